@@ -34,6 +34,7 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_convergenceMonitor.hpp"
 #include <iostream>
 #include <cmath>
 
@@ -82,7 +83,32 @@ int main(int argc, const char * argv[]) {
         reactionConditions.electricField = 0.0;
         reactionConditions.pressure = 0.0;
 
+        // optionally sample the reactions with exact waiting times, which resolves reactions faster than the
+        // time step:
+        if (simConf->isParameter("exact_reaction_kinetics")) {
+            sim.setExactReactionKinetics(simConf->boolParameter("exact_reaction_kinetics"));
+        }
+
+        // optionally initialize the particle species to the steady state of the reaction system, to skip the
+        // equilibration of the chemistry:
+        if (simConf->isParameter("initialize_reaction_steady_state") &&
+            simConf->boolParameter("initialize_reaction_steady_state")) {
+            std::map<RS::Substance*, double> steadyState = sim.initializeToSteadyState(reactionConditions);
+            for (const auto& entry: steadyState) {
+                logger->info("steady state abundance {}: {}", entry.first->name(), entry.second);
+            }
+        }
+
         resultFilewriter.initFile(rsSimConf);
+
+        // optional monitoring of the statistical convergence of the relative substance concentrations, which
+        // terminates the simulation early:
+        std::vector<std::string> availableObservables;
+        for (const auto& substance: rsSimConf->getAllDiscreteSubstances()) {
+            availableObservables.push_back(substance->name());
+        }
+        std::unique_ptr<AppUtils::ConvergenceMonitor> convergenceMonitor =
+                AppUtils::createConvergenceMonitor(simConf, availableObservables);
         // ======================================================================================
 
 
@@ -101,6 +127,19 @@ int main(int argc, const char * argv[]) {
 
             sim.performTimestep(reactionConditions, dt_s);
             sim.advanceTimestep(dt_s);
+
+            if (convergenceMonitor) {
+                for (const auto& [substance, count]: sim.discreteConcentrations()) {
+                    if (convergenceMonitor->hasObservable(substance->name())) {
+                        convergenceMonitor->addSample(substance->name(), count / (double) nParticlesTotal);
+                    }
+                }
+                if (convergenceMonitor->isConverged()) {
+                    logger->info("Concentrations converged ts:{} time:{:.2e}", step, sim.simulationTime());
+                    convergenceMonitor->logStatistics(logger);
+                    break;
+                }
+            }
         }
         resultFilewriter.closeFile();
         stopWatch.stop();
@@ -48,6 +48,7 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_convergenceMonitor.hpp"
 #include "dmsSim_dmsFields.hpp"
 #include <iostream>
 #include <cmath>
@@ -203,6 +204,15 @@ int main(int argc, const char * argv[]) {
             std::string mdCollisionConfFile = simConf->pathRelativeToConfFile(simConf->stringParameter("md_configuration"));
             FileIO::MolecularStructureReader mdConfReader = FileIO::MolecularStructureReader();
             molecularStructureCollection = mdConfReader.readMolecularStructure(mdCollisionConfFile);
+            if (simConf->isParameter("md_interaction_cutoff_angstrom")){
+                //build spatial indices of the ion structures for cut-off based MD force calculation:
+                double interactionCutoff_m = simConf->doubleParameter("md_interaction_cutoff_angstrom")*1e-10;
+                for (auto& structure: molecularStructureCollection){
+                    if (structure.second->getIsIon()){
+                        structure.second->buildAtomCellGrid(interactionCutoff_m);
+                    }
+                }
+            }
         }
 
 
@@ -475,6 +485,18 @@ int main(int argc, const char * argv[]) {
         // ======================================================================================
 
 
+        // optional monitoring of the statistical convergence of observables (the compensation voltage in auto cv
+        // mode and relative concentrations of the discrete substances), which terminates the simulation early:
+        std::vector<std::string> availableObservables;
+        for (const auto& substance: discreteSubstances) {
+            availableObservables.push_back(substance->name());
+        }
+        if (cvMode==AUTO_CV) {
+            availableObservables.emplace_back("cv");
+        }
+        std::unique_ptr<AppUtils::ConvergenceMonitor> convergenceMonitor =
+                AppUtils::createConvergenceMonitor(simConf, availableObservables);
+
         // simulate   ===========================================================================
         AppUtils::SignalHandler::setReceiver(verletIntegrator);
         AppUtils::Stopwatch stopWatch;
@@ -504,6 +526,24 @@ int main(int argc, const char * argv[]) {
                         rsSim.simulationTime());
                 meanZPos = currentMeanZPos;
                 logger->info("CV corrected ts:{} time:{:.2e} new CV:{} diffMeanPos:{}", step, rsSim.simulationTime(), fieldCVSetpoint_VPerM, diffMeanZPos);
+
+                if (convergenceMonitor && convergenceMonitor->hasObservable("cv")) {
+                    convergenceMonitor->addSample("cv", fieldCVSetpoint_VPerM/1000.0);
+                    convergenceMonitor->logStatistics(logger);
+                }
+            }
+
+            //terminate the integrator if the monitored observables are converged:
+            if (convergenceMonitor) {
+                for (const auto& [substance, count]: rsSim.discreteConcentrations()) {
+                    if (convergenceMonitor->hasObservable(substance->name())) {
+                        convergenceMonitor->addSample(substance->name(), count/(double) nParticlesTotal);
+                    }
+                }
+                if (convergenceMonitor->terminateIfConverged(verletIntegrator)) {
+                    logger->info("Observables converged ts:{} time:{:.2e}", step, rsSim.simulationTime());
+                    convergenceMonitor->logStatistics(logger);
+                }
             }
 
             //terminate simulation loops if all particles are terminated or termination of the integrator was requested
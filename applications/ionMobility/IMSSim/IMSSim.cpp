@@ -27,6 +27,7 @@
 
 
 #include "Core_utils.hpp"
+#include "Core_constants.hpp"
 #include "RS_Simulation.hpp"
 #include "RS_SimulationConfiguration.hpp"
 #include "RS_ConfigFileParser.hpp"
@@ -35,7 +36,10 @@
 #include "PSim_constants.hpp"
 #include "Integration_velocityIntegrator.hpp"
 #include "Integration_parallelVerletIntegrator.hpp"
+#include "Integration_parallelExponentialIntegrator.hpp"
+#include "Integration_parallelEventDrivenIntegrator.hpp"
 #include "FileIO_trajectoryHDF5Writer.hpp"
+#include "FileIO_sharedMemoryFrameWriter.hpp"
 #include "CollisionModel_AbstractCollisionModel.hpp"
 #include "CollisionModel_HardSphere.hpp"
 #include "CollisionModel_StatisticalDiffusion.hpp"
@@ -48,6 +52,7 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_convergenceMonitor.hpp"
 #include "FileIO_MolecularStructureReader.hpp"
 #include "Core_randomGenerators.hpp"
 #include "json.h"
@@ -57,7 +62,7 @@
 #include <numeric>
 
 enum IntegratorType{
-    VERLET, VERLET_PARALLEL, SIMPLE, NO_INTEGRATOR
+    VERLET, VERLET_PARALLEL, EXPONENTIAL_PARALLEL, EVENT_DRIVEN_PARALLEL, SIMPLE, NO_INTEGRATOR
 };
 enum CollisionModelType{
     HS, VSS, SDS, MD, NO_COLLISONS
@@ -166,6 +171,15 @@ int main(int argc, const char *argv[]){
             std::string mdCollisionConfFile = simConf->pathRelativeToConfFile(simConf->stringParameter("md_configuration"));
             FileIO::MolecularStructureReader mdConfReader = FileIO::MolecularStructureReader();
             molecularStructureCollection = mdConfReader.readMolecularStructure(mdCollisionConfFile);
+            if (simConf->isParameter("md_interaction_cutoff_angstrom")){
+                //build spatial indices of the ion structures for cut-off based MD force calculation:
+                double interactionCutoff_m = simConf->doubleParameter("md_interaction_cutoff_angstrom")*1e-10;
+                for (auto& structure: molecularStructureCollection){
+                    if (structure.second->getIsIon()){
+                        structure.second->buildAtomCellGrid(interactionCutoff_m);
+                    }
+                }
+            }
         }
 
         // prepare softsphere collision model alpha values
@@ -208,6 +222,13 @@ int main(int argc, const char *argv[]){
         //init hdf5 filewriter
         FileIO::TrajectoryHDF5Writer hdf5Writer(cmdLineParser.trajectoriesResultName());
         hdf5Writer.setParticleAttributes(auxParamNames, additionalParamTFct);
+        if (simConf->isParameter("trajectory_position_error")) {
+            double attributeError = 0.0;
+            if (simConf->isParameter("trajectory_attribute_error")) {
+                attributeError = simConf->doubleParameter("trajectory_attribute_error");
+            }
+            hdf5Writer.setQuantization(simConf->doubleParameter("trajectory_position_error"), attributeError);
+        }
 
         unsigned int ionsInactive = 0;
 
@@ -217,6 +238,18 @@ int main(int argc, const char *argv[]){
             nAllParticles += ni;
         }
 
+        // optional live output of the particle frames into a shared memory ring buffer:
+        std::unique_ptr<FileIO::SharedMemoryFrameWriter> liveFrameWriter;
+        int liveFramesWriteInterval = trajectoryWriteInterval;
+        if (simConf->isParameter("live_frames_shm_name")) {
+            liveFrameWriter = std::make_unique<FileIO::SharedMemoryFrameWriter>(
+                    simConf->stringParameter("live_frames_shm_name"), nAllParticles);
+            liveFrameWriter->setParticleAttributes(auxParamNames, additionalParamTFct);
+            if (simConf->isParameter("live_frames_write_interval")) {
+                liveFramesWriteInterval = simConf->intParameter("live_frames_write_interval");
+            }
+        }
+
         // init simulation  =====================================================================
 
         // create and add simulation particles:
@@ -259,6 +292,22 @@ int main(int argc, const char *argv[]){
         reactionConditions.pressure = totalBackgroundPressure_Pa;
         reactionConditions.electricField = eFieldMagnitude;
 
+        // optionally sample the reactions with exact waiting times, which resolves reactions faster than the
+        // time step:
+        if (simConf->isParameter("exact_reaction_kinetics")) {
+            rsSim.setExactReactionKinetics(simConf->boolParameter("exact_reaction_kinetics"));
+        }
+
+        // optionally initialize the particle species to the steady state of the reaction system, to skip the
+        // equilibration of the chemistry:
+        if (simConf->isParameter("initialize_reaction_steady_state") &&
+            simConf->boolParameter("initialize_reaction_steady_state")) {
+            std::map<RS::Substance*, double> steadyState = rsSim.initializeToSteadyState(reactionConditions);
+            for (const auto& entry: steadyState) {
+                logger->info("steady state abundance {}: {}", entry.first->name(), entry.second);
+            }
+        }
+
         resultFilewriter.initFile(rsSimConf);
         // ======================================================================================
 
@@ -269,6 +318,27 @@ int main(int argc, const char *argv[]){
         IntegratorType integratorType;
         if (vType!=std::end(verletTypes)) {
                 integratorType = VERLET_PARALLEL;
+                // optionally integrate the drag of the gas interaction analytically, which allows time steps
+                // much longer than the velocity relaxation time of the ions:
+                if (simConf->isParameter("exponential_integrator") &&
+                    simConf->boolParameter("exponential_integrator")) {
+                    integratorType = EXPONENTIAL_PARALLEL;
+                    logger->info("Exponential trajectory integration");
+                }
+                // optionally propagate the ions from collision to collision in the uniform drift field, which allows
+                // time steps much longer than the mean time between collisions:
+                if (simConf->isParameter("event_driven_integrator") &&
+                    simConf->boolParameter("event_driven_integrator")) {
+                    if (transportModelType!="btree_HS") {
+                        throw std::invalid_argument("Event driven integration requires the btree_HS transport model");
+                    }
+                    if (integratorType==EXPONENTIAL_PARALLEL) {
+                        throw std::invalid_argument(
+                                "Exponential and event driven integration can not be used together");
+                    }
+                    integratorType = EVENT_DRIVEN_PARALLEL;
+                    logger->info("Event driven trajectory integration");
+                }
         }
         else if (transportModelType=="simple") {
             integratorType = SIMPLE;
@@ -284,10 +354,9 @@ int main(int argc, const char *argv[]){
         //===================================================================================================
 
         // define trajectory integration parameters / functions =================================
-        double referencePressure_Pa = 100000;
-        double referenceTemperature_K = 273.15;
         double backgroundPTRatio =
-                referencePressure_Pa/totalBackgroundPressure_Pa*backgroundTemperature_K/referenceTemperature_K;
+                Core::REDUCED_MOBILITY_REFERENCE_PRESSURE_PA/totalBackgroundPressure_Pa*
+                backgroundTemperature_K/Core::REDUCED_MOBILITY_REFERENCE_TEMPERATURE_K;
 
         auto accelerationFctVerlet =
                 [eFieldMagnitude, spaceChargeFactor]
@@ -307,8 +376,11 @@ int main(int argc, const char *argv[]){
                 };
 
         auto timestepWriteFctSimple =
-                [&hdf5Writer, trajectoryWriteInterval, &ionsInactive, &logger]
+                [&hdf5Writer, trajectoryWriteInterval, &ionsInactive, &liveFrameWriter, liveFramesWriteInterval, &logger]
                         (std::vector<Core::Particle*>& particles, double time, int timestep, bool lastTimestep) {
+                    if (liveFrameWriter && timestep%liveFramesWriteInterval==0) {
+                        liveFrameWriter->writeTimestep(particles, time);
+                    }
                     if (lastTimestep) {
                         hdf5Writer.writeTimestep(particles, time);
                         hdf5Writer.writeSplatTimes(particles);
@@ -470,6 +542,25 @@ int main(int argc, const char *argv[]){
                 ParticleSimulation::noFunction,
                 collisionModelPtr.get());
         }
+        else if(integratorType==EXPONENTIAL_PARALLEL){
+            trajectoryIntegrator = std::make_unique<Integration::ParallelExponentialIntegrator>(
+                particlesPtrs,
+                accelerationFctVerlet, postTimestepFctVerlet, otherActionsFunctionIMSVerlet,
+                ParticleSimulation::noFunction,
+                collisionModelPtr.get());
+        }
+        else if(integratorType==EVENT_DRIVEN_PARALLEL){
+            // the drift field is uniform in the whole drift tube, the space charge field is evaluated once per
+            // time step:
+            auto uniformFieldRegionFct = [](Core::Particle* /*particle*/, double /*time*/){
+                return true;
+            };
+            trajectoryIntegrator = std::make_unique<Integration::ParallelEventDrivenIntegrator>(
+                particlesPtrs,
+                accelerationFctVerlet, uniformFieldRegionFct, collisionModelPtr.get(),
+                postTimestepFctVerlet, otherActionsFunctionIMSVerlet,
+                ParticleSimulation::noFunction);
+        }
         else if (integratorType==SIMPLE) {
             auto velocityFctSimple = [eFieldMagnitude, backgroundPTRatio](Core::Particle* particle, int /*particleIndex*/,
                                                                           double /*time*/, int /*timestep*/) {
@@ -487,18 +578,76 @@ int main(int argc, const char *argv[]){
         // ======================================================================================
 
 
+        // optional monitoring of the statistical convergence of observables (drift velocity / reduced mobility of
+        // the ions and relative concentrations of the discrete substances), which terminates the simulation early:
+        std::vector<std::string> availableObservables;
+        for (const auto& substance: discreteSubstances) {
+            availableObservables.push_back(substance->name());
+        }
+        if (integratorType!=NO_INTEGRATOR) {
+            availableObservables.emplace_back("drift_velocity");
+            availableObservables.emplace_back("reduced_mobility");
+        }
+        std::unique_ptr<AppUtils::ConvergenceMonitor> convergenceMonitor =
+                AppUtils::createConvergenceMonitor(simConf, availableObservables);
+        std::vector<double> lastXPositions(nParticlesTotal);
+        for (unsigned int i = 0; i<nParticlesTotal; i++) {
+            lastXPositions[i] = particles[i]->getLocation().x();
+        }
+
+        auto sampleConvergenceObservables = [&](){
+            for (const auto& [substance, count]: rsSim.discreteConcentrations()) {
+                if (convergenceMonitor->hasObservable(substance->name())) {
+                    convergenceMonitor->addSample(substance->name(), count/(double) nParticlesTotal);
+                }
+            }
+            if (integratorType!=NO_INTEGRATOR) {
+                // mean drift velocity of the ions which are still active:
+                double sumDisplacement = 0.0;
+                unsigned int nActive = 0;
+                for (unsigned int i = 0; i<nParticlesTotal; i++) {
+                    double xPos = particles[i]->getLocation().x();
+                    if (particles[i]->isActive()) {
+                        sumDisplacement += xPos-lastXPositions[i];
+                        nActive++;
+                    }
+                    lastXPositions[i] = xPos;
+                }
+                if (nActive>0) {
+                    double driftVelocity = sumDisplacement/nActive/dt_s;
+                    if (convergenceMonitor->hasObservable("drift_velocity")) {
+                        convergenceMonitor->addSample("drift_velocity", driftVelocity);
+                    }
+                    if (convergenceMonitor->hasObservable("reduced_mobility")) {
+                        convergenceMonitor->addSample("reduced_mobility",
+                                driftVelocity/eFieldMagnitude/backgroundPTRatio);
+                    }
+                }
+            }
+        };
+
         // simulate   ===========================================================================
         AppUtils::SignalHandler::registerSignalHandler(); //this method is used because trajectory integrator can be null
         AppUtils::Stopwatch stopWatch;
         stopWatch.start();
 
+        auto encounterProductFct = [&collisionModelPtr, collisionModelType](RS::ReactiveParticle* particle){
+            if (collisionModelType==SDS) {
+                collisionModelPtr->initializeModelParticleParameters(*particle);
+            }
+        };
+
         for (int step = 0; step<nSteps; step++) {
             if (step%concentrationWriteInterval==0) {
                 resultFilewriter.writeTimestep(rsSim);
             }
             if (step%trajectoryWriteInterval==0) {
                 rsSim.logConcentrations(logger);
+                if (convergenceMonitor) {
+                    convergenceMonitor->logStatistics(logger);
+                }
             }
+            rsSim.performEncounterReactions(dt_s, encounterProductFct);
             for (unsigned int i = 0; i<nParticlesTotal; i++) {
                 bool reacted = rsSim.react(i, reactionConditions, dt_s);
                 int substIndex = substanceIndices.at(particles[i]->getSpecies());
@@ -523,6 +672,19 @@ int main(int argc, const char *argv[]){
             if (ionsInactive>=nAllParticles){
                 break;
             }
+
+            //terminate simulation loop if the monitored observables are converged:
+            if (convergenceMonitor) {
+                sampleConvergenceObservables();
+                if (convergenceMonitor->isConverged()) {
+                    logger->info("Observables converged ts:{} time:{:.2e}", step, rsSim.simulationTime());
+                    convergenceMonitor->logStatistics(logger);
+                    if (trajectoryIntegrator !=nullptr) {
+                        trajectoryIntegrator->setTerminationState();
+                    }
+                    break;
+                }
+            }
         }
         resultFilewriter.writeReactionStatistics(rsSim);
         if (trajectoryIntegrator) {
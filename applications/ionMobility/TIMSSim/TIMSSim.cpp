@@ -236,6 +236,15 @@ int main(int argc, const char * argv[]) {
             std::string mdCollisionConfFile = simConf->pathRelativeToConfFile(simConf->stringParameter("md_configuration"));
             FileIO::MolecularStructureReader mdConfReader = FileIO::MolecularStructureReader();
             molecularStructureCollection = mdConfReader.readMolecularStructure(mdCollisionConfFile);
+            if (simConf->isParameter("md_interaction_cutoff_angstrom")){
+                //build spatial indices of the ion structures for cut-off based MD force calculation:
+                double interactionCutoff_m = simConf->doubleParameter("md_interaction_cutoff_angstrom")*1e-10;
+                for (auto& structure: molecularStructureCollection){
+                    if (structure.second->getIsIon()){
+                        structure.second->buildAtomCellGrid(interactionCutoff_m);
+                    }
+                }
+            }
         }
 
 
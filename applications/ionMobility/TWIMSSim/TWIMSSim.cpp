@@ -48,8 +48,10 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_convergenceMonitor.hpp"
 #include "dmsSim_dmsFields.hpp"
 #include "PSim_simionPotentialArray.hpp"
+#include "PSim_voltageSchedule.hpp"
 #include "PSim_particleStartSplatTracker.hpp"
 #include "CollisionModel_MultiCollisionModel.hpp"
 #include <iostream>
@@ -83,11 +85,6 @@ int main(int argc, const char * argv[]) {
         int concentrationWriteInterval = simConf->intParameter("concentrations_write_interval");
         int trajectoryWriteInterval = simConf->intParameter("trajectory_write_interval");
         double spaceChargeFactor = simConf->doubleParameter("space_charge_factor");
-        [[maybe_unused]] double waveAmplitude = simConf->doubleParameter("wave_amplitude_V");
-        double waveFrequency = simConf->doubleParameter("wave_frequency_hz");
-
-        double f_rf = simConf->doubleParameter("confining_RF_frequency_Hz");
-        [[maybe_unused]] double omega = f_rf*2.0*M_PI;
         double V_rf = simConf->doubleParameter("confining_RF_amplitude_V");
 
         //geometric parameters:
@@ -200,13 +197,53 @@ int main(int argc, const char * argv[]) {
             RFPotentialArrays.push_back(std::move(pa_pt));
         }
 
+        // optional in memory compression of the potential arrays (absolute error bound, 0 for lossless compression)
+        if (simConf->isParameter("potential_array_compression_error")){
+            double paCompressionError = simConf->doubleParameter("potential_array_compression_error");
+            for (auto& pa: WavePotentialArrays){
+                pa->compress(paCompressionError);
+            }
+            for (auto& pa: RFPotentialArrays){
+                pa->compress(paCompressionError);
+            }
+        }
+
         double potentialScale = 1.0/10000.0;
 
-        [[maybe_unused]] double wavePeriod = 1.0/waveFrequency;
+        // read electrode voltage configuration: The voltages of the wave electrodes followed by the voltages of the RF
+        // electrodes are defined by a voltage schedule, which is either given explicitly or constructed from
+        // the traveling wave and confining RF configuration
+        std::size_t nWaveElectrodes = WavePotentialArrays.size();
+        std::size_t nElectrodes = nWaveElectrodes+RFPotentialArrays.size();
+        std::unique_ptr<ParticleSimulation::VoltageSchedule> voltageSchedule;
+        if (simConf->isParameter("voltage_schedule")) {
+            voltageSchedule = simConf->voltageScheduleParameter("voltage_schedule");
+        }
+        else {
+            using Signal = ParticleSimulation::VoltageSchedule::Signal;
+            voltageSchedule = std::make_unique<ParticleSimulation::VoltageSchedule>(nElectrodes);
+
+            double waveAmplitude = simConf->doubleParameter("wave_amplitude_V");
+            double waveFrequency = simConf->doubleParameter("wave_frequency_hz");
+            std::vector<double> phaseShift = simConf->doubleVectorParameter("phase_shift");
+            std::string WaveformFilename = simConf->pathRelativeToConfFile(simConf->stringParameter("waveform"));
+            auto waveForm = std::make_shared<ParticleSimulation::SampledWaveform>(WaveformFilename);
+            for (std::size_t i = 0; i<nWaveElectrodes; ++i) {
+                std::size_t waveSignal = voltageSchedule->addSignal("wave_"+std::to_string(i),
+                        Signal::travelingWave(waveForm, waveAmplitude, waveFrequency, phaseShift.at(i)));
+                voltageSchedule->setElectrodeFactor(i, waveSignal, 1.0);
+            }
 
-        std::vector<double> phaseShift = simConf->doubleVectorParameter("phase_shift");
-        std::string WaveformFilename = simConf->pathRelativeToConfFile(simConf->stringParameter("waveform"));
-        auto WaveForm = ParticleSimulation::SampledWaveform(WaveformFilename);
+            // bipolar confining RF: V_rf * sin(omega t) with alternating polarity of the RF electrodes
+            double f_rf = simConf->doubleParameter("confining_RF_frequency_Hz");
+            std::size_t rfSignal = voltageSchedule->addSignal("rf", Signal::sine(V_rf, f_rf, -M_PI/2.0));
+            for (std::size_t i = 0; i<RFPotentialArrays.size(); ++i) {
+                voltageSchedule->setElectrodeFactor(nWaveElectrodes+i, rfSignal, i%2 == 0 ? 1.0 : -1.0);
+            }
+        }
+        if (voltageSchedule->numberOfElectrodes() != nElectrodes) {
+            throw std::invalid_argument("Number of electrodes in voltage schedule does not match number of potential arrays");
+        }
 
         // defining simulation domain box (used for ion termination):
         std::array<std::array<double, 2>, 3> simulationDomainBoundaries{};
@@ -256,6 +293,15 @@ int main(int argc, const char * argv[]) {
             std::string mdCollisionConfFile = simConf->pathRelativeToConfFile(simConf->stringParameter("md_configuration"));
             FileIO::MolecularStructureReader mdConfReader = FileIO::MolecularStructureReader();
             molecularStructureCollection = mdConfReader.readMolecularStructure(mdCollisionConfFile);
+            if (simConf->isParameter("md_interaction_cutoff_angstrom")){
+                //build spatial indices of the ion structures for cut-off based MD force calculation:
+                double interactionCutoff_m = simConf->doubleParameter("md_interaction_cutoff_angstrom")*1e-10;
+                for (auto& structure: molecularStructureCollection){
+                    if (structure.second->getIsIon()){
+                        structure.second->buildAtomCellGrid(interactionCutoff_m);
+                    }
+                }
+            }
         }
 
 
@@ -348,52 +394,28 @@ int main(int argc, const char * argv[]) {
 
 
         // define trajectory integration parameters / functions =================================
-        std::vector<double> totalFieldNow(WavePotentialArrays.size()+RFPotentialArrays.size(), 0.0);
-
-        auto paVoltageFct = [&WavePotentialArrays, &RFPotentialArrays, &WaveForm, phaseShift,
-                wavePeriod, waveAmplitude, omega, V_rf, &totalFieldNow](double time){
-                for(size_t i=0; i<WavePotentialArrays.size(); i++) {
-                    double phase = std::fmod(time, wavePeriod) / wavePeriod;
-                    double shiftedphase = std::fmod(phase + phaseShift[i], 1.0);
-                    totalFieldNow[i]=(WaveForm.getInterpolatedValue(shiftedphase) * waveAmplitude);
-                }
-
-                for(size_t i=0; i<RFPotentialArrays.size(); i++) {
-                    if (i%2 == 0) {
-                        totalFieldNow[WavePotentialArrays.size()+i] = sin(time*omega) * V_rf;
-                    }
-                    else {
-                        totalFieldNow[WavePotentialArrays.size()+i] = -1 * sin(time*omega) * V_rf;
-                    }
-                }
-
-
-        };
-
         auto accelerationFct =
-                [&WavePotentialArrays, &RFPotentialArrays, &totalFieldNow, potentialScale, spaceChargeFactor]
+                [&WavePotentialArrays, &RFPotentialArrays, &voltageSchedule, nWaveElectrodes, potentialScale,
+                 spaceChargeFactor]
                         (Core::Particle* particle, int /*particleIndex*/,
                          SpaceCharge::FieldCalculator& scFieldCalculator,
-                         double /*time*/, int /*timestep*/)
+                         double time, unsigned int timestep)
                 {
                     Core::Vector fEfield(0, 0, 0);
                     Core::Vector pos = particle->getLocation();
                     double particleCharge = particle->getCharge();
+                    const std::vector<double>& electrodeVoltages = voltageSchedule->voltages(time, timestep);
 
                     for (size_t i = 0; i<WavePotentialArrays.size(); i++) {
                         Core::Vector paField = WavePotentialArrays[i]->getField(pos.x(), pos.y(), pos.z());
-                        Core::Vector paEffectiveField = paField*totalFieldNow[i]*potentialScale;
-
-                        fEfield = fEfield+paEffectiveField;
+                        fEfield = fEfield+paField*electrodeVoltages[i];
                     }
 
                     for (size_t i = 0; i<RFPotentialArrays.size(); i++) {
                         Core::Vector paField = RFPotentialArrays[i]->getField(pos.x(), pos.y(), pos.z());
-                        Core::Vector paEffectiveField =
-                                paField*totalFieldNow[WavePotentialArrays.size()+i]*potentialScale;
-
-                        fEfield = fEfield+paEffectiveField;
+                        fEfield = fEfield+paField*electrodeVoltages[nWaveElectrodes+i];
                     }
+                    fEfield = fEfield*potentialScale;
 
                     particle->setFloatAttribute("effectiveField", fEfield.magnitude());
 
@@ -409,7 +431,7 @@ int main(int argc, const char * argv[]) {
 
         auto postTimestepFct =
                 [&trajectoryWriter, &voltageWriter, trajectoryWriteInterval, &rsSim, &resultFilewriter, concentrationWriteInterval,
-                        &totalFieldNow, &logger, &ionsInactive]
+                        &voltageSchedule, &logger, &ionsInactive]
                         (
                                 Integration::AbstractTimeIntegrator* /*integrator*/,
                                 std::vector<Core::Particle*>& particles, double time, int timestep,
@@ -418,7 +440,8 @@ int main(int argc, const char * argv[]) {
 
                     if (timestep%concentrationWriteInterval==0) {
                         resultFilewriter.writeTimestep(rsSim);
-                        voltageWriter->writeTimestep(totalFieldNow, time);
+                        voltageWriter->writeTimestep(
+                                voltageSchedule->voltages(time, static_cast<unsigned int>(timestep)), time);
                     }
                     if (lastTimestep) {
                         trajectoryWriter.writeTimestep(particles, time);
@@ -684,6 +707,45 @@ int main(int argc, const char * argv[]) {
         // ======================================================================================
 
 
+        // optional monitoring of the statistical convergence of observables (arrival time mean and width of the
+        // ions and relative concentrations of the discrete substances), which terminates the simulation early:
+        std::vector<std::string> availableObservables = {"arrival_time_mean", "arrival_time_width"};
+        for (const auto& substance: discreteSubstances) {
+            availableObservables.push_back(substance->name());
+        }
+        std::unique_ptr<AppUtils::ConvergenceMonitor> convergenceMonitor =
+                AppUtils::createConvergenceMonitor(simConf, availableObservables);
+
+        // The ions arrive (splat) ordered by their arrival time, thus the arrival times in the order of arrival
+        // are not a random sample of the arrival time distribution. The arrival times are therefore sampled in
+        // the order of the particle indices (which is random with respect to the arrival times): The arrival time
+        // of an ion is sampled as soon as all ions with lower indices have arrived.
+        // The width samples are sqrt(pi)/2 * |t_a - t_b| of disjoint pairs of arrival times, their mean is the
+        // standard deviation of a gaussian arrival time distribution.
+        std::size_t nextArrivalSampleIndex = 0;
+        double unpairedArrivalTime = -1.0;
+        auto sampleArrivalTimes = [&](){
+            while (nextArrivalSampleIndex<nAllParticles && !particlesPtrs[nextArrivalSampleIndex]->isActive()) {
+                double arrivalTime = particlesPtrs[nextArrivalSampleIndex]->getSplatTime();
+                if (convergenceMonitor->hasObservable("arrival_time_mean")) {
+                    convergenceMonitor->addSample("arrival_time_mean", arrivalTime);
+                }
+                if (unpairedArrivalTime < 0.0) {
+                    unpairedArrivalTime = arrivalTime;
+                }
+                else {
+                    if (convergenceMonitor->hasObservable("arrival_time_width")) {
+                        convergenceMonitor->addSample("arrival_time_width",
+                                std::sqrt(M_PI)/2.0*std::fabs(arrivalTime-unpairedArrivalTime));
+                    }
+                    unpairedArrivalTime = -1.0;
+                }
+                ++nextArrivalSampleIndex;
+            }
+        };
+        // ======================================================================================
+
+
         // simulate   ===========================================================================
         AppUtils::SignalHandler::setReceiver(verletIntegrator);
         AppUtils::Stopwatch stopWatch;
@@ -692,9 +754,24 @@ int main(int argc, const char * argv[]) {
         for (unsigned int step = 0; step<nSteps; step++) {
             rsSim.performTimestep(reactionConditionsFct, dt_s, particlesHasReactedFct);
             rsSim.advanceTimestep(dt_s);
-            paVoltageFct(rsSim.simulationTime());
             verletIntegrator.runSingleStep(dt_s);
 
+            //terminate the integrator if the monitored observables are converged:
+            if (convergenceMonitor) {
+                sampleArrivalTimes();
+                for (const auto& [substance, count]: rsSim.discreteConcentrations()) {
+                    if (convergenceMonitor->hasObservable(substance->name())) {
+                        convergenceMonitor->addSample(substance->name(), count/(double) nParticlesTotal);
+                    }
+                }
+                if (step%static_cast<unsigned int>(trajectoryWriteInterval)==0) {
+                    convergenceMonitor->logStatistics(logger);
+                }
+                if (convergenceMonitor->terminateIfConverged(verletIntegrator)) {
+                    logger->info("Observables converged ts:{} time:{:.2e}", step, rsSim.simulationTime());
+                    convergenceMonitor->logStatistics(logger);
+                }
+            }
 
             //terminate simulation loops if all particles are terminated or termination of the integrator was requested
             //from somewhere (e.g. signal from outside)
@@ -0,0 +1,310 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ TransportTableSim.cpp
+
+ Generation of ion transport coefficient tables (field and temperature dependent mobility and diffusion) from
+ parallel ion swarm simulations with gas collision models
+
+ ****************************/
+
+#include "Core_particle.hpp"
+#include "Core_constants.hpp"
+#include "PSim_constants.hpp"
+#include "PSim_util.hpp"
+#include "Integration_verletIntegrator.hpp"
+#include "CollisionModel_AbstractCollisionModel.hpp"
+#include "CollisionModel_HardSphere.hpp"
+#include "CollisionModel_SoftSphere.hpp"
+#include "CollisionModel_MultiCollisionModel.hpp"
+#include "CollisionModel_MDInteractions.hpp"
+#include "CollisionModel_MDForceField_LJ12_6.hpp"
+#include "FileIO_MolecularStructureReader.hpp"
+#include "appUtils_simulationConfiguration.hpp"
+#include "appUtils_logging.hpp"
+#include "appUtils_stopwatch.hpp"
+#include "appUtils_commandlineParser.hpp"
+#include "ionMobility_swarmTransport.hpp"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+int main(int argc, const char *argv[]){
+
+    try {
+        // open configuration, parse configuration file =========================================
+        AppUtils::CommandlineParser cmdLineParser(argc, argv, "TransportTableSim",
+                "Ion transport coefficient tables from parallel ion swarm simulations", true);
+        std::string projectName = cmdLineParser.resultName();
+        AppUtils::logger_ptr logger = cmdLineParser.logger();
+        AppUtils::simConf_ptr simConf = cmdLineParser.simulationConfiguration();
+
+        std::vector<double> reducedFields_Td = simConf->doubleVectorParameter("reduced_field_Td");
+        if (std::any_of(reducedFields_Td.begin(), reducedFields_Td.end(), [](double field){return field <= 0.0;})){
+            throw std::invalid_argument("reduced_field_Td values have to be larger than zero");
+        }
+        std::vector<double> temperatures_K = simConf->doubleVectorParameter("background_temperature_K");
+
+        unsigned int nParticles = simConf->unsignedIntParameter("n_particles");
+        double dt_s = simConf->doubleParameter("dt_s");
+        unsigned int warmupSteps = simConf->unsignedIntParameter("warmup_time_steps");
+        unsigned int samplingSteps = simConf->unsignedIntParameter("sampling_time_steps");
+        unsigned int samplingInterval = simConf->unsignedIntParameter("sampling_interval");
+        if (samplingInterval == 0 || samplingSteps < 2*samplingInterval){
+            throw std::invalid_argument("Sampling phase has to contain at least two sampling intervals");
+        }
+
+        double ionMass_amu = simConf->doubleParameter("ion_mass_amu");
+        double ionCharge = simConf->doubleParameter("ion_charge");
+
+        //read and check gas parameters:
+        std::string transportModelType = simConf->stringParameter("transport_model_type");
+        std::vector<double> backgroundPartialPressures_Pa = simConf->doubleVectorParameter(
+                "background_partial_pressures_Pa");
+        std::vector<double> collisionGasMasses_Amu = simConf->doubleVectorParameter("collision_gas_masses_amu");
+        std::vector<double> collisionGasDiameters_angstrom = simConf->doubleVectorParameter(
+                "collision_gas_diameters_angstrom");
+
+        std::size_t nBackgroundGases = backgroundPartialPressures_Pa.size();
+        if (collisionGasMasses_Amu.size()!=nBackgroundGases || collisionGasDiameters_angstrom.size()!=nBackgroundGases) {
+            throw std::invalid_argument("Inconsistent background gas configuration");
+        }
+        double totalBackgroundPressure_Pa = std::accumulate(
+                backgroundPartialPressures_Pa.begin(),
+                backgroundPartialPressures_Pa.end(), 0.0);
+
+        std::vector<double> collisionGasDiameters_m;
+        std::transform(
+                collisionGasDiameters_angstrom.begin(),
+                collisionGasDiameters_angstrom.end(),
+                std::back_inserter(collisionGasDiameters_m),
+                [](double cgd) -> double { return cgd*1e-10; });
+
+        double ionDiameter_m = 0.0;
+        double vssCollisionAlpha = 0.0;
+        double vssCollisionOmega = 0.0;
+        if (transportModelType=="btree_HS" || transportModelType=="btree_VSS"){
+            ionDiameter_m = simConf->doubleParameter("ion_collision_diameter_angstrom")*1e-10;
+        }
+        if (transportModelType=="btree_VSS"){
+            vssCollisionAlpha = simConf->doubleParameter("vss_collision_alpha");
+            vssCollisionOmega = simConf->doubleParameter("vss_collision_omega");
+        }
+
+        //read MD parameters and molecular structure file:
+        std::vector<std::string> collisionGasIdentifier;
+        std::vector<double> collisionGasPolarizability_m3;
+        std::string particleIdentifier;
+        double subIntegratorIntegrationTime_s = 0;
+        double subIntegratorStepSize_s = 0;
+        double collisionRadiusScaling = 0;
+        double angleThetaScaling = 0;
+        double spawnRadius_m = 0;
+        std::unordered_map<std::string,  std::shared_ptr<CollisionModel::MolecularStructure>> molecularStructureCollection;
+        if (transportModelType=="btree_MD"){
+            collisionGasPolarizability_m3 = simConf->doubleVectorParameter("collision_gas_polarizability_m3");
+            collisionGasIdentifier = simConf->stringVectorParameter("collision_gas_identifier");
+            particleIdentifier = simConf->stringParameter("particle_identifier");
+            subIntegratorIntegrationTime_s = simConf->doubleParameter("sub_integrator_integration_time_s");
+            subIntegratorStepSize_s = simConf->doubleParameter("sub_integrator_step_size_s");
+            collisionRadiusScaling = simConf->doubleParameter("collision_radius_scaling");
+            angleThetaScaling = simConf->doubleParameter("angle_theta_scaling");
+            spawnRadius_m = simConf->doubleParameter("spawn_radius_m");
+
+            std::string mdCollisionConfFile = simConf->pathRelativeToConfFile(simConf->stringParameter("md_configuration"));
+            FileIO::MolecularStructureReader mdConfReader = FileIO::MolecularStructureReader();
+            molecularStructureCollection = mdConfReader.readMolecularStructure(mdCollisionConfFile);
+            if (simConf->isParameter("md_interaction_cutoff_angstrom")){
+                //build spatial indices of the ion structures for cut-off based MD force calculation:
+                double interactionCutoff_m = simConf->doubleParameter("md_interaction_cutoff_angstrom")*1e-10;
+                for (auto& structure: molecularStructureCollection){
+                    if (structure.second->getIsIon()){
+                        structure.second->buildAtomCellGrid(interactionCutoff_m);
+                    }
+                }
+            }
+        }
+        else if (transportModelType!="btree_HS" && transportModelType!="btree_VSS"){
+            throw std::invalid_argument("Illegal transport model type for transport table generation");
+        }
+
+        // prepare collision model creation  ====================================================
+        // every grid point gets an own collision model instance for the temperature of the grid point
+        auto createCollisionModel = [&](double temperature_K) -> std::unique_ptr<CollisionModel::AbstractCollisionModel>{
+            std::vector<std::unique_ptr<CollisionModel::AbstractCollisionModel>> gasModels;
+            for (std::size_t i = 0; i<nBackgroundGases; ++i) {
+                if (transportModelType=="btree_HS"){
+                    gasModels.emplace_back(std::make_unique<CollisionModel::HardSphereModel>(
+                            backgroundPartialPressures_Pa[i],
+                            temperature_K,
+                            collisionGasMasses_Amu[i],
+                            collisionGasDiameters_m[i]));
+                }
+                else if (transportModelType=="btree_VSS"){
+                    gasModels.emplace_back(std::make_unique<CollisionModel::SoftSphereModel>(
+                            backgroundPartialPressures_Pa[i],
+                            temperature_K,
+                            collisionGasMasses_Amu[i],
+                            collisionGasDiameters_m[i]));
+                }
+                else {
+                    auto forceFieldPtr = std::make_unique<CollisionModel::MDForceField_LJ12_6>(
+                            collisionGasPolarizability_m3[i]);
+                    gasModels.emplace_back(std::make_unique<CollisionModel::MDInteractionsModel>(
+                            backgroundPartialPressures_Pa[i],
+                            temperature_K,
+                            collisionGasMasses_Amu[i],
+                            collisionGasDiameters_m[i],
+                            collisionGasIdentifier[i],
+                            subIntegratorIntegrationTime_s,
+                            subIntegratorStepSize_s,
+                            collisionRadiusScaling,
+                            angleThetaScaling,
+                            spawnRadius_m,
+                            std::move(forceFieldPtr),
+                            molecularStructureCollection));
+                }
+            }
+            return std::make_unique<CollisionModel::MultiCollisionModel>(std::move(gasModels));
+        };
+
+        // simulates the ion swarm of one grid point and extracts the transport coefficients:
+        auto simulateGridPoint = [&](double reducedField_Td, double temperature_K) -> AppUtils::TransportTableEntry{
+            double gasNumberDensity = totalBackgroundPressure_Pa / (Core::K_BOLTZMANN*temperature_K);
+            double eFieldMagnitude = reducedField_Td*1e-21*gasNumberDensity;
+
+            std::unique_ptr<CollisionModel::AbstractCollisionModel> collisionModel = createCollisionModel(temperature_K);
+
+            // the ions start in a small box, the transport coefficients are derived from the temporal change of
+            // the swarm moments and are not affected by the initial swarm shape:
+            std::vector<std::unique_ptr<Core::Particle>> particles;
+            std::vector<Core::Particle*> particlesPtrs;
+            std::vector<Core::Vector> initialPositions = ParticleSimulation::util::getRandomPositionsInBox(
+                    nParticles, Core::Vector(0.0, 0.0, 0.0), Core::Vector(1e-6, 1e-6, 1e-6));
+            for (unsigned int k = 0; k<nParticles; k++) {
+                auto particle = std::make_unique<Core::Particle>(
+                        initialPositions[k], Core::Vector(0.0, 0.0, 0.0), ionCharge, ionMass_amu);
+                if (transportModelType=="btree_MD"){
+                    particle->setMolecularStructure(molecularStructureCollection.at(particleIdentifier));
+                    particle->setDiameter(particle->getMolecularStructure()->getDiameter());
+                }
+                else {
+                    particle->setDiameter(ionDiameter_m);
+                }
+                if (transportModelType=="btree_VSS"){
+                    particle->setFloatAttribute(CollisionModel::SoftSphereModel::VSS_ALPHA, vssCollisionAlpha);
+                    particle->setFloatAttribute(CollisionModel::SoftSphereModel::VSS_OMEGA, vssCollisionOmega);
+                }
+                collisionModel->initializeModelParticleParameters(*particle);
+                particlesPtrs.push_back(particle.get());
+                particles.push_back(std::move(particle));
+            }
+
+            auto accelerationFct =
+                    [eFieldMagnitude](Core::Particle* particle, std::size_t /*particleIndex*/,
+                                      SpaceCharge::FieldCalculator& /*scFieldCalculator*/,
+                                      double /*time*/, unsigned int /*timestep*/){
+                        return Core::Vector(0.0, 0.0, eFieldMagnitude*particle->getCharge()/particle->getMass());
+                    };
+
+            AppUtils::SwarmTransportAnalyzer analyzer;
+            auto postTimestepFct =
+                    [&analyzer, warmupSteps, samplingInterval](Integration::AbstractTimeIntegrator* /*integrator*/,
+                            std::vector<Core::Particle*>& particles, double time, unsigned int timestep,
+                            bool lastTimestep){
+                        if (!lastTimestep && timestep >= warmupSteps && (timestep-warmupSteps) % samplingInterval == 0){
+                            analyzer.addSample(time, particles);
+                        }
+                    };
+
+            Integration::VerletIntegrator integrator(
+                    particlesPtrs, accelerationFct, postTimestepFct,
+                    ParticleSimulation::noFunction, ParticleSimulation::noFunction,
+                    collisionModel.get());
+            integrator.run(warmupSteps + samplingSteps, dt_s);
+
+            AppUtils::TransportTableEntry entry;
+            entry.reducedField_Td = reducedField_Td;
+            entry.temperature_K = temperature_K;
+            entry.coefficients = analyzer.transportCoefficients();
+            entry.mobility = entry.coefficients.driftVelocity_ms / eFieldMagnitude;
+            entry.reducedMobility = entry.mobility *
+                    (totalBackgroundPressure_Pa/Core::REDUCED_MOBILITY_REFERENCE_PRESSURE_PA) *
+                    (Core::REDUCED_MOBILITY_REFERENCE_TEMPERATURE_K/temperature_K);
+            return entry;
+        };
+
+        // simulate the grid points in parallel  ===============================================
+        std::size_t nFields = reducedFields_Td.size();
+        std::size_t nGridPoints = nFields * temperatures_K.size();
+        logger->info("Simulating {} grid points ({} E/N values, {} temperatures) with {} particles",
+                nGridPoints, nFields, temperatures_K.size(), nParticles);
+
+        AppUtils::Stopwatch stopWatch;
+        stopWatch.start();
+
+        std::vector<AppUtils::TransportTableEntry> table(nGridPoints);
+        std::vector<std::string> errorMessages(nGridPoints);
+        #pragma omp parallel for default(none) shared(table, errorMessages, reducedFields_Td, temperatures_K, simulateGridPoint, logger) firstprivate(nFields, nGridPoints) schedule(dynamic)
+        for (std::size_t i = 0; i<nGridPoints; ++i) {
+            double reducedField_Td = reducedFields_Td[i % nFields];
+            double temperature_K = temperatures_K[i / nFields];
+            try {
+                table[i] = simulateGridPoint(reducedField_Td, temperature_K);
+                logger->info("E/N: {} Td T: {} K  v_d: {:.4g} m/s K0: {:.4g} m^2/Vs D_L: {:.4g} D_T: {:.4g} m^2/s",
+                        reducedField_Td, temperature_K, table[i].coefficients.driftVelocity_ms,
+                        table[i].reducedMobility, table[i].coefficients.longitudinalDiffusion_m2s,
+                        table[i].coefficients.transverseDiffusion_m2s);
+            }
+            catch (const std::exception& e){
+                errorMessages[i] = e.what();
+            }
+        }
+        for (const std::string& message: errorMessages){
+            if (!message.empty()){
+                throw std::invalid_argument(message);
+            }
+        }
+
+        // write results  =======================================================================
+        AppUtils::writeTransportTable(projectName+"_transport.csv", table);
+        for (double temperature_K: temperatures_K){
+            std::stringstream filename;
+            filename << projectName << "_mobility_scaling_" << temperature_K << "K.csv";
+            AppUtils::writeMobilityScalingFunction(filename.str(), table, temperature_K);
+        }
+
+        stopWatch.stop();
+        logger->info("CPU time: {} s", stopWatch.elapsedSecondsCPU());
+        logger->info("Finished in {} seconds (wall clock time)", stopWatch.elapsedSecondsWall());
+
+        return 0;
+    }
+    catch(AppUtils::TerminatedWhileCommandlineParsing& terminatedMessage){
+        return terminatedMessage.returnCode();
+    }
+    catch(const std::invalid_argument& ia){
+        std::cout << ia.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
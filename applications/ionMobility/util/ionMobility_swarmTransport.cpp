@@ -0,0 +1,185 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "ionMobility_swarmTransport.hpp"
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+    /**
+     * Collects the entries of a transport table with a background gas temperature, sorted by the reduced field
+     */
+    std::vector<AppUtils::TransportTableEntry> entriesForTemperature(
+            const std::vector<AppUtils::TransportTableEntry>& table, double temperature_K){
+
+        std::vector<AppUtils::TransportTableEntry> result;
+        std::copy_if(table.begin(), table.end(), std::back_inserter(result),
+                [temperature_K](const AppUtils::TransportTableEntry& entry){
+                    return std::fabs(entry.temperature_K - temperature_K) <= 1e-9*temperature_K;
+                });
+        std::sort(result.begin(), result.end(),
+                [](const AppUtils::TransportTableEntry& a, const AppUtils::TransportTableEntry& b){
+                    return a.reducedField_Td < b.reducedField_Td;
+                });
+        if (result.empty()){
+            throw (std::invalid_argument("No transport table entries for requested temperature"));
+        }
+        // the mobility K = v_d / E is undefined at zero field:
+        if (result.front().reducedField_Td <= 0.0){
+            throw (std::invalid_argument("Transport table entries require reduced fields larger than zero"));
+        }
+        return result;
+    }
+}
+
+/**
+ * Adds a sample of the spatial moments of the active particles of the swarm
+ *
+ * @param time the current time
+ * @param particles the particles of the swarm
+ */
+void AppUtils::SwarmTransportAnalyzer::addSample(double time, const std::vector<Core::Particle*>& particles){
+    double nActive = 0.0;
+    Core::Vector mean(0.0, 0.0, 0.0);
+    for (Core::Particle* particle: particles){
+        if (particle->isActive()){
+            mean += particle->getLocation();
+            nActive += 1.0;
+        }
+    }
+    if (nActive < 2.0){
+        throw (std::invalid_argument("Swarm transport analysis requires at least two active particles"));
+    }
+    mean = mean / nActive;
+
+    double varianceZ = 0.0;
+    double varianceXY = 0.0;
+    for (Core::Particle* particle: particles){
+        if (particle->isActive()){
+            Core::Vector deviation = particle->getLocation() - mean;
+            varianceZ += deviation.z()*deviation.z();
+            varianceXY += deviation.x()*deviation.x() + deviation.y()*deviation.y();
+        }
+    }
+
+    times_.push_back(time);
+    meanZ_.push_back(mean.z());
+    varianceZ_.push_back(varianceZ / (nActive - 1.0));
+    varianceXY_.push_back(varianceXY / (nActive - 1.0));
+}
+
+/**
+ * Gets the number of recorded samples
+ */
+std::size_t AppUtils::SwarmTransportAnalyzer::numberOfSamples() const{
+    return times_.size();
+}
+
+/**
+ * Calculates the transport coefficients from the recorded samples (at least two samples are required)
+ */
+AppUtils::SwarmTransportCoefficients AppUtils::SwarmTransportAnalyzer::transportCoefficients() const{
+    if (times_.size() < 2){
+        throw (std::invalid_argument("Swarm transport analysis requires at least two samples"));
+    }
+    SwarmTransportCoefficients result;
+    result.driftVelocity_ms = slope_(meanZ_);
+    result.longitudinalDiffusion_m2s = slope_(varianceZ_) / 2.0;
+    result.transverseDiffusion_m2s = slope_(varianceXY_) / 4.0;
+    return result;
+}
+
+/**
+ * Least squares slope of sampled values with respect to the sample times
+ */
+double AppUtils::SwarmTransportAnalyzer::slope_(const std::vector<double>& values) const{
+    auto n = static_cast<double>(times_.size());
+    double meanTime = 0.0;
+    double meanValue = 0.0;
+    for (std::size_t i=0; i<times_.size(); ++i){
+        meanTime += times_[i];
+        meanValue += values[i];
+    }
+    meanTime /= n;
+    meanValue /= n;
+
+    double covariance = 0.0;
+    double timeVariance = 0.0;
+    for (std::size_t i=0; i<times_.size(); ++i){
+        covariance += (times_[i] - meanTime) * (values[i] - meanValue);
+        timeVariance += (times_[i] - meanTime) * (times_[i] - meanTime);
+    }
+    return covariance / timeVariance;
+}
+
+/**
+ * Writes a transport coefficient table to a semicolon separated file. The field dependence parameter alpha is
+ * the relative change of the mobility with respect to the mobility at the lowest reduced field of the same
+ * temperature.
+ *
+ * @param filename name of the table file to write
+ * @param table the transport table
+ */
+void AppUtils::writeTransportTable(const std::string& filename, const std::vector<TransportTableEntry>& table){
+    std::ofstream outFile(filename);
+    outFile << "# E/N (Td) ; T (K) ; drift velocity (m/s) ; K (m^2/Vs) ; K0 (m^2/Vs) ; alpha ; "
+               "D_L (m^2/s) ; D_T (m^2/s)" << std::endl;
+    outFile << std::setprecision(10);
+    for (const TransportTableEntry& entry: table){
+        double lowFieldMobility = entriesForTemperature(table, entry.temperature_K).front().mobility;
+        outFile << entry.reducedField_Td << ";"
+                << entry.temperature_K << ";"
+                << entry.coefficients.driftVelocity_ms << ";"
+                << entry.mobility << ";"
+                << entry.reducedMobility << ";"
+                << entry.mobility / lowFieldMobility - 1.0 << ";"
+                << entry.coefficients.longitudinalDiffusion_m2s << ";"
+                << entry.coefficients.transverseDiffusion_m2s << std::endl;
+    }
+}
+
+/**
+ * Writes the field dependent mobility scaling (the mobility relative to the mobility at the lowest reduced field)
+ * for one temperature of a transport table as sampled function file (reduced field in Td ; scaling factor), which
+ * can be used as mobility scaling function (e.g. in DMSSimplifiedSim). A sample with scaling factor one at zero
+ * field is prepended (the reduced fields of the table have to be larger than zero).
+ *
+ * @param filename name of the file to write
+ * @param table the transport table
+ * @param temperature_K the temperature to write the scaling function for
+ */
+void AppUtils::writeMobilityScalingFunction(const std::string& filename,
+                                            const std::vector<TransportTableEntry>& table, double temperature_K){
+    std::vector<TransportTableEntry> entries = entriesForTemperature(table, temperature_K);
+    double lowFieldMobility = entries.front().mobility;
+
+    std::ofstream outFile(filename);
+    outFile << "# mobility scaling K(E/N) / K(E/N low) at T = " << temperature_K << " K" << std::endl;
+    outFile << std::setprecision(10);
+    outFile << 0.0 << ";" << 1.0 << std::endl;
+    for (const TransportTableEntry& entry: entries){
+        outFile << entry.reducedField_Td << ";" << entry.mobility / lowFieldMobility << std::endl;
+    }
+}
@@ -0,0 +1,88 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ ionMobility_swarmTransport.hpp
+
+ Extraction of transport coefficients (drift velocity, diffusion coefficients) from simulated ion swarms
+
+ ****************************/
+
+#ifndef IDSIMF_IONMOBILITY_SWARMTRANSPORT_HPP
+#define IDSIMF_IONMOBILITY_SWARMTRANSPORT_HPP
+
+#include "Core_particle.hpp"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace AppUtils{
+
+    /**
+     * Transport coefficients of an ion swarm drifting in a homogeneous electric field along the z axis
+     */
+    struct SwarmTransportCoefficients{
+        double driftVelocity_ms = 0.0; ///< Drift velocity (m/s)
+        double longitudinalDiffusion_m2s = 0.0; ///< Diffusion coefficient parallel to the field (m^2/s)
+        double transverseDiffusion_m2s = 0.0; ///< Diffusion coefficient perpendicular to the field (m^2/s)
+    };
+
+    /**
+     * Extracts the transport coefficients of an ion swarm, which drifts in a homogeneous electric field along
+     * the z axis, from the time evolution of the spatial moments of the swarm.
+     *
+     * The mean z position, the variance of the z positions and the sum of the variances of the x and y positions of
+     * the active particles are sampled at a series of times. The drift velocity is the slope of the mean z position,
+     * the longitudinal / transverse diffusion coefficients are the slopes of the variances divided by 2 / 4
+     * (Einstein relation), the slopes are determined by linear least squares regression.
+     */
+    class SwarmTransportAnalyzer{
+
+    public:
+        void addSample(double time, const std::vector<Core::Particle*>& particles);
+        [[nodiscard]] std::size_t numberOfSamples() const;
+        [[nodiscard]] SwarmTransportCoefficients transportCoefficients() const;
+
+    private:
+        std::vector<double> times_; ///< Sample times
+        std::vector<double> meanZ_; ///< Mean z positions of the swarm
+        std::vector<double> varianceZ_; ///< Variances of the z positions
+        std::vector<double> varianceXY_; ///< Sums of the variances of the x and y positions
+
+        [[nodiscard]] double slope_(const std::vector<double>& values) const;
+    };
+
+    /**
+     * Entry of a transport coefficient table
+     */
+    struct TransportTableEntry{
+        double reducedField_Td = 0.0; ///< Reduced electric field E/N (Td)
+        double temperature_K = 0.0; ///< Background gas temperature (K)
+        SwarmTransportCoefficients coefficients; ///< Transport coefficients
+        double mobility = 0.0; ///< Ion mobility K (m^2/(V s))
+        double reducedMobility = 0.0; ///< Reduced ion mobility K_0 (m^2/(V s))
+    };
+
+    void writeTransportTable(const std::string& filename, const std::vector<TransportTableEntry>& table);
+    void writeMobilityScalingFunction(const std::string& filename, const std::vector<TransportTableEntry>& table,
+                                      double temperature_K);
+}
+
+#endif //IDSIMF_IONMOBILITY_SWARMTRANSPORT_HPP
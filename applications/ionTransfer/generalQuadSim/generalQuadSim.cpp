@@ -32,9 +32,12 @@
 #include "PSim_util.hpp"
 #include "PSim_constants.hpp"
 #include "FileIO_trajectoryHDF5Writer.hpp"
-#include "PSim_interpolatedField.hpp"
+#include "PSim_spatialField.hpp"
+#include "PSim_tetrahedralMeshField.hpp"
 #include "PSim_boxStartZone.hpp"
 #include "Integration_verletIntegrator.hpp"
+#include "Integration_steadyStateBeamIntegrator.hpp"
+#include "SC_steadyStateBeamSolver.hpp"
 #include "CollisionModel_HardSphere.hpp"
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
@@ -63,13 +66,13 @@ int main(int argc, const char * argv[]) {
         double dt = simConf->doubleParameter("dt");
 
         // read interpolated fields ======================
-        std::unique_ptr<ParticleSimulation::InterpolatedField> rhoField = simConf->readInterpolatedField(
+        std::unique_ptr<ParticleSimulation::SpatialField> rhoField = simConf->readSpatialField(
                 "rho_field_file");
-        std::unique_ptr<ParticleSimulation::InterpolatedField> flowField = simConf->readInterpolatedField(
+        std::unique_ptr<ParticleSimulation::SpatialField> flowField = simConf->readSpatialField(
                 "flow_field_file");
-        std::unique_ptr<ParticleSimulation::InterpolatedField> electricFieldQuadRF = simConf->readInterpolatedField(
+        std::unique_ptr<ParticleSimulation::SpatialField> electricFieldQuadRF = simConf->readSpatialField(
                 "electric_field_rf_file");
-        std::unique_ptr<ParticleSimulation::InterpolatedField> electricFieldQuadEntrance = simConf->readInterpolatedField(
+        std::unique_ptr<ParticleSimulation::SpatialField> electricFieldQuadEntrance = simConf->readSpatialField(
                 "electric_field_entrance_file");
 
         // read physical and geometrical simulation parameters
@@ -121,6 +124,10 @@ int main(int argc, const char * argv[]) {
             }
         }
 
+        // per particle location hints (last mesh elements) for the electric fields:
+        std::vector<std::size_t> rfFieldHints(particlePtrs.size(), ParticleSimulation::TetrahedralMeshField::NO_ELEMENT);
+        std::vector<std::size_t> entranceFieldHints(particlePtrs.size(), ParticleSimulation::TetrahedralMeshField::NO_ELEMENT);
+
         auto backgroundGasVelocityFunction = [&flowField](Core::Vector& location) {
             Core::Vector flowVelo = flowField->getInterpolatedVector(location.x(), location.y(), location.z(), 0);
             return flowVelo;
@@ -144,8 +151,9 @@ int main(int argc, const char * argv[]) {
 
 
         // define functions for the trajectory integration ==================================================
-        auto accelerationFunction = [V_rf, V_entrance, spaceChargeFactor, &electricFieldQuadRF, &electricFieldQuadEntrance](
-                Core::Particle* particle, int /*particleIndex*/, SpaceCharge::FieldCalculator& scFieldCalculator,
+        auto accelerationFunction = [V_rf, V_entrance, spaceChargeFactor, &electricFieldQuadRF, &electricFieldQuadEntrance,
+                                     &rfFieldHints, &entranceFieldHints](
+                Core::Particle* particle, int particleIndex, SpaceCharge::FieldCalculator& scFieldCalculator,
                 double time, int /*timestep*/) {
             //x is the long quad axis
             Core::Vector pos = particle->getLocation();
@@ -153,9 +161,11 @@ int main(int argc, const char * argv[]) {
 
             try {
                 Core::Vector E =
-                        (electricFieldQuadRF->getInterpolatedVector(pos.x(), pos.y(), pos.z(), 0)*cos(omega_rf*time)
+                        (electricFieldQuadRF->getInterpolatedVector(pos.x(), pos.y(), pos.z(), 0,
+                                rfFieldHints[static_cast<std::size_t>(particleIndex)])*cos(omega_rf*time)
                                 *V_rf)+
-                                (electricFieldQuadEntrance->getInterpolatedVector(pos.x(), pos.y(), pos.z(), 0)
+                                (electricFieldQuadEntrance->getInterpolatedVector(pos.x(), pos.y(), pos.z(), 0,
+                                        entranceFieldHints[static_cast<std::size_t>(particleIndex)])
                                         *V_entrance);
 
                 Core::Vector spaceChargeForce = scFieldCalculator.getEFieldFromSpaceCharge(*particle)*spaceChargeFactor;
@@ -223,12 +233,88 @@ int main(int argc, const char * argv[]) {
         // simulate ===============================================================================================
         AppUtils::Stopwatch stopWatch;
         stopWatch.start();
-        Integration::VerletIntegrator verletIntegrator(
-                particlePtrs,
-                accelerationFunction, postTimestepFunction, otherActionsFunction, ParticleSimulation::noFunction,
-                &hsModel);
-        AppUtils::SignalHandler::setReceiver(verletIntegrator);
-        verletIntegrator.run(timeSteps, dt);
+        bool steadyStateSpaceCharge = simConf->isParameter("steady_state_space_charge") &&
+                simConf->boolParameter("steady_state_space_charge");
+
+        if (steadyStateSpaceCharge) {
+            // steady state beam simulation: the ions are representative trajectories of a continuous beam, the
+            // space charge field is iterated to self consistency on a grid
+            double beamCurrent = simConf->doubleParameter("steady_state_beam_current_A");
+            std::vector<double> gridMin = simConf->doubleVectorParameter("steady_state_grid_min_mm", 1e-3);
+            std::vector<double> gridMax = simConf->doubleVectorParameter("steady_state_grid_max_mm", 1e-3);
+            std::vector<unsigned int> gridPoints = simConf->unsignedIntVectorParameter("steady_state_grid_points");
+            if (gridMin.size() != 3 || gridMax.size() != 3 || gridPoints.size() != 3) {
+                throw (std::invalid_argument("Steady state space charge grid has to be three dimensional"));
+            }
+            double relaxationFactor = simConf->doubleParameter("steady_state_relaxation");
+            unsigned int maxIterations = simConf->unsignedIntParameter("steady_state_max_iterations");
+            double tolerance = simConf->doubleParameter("steady_state_tolerance");
+
+            SpaceCharge::SteadyStateBeamSolver steadyStateSolver(
+                    {gridMin[0], gridMin[1], gridMin[2]}, {gridMax[0], gridMax[1], gridMax[2]},
+                    {gridPoints[0], gridPoints[1], gridPoints[2]}, relaxationFactor);
+
+            // the trajectories start with random RF phases and carry equal fractions of the beam current:
+            for (Core::Particle* particle: particlePtrs) {
+                particle->setTimeOfBirth(
+                        Core::globalRandomGeneratorPool->getThreadRandomSource()->uniformRealRndValue()/freq_rf);
+            }
+            std::vector<double> currents(particlePtrs.size(), beamCurrent/static_cast<double>(particlePtrs.size()));
+
+            auto terminationFunction = [maxQLength, maxRadius, dt](Core::Vector& newPartPos, Core::Particle* particle,
+                                                                   int /*particleIndex*/, double /*time*/,
+                                                                   int timestep) {
+                double r_pos = std::sqrt(newPartPos.y()*newPartPos.y()+newPartPos.z()*newPartPos.z());
+                if (r_pos>maxRadius || newPartPos.x()>maxQLength || particle->isInvalid()) {
+                    particle->setActive(false);
+                    particle->setSplatTime(timestep*dt);
+                }
+            };
+
+            auto traceStepFunction = [trajectoryWriteInterval, dt, &hdf5Writer, &logger](
+                    std::vector<Core::Particle*>& particles, unsigned int timestep, bool lastTimestep)
+            {
+                double time = timestep*dt;
+                if (timestep%static_cast<unsigned int>(trajectoryWriteInterval)==0) {
+                    hdf5Writer->writeTimestep(particles, time);
+                }
+                if (lastTimestep) {
+                    hdf5Writer->writeTimestep(particles, time);
+                    hdf5Writer->writeSplatTimes(particles);
+                    std::vector<double> ionMasses = std::vector<double>();
+                    for (const auto& particle: particles) {
+                        ionMasses.emplace_back(particle->getMass()/Core::AMU_TO_KG);
+                    }
+                    hdf5Writer->writeNumericListDataset("Particle Masses", ionMasses);
+                    hdf5Writer->finalizeTrajectory();
+                    logger->info("finished final trajectory tracing ts:{} time:{:.2e}", timestep, time);
+                }
+            };
+
+            Integration::SteadyStateBeamIntegrator steadyStateIntegrator(
+                    particlePtrs, currents, steadyStateSolver, accelerationFunction, terminationFunction, &hsModel);
+            std::size_t nIterations = steadyStateIntegrator.run(maxIterations, tolerance, dt, timeSteps);
+            const std::vector<double>& residuals = steadyStateIntegrator.getResiduals();
+            for (std::size_t i=0; i<residuals.size(); ++i) {
+                logger->info("steady state iteration {} residual:{:.3e}", i+1, residuals[i]);
+            }
+            if (residuals.empty() || residuals.back() >= tolerance) {
+                logger->warn("steady state space charge not converged after {} iterations", nIterations);
+            }
+            logger->info("total beam charge:{:.3e} C", steadyStateSolver.getTotalCharge());
+
+            // final tracing with the self consistent field, which is written to the trajectory file (without
+            // deposition of charge, since the field is not updated anymore):
+            steadyStateIntegrator.traceTrajectories(dt, timeSteps, traceStepFunction, false);
+        }
+        else {
+            Integration::VerletIntegrator verletIntegrator(
+                    particlePtrs,
+                    accelerationFunction, postTimestepFunction, otherActionsFunction, ParticleSimulation::noFunction,
+                    &hsModel);
+            AppUtils::SignalHandler::setReceiver(verletIntegrator);
+            verletIntegrator.run(timeSteps, dt);
+        }
 
         stopWatch.stop();
         logger->info("CPU time: {} s", stopWatch.elapsedSecondsCPU());
@@ -33,6 +33,8 @@
 #include "FileIO_scalar_writer.hpp"
 #include "PSim_util.hpp"
 #include "PSim_sampledWaveform.hpp"
+#include "PSim_swiftWaveform.hpp"
+#include "PSim_voltageSchedule.hpp"
 #include "PSim_particleStartSplatTracker.hpp"
 #include "PSim_math.hpp"
 #include "FileIO_averageChargePositionWriter.hpp"
@@ -46,13 +48,12 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_forkedSweep.hpp"
 #include <iostream>
 #include <vector>
 #include <ctime>
 #include <filesystem>
 
-enum RfAmplitudeMode {STATIC_RF,RAMPED_RF};
-enum ExciteMode {RECTPULSE,SWIFT};
 enum FftWriteMode {UNRESOLVED,MASS_RESOLVED};
 
 const std::string key_spaceCharge_x = "keySpaceChargeX";
@@ -106,10 +107,6 @@ int main(int argc, const char * argv[]) {
 
         // SIMION fast adjust PAs use 10000 as normalized potential value, thus we have to scale everything with 1/10000
         double potentialScale = 1.0/10000.0;
-        std::vector<double> potentialsFactorsDc = simConf->doubleVectorParameter("dc_potentials", potentialScale);
-        std::vector<double> potentialFactorsRf = simConf->doubleVectorParameter("rf_potential_factors", potentialScale);
-        std::vector<double> potentialFactorsExcite = simConf->doubleVectorParameter("excite_potential_factors",
-                potentialScale);
         std::vector<double> detectionPAFactorsRaw = simConf->doubleVectorParameter("detection_potential_factors");
         std::vector<ParticleSimulation::SimionPotentialArray*> detectionPAs;
 
@@ -155,44 +152,127 @@ int main(int argc, const char * argv[]) {
         double collisionGasDiameterM = simConf->doubleParameter("collision_gas_diameter_angstrom")*1e-10;
 
 
-        //read rf configuration =========================================================================
-        double f_rf = simConf->doubleParameter("f_rf"); //RF frequency 1e6;
-        double omega = f_rf*2.0*M_PI; //RF angular frequencyf_rf* 2.0 * M_PI;
-
-        RfAmplitudeMode rfMode;
-        std::vector<double> V_0_ramp;
-        double V_0 = 0.0;
-        if (simConf->isParameter("V_rf_start")) {
-            rfMode = RAMPED_RF;
-            double V_rf_start = simConf->doubleParameter("V_rf_start");
-            double V_rf_end = simConf->doubleParameter("V_rf_end");
-            V_0_ramp = ParticleSimulation::linspace(V_rf_start, V_rf_end, static_cast<int>(timeSteps));
-        }
-        else {
-            rfMode = STATIC_RF;
-            V_0 = simConf->doubleParameter("V_rf");
-        }
-        std::vector<double> V_rf_export;
+        //read electrode voltage configuration ========================================================
+        // the electrode voltages are defined by a voltage schedule, which is either given explicitly or
+        // constructed from the dc / rf / excitation configuration of the trap (the voltage schedule is constructed
+        // again from the variant configuration in the variant processes of forked sweeps, the rf ramp and the
+        // excitation of the variants start at the fork time / time step)
+        auto createVoltageSchedule = [&potentialArrays, timeSteps, dt, &logger](
+                const AppUtils::simConf_ptr& conf, double startTime, unsigned int startTimestep)
+                -> std::unique_ptr<ParticleSimulation::VoltageSchedule> {
+            std::unique_ptr<ParticleSimulation::VoltageSchedule> voltageSchedule;
+            if (conf->isParameter("voltage_schedule")) {
+                voltageSchedule = conf->voltageScheduleParameter("voltage_schedule");
+            }
+            else {
+                using Signal = ParticleSimulation::VoltageSchedule::Signal;
+                voltageSchedule = std::make_unique<ParticleSimulation::VoltageSchedule>(potentialArrays.size());
+
+                double f_rf = conf->doubleParameter("f_rf"); //RF frequency 1e6;
+                double V_rf_initial;
+                if (conf->isParameter("V_rf_start")) {
+                    V_rf_initial = conf->doubleParameter("V_rf_start");
+                    double V_rf_end = conf->doubleParameter("V_rf_end");
+                    voltageSchedule->addSignal("rf",
+                            Signal::sine(V_rf_initial, f_rf).setAmplitudeRamp(V_rf_end, startTime, (timeSteps-1)*dt));
+                }
+                else {
+                    V_rf_initial = conf->doubleParameter("V_rf");
+                    voltageSchedule->addSignal("rf", Signal::sine(V_rf_initial, f_rf));
+                }
 
+                double excitePulsePotential = conf->doubleParameter("excite_pulse_potential");
+                if (conf->isParameter("swift_frequency_range_hz")) {
+                    // SWIFT excitation synthesized in process from a frequency domain specification, the notches are
+                    // given either as frequency windows or as m/z windows (converted to secular frequencies at the
+                    // initial RF amplitude)
+                    std::vector<double> frequencyRange = conf->doubleVectorParameter("swift_frequency_range_hz");
+                    std::vector<std::array<double, 2>> notches;
+                    if (conf->isParameter("swift_notches_mz")) {
+                        std::vector<double> notchesMz = conf->doubleVectorParameter("swift_notches_mz");
+                        double r_0 = conf->doubleParameter("swift_r_0_m");
+                        for (std::size_t i = 0; i+1<notchesMz.size(); i += 2) {
+                            notches.push_back({
+                                ParticleSimulation::SwiftWaveform::linearQuadrupoleSecularFrequency(
+                                        notchesMz[i+1], 1.0, V_rf_initial, f_rf, r_0),
+                                ParticleSimulation::SwiftWaveform::linearQuadrupoleSecularFrequency(
+                                        notchesMz[i], 1.0, V_rf_initial, f_rf, r_0)});
+                        }
+                    }
+                    else if (conf->isParameter("swift_notches_hz")) {
+                        std::vector<double> notchesHz = conf->doubleVectorParameter("swift_notches_hz");
+                        for (std::size_t i = 0; i+1<notchesHz.size(); i += 2) {
+                            notches.push_back({notchesHz[i], notchesHz[i+1]});
+                        }
+                    }
+                    auto swiftWaveform = std::make_shared<ParticleSimulation::SwiftWaveform>(
+                            frequencyRange.at(0), frequencyRange.at(1),
+                            conf->doubleParameter("swift_frequency_resolution_hz"), notches);
+                    logger->info("Synthesized SWIFT waveform with {} frequency components and {} notches",
+                            swiftWaveform->numberOfComponents(), notches.size());
+                    voltageSchedule->addSignal("excite", Signal::swift(swiftWaveform, excitePulsePotential)
+                            .setCarrierStart(startTime, startTimestep));
+                }
+                else if (conf->isParameter("excite_waveform_csv_file")) {
+                    std::string swiftFileName = conf->stringParameter("excite_waveform_csv_file");
+                    auto swiftWaveForm = std::make_shared<ParticleSimulation::SampledWaveform>(swiftFileName);
+                    if (!swiftWaveForm->good()) {
+                        logger->error("swift transient file not accessible");
+                        return nullptr;
+                    }
+                    voltageSchedule->addSignal("excite", Signal::sampled(swiftWaveForm, excitePulsePotential)
+                            .setCarrierStart(startTime, startTimestep));
+                }
+                else {
+                    double excitePulseLength = conf->doubleParameter("excite_pulse_length");
+                    voltageSchedule->addSignal("excite",
+                            Signal::pulse(excitePulsePotential, startTime, excitePulseLength));
+                }
 
-        //read excitation / swift configuration ========================================================
-        ExciteMode exciteMode;
-        std::unique_ptr<ParticleSimulation::SampledWaveform> swiftWaveForm;
-        double excitePulseLength = 0.0;
-        if (simConf->isParameter("excite_waveform_csv_file")) {
-            exciteMode = SWIFT;
-            std::string swiftFileName = simConf->stringParameter("excite_waveform_csv_file");
-            swiftWaveForm = std::make_unique<ParticleSimulation::SampledWaveform>(swiftFileName);
-            if (!swiftWaveForm->good()) {
-                logger->error("swift transient file not accessible");
-                return (0);
+                std::vector<double> potentialsDc = conf->doubleVectorParameter("dc_potentials");
+                std::vector<double> potentialFactorsRf = conf->doubleVectorParameter("rf_potential_factors");
+                std::vector<double> potentialFactorsExcite = conf->doubleVectorParameter("excite_potential_factors");
+                for (std::size_t i = 0; i<potentialArrays.size(); ++i) {
+                    voltageSchedule->setElectrodeOffset(i, potentialsDc.at(i));
+                    voltageSchedule->setElectrodeFactor(i, "rf", potentialFactorsRf.at(i));
+                    voltageSchedule->setElectrodeFactor(i, "excite", potentialFactorsExcite.at(i));
+                }
             }
+            if (voltageSchedule->numberOfElectrodes() != potentialArrays.size()) {
+                throw std::invalid_argument("Number of electrodes in voltage schedule does not match number of potential arrays");
+            }
+            return voltageSchedule;
+        };
+        std::unique_ptr<ParticleSimulation::VoltageSchedule> voltageSchedule = createVoltageSchedule(simConf, 0.0, 0);
+        if (!voltageSchedule) {
+            return 0;
         }
-        else {
-            exciteMode = RECTPULSE;
-            excitePulseLength = simConf->doubleParameter("excite_pulse_length");
-        }
-        double excitePulsePotential = simConf->doubleParameter("excite_pulse_potential");
+
+        // the amplitude of the signal "rf" is logged and exported as RF amplitude, the value of the signal
+        // "excite" is logged
+        auto rfAmplitude = [&voltageSchedule](double time) -> double {
+            return voltageSchedule->hasSignal("rf") ? voltageSchedule->signal("rf").amplitude(time) : 0.0;
+        };
+        auto exciteValue = [&voltageSchedule](double time, int timestep) -> double {
+            return voltageSchedule->hasSignal("excite") ?
+                voltageSchedule->signal("excite").value(time, static_cast<unsigned int>(timestep)) : 0.0;
+        };
+        // the rf amplitude is exported with the trajectory if it is ramped:
+        auto isRfAmplitudeRamped = [](const AppUtils::simConf_ptr& conf) -> bool {
+            return !conf->isParameter("voltage_schedule") && conf->isParameter("V_rf_start");
+        };
+        bool rfAmplitudeRamped = isRfAmplitudeRamped(simConf);
+        std::vector<double> V_rf_export;
+
+        // optional forked parameter sweep: the variants are forked from the simulation state after a shared prefix,
+        // only the voltage schedule is constructed again in the variants, thus only its parameters can be varied
+        std::vector<std::string> sweepVariantParameters = {
+                "voltage_schedule", "f_rf", "V_rf", "V_rf_start", "V_rf_end",
+                "excite_pulse_potential", "excite_pulse_length", "excite_waveform_csv_file",
+                "swift_frequency_range_hz", "swift_frequency_resolution_hz", "swift_notches_mz", "swift_notches_hz",
+                "swift_r_0_m", "dc_potentials", "rf_potential_factors", "excite_potential_factors"};
+        std::unique_ptr<AppUtils::ForkedSweep> forkedSweep =
+                AppUtils::createForkedSweep(simConf, simResultBasename, sweepVariantParameters);
 
         //read ion configuration =======================================================================
         std::vector<std::unique_ptr<Core::Particle>> particles;
@@ -212,42 +292,20 @@ int main(int argc, const char * argv[]) {
         // define functions for the trajectory integration ==================================================
         std::size_t ionsInactive = 0;
         auto trapFieldFunction =
-                [exciteMode, rfMode, excitePulseLength, excitePulsePotential, omega, &swiftWaveForm, &V_0, &V_0_ramp,
-                        &potentialArrays, &potentialsFactorsDc, &potentialFactorsRf, &potentialFactorsExcite]
+                [&voltageSchedule, &potentialArrays, potentialScale]
                         (Core::Particle* particle, int /*particleIndex*/,  double time, unsigned int timestep)
                         -> Core::Vector {
 
                     Core::Vector pos = particle->getLocation();
-                    double particleCharge = particle->getCharge();
-                    double excitePotential = 0;
-                    if (exciteMode==RECTPULSE) {
-                        if (time<excitePulseLength) {
-                            excitePotential = excitePulsePotential;
-                        }
-                    }
-                    else {
-                        excitePotential = swiftWaveForm->getValue(timestep)*excitePulsePotential;
-                    }
-
-                    if (rfMode==RAMPED_RF) {
-                        V_0 = V_0_ramp[timestep];
-                    }
+                    const std::vector<double>& electrodeVoltages = voltageSchedule->voltages(time, timestep);
 
                     Core::Vector fEfield(0, 0, 0);
-                    double V_t = V_0*cos(omega*time);
-
                     for (size_t i = 0; i<potentialArrays.size(); ++i) {
                         Core::Vector paField = potentialArrays[i]->getField(pos.x(), pos.y(), pos.z());
-
-                        Core::Vector paEffectiveField =
-                                paField*potentialsFactorsDc.at(i)+
-                                        paField*potentialFactorsRf.at(i)*V_t+
-                                        paField*potentialFactorsExcite.at(i)*excitePotential;
-
-                        fEfield = fEfield+paEffectiveField;
+                        fEfield = fEfield+paField*electrodeVoltages[i];
                     }
 
-                    return fEfield*particleCharge;
+                    return fEfield*(potentialScale*particle->getCharge());
                 };
 
         double axialPotential_upperStart = axialPotentialCenter+axialPotentialFloowWidth;
@@ -317,12 +375,6 @@ int main(int argc, const char * argv[]) {
         };
 
         //prepare file writers and data writing functions ==============================================================================
-        auto avgPositionWriter = std::make_unique<FileIO::AverageChargePositionWriter>(
-                simResultBasename+"_averagePosition.txt");
-
-        auto fftWriter = std::make_unique<FileIO::InductionCurrentWriter>(
-                particlePtrs, simResultBasename+"_fft.txt", detectionPAs, detectionPAFactors, paSpatialScale);
-        auto ionsInactiveWriter = std::make_unique<FileIO::Scalar_writer>(simResultBasename+"_ionsInactive.txt");
 
         FileIO::partAttribTransformFctType particleAttributesTransformFct =
                 [](Core::Particle* particle) -> std::vector<double> {
@@ -358,17 +410,42 @@ int main(int argc, const char * argv[]) {
 
         std::vector<std::string> integerParticleAttributesNames = {"global index", "index"};
 
-        auto hdf5Writer = std::make_unique<FileIO::TrajectoryHDF5Writer>(cmdLineParser.trajectoriesResultName());
-        hdf5Writer->setParticleAttributes(particleAttributesNames, particleAttributesTransformFct);
-        hdf5Writer->setParticleAttributes(integerParticleAttributesNames, integerParticleAttributesTransformFct);
+        // the result files are named with a result base name and the trajectory file name (the variant processes of
+        // forked sweeps write their own result files):
+        std::unique_ptr<FileIO::AverageChargePositionWriter> avgPositionWriter;
+        std::unique_ptr<FileIO::InductionCurrentWriter> fftWriter;
+        std::unique_ptr<FileIO::Scalar_writer> ionsInactiveWriter;
+        std::unique_ptr<FileIO::TrajectoryHDF5Writer> hdf5Writer;
+        auto createFileWriters = [&avgPositionWriter, &fftWriter, &ionsInactiveWriter, &hdf5Writer, &particlePtrs,
+                                  &detectionPAs, &detectionPAFactors, paSpatialScale,
+                                  &particleAttributesNames, &particleAttributesTransformFct,
+                                  &integerParticleAttributesNames, &integerParticleAttributesTransformFct](
+                const std::string& resultBasename, const std::string& trajectoriesResultName) {
+            avgPositionWriter = std::make_unique<FileIO::AverageChargePositionWriter>(
+                    resultBasename+"_averagePosition.txt");
+            fftWriter = std::make_unique<FileIO::InductionCurrentWriter>(
+                    particlePtrs, resultBasename+"_fft.txt", detectionPAs, detectionPAFactors, paSpatialScale);
+            ionsInactiveWriter = std::make_unique<FileIO::Scalar_writer>(resultBasename+"_ionsInactive.txt");
+            hdf5Writer = std::make_unique<FileIO::TrajectoryHDF5Writer>(trajectoriesResultName);
+            hdf5Writer->setParticleAttributes(particleAttributesNames, particleAttributesTransformFct);
+            hdf5Writer->setParticleAttributes(integerParticleAttributesNames, integerParticleAttributesTransformFct);
+        };
+        createFileWriters(simResultBasename, cmdLineParser.trajectoriesResultName());
 
         auto postTimestepFunction =
-                [trajectoryWriteInterval, fftWriteInterval, fftWriteMode, &V_0, &V_rf_export, &ionsInactive,
-                 &hdf5Writer, &startSplatTracker, &ionsInactiveWriter, &fftWriter, &logger](
+                [trajectoryWriteInterval, fftWriteInterval, fftWriteMode, &rfAmplitude, &exciteValue, &V_rf_export, &ionsInactive,
+                 &hdf5Writer, &startSplatTracker, &ionsInactiveWriter, &fftWriter, &avgPositionWriter, &logger,
+                 &forkedSweep, &createFileWriters, &voltageSchedule, &createVoltageSchedule,
+                 &isRfAmplitudeRamped, &rfAmplitudeRamped](
                         Integration::AbstractTimeIntegrator* integrator,
                         std::vector<Core::Particle*>& particles, double time, int timestep,
                         bool lastTimestep)
                 {
+                    // the prefix process of a forked sweep has no results after the variants are forked:
+                    if (!hdf5Writer) {
+                        return;
+                    }
+                    bool forkTimestep = forkedSweep && forkedSweep->isForkTimestep(static_cast<unsigned int>(timestep));
 
                     // check if simulation should be terminated (if all particles are terminated)
                     if (ionsInactive>=particles.size() && particles.size()>0) {
@@ -389,18 +466,44 @@ int main(int argc, const char * argv[]) {
                         }
                     }
 
-                    if (timestep%trajectoryWriteInterval==0 || lastTimestep) {
-                        logger->info("ts:{} time:{:.2e} V_rf:{:.1f} ions existing:{} ions inactive:{}",
-                                timestep, time, V_0, particles.size(), ionsInactive);
-                        V_rf_export.emplace_back(V_0);
+                    if (timestep%trajectoryWriteInterval==0 || lastTimestep || forkTimestep) {
+                        double V_rf = rfAmplitude(time);
+                        logger->info("ts:{} time:{:.2e} V_rf:{:.1f} V_excite:{:.1f} ions existing:{} ions inactive:{}",
+                                timestep, time, V_rf, exciteValue(time, timestep), particles.size(), ionsInactive);
+                        V_rf_export.emplace_back(V_rf);
                         hdf5Writer->writeTimestep(particles, time);
                     }
 
-                    if (lastTimestep) {
+                    if (lastTimestep || forkTimestep) {
                         hdf5Writer->writeStartSplatData(startSplatTracker);
                         hdf5Writer->finalizeTrajectory();
+                        if (rfAmplitudeRamped) {
+                            hdf5Writer->writeNumericListDataset("V_rf", V_rf_export);
+                        }
                         logger->info("finished ts:{} time:{:.2e}", timestep, time);
                     }
+
+                    if (forkTimestep) {
+                        // the result files of the prefix are closed before the variants are forked:
+                        avgPositionWriter.reset();
+                        fftWriter.reset();
+                        ionsInactiveWriter.reset();
+                        hdf5Writer.reset();
+                        if (forkedSweep->forkVariants(logger) == AppUtils::ForkedSweep::PREFIX_PROCESS) {
+                            integrator->setTerminationState();
+                        }
+                        else {
+                            voltageSchedule = createVoltageSchedule(
+                                    forkedSweep->variantConfiguration(), time, static_cast<unsigned int>(timestep));
+                            if (!voltageSchedule) {
+                                throw (std::invalid_argument("Invalid voltage schedule of sweep variant"));
+                            }
+                            rfAmplitudeRamped = isRfAmplitudeRamped(forkedSweep->variantConfiguration());
+                            V_rf_export.clear();
+                            std::string variantResultName = forkedSweep->variantResultName(forkedSweep->variantIndex());
+                            createFileWriters(variantResultName, variantResultName+"_trajectories.h5");
+                        }
+                    }
                 };
 
         CollisionModel::HardSphereModel hsModel(backgroundPressure,
@@ -418,13 +521,15 @@ int main(int argc, const char * argv[]) {
                 accelerationFunctionLIT,
                 postTimestepFunction, otherActionsFunctionQIT, particleStartMonitoringFct, &hsModel);
 
-        if (rfMode==RAMPED_RF) {
-            hdf5Writer->writeNumericListDataset("V_rf", V_rf_export);
-        }
         stopWatch.stop();
 
         logger->info("CPU time: {} s", stopWatch.elapsedSecondsCPU());
         logger->info("Finished in {} seconds (wall clock time)", stopWatch.elapsedSecondsWall());
+        if (forkedSweep && forkedSweep->numberOfFailedVariants() > 0) {
+            logger->error("{} of {} sweep variants failed",
+                    forkedSweep->numberOfFailedVariants(), forkedSweep->numberOfVariants());
+            return EXIT_FAILURE;
+        }
         return 0;
     }
     catch(const ParticleSimulation::PotentialArrayException& pe)
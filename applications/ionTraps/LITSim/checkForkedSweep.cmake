@@ -0,0 +1,46 @@
+# Checks the voltage schedules of the variants of the forked sweep example (simpleQuadLIT_forkedSweep.json) from
+# the variant log files:
+#   - variant 1 ramps the RF amplitude from V_rf_start = V_rf of the prefix, thus V_rf has to be continuous at the fork
+#   - variant 3 has an excitation pulse, which has to fire after the fork
+#
+# usage: cmake -DRESULT_NAME=<result base name of the sweep> -DFORK_TIMESTEP=<n> -DCHECK_TIMESTEP=<n> -P checkForkedSweep.cmake
+
+function(read_log_values LOG_FILE TIMESTEP V_RF_VAR V_EXCITE_VAR)
+    if(NOT EXISTS ${LOG_FILE})
+        message(FATAL_ERROR "Log file ${LOG_FILE} not found")
+    endif()
+    file(STRINGS ${LOG_FILE} LOG_LINES REGEX " V_rf:.* V_excite:")
+    list(FILTER LOG_LINES INCLUDE REGEX " ts:${TIMESTEP} time:")
+    if(NOT LOG_LINES)
+        message(FATAL_ERROR "No voltages for time step ${TIMESTEP} in ${LOG_FILE}")
+    endif()
+    list(GET LOG_LINES -1 LOG_LINE)
+    if(NOT LOG_LINE MATCHES "V_rf:([-0-9.]+) V_excite:([-0-9.]+)")
+        message(FATAL_ERROR "No voltages for time step ${TIMESTEP} in ${LOG_FILE}")
+    endif()
+    set(${V_RF_VAR} ${CMAKE_MATCH_1} PARENT_SCOPE)
+    set(${V_EXCITE_VAR} ${CMAKE_MATCH_2} PARENT_SCOPE)
+endfunction()
+
+read_log_values(${RESULT_NAME}.log ${FORK_TIMESTEP} V_RF_PREFIX V_EXCITE_PREFIX)
+read_log_values(${RESULT_NAME}_variant_1.log ${CHECK_TIMESTEP} V_RF_RAMP V_EXCITE_RAMP)
+read_log_values(${RESULT_NAME}_variant_3.log ${CHECK_TIMESTEP} V_RF_PULSE V_EXCITE_PULSE)
+
+# the voltages are logged with one decimal place, they are compared as integer multiples of 0.1 V:
+foreach(VOLTAGE V_RF_PREFIX V_RF_RAMP V_EXCITE_PREFIX V_EXCITE_PULSE)
+    string(REPLACE "." "" ${VOLTAGE}_DV ${${VOLTAGE}})
+endforeach()
+
+# the RF amplitude of the ramped variant must not differ more than 1 V from the prefix shortly after the fork:
+math(EXPR V_RF_DIFFERENCE_DV "${V_RF_RAMP_DV} - ${V_RF_PREFIX_DV}")
+if(V_RF_DIFFERENCE_DV GREATER 10 OR V_RF_DIFFERENCE_DV LESS -10)
+    message(FATAL_ERROR "V_rf not continuous at the fork: ${V_RF_PREFIX} (prefix) / ${V_RF_RAMP} (variant 1)")
+endif()
+
+# the excitation pulse of the pulse variant starts at the fork:
+if(NOT V_EXCITE_PREFIX_DV EQUAL 0 OR V_EXCITE_PULSE_DV EQUAL 0)
+    message(FATAL_ERROR
+        "Excitation pulse not fired after the fork: ${V_EXCITE_PREFIX} (prefix) / ${V_EXCITE_PULSE} (variant 3)")
+endif()
+message(STATUS "V_rf at the fork: ${V_RF_PREFIX} (prefix) / ${V_RF_RAMP} (variant 1), "
+    "V_excite after the fork: ${V_EXCITE_PULSE} (variant 3)")
@@ -28,14 +28,17 @@
 
 #include "Core_particle.hpp"
 #include "FileIO_trajectoryHDF5Writer.hpp"
+#include "FileIO_sharedMemoryFrameWriter.hpp"
 #include "PSim_util.hpp"
 #include "FileIO_scalar_writer.hpp"
 #include "PSim_sampledWaveform.hpp"
+#include "PSim_voltageSchedule.hpp"
 #include "PSim_math.hpp"
 #include "FileIO_averageChargePositionWriter.hpp"
 #include "FileIO_idealizedQitFFTWriter.hpp"
 #include "PSim_particleStartSplatTracker.hpp"
 #include "CollisionModel_HardSphere.hpp"
+#include "Integration_floquetQuadrupoleIntegrator.hpp"
 #include "appUtils_simulationConfiguration.hpp"
 #include "appUtils_integrationRunning.hpp"
 #include "appUtils_ionDefinitionReading.hpp"
@@ -43,14 +46,12 @@
 #include "appUtils_stopwatch.hpp"
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
+#include "appUtils_memoryReporting.hpp"
 #include <iostream>
 #include <vector>
 
 enum GeometryMode {DEFAULT, SCALED,VARIABLE};
-enum RfAmplitudeMode {STATIC_RF, RAMPED_RF};
-enum RfWaveMode {SINE, SAMPLED};
 enum FieldMode {BASIC, HIGHER_ORDERS, AVERAGED};
-enum ExciteMode {RECTPULSE, SWIFT};
 enum FftWriteMode {UNRESOLVED, MASS_RESOLVED, ION_CLOUD_POSITION};
 
 std::string key_spaceCharge_x = "keySpaceChargeX";
@@ -67,6 +68,10 @@ std::string key_velocity_z = "keyVeloZ";
 constexpr double r_0_default = 10.0 / 1000.0;
 constexpr double z_0_default = 7.0  / 1000.0;
 
+// "electrodes" of the voltage schedule of the idealized trap:
+constexpr std::size_t RING_ELECTRODE = 0; // voltage between ring and end cap electrodes (dc + rf)
+constexpr std::size_t EXCITE_ELECTRODE = 1; // dipolar excitation voltage between the end cap electrodes
+
 
 int main(int argc, const char * argv[]) {
 
@@ -159,60 +164,91 @@ int main(int argc, const char * argv[]) {
         double f_rf = simConf->doubleParameter("f_rf"); //RF frequency 1e6;
         double omega = f_rf*2.0*M_PI; //RF angular frequency_rf* 2.0 * M_PI;
 
-        // read sampled RF waveform
-        RfWaveMode rfWaveMode;
-        std::unique_ptr<ParticleSimulation::SampledWaveform> rfSampledWaveForm;
+        // the time dependent voltages of the trap are defined by a voltage schedule:
+        using Signal = ParticleSimulation::VoltageSchedule::Signal;
+        ParticleSimulation::VoltageSchedule voltageSchedule(2);
+
+        // read RF amplitude configuration
+        double V_rf_start = 0.0;
+        double V_rf_end = 0.0;
+        bool rfAmplitudeRamped = simConf->isParameter("V_rf_start");
+        if (rfAmplitudeRamped) {
+            V_rf_start = simConf->doubleParameter("V_rf_start");
+            V_rf_end = simConf->doubleParameter("V_rf_end");
+        }
+        else {
+            V_rf_start = simConf->doubleParameter("V_rf");
+            V_rf_end = V_rf_start;
+        }
+
+        // read RF waveform (sine or sampled RF waveform)
         if (simConf->isParameter("rf_waveform_csv_file")) {
-            rfWaveMode = SAMPLED;
             std::string rfWaveformFileName = simConf->pathRelativeToConfFile(
                     simConf->stringParameter("rf_waveform_csv_file"));
 
-            rfSampledWaveForm = std::make_unique<ParticleSimulation::SampledWaveform>(rfWaveformFileName);
+            auto rfSampledWaveForm = std::make_shared<ParticleSimulation::SampledWaveform>(rfWaveformFileName);
             if (!rfSampledWaveForm->good()) {
                 logger->error("rf waveform file not accessible");
                 return EXIT_FAILURE;
             }
+            voltageSchedule.addSignal("rf", Signal::sampled(rfSampledWaveForm, V_rf_start, true)
+                    .setAmplitudeRamp(V_rf_end, 0.0, (timeSteps-1)*dt));
         }
         else {
-            rfWaveMode = SINE;
-        }
-
-        // read RF amplitude configuration
-        RfAmplitudeMode rfAmplitudeMode;
-        std::vector<double> V_0_ramp;
-        double V_0 = 0.0;
-        if (simConf->isParameter("V_rf_start")) {
-            rfAmplitudeMode = RAMPED_RF;
-            double V_rf_start = simConf->doubleParameter("V_rf_start");
-            double V_rf_end = simConf->doubleParameter("V_rf_end");
-            V_0_ramp = ParticleSimulation::linspace(V_rf_start, V_rf_end, static_cast<int>(timeSteps));
-        }
-        else {
-            rfAmplitudeMode = STATIC_RF;
-            V_0 = simConf->doubleParameter("V_rf");
+            voltageSchedule.addSignal("rf", Signal::sine(V_rf_start, f_rf)
+                    .setAmplitudeRamp(V_rf_end, 0.0, (timeSteps-1)*dt));
         }
+        voltageSchedule.setElectrodeOffset(RING_ELECTRODE, U_0);
+        voltageSchedule.setElectrodeFactor(RING_ELECTRODE, "rf", 1.0);
         std::vector<double> V_rf_export;
 
 
         //read excitation / swift configuration ========================================================
-
-        ExciteMode exciteMode;
-        std::unique_ptr<ParticleSimulation::SampledWaveform> swiftWaveForm;
-        double excitePulseLength = 0.0;
+        double excitePulsePotential = simConf->doubleParameter("excite_pulse_potential");
         if (simConf->isParameter("excite_waveform_csv_file")) {
-            exciteMode = SWIFT;
             std::string swiftFileName = simConf->stringParameter("excite_waveform_csv_file");
-            swiftWaveForm = std::make_unique<ParticleSimulation::SampledWaveform>(swiftFileName);
+            auto swiftWaveForm = std::make_shared<ParticleSimulation::SampledWaveform>(swiftFileName);
             if (!swiftWaveForm->good()) {
                 logger->error("swift transient file not accessible");
                 return EXIT_FAILURE;
             }
+            voltageSchedule.addSignal("excite", Signal::sampled(swiftWaveForm, excitePulsePotential));
         }
         else {
-            exciteMode = RECTPULSE;
-            excitePulseLength = simConf->doubleParameter("excite_pulse_length");
+            double excitePulseLength = simConf->doubleParameter("excite_pulse_length");
+            voltageSchedule.addSignal("excite", Signal::pulse(excitePulsePotential, 0.0, excitePulseLength));
+        }
+        voltageSchedule.setElectrodeFactor(EXCITE_ELECTRODE, "excite", 1.0);
+        // (the signal reference is taken after all signals are added, adding signals invalidates it)
+        const Signal& rfSignal = voltageSchedule.signal("rf");
+
+
+        //read optional Floquet propagation configuration ===============================================
+        // in an ideal quadrupole field without space charge and collisions, the ions can be propagated by whole RF
+        // periods with precomputed transfer matrices. The time step is then a whole number of RF periods, the number
+        // of time steps and the write intervals are converted to keep the simulated time and the output times.
+        bool floquetPropagation =
+                simConf->isParameter("floquet_propagation") && simConf->boolParameter("floquet_propagation");
+        double floquetDt = 0.0;
+        auto toFloquetTimesteps = [dt, &floquetDt](unsigned int nTimesteps) -> unsigned int {
+            return std::max(1u, static_cast<unsigned int>(std::lround(nTimesteps*dt/floquetDt)));
+        };
+        if (floquetPropagation) {
+            if (fieldMode!=BASIC || spaceChargeFactor>0 || backgroundPressure>0 ||
+                    simConf->isParameter("rf_waveform_csv_file")) {
+                throw std::invalid_argument("floquet_propagation requires field_mode basic, a sine RF, "
+                                            "no space charge and no background gas");
+            }
+            unsigned int periodsPerTimestep = 1;
+            if (simConf->isParameter("floquet_periods_per_step")) {
+                periodsPerTimestep = simConf->unsignedIntParameter("floquet_periods_per_step");
+            }
+            floquetDt = periodsPerTimestep/f_rf;
+            timeSteps = toFloquetTimesteps(timeSteps);
+            trajectoryWriteInterval = toFloquetTimesteps(trajectoryWriteInterval);
+            fftWriteInterval = toFloquetTimesteps(fftWriteInterval);
+            logger->info("Floquet propagation: {} time steps of {} RF periods", timeSteps, periodsPerTimestep);
         }
-        double excitePulsePotential = simConf->doubleParameter("excite_pulse_potential");
 
 
 
@@ -232,26 +268,13 @@ int main(int argc, const char * argv[]) {
 
         // define functions for the trajectory integration ==================================================
         auto trapFieldFunction =
-                [exciteMode, rfWaveMode, rfAmplitudeMode, fieldMode, excitePulseLength, excitePulsePotential,
-                        omega, z_0, r_0, U_0, d_square_2,
-                        &rfSampledWaveForm, &higherFieldOrdersCoefficients, &swiftWaveForm, &V_0, &V_0_ramp](
+                [fieldMode, omega, z_0, r_0, d_square_2,
+                        &voltageSchedule, &rfSignal, &higherFieldOrdersCoefficients](
                         Core::Particle* particle, Core::Vector pPos, double time, unsigned int timestep) -> Core::Vector
                 {
                     double particleCharge = particle->getCharge();
-                    double excitePotential = 0;
-                    if (exciteMode==RECTPULSE) {
-                        if (time<excitePulseLength) {
-                            excitePotential = excitePulsePotential;
-                        }
-                    }
-                    else {
-                        excitePotential = swiftWaveForm->getValue(timestep)*excitePulsePotential;
-                    }
-
-                    if (rfAmplitudeMode==RAMPED_RF) {
-                        V_0 = V_0_ramp[timestep];
-                    }
-                    double a_ex = excitePotential/z_0*particleCharge;
+                    const std::vector<double>& trapVoltages = voltageSchedule.voltages(time, timestep);
+                    double a_ex = trapVoltages[EXCITE_ELECTRODE]/z_0*particleCharge;
 
                     if (fieldMode==AVERAGED){
                         // transform to z-r space, calculate higher orders and transform force back to cartesian space
@@ -261,6 +284,7 @@ int main(int argc, const char * argv[]) {
 
                         double ponderomotiveForceFactor = -(particleCharge*particleCharge) / (2.0 * particle->getMass() * omega * omega);
 
+                        double V_0 = rfSignal.amplitude(time);
                         double rz_0Factor = r_0*r_0 + 2*z_0*z_0;
                         double a_2_avg = V_0 * V_0 / (2*rz_0Factor*rz_0Factor);
 
@@ -277,17 +301,12 @@ int main(int argc, const char * argv[]) {
                         return averagedRFForce;
                     }
                     else {
-                        double V_rf = 0.0;
-                        if (rfWaveMode==SINE) {
-                            V_rf = V_0*cos(omega*time);
-                        }
-                        else if (rfWaveMode==SAMPLED) {
-                            V_rf = V_0*rfSampledWaveForm->getValueLooped(timestep);
-                        }
+                        // voltage between ring and end caps (dc + rf):
+                        double U_ring = trapVoltages[RING_ELECTRODE];
 
                         Core::Vector rfForce(0, 0, 0);
                         if (fieldMode==BASIC) {
-                            double a = (U_0+V_rf)/d_square_2*particleCharge;
+                            double a = U_ring/d_square_2*particleCharge;
 
                             rfForce = Core::Vector(
                                     -a*pPos.x(),
@@ -305,7 +324,7 @@ int main(int argc, const char * argv[]) {
                             double phi = std::atan2(pPos.x(), pPos.y());
 
                             //d_square_2 == r_0^2 for ideal electrode geometry
-                            double phi_0 = (U_0+V_rf)/2.0*particleCharge;
+                            double phi_0 = U_ring/2.0*particleCharge;
 
                             // ideal quadropole field:
                             double E_2_r = 2.0*r/d_square_2;
@@ -403,6 +422,15 @@ int main(int argc, const char * argv[]) {
             }
         };
 
+        // report the memory usage at startup, a dry run ends here before any result file is created ==================
+        Core::MemoryReport startupMemoryReport;
+        AppUtils::addParticleMemoryUsage(startupMemoryReport, particlePtrs);
+        AppUtils::logMemoryReport(startupMemoryReport, "startup", logger);
+        if (cmdLineParser.dryRun()) {
+            logger->info("Dry run: simulation not started");
+            return EXIT_SUCCESS;
+        }
+
         //prepare file writers and data writing functions ==============================================================================
         /*auto avgPositionWriter = std::make_unique<FileIO::AverageChargePositionWriter>(
                 simResultBasename+"_averagePosition.txt");*/
@@ -443,15 +471,55 @@ int main(int argc, const char * argv[]) {
         auto hdf5Writer = std::make_unique<FileIO::TrajectoryHDF5Writer>(cmdLineParser.trajectoriesResultName());
         hdf5Writer->setParticleAttributes(auxParamNames, additionalParameterTransformFct);
         hdf5Writer->setParticleAttributes(integerParticleAttributesNames, integerParticleAttributesTransformFct);
+        if (simConf->isParameter("trajectory_position_error")) {
+            double attributeError = 0.0;
+            if (simConf->isParameter("trajectory_attribute_error")) {
+                attributeError = simConf->doubleParameter("trajectory_attribute_error");
+            }
+            hdf5Writer->setQuantization(simConf->doubleParameter("trajectory_position_error"), attributeError);
+        }
+
+        // optional live output of the particle frames into a shared memory ring buffer:
+        std::unique_ptr<FileIO::SharedMemoryFrameWriter> liveFrameWriter;
+        unsigned int liveFramesWriteInterval = trajectoryWriteInterval;
+        if (simConf->isParameter("live_frames_shm_name")) {
+            liveFrameWriter = std::make_unique<FileIO::SharedMemoryFrameWriter>(
+                    simConf->stringParameter("live_frames_shm_name"), particlePtrs.size());
+            liveFrameWriter->setParticleAttributes(auxParamNames, additionalParameterTransformFct);
+            if (simConf->isParameter("live_frames_write_interval")) {
+                liveFramesWriteInterval = simConf->unsignedIntParameter("live_frames_write_interval");
+                if (floquetPropagation) {
+                    liveFramesWriteInterval = toFloquetTimesteps(liveFramesWriteInterval);
+                }
+            }
+        }
+
+        // memory usage of the simulation subsystems, reported with the space charge solver of the running integrator:
+        auto memoryReport = [&particlePtrs, &hdf5Writer, &liveFrameWriter](
+                const Integration::AbstractTimeIntegrator* integrator){
+            Core::MemoryReport report;
+            AppUtils::addParticleMemoryUsage(report, particlePtrs);
+            if (integrator != nullptr) {
+                AppUtils::addIntegratorMemoryUsage(report, *integrator);
+            }
+            report.add("trajectory writer", hdf5Writer->memoryUsageBytes(particlePtrs.size()));
+            if (liveFrameWriter) {
+                report.add("live frame writer", liveFrameWriter->memoryUsageBytes());
+            }
+            return report;
+        };
 
         auto postTimestepFunction =
-                [trajectoryWriteInterval, fftWriteInterval, fftWriteMode, &V_0, &V_rf_export, &ionsInactive,
-                &hdf5Writer, &ionsInactiveWriter,
-                &fftWriter, &startSplatTracker, &logger](
-                        Integration::AbstractTimeIntegrator* /*integrator*/,
+                [trajectoryWriteInterval, fftWriteInterval, fftWriteMode, &rfSignal, &V_rf_export, &ionsInactive,
+                &hdf5Writer, &ionsInactiveWriter, &liveFrameWriter, liveFramesWriteInterval,
+                &fftWriter, &startSplatTracker, &memoryReport, &logger](
+                        Integration::AbstractTimeIntegrator* integrator,
                         std::vector<Core::Particle*>& particles, double time, unsigned int timestep,
                         bool lastTimestep)
                 {
+                    if (liveFrameWriter && timestep%liveFramesWriteInterval==0) {
+                        liveFrameWriter->writeTimestep(particles, time);
+                    }
 
                     if (timestep%fftWriteInterval==0) {
                         ionsInactiveWriter->writeTimestep(ionsInactive, time);
@@ -467,7 +535,7 @@ int main(int argc, const char * argv[]) {
                     }
 
                     if (lastTimestep) {
-                        V_rf_export.emplace_back(V_0);
+                        V_rf_export.emplace_back(rfSignal.amplitude(time));
                         hdf5Writer->writeStartSplatData(startSplatTracker);
                         hdf5Writer->writeTimestep(particles, time);
                         std::vector<double> ionMasses = std::vector<double>();
@@ -477,11 +545,12 @@ int main(int argc, const char * argv[]) {
                         hdf5Writer->writeNumericListDataset("Particle Masses", ionMasses);
                         hdf5Writer->finalizeTrajectory();
                         logger->info("finished ts:{} time:{:.2e}", timestep, time);
+                        AppUtils::logMemoryReport(memoryReport(integrator), "end of simulation", logger);
                     }
                     else if (timestep%trajectoryWriteInterval==0) {
                         logger->info("ts:{} time:{:.2e} V_rf:{:.1f} ions existing:{} ions inactive:{}",
-                                timestep, time, V_0, particles.size(), ionsInactive);
-                        V_rf_export.emplace_back(V_0);
+                                timestep, time, rfSignal.amplitude(time), particles.size(), ionsInactive);
+                        V_rf_export.emplace_back(rfSignal.amplitude(time));
                         hdf5Writer->writeTimestep(particles, time);
                     }
                 };
@@ -491,20 +560,39 @@ int main(int argc, const char * argv[]) {
                 collisionGasMassAmu,
                 collisionGasDiameterM);
 
-
         // simulate ===============================================================================================
         AppUtils::Stopwatch stopWatch;
         stopWatch.start();
 
-        AppUtils::runTrajectoryIntegration(
-                simConf, timeSteps, dt,
-                particlePtrs,
-                accelerationFctQIT_verletIntegration,
-                accelerationFctTrapField_RKIntegration,
-                spaceChargeAccelerationFct_RKIntegration,
-                postTimestepFunction, otherActionsFunctionQIT, particleStartMonitoringFct, &hsModel);
+        if (floquetPropagation) {
+            // the excitation is sampled by the propagation within the RF periods, sampled excitation waveforms are
+            // indexed with the time steps of the configured time step length:
+            auto excitationFieldFct = [&voltageSchedule, z_0, dt](double time) {
+                auto timestep = static_cast<unsigned int>(std::lround(time/dt));
+                return Core::Vector(0.0, 0.0, voltageSchedule.voltage(EXCITE_ELECTRODE, time, timestep)/z_0);
+            };
+            auto rfAmplitudeFct = [&rfSignal](double time) {
+                return rfSignal.amplitude(time);
+            };
+            Integration::FloquetQuadrupoleIntegrator floquetIntegrator(
+                    particlePtrs,
+                    Core::Vector(1.0/d_square_2, 1.0/d_square_2, -2.0/d_square_2),
+                    f_rf, rfAmplitudeFct, U_0, excitationFieldFct,
+                    postTimestepFunction, otherActionsFunctionQIT, particleStartMonitoringFct);
+            AppUtils::SignalHandler::setReceiver(floquetIntegrator);
+            floquetIntegrator.run(timeSteps, floquetDt);
+        }
+        else {
+            AppUtils::runTrajectoryIntegration(
+                    simConf, timeSteps, dt,
+                    particlePtrs,
+                    accelerationFctQIT_verletIntegration,
+                    accelerationFctTrapField_RKIntegration,
+                    spaceChargeAccelerationFct_RKIntegration,
+                    postTimestepFunction, otherActionsFunctionQIT, particleStartMonitoringFct, &hsModel);
+        }
 
-        if (rfAmplitudeMode==RAMPED_RF) {
+        if (rfAmplitudeRamped) {
             hdf5Writer->writeNumericListDataset("V_rf", V_rf_export);
         }
         stopWatch.stop();
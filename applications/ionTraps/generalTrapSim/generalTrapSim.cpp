@@ -44,6 +44,7 @@
 #include "appUtils_signalHandler.hpp"
 #include "appUtils_commandlineParser.hpp"
 #include "appUtils_integrationRunning.hpp"
+#include "appUtils_memoryReporting.hpp"
 #include "FileIO_ionCloudReader.hpp"
 #include <iostream>
 #include <vector>
@@ -321,6 +322,18 @@ int main(int argc, const char * argv[]) {
             }
         };
 
+        // report the memory usage at startup, a dry run ends here before any result file is created ==================
+        Core::MemoryReport startupMemoryReport;
+        for (const auto& pa: potentialArrays) {
+            startupMemoryReport.add("potential arrays", pa->dataSizeBytes());
+        }
+        AppUtils::addParticleMemoryUsage(startupMemoryReport, particlePtrs);
+        AppUtils::logMemoryReport(startupMemoryReport, "startup", logger);
+        if (cmdLineParser.dryRun()) {
+            logger->info("Dry run: simulation not started");
+            return EXIT_SUCCESS;
+        }
+
         //prepare file writers and data writing functions ==============================================================================
         auto fftWriter = std::make_unique<FileIO::InductionCurrentWriter>(
                 particlePtrs, simResultBasename+"_fft.txt", detectionPAs, detectionPAFactors, paSpatialScale);
@@ -360,9 +373,24 @@ int main(int argc, const char * argv[]) {
         hdf5Writer->setParticleAttributes(particleAttributesNames, particleAttributesTransformFct);
         hdf5Writer->setParticleAttributes(integerParticleAttributesNames, integerParticleAttributesTransformFct);
 
+        // memory usage of the simulation subsystems, reported with the space charge solver of the running integrator:
+        auto memoryReport = [&potentialArrays, &particlePtrs, &hdf5Writer](
+                const Integration::AbstractTimeIntegrator* integrator){
+            Core::MemoryReport report;
+            for (const auto& pa: potentialArrays) {
+                report.add("potential arrays", pa->dataSizeBytes());
+            }
+            AppUtils::addParticleMemoryUsage(report, particlePtrs);
+            if (integrator != nullptr) {
+                AppUtils::addIntegratorMemoryUsage(report, *integrator);
+            }
+            report.add("trajectory writer", hdf5Writer->memoryUsageBytes(particlePtrs.size()));
+            return report;
+        };
+
         auto postTimestepFunction =
                 [trajectoryWriteInterval, fftWriteInterval, fftWriteMode, &V_0, &V_rf_export, &ionsInactive,
-                        &hdf5Writer, &startSplatTracker, &ionsInactiveWriter, &fftWriter, &logger](
+                        &hdf5Writer, &startSplatTracker, &ionsInactiveWriter, &fftWriter, &memoryReport, &logger](
                         Integration::AbstractTimeIntegrator* integrator,
                         std::vector<Core::Particle*>& particles,  double time, unsigned int timestep,
                         bool lastTimestep) {
@@ -398,6 +426,7 @@ int main(int argc, const char * argv[]) {
                         hdf5Writer->writeStartSplatData(startSplatTracker);
                         hdf5Writer->finalizeTrajectory();
                         logger->info("finished ts:{} time:{:.2e}", timestep, time);
+                        AppUtils::logMemoryReport(memoryReport(integrator), "end of simulation", logger);
                     }
                 };
 
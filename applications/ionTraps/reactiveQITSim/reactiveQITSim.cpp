@@ -278,6 +278,22 @@ int main(int argc, const char * argv[]) {
         //reactionConditions.electricField = 0.0;
         //reactionConditions.kineticEnergy = 0.0;
 
+        // optionally sample the reactions with exact waiting times, which resolves reactions faster than the
+        // time step:
+        if (simConf->isParameter("exact_reaction_kinetics")) {
+            rsSim.setExactReactionKinetics(simConf->boolParameter("exact_reaction_kinetics"));
+        }
+
+        // optionally initialize the particle species to the steady state of the reaction system, to skip the
+        // equilibration of the chemistry:
+        if (simConf->isParameter("initialize_reaction_steady_state") &&
+            simConf->boolParameter("initialize_reaction_steady_state")) {
+            std::map<RS::Substance*, double> steadyState = rsSim.initializeToSteadyState(reactionConditions);
+            for (const auto& entry: steadyState) {
+                logger->info("steady state abundance {}: {}", entry.first->name(), entry.second);
+            }
+        }
+
         // define functions for the trajectory integration ==================================================
 
         // some variables for synchronization between calls of the acceleration function:
@@ -462,6 +478,7 @@ int main(int argc, const char * argv[]) {
             if (step%trajectoryWriteInterval==0) {
                 rsSim.logConcentrations(logger);
             }
+            rsSim.performEncounterReactions(dt);
             for (unsigned int i = 0; i<nParticlesTotal; i++) {
                 if (particles[i]->isActive()) {
                     rsSim.react(i, reactionConditions, dt);
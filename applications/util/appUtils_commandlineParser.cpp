@@ -21,6 +21,8 @@
 
 #include "appUtils_commandlineParser.hpp"
 #include "appUtils_logging.hpp"
+#include "Core_tracing.hpp"
+#include "Core_hugePageAllocator.hpp"
 #include <omp.h>
 
 /**
@@ -43,6 +45,13 @@ AppUtils::CommandlineParser::CommandlineParser(
     if (multithreaded){
         app.add_option("--n_threads,-n", numberOfThreads_, "number of parallel threads")->required();
     }
+    app.add_flag("--trace", trace_,
+            "Record a per thread timeline trace of the simulation phases (requires a build with USE_TRACING)");
+    app.add_flag("--dry_run", dryRun_,
+            "Set up the simulation and report its estimated memory usage without simulating");
+    app.add_option("--huge_pages", hugePageSettings_,
+            "Back large buffers with huge pages: <mode> for all subsystems or <subsystem>:<mode> "
+            "(subsystems: fields, particles, tree; modes: none, transparent, explicit)");
 
     // Try to parse and raise a message to the main app if the parsing fails for some reason:
     try {
@@ -56,7 +65,33 @@ AppUtils::CommandlineParser::CommandlineParser(
         omp_set_num_threads(numberOfThreads_);
     }
     logger_ = AppUtils::createLogger(simResultName_ + ".log");
+    applyHugePageSettings_();
     simulationConfiguration_ = std::make_shared<SimulationConfiguration>(confFileName_, logger_);
+
+    if (trace_){
+        #ifdef WITH_TRACING
+            Core::Tracing::setEnabled(true);
+        #else
+            logger_->warn("Timeline tracing is not compiled in (configure with USE_TRACING), no trace is recorded");
+        #endif
+    }
+}
+
+/**
+ * Writes the recorded timeline trace, if tracing was requested in the commandline, at the end of the app run
+ */
+AppUtils::CommandlineParser::~CommandlineParser() {
+    if (trace_ && Core::Tracing::isEnabled()){
+        Core::Tracing::setEnabled(false);
+        try {
+            Core::Tracing::writeChromeTrace(traceResultName());
+            logger_->info("Timeline trace with {} events written to {}",
+                    Core::Tracing::numberOfEvents(), traceResultName());
+        }
+        catch (const std::exception& e){
+            logger_->error("Timeline trace could not be written: {}", e.what());
+        }
+    }
 }
 
 /**
@@ -94,10 +129,44 @@ std::string AppUtils::CommandlineParser::trajectoriesResultName() const {
     return simResultName_+"_trajectories.h5";;
 }
 
+/**
+ * Returns the name of the timeline trace file (Chrome trace event format) specified by the result base name
+ */
+std::string AppUtils::CommandlineParser::traceResultName() const {
+    return simResultName_+"_trace.json";
+}
+
 /**
  * Returns the number of parallel threads specified by the commandline. For a single threaded application, the number
  * of threads is always 1
  */
 int AppUtils::CommandlineParser::numberOfThreads() const {
     return  numberOfThreads_;
-}
\ No newline at end of file
+}
+
+/**
+ * Returns true if a dry run was requested in the commandline: The simulation should only be set up and its memory
+ * usage should be reported, without running the simulation
+ */
+bool AppUtils::CommandlineParser::dryRun() const {
+    return dryRun_;
+}
+
+/**
+ * Applies the huge page modes given in the commandline to the subsystems, the modes have to be set before the large
+ * buffers (e.g. potential arrays) are allocated
+ */
+void AppUtils::CommandlineParser::applyHugePageSettings_() {
+    for (const std::string& setting: hugePageSettings_){
+        std::size_t separator = setting.find(':');
+        if (separator == std::string::npos){
+            Core::setHugePageMode(Core::parseHugePageMode(setting));
+        }
+        else {
+            Core::setHugePageMode(
+                    Core::parseHugePageSubsystem(setting.substr(0, separator)),
+                    Core::parseHugePageMode(setting.substr(separator + 1)));
+        }
+        logger_->info("Huge page backing: {}", setting);
+    }
+}
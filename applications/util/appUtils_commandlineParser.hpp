@@ -32,6 +32,8 @@
 #include "appUtils_logging.hpp"
 #include "CLI11.hpp"
 #include <memory>
+#include <vector>
+#include <string>
 
 namespace AppUtils{
 
@@ -61,12 +63,17 @@ namespace AppUtils{
     class CommandlineParser {
     public:
         CommandlineParser(int argc, const char * argv[], std::string appName, std::string appDescription,  bool multithreaded=false);
+        ~CommandlineParser();
+        CommandlineParser(const CommandlineParser&) = delete;
+        CommandlineParser& operator=(const CommandlineParser&) = delete;
         simConf_ptr simulationConfiguration();
         AppUtils::logger_ptr logger();
         std::string resultName() const;
         std::string trajectoriesResultName() const;
         std::string confFileName() const;
         int numberOfThreads() const;
+        std::string traceResultName() const;
+        bool dryRun() const;
 
     private:
         simConf_ptr simulationConfiguration_;
@@ -74,6 +81,11 @@ namespace AppUtils{
         std::string simResultName_;
         std::string confFileName_;
         int numberOfThreads_= 1;
+        bool trace_ = false; ///< if true: a timeline trace of the simulation phases is recorded
+        bool dryRun_ = false; ///< if true: the simulation is only set up and its memory usage is reported
+        std::vector<std::string> hugePageSettings_; ///< huge page modes of the subsystems ("<mode>" or "<subsystem>:<mode>")
+
+        void applyHugePageSettings_();
     };
 }
 
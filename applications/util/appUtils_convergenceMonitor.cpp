@@ -0,0 +1,308 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "appUtils_convergenceMonitor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+    /**
+     * Calculates the quantile of the standard normal distribution (rational approximation of Abramowitz and Stegun
+     * 26.2.23, absolute error < 4.5e-4)
+     * @param probability the probability (0 < probability < 1)
+     */
+    double normalQuantile(double probability){
+        double p = probability < 0.5 ? probability : 1.0 - probability;
+        double t = std::sqrt(-2.0 * std::log(p));
+        double x = t - (2.515517 + 0.802853*t + 0.010328*t*t) / (1.0 + 1.432788*t + 0.189269*t*t + 0.001308*t*t*t);
+        return probability < 0.5 ? -x : x;
+    }
+}
+
+/**
+ * Constructs a convergence monitor without observables
+ *
+ * @param confidenceLevel the confidence level of the confidence intervals (e.g. 0.95)
+ * @param nBatches minimum number of complete batches for a confidence interval (the number of batches is between
+ * nBatches and 2 * nBatches)
+ */
+AppUtils::ConvergenceMonitor::ConvergenceMonitor(double confidenceLevel, std::size_t nBatches):
+confidenceLevel_(confidenceLevel),
+nBatches_(nBatches)
+{
+    if (confidenceLevel <= 0.0 || confidenceLevel >= 1.0){
+        throw (std::invalid_argument("Confidence level of convergence monitor has to be in (0, 1)"));
+    }
+    if (nBatches < 2){
+        throw (std::invalid_argument("Convergence monitor requires at least two batches"));
+    }
+}
+
+/**
+ * Adds an observable to monitor
+ *
+ * @param name the name of the observable
+ * @param targetHalfWidth the target half width of the confidence interval of the mean
+ * @param isRelativeTarget if true, the target is relative to the absolute mean of the observable
+ * @param warmupSamples number of initial samples which are discarded
+ * @return the index of the observable
+ */
+std::size_t AppUtils::ConvergenceMonitor::addObservable(const std::string& name, double targetHalfWidth,
+                                                        bool isRelativeTarget, std::size_t warmupSamples) {
+    if (hasObservable(name)){
+        throw (std::invalid_argument("Observable " + name + " is already monitored"));
+    }
+    if (targetHalfWidth <= 0.0){
+        throw (std::invalid_argument("Convergence target of observable " + name + " has to be positive"));
+    }
+    Observable_ observable;
+    observable.name = name;
+    observable.target = targetHalfWidth;
+    observable.isRelativeTarget = isRelativeTarget;
+    observable.warmupSamples = warmupSamples;
+    observable.batchMeans.reserve(2*nBatches_);
+    observables_.push_back(observable);
+    return observables_.size() - 1;
+}
+
+/**
+ * Gets the number of monitored observables
+ */
+std::size_t AppUtils::ConvergenceMonitor::numberOfObservables() const {
+    return observables_.size();
+}
+
+/**
+ * Checks if an observable with a name is monitored
+ */
+bool AppUtils::ConvergenceMonitor::hasObservable(const std::string& name) const {
+    return std::any_of(observables_.begin(), observables_.end(),
+            [&name](const Observable_& observable){return observable.name == name;});
+}
+
+/**
+ * Gets the index of a monitored observable
+ * @param name the name of the observable
+ */
+std::size_t AppUtils::ConvergenceMonitor::observableIndex(const std::string& name) const {
+    for (std::size_t i=0; i<observables_.size(); ++i){
+        if (observables_[i].name == name){
+            return i;
+        }
+    }
+    throw (std::invalid_argument("Observable " + name + " is not monitored"));
+}
+
+/**
+ * Gets the name of a monitored observable
+ */
+const std::string& AppUtils::ConvergenceMonitor::observableName(std::size_t index) const {
+    return observables_.at(index).name;
+}
+
+/**
+ * Adds a sample of an observable
+ *
+ * @param index the index of the observable
+ * @param value the sampled value
+ */
+void AppUtils::ConvergenceMonitor::addSample(std::size_t index, double value) {
+    Observable_& obs = observables_.at(index);
+    obs.nSamplesSeen++;
+    if (obs.nSamplesSeen <= obs.warmupSamples){
+        return;
+    }
+
+    // running mean and variance (Welford):
+    obs.nSamples++;
+    double delta = value - obs.mean;
+    obs.mean += delta / static_cast<double>(obs.nSamples);
+    obs.m2 += delta * (value - obs.mean);
+
+    // batch means, the batch size is doubled if the maximum number of batches is reached:
+    obs.currentBatchSum += value;
+    obs.currentBatchCount++;
+    if (obs.currentBatchCount == obs.batchSize){
+        obs.batchMeans.push_back(obs.currentBatchSum / static_cast<double>(obs.batchSize));
+        obs.currentBatchSum = 0.0;
+        obs.currentBatchCount = 0;
+
+        if (obs.batchMeans.size() == 2*nBatches_){
+            for (std::size_t i=0; i<nBatches_; ++i){
+                obs.batchMeans[i] = 0.5 * (obs.batchMeans[2*i] + obs.batchMeans[2*i + 1]);
+            }
+            obs.batchMeans.resize(nBatches_);
+            obs.batchSize *= 2;
+        }
+    }
+}
+
+/**
+ * Adds a sample of an observable
+ *
+ * @param name the name of the observable
+ * @param value the sampled value
+ */
+void AppUtils::ConvergenceMonitor::addSample(const std::string& name, double value) {
+    addSample(observableIndex(name), value);
+}
+
+/**
+ * Calculates the current statistics of an observable
+ * @param index the index of the observable
+ */
+AppUtils::ConvergenceMonitor::Statistics AppUtils::ConvergenceMonitor::statistics(std::size_t index) const {
+    const Observable_& obs = observables_.at(index);
+    Statistics result;
+    result.nSamples = obs.nSamples;
+    result.mean = obs.mean;
+    if (obs.nSamples > 1){
+        result.standardDeviation = std::sqrt(obs.m2 / static_cast<double>(obs.nSamples - 1));
+    }
+    result.nBatches = obs.batchMeans.size();
+    result.targetHalfWidth = obs.isRelativeTarget ? obs.target * std::fabs(obs.mean) : obs.target;
+
+    if (result.nBatches >= nBatches_){
+        auto k = static_cast<double>(result.nBatches);
+        double batchMean = 0.0;
+        for (double value: obs.batchMeans){
+            batchMean += value;
+        }
+        batchMean /= k;
+        double batchVariance = 0.0;
+        for (double value: obs.batchMeans){
+            batchVariance += (value - batchMean) * (value - batchMean);
+        }
+        batchVariance /= (k - 1.0);
+
+        double t = studentTQuantile(0.5 * (1.0 + confidenceLevel_), k - 1.0);
+        result.confidenceHalfWidth = t * std::sqrt(batchVariance / k);
+        result.isConverged = result.confidenceHalfWidth <= result.targetHalfWidth;
+    }
+    return result;
+}
+
+/**
+ * Checks if all monitored observables are converged (false if there are no observables)
+ */
+bool AppUtils::ConvergenceMonitor::isConverged() const {
+    if (observables_.empty()){
+        return false;
+    }
+    for (std::size_t i=0; i<observables_.size(); ++i){
+        if (!statistics(i).isConverged){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sets an integrator to termination state if all monitored observables are converged
+ *
+ * @param integrator the integrator to terminate
+ * @return true if the observables are converged and the integrator was terminated
+ */
+bool AppUtils::ConvergenceMonitor::terminateIfConverged(Integration::AbstractTimeIntegrator& integrator) const {
+    if (isConverged()){
+        integrator.setTerminationState();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Logs the current statistics of the monitored observables
+ */
+void AppUtils::ConvergenceMonitor::logStatistics(const logger_ptr& logger) const {
+    for (std::size_t i=0; i<observables_.size(); ++i){
+        Statistics stats = statistics(i);
+        logger->info("observable {}: mean {:.6e} sd {:.4e} CI half width {:.4e} (target {:.4e}) samples {} {}",
+                observables_[i].name, stats.mean, stats.standardDeviation, stats.confidenceHalfWidth,
+                stats.targetHalfWidth, stats.nSamples, stats.isConverged ? "converged" : "");
+    }
+}
+
+/**
+ * Calculates the quantile of the Student t distribution (Cornish-Fisher expansion of Abramowitz and Stegun 26.7.5,
+ * which is accurate to about 1e-3 for more than five degrees of freedom)
+ *
+ * @param probability the probability (0 < probability < 1)
+ * @param degreesOfFreedom the degrees of freedom of the distribution
+ */
+double AppUtils::ConvergenceMonitor::studentTQuantile(double probability, double degreesOfFreedom) {
+    double x = normalQuantile(probability);
+    double x2 = x*x;
+    double nu = degreesOfFreedom;
+    double g1 = (x2 + 1.0) * x / 4.0;
+    double g2 = ((5.0*x2 + 16.0)*x2 + 3.0) * x / 96.0;
+    double g3 = (((3.0*x2 + 19.0)*x2 + 17.0)*x2 - 15.0) * x / 384.0;
+    double g4 = ((((79.0*x2 + 776.0)*x2 + 1482.0)*x2 - 1920.0)*x2 - 945.0) * x / 92160.0;
+    return x + g1/nu + g2/(nu*nu) + g3/(nu*nu*nu) + g4/(nu*nu*nu*nu);
+}
+
+/**
+ * Creates a convergence monitor from a simulation configuration. The monitored observables are configured by the
+ * parameters "convergence_observables" (names of the observables) and "convergence_targets" (target confidence
+ * interval half widths), the optional parameters are "convergence_relative_targets" (default true),
+ * "convergence_confidence_level" (default 0.95) and "convergence_warmup_samples" (default 0).
+ *
+ * @param simConf the simulation configuration
+ * @param availableObservables names of the observables the simulation app provides
+ * @return the convergence monitor or nullptr if no convergence observables are configured
+ */
+std::unique_ptr<AppUtils::ConvergenceMonitor> AppUtils::createConvergenceMonitor(
+        const simConf_ptr& simConf, const std::vector<std::string>& availableObservables) {
+
+    if (!simConf->isParameter("convergence_observables")){
+        return nullptr;
+    }
+    std::vector<std::string> names = simConf->stringVectorParameter("convergence_observables");
+    std::vector<double> targets = simConf->doubleVectorParameter("convergence_targets");
+    if (names.size() != targets.size()){
+        throw (std::invalid_argument("Number of convergence observables and convergence targets differ"));
+    }
+
+    bool isRelative = true;
+    if (simConf->isParameter("convergence_relative_targets")){
+        isRelative = simConf->boolParameter("convergence_relative_targets");
+    }
+    double confidenceLevel = 0.95;
+    if (simConf->isParameter("convergence_confidence_level")){
+        confidenceLevel = simConf->doubleParameter("convergence_confidence_level");
+    }
+    std::size_t warmupSamples = 0;
+    if (simConf->isParameter("convergence_warmup_samples")){
+        warmupSamples = simConf->unsignedIntParameter("convergence_warmup_samples");
+    }
+
+    auto monitor = std::make_unique<ConvergenceMonitor>(confidenceLevel);
+    for (std::size_t i=0; i<names.size(); ++i){
+        if (std::find(availableObservables.begin(), availableObservables.end(), names[i])
+            == availableObservables.end()){
+            throw (std::invalid_argument("Convergence observable " + names[i] + " is not available"));
+        }
+        monitor->addObservable(names[i], targets[i], isRelative, warmupSamples);
+    }
+    return monitor;
+}
@@ -0,0 +1,122 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ appUtils_convergenceMonitor.hpp
+
+ Monitoring of the statistical convergence of simulation observables for early termination of simulations
+
+ ****************************/
+
+#ifndef IDSIMF_APPUTILS_CONVERGENCEMONITOR_HPP
+#define IDSIMF_APPUTILS_CONVERGENCEMONITOR_HPP
+
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "appUtils_simulationConfiguration.hpp"
+#include "appUtils_logging.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstddef>
+
+namespace AppUtils{
+
+    /**
+     * Monitors the statistical convergence of scalar observables of a simulation (e.g. a drift velocity, a
+     * compensation voltage or a concentration), which are sampled once per time step or sampling interval, and
+     * detects when the confidence intervals of the observable means have reached a target width.
+     *
+     * The samples of an observable are a correlated time series. The confidence interval of the mean is therefore
+     * estimated with non overlapping batch means: The samples are grouped into batches of equal size, and the
+     * variance of the mean is estimated from the variance of the batch means. The batch size is doubled (and pairs
+     * of batch means are merged) whenever the number of batches reaches twice the configured number of batches,
+     * thus the batches grow with the simulation and become longer than the correlation time of the samples. The
+     * memory usage is constant. The half width of the confidence interval is calculated with the Student t
+     * distribution of the batch means.
+     *
+     * An observable is converged if at least the configured number of batches is complete and the confidence
+     * interval half width is not larger than the target (an absolute value, or relative to the absolute mean).
+     * Samples in an initial warm up phase (e.g. the equilibration of the ion ensemble) are discarded.
+     */
+    class ConvergenceMonitor {
+
+    public:
+        /**
+         * Current statistics of a monitored observable
+         */
+        struct Statistics {
+            std::size_t nSamples = 0; ///< number of samples (after the warm up phase)
+            double mean = 0.0; ///< mean of the samples
+            double standardDeviation = 0.0; ///< standard deviation of the samples
+            std::size_t nBatches = 0; ///< number of complete batches
+            double confidenceHalfWidth = std::numeric_limits<double>::infinity(); ///< half width of the confidence interval of the mean
+            double targetHalfWidth = 0.0; ///< absolute target half width of the confidence interval
+            bool isConverged = false; ///< true if the target half width is reached
+        };
+
+        explicit ConvergenceMonitor(double confidenceLevel = 0.95, std::size_t nBatches = 32);
+
+        std::size_t addObservable(const std::string& name, double targetHalfWidth, bool isRelativeTarget = true,
+                                  std::size_t warmupSamples = 0);
+        [[nodiscard]] std::size_t numberOfObservables() const;
+        [[nodiscard]] bool hasObservable(const std::string& name) const;
+        [[nodiscard]] std::size_t observableIndex(const std::string& name) const;
+        [[nodiscard]] const std::string& observableName(std::size_t index) const;
+
+        void addSample(std::size_t index, double value);
+        void addSample(const std::string& name, double value);
+
+        [[nodiscard]] Statistics statistics(std::size_t index) const;
+        [[nodiscard]] bool isConverged() const;
+        bool terminateIfConverged(Integration::AbstractTimeIntegrator& integrator) const;
+        void logStatistics(const logger_ptr& logger) const;
+
+        [[nodiscard]] static double studentTQuantile(double probability, double degreesOfFreedom);
+
+    private:
+        /**
+         * Running statistics and batch means of an observable
+         */
+        struct Observable_ {
+            std::string name; ///< name of the observable
+            double target = 0.0; ///< target confidence interval half width (absolute or relative to the mean)
+            bool isRelativeTarget = true; ///< true if the target is relative to the absolute mean
+            std::size_t warmupSamples = 0; ///< number of initial samples to discard
+            std::size_t nSamplesSeen = 0; ///< total number of samples including the warm up phase
+            std::size_t nSamples = 0; ///< number of samples in the statistics
+            double mean = 0.0; ///< running mean
+            double m2 = 0.0; ///< running sum of squared deviations from the mean
+            std::size_t batchSize = 1; ///< current number of samples per batch
+            double currentBatchSum = 0.0; ///< sum of the samples in the incomplete current batch
+            std::size_t currentBatchCount = 0; ///< number of samples in the incomplete current batch
+            std::vector<double> batchMeans; ///< means of the complete batches
+        };
+
+        double confidenceLevel_; ///< confidence level of the confidence intervals
+        std::size_t nBatches_; ///< minimum number of complete batches for a confidence interval
+        std::vector<Observable_> observables_; ///< the monitored observables
+    };
+
+    std::unique_ptr<ConvergenceMonitor> createConvergenceMonitor(
+            const simConf_ptr& simConf, const std::vector<std::string>& availableObservables);
+}
+
+#endif //IDSIMF_APPUTILS_CONVERGENCEMONITOR_HPP
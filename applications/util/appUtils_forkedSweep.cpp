@@ -0,0 +1,252 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "appUtils_forkedSweep.hpp"
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Constructs a forked sweep
+ *
+ * @param variantConfigurations the simulation configurations of the variants
+ * @param prefixTimesteps number of time steps of the shared prefix, the variants are forked after this time step
+ * @param resultBasename result base name of the simulation
+ * @param maxConcurrentVariants maximum number of concurrently running variant processes (one: the variants run
+ * in sequence)
+ * @param variantThreads number of OpenMP threads of the variant processes
+ */
+AppUtils::ForkedSweep::ForkedSweep(std::vector<simConf_ptr> variantConfigurations, unsigned int prefixTimesteps,
+                                   std::string resultBasename, std::size_t maxConcurrentVariants,
+                                   int variantThreads):
+variantConfigurations_(std::move(variantConfigurations)),
+prefixTimesteps_(prefixTimesteps),
+resultBasename_(std::move(resultBasename)),
+maxConcurrentVariants_(maxConcurrentVariants),
+variantThreads_(variantThreads)
+{
+    if (variantConfigurations_.empty()){
+        throw (std::invalid_argument("Forked sweep without variants"));
+    }
+    if (maxConcurrentVariants_ == 0){
+        throw (std::invalid_argument("Illegal number of concurrent variants of forked sweep"));
+    }
+    if (variantThreads_ < 1){
+        throw (std::invalid_argument("Illegal number of threads of forked sweep variants"));
+    }
+}
+
+/**
+ * Gets the number of variants of the sweep
+ */
+std::size_t AppUtils::ForkedSweep::numberOfVariants() const {
+    return variantConfigurations_.size();
+}
+
+/**
+ * Gets the number of time steps of the shared prefix
+ */
+unsigned int AppUtils::ForkedSweep::prefixTimesteps() const {
+    return prefixTimesteps_;
+}
+
+/**
+ * Checks if the variants have to be forked in a time step (the last time step of the prefix, if the variants are
+ * not forked yet)
+ */
+bool AppUtils::ForkedSweep::isForkTimestep(unsigned int timestep) const {
+    return !isForked_ && timestep == prefixTimesteps_;
+}
+
+/**
+ * Checks if this process is a variant process (and not the prefix process)
+ */
+bool AppUtils::ForkedSweep::isVariantProcess() const {
+    return variantIndex_ != PREFIX_PROCESS;
+}
+
+/**
+ * Gets the variant index of this process (PREFIX_PROCESS in the prefix process)
+ */
+std::size_t AppUtils::ForkedSweep::variantIndex() const {
+    return variantIndex_;
+}
+
+/**
+ * Gets the simulation configuration of the variant of this process
+ */
+AppUtils::simConf_ptr AppUtils::ForkedSweep::variantConfiguration() const {
+    if (!isVariantProcess()){
+        throw (std::invalid_argument("The prefix process of a forked sweep has no variant configuration"));
+    }
+    return variantConfigurations_[variantIndex_];
+}
+
+/**
+ * Gets the result base name of a variant
+ */
+std::string AppUtils::ForkedSweep::variantResultName(std::size_t variantIndex) const {
+    return resultBasename_ + "_variant_" + std::to_string(variantIndex);
+}
+
+/**
+ * Gets the number of variant processes which failed (terminated with an error)
+ */
+std::size_t AppUtils::ForkedSweep::numberOfFailedVariants() const {
+    return nFailedVariants_;
+}
+
+/**
+ * Gets the number of OpenMP threads of the variant processes
+ */
+int AppUtils::ForkedSweep::variantThreads() const {
+    return variantThreads_;
+}
+
+/**
+ * Forks the variant processes. The prefix process waits until all variants are finished.
+ *
+ * In a variant process, the logger is replaced by a logger which writes to the log file of the variant, and the
+ * number of OpenMP threads is set to the number of variant threads.
+ *
+ * @param logger the logger of the simulation (is replaced in the variant processes)
+ * @return the variant index in a variant process, PREFIX_PROCESS in the prefix process
+ */
+std::size_t AppUtils::ForkedSweep::forkVariants(logger_ptr& logger) {
+    if (isForked_){
+        throw (std::runtime_error("Variants of forked sweep are already forked"));
+    }
+    isForked_ = true;
+
+#if defined(__unix__) || defined(__APPLE__)
+    logger->info("Forking {} sweep variants after time step {} ({} concurrent)",
+            variantConfigurations_.size(), prefixTimesteps_, maxConcurrentVariants_);
+
+    std::map<pid_t, std::size_t> runningVariants;
+    auto waitForVariant = [this, &runningVariants, &logger](){
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0){
+            throw (std::runtime_error("Waiting for sweep variant process failed"));
+        }
+        auto variant = runningVariants.find(pid);
+        if (variant == runningVariants.end()){
+            return;
+        }
+        if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS){
+            logger->info("Sweep variant {} finished", variant->second);
+        }
+        else {
+            logger->error("Sweep variant {} failed", variant->second);
+            ++nFailedVariants_;
+        }
+        runningVariants.erase(variant);
+    };
+
+    for (std::size_t i=0; i<variantConfigurations_.size(); ++i){
+        while (runningVariants.size() >= maxConcurrentVariants_){
+            waitForVariant();
+        }
+
+        // buffered output would be written by both processes:
+        logger->flush();
+        std::cout.flush();
+        std::fflush(nullptr);
+
+        pid_t pid = fork();
+        if (pid < 0){
+            throw (std::runtime_error("Forking of sweep variant process failed"));
+        }
+        if (pid == 0){
+            variantIndex_ = i;
+            #ifdef _OPENMP
+                // the OpenMP thread team of the prefix process does not exist in the forked process, (some)
+                // OpenMP runtimes do not support a new thread team after forking:
+                omp_set_num_threads(variantThreads_);
+            #endif
+            spdlog::drop(logger->name());
+            logger = createLogger(variantResultName(i) + ".log");
+            variantConfigurations_[i]->setLogger(logger);
+            logger->info("Sweep variant {} continues the simulation after time step {} ({} threads)",
+                    i, prefixTimesteps_, variantThreads_);
+            return i;
+        }
+        runningVariants[pid] = i;
+        logger->info("Started sweep variant {} (process {})", i, pid);
+    }
+
+    while (!runningVariants.empty()){
+        waitForVariant();
+    }
+    return PREFIX_PROCESS;
+#else
+    (void) logger;
+    throw (std::runtime_error("Forked sweeps require process forking, which is not available on this platform"));
+#endif
+}
+
+/**
+ * Creates a forked sweep from a simulation configuration. The sweep is configured by the parameters
+ * "sweep_variants" (array of parameter override objects, see SimulationConfiguration::variantConfigurations) and
+ * "sweep_prefix_time_steps" (number of time steps of the shared prefix). The optional parameter
+ * "sweep_variant_threads" is the number of OpenMP threads of the variant processes (default: 1), the optional
+ * parameter "sweep_concurrent_variants" is the maximum number of concurrently running variants (default: the
+ * number of OpenMP threads of the prefix divided by the number of threads of the variants).
+ *
+ * @param simConf the simulation configuration
+ * @param resultBasename result base name of the simulation
+ * @param variantParameters names of the parameters which can be changed in the variants (the parameters which are
+ * read again by the app in the variant processes), other parameters in the variants are a configuration error
+ * @return the forked sweep or nullptr if no sweep variants are configured
+ */
+std::unique_ptr<AppUtils::ForkedSweep> AppUtils::createForkedSweep(const simConf_ptr& simConf,
+                                                                   const std::string& resultBasename,
+                                                                   const std::vector<std::string>& variantParameters) {
+    if (!simConf->isParameter("sweep_variants")){
+        return nullptr;
+    }
+    std::vector<simConf_ptr> variants = simConf->variantConfigurations("sweep_variants", variantParameters);
+    unsigned int prefixTimesteps = simConf->unsignedIntParameter("sweep_prefix_time_steps");
+
+    int variantThreads = 1;
+    if (simConf->isParameter("sweep_variant_threads")){
+        variantThreads = simConf->intParameter("sweep_variant_threads");
+    }
+    std::size_t maxConcurrentVariants = 1;
+    #ifdef _OPENMP
+        maxConcurrentVariants = static_cast<std::size_t>(std::max(omp_get_max_threads()/std::max(variantThreads, 1), 1));
+    #endif
+    if (simConf->isParameter("sweep_concurrent_variants")){
+        maxConcurrentVariants = simConf->unsignedIntParameter("sweep_concurrent_variants");
+    }
+    return std::make_unique<ForkedSweep>(std::move(variants), prefixTimesteps, resultBasename,
+                                         maxConcurrentVariants, variantThreads);
+}
@@ -0,0 +1,95 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ appUtils_forkedSweep.hpp
+
+ Parameter sweeps which fork simulation variants from a shared, simulated prefix
+
+ ****************************/
+
+#ifndef IDSIMF_APPUTILS_FORKEDSWEEP_HPP
+#define IDSIMF_APPUTILS_FORKEDSWEEP_HPP
+
+#include "appUtils_simulationConfiguration.hpp"
+#include "appUtils_logging.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstddef>
+
+namespace AppUtils{
+
+    /**
+     * Parameter sweep in which the variants share an identical first phase (prefix) of the simulation, e.g. the
+     * cooling of an ion cloud before different RF scans or excitations. The prefix is simulated only once: At the
+     * end of the prefix, the simulation process is forked into one process per variant. Every variant process
+     * starts with a copy of the complete in memory state of the simulation (particles, random generators, reaction
+     * system state, integrator time and time step) and continues the simulation with its variant configuration,
+     * which is the simulation configuration with a set of replaced parameters. Since the random generator state is
+     * copied, all variants continue with identical random numbers (common random numbers), which reduces the
+     * statistical noise of the differences between the variants.
+     *
+     * The variant processes run concurrently, up to a maximum number of concurrent variants (one runs the variants
+     * in sequence). The OpenMP thread team of the prefix process is not usable after forking with all OpenMP
+     * runtimes (e.g. libgomp), thus the variant processes run with a configurable number of OpenMP threads, which
+     * is one by default, and the parallelism of the sweep results from the concurrent variants. The prefix process
+     * waits until all variants are finished.
+     *
+     * Apps have to close their result files before the fork (the variants write their own result files, named
+     * with the result base name and the variant index), and should terminate the prefix process after the fork.
+     */
+    class ForkedSweep {
+
+    public:
+        static constexpr std::size_t PREFIX_PROCESS = std::numeric_limits<std::size_t>::max(); ///< Fork result of the prefix process
+
+        ForkedSweep(std::vector<simConf_ptr> variantConfigurations, unsigned int prefixTimesteps,
+                    std::string resultBasename, std::size_t maxConcurrentVariants = 1, int variantThreads = 1);
+
+        [[nodiscard]] std::size_t numberOfVariants() const;
+        [[nodiscard]] unsigned int prefixTimesteps() const;
+        [[nodiscard]] bool isForkTimestep(unsigned int timestep) const;
+        [[nodiscard]] bool isVariantProcess() const;
+        [[nodiscard]] std::size_t variantIndex() const;
+        [[nodiscard]] simConf_ptr variantConfiguration() const;
+        [[nodiscard]] std::string variantResultName(std::size_t variantIndex) const;
+        [[nodiscard]] std::size_t numberOfFailedVariants() const;
+        [[nodiscard]] int variantThreads() const;
+
+        std::size_t forkVariants(logger_ptr& logger);
+
+    private:
+        std::vector<simConf_ptr> variantConfigurations_; ///< Configurations of the variants
+        unsigned int prefixTimesteps_; ///< Number of time steps of the shared prefix
+        std::string resultBasename_; ///< Result base name of the simulation
+        std::size_t maxConcurrentVariants_; ///< Maximum number of concurrently running variant processes
+        int variantThreads_; ///< Number of OpenMP threads of the variant processes
+        bool isForked_ = false; ///< true if the variants are already forked
+        std::size_t variantIndex_ = PREFIX_PROCESS; ///< Variant index of this process (PREFIX_PROCESS in the prefix process)
+        std::size_t nFailedVariants_ = 0; ///< Number of variant processes which failed
+    };
+
+    std::unique_ptr<ForkedSweep> createForkedSweep(const simConf_ptr& simConf, const std::string& resultBasename,
+                                                   const std::vector<std::string>& variantParameters);
+}
+
+#endif //IDSIMF_APPUTILS_FORKEDSWEEP_HPP
@@ -31,6 +31,7 @@
 #include "Integration_fullSumVerletIntegrator.hpp"
 #include "Integration_parallelRK4Integrator.hpp"
 #include "Integration_fullSumRK4Integrator.hpp"
+#include "Integration_parallelSymplecticIntegrator.hpp"
 
 #ifdef WITH_FMM_3d
 #include "Integration_fmmIntegrator.hpp"
@@ -102,7 +103,10 @@ void AppUtils::runTrajectoryIntegration(
         CollisionModel::AbstractCollisionModel* collisionModel){
 
     IntegratorMode integratorMode = simConf->integratorMode();
-    std::vector<IntegratorMode> multiStepIntegrators = {IntegratorMode::PARALLEL_RUNGE_KUTTA4, IntegratorMode::FULL_SUM_RUNGE_KUTTA4};
+    std::vector<IntegratorMode> multiStepIntegrators =
+            {IntegratorMode::PARALLEL_RUNGE_KUTTA4, IntegratorMode::FULL_SUM_RUNGE_KUTTA4,
+             IntegratorMode::PARALLEL_VERLET_OVERLAPPED, IntegratorMode::PARALLEL_SYMPLECTIC4,
+             IntegratorMode::PARALLEL_SYMPLECTIC6};
     if (AppUtils::integratorModeInVector(
             multiStepIntegrators, integratorMode)) {
 
@@ -156,6 +160,16 @@ void AppUtils::runTrajectoryIntegration(
         AppUtils::SignalHandler::setReceiver(verletIntegrator);
         verletIntegrator.run(timeSteps, dt);
     }
+    else if (integratorMode==AppUtils::PARALLEL_VERLET_OVERLAPPED) {
+        Integration::ParallelVerletIntegrator verletIntegrator(
+                particles,
+                multiStepAccelerationFunction, multiStepSpaceChargeAccelerationFunction,
+                postTimestepFunction, otherActionsFunction,
+                ionStartMonitoringFunction,
+                collisionModel);
+        AppUtils::SignalHandler::setReceiver(verletIntegrator);
+        verletIntegrator.run(timeSteps, dt);
+    }
     else if (integratorMode==AppUtils::FULL_SUM_VERLET) {
         Integration::FullSumVerletIntegrator verletIntegrator(
                 particles,
@@ -185,6 +199,21 @@ void AppUtils::runTrajectoryIntegration(
         AppUtils::SignalHandler::setReceiver(fullSumRK4Integrator);
         fullSumRK4Integrator.run(timeSteps, dt);
     }
+    else if (integratorMode==AppUtils::PARALLEL_SYMPLECTIC4 || integratorMode==AppUtils::PARALLEL_SYMPLECTIC6) {
+        Integration::ParallelSymplecticIntegrator::Order order =
+                integratorMode==AppUtils::PARALLEL_SYMPLECTIC4 ?
+                Integration::ParallelSymplecticIntegrator::FOURTH_ORDER :
+                Integration::ParallelSymplecticIntegrator::SIXTH_ORDER;
+        Integration::ParallelSymplecticIntegrator symplecticIntegrator(
+                particles,
+                multiStepAccelerationFunction, multiStepSpaceChargeAccelerationFunction,
+                order,
+                postTimestepFunction, otherActionsFunction,
+                ionStartMonitoringFunction,
+                collisionModel);
+        AppUtils::SignalHandler::setReceiver(symplecticIntegrator);
+        symplecticIntegrator.run(timeSteps, dt);
+    }
 #ifdef WITH_FMM_3d
     else if (integratorMode==AppUtils::FMM3D_VERLET) {
         Integration::FMMVerletIntegrator<FMM3D::FMMSolver> integrator(
@@ -212,6 +241,10 @@ void AppUtils::runTrajectoryIntegration(
         if (simConf->isParameter("ExaFMM_order")) {
             integrator.getFMMSolver()->setExpansionOrder(simConf->intParameter("ExaFMM_order"));
         }
+        if (simConf->isParameter("ExaFMM_tree_rebuild_threshold")) {
+            integrator.getFMMSolver()->setTreeRebuildThreshold(
+                    simConf->doubleParameter("ExaFMM_tree_rebuild_threshold"));
+        }
 
         AppUtils::SignalHandler::setReceiver(integrator);
         integrator.run(timeSteps, dt);
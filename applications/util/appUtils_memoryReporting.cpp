@@ -0,0 +1,68 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "appUtils_memoryReporting.hpp"
+
+/**
+ * Adds the memory used by a set of particles (the particle objects, their attributes and the particle pointer
+ * vector) to a memory report
+ */
+void AppUtils::addParticleMemoryUsage(Core::MemoryReport& report, const std::vector<Core::Particle*>& particles) {
+    std::size_t result = Core::vectorMemoryBytes(particles);
+    for (const auto& particle: particles){
+        result += particle->memoryUsageBytes();
+    }
+    report.add("particles", result);
+}
+
+/**
+ * Adds the memory used by the space charge data structure of a running integrator to a memory report. Only
+ * integrators with such a data structure (the Barnes-Hut tree of the tree based integrators) are reported, the
+ * memory used by the external FMM libraries is not accounted.
+ *
+ * @param report the report to add the memory usage to
+ * @param integrator the integrator to report
+ */
+void AppUtils::addIntegratorMemoryUsage(Core::MemoryReport& report,
+                                        const Integration::AbstractTimeIntegrator& integrator) {
+    std::size_t spaceChargeBytes = integrator.spaceChargeMemoryUsageBytes();
+    if (spaceChargeBytes > 0){
+        report.add("space charge tree", spaceChargeBytes);
+    }
+}
+
+/**
+ * Logs a memory report as a table together with the current and peak resident memory of the process
+ *
+ * @param report the memory report to log
+ * @param title title of the report (e.g. the simulation phase)
+ * @param logger the logger to log with
+ */
+void AppUtils::logMemoryReport(const Core::MemoryReport& report, const std::string& title,
+                               const logger_ptr& logger) {
+    logger->info("Memory usage ({}):", title);
+    for (const auto& line: report.toLines()){
+        logger->info("  {}", line);
+    }
+    logger->info("Resident memory of the process: {} (peak {})",
+            Core::formatBytes(Core::currentResidentMemoryBytes()),
+            Core::formatBytes(Core::peakResidentMemoryBytes()));
+}
@@ -0,0 +1,45 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ appUtils_memoryReporting.hpp
+
+ Memory usage reports of simulation apps
+
+ ****************************/
+
+#ifndef IDSIMF_APPUTILS_MEMORYREPORTING_HPP
+#define IDSIMF_APPUTILS_MEMORYREPORTING_HPP
+
+#include "Core_memoryAccounting.hpp"
+#include "Core_particle.hpp"
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "appUtils_logging.hpp"
+#include <vector>
+#include <string>
+
+namespace AppUtils{
+
+    void addParticleMemoryUsage(Core::MemoryReport& report, const std::vector<Core::Particle*>& particles);
+    void addIntegratorMemoryUsage(Core::MemoryReport& report, const Integration::AbstractTimeIntegrator& integrator);
+    void logMemoryReport(const Core::MemoryReport& report, const std::string& title, const logger_ptr& logger);
+}
+
+#endif //IDSIMF_APPUTILS_MEMORYREPORTING_HPP
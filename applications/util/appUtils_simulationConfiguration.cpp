@@ -1,5 +1,8 @@
 #include "appUtils_simulationConfiguration.hpp"
 #include "Core_vector.hpp"
+#include "PSim_tetrahedralMeshField.hpp"
+#include "FileIO_HDF5Reader.hpp"
+#include <algorithm>
 
 AppUtils::SimulationConfiguration::SimulationConfiguration(const std::string& confFileName) {
 
@@ -187,12 +190,21 @@ AppUtils::IntegratorMode AppUtils::SimulationConfiguration::integratorMode() con
     else if (integratorMode_str=="parallel_verlet") {
         integratorMode = PARALLEL_VERLET;
     }
+    else if (integratorMode_str=="parallel_verlet_overlapped") {
+        integratorMode = PARALLEL_VERLET_OVERLAPPED;
+    }
     else if (integratorMode_str=="RK4") {
         integratorMode = PARALLEL_RUNGE_KUTTA4;
     }
     else if (integratorMode_str=="full_sum_RK4") {
         integratorMode = FULL_SUM_RUNGE_KUTTA4;
     }
+    else if (integratorMode_str=="symplectic4") {
+        integratorMode = PARALLEL_SYMPLECTIC4;
+    }
+    else if (integratorMode_str=="symplectic6") {
+        integratorMode = PARALLEL_SYMPLECTIC6;
+    }
     else if (integratorMode_str=="full_sum_verlet") {
         integratorMode = FULL_SUM_VERLET;
     }
@@ -221,12 +233,277 @@ std::unique_ptr<ParticleSimulation::InterpolatedField> AppUtils::SimulationConfi
                 logger_->info("Reading field {}", fieldPath.string());
             }
 
-            return std::make_unique<ParticleSimulation::InterpolatedField>(fieldPath);
+            std::unique_ptr<ParticleSimulation::InterpolatedField> field =
+                    std::make_unique<ParticleSimulation::InterpolatedField>(fieldPath);
+            compressField_(*field);
+            return field;
+        }else{
+            throw std::invalid_argument("missing configuration value: " + jsonName);
+        }
+}
+
+/**
+ * Reads a spatial field from a HDF5 file. The type of the field is determined from the file content: Files with
+ * a "mesh" group are read as tetrahedral mesh field, other files as interpolated field on a rectangular grid.
+ */
+std::unique_ptr<ParticleSimulation::SpatialField> AppUtils::SimulationConfiguration::readSpatialField(
+        const std::string& jsonName) const {
+        if (isParameter(jsonName)){
+            std::string fieldFileName = confRoot_.get(jsonName,0).asString();
+            std::filesystem::path fieldPath(confFileBasePath_ / std::filesystem::path(fieldFileName));
+
+            bool isMeshField;
+            {
+                FileIO::HDF5Reader h5Reader(fieldPath);
+                std::vector<std::string> rootObjects = h5Reader.namesOfObjectsInGroup("/");
+                isMeshField = std::find(rootObjects.begin(), rootObjects.end(), "mesh") != rootObjects.end();
+            }
+
+            if (isMeshField){
+                if (logger_){
+                    logger_->info("Reading tetrahedral mesh field {}", fieldPath.string());
+                }
+                return std::make_unique<ParticleSimulation::TetrahedralMeshField>(fieldPath);
+            }
+            else {
+                if (logger_){
+                    logger_->info("Reading field {}", fieldPath.string());
+                }
+                std::unique_ptr<ParticleSimulation::InterpolatedField> field =
+                        std::make_unique<ParticleSimulation::InterpolatedField>(fieldPath);
+                compressField_(*field);
+                return field;
+            }
         }else{
             throw std::invalid_argument("missing configuration value: " + jsonName);
         }
 }
 
+/**
+ * Reads a time dependent field, defined by a sequence of field snapshots (InterpolatedField HDF5 files) at given
+ * times, from the simulation configuration:
+ *
+ *  "flow_field": {
+ *      "snapshots": ["flow_000.h5", "flow_001.h5", "flow_002.h5"],
+ *      "times_s": [0.0, 1e-4, 2e-4]
+ *  }
+ *
+ * The snapshot file names are relative to the configuration file.
+ */
+std::unique_ptr<ParticleSimulation::TimeSeriesField> AppUtils::SimulationConfiguration::readTimeSeriesField(
+        const std::string& jsonName) const {
+    if (!isParameter(jsonName)) {
+        throw std::invalid_argument("missing configuration value: " + jsonName);
+    }
+    Json::Value fieldNode = confRoot_.get(jsonName, 0);
+    Json::Value snapshotsNode = fieldNode.get("snapshots", Json::Value());
+    Json::Value timesNode = fieldNode.get("times_s", Json::Value());
+    if (!snapshotsNode.isArray() || !timesNode.isArray()){
+        throw std::invalid_argument("time series field " + jsonName + " requires \"snapshots\" and \"times_s\"");
+    }
+
+    std::vector<std::string> snapshotFilenames;
+    for (const auto& snapshotNode: snapshotsNode){
+        std::filesystem::path snapshotPath(confFileBasePath_ / std::filesystem::path(snapshotNode.asString()));
+        snapshotFilenames.push_back(snapshotPath.string());
+    }
+    std::vector<double> times;
+    for (const auto& timeNode: timesNode){
+        times.push_back(timeNode.asDouble());
+    }
+    if (logger_){
+        logger_->info("Reading time series field {} with {} snapshots", jsonName, snapshotFilenames.size());
+    }
+    return std::make_unique<ParticleSimulation::TimeSeriesField>(snapshotFilenames, times);
+}
+
+/**
+ * Reads a voltage schedule (time dependent electrode voltages) from the simulation configuration. The schedule
+ * is defined by a set of named signals and a list of electrodes, the voltage of an electrode is a constant offset
+ * plus a linear combination of the signals:
+ *
+ *  "voltage_schedule": {
+ *      "signals": {
+ *          "rf": {"type": "sine", "amplitude": 500, "frequency_hz": 1e6},
+ *          "excite": {"type": "pulse", "amplitude": 1.0, "start_time_s": 0, "duration_s": 1e-5}
+ *      },
+ *      "electrodes": [
+ *          {"offset_V": 10.0, "factors": {"rf": 1.0}},
+ *          {"factors": {"rf": -1.0, "excite": 0.5}}
+ *      ]
+ *  }
+ *
+ * Signal types are "constant", "sine", "pulse", "sampled" and "traveling_wave". The amplitude of all signal types
+ * can be ramped linearly with "amplitude_end", "ramp_start_time_s" and "ramp_end_time_s".
+ */
+std::unique_ptr<ParticleSimulation::VoltageSchedule> AppUtils::SimulationConfiguration::voltageScheduleParameter(
+        const std::string& jsonName) const {
+    if (!isParameter(jsonName)) {
+        throw std::invalid_argument("missing configuration value: " + jsonName);
+    }
+    Json::Value scheduleNode = confRoot_.get(jsonName, 0);
+    Json::Value signalsNode = scheduleNode.get("signals", Json::Value(Json::objectValue));
+    Json::Value electrodesNode = scheduleNode.get("electrodes", Json::Value(Json::arrayValue));
+    if (!signalsNode.isObject() || !electrodesNode.isArray()){
+        throw std::invalid_argument("invalid voltage schedule definition: " + jsonName);
+    }
+
+    auto nElectrodes = static_cast<unsigned int>(electrodesNode.size());
+    auto schedule = std::make_unique<ParticleSimulation::VoltageSchedule>(nElectrodes);
+    for (const std::string& signalName: signalsNode.getMemberNames()){
+        schedule->addSignal(signalName, readVoltageScheduleSignal_(signalName, signalsNode[signalName]));
+    }
+
+    for (unsigned int i=0; i<nElectrodes; ++i){
+        Json::Value electrodeNode = electrodesNode.get(i, 0);
+        schedule->setElectrodeOffset(i, electrodeNode.get("offset_V", 0.0).asDouble());
+        Json::Value factorsNode = electrodeNode.get("factors", Json::Value(Json::objectValue));
+        for (const std::string& signalName: factorsNode.getMemberNames()){
+            schedule->setElectrodeFactor(i, signalName, factorsNode[signalName].asDouble());
+        }
+    }
+
+    if (logger_){
+        logger_->info("{}: {} signals, {} electrodes", jsonName, schedule->numberOfSignals(), nElectrodes);
+    }
+    return schedule;
+}
+
+/**
+ * Reads a single signal of a voltage schedule from its json node
+ */
+ParticleSimulation::VoltageSchedule::Signal AppUtils::SimulationConfiguration::readVoltageScheduleSignal_(
+        const std::string& signalName, const Json::Value& signalNode) const {
+
+    using Signal = ParticleSimulation::VoltageSchedule::Signal;
+
+    auto requiredValue = [&signalName, &signalNode](const std::string& key) -> Json::Value {
+        if (!signalNode.isMember(key)){
+            throw std::invalid_argument("missing value " + key + " in voltage schedule signal " + signalName);
+        }
+        return signalNode[key];
+    };
+
+    auto readWaveform = [this, &requiredValue]() -> std::shared_ptr<ParticleSimulation::SampledWaveform> {
+        std::string waveformFileName = pathRelativeToConfFile(requiredValue("waveform_csv_file").asString());
+        auto waveform = std::make_shared<ParticleSimulation::SampledWaveform>(waveformFileName);
+        if (!waveform->good()){
+            throw std::invalid_argument("waveform file not accessible: " + waveformFileName);
+        }
+        return waveform;
+    };
+
+    std::string signalType = requiredValue("type").asString();
+    double amplitude = requiredValue("amplitude").asDouble();
+
+    Signal signal = Signal::constant(amplitude);
+    if (signalType == "constant"){
+        // constant signal already created
+    }
+    else if (signalType == "sine"){
+        signal = Signal::sine(amplitude, requiredValue("frequency_hz").asDouble(),
+                signalNode.get("phase_rad", 0.0).asDouble());
+    }
+    else if (signalType == "pulse"){
+        signal = Signal::pulse(amplitude, requiredValue("start_time_s").asDouble(),
+                requiredValue("duration_s").asDouble());
+    }
+    else if (signalType == "sampled"){
+        bool looped = signalNode.get("looped", "false").asString() == "true";
+        signal = Signal::sampled(readWaveform(), amplitude, looped);
+    }
+    else if (signalType == "traveling_wave"){
+        signal = Signal::travelingWave(readWaveform(), amplitude, requiredValue("frequency_hz").asDouble(),
+                signalNode.get("phase_shift", 0.0).asDouble());
+    }
+    else if (signalType == "swift"){
+        Json::Value rangeNode = requiredValue("frequency_range_hz");
+        std::vector<std::array<double, 2>> notches;
+        Json::Value notchesNode = signalNode.get("notches_hz", Json::Value(Json::arrayValue));
+        for (const Json::Value& notchNode: notchesNode){
+            notches.push_back({notchNode.get(0u, 0.0).asDouble(), notchNode.get(1u, 0.0).asDouble()});
+        }
+        auto waveform = std::make_shared<ParticleSimulation::SwiftWaveform>(
+                rangeNode.get(0u, 0.0).asDouble(), rangeNode.get(1u, 0.0).asDouble(),
+                requiredValue("frequency_resolution_hz").asDouble(), notches);
+        signal = Signal::swift(waveform, amplitude);
+    }
+    else {
+        throw std::invalid_argument("wrong configuration value: type of voltage schedule signal " + signalName);
+    }
+
+    if (signalNode.isMember("amplitude_end")){
+        signal.setAmplitudeRamp(signalNode["amplitude_end"].asDouble(),
+                requiredValue("ramp_start_time_s").asDouble(), requiredValue("ramp_end_time_s").asDouble());
+    }
+    return signal;
+}
+
+/**
+ * Compresses the data of an interpolated field in memory if the optional configuration value
+ * "field_compression_error" (absolute error bound of the field values, 0 for lossless compression) is set
+ */
+void AppUtils::SimulationConfiguration::compressField_(ParticleSimulation::InterpolatedField& field) const {
+    if (isParameter("field_compression_error")){
+        std::size_t uncompressedSize = field.dataSizeBytes();
+        field.compress(doubleParameter("field_compression_error"));
+        if (logger_){
+            logger_->info("Compressed field data from {} to {} bytes", uncompressedSize, field.dataSizeBytes());
+        }
+    }
+}
+
+/**
+ * Creates variants of this simulation configuration (e.g. for parameter sweeps) from an array of parameter
+ * override objects: Every variant is a copy of this configuration, in which the parameters given in the
+ * corresponding override object are replaced (or added). Only the parameters in the list of variant parameters
+ * (the parameters which are actually read again by the app for a variant) are allowed in the override objects.
+ * Example:
+ *
+ *  "sweep_variants": [
+ *      {"V_rf": 150.0},
+ *      {"V_rf": 200.0, "excite_pulse_potential": 1.0}
+ *  ]
+ *
+ * @param jsonName name of the array of parameter override objects
+ * @param variantParameters names of the parameters which are allowed in the override objects
+ * @return the variant configurations, in the order of the override objects
+ */
+std::vector<AppUtils::simConf_ptr> AppUtils::SimulationConfiguration::variantConfigurations(
+        const std::string& jsonName, const std::vector<std::string>& variantParameters) const {
+    if (!isParameter(jsonName)) {
+        throw std::invalid_argument("missing configuration value: " + jsonName);
+    }
+    Json::Value variantsNode = confRoot_.get(jsonName, 0);
+    if (!variantsNode.isArray()) {
+        throw std::invalid_argument("configuration value " + jsonName + " is not an array of parameter objects");
+    }
+
+    std::vector<simConf_ptr> result;
+    for (const auto& overridesNode: variantsNode) {
+        if (!overridesNode.isObject()) {
+            throw std::invalid_argument("configuration value " + jsonName + " is not an array of parameter objects");
+        }
+        auto variant = std::make_shared<SimulationConfiguration>(*this);
+        for (const auto& key: overridesNode.getMemberNames()) {
+            if (std::find(variantParameters.begin(), variantParameters.end(), key) == variantParameters.end()) {
+                throw std::invalid_argument("configuration value " + key + " in " + jsonName +
+                                            " can not be changed in variants");
+            }
+            variant->confRoot_[key] = overridesNode[key];
+        }
+        result.push_back(variant);
+    }
+    return result;
+}
+
+/**
+ * Sets the logger which logs the read configuration values
+ */
+void AppUtils::SimulationConfiguration::setLogger(std::shared_ptr<spdlog::logger> logger) {
+    logger_ = std::move(logger);
+}
+
 std::string AppUtils::SimulationConfiguration::pathRelativeToConfFile(const std::string& pathStr) const {
     return confFilePath_.parent_path() / std::filesystem::path(pathStr);
 }
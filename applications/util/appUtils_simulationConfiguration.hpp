@@ -30,6 +30,9 @@
 #include "json.h"
 #include "spdlog/spdlog.h"
 #include "PSim_interpolatedField.hpp"
+#include "PSim_spatialField.hpp"
+#include "PSim_timeSeriesField.hpp"
+#include "PSim_voltageSchedule.hpp"
 #include "appUtils_logging.hpp"
 #include <filesystem>
 #include <vector>
@@ -39,7 +42,8 @@
 
 namespace AppUtils{
 
-    enum IntegratorMode {VERLET, PARALLEL_VERLET, FMM3D_VERLET, EXAFMM_VERLET, FULL_SUM_VERLET, PARALLEL_RUNGE_KUTTA4, FULL_SUM_RUNGE_KUTTA4};
+    enum IntegratorMode {VERLET, PARALLEL_VERLET, FMM3D_VERLET, EXAFMM_VERLET, FULL_SUM_VERLET, PARALLEL_RUNGE_KUTTA4, FULL_SUM_RUNGE_KUTTA4,
+        PARALLEL_VERLET_OVERLAPPED, PARALLEL_SYMPLECTIC4, PARALLEL_SYMPLECTIC6};
 
     class SimulationConfiguration{
     public:
@@ -67,6 +71,16 @@ namespace AppUtils{
         AppUtils::IntegratorMode integratorMode() const;
         std::unique_ptr<ParticleSimulation::InterpolatedField> readInterpolatedField(
                 const std::string& jsonName) const;
+        std::unique_ptr<ParticleSimulation::SpatialField> readSpatialField(
+                const std::string& jsonName) const;
+        std::unique_ptr<ParticleSimulation::TimeSeriesField> readTimeSeriesField(
+                const std::string& jsonName) const;
+        std::unique_ptr<ParticleSimulation::VoltageSchedule> voltageScheduleParameter(
+                const std::string& jsonName) const;
+
+        std::vector<std::shared_ptr<SimulationConfiguration>> variantConfigurations(
+                const std::string& jsonName, const std::vector<std::string>& variantParameters) const;
+        void setLogger(std::shared_ptr<spdlog::logger> logger);
 
         std::string pathRelativeToConfFile(const std::string& pathStr) const;
         std::string pathRelativeToConfBasePath(const std::string& pathStr) const;
@@ -74,6 +88,9 @@ namespace AppUtils{
 
     private:
         Json::Value readConfigurationJson_(const std::string& confFileName);
+        void compressField_(ParticleSimulation::InterpolatedField& field) const;
+        ParticleSimulation::VoltageSchedule::Signal readVoltageScheduleSignal_(
+                const std::string& signalName, const Json::Value& signalNode) const;
 
         Json::Value confRoot_;
         std::filesystem::path confFilePath_;
@@ -51,6 +51,53 @@ namespace CollisionModel {
             virtual void modifyPosition(Core::Vector& position,
                                         Core::Particle& particle,
                                         double dt) = 0;
+
+            /**
+             * Gets the damping rate of a continuous linear drag (a_drag = -dampingRate * (v - gasVelocity)), if the
+             * model describes the background gas interaction as drag. Integrators which treat the drag analytically
+             * (ParallelExponentialIntegrator) use the drag instead of modifyAcceleration. Models without a continuous
+             * drag return zero.
+             */
+            [[nodiscard]] virtual double dragDampingRate(Core::Particle& /*particle*/) const {
+                return 0.0;
+            }
+
+            /**
+             * Gets the background gas velocity the continuous linear drag relaxes the particle velocity to
+             */
+            [[nodiscard]] virtual Core::Vector dragGasVelocity(Core::Particle& /*particle*/) const {
+                return {0.0, 0.0, 0.0};
+            }
+
+            /**
+             * Checks if the model describes the background gas interaction as discrete collision events with a
+             * collision frequency, which allows event driven propagation (ParallelEventDrivenIntegrator) with the
+             * collisionFrequency / collisionFrequencyBound / performCollision methods
+             */
+            [[nodiscard]] virtual bool hasCollisionEvents() const {
+                return false;
+            }
+
+            /**
+             * Gets the collision frequency (1/s) of a particle with its current velocity and location
+             */
+            [[nodiscard]] virtual double collisionFrequency(Core::Particle& /*particle*/) const {
+                return 0.0;
+            }
+
+            /**
+             * Gets an upper bound of the collision frequency (1/s) of a particle at its current location for all
+             * velocities which differ from the current particle velocity by at most speedIncrease (m/s)
+             */
+            [[nodiscard]] virtual double collisionFrequencyBound(Core::Particle& /*particle*/,
+                                                                 double /*speedIncrease*/) const {
+                return 0.0;
+            }
+
+            /**
+             * Performs a collision event with the particle (modifies the particle velocity)
+             */
+            virtual void performCollision(Core::Particle& /*particle*/) {}
     };
 }
 
@@ -181,25 +181,36 @@ double CollisionModel::Atom::getPartCharge() const{
  * @param angles The current x-y-z rotation angles of the molecule
  */
 void CollisionModel::Atom::rotate(const Core::Vector &angles){
+    rotate(angles, this->relativePosition);
+}       
+
+/**
+ * Rotates a position vector in the same way as the relative position of an atom is rotated by 
+ * rotate(const Core::Vector &angles)
+ * 
+ * @param angles The x-y-z rotation angles
+ * @param position The position to rotate
+ */
+void CollisionModel::Atom::rotate(const Core::Vector &angles, Core::Vector& position){
     
     double tmp_x = angles.x();
     double tmp_y = angles.y();
     double tmp_z = angles.z();
 
-    double new_rel_x = cos(tmp_y) * cos(tmp_z)*relativePosition.x() 
-                        + (sin(tmp_x) * sin(tmp_y) * cos(tmp_z) + cos(tmp_x) * sin(tmp_z)) * relativePosition.y() 
-                        + (sin(tmp_x) * sin(tmp_z) - cos(tmp_x) * sin(tmp_y) * cos(tmp_z)) * relativePosition.z();
-    double new_rel_y = - cos(tmp_y) * sin(tmp_z) * relativePosition.x()
-                        + (cos(tmp_x) * cos(tmp_z) - sin(tmp_x) * sin(tmp_y) * sin(tmp_z)) * relativePosition.y()
-                        + (cos(tmp_x) * sin(tmp_y) * sin(tmp_z) + sin(tmp_x)*cos(tmp_z)) * relativePosition.z();
-    double new_rel_z = sin(tmp_y) * relativePosition.x()
-                        - sin(tmp_x) * cos(tmp_y) * relativePosition.y()
-                        + cos(tmp_x) * cos(tmp_y) * relativePosition.z();
-
-    this->relativePosition.x(new_rel_x);
-    this->relativePosition.y(new_rel_y);
-    this->relativePosition.z(new_rel_z);
-}       
+    double new_rel_x = cos(tmp_y) * cos(tmp_z)*position.x() 
+                        + (sin(tmp_x) * sin(tmp_y) * cos(tmp_z) + cos(tmp_x) * sin(tmp_z)) * position.y() 
+                        + (sin(tmp_x) * sin(tmp_z) - cos(tmp_x) * sin(tmp_y) * cos(tmp_z)) * position.z();
+    double new_rel_y = - cos(tmp_y) * sin(tmp_z) * position.x()
+                        + (cos(tmp_x) * cos(tmp_z) - sin(tmp_x) * sin(tmp_y) * sin(tmp_z)) * position.y()
+                        + (cos(tmp_x) * sin(tmp_y) * sin(tmp_z) + sin(tmp_x)*cos(tmp_z)) * position.z();
+    double new_rel_z = sin(tmp_y) * position.x()
+                        - sin(tmp_x) * cos(tmp_y) * position.y()
+                        + cos(tmp_x) * cos(tmp_y) * position.z();
+
+    position.x(new_rel_x);
+    position.y(new_rel_y);
+    position.z(new_rel_z);
+}
 
 void CollisionModel::Atom::rotate2D(double angle, Core::Vector& relPos){
     double xNew = relPos.x() * cos(angle) - relPos.y() * sin(angle);
@@ -77,6 +77,7 @@ namespace CollisionModel{
         static double calcLJEps(const Atom &atm1, const Atom &atm2);
         static double calcLJSig(const Atom &atm1, const Atom &atm2);
         static void rotate2D(double angle, Core::Vector& relPos); 
+        static void rotate(const Core::Vector &angles, Core::Vector& position);
 
     private:
 
@@ -0,0 +1,151 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "CollisionModel_AtomCellGrid.hpp"
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Creates the cell grid of the atoms of a molecular structure
+ *
+ * @param atoms the atoms of the molecular structure (the relative positions define the molecule frame)
+ * @param cutoffRadius radius in which the atoms are evaluated individually (m)
+ */
+CollisionModel::AtomCellGrid::AtomCellGrid(const std::vector<std::shared_ptr<Atom>>& atoms, double cutoffRadius):
+    cutoffRadius_(cutoffRadius),
+    cellSize_(cutoffRadius/4.0)
+{
+    if (cutoffRadius <= 0.0){
+        throw (std::invalid_argument("Cut-off radius of atom cell grid has to be positive"));
+    }
+
+    Core::Vector lowerCorner(0.0, 0.0, 0.0);
+    if (!atoms.empty()){
+        lowerCorner = atoms.front()->getRelativePosition();
+    }
+    for (const auto& atom: atoms){
+        const Core::Vector& pos = atom->getRelativePosition();
+        lowerCorner.x(std::min(lowerCorner.x(), pos.x()));
+        lowerCorner.y(std::min(lowerCorner.y(), pos.y()));
+        lowerCorner.z(std::min(lowerCorner.z(), pos.z()));
+    }
+
+    // bin the uncharged atoms:
+    std::map<std::array<long, 3>, std::size_t> cellIndices;
+    for (std::size_t i=0; i<atoms.size(); ++i){
+        if (isChargedAtom(*atoms[i])){
+            chargedAtomIndices_.push_back(i);
+            continue;
+        }
+        Core::Vector relPos = (atoms[i]->getRelativePosition() - lowerCorner) / cellSize_;
+        std::array<long, 3> gridIndex = {
+                static_cast<long>(std::floor(relPos.x())),
+                static_cast<long>(std::floor(relPos.y())),
+                static_cast<long>(std::floor(relPos.z()))};
+
+        auto it = cellIndices.find(gridIndex);
+        if (it == cellIndices.end()){
+            it = cellIndices.emplace(gridIndex, cells_.size()).first;
+            cells_.emplace_back();
+        }
+        cells_[it->second].atomIndices.push_back(i);
+    }
+
+    // bounding spheres and dispersion moments of the cells:
+    for (Cell& cell: cells_){
+        Core::Vector center(0.0, 0.0, 0.0);
+        for (std::size_t i: cell.atomIndices){
+            center += atoms[i]->getRelativePosition();
+        }
+        cell.center = center / static_cast<double>(cell.atomIndices.size());
+
+        for (std::size_t i: cell.atomIndices){
+            cell.radius = std::max(cell.radius, (atoms[i]->getRelativePosition() - cell.center).magnitude());
+
+            double sqrtEpsilon = std::sqrt(atoms[i]->getEpsilon());
+            double sigmaPower = 1.0;
+            for (double& moment: cell.dispersionMoments){
+                moment += sqrtEpsilon * sigmaPower;
+                sigmaPower *= atoms[i]->getSigma();
+            }
+        }
+    }
+}
+
+/**
+ * Gets the radius in which atoms are evaluated individually
+ */
+double CollisionModel::AtomCellGrid::getCutoffRadius() const{
+    return cutoffRadius_;
+}
+
+/**
+ * Gets the edge length of the grid cells
+ */
+double CollisionModel::AtomCellGrid::getCellSize() const{
+    return cellSize_;
+}
+
+/**
+ * Gets the non empty cells of the grid
+ */
+const std::vector<CollisionModel::AtomCellGrid::Cell>& CollisionModel::AtomCellGrid::getCells() const{
+    return cells_;
+}
+
+/**
+ * Gets the indices of the charged atoms, which are not binned into the cells
+ */
+const std::vector<std::size_t>& CollisionModel::AtomCellGrid::getChargedAtomIndices() const{
+    return chargedAtomIndices_;
+}
+
+/**
+ * Checks if an atom is charged (and therefore takes part in the electrostatic interactions of the MD force field)
+ */
+bool CollisionModel::AtomCellGrid::isChargedAtom(const Atom& atom){
+    return int(ceil(fabs(atom.getCharge()/Core::ELEMENTARY_CHARGE))) != 0;
+}
+
+/**
+ * Calculates the aggregated Lennard-Jones dispersion coefficient C6 = sum(4 * epsilon_ij * sigma_ij^6) of all
+ * atoms i in a cell with an atom j, with the combination rules epsilon_ij = sqrt(epsilon_i * epsilon_j) and
+ * sigma_ij = (sigma_i + sigma_j) / 2
+ *
+ * @param cell the cell
+ * @param atom the interacting atom
+ * @return the aggregated C6 coefficient (J m^6)
+ */
+double CollisionModel::AtomCellGrid::dispersionCoefficient(const Cell& cell, const Atom& atom){
+    constexpr std::array<double, 7> binomial = {1.0, 6.0, 15.0, 20.0, 15.0, 6.0, 1.0};
+    double sigma = atom.getSigma();
+
+    // sum_k binom(6,k) * moment_k * sigma_j^(6-k), evaluated from k = 6 downwards:
+    double result = 0.0;
+    double sigmaPower = 1.0;
+    for (std::size_t k=7; k-- > 0;){
+        result += binomial[k] * cell.dispersionMoments[k] * sigmaPower;
+        sigmaPower *= sigma;
+    }
+    return 4.0 * std::sqrt(atom.getEpsilon()) * result / 64.0;
+}
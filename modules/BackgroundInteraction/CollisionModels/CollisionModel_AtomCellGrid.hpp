@@ -0,0 +1,86 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ CollisionModel_AtomCellGrid.hpp
+
+ Spatial index (uniform cell grid) of the atoms of a molecular structure for cut-off based MD force calculation
+
+ ****************************/
+
+#ifndef IDSIMF_COLLISIONMODEL_ATOMCELLGRID_H
+#define IDSIMF_COLLISIONMODEL_ATOMCELLGRID_H
+
+#include "CollisionModel_Atom.hpp"
+#include "Core_vector.hpp"
+#include <vector>
+#include <array>
+#include <memory>
+#include <cstddef>
+
+namespace CollisionModel{
+
+    /**
+     * Spatial index of the atoms of a molecular structure in the molecule frame (the relative atom positions of the
+     * unrotated structure), which allows the MD force field to evaluate only the atom pairs in the vicinity of a
+     * background gas atom individually.
+     *
+     * The uncharged atoms are binned into the cells of a uniform grid with a cell size of a quarter of the cut-off
+     * radius. Every non empty cell stores its atoms, a bounding sphere (centroid of the atoms and maximum atom distance
+     * from the centroid) and the moments of the Lennard-Jones parameters of its atoms, which allow to calculate the
+     * aggregated dispersion (C6) coefficient of the whole cell with any other atom exactly for the Lorentz-Berthelot
+     * combination rules. Cells with a bounding sphere closer than the cut-off radius to an atom are evaluated
+     * atom by atom, the dispersion attraction of farther cells is approximated by a single C6 term at the cell
+     * centroid (long range correction).
+     *
+     * Charged atoms are not binned but collected in a separate list, since the electrostatic interactions are long
+     * ranged and always evaluated for all charged atoms.
+     */
+    class AtomCellGrid {
+
+    public:
+        /**
+         * A cell of the grid
+         */
+        struct Cell{
+            std::vector<std::size_t> atomIndices; ///< Indices of the atoms in the cell
+            Core::Vector center; ///< Centroid of the atoms in the cell (molecule frame)
+            double radius = 0.0; ///< Maximum distance of an atom in the cell from the centroid
+            std::array<double, 7> dispersionMoments = {}; ///< Moments sum(sqrt(epsilon) * sigma^k), k = 0..6
+        };
+
+        AtomCellGrid(const std::vector<std::shared_ptr<Atom>>& atoms, double cutoffRadius);
+
+        [[nodiscard]] double getCutoffRadius() const;
+        [[nodiscard]] double getCellSize() const;
+        [[nodiscard]] const std::vector<Cell>& getCells() const;
+        [[nodiscard]] const std::vector<std::size_t>& getChargedAtomIndices() const;
+        [[nodiscard]] static bool isChargedAtom(const Atom& atom);
+        [[nodiscard]] static double dispersionCoefficient(const Cell& cell, const Atom& atom);
+
+    private:
+        double cutoffRadius_; ///< Radius in which atoms are evaluated individually
+        double cellSize_; ///< Edge length of the grid cells
+        std::vector<Cell> cells_; ///< Non empty cells of the grid
+        std::vector<std::size_t> chargedAtomIndices_; ///< Indices of the charged atoms
+    };
+}
+
+#endif //IDSIMF_COLLISIONMODEL_ATOMCELLGRID_H
@@ -99,6 +99,19 @@ void CollisionModel::CollisionStatistics::initCollisionModelFromStatisticsFile_(
     }
 }
 
+/**
+ * Estimates the memory used by the collision statistics data (the mass ratios and the ICDF data)
+ */
+std::size_t CollisionModel::CollisionStatistics::memoryUsageBytes() const {
+    std::size_t result = sizeof(CollisionStatistics);
+    result += (massRatios_.capacity() + logMassRatios_.capacity() + logMassRatioDists_.capacity())*sizeof(double);
+    result += icdfs_.capacity()*sizeof(std::vector<double>);
+    for (const auto& icdf: icdfs_){
+        result += icdf.capacity()*sizeof(double);
+    }
+    return result;
+}
+
 /**
  * Gets the index of the collision distribution with a logMassRatio above the given logMassRatio
  * @param logMassRatio the logarithmic mass ratio to find the distribution index for
@@ -56,6 +56,7 @@ namespace CollisionModel{
             [[nodiscard]] double getLogMassRatioDistance(std::size_t index) const;
             [[nodiscard]] std::vector<std::vector<double>> getICDFs() const;
             [[nodiscard]] std::size_t findUpperDistIndex(double logMassRatio) const;
+            [[nodiscard]] std::size_t memoryUsageBytes() const;
 
 
         private:
@@ -132,29 +132,88 @@ void CollisionModel::HardSphereModel::modifyVelocity(Core::Particle &ion, double
 
     Core::RandomSource* rndSource = Core::globalRandomGeneratorPool->getThreadRandomSource();
 
-    // Calculate collision cross section between particle and collision gas:
-    //   TODO: It seems to be unnecessary to constantly recalculate this
-    //   value, cache the calculated values somehow?
-    double sigma_m2 = M_PI * std::pow( (ion.getDiameter() + collisionGasDiameter_m_)/2.0, 2.0);
+    double collisionFrequency_Hz = collisionFrequency_(ion, 0.0);
+    if (collisionFrequency_Hz <= 0.0){
+        return; //pressure 0 means no collision at all
+    }
+
+    // Compute probability of collision in the current time-step.
+    double collisionProb = 1.0 - std::exp(-collisionFrequency_Hz * dt);
+
+    // FIXME: The time step length dt is unrestricted
+    // Possible mitigation: Throw warning / exception if collision probability becomes too high
+
+    // Decide if a collision actually happens:
+    if (rndSource->uniformRealRndValue() > collisionProb){
+        return; // no collision takes place
+    }
+
+    // Now we know that a collision happens: Perform the collision
+    collide_(ion, rndSource);
+}
+
+void CollisionModel::HardSphereModel::modifyPosition(Core::Vector& /*position*/, Core::Particle& /*ion*/, double /*dt*/) {}
+
+/**
+ * The hard sphere model describes the gas interaction with discrete collision events
+ */
+bool CollisionModel::HardSphereModel::hasCollisionEvents() const {
+    return true;
+}
+
+/**
+ * Gets the collision frequency of a particle with its current velocity in the background gas at its current
+ * location
+ */
+double CollisionModel::HardSphereModel::collisionFrequency(Core::Particle &ion) const {
+    return collisionFrequency_(ion, 0.0);
+}
+
+/**
+ * Gets an upper bound of the collision frequency of a particle at its current location for all velocities which
+ * differ from the current particle velocity by at most speedIncrease. Since the mean relative speed between ion and
+ * gas particles increases monotonically with the ion speed relative to the gas, the bound is the collision frequency
+ * of the maximum possible relative ion speed.
+ *
+ * @param ion the particle
+ * @param speedIncrease maximum magnitude of the velocity change of the particle (m/s)
+ */
+double CollisionModel::HardSphereModel::collisionFrequencyBound(Core::Particle &ion, double speedIncrease) const {
+    return collisionFrequency_(ion, speedIncrease);
+}
+
+/**
+ * Performs a hard sphere collision of the particle with a background gas particle
+ */
+void CollisionModel::HardSphereModel::performCollision(Core::Particle &ion) {
+    collide_(ion, Core::globalRandomGeneratorPool->getThreadRandomSource());
+}
+
+/**
+ * Calculates the collision frequency of a particle, with the particle speed relative to the mean background gas
+ * velocity increased by a speed increase
+ */
+double CollisionModel::HardSphereModel::collisionFrequency_(Core::Particle &ion, double speedIncrease) const {
 
     Core::Vector pLocation = ion.getLocation();
     double localPressure_Pa = pressureFunction_(pLocation);
 
     if (Core::isDoubleEqual(localPressure_Pa, 0.0)){
-        return; //pressure 0 means no collision at all
+        return 0.0; //pressure 0 means no collision at all
     }
 
+    // Calculate collision cross section between particle and collision gas:
+    //   TODO: It seems to be unnecessary to constantly recalculate this
+    //   value, cache the calculated values somehow?
+    double sigma_m2 = M_PI * std::pow( (ion.getDiameter() + collisionGasDiameter_m_)/2.0, 2.0);
+
     // Transform the frame of reference in a frame where the mean background gas velocity is zero.
     Core::Vector vGasMean = velocityFunction_(pLocation);
-    Core::Vector vFrameMeanBackRest = ion.getVelocity() - vGasMean;
-
-    double vRelIonMeanBackRest = vFrameMeanBackRest.magnitude(); //relative ion relative to bulk gas velocity
-
-    // Calculate the mean free path (MFP) from current ion velocity:
+    double vRelIonMeanBackRest = (ion.getVelocity() - vGasMean).magnitude() + speedIncrease;
 
     // a static ion leads in static gas leads to a relative velocity of zero, which leads
     // to undefined behavior due to division by zero later.
-    // The whole process converges to the MFP and collision probability of a static ion, thus
+    // The whole process converges to the collision probability of a static ion, thus
     // it is possible to assume a small velocity (1 nm/s) for the static ions to get rid of undefined behavior
     if (vRelIonMeanBackRest < 1e-9){
         vRelIonMeanBackRest = 1e-9;
@@ -172,22 +231,27 @@ void CollisionModel::HardSphereModel::modifyVelocity(Core::Particle &ion, double
     double cMeanRel = vMeanGas * (
             (s + 1.0/(2.0*s)) * 0.5 * PI_SQRT * std::erf(s) + 0.5 * std::exp(-s*s) );
 
-    // Compute mean-free-path (m)
-    double effectiveMFP_m = Core::K_BOLTZMANN * temperature_K *
-                            (vRelIonMeanBackRest / cMeanRel) / (localPressure_Pa * sigma_m2);
+    // The mean free path is kT / (p sigma) * (vRel / cMeanRel), thus the collision frequency
+    // (vRel / mean free path) is the gas number density times sigma times the mean relative speed:
+    return localPressure_Pa * sigma_m2 * cMeanRel / (Core::K_BOLTZMANN * temperature_K);
+}
 
-    // Compute probability of collision in the current time-step.
-    double collisionProb = 1.0 - std::exp(-vRelIonMeanBackRest * dt / effectiveMFP_m);
+/**
+ * Performs a hard sphere collision of a particle with a randomly chosen background gas particle
+ */
+void CollisionModel::HardSphereModel::collide_(Core::Particle &ion, Core::RandomSource* rndSource) {
 
-    // FIXME: The time step length dt is unrestricted
-    // Possible mitigation: Throw warning / exception if collision probability becomes too high
+    Core::Vector pLocation = ion.getLocation();
+    double temperature_K = temperatureFunction_(pLocation);
 
-    // Decide if a collision actually happens:
-    if (rndSource->uniformRealRndValue() > collisionProb){
-        return; // no collision takes place
+    // Transform the frame of reference in a frame where the mean background gas velocity is zero.
+    Core::Vector vGasMean = velocityFunction_(pLocation);
+    Core::Vector vFrameMeanBackRest = ion.getVelocity() - vGasMean;
+
+    double vRelIonMeanBackRest = vFrameMeanBackRest.magnitude(); //relative ion relative to bulk gas velocity
+    if (vRelIonMeanBackRest < 1e-9){
+        vRelIonMeanBackRest = 1e-9;
     }
-    
-    // Now we know that a collision happens: Perform the collision
 
     // Calculate the standard deviation of the one dimensional velocity distribution of the
     // background gas particles. Std. dev. in one dimension is given from Maxwell-Boltzmann
@@ -315,5 +379,3 @@ void CollisionModel::HardSphereModel::modifyVelocity(Core::Particle &ion, double
         afterCollisionActionFunction_(collisionConditions, ion);
     }
 }
-
-void CollisionModel::HardSphereModel::modifyPosition(Core::Vector& /*position*/, Core::Particle& /*ion*/, double /*dt*/) {}
\ No newline at end of file
@@ -45,6 +45,7 @@
 #include "CollisionModel_AbstractCollisionModel.hpp"
 #include "CollisionModel_SpatialFieldFunctions.hpp"
 #include "CollisionModel_MathFunctions.hpp"
+#include "Core_randomGenerators.hpp"
 #include "RS_AbstractReaction.hpp"
 #include <cstdio>
 #include <functional>
@@ -107,6 +108,11 @@ namespace CollisionModel{
                 Core::Particle& ion,
                 double dt) override;
 
+        [[nodiscard]] bool hasCollisionEvents() const override;
+        [[nodiscard]] double collisionFrequency(Core::Particle& ion) const override;
+        [[nodiscard]] double collisionFrequencyBound(Core::Particle& ion, double speedIncrease) const override;
+        void performCollision(Core::Particle& ion) override;
+
     private:
         const double PI_SQRT = std::sqrt(M_PI);
         const double PI_2 = 2.0*M_PI;
@@ -123,6 +129,9 @@ namespace CollisionModel{
         std::function<double(const Core::Vector&)>temperatureFunction_ = nullptr;  ///< Spatial temperature function
         std::function<void(RS::CollisionConditions, Core::Particle&)> afterCollisionActionFunction_ = nullptr;
         ///< Function with things to do after a collision (e.g. collision based chemical reactions)
+
+        [[nodiscard]] double collisionFrequency_(Core::Particle& ion, double speedIncrease) const;
+        void collide_(Core::Particle& ion, Core::RandomSource* rndSource);
     };
 }
 
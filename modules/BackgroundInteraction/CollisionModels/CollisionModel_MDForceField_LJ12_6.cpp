@@ -46,6 +46,12 @@ void CollisionModel::MDForceField_LJ12_6::calculateForceField(std::vector<Collis
         isCO2 = true;
     }
 
+    if(isAtomCellGridApplicable(moleculesPtr)){
+        calculateAtomCellGridForceField(moleculesPtr, forceMolecules, collisionGasPolarizability_m3_,
+                                        isN2, isN2Approx, isCO2);
+        return;
+    }
+
     // construct E-field acting on the molecule
     std::array<double, 3> eField = {0., 0., 0.};
     std::array<double, 6> eFieldDerivative = {0., 0., 0., 0., 0., 0.};
@@ -224,4 +230,159 @@ void CollisionModel::MDForceField_LJ12_6::calculateForceField(std::vector<Collis
     }
     forceMolecules[0] += ionInducedForce;
     forceMolecules[1] += ionInducedForce * (-1);
-}
\ No newline at end of file
+}
+/**
+ * Checks if the cut-off based force calculation with the spatial index of the ion can be used: The molecular
+ * structure of the ion (first molecule) has to provide an atom cell grid and the atoms of the background gas
+ * molecule (second molecule) have to be uncharged.
+ */
+bool CollisionModel::MDForceField_LJ12_6::isAtomCellGridApplicable(std::vector<CollisionModel::Molecule*>& moleculesPtr){
+    if(moleculesPtr[0]->getAtomCellGrid() == nullptr){
+        return false;
+    }
+    for(auto& atomJ : moleculesPtr[1]->getAtoms()){
+        if(CollisionModel::AtomCellGrid::isChargedAtom(*atomJ)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Calculates the forces between an ion and a background gas molecule with the spatial index (atom cell grid) of
+ * the ion: The Lennard-Jones interaction of a background gas atom is evaluated atom by atom only for the grid cells
+ * in the cut-off radius, the farther cells contribute with their aggregated dispersion attraction at the cell
+ * centroid. The electrostatic contributions (C4 ion-induced dipole and N2 quadrupole) are long ranged and are
+ * evaluated for all charged atoms of the ion. Without a cut-off (all cells in the cut-off radius) the result is
+ * equal to the full pairwise calculation.
+ *
+ * @param moleculesPtr the ion (first) and the background gas molecule (second)
+ * @param forceMolecules the calculated forces on the molecules
+ * @param collisionGasPolarizability_m3 the polarizability of the background gas
+ * @param isN2 flag if the background gas is N2
+ * @param isN2Approx flag if the background gas is approximated N2
+ * @param isCO2 flag if the background gas is CO2
+ */
+void CollisionModel::MDForceField_LJ12_6::calculateAtomCellGridForceField(
+        std::vector<CollisionModel::Molecule*>& moleculesPtr, std::vector<Core::Vector>& forceMolecules,
+        double collisionGasPolarizability_m3, bool isN2, bool isN2Approx, bool isCO2) {
+
+    CollisionModel::Molecule* ion = moleculesPtr[0];
+    CollisionModel::Molecule* bgGas = moleculesPtr[1];
+    forceMolecules[0] = Core::Vector(0.0, 0.0, 0.0);
+    forceMolecules[1] = Core::Vector(0.0, 0.0, 0.0);
+
+    const CollisionModel::AtomCellGrid& grid = *ion->getAtomCellGrid();
+    const std::vector<CollisionModel::AtomCellGrid::Cell>& cells = grid.getCells();
+    const std::vector<Core::Vector>& cellCenters = ion->getCellCenters();
+    std::vector<std::shared_ptr<CollisionModel::Atom>>& ionAtoms = ion->getAtoms();
+    double cutoffRadius = grid.getCutoffRadius();
+
+    std::array<double, 3> eField = {0., 0., 0.};
+    std::array<double, 6> eFieldDerivative = {0., 0., 0., 0., 0., 0.};
+
+    for(auto& atomJ : bgGas->getAtoms()){
+        Core::Vector absPosAtomJ = bgGas->getComPos() + atomJ->getRelativePosition();
+
+        // charged atoms: all contributions
+        for(std::size_t i : grid.getChargedAtomIndices()){
+            Core::Vector distance = ion->getComPos() + ionAtoms[i]->getRelativePosition() - absPosAtomJ;
+            addLennardJonesForce_(*ionAtoms[i], *atomJ, distance, forceMolecules);
+            addChargedAtomPairForces_(*ionAtoms[i], *atomJ, distance, isN2, isN2Approx, isCO2,
+                                      eField, eFieldDerivative, forceMolecules);
+        }
+
+        // uncharged atoms: Lennard-Jones in the cut-off radius, aggregated dispersion of the far cells
+        for(std::size_t c = 0; c < cells.size(); ++c){
+            Core::Vector cellDistance = ion->getComPos() + cellCenters[c] - absPosAtomJ;
+            if(cellDistance.magnitude() - cells[c].radius > cutoffRadius){
+                double c6 = CollisionModel::AtomCellGrid::dispersionCoefficient(cells[c], *atomJ);
+                double distanceSquaredInverse = 1./cellDistance.magnitudeSquared();
+                double dispersionFactor = -6 * c6 *
+                        distanceSquaredInverse*distanceSquaredInverse*distanceSquaredInverse*distanceSquaredInverse;
+                Core::Vector dispersionForce = cellDistance * dispersionFactor;
+                forceMolecules[0] += dispersionForce;
+                forceMolecules[1] += dispersionForce * (-1);
+            }else{
+                for(std::size_t i : cells[c].atomIndices){
+                    Core::Vector distance = ion->getComPos() + ionAtoms[i]->getRelativePosition() - absPosAtomJ;
+                    addLennardJonesForce_(*ionAtoms[i], *atomJ, distance, forceMolecules);
+                }
+            }
+        }
+    }
+
+    // add the C4 ion-induced dipole force contribution
+    double polarizabilityFactor = isN2Approx ? collisionGasPolarizability_m3/2 : collisionGasPolarizability_m3;
+    Core::Vector ionInducedForce;
+    ionInducedForce.x(1./(Core::ELECTRIC_CONSTANT) * polarizabilityFactor *
+            (eField[0]*eFieldDerivative[0] + eField[1]*eFieldDerivative[1] + eField[2]*eFieldDerivative[5]));
+    ionInducedForce.y(1./(Core::ELECTRIC_CONSTANT) * polarizabilityFactor *
+            (eField[0]*eFieldDerivative[1] + eField[1]*eFieldDerivative[2] + eField[2]*eFieldDerivative[3]));
+    ionInducedForce.z(1./(Core::ELECTRIC_CONSTANT) * polarizabilityFactor *
+            (eField[0]*eFieldDerivative[5] + eField[1]*eFieldDerivative[3] + eField[2]*eFieldDerivative[4]));
+    forceMolecules[0] += ionInducedForce;
+    forceMolecules[1] += ionInducedForce * (-1);
+}
+
+/**
+ * Adds the Lennard-Jones force between two atoms to the molecule forces
+ *
+ * @param distance the distance vector from atom J to atom I
+ */
+void CollisionModel::MDForceField_LJ12_6::addLennardJonesForce_(Atom& atomI, Atom& atomJ, const Core::Vector& distance,
+                                                                std::vector<Core::Vector>& forceMolecules) {
+    double distanceSquaredInverse = 1./distance.magnitudeSquared();
+    double sigma = CollisionModel::Atom::calcLJSig(atomI, atomJ);
+    double sigma6 = sigma * sigma * sigma * sigma * sigma * sigma;
+    double epsilon = CollisionModel::Atom::calcLJEps(atomI, atomJ);
+    double ljFactor = 24 * epsilon * distanceSquaredInverse*distanceSquaredInverse*distanceSquaredInverse*distanceSquaredInverse *
+            (2 * distanceSquaredInverse*distanceSquaredInverse*distanceSquaredInverse * sigma6 * sigma6 - sigma6);
+
+    Core::Vector atomForce = distance * ljFactor;
+    forceMolecules[0] += atomForce;
+    forceMolecules[1] += atomForce * (-1);
+}
+
+/**
+ * Adds the electrostatic contributions of a charged ion atom I and an uncharged background gas atom J: The E-field
+ * and its derivative for the C4 ion-induced dipole force and the N2 quadrupole force
+ *
+ * @param distance the distance vector from atom J to atom I
+ */
+void CollisionModel::MDForceField_LJ12_6::addChargedAtomPairForces_(Atom& atomI, Atom& atomJ,
+                                                                    const Core::Vector& distance,
+                                                                    bool isN2, bool isN2Approx, bool isCO2,
+                                                                    std::array<double, 3>& eField,
+                                                                    std::array<double, 6>& eFieldDerivative,
+                                                                    std::vector<Core::Vector>& forceMolecules) {
+    double distanceSquared = distance.magnitudeSquared();
+    double distanceCubed = distanceSquared * sqrt(distanceSquared);
+
+    // C4 ion-induced dipole: with the center of mass of N2 / CO2 or with all other gas atoms
+    bool isCenterOfMassJ = atomJ.getType() == CollisionModel::Atom::AtomType::COM;
+    if((isN2 || isCO2) == isCenterOfMassJ){
+        double currentCharge = atomI.getCharge();
+        eField[0] += distance.x() * currentCharge / distanceCubed;
+        eField[1] += distance.y() * currentCharge / distanceCubed;
+        eField[2] += distance.z() * currentCharge / distanceCubed;
+
+        eFieldDerivative[0] += currentCharge / distanceCubed -
+                3 * currentCharge * distance.x() * distance.x() / (distanceCubed * distanceSquared);
+        eFieldDerivative[1] += -3 * currentCharge * distance.x() * distance.y() / (distanceCubed * distanceSquared);
+        eFieldDerivative[2] += currentCharge / distanceCubed -
+                3 * currentCharge * distance.y() * distance.y() / (distanceCubed * distanceSquared);
+        eFieldDerivative[3] += -3 * currentCharge * distance.y() * distance.z() / (distanceCubed * distanceSquared);
+        eFieldDerivative[4] += currentCharge / distanceCubed -
+                3 * currentCharge * distance.z() * distance.z() / (distanceCubed * distanceSquared);
+        eFieldDerivative[5] += -3 * currentCharge * distance.x() * distance.z() / (distanceCubed * distanceSquared);
+    }
+
+    // quadrupole moment if background gas is N2
+    if(isN2 || isN2Approx){
+        Core::Vector quadrupoleForce = distance *
+                (atomI.getCharge() * atomJ.getPartCharge() * 1./Core::ELECTRIC_CONSTANT / distanceCubed);
+        forceMolecules[0] += quadrupoleForce;
+        forceMolecules[1] += quadrupoleForce * (-1);
+    }
+}
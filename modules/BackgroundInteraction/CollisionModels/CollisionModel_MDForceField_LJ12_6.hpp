@@ -28,6 +28,7 @@
 #define IDSIMF_COLLISIONMODEL_MDFORCEFIELD_LJ12_6_HPP
 
 #include "CollisionModel_AbstractMDForceField.hpp"
+#include <array>
 
 namespace CollisionModel{
     class MDForceField_LJ12_6 : public AbstractMDForceField {
@@ -37,8 +38,24 @@ namespace CollisionModel{
 
         void calculateForceField(std::vector<CollisionModel::Molecule*>& moleculesPtr, std::vector<Core::Vector>& forceMolecules) override;
 
+        static bool isAtomCellGridApplicable(std::vector<CollisionModel::Molecule*>& moleculesPtr);
+
+        static void calculateAtomCellGridForceField(std::vector<CollisionModel::Molecule*>& moleculesPtr,
+                                                    std::vector<Core::Vector>& forceMolecules,
+                                                    double collisionGasPolarizability_m3,
+                                                    bool isN2, bool isN2Approx, bool isCO2);
+
     private:
         double collisionGasPolarizability_m3_ = 0.0; ///< polarizability of the collision gas in m^3
+
+        static void addLennardJonesForce_(Atom& atomI, Atom& atomJ, const Core::Vector& distance,
+                                          std::vector<Core::Vector>& forceMolecules);
+
+        static void addChargedAtomPairForces_(Atom& atomI, Atom& atomJ, const Core::Vector& distance,
+                                              bool isN2, bool isN2Approx, bool isCO2,
+                                              std::array<double, 3>& eField,
+                                              std::array<double, 6>& eFieldDerivative,
+                                              std::vector<Core::Vector>& forceMolecules);
     };
 }
 
@@ -32,6 +32,7 @@
 #include <initializer_list>
 #include <limits>
 #include "CollisionModel_MathFunctions.hpp"
+#include "CollisionModel_MDForceField_LJ12_6.hpp"
 
 CollisionModel::MDInteractionsModelPreconstructed::MDInteractionsModelPreconstructed(double staticPressure,
                                                         double staticTemperature,
@@ -918,6 +919,11 @@ void CollisionModel::MDInteractionsModelPreconstructed::forceFieldMD(std::vector
         isN2Approx = true;
     }
 
+    if(CollisionModel::MDForceField_LJ12_6::isAtomCellGridApplicable(moleculesPtr)){
+        CollisionModel::MDForceField_LJ12_6::calculateAtomCellGridForceField(
+                moleculesPtr, forceMolecules, collisionGasPolarizability_m3_, isN2, isN2Approx, false);
+        return;
+    }
 
     // construct E-field acting on the molecule
     std::array<double, 3> eField = {0., 0., 0.};
@@ -76,6 +76,13 @@ double CollisionModel::MolecularStructure::getMass() const{
     return mass;
 }
 
+/**
+ * Gets the spatial index of the atoms (nullptr if no index was built)
+ */
+std::shared_ptr<const CollisionModel::AtomCellGrid> CollisionModel::MolecularStructure::getAtomCellGrid() const{
+    return atomCellGrid;
+}
+
 /**
  * Gets the dipole vector
  */
@@ -163,6 +170,9 @@ void CollisionModel::MolecularStructure::addAtom(std::shared_ptr<CollisionModel:
     this->calcMass();
     this->setIsDipole();
     this->setIsIon();   
+    if(atomCellGrid != nullptr){
+        this->buildAtomCellGrid(atomCellGrid->getCutoffRadius());
+    }
 }
 
 /**
@@ -177,6 +187,20 @@ void CollisionModel::MolecularStructure::removeAtom(std::shared_ptr<CollisionMod
     this->calcMass();
     this->setIsDipole();
     this->setIsIon(); 
+    if(atomCellGrid != nullptr){
+        this->buildAtomCellGrid(atomCellGrid->getCutoffRadius());
+    }
+}
+
+/**
+ * Builds the spatial index (cell grid) of the atoms of the MolecularStructure, which enables the cut-off based 
+ * force calculation in the MD force field for all molecules created from this structure. 
+ * The index is built once per structure and has to be built before the structure is used in parallel. 
+ * 
+ * @param cutoffRadius radius in which atom pairs are evaluated individually in m
+ */
+void CollisionModel::MolecularStructure::buildAtomCellGrid(double cutoffRadius){
+    this->atomCellGrid = std::make_shared<const AtomCellGrid>(atoms, cutoffRadius);
 }
 
 /**
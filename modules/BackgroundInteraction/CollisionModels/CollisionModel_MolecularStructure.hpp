@@ -30,6 +30,7 @@
 #define IDSIMF_COLLISIONMODEL_MOLECULARSTRUCTURE_H
 
 #include "CollisionModel_Atom.hpp"
+#include "CollisionModel_AtomCellGrid.hpp"
 #include "Core_constants.hpp"
 #include "Core_vector.hpp"
 #include <vector>
@@ -66,6 +67,7 @@ namespace CollisionModel{
         std::vector<std::shared_ptr<CollisionModel::Atom>> getAtoms() const;
         double getDiameter() const;
         std::string getName() const; 
+        std::shared_ptr<const AtomCellGrid> getAtomCellGrid() const;
         static double getMomentOfInertia(double x1, double x2, double m1, double m2); 
         static double getAngularVelocity(double T, double I); 
         // static void rotateMolecule2D(double angle);
@@ -73,6 +75,7 @@ namespace CollisionModel{
         // Member functions
         void addAtom(std::shared_ptr<CollisionModel::Atom> atm);
         void removeAtom(std::shared_ptr<CollisionModel::Atom> atm);
+        void buildAtomCellGrid(double cutoffRadius);
 
         // static std::unordered_map<std::string, std::shared_ptr<MolecularStructure>> createCollection();
         
@@ -96,6 +99,7 @@ namespace CollisionModel{
         std::vector<std::shared_ptr<Atom>> atoms = {}; // Vector of all atoms belonging to this molecule 
         double diameter = 0.0; // Diameter of the molecule for collision probability [m]
         std::string structureName = "";
+        std::shared_ptr<const AtomCellGrid> atomCellGrid = nullptr; // Spatial index of the atoms for cut-off based force calculation
 
         
     };
@@ -83,12 +83,18 @@ CollisionModel::Molecule::Molecule(const Core::Vector &comPos, const Core::Vecto
     dipoleMag(structure->getDipoleMag()),
     atomCount(structure->getAtoms().size()),
     diameter(structure->getDiameter()), 
-    molecularStructureName(structure->getName())
+    molecularStructureName(structure->getName()),
+    atomCellGrid(structure->getAtomCellGrid())
 {
     atoms.resize(atomCount);
     for(size_t i = 0; i < atomCount; i++) {
         this->atoms.at(i) = std::make_shared<Atom>(*(structure->getAtoms().at(i)));
     }
+    if(atomCellGrid != nullptr){
+        for(const auto& cell : atomCellGrid->getCells()){
+            cellCenters.push_back(cell.center);
+        }
+    }
 
 }
 
@@ -212,6 +218,21 @@ std::string CollisionModel::Molecule::getMolecularStructureName() const{
     return molecularStructureName;
 }
 
+/**
+ * Gets the spatial index of the atoms of the molecular structure (nullptr if the structure has no index)
+ */
+std::shared_ptr<const CollisionModel::AtomCellGrid> CollisionModel::Molecule::getAtomCellGrid() const{
+    return atomCellGrid;
+}
+
+/**
+ * Gets the current centers of the cells of the spatial index, relative to the center-of-mass and rotated with 
+ * the molecule
+ */
+const std::vector<Core::Vector>& CollisionModel::Molecule::getCellCenters() const{
+    return cellCenters;
+}
+
 /**
  * Calculates the current mass of the molecule
  */
@@ -303,5 +324,8 @@ void CollisionModel::Molecule::rotateMolecule(){
     for(auto& atom : atoms){
        atom->rotate(this->angles);
     }
+    for(auto& cellCenter : cellCenters){
+       CollisionModel::Atom::rotate(this->angles, cellCenter);
+    }
 }
 
@@ -70,6 +70,8 @@ namespace CollisionModel{
         std::vector<std::shared_ptr<CollisionModel::Atom>>& getAtoms();
         double getDiameter() const;
         std::string getMolecularStructureName() const; 
+        std::shared_ptr<const CollisionModel::AtomCellGrid> getAtomCellGrid() const;
+        const std::vector<Core::Vector>& getCellCenters() const;
 
         // Member functions
         void addAtom(std::shared_ptr<CollisionModel::Atom> atm);
@@ -98,6 +100,8 @@ namespace CollisionModel{
         std::vector<std::shared_ptr<CollisionModel::Atom>> atoms; // Vector of all atoms belonging to this molecule 
         double diameter = 0.0; // Diameter of the molecule for collision probability [m]
         std::string molecularStructureName = "";
+        std::shared_ptr<const CollisionModel::AtomCellGrid> atomCellGrid = nullptr; // Spatial index of the atoms of the molecular structure
+        std::vector<Core::Vector> cellCenters; // Current (rotated) centers of the cells of the spatial index relative to the center-of-mass [m]
 
         
     };
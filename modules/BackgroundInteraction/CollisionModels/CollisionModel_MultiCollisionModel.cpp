@@ -20,6 +20,8 @@
  ****************************/
 
 #include "CollisionModel_MultiCollisionModel.hpp"
+#include "Core_randomGenerators.hpp"
+#include <algorithm>
 
 /**
  * Constructs a multi collision model from a vector of collision models.
@@ -87,3 +89,91 @@ void CollisionModel::MultiCollisionModel::modifyAcceleration(Core::Vector &accel
         model->modifyAcceleration(acceleration,ion,dt);
     }
 }
+
+/**
+ * Gets the total damping rate of the continuous drags of all combined sub models
+ */
+double CollisionModel::MultiCollisionModel::dragDampingRate(Core::Particle &ion) const{
+    double result = 0.0;
+    for(const auto &model: models_){
+        result += model->dragDampingRate(ion);
+    }
+    return result;
+}
+
+/**
+ * Gets the gas velocity of the combined drag of all sub models: The sum of the linear drags of the sub models is a
+ * linear drag with the total damping rate, which relaxes the particle velocity to the damping rate weighted mean of
+ * the gas velocities of the sub models
+ */
+Core::Vector CollisionModel::MultiCollisionModel::dragGasVelocity(Core::Particle &ion) const{
+    double totalDampingRate = 0.0;
+    Core::Vector weightedVelocity(0.0, 0.0, 0.0);
+    for(const auto &model: models_){
+        double dampingRate = model->dragDampingRate(ion);
+        if (dampingRate > 0.0){
+            totalDampingRate += dampingRate;
+            weightedVelocity = weightedVelocity + model->dragGasVelocity(ion)*dampingRate;
+        }
+    }
+    if (totalDampingRate <= 0.0){
+        return {0.0, 0.0, 0.0};
+    }
+    return weightedVelocity / totalDampingRate;
+}
+
+/**
+ * Checks if all combined sub models describe the gas interaction with collision events
+ */
+bool CollisionModel::MultiCollisionModel::hasCollisionEvents() const{
+    return std::all_of(models_.begin(), models_.end(),
+            [](const std::unique_ptr<AbstractCollisionModel>& model){return model->hasCollisionEvents();});
+}
+
+/**
+ * Gets the total collision frequency of all combined sub models
+ */
+double CollisionModel::MultiCollisionModel::collisionFrequency(Core::Particle &ion) const{
+    double result = 0.0;
+    for(const auto &model: models_){
+        result += model->collisionFrequency(ion);
+    }
+    return result;
+}
+
+/**
+ * Gets the sum of the collision frequency bounds of all combined sub models
+ */
+double CollisionModel::MultiCollisionModel::collisionFrequencyBound(Core::Particle &ion, double speedIncrease) const{
+    double result = 0.0;
+    for(const auto &model: models_){
+        result += model->collisionFrequencyBound(ion, speedIncrease);
+    }
+    return result;
+}
+
+/**
+ * Performs a collision event with one of the combined sub models, which is chosen randomly with a probability
+ * proportional to the collision frequency of the sub model
+ */
+void CollisionModel::MultiCollisionModel::performCollision(Core::Particle &ion){
+    std::vector<double> frequencies;
+    double totalFrequency = 0.0;
+    for(const auto &model: models_){
+        frequencies.push_back(model->collisionFrequency(ion));
+        totalFrequency += frequencies.back();
+    }
+    if (totalFrequency <= 0.0){
+        return;
+    }
+
+    double rndValue = Core::globalRandomGeneratorPool->getThreadRandomSource()->uniformRealRndValue() * totalFrequency;
+    double cumulativeFrequency = 0.0;
+    for (std::size_t i=0; i<models_.size(); ++i){
+        cumulativeFrequency += frequencies[i];
+        if (rndValue < cumulativeFrequency || i == models_.size()-1){
+            models_[i]->performCollision(ion);
+            return;
+        }
+    }
+}
@@ -53,6 +53,13 @@ namespace CollisionModel{
                             Core::Particle& ion,
                             double dt) override;
 
+        [[nodiscard]] double dragDampingRate(Core::Particle& ion) const override;
+        [[nodiscard]] Core::Vector dragGasVelocity(Core::Particle& ion) const override;
+
+        [[nodiscard]] bool hasCollisionEvents() const override;
+        [[nodiscard]] double collisionFrequency(Core::Particle& ion) const override;
+        [[nodiscard]] double collisionFrequencyBound(Core::Particle& ion, double speedIncrease) const override;
+        void performCollision(Core::Particle& ion) override;
 
     private:
         std::vector<std::unique_ptr<AbstractCollisionModel>> models_;
@@ -230,9 +230,8 @@ void CollisionModel::StatisticalDiffusionModel::updateModelTimestepParameters(un
 void CollisionModel::StatisticalDiffusionModel::modifyAcceleration(Core::Vector& acceleration, Core::Particle& ion,
                                                                    double dt) {
 
-    Core::Vector gasVelocity = velocityFunction_(ion.getLocation());
-    double ionLocalDamping = ion.getAuxCollisionParams()[index_ionSTPdamping]/
-            ion.getAuxCollisionParams()[index_ptRatio];
+    Core::Vector gasVelocity = dragGasVelocity(ion);
+    double ionLocalDamping = dragDampingRate(ion);
 
     double dampingTimeConstant = ionLocalDamping * dt;
     double dampingFactor = (1 - exp(-dampingTimeConstant)) / dampingTimeConstant;
@@ -245,6 +244,21 @@ void CollisionModel::StatisticalDiffusionModel::modifyAcceleration(Core::Vector&
     acceleration = newAcceleration;
 }
 
+/**
+ * Gets the local damping rate (the inverse velocity relaxation time) of the viscous drag of an ion in the SDS model
+ * @param ion the ion (with initialized SDS model parameters)
+ */
+double CollisionModel::StatisticalDiffusionModel::dragDampingRate(Core::Particle& ion) const {
+    return ion.getAuxCollisionParams()[index_ionSTPdamping] / ion.getAuxCollisionParams()[index_ptRatio];
+}
+
+/**
+ * Gets the local background gas velocity at the position of an ion
+ */
+Core::Vector CollisionModel::StatisticalDiffusionModel::dragGasVelocity(Core::Particle& ion) const {
+    return velocityFunction_(ion.getLocation());
+}
+
 /**
  * The ion velocity is not modified by the SDS model
  */
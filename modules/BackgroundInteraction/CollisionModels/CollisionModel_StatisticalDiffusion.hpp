@@ -85,6 +85,9 @@ namespace CollisionModel {
                     Core::Particle& ion,
                     double dt) override;
 
+            [[nodiscard]] double dragDampingRate(Core::Particle& ion) const override;
+            [[nodiscard]] Core::Vector dragGasVelocity(Core::Particle& ion) const override;
+
         private:
             constexpr double static STP_TEMP = 273.15;        ///< Standard temperature (K)
             constexpr double static STP_PRESSURE = 100000.0;  ///< Standard pressure (Pa)
@@ -44,5 +44,8 @@ namespace Core {
     constexpr double N_AVOGADRO = 6.02214199e23;        ///< Avogadro's number
     constexpr double MOL_VOLUME = 22.413996e-3;         //Volume (m^3) of one mol
                                                     // of ideal gas at 0 C, 101.325 kPa
+
+    constexpr double REDUCED_MOBILITY_REFERENCE_PRESSURE_PA = 100000.0; ///< Reference pressure of reduced mobilities (Pa)
+    constexpr double REDUCED_MOBILITY_REFERENCE_TEMPERATURE_K = 273.15; ///< Reference temperature of reduced mobilities (K)
 }
 #endif /* BTree_constants_h */
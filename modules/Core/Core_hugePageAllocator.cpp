@@ -0,0 +1,244 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Core_hugePageAllocator.hpp"
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#ifdef __linux__
+    #include <sys/mman.h>
+    #include <linux/mman.h>
+#endif
+
+namespace {
+
+    std::array<std::atomic<int>, 3> subsystemModes = {
+            static_cast<int>(Core::HugePageMode::NONE),
+            static_cast<int>(Core::HugePageMode::NONE),
+            static_cast<int>(Core::HugePageMode::NONE)};
+
+    std::array<std::atomic<std::size_t>, 3> allocatedBytes = {0, 0, 0};
+
+    /**
+     * Checks if a buffer is allocated as huge page backed mapping (large buffers with a huge page mode)
+     */
+    bool isMappedBuffer(std::size_t bytes, Core::HugePageMode mode){
+        #ifdef __linux__
+            return mode != Core::HugePageMode::NONE && bytes >= Core::HUGE_PAGE_SIZE;
+        #else
+            (void) bytes;
+            (void) mode;
+            return false;
+        #endif
+    }
+
+    /**
+     * Gets the length of the mapping of a buffer (the buffer size rounded up to whole huge pages)
+     */
+    std::size_t mappingLength(std::size_t bytes){
+        return (bytes + Core::HUGE_PAGE_SIZE - 1) / Core::HUGE_PAGE_SIZE * Core::HUGE_PAGE_SIZE;
+    }
+
+    void countAllocation(Core::HugePageMode backing, std::size_t bytes){
+        allocatedBytes[static_cast<std::size_t>(backing)] += bytes;
+    }
+
+    #ifdef __linux__
+    /**
+     * Maps a huge page aligned anonymous buffer and advises the kernel to back it with transparent huge pages
+     *
+     * @param length length of the mapping (a multiple of the huge page size)
+     * @return the buffer, or nullptr if the mapping failed
+     */
+    void* mapTransparentHugePages(std::size_t length){
+        // over allocate by one huge page and trim the mapping to a huge page aligned region:
+        void* raw = mmap(nullptr, length + Core::HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED){
+            return nullptr;
+        }
+        auto rawAddress = reinterpret_cast<std::uintptr_t>(raw);
+        std::uintptr_t alignedAddress =
+                (rawAddress + Core::HUGE_PAGE_SIZE - 1) / Core::HUGE_PAGE_SIZE * Core::HUGE_PAGE_SIZE;
+        std::size_t head = alignedAddress - rawAddress;
+        std::size_t tail = Core::HUGE_PAGE_SIZE - head;
+        if (head > 0){
+            munmap(raw, head);
+        }
+        if (tail > 0){
+            munmap(reinterpret_cast<void*>(alignedAddress + length), tail);
+        }
+
+        void* buffer = reinterpret_cast<void*>(alignedAddress);
+        if (madvise(buffer, length, MADV_HUGEPAGE) == 0){
+            countAllocation(Core::HugePageMode::TRANSPARENT, length);
+        }
+        else {
+            countAllocation(Core::HugePageMode::NONE, length);
+        }
+        return buffer;
+    }
+
+    /**
+     * Maps a buffer from the explicit huge page pool of the system
+     *
+     * @param length length of the mapping (a multiple of the huge page size)
+     * @return the buffer, or nullptr if no explicit huge pages are available
+     */
+    void* mapExplicitHugePages(std::size_t length){
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+        #ifdef MAP_HUGE_2MB
+            flags |= static_cast<int>(MAP_HUGE_2MB);
+        #endif
+        void* buffer = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (buffer == MAP_FAILED){
+            return nullptr;
+        }
+        countAllocation(Core::HugePageMode::EXPLICIT, length);
+        return buffer;
+    }
+    #endif
+}
+
+/**
+ * Sets the huge page mode of a subsystem, the mode is applied to containers which are constructed afterwards
+ *
+ * @param subsystem the subsystem
+ * @param mode the huge page mode for the large buffers of the subsystem
+ */
+void Core::setHugePageMode(Core::HugePageSubsystem subsystem, Core::HugePageMode mode) {
+    subsystemModes[static_cast<std::size_t>(subsystem)] = static_cast<int>(mode);
+}
+
+/**
+ * Sets the huge page mode of all subsystems
+ */
+void Core::setHugePageMode(Core::HugePageMode mode) {
+    for (auto& subsystemMode: subsystemModes){
+        subsystemMode = static_cast<int>(mode);
+    }
+}
+
+/**
+ * Gets the huge page mode of a subsystem
+ */
+Core::HugePageMode Core::hugePageMode(Core::HugePageSubsystem subsystem) {
+    return static_cast<HugePageMode>(subsystemModes[static_cast<std::size_t>(subsystem)].load());
+}
+
+/**
+ * Parses a huge page mode from its name ("none", "transparent" or "explicit", case insensitive)
+ */
+Core::HugePageMode Core::parseHugePageMode(const std::string& modeName) {
+    std::string name = modeName;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c){return std::tolower(c);});
+    if (name == "none"){
+        return HugePageMode::NONE;
+    }
+    else if (name == "transparent"){
+        return HugePageMode::TRANSPARENT;
+    }
+    else if (name == "explicit"){
+        return HugePageMode::EXPLICIT;
+    }
+    throw (std::invalid_argument("Illegal huge page mode: " + modeName));
+}
+
+/**
+ * Parses a huge page subsystem from its name ("fields", "particles" or "tree", case insensitive)
+ */
+Core::HugePageSubsystem Core::parseHugePageSubsystem(const std::string& subsystemName) {
+    std::string name = subsystemName;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c){return std::tolower(c);});
+    if (name == "fields"){
+        return HugePageSubsystem::FIELD_GRIDS;
+    }
+    else if (name == "particles"){
+        return HugePageSubsystem::PARTICLES;
+    }
+    else if (name == "tree"){
+        return HugePageSubsystem::TREE;
+    }
+    throw (std::invalid_argument("Illegal huge page subsystem: " + subsystemName));
+}
+
+/**
+ * Allocates a buffer. Buffers of at least one huge page size are mapped huge page aligned and backed with huge pages
+ * according to the huge page mode, smaller buffers and buffers with mode NONE are allocated from the regular heap.
+ * Explicit huge pages fall back to transparent huge pages, if the explicit huge page pool is exhausted or not
+ * configured, and transparent huge pages fall back to regular pages, if they are not supported by the system.
+ *
+ * @param bytes size of the buffer
+ * @param mode huge page mode
+ * @return the allocated buffer, which has to be released with deallocateHugePageBuffer with the same size and mode
+ */
+void* Core::allocateHugePageBuffer(std::size_t bytes, Core::HugePageMode mode) {
+    if (!isMappedBuffer(bytes, mode)){
+        return ::operator new(bytes);
+    }
+
+    void* buffer = nullptr;
+    #ifdef __linux__
+        std::size_t length = mappingLength(bytes);
+        if (mode == HugePageMode::EXPLICIT){
+            buffer = mapExplicitHugePages(length);
+        }
+        if (buffer == nullptr){
+            buffer = mapTransparentHugePages(length);
+        }
+    #endif
+    if (buffer == nullptr){
+        throw std::bad_alloc();
+    }
+    return buffer;
+}
+
+/**
+ * Releases a buffer allocated with allocateHugePageBuffer
+ *
+ * @param buffer the buffer
+ * @param bytes size of the buffer (as given at the allocation)
+ * @param mode huge page mode (as given at the allocation)
+ */
+void Core::deallocateHugePageBuffer(void* buffer, std::size_t bytes, Core::HugePageMode mode) {
+    if (buffer == nullptr){
+        return;
+    }
+    if (!isMappedBuffer(bytes, mode)){
+        ::operator delete(buffer);
+        return;
+    }
+    #ifdef __linux__
+        munmap(buffer, mappingLength(bytes));
+    #endif
+}
+
+/**
+ * Gets the total size of the huge page mapped buffers, which were allocated with a backing since the start of the
+ * program (TRANSPARENT: advised for transparent huge pages, EXPLICIT: explicit huge pages, NONE: large buffers which
+ * fell back to regular pages)
+ */
+std::size_t Core::hugePageAllocatedBytes(Core::HugePageMode backing) {
+    return allocatedBytes[static_cast<std::size_t>(backing)].load();
+}
@@ -0,0 +1,141 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Core_hugePageAllocator.hpp
+
+ Allocation of large buffers backed by transparent or explicit huge pages
+
+ ****************************/
+
+#ifndef IDSIMF_CORE_HUGEPAGEALLOCATOR_HPP
+#define IDSIMF_CORE_HUGEPAGEALLOCATOR_HPP
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+
+namespace Core {
+
+    /**
+     * Backing of large buffers with huge pages
+     */
+    enum class HugePageMode {
+        NONE,        ///< regular heap allocation
+        TRANSPARENT, ///< anonymous mapping advised for transparent huge pages (madvise MADV_HUGEPAGE)
+        EXPLICIT     ///< mapping from the explicit huge page pool (MAP_HUGETLB), falls back to transparent huge pages
+    };
+
+    /**
+     * Subsystems with large buffers, the huge page mode is selected individually for every subsystem
+     */
+    enum class HugePageSubsystem {
+        FIELD_GRIDS, ///< data of potential arrays and interpolated fields
+        PARTICLES,   ///< per particle arrays of the integrators
+        TREE         ///< node storage of the space charge tree
+    };
+
+    /**
+     * Size of a huge page (bytes), smaller buffers are always allocated from the regular heap
+     */
+    constexpr std::size_t HUGE_PAGE_SIZE = 2*1024*1024;
+
+    void setHugePageMode(HugePageSubsystem subsystem, HugePageMode mode);
+    void setHugePageMode(HugePageMode mode);
+    [[nodiscard]] HugePageMode hugePageMode(HugePageSubsystem subsystem);
+    [[nodiscard]] HugePageMode parseHugePageMode(const std::string& modeName);
+    [[nodiscard]] HugePageSubsystem parseHugePageSubsystem(const std::string& subsystemName);
+
+    [[nodiscard]] void* allocateHugePageBuffer(std::size_t bytes, HugePageMode mode);
+    void deallocateHugePageBuffer(void* buffer, std::size_t bytes, HugePageMode mode);
+    [[nodiscard]] std::size_t hugePageAllocatedBytes(HugePageMode backing);
+
+    /**
+     * Standard conforming allocator, which backs large allocations with huge pages to reduce TLB misses of
+     * random accesses into large buffers (e.g. field grids or tree node arrays).
+     *
+     * The huge page mode is taken from the setting of the subsystem at the construction of the allocator (thus
+     * typically at the construction of the container) and is kept by the allocator and its copies, which ensures
+     * that buffers are released in the way they were allocated. If huge pages are not available, the buffers are
+     * transparently backed by regular pages.
+     */
+    template<typename T, HugePageSubsystem subsystem> class HugePageAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template<typename U> struct rebind {
+            using other = HugePageAllocator<U, subsystem>;
+        };
+
+        HugePageAllocator():
+        mode_(hugePageMode(subsystem))
+        {}
+
+        explicit HugePageAllocator(HugePageMode mode):
+        mode_(mode)
+        {}
+
+        template<typename U> HugePageAllocator(const HugePageAllocator<U, subsystem>& other) noexcept: // NOLINT
+        mode_(other.mode())
+        {}
+
+        [[nodiscard]] T* allocate(std::size_t n){
+            if (n > std::numeric_limits<std::size_t>::max()/sizeof(T)){
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(allocateHugePageBuffer(n*sizeof(T), mode_));
+        }
+
+        void deallocate(T* buffer, std::size_t n) noexcept {
+            deallocateHugePageBuffer(buffer, n*sizeof(T), mode_);
+        }
+
+        [[nodiscard]] HugePageMode mode() const noexcept {
+            return mode_;
+        }
+
+    private:
+        HugePageMode mode_; ///< huge page mode of the allocations of this allocator
+    };
+
+    template<typename T, typename U, HugePageSubsystem subsystem>
+    bool operator==(const HugePageAllocator<T, subsystem>& lhs, const HugePageAllocator<U, subsystem>& rhs){
+        return lhs.mode() == rhs.mode();
+    }
+
+    template<typename T, typename U, HugePageSubsystem subsystem>
+    bool operator!=(const HugePageAllocator<T, subsystem>& lhs, const HugePageAllocator<U, subsystem>& rhs){
+        return !(lhs == rhs);
+    }
+
+    /**
+     * Vector with huge page backed storage for a subsystem
+     */
+    template<typename T, HugePageSubsystem subsystem>
+    using hugePageVector = std::vector<T, HugePageAllocator<T, subsystem>>;
+}
+
+#endif //IDSIMF_CORE_HUGEPAGEALLOCATOR_HPP
@@ -0,0 +1,173 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Core_memoryAccounting.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <sys/resource.h>
+
+namespace {
+
+    /**
+     * Reads a memory size (in kB) from the status of the process in the Linux proc file system
+     *
+     * @param field name of the status field (e.g. "VmRSS:")
+     * @return the memory size in bytes, zero if the status is not available
+     */
+    std::size_t processStatusMemoryBytes(const std::string& field){
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)){
+            if (line.compare(0, field.size(), field) == 0){
+                std::istringstream value(line.substr(field.size()));
+                std::size_t kiloBytes = 0;
+                value >> kiloBytes;
+                return kiloBytes*1024;
+            }
+        }
+        return 0;
+    }
+}
+
+/**
+ * Adds the memory usage of a subsystem to the report, the sizes of subsystems which are added multiple times
+ * are summed up
+ *
+ * @param subsystem name of the subsystem
+ * @param bytes memory used by the subsystem (bytes)
+ */
+void Core::MemoryReport::add(const std::string& subsystem, std::size_t bytes) {
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+            [&subsystem](const std::pair<std::string, std::size_t>& entry){return entry.first == subsystem;});
+    if (it == entries_.end()){
+        entries_.emplace_back(subsystem, bytes);
+    }
+    else {
+        it->second += bytes;
+    }
+}
+
+/**
+ * Gets the number of subsystems in the report
+ */
+std::size_t Core::MemoryReport::numberOfSubsystems() const {
+    return entries_.size();
+}
+
+/**
+ * Gets the memory usage of a subsystem (zero if the subsystem is not part of the report)
+ */
+std::size_t Core::MemoryReport::bytes(const std::string& subsystem) const {
+    for (const auto& entry: entries_){
+        if (entry.first == subsystem){
+            return entry.second;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Gets the total memory usage of all subsystems in the report
+ */
+std::size_t Core::MemoryReport::totalBytes() const {
+    std::size_t result = 0;
+    for (const auto& entry: entries_){
+        result += entry.second;
+    }
+    return result;
+}
+
+/**
+ * Formats the report as table lines (one line per subsystem with its share of the total and a total line),
+ * e.g. for logging
+ */
+std::vector<std::string> Core::MemoryReport::toLines() const {
+    std::size_t nameWidth = 5;
+    for (const auto& entry: entries_){
+        nameWidth = std::max(nameWidth, entry.first.size());
+    }
+    std::size_t total = totalBytes();
+
+    std::vector<std::string> result;
+    for (const auto& entry: entries_){
+        double share = total > 0 ? 100.0*static_cast<double>(entry.second)/static_cast<double>(total) : 0.0;
+        std::ostringstream line;
+        line << std::left << std::setw(static_cast<int>(nameWidth)) << entry.first << "  "
+             << std::right << std::setw(10) << formatBytes(entry.second) << "  "
+             << std::fixed << std::setprecision(1) << std::setw(5) << share << " %";
+        result.push_back(line.str());
+    }
+    std::ostringstream totalLine;
+    totalLine << std::left << std::setw(static_cast<int>(nameWidth)) << "total" << "  "
+              << std::right << std::setw(10) << formatBytes(total);
+    result.push_back(totalLine.str());
+    return result;
+}
+
+/**
+ * Formats a memory size with a binary unit prefix (e.g. "1.50 MiB")
+ */
+std::string Core::formatBytes(std::size_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    auto value = static_cast<double>(bytes);
+    std::size_t unit = 0;
+    while (value >= 1024.0 && unit < 4){
+        value /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream result;
+    if (unit == 0){
+        result << bytes << " B";
+    }
+    else {
+        result << std::fixed << std::setprecision(2) << value << " " << units[unit];
+    }
+    return result.str();
+}
+
+/**
+ * Gets the current resident memory (the physical memory actually used) of the process, zero if the resident memory
+ * can not be determined on the platform
+ */
+std::size_t Core::currentResidentMemoryBytes() {
+    return processStatusMemoryBytes("VmRSS:");
+}
+
+/**
+ * Gets the peak resident memory (the maximum physical memory used so far) of the process
+ */
+std::size_t Core::peakResidentMemoryBytes() {
+    std::size_t result = processStatusMemoryBytes("VmHWM:");
+    if (result > 0){
+        return result;
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0){
+        return 0;
+    }
+    #ifdef __APPLE__
+        return static_cast<std::size_t>(usage.ru_maxrss);
+    #else
+        return static_cast<std::size_t>(usage.ru_maxrss)*1024;
+    #endif
+}
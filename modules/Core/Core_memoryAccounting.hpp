@@ -0,0 +1,86 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Core_memoryAccounting.hpp
+
+ Accounting of the memory usage of the subsystems of a simulation and of the process
+
+ ****************************/
+
+#ifndef IDSIMF_CORE_MEMORYACCOUNTING_HPP
+#define IDSIMF_CORE_MEMORYACCOUNTING_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+
+namespace Core {
+
+    /**
+     * Per subsystem breakdown of the memory used by a simulation.
+     *
+     * The subsystems (e.g. potential arrays, particles, the space charge tree or trajectory writers) report their
+     * memory usage explicitly (typically with a memoryUsageBytes() or dataSizeBytes() method), the report collects
+     * these sizes and compares them to the memory actually used by the process.
+     */
+    class MemoryReport {
+    public:
+        void add(const std::string& subsystem, std::size_t bytes);
+
+        [[nodiscard]] std::size_t numberOfSubsystems() const;
+        [[nodiscard]] std::size_t bytes(const std::string& subsystem) const;
+        [[nodiscard]] std::size_t totalBytes() const;
+        [[nodiscard]] std::vector<std::string> toLines() const;
+
+    private:
+        std::vector<std::pair<std::string, std::size_t>> entries_; ///< Subsystem names and sizes (in insertion order)
+    };
+
+    [[nodiscard]] std::string formatBytes(std::size_t bytes);
+    [[nodiscard]] std::size_t currentResidentMemoryBytes();
+    [[nodiscard]] std::size_t peakResidentMemoryBytes();
+
+    /**
+     * Estimates the heap memory used by the elements of a vector
+     */
+    template<typename T, typename Alloc> std::size_t vectorMemoryBytes(const std::vector<T, Alloc>& vec){
+        return vec.capacity()*sizeof(T);
+    }
+
+    /**
+     * Estimates the heap memory used by an unordered map with string keys (the bucket array, the nodes of the
+     * elements and heap allocated keys, which are too long for the small string buffer)
+     */
+    template<typename T> std::size_t unorderedMapMemoryBytes(const std::unordered_map<std::string, T>& map){
+        std::size_t result = map.bucket_count()*sizeof(void*);
+        for (const auto& entry: map){
+            result += sizeof(void*) + sizeof(std::size_t) + sizeof(entry);
+            if (entry.first.capacity() > std::string().capacity()){
+                result += entry.first.capacity() + 1;
+            }
+        }
+        return result;
+    }
+}
+
+#endif //IDSIMF_CORE_MEMORYACCOUNTING_HPP
@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Core_particle.hpp"
+#include "Core_memoryAccounting.hpp"
 #include <iostream>
 
 // // FIXME: copy and move functionality 
@@ -514,4 +515,14 @@ void Core::Particle::setMolecularStructure(std::shared_ptr<CollisionModel::Molec
  */
 std::shared_ptr<CollisionModel::MolecularStructure> Core::Particle::getMolecularStructure(){
     return molstrPtr;
-}
\ No newline at end of file
+}
+
+/**
+ * Estimates the memory used by the particle (the particle object and the heap memory of its additional attributes,
+ * a shared molecular structure is not included)
+ */
+std::size_t Core::Particle::memoryUsageBytes() const{
+    return sizeof(Particle) +
+           Core::unorderedMapMemoryBytes(attributesFloat_) +
+           Core::unorderedMapMemoryBytes(attributesInteger_);
+}
@@ -109,6 +109,8 @@ namespace Core {
         void setMolecularStructure(std::shared_ptr<CollisionModel::MolecularStructure> molecularStructurePtr);
         [[nodiscard]] std::shared_ptr<CollisionModel::MolecularStructure> getMolecularStructure();
 
+        [[nodiscard]] std::size_t memoryUsageBytes() const;
+
     private:
         //all internal variable are in SI units
         std::size_t index_ = 0; ///< an external index (mostly the index of the particle in the reaction model)
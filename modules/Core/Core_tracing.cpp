@@ -0,0 +1,179 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Core_tracing.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    /**
+     * Trace event buffer of one thread, the buffers are owned by the global registry and outlive their threads
+     */
+    struct ThreadBuffer {
+        std::size_t threadIndex = 0;
+        std::vector<Core::Tracing::TraceEvent> events;
+    };
+
+    const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+    std::atomic<bool> tracingEnabled(false);
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+    thread_local ThreadBuffer* currentThreadBuffer = nullptr;
+
+    /**
+     * Gets the trace buffer of the current thread, the buffer is registered on first use
+     */
+    ThreadBuffer* threadBuffer(){
+        if (currentThreadBuffer == nullptr){
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->threadIndex = threadBuffers.size();
+            buffer->events.reserve(4096);
+            currentThreadBuffer = buffer.get();
+            threadBuffers.emplace_back(std::move(buffer));
+        }
+        return currentThreadBuffer;
+    }
+
+    /**
+     * Writes a string as JSON string literal
+     */
+    void writeJSONString(std::ostream& out, const char* str){
+        out << '"';
+        for (const char* c = str; *c != '\0'; ++c){
+            if (*c == '"' || *c == '\\'){
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+/**
+ * Enables or disables the recording of trace events at runtime
+ */
+void Core::Tracing::setEnabled(bool enabled) {
+    tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * Returns true if trace events are recorded
+ */
+bool Core::Tracing::isEnabled() {
+    return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets the current time in ns, relative to the start of the program (steady clock)
+ */
+std::int64_t Core::Tracing::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+/**
+ * Records a completed event in the trace buffer of the current thread
+ *
+ * @param name name of the event (a string literal or a string which outlives the trace)
+ * @param category category of the event (a string literal or a string which outlives the trace)
+ * @param startNs start time of the event (see Core::Tracing::now)
+ * @param durationNs duration of the event in ns
+ */
+void Core::Tracing::recordEvent(const char* name, const char* category, std::int64_t startNs,
+                                std::int64_t durationNs) {
+    threadBuffer()->events.push_back({name, category, startNs, durationNs});
+}
+
+/**
+ * Gets the total number of recorded events of all threads (should not be called while events are recorded)
+ */
+std::size_t Core::Tracing::numberOfEvents() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::size_t result = 0;
+    for (const auto& buffer: threadBuffers){
+        result += buffer->events.size();
+    }
+    return result;
+}
+
+/**
+ * Gets the number of threads which have recorded trace events
+ */
+std::size_t Core::Tracing::numberOfThreads() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return threadBuffers.size();
+}
+
+/**
+ * Discards all recorded events (should not be called while events are recorded)
+ */
+void Core::Tracing::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer: threadBuffers){
+        buffer->events.clear();
+    }
+}
+
+/**
+ * Writes the recorded events of all threads as Chrome trace event file (JSON), which can be inspected with
+ * chrome://tracing or the Perfetto UI (https://ui.perfetto.dev). Should not be called while events are recorded.
+ *
+ * @param filename name of the trace file to write
+ */
+void Core::Tracing::writeChromeTrace(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out.good()){
+        throw (std::runtime_error("Trace file " + filename + " could not be opened"));
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer: threadBuffers){
+        if (!first){
+            out << ",\n";
+        }
+        first = false;
+        out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->threadIndex
+            << R"(,"args":{"name":"thread )" << buffer->threadIndex << "\"}}";
+
+        for (const TraceEvent& event: buffer->events){
+            out << ",\n{\"name\":";
+            writeJSONString(out, event.name);
+            out << ",\"cat\":";
+            writeJSONString(out, event.category);
+            // Chrome trace times are in microseconds:
+            out << R"(,"ph":"X","pid":1,"tid":)" << buffer->threadIndex
+                << ",\"ts\":" << static_cast<double>(event.startNs) * 1e-3
+                << ",\"dur\":" << static_cast<double>(event.durationNs) * 1e-3 << "}";
+        }
+    }
+    out << "\n]}\n";
+}
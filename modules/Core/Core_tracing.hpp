@@ -0,0 +1,99 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Core_tracing.hpp
+
+ Low overhead per thread timeline tracing, exported in the Chrome trace event format
+
+ ****************************/
+
+#ifndef IDSIMF_CORE_TRACING_HPP
+#define IDSIMF_CORE_TRACING_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace Core::Tracing {
+
+    /**
+     * A completed (begin / end) trace event of a thread
+     */
+    struct TraceEvent {
+        const char* name;        ///< name of the event (a string literal, which is not copied)
+        const char* category;    ///< category of the event (a string literal, which is not copied)
+        std::int64_t startNs;    ///< start time in ns, relative to the start of the program
+        std::int64_t durationNs; ///< duration in ns
+    };
+
+    void setEnabled(bool enabled);
+    [[nodiscard]] bool isEnabled();
+
+    [[nodiscard]] std::int64_t now();
+    void recordEvent(const char* name, const char* category, std::int64_t startNs, std::int64_t durationNs);
+
+    [[nodiscard]] std::size_t numberOfEvents();
+    [[nodiscard]] std::size_t numberOfThreads();
+    void clear();
+    void writeChromeTrace(const std::string& filename);
+
+    /**
+     * Scope guard, which records a trace event from its construction to its destruction in the trace buffer of the
+     * current thread. Nothing is recorded if tracing is not enabled at the construction of the scope.
+     */
+    class Scope {
+    public:
+        Scope(const char* name, const char* category):
+        name_(name),
+        category_(category),
+        startNs_(isEnabled() ? now() : -1)
+        {}
+
+        ~Scope(){
+            if (startNs_ >= 0){
+                recordEvent(name_, category_, startNs_, now() - startNs_);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        const char* category_;
+        std::int64_t startNs_;
+    };
+}
+
+/**
+ * Traces the enclosing scope as event with a name and a category (string literals). Tracing is compiled in only if
+ * IDSimF is configured with the USE_TRACING option, otherwise the macro expands to nothing.
+ */
+#ifdef WITH_TRACING
+    #define IDSIMF_TRACE_CONCAT_(a, b) a##b
+    #define IDSIMF_TRACE_SCOPE_VAR_(line) IDSIMF_TRACE_CONCAT_(idsimfTraceScope_, line)
+    #define IDSIMF_TRACE_SCOPE(name, category) \
+        Core::Tracing::Scope IDSIMF_TRACE_SCOPE_VAR_(__LINE__)((name), (category))
+#else
+    #define IDSIMF_TRACE_SCOPE(name, category)
+#endif
+
+#endif //IDSIMF_CORE_TRACING_HPP
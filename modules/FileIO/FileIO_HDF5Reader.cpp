@@ -25,6 +25,11 @@ FileIO::HDF5Reader::HDF5Reader(const std::string &hdf5Filename) {
     h5f_ = std::make_unique<H5::H5File>(hdf5Filename.c_str(), H5F_ACC_RDONLY);
 }
 
+bool FileIO::HDF5Reader::hasAttribute(std::string groupName, std::string attributeName) const{
+    H5::Group group (h5f_->openGroup(groupName.c_str()));
+    return group.attrExists(attributeName.c_str());
+}
+
 hsize_t FileIO::HDF5Reader::numberOfObjectsInGroup(std::string groupName) const{
     H5::Group group (h5f_->openGroup(groupName.c_str()));
     return group.getNumObjs();
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <memory>
 #include <iostream>
 #include "H5Cpp.h"
@@ -54,6 +55,7 @@ namespace FileIO{
         template<typename DTYPE>
         [[nodiscard]] std::vector<DTYPE> readAttributeVector(std::string groupName, std::string attributeName) const;
 
+        [[nodiscard]] bool hasAttribute(std::string groupName, std::string attributeName) const;
         [[nodiscard]] hsize_t numberOfObjectsInGroup(std::string groupName) const;
         [[nodiscard]] std::vector<std::string> namesOfObjectsInGroup(std::string groupName) const;
         [[nodiscard]] std::vector<std::string> namesOfDatasetsInGroup(std::string groupName) const;
@@ -0,0 +1,91 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ FileIO_sharedMemoryFrameDefs.hpp
+
+ Memory layout of the shared memory ring buffer for live simulation frames
+
+ ****************************/
+
+#ifndef FileIO_sharedMemoryFrameDefs_hpp
+#define FileIO_sharedMemoryFrameDefs_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace FileIO::SharedMemoryFrames {
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+            "Shared memory frame buffer requires lock free 64 bit atomics");
+
+    constexpr std::uint64_t MAGIC = 0x314D524653444931ULL; ///< identifier of a frame buffer ("1IDSFRM1" in memory)
+    constexpr std::uint32_t LAYOUT_VERSION = 1;   ///< version of the memory layout
+    constexpr std::size_t MAX_FIELDS = 32;        ///< maximum number of per particle fields in a frame
+    constexpr std::size_t FIELD_NAME_LENGTH = 32; ///< length of the (zero terminated) field names
+
+    /**
+     * Header at the beginning of the shared memory segment, which describes the buffer layout
+     */
+    struct BufferHeader {
+        std::uint64_t magic;        ///< buffer identifier (MAGIC)
+        std::uint32_t version;      ///< layout version (LAYOUT_VERSION)
+        std::uint32_t nFields;      ///< number of double values per particle in a frame
+        std::uint64_t nSlots;       ///< number of frame slots in the ring buffer
+        std::uint64_t maxParticles; ///< maximum number of particles in a frame
+        std::uint64_t slotOffset;   ///< offset of the first frame slot (bytes from the start of the segment)
+        std::uint64_t slotStride;   ///< size of a frame slot (bytes)
+        std::atomic<std::uint64_t> framesWritten; ///< number of completely published frames
+        std::atomic<std::uint64_t> writerActive;  ///< 1 while the writer is publishing frames, 0 after it was closed
+        char fieldNames[MAX_FIELDS][FIELD_NAME_LENGTH]; ///< names of the per particle fields
+    };
+
+    /**
+     * Header of a frame slot, followed by the frame data (nParticles x nFields doubles, particle major)
+     *
+     * The slot is protected by a sequence lock: The sequence is odd (2*frameIndex+1) while the writer updates the
+     * slot and even (2*frameIndex+2) if the frame is complete. A reader copies the frame and accepts the copy only
+     * if the sequence was even and unchanged during the copy, thus the writer is never blocked by readers.
+     */
+    struct alignas(64) SlotHeader {
+        std::atomic<std::uint64_t> sequence; ///< sequence lock counter of the slot
+        std::uint64_t frameIndex;            ///< index of the frame in the slot
+        double time;                         ///< simulated time of the frame
+        std::uint64_t nParticles;            ///< number of particles in the frame
+    };
+
+    /**
+     * Gets the size of a frame slot (header and data) in bytes
+     */
+    constexpr std::size_t slotStride(std::size_t maxParticles, std::size_t nFields){
+        std::size_t size = sizeof(SlotHeader) + maxParticles*nFields*sizeof(double);
+        return (size + 63) / 64 * 64;
+    }
+
+    /**
+     * Gets the offset of the first frame slot in the shared memory segment
+     */
+    constexpr std::size_t slotOffset(){
+        return (sizeof(BufferHeader) + 63) / 64 * 64;
+    }
+}
+
+#endif //FileIO_sharedMemoryFrameDefs_hpp
@@ -0,0 +1,159 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "FileIO_sharedMemoryFrameReader.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Gets a value of a particle from the frame data
+ * @param particleIndex index of the particle
+ * @param fieldIndex index of the field (0-2 are the x, y, z positions)
+ */
+double FileIO::SharedMemoryFrame::value(std::size_t particleIndex, std::size_t fieldIndex) const {
+    return data.at(particleIndex*nFields + fieldIndex);
+}
+
+/**
+ * Attaches a reader to an existing shared memory frame buffer
+ * @param shmName name of the shared memory segment
+ */
+FileIO::SharedMemoryFrameReader::SharedMemoryFrameReader(const std::string& shmName) {
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0){
+        throw (std::runtime_error("Shared memory segment "+shmName+" could not be opened: "+std::strerror(errno)));
+    }
+    struct stat segmentStat{};
+    if (fstat(fd, &segmentStat) != 0 ||
+        static_cast<std::size_t>(segmentStat.st_size) < SharedMemoryFrames::slotOffset()){
+        close(fd);
+        throw (std::runtime_error("Shared memory segment "+shmName+" is not a frame buffer"));
+    }
+    segmentSize_ = static_cast<std::size_t>(segmentStat.st_size);
+    void* segment = mmap(nullptr, segmentSize_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED){
+        throw (std::runtime_error("Shared memory segment "+shmName+" could not be mapped: "+std::strerror(errno)));
+    }
+    segment_ = segment;
+    header_ = static_cast<const SharedMemoryFrames::BufferHeader*>(segment_);
+
+    if (header_->magic != SharedMemoryFrames::MAGIC || header_->version != SharedMemoryFrames::LAYOUT_VERSION){
+        munmap(const_cast<void*>(segment_), segmentSize_);
+        throw (std::runtime_error("Shared memory segment "+shmName+" is not a compatible frame buffer"));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+/**
+ * Destructor: Detaches from the shared memory segment
+ */
+FileIO::SharedMemoryFrameReader::~SharedMemoryFrameReader() {
+    munmap(const_cast<void*>(segment_), segmentSize_);
+}
+
+/**
+ * Gets the names of the per particle fields in the frames
+ */
+std::vector<std::string> FileIO::SharedMemoryFrameReader::fieldNames() const {
+    std::vector<std::string> result;
+    for (std::size_t i=0; i<header_->nFields; ++i){
+        result.emplace_back(header_->fieldNames[i],
+                strnlen(header_->fieldNames[i], SharedMemoryFrames::FIELD_NAME_LENGTH));
+    }
+    return result;
+}
+
+/**
+ * Gets the number of frame slots in the ring buffer (the number of recent frames which can be read)
+ */
+std::size_t FileIO::SharedMemoryFrameReader::numberOfSlots() const {
+    return header_->nSlots;
+}
+
+/**
+ * Gets the number of frames published by the writer
+ */
+std::uint64_t FileIO::SharedMemoryFrameReader::framesWritten() const {
+    return header_->framesWritten.load(std::memory_order_acquire);
+}
+
+/**
+ * Checks if the writer is still publishing frames
+ */
+bool FileIO::SharedMemoryFrameReader::isWriterActive() const {
+    return header_->writerActive.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * Reads a frame from the ring buffer
+ *
+ * @param frameIndex the index of the frame to read
+ * @param frame the frame to read to
+ * @return true if the frame was read, false if the frame is not (or not longer) available in the ring buffer
+ */
+bool FileIO::SharedMemoryFrameReader::readFrame(std::uint64_t frameIndex, FileIO::SharedMemoryFrame& frame) const {
+    const auto* slotBase = static_cast<const char*>(segment_) + header_->slotOffset +
+            (frameIndex % header_->nSlots)*header_->slotStride;
+    const auto* slot = reinterpret_cast<const SharedMemoryFrames::SlotHeader*>(slotBase);
+    const auto* data = reinterpret_cast<const double*>(slotBase + sizeof(SharedMemoryFrames::SlotHeader));
+
+    std::uint64_t expectedSequence = 2*frameIndex + 2;
+    if (slot->sequence.load(std::memory_order_acquire) != expectedSequence){
+        return false;
+    }
+
+    frame.frameIndex = slot->frameIndex;
+    frame.time = slot->time;
+    frame.nFields = header_->nFields;
+    frame.nParticles = std::min(static_cast<std::size_t>(slot->nParticles), static_cast<std::size_t>(header_->maxParticles));
+    frame.data.assign(data, data + frame.nParticles*frame.nFields);
+
+    // the frame is valid if the slot was not changed by the writer during the copy:
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->sequence.load(std::memory_order_relaxed) == expectedSequence;
+}
+
+/**
+ * Reads the most recently published frame from the ring buffer
+ *
+ * @param frame the frame to read to
+ * @return true if a frame was read, false if no frame is available
+ */
+bool FileIO::SharedMemoryFrameReader::readLatestFrame(FileIO::SharedMemoryFrame& frame) const {
+    // the latest frame can be overwritten during the copy if the writer is faster than the reader, retry a few times:
+    for (int attempt=0; attempt<16; ++attempt){
+        std::uint64_t nFrames = framesWritten();
+        if (nFrames == 0){
+            return false;
+        }
+        if (readFrame(nFrames-1, frame)){
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ FileIO_sharedMemoryFrameReader.hpp
+
+ Attaches to a shared memory ring buffer of live simulation frames and reads frames from it
+
+ ****************************/
+
+#ifndef FileIO_sharedMemoryFrameReader_hpp
+#define FileIO_sharedMemoryFrameReader_hpp
+
+#include "FileIO_sharedMemoryFrameDefs.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace FileIO {
+
+    /**
+     * A simulation frame read from a shared memory frame buffer
+     */
+    struct SharedMemoryFrame {
+        std::uint64_t frameIndex = 0; ///< index of the frame (number of frames published before this frame)
+        double time = 0.0;            ///< simulated time of the frame
+        std::size_t nParticles = 0;   ///< number of particles in the frame
+        std::size_t nFields = 0;      ///< number of values per particle
+        std::vector<double> data;     ///< frame data (nParticles x nFields values, particle major)
+
+        [[nodiscard]] double value(std::size_t particleIndex, std::size_t fieldIndex) const;
+    };
+
+    /**
+     * Read only consumer of a shared memory frame buffer written by FileIO::SharedMemoryFrameWriter.
+     *
+     * The reader maps the shared memory segment read only and does not influence the writer. Frames are copied
+     * from the ring buffer with a sequence lock check, a frame which was overwritten during the copy is rejected.
+     */
+    class SharedMemoryFrameReader {
+    public:
+        explicit SharedMemoryFrameReader(const std::string& shmName);
+        ~SharedMemoryFrameReader();
+
+        SharedMemoryFrameReader(const SharedMemoryFrameReader&) = delete;
+        SharedMemoryFrameReader& operator=(const SharedMemoryFrameReader&) = delete;
+
+        [[nodiscard]] std::vector<std::string> fieldNames() const;
+        [[nodiscard]] std::size_t numberOfSlots() const;
+        [[nodiscard]] std::uint64_t framesWritten() const;
+        [[nodiscard]] bool isWriterActive() const;
+
+        bool readFrame(std::uint64_t frameIndex, SharedMemoryFrame& frame) const;
+        bool readLatestFrame(SharedMemoryFrame& frame) const;
+
+    private:
+        std::size_t segmentSize_ = 0; ///< size of the mapped segment (bytes)
+        const void* segment_ = nullptr; ///< the mapped shared memory segment
+        const SharedMemoryFrames::BufferHeader* header_ = nullptr; ///< the buffer header
+    };
+}
+
+#endif //FileIO_sharedMemoryFrameReader_hpp
@@ -0,0 +1,218 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "FileIO_sharedMemoryFrameWriter.hpp"
+#include "Core_tracing.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Creates a shared memory frame writer
+ *
+ * @param shmName name of the POSIX shared memory segment (e.g. "/idsimf_run01"), an existing segment with the
+ * same name is replaced
+ * @param maxParticles the maximum number of particles in a frame, particles exceeding this number are not published
+ * @param nSlots the number of frame slots in the ring buffer
+ */
+FileIO::SharedMemoryFrameWriter::SharedMemoryFrameWriter(const std::string& shmName, std::size_t maxParticles,
+                                                         std::size_t nSlots):
+shmName_(shmName),
+maxParticles_(maxParticles),
+nSlots_(nSlots)
+{
+    if (shmName.size() < 2 || shmName[0] != '/' || shmName.find('/', 1) != std::string::npos){
+        throw (std::invalid_argument("Shared memory name has to start with a single slash: "+shmName));
+    }
+    if (maxParticles == 0 || nSlots == 0){
+        throw (std::invalid_argument("Shared memory frame buffer needs particles and frame slots"));
+    }
+
+    createSegment_({});
+}
+
+/**
+ * Destructor: Marks the buffer as closed and removes the shared memory segment
+ */
+FileIO::SharedMemoryFrameWriter::~SharedMemoryFrameWriter() {
+    releaseSegment_();
+}
+
+/**
+ * Sets additional particle attributes which are published with the particle positions. The shared memory segment
+ * is recreated with the size required by the new fields, thus readers should attach after the attributes are set.
+ *
+ * @param attributeNames names of the attributes
+ * @param attributesTransformFct function which transforms a particle into the vector of attribute values
+ */
+void FileIO::SharedMemoryFrameWriter::setParticleAttributes(const std::vector<std::string>& attributeNames,
+                                                            partAttribTransformFctType attributesTransformFct) {
+    if (hasWrittenFrames_){
+        throw (std::logic_error("Particle attributes of a shared memory frame buffer can not be changed after "
+                                "frames were published"));
+    }
+    if (attributeNames.size() + 3 > SharedMemoryFrames::MAX_FIELDS){
+        throw (std::invalid_argument("Too many particle attributes for shared memory frame buffer"));
+    }
+    nAttributes_ = attributeNames.size();
+    particleAttributeTransformFct_ = std::move(attributesTransformFct);
+    releaseSegment_();
+    createSegment_(attributeNames);
+}
+
+/**
+ * Publishes a frame with the current state of the particles into the ring buffer
+ *
+ * @param particles the particles to publish
+ * @param time the simulated time of the frame
+ */
+void FileIO::SharedMemoryFrameWriter::writeTimestep(std::vector<Core::Particle*>& particles, double time) {
+    IDSIMF_TRACE_SCOPE("shared memory frame writer", "file io");
+    hasWrittenFrames_ = true;
+    std::uint64_t frameIndex = header_->framesWritten.load(std::memory_order_relaxed);
+    std::size_t nFields = header_->nFields;
+
+    auto* slotBase = static_cast<char*>(segment_) + header_->slotOffset + (frameIndex % nSlots_)*header_->slotStride;
+    auto* slot = reinterpret_cast<SharedMemoryFrames::SlotHeader*>(slotBase);
+    auto* data = reinterpret_cast<double*>(slotBase + sizeof(SharedMemoryFrames::SlotHeader));
+
+    slot->sequence.store(2*frameIndex + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::size_t nParticles = std::min(particles.size(), maxParticles_);
+    slot->frameIndex = frameIndex;
+    slot->time = time;
+    slot->nParticles = nParticles;
+    for (std::size_t i=0; i<nParticles; ++i){
+        double* particleData = data + i*nFields;
+        const Core::Vector& location = particles[i]->getLocation();
+        particleData[0] = location.x();
+        particleData[1] = location.y();
+        particleData[2] = location.z();
+        if (nAttributes_ > 0){
+            std::vector<double> attributes = particleAttributeTransformFct_(particles[i]);
+            std::copy_n(attributes.begin(), std::min(attributes.size(), nAttributes_), particleData + 3);
+        }
+    }
+
+    slot->sequence.store(2*frameIndex + 2, std::memory_order_release);
+    header_->framesWritten.store(frameIndex + 1, std::memory_order_release);
+}
+
+/**
+ * Gets the name of the shared memory segment
+ */
+std::string FileIO::SharedMemoryFrameWriter::shmName() const {
+    return shmName_;
+}
+
+/**
+ * Gets the number of published frames
+ */
+std::size_t FileIO::SharedMemoryFrameWriter::framesWritten() const {
+    return header_->framesWritten.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets the size of the mapped shared memory segment (the ring buffer)
+ */
+std::size_t FileIO::SharedMemoryFrameWriter::memoryUsageBytes() const {
+    return segmentSize_;
+}
+
+/**
+ * Creates, maps and initializes the shared memory segment, which is sized for the positions and the given additional
+ * particle attributes
+ */
+void FileIO::SharedMemoryFrameWriter::createSegment_(const std::vector<std::string>& attributeNames) {
+    segmentSize_ = SharedMemoryFrames::slotOffset() +
+            nSlots_ * SharedMemoryFrames::slotStride(maxParticles_, attributeNames.size() + 3);
+
+    shm_unlink(shmName_.c_str());
+    int fd = shm_open(shmName_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0){
+        throw (std::runtime_error("Shared memory segment "+shmName_+" could not be created: "+std::strerror(errno)));
+    }
+    if (ftruncate(fd, static_cast<off_t>(segmentSize_)) != 0){
+        close(fd);
+        shm_unlink(shmName_.c_str());
+        throw (std::runtime_error("Shared memory segment "+shmName_+" could not be sized: "+std::strerror(errno)));
+    }
+    segment_ = mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment_ == MAP_FAILED){
+        segment_ = nullptr;
+        shm_unlink(shmName_.c_str());
+        throw (std::runtime_error("Shared memory segment "+shmName_+" could not be mapped: "+std::strerror(errno)));
+    }
+
+    header_ = new (segment_) SharedMemoryFrames::BufferHeader();
+    header_->nSlots = nSlots_;
+    header_->maxParticles = maxParticles_;
+    header_->slotOffset = SharedMemoryFrames::slotOffset();
+    header_->framesWritten.store(0);
+    header_->writerActive.store(1);
+    setFieldNames_(attributeNames);
+    header_->version = SharedMemoryFrames::LAYOUT_VERSION;
+
+    // the magic is written last, readers reject the segment before it is initialized:
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = SharedMemoryFrames::MAGIC;
+}
+
+/**
+ * Marks the buffer as closed, unmaps and removes the shared memory segment
+ */
+void FileIO::SharedMemoryFrameWriter::releaseSegment_() {
+    if (segment_ != nullptr){
+        header_->writerActive.store(0, std::memory_order_release);
+        munmap(segment_, segmentSize_);
+        shm_unlink(shmName_.c_str());
+        segment_ = nullptr;
+        header_ = nullptr;
+    }
+}
+
+/**
+ * Sets the field names (positions and additional attributes) and the slot layout in the buffer header
+ */
+void FileIO::SharedMemoryFrameWriter::setFieldNames_(const std::vector<std::string>& attributeNames) {
+    std::vector<std::string> fieldNames = {"x", "y", "z"};
+    fieldNames.insert(fieldNames.end(), attributeNames.begin(), attributeNames.end());
+
+    header_->nFields = static_cast<std::uint32_t>(fieldNames.size());
+    header_->slotStride = SharedMemoryFrames::slotStride(maxParticles_, fieldNames.size());
+    std::memset(header_->fieldNames, 0, sizeof(header_->fieldNames));
+    for (std::size_t i=0; i<fieldNames.size(); ++i){
+        std::strncpy(header_->fieldNames[i], fieldNames[i].c_str(), SharedMemoryFrames::FIELD_NAME_LENGTH-1);
+    }
+
+    auto* slots = static_cast<char*>(segment_) + header_->slotOffset;
+    for (std::size_t i=0; i<nSlots_; ++i){
+        new (slots + i*header_->slotStride) SharedMemoryFrames::SlotHeader{{0}, 0, 0.0, 0};
+    }
+}
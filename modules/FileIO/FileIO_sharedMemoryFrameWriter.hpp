@@ -0,0 +1,87 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ FileIO_sharedMemoryFrameWriter.hpp
+
+ Publishes simulation frames into a shared memory ring buffer for live monitoring of running simulations
+
+ ****************************/
+
+#ifndef FileIO_sharedMemoryFrameWriter_hpp
+#define FileIO_sharedMemoryFrameWriter_hpp
+
+#include "Core_particle.hpp"
+#include "FileIO_trajectoryWriterDefs.hpp"
+#include "FileIO_sharedMemoryFrameDefs.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace FileIO {
+
+    /**
+     * Output sink which publishes simulation frames (the particle positions and optional particle attributes)
+     * into a lock free ring buffer in a POSIX shared memory segment.
+     *
+     * External processes on the same host (viewers, analysis scripts) can attach to the shared memory segment by
+     * its name, read the most recent frames and detach at any time (see FileIO::SharedMemoryFrameReader). The
+     * writer never waits for readers: Frames are written into the slots of the ring buffer in turn, slow readers
+     * miss frames which were overwritten. The memory layout is defined in FileIO_sharedMemoryFrameDefs.hpp.
+     *
+     * The shared memory segment is sized for the published fields. It is recreated when particle attributes are set,
+     * thus readers should attach after the attributes are set. The segment is removed when the writer is destroyed,
+     * attached readers keep their mapping.
+     */
+    class SharedMemoryFrameWriter {
+    public:
+        SharedMemoryFrameWriter(const std::string& shmName, std::size_t maxParticles, std::size_t nSlots = 8);
+        ~SharedMemoryFrameWriter();
+
+        SharedMemoryFrameWriter(const SharedMemoryFrameWriter&) = delete;
+        SharedMemoryFrameWriter& operator=(const SharedMemoryFrameWriter&) = delete;
+
+        void setParticleAttributes(const std::vector<std::string>& attributeNames,
+                                   partAttribTransformFctType attributesTransformFct);
+
+        void writeTimestep(std::vector<Core::Particle*>& particles, double time);
+
+        [[nodiscard]] std::string shmName() const;
+        [[nodiscard]] std::size_t framesWritten() const;
+        [[nodiscard]] std::size_t memoryUsageBytes() const;
+
+    private:
+        void createSegment_(const std::vector<std::string>& attributeNames);
+        void releaseSegment_();
+        void setFieldNames_(const std::vector<std::string>& fieldNames);
+
+        std::string shmName_;         ///< name of the shared memory segment
+        std::size_t maxParticles_;    ///< maximum number of particles in a frame
+        std::size_t nSlots_;          ///< number of frame slots in the ring buffer
+        std::size_t nAttributes_ = 0; ///< number of additional particle attributes
+        std::size_t segmentSize_ = 0; ///< size of the shared memory segment (bytes)
+        bool hasWrittenFrames_ = false; ///< true if frames were published (the fields are fixed afterwards)
+        void* segment_ = nullptr;     ///< the mapped shared memory segment
+        SharedMemoryFrames::BufferHeader* header_ = nullptr; ///< the buffer header in the shared memory segment
+        partAttribTransformFctType particleAttributeTransformFct_; ///< transforms particles to additional attributes
+    };
+}
+
+#endif //FileIO_sharedMemoryFrameWriter_hpp
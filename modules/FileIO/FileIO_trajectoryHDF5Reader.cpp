@@ -0,0 +1,196 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "FileIO_trajectoryHDF5Reader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * Opens a trajectory HDF5 file for reading
+ * @param hdf5Filename A filename / path of a trajectory HDF5 file
+ */
+FileIO::TrajectoryHDF5Reader::TrajectoryHDF5Reader(const std::string &hdf5Filename):
+reader_(hdf5Filename)
+{
+    if (reader_.hasAttribute("/particle_trajectory", "quantization position step")){
+        positionQuantizationStep_ =
+                reader_.readAttributeVector<double>("/particle_trajectory", "quantization position step").at(0);
+        attributeQuantizationStep_ =
+                reader_.readAttributeVector<double>("/particle_trajectory", "quantization attribute step").at(0);
+    }
+}
+
+/**
+ * Gets the number of time steps in the trajectory
+ */
+hsize_t FileIO::TrajectoryHDF5Reader::numberOfTimesteps() const {
+    return reader_.readDataset<1>("/particle_trajectory/times").dims[0];
+}
+
+/**
+ * Gets the simulated times of the time steps in the trajectory
+ */
+std::vector<double> FileIO::TrajectoryHDF5Reader::times() const {
+    return reader_.readDataset<1>("/particle_trajectory/times").data;
+}
+
+/**
+ * Returns true if the particle positions in the trajectory are stored quantized
+ */
+bool FileIO::TrajectoryHDF5Reader::isQuantized() const {
+    return positionQuantizationStep_ > 0.0;
+}
+
+/**
+ * Gets the quantization step of the positions (two times the error bound, zero if the positions are not quantized)
+ */
+double FileIO::TrajectoryHDF5Reader::positionQuantizationStep() const {
+    return positionQuantizationStep_;
+}
+
+/**
+ * Gets the quantization step of the float particle attributes (two times the error bound, zero if the attributes
+ * are not quantized)
+ */
+double FileIO::TrajectoryHDF5Reader::attributeQuantizationStep() const {
+    return attributeQuantizationStep_;
+}
+
+/**
+ * Reads the particle positions of a time step
+ * @param timestep index of the time step
+ * @return the positions (one row with x,y,z per particle)
+ */
+FileIO::TrajectoryHDF5Reader::DataField2D FileIO::TrajectoryHDF5Reader::positions(hsize_t timestep) {
+    if (isQuantized()){
+        return decodeQuantized_(timestep, "positions_quantized", 3, positionQuantizationStep_);
+    }
+    return readTimestepDataset_(timestep, "positions", 3);
+}
+
+/**
+ * Reads the float particle attributes of a time step
+ * @param timestep index of the time step
+ * @return the attributes (one row per particle, in the order of the "attributes names" of the trajectory)
+ */
+FileIO::TrajectoryHDF5Reader::DataField2D FileIO::TrajectoryHDF5Reader::particleAttributesFloat(hsize_t timestep) {
+    hsize_t nAttributes = reader_.readAttributeVector<std::string>("/particle_trajectory", "attributes names").size();
+    if (attributeQuantizationStep_ > 0.0){
+        return decodeQuantized_(timestep, "particle_attributes_float_quantized", nAttributes,
+                                attributeQuantizationStep_);
+    }
+    return readTimestepDataset_(timestep, "particle_attributes_float", nAttributes);
+}
+
+std::string FileIO::TrajectoryHDF5Reader::timestepGroupName_(hsize_t timestep) const {
+    return "/particle_trajectory/timesteps/" + std::to_string(timestep);
+}
+
+bool FileIO::TrajectoryHDF5Reader::hasDataset_(hsize_t timestep, const std::string& dsName) const {
+    std::vector<std::string> dsNames = reader_.namesOfDatasetsInGroup(timestepGroupName_(timestep));
+    return std::find(dsNames.begin(), dsNames.end(), dsName) != dsNames.end();
+}
+
+bool FileIO::TrajectoryHDF5Reader::isKeyFrame_(hsize_t timestep) const {
+    return reader_.readAttributeVector<int>(timestepGroupName_(timestep), "key frame").at(0) != 0;
+}
+
+/**
+ * Reads a two dimensional dataset of a time step, time steps without particles have no datasets and result in an
+ * empty data field
+ */
+FileIO::TrajectoryHDF5Reader::DataField2D FileIO::TrajectoryHDF5Reader::readTimestepDataset_(
+        hsize_t timestep, const std::string& dsName, hsize_t nColumns) const {
+
+    if (timestep >= numberOfTimesteps()){
+        throw (std::invalid_argument("Time step index " + std::to_string(timestep) + " is out of range"));
+    }
+    if (!hasDataset_(timestep, dsName)){
+        DataField2D empty;
+        empty.rank = 2;
+        empty.dims = {0, nColumns};
+        return empty;
+    }
+    return reader_.readDataset<2>(timestepGroupName_(timestep) + "/" + dsName);
+}
+
+/**
+ * Decodes a quantized, delta encoded dataset of a time step
+ *
+ * @param timestep index of the time step
+ * @param dsName name of the quantized dataset
+ * @param nColumns number of columns of the dataset
+ * @param step the quantization step of the dataset
+ * @return the decoded values
+ */
+FileIO::TrajectoryHDF5Reader::DataField2D FileIO::TrajectoryHDF5Reader::decodeQuantized_(
+        hsize_t timestep, const std::string& dsName, hsize_t nColumns, double step) {
+
+    DecodedFrame& frame = decodedFrames_[dsName];
+
+    // search backwards for the cached time step or the last key frame (time steps without particles have no
+    // dataset and are also starting points of the decoding):
+    hsize_t startTimestep = timestep;
+    bool startAtCache = false;
+    while (true){
+        if (frame.isValid && frame.timestep == startTimestep){
+            startAtCache = true;
+            break;
+        }
+        if (!hasDataset_(startTimestep, dsName) || isKeyFrame_(startTimestep)){
+            break;
+        }
+        if (startTimestep == 0){
+            throw (std::runtime_error("Quantized trajectory dataset " + dsName + " has no key frame"));
+        }
+        --startTimestep;
+    }
+
+    if (!startAtCache){
+        DataField2D field = readTimestepDataset_(startTimestep, dsName, nColumns);
+        frame.values.resize(field.data.size());
+        for (std::size_t i=0; i<field.data.size(); ++i){
+            frame.values[i] = std::llround(field.data[i]);
+        }
+    }
+
+    for (hsize_t ts=startTimestep+1; ts<=timestep; ++ts){
+        DataField2D field = readTimestepDataset_(ts, dsName, nColumns);
+        if (frame.values.size() != field.data.size()){
+            throw (std::runtime_error("Corrupt delta encoding in quantized trajectory dataset " + dsName));
+        }
+        for (std::size_t i=0; i<field.data.size(); ++i){
+            frame.values[i] += std::llround(field.data[i]);
+        }
+    }
+    frame.timestep = timestep;
+    frame.isValid = true;
+
+    DataField2D result;
+    result.rank = 2;
+    result.dims = {frame.values.size() / nColumns, nColumns};
+    result.data.resize(frame.values.size());
+    for (std::size_t i=0; i<frame.values.size(); ++i){
+        result.data[i] = static_cast<double>(frame.values[i]) * step;
+    }
+    return result;
+}
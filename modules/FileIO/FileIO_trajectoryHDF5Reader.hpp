@@ -0,0 +1,87 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ FileIO_trajectoryHDF5Reader.hpp
+
+ Reader for trajectory HDF5 files, which decodes quantized (lossy compressed) trajectories transparently
+
+ ****************************/
+
+#ifndef IDSIMF_FILEIO_TRAJECTORYHDF5READER_HPP
+#define IDSIMF_FILEIO_TRAJECTORYHDF5READER_HPP
+
+#include "FileIO_HDF5Reader.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+namespace FileIO{
+
+    /**
+     * Reads the particle data of the time steps of trajectory HDF5 files written by FileIO::TrajectoryHDF5Writer.
+     *
+     * Quantized, delta encoded trajectories (see TrajectoryHDF5Writer::setQuantization) are decoded transparently:
+     * A time step is reconstructed by accumulating the differences from the last key frame. The last decoded time
+     * step is cached, thus reading the time steps in ascending order decodes every frame only once.
+     */
+    class TrajectoryHDF5Reader {
+
+    public:
+        using DataField2D = HDF5Reader::DataField<2, double>;
+
+        explicit TrajectoryHDF5Reader(const std::string &hdf5Filename);
+
+        [[nodiscard]] hsize_t numberOfTimesteps() const;
+        [[nodiscard]] std::vector<double> times() const;
+        [[nodiscard]] bool isQuantized() const;
+        [[nodiscard]] double positionQuantizationStep() const;
+        [[nodiscard]] double attributeQuantizationStep() const;
+
+        [[nodiscard]] DataField2D positions(hsize_t timestep);
+        [[nodiscard]] DataField2D particleAttributesFloat(hsize_t timestep);
+
+    private:
+        /**
+         * Decoder state of a quantized dataset: the last decoded time step
+         */
+        struct DecodedFrame{
+            hsize_t timestep = 0;
+            bool isValid = false;
+            std::vector<std::int64_t> values;
+        };
+
+        HDF5Reader reader_;
+        double positionQuantizationStep_ = 0.0;  ///< quantization step of the positions (0: not quantized)
+        double attributeQuantizationStep_ = 0.0; ///< quantization step of the float attributes (0: not quantized)
+        std::map<std::string, DecodedFrame> decodedFrames_; ///< decoder states of the quantized datasets
+
+        [[nodiscard]] std::string timestepGroupName_(hsize_t timestep) const;
+        [[nodiscard]] bool hasDataset_(hsize_t timestep, const std::string& dsName) const;
+        [[nodiscard]] bool isKeyFrame_(hsize_t timestep) const;
+        [[nodiscard]] DataField2D readTimestepDataset_(hsize_t timestep, const std::string& dsName,
+                                                       hsize_t nColumns) const;
+        [[nodiscard]] DataField2D decodeQuantized_(hsize_t timestep, const std::string& dsName, hsize_t nColumns,
+                                                   double step);
+    };
+}
+
+#endif //IDSIMF_FILEIO_TRAJECTORYHDF5READER_HPP
@@ -21,10 +21,46 @@
 
 #include "FileIO_trajectoryHDF5Writer.hpp"
 #include "PSim_particleStartSplatTracker.hpp"
+#include "Core_tracing.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <string>
 
+namespace {
+
+    /**
+     * Quantizes values to integer multiples of a quantization step (non finite values are mapped to zero)
+     */
+    std::vector<std::int64_t> quantize(const std::vector<double>& values, double step){
+        constexpr double maxQuantized = 4.0e18;
+        std::vector<std::int64_t> result(values.size());
+        for (std::size_t i=0; i<values.size(); ++i){
+            double scaled = values[i] / step;
+            if (!std::isfinite(scaled)){
+                scaled = 0.0;
+            }
+            result[i] = std::llround(std::clamp(scaled, -maxQuantized, maxQuantized));
+        }
+        return result;
+    }
+
+    /**
+     * Checks if the differences between two quantized frames of equal size are representable as 32 bit integers
+     */
+    bool deltasFitInt32(const std::vector<std::int64_t>& current, const std::vector<std::int64_t>& last){
+        for (std::size_t i=0; i<current.size(); ++i){
+            std::int64_t delta = current[i] - last[i];
+            if (delta > std::numeric_limits<std::int32_t>::max() || delta < std::numeric_limits<std::int32_t>::min()){
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 /**
  * Constructs a new HDF5 trajectory filewriter
  * @param hdf5Filename A filename / path of a HDF5 file to write
@@ -86,6 +122,62 @@ void FileIO::TrajectoryHDF5Writer::setParticleAttributes(const std::vector<std::
     writeTrajectoryAttribute("integer attributes names",attributeNames);
 }
 
+/**
+ * Activates the error bounded, lossy compressed storage of the trajectory:
+ *
+ * The particle positions (and optionally the float particle attributes) are quantized to integer multiples of a
+ * quantization step of two times the specified absolute error bound, thus the decoded values deviate at most by the
+ * error bound from the simulated values. The quantized frames are stored as differences (deltas) to the previous
+ * time step as 32 bit integers in the datasets "positions_quantized" / "particle_attributes_float_quantized" (with
+ * shuffle filter and compression). Periodically, and if the number of particles changes or a difference exceeds the
+ * 32 bit range, a key frame with the absolute quantized values is written, which marks a starting point for the
+ * decoding. Trajectories with quantized storage are decoded transparently by FileIO::TrajectoryHDF5Reader.
+ *
+ * The quantization has to be set before the first time step is written.
+ *
+ * @param positionError absolute error bound of the stored positions (in the units of the simulation, usually m)
+ * @param attributeError absolute error bound of the float particle attributes, the attributes are stored
+ * unquantized if the error bound is not positive
+ * @param keyFrameInterval maximum interval (in written time steps) between two key frames
+ */
+void FileIO::TrajectoryHDF5Writer::setQuantization(double positionError, double attributeError,
+                                                   hsize_t keyFrameInterval) {
+    if (sizeTimesteps_[0] > 0){
+        throw (std::logic_error("Trajectory quantization has to be set before the first time step is written"));
+    }
+    if (quantization_){
+        throw (std::logic_error("Trajectory quantization is already set"));
+    }
+    if (!(positionError > 0.0) || keyFrameInterval == 0){
+        throw (std::invalid_argument("Illegal position error bound or key frame interval for trajectory quantization"));
+    }
+    quantization_ = true;
+    positionQuantizationStep_ = 2.0 * positionError;
+    attributeQuantizationStep_ = attributeError > 0.0 ? 2.0 * attributeError : 0.0;
+    keyFrameInterval_ = keyFrameInterval;
+
+    writeAttribute_(baseGroup_, "quantization position step", positionQuantizationStep_);
+    writeAttribute_(baseGroup_, "quantization attribute step", attributeQuantizationStep_);
+    writeAttribute_(baseGroup_, "quantization key frame interval", keyFrameInterval_);
+}
+
+/**
+ * Estimates the peak memory used by the writer while a time step is written: The persistent state of the
+ * quantized delta encoding and the transient buffers of a time step (the HDF5 library chunk caches are not included)
+ *
+ * @param nParticles number of particles in a time step
+ */
+std::size_t FileIO::TrajectoryHDF5Writer::memoryUsageBytes(std::size_t nParticles) const {
+    std::size_t nValues = nParticles*(3 + nPAttributes_);
+    std::size_t result = sizeof(TrajectoryHDF5Writer);
+    result += nValues*sizeof(double) + nParticles*nPAttributesInteger_*sizeof(int);
+    if (quantization_){
+        // last and current quantized values and the delta frame:
+        result += nValues*(2*sizeof(std::int64_t) + sizeof(std::int32_t));
+    }
+    return result;
+}
+
 /**
  * Writes a single time step to the HDF5 trajectory file
  *
@@ -96,6 +188,7 @@ void FileIO::TrajectoryHDF5Writer::setParticleAttributes(const std::vector<std::
  */
 void FileIO::TrajectoryHDF5Writer::writeTimestep(std::vector<Core::Particle*> &particles,
                                                              double time){
+    IDSIMF_TRACE_SCOPE("trajectory HDF5 writer", "file io");
 
     // Write time of this time step to the times vector:
     sizeTimesteps_[0] += 1;
@@ -115,40 +208,6 @@ void FileIO::TrajectoryHDF5Writer::writeTimestep(std::vector<Core::Particle*> &p
     writeAttribute_(timeStepGroup_, "number of particles", nParticles);
 
     if (nParticles > 0) {
-        //write particle location data:
-
-        //define chunk size in parameter direction:
-        hsize_t nParticlesChunk = 256;
-        if (nParticlesChunk>nParticles) {
-            nParticlesChunk = nParticles;
-        }
-
-        //prepare location dataset structures:
-        hsize_t dimsLocation[2] = {nParticles, 3};            // dataset dimensions at creation
-        hsize_t maxdimsLocation[2] = {nParticles, 3};         // maximum dataset dimensions
-        hsize_t chunkDimsLocation[2] = {nParticlesChunk, 3};
-        H5::DataSpace dataspaceLocation(2, dimsLocation, maxdimsLocation);
-
-        // Modify dataset creation properties to enable chunking and optional compression:
-        H5::DSetCreatPropList propLocation;
-        propLocation.setChunk(2, chunkDimsLocation);
-
-        if (compression_) {
-            propLocation.setDeflate(6);
-        }
-
-        // Create dataset for the location data:
-        std::unique_ptr<H5::DataSet> dsetPPositions = std::make_unique<H5::DataSet>(
-                timeStepGroup_->createDataSet("positions",
-                        H5::PredType::IEEE_F32BE, dataspaceLocation,
-                        propLocation));
-
-        //prepare dataset:
-        H5::DataSpace dSpaceLocation = dsetPPositions->getSpace();
-        hsize_t slabDimsLocation[2] = {nParticles, 3};
-        hsize_t offsetLocation[2] = {0, 0};
-        dSpaceLocation.selectHyperslab(H5S_SELECT_SET, slabDimsLocation, offsetLocation);
-
         //create location data buffer:
         std::vector<double> bufLocation(nParticles*3);
         for (hsize_t i = 0; i<nParticles; ++i) {
@@ -158,17 +217,61 @@ void FileIO::TrajectoryHDF5Writer::writeTimestep(std::vector<Core::Particle*> &p
             bufLocation[i*3+2] = loc.z();
         }
 
-        //write to the dataset:
-        H5::DataSpace memspaceLocation(2, slabDimsLocation);
-        dsetPPositions->write(bufLocation.data(), H5::PredType::NATIVE_DOUBLE, memspaceLocation, dSpaceLocation);
-
-        if (hasParticleAttributes_) {
-            writeTimestepParticleAttributes_(particles);
+        if (quantization_) {
+            writeQuantizedTimestep_(bufLocation, particles);
+        }
+        else {
+            //write particle location data:
+
+            //define chunk size in parameter direction:
+            hsize_t nParticlesChunk = 256;
+            if (nParticlesChunk>nParticles) {
+                nParticlesChunk = nParticles;
+            }
+
+            //prepare location dataset structures:
+            hsize_t dimsLocation[2] = {nParticles, 3};            // dataset dimensions at creation
+            hsize_t maxdimsLocation[2] = {nParticles, 3};         // maximum dataset dimensions
+            hsize_t chunkDimsLocation[2] = {nParticlesChunk, 3};
+            H5::DataSpace dataspaceLocation(2, dimsLocation, maxdimsLocation);
+
+            // Modify dataset creation properties to enable chunking and optional compression:
+            H5::DSetCreatPropList propLocation;
+            propLocation.setChunk(2, chunkDimsLocation);
+
+            if (compression_) {
+                propLocation.setDeflate(6);
+            }
+
+            // Create dataset for the location data:
+            std::unique_ptr<H5::DataSet> dsetPPositions = std::make_unique<H5::DataSet>(
+                    timeStepGroup_->createDataSet("positions",
+                            H5::PredType::IEEE_F32BE, dataspaceLocation,
+                            propLocation));
+
+            //prepare dataset:
+            H5::DataSpace dSpaceLocation = dsetPPositions->getSpace();
+            hsize_t slabDimsLocation[2] = {nParticles, 3};
+            hsize_t offsetLocation[2] = {0, 0};
+            dSpaceLocation.selectHyperslab(H5S_SELECT_SET, slabDimsLocation, offsetLocation);
+
+            //write to the dataset:
+            H5::DataSpace memspaceLocation(2, slabDimsLocation);
+            dsetPPositions->write(bufLocation.data(), H5::PredType::NATIVE_DOUBLE, memspaceLocation, dSpaceLocation);
+
+            if (hasParticleAttributes_) {
+                writeTimestepParticleAttributes_(particles);
+            }
         }
         if (hasParticleAttributesInteger_) {
             writeTimestepParticleAttributesInteger_(particles);
         }
     }
+    else {
+        // the next non empty time step has to be a key frame:
+        lastPositionsQuantized_.clear();
+        lastAttributesQuantized_.clear();
+    }
     offsetScalarLike_[0] +=1;
 }
 
@@ -412,6 +515,20 @@ void FileIO::TrajectoryHDF5Writer::writeTimestepParticleAttributes_(std::vector<
     dSpaceAttrib.selectHyperslab(H5S_SELECT_SET, slabDimsLocation, offsetLocation);
 
     //create and fill aux data buffer:
+    std::vector<double> bufAux = particleAttributesBuffer_(particles);
+
+    //write to the dataset:
+    H5::DataSpace memspaceAux(2,slabDimsLocation);
+    dset->write(bufAux.data(),H5::PredType::NATIVE_DOUBLE,memspaceAux,dSpaceAttrib);
+}
+
+/**
+ * Evaluates the float particle attributes of a particle ensemble
+ * @param particles The simulated particle ensemble
+ * @return the attributes of the particles (row major, one row per particle)
+ */
+std::vector<double> FileIO::TrajectoryHDF5Writer::particleAttributesBuffer_(std::vector<Core::Particle*> &particles){
+    hsize_t nParticles = particles.size();
     std::vector<double> bufAux(nParticles*nPAttributes_);
     for (hsize_t i=0; i<nParticles; ++i){
         std::vector<double> auxDat = particleAttributeTransformFct_(particles[i]);
@@ -419,10 +536,94 @@ void FileIO::TrajectoryHDF5Writer::writeTimestepParticleAttributes_(std::vector<
             bufAux[i*nPAttributes_+j] = auxDat[j];
         }
     }
+    return bufAux;
+}
 
-    //write to the dataset:
-    H5::DataSpace memspaceAux(2,slabDimsLocation);
-    dset->write(bufAux.data(),H5::PredType::NATIVE_DOUBLE,memspaceAux,dSpaceAttrib);
+/**
+ * Writes the positions and the float particle attributes of a time step quantized and delta encoded
+ * @param bufLocation The particle positions (row major, one row per particle)
+ * @param particles The simulated particle ensemble
+ */
+void FileIO::TrajectoryHDF5Writer::writeQuantizedTimestep_(const std::vector<double>& bufLocation,
+                                                           std::vector<Core::Particle*> &particles){
+
+    bool quantizedAttributes = hasParticleAttributes_ && attributeQuantizationStep_ > 0.0;
+    std::vector<std::int64_t> positionsQuantized = quantize(bufLocation, positionQuantizationStep_);
+    std::vector<std::int64_t> attributesQuantized;
+    if (quantizedAttributes){
+        attributesQuantized = quantize(particleAttributesBuffer_(particles), attributeQuantizationStep_);
+    }
+
+    bool keyFrame = framesSinceKeyFrame_ >= keyFrameInterval_ - 1 ||
+            positionsQuantized.size() != lastPositionsQuantized_.size() ||
+            attributesQuantized.size() != lastAttributesQuantized_.size() ||
+            !deltasFitInt32(positionsQuantized, lastPositionsQuantized_) ||
+            !deltasFitInt32(attributesQuantized, lastAttributesQuantized_);
+    if (keyFrame){
+        framesSinceKeyFrame_ = 0;
+    }
+    else {
+        ++framesSinceKeyFrame_;
+    }
+    writeAttribute_(timeStepGroup_, "key frame", keyFrame ? 1 : 0);
+
+    writeQuantizedDataset_("positions_quantized", positionsQuantized, lastPositionsQuantized_, 3, keyFrame);
+    lastPositionsQuantized_ = std::move(positionsQuantized);
+
+    if (quantizedAttributes){
+        writeQuantizedDataset_("particle_attributes_float_quantized", attributesQuantized, lastAttributesQuantized_,
+                               nPAttributes_, keyFrame);
+        lastAttributesQuantized_ = std::move(attributesQuantized);
+    }
+    else if (hasParticleAttributes_){
+        writeTimestepParticleAttributes_(particles);
+    }
+}
+
+/**
+ * Writes a quantized dataset of the current time step, key frames are written with the absolute quantized values as
+ * 64 bit integers, other frames as differences to the last time step as 32 bit integers
+ *
+ * @param dsName Name of the dataset
+ * @param values The quantized values (row major)
+ * @param last The quantized values of the last time step
+ * @param nColumns Number of columns of the dataset
+ * @param keyFrame If true: the dataset is written as key frame
+ */
+void FileIO::TrajectoryHDF5Writer::writeQuantizedDataset_(const std::string& dsName,
+                                                          const std::vector<std::int64_t>& values,
+                                                          const std::vector<std::int64_t>& last,
+                                                          hsize_t nColumns, bool keyFrame){
+    hsize_t nRows = values.size() / nColumns;
+
+    //define chunk size in parameter direction:
+    hsize_t nRowsChunk = 4096;
+    if (nRowsChunk > nRows) {
+        nRowsChunk = nRows;
+    }
+
+    hsize_t dims[2] = {nRows, nColumns};
+    hsize_t chunkDims[2] = {nRowsChunk, nColumns};
+    H5::DataSpace dataspace(2, dims);
+
+    // the shuffle filter groups the bytes of the integers, which improves the compression of small values:
+    H5::DSetCreatPropList props;
+    props.setChunk(2, chunkDims);
+    if (compression_) {
+        props.setShuffle();
+        props.setDeflate(6);
+    }
+
+    std::vector<std::int64_t> buf(values);
+    if (!keyFrame){
+        for (std::size_t i=0; i<buf.size(); ++i){
+            buf[i] -= last[i];
+        }
+    }
+
+    const H5::PredType& fileType = keyFrame ? H5::PredType::STD_I64LE : H5::PredType::STD_I32LE;
+    H5::DataSet dset = timeStepGroup_->createDataSet(dsName.c_str(), fileType, dataspace, props);
+    dset.write(buf.data(), H5::PredType::NATIVE_INT64, dataspace, dataspace);
 }
 
 /**
@@ -494,6 +695,26 @@ void FileIO::TrajectoryHDF5Writer::writeAttribute_(std::unique_ptr<H5::Group>& g
     attribute.write( H5::PredType::NATIVE_INT, attr_data);
 }
 
+/**
+ * Writes a double precision attribute to a HDF5 group
+ * @param group The group to write to
+ * @param attrName Name of the attribute to write
+ * @param value The value to write into the attribute in the trajectory file
+ */
+void FileIO::TrajectoryHDF5Writer::writeAttribute_(std::unique_ptr<H5::Group>& group, const std::string &attrName,
+                                                   double value){
+
+    // Create a dataset attribute.
+    hsize_t dims[1] = { 1 };
+    H5::DataSpace attr_dataspace = H5::DataSpace (1, dims);
+    H5::Attribute attribute = group->createAttribute( attrName.c_str(), H5::PredType::IEEE_F64BE,
+            attr_dataspace);
+
+    // Write the attribute data.
+    double attr_data[1] = {value};
+    attribute.write( H5::PredType::NATIVE_DOUBLE, attr_data);
+}
+
 /**
  * Writes an unsigned long long (aka hsize_t) attribute to a HDF5 group
  * @param group The group to write to
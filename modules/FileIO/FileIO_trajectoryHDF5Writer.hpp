@@ -35,6 +35,7 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <cstdint>
 
 
 namespace BTree{
@@ -53,8 +54,10 @@ namespace FileIO {
 
         void setParticleAttributes(const std::vector<std::string>& attributeNames, partAttribTransformFctType attributesTransformFct);
         void setParticleAttributes(const std::vector<std::string>& attributeNames, partAttribTransformFctTypeInteger attributesTransformFct);
+        void setQuantization(double positionError, double attributeError = 0.0, hsize_t keyFrameInterval = 50);
 
         void writeTimestep(std::vector<Core::Particle*>& particles, double time);
+        [[nodiscard]] std::size_t memoryUsageBytes(std::size_t nParticles) const;
 
         template <typename DT>
         void writeNumericListDataset(std::string dsName, const std::vector<DT> &values, H5::Group* group = nullptr);
@@ -74,14 +77,27 @@ namespace FileIO {
 
         void writeTimestepParticleAttributes_(std::vector<Core::Particle*> &particles);
         void writeTimestepParticleAttributesInteger_(std::vector<Core::Particle*> &particles);
+        void writeQuantizedTimestep_(const std::vector<double>& bufLocation, std::vector<Core::Particle*> &particles);
+        void writeQuantizedDataset_(const std::string& dsName, const std::vector<std::int64_t>& values,
+                                    const std::vector<std::int64_t>& last, hsize_t nColumns, bool keyFrame);
+        [[nodiscard]] std::vector<double> particleAttributesBuffer_(std::vector<Core::Particle*> &particles);
         void writeAttribute_(std::unique_ptr<H5::Group>& group, const std::string &attrName, int value);
         void writeAttribute_(std::unique_ptr<H5::Group>& group, const std::string &attrName, hsize_t value);
+        void writeAttribute_(std::unique_ptr<H5::Group>& group, const std::string &attrName, double value);
 
         //int nTimestepsWritten_;
         bool compression_ = true;
         bool hasParticleAttributes_ = false;
         bool hasParticleAttributesInteger_ = false;
 
+        bool quantization_ = false;                ///< If true: positions are written quantized and delta encoded
+        double positionQuantizationStep_ = 0.0;    ///< quantization step of the positions (two times the error bound)
+        double attributeQuantizationStep_ = 0.0;   ///< quantization step of the float attributes (0: not quantized)
+        hsize_t keyFrameInterval_ = 50;            ///< maximum number of time steps between two key frames
+        hsize_t framesSinceKeyFrame_ = 0;          ///< number of time steps written since the last key frame
+        std::vector<std::int64_t> lastPositionsQuantized_;  ///< quantized positions of the last written time step
+        std::vector<std::int64_t> lastAttributesQuantized_; ///< quantized float attributes of the last time step
+
         std::unique_ptr<H5::H5File> h5f_;
         std::unique_ptr<H5::Group> baseGroup_;
         std::unique_ptr<H5::Group> optionalDataSetGroup_;
@@ -77,6 +77,14 @@ unsigned int Integration::AbstractTimeIntegrator::timeStep() const{
     return timestep_;
 }
 
+/**
+ * Gets the memory used by the space charge data structure of the integrator (e.g. the Barnes-Hut tree),
+ * integrators without such a data structure return zero
+ */
+std::size_t Integration::AbstractTimeIntegrator::spaceChargeMemoryUsageBytes() const{
+    return 0;
+}
+
 /**
  * Generate ions in the simulation which are born up to the time "time"
  * The time of birth in the particles is set according to the actual birth time in the simulation
@@ -69,6 +69,7 @@ namespace Integration{
         [[nodiscard]] RunState runState() const;
         [[nodiscard]] double time() const;
         [[nodiscard]] unsigned int timeStep() const;
+        [[nodiscard]] virtual std::size_t spaceChargeMemoryUsageBytes() const;
 
     protected:
         RunState runState_ = STOPPED; ///< the current state the integrator is in
@@ -0,0 +1,291 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_floquetQuadrupoleIntegrator.hpp"
+#include "Core_tracing.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    double vectorComponent(const Core::Vector& vector, std::size_t axis){
+        return axis == 0 ? vector.x() : (axis == 1 ? vector.y() : vector.z());
+    }
+}
+
+Integration::FloquetQuadrupoleIntegrator::FloquetQuadrupoleIntegrator(
+        const std::vector<Core::Particle*>& particles,
+        Core::Vector fieldGradients,
+        double rfFrequency,
+        rfAmplitudeFctType rfAmplitudeFunction,
+        double dcVoltage,
+        excitationFieldFctType excitationFieldFunction,
+        Integration::postTimestepFctType timestepWriteFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        std::size_t substepsPerPeriod) :
+        AbstractTimeIntegrator(particles, ionStartMonitoringFunction),
+        fieldGradients_(fieldGradients),
+        rfOmega_(2.0*M_PI*rfFrequency),
+        rfAmplitudeFunction_(std::move(rfAmplitudeFunction)),
+        dcVoltage_(dcVoltage),
+        excitationFieldFunction_(std::move(excitationFieldFunction)),
+        postTimestepFunction_(std::move(timestepWriteFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction)),
+        substepsPerPeriod_(substepsPerPeriod)
+{
+    if (rfFrequency <= 0.0 || rfAmplitudeFunction_ == nullptr){
+        throw (std::invalid_argument("Floquet quadrupole integrator requires a positive RF frequency and an RF amplitude"));
+    }
+}
+
+/**
+ * Gets the RF period (the time step length has to be a whole multiple of the RF period)
+ */
+double Integration::FloquetQuadrupoleIntegrator::rfPeriod() const {
+    return 2.0*M_PI/rfOmega_;
+}
+
+/**
+ * Gets the number of ion species (distinct charge / mass ratios) in the integrator
+ */
+std::size_t Integration::FloquetQuadrupoleIntegrator::numberOfSpecies() const {
+    return species_.size();
+}
+
+/**
+ * Gets the current one RF period transfer map of a particle in the integrator along an axis
+ *
+ * @param particle a particle which was added to the integrator
+ * @param axis the axis (0: x, 1: y, 2: z)
+ */
+const Integration::MathieuTransferMap& Integration::FloquetQuadrupoleIntegrator::transferMap(
+        const Core::Particle& particle, std::size_t axis) const {
+
+    for (std::size_t i=0; i<nParticles_; ++i){
+        if (particles_[i] == &particle){
+            return species_[particleSpecies_[i]].maps.at(axis);
+        }
+    }
+    throw (std::invalid_argument("Particle is not part of the Floquet quadrupole integrator"));
+}
+
+/**
+ * Adds a particle to the integrator (required if particles are generated in the course of the simulation
+ * @param particle the particle to add to the integration
+ */
+void Integration::FloquetQuadrupoleIntegrator::addParticle(Core::Particle *particle){
+    particles_.push_back(particle);
+    newPos_.emplace_back(Core::Vector(0,0,0));
+    particleSpecies_.push_back(speciesIndex_(*particle));
+    ++nParticles_;
+}
+
+/**
+ * Runs the integration
+ * @param nTimesteps number of time steps to run
+ * @param dt time step length (a whole multiple of the RF period)
+ */
+void Integration::FloquetQuadrupoleIntegrator::run(unsigned int nTimesteps, double dt) {
+
+    // check the time step length before anything is written:
+    [[maybe_unused]] std::size_t nPeriods = periodsPerTimestep_(dt);
+
+    // run init:
+    this->runState_ = RUNNING;
+    bearParticles_(0.0);
+
+    if (postTimestepFunction_ !=nullptr) {
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+
+    // run:
+    for (unsigned int step=0; step< nTimesteps; step++){
+        runSingleStep(dt);
+        if (this->runState_ == IN_TERMINATION){
+            break;
+        }
+    }
+    this->finalizeSimulation();
+    this->runState_ = STOPPED;
+}
+
+/**
+ * Runs a single step of the integration
+ * @param dt time step length (a whole multiple of the RF period)
+ */
+void Integration::FloquetQuadrupoleIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
+
+    std::size_t nPeriods = periodsPerTimestep_(dt);
+
+    //first: Generate new particles if necessary
+    bearParticles_(time_);
+
+    {
+        IDSIMF_TRACE_SCOPE("transfer map update", "integration");
+        prepareTimestep_(nPeriods);
+    }
+
+    std::size_t i;
+    #pragma omp parallel for \
+            default(none) shared(newPos_, species_, particleSpecies_, particles_) \
+            private(i) schedule(static)
+    for (i=0; i<nParticles_; i++){
+        Core::Particle* particle = particles_[i];
+        if (particle->isActive()){
+            const Species& species = species_[particleSpecies_[i]];
+            Core::Vector pos = particle->getLocation();
+            Core::Vector vel = particle->getVelocity();
+            std::array<double, 3> x = {pos.x(), pos.y(), pos.z()};
+            std::array<double, 3> v = {vel.x(), vel.y(), vel.z()};
+            for (std::size_t axis=0; axis<3; ++axis){
+                MathieuTransferMap::state_t state =
+                        MathieuTransferMap::apply(species.stepMatrices[axis], {x[axis], v[axis]});
+                x[axis] = state[0] + species.stepDrivenResponses[axis][0];
+                v[axis] = state[1] + species.stepDrivenResponses[axis][1];
+            }
+            newPos_[i] = Core::Vector(x[0], x[1], x[2]);
+            particle->setVelocity(Core::Vector(v[0], v[1], v[2]));
+        }
+    }
+
+    {
+        IDSIMF_TRACE_SCOPE("position update", "integration");
+        for (std::size_t j=0; j<nParticles_; j++){
+            if (particles_[j]->isActive()){
+                if (otherActionsFunction_ != nullptr) {
+                    otherActionsFunction_(newPos_[j], particles_[j], j, time_, timestep_);
+                }
+                particles_[j]->setLocation(newPos_[j]);
+            }
+        }
+    }
+
+    time_ = time_ + dt;
+    timestep_++;
+    if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+}
+
+/**
+ * Finalizes the integration run (should be called after the last time step).
+ */
+void Integration::FloquetQuadrupoleIntegrator::finalizeSimulation(){
+    if (postTimestepFunction_ != nullptr){
+        postTimestepFunction_(this, particles_, time_, timestep_, true);
+    }
+}
+
+/**
+ * Gets the number of RF periods of a time step, throws if the time step length is not a whole multiple of the
+ * RF period
+ */
+std::size_t Integration::FloquetQuadrupoleIntegrator::periodsPerTimestep_(double dt) const {
+    double periods = dt / rfPeriod();
+    double nPeriods = std::round(periods);
+    if (nPeriods < 1.0 || std::fabs(periods - nPeriods) > 1e-9*periods){
+        throw (std::invalid_argument("Time step of Floquet quadrupole integrator is not a multiple of the RF period"));
+    }
+    return static_cast<std::size_t>(nPeriods);
+}
+
+/**
+ * Gets the species index of a particle, a new species is created if there is no species with the charge / mass
+ * ratio of the particle yet
+ */
+std::size_t Integration::FloquetQuadrupoleIntegrator::speciesIndex_(const Core::Particle& particle) {
+    double chargeMassRatio = particle.getCharge() / particle.getMass();
+    for (std::size_t i=0; i<species_.size(); ++i){
+        if (std::fabs(species_[i].chargeMassRatio - chargeMassRatio) <= 1e-12*std::fabs(chargeMassRatio)){
+            return i;
+        }
+    }
+    Species newSpecies;
+    newSpecies.chargeMassRatio = chargeMassRatio;
+    calculateTransferMaps_(newSpecies, mapsRfAmplitude_);
+    species_.push_back(std::move(newSpecies));
+    return species_.size() - 1;
+}
+
+/**
+ * Calculates the one RF period transfer maps of the axes of an ion species
+ */
+void Integration::FloquetQuadrupoleIntegrator::calculateTransferMaps_(Species& species, double rfAmplitude) const {
+    species.maps.clear();
+    for (std::size_t axis=0; axis<3; ++axis){
+        double k = species.chargeMassRatio * vectorComponent(fieldGradients_, axis);
+        species.maps.emplace_back(k*dcVoltage_, k*rfAmplitude, rfOmega_, substepsPerPeriod_);
+    }
+}
+
+/**
+ * Prepares the transfer matrices and the driven responses of all species for the current time step
+ * @param nPeriods number of RF periods of the time step
+ */
+void Integration::FloquetQuadrupoleIntegrator::prepareTimestep_(std::size_t nPeriods) {
+    if (species_.empty()){
+        return;
+    }
+
+    double rfAmplitude = rfAmplitudeFunction_(time_);
+    if (std::fabs(rfAmplitude - mapsRfAmplitude_) > 1e-12*std::fabs(rfAmplitude)){
+        mapsRfAmplitude_ = rfAmplitude;
+        for (Species& species: species_){
+            calculateTransferMaps_(species, rfAmplitude);
+        }
+    }
+
+    for (Species& species: species_){
+        for (std::size_t axis=0; axis<3; ++axis){
+            species.stepMatrices[axis] = species.maps[axis].matrixPower(nPeriods);
+            species.stepDrivenResponses[axis] = {0.0, 0.0};
+        }
+    }
+
+    if (excitationFieldFunction_ != nullptr){
+        // the excitation field is sampled once per RF period for all species, the responses of the periods
+        // are propagated to the end of the time step:
+        const MathieuTransferMap& referenceMap = species_[0].maps[0];
+        std::size_t nSamples = referenceMap.numberOfDriveSamples();
+        std::vector<Core::Vector> fieldSamples(nSamples);
+        std::vector<double> driveSamples(nSamples);
+        for (std::size_t period=0; period<nPeriods; ++period){
+            double periodStartTime = time_ + static_cast<double>(period)*rfPeriod();
+            for (std::size_t j=0; j<nSamples; ++j){
+                fieldSamples[j] = excitationFieldFunction_(periodStartTime + referenceMap.driveSampleTime(j));
+            }
+            for (Species& species: species_){
+                for (std::size_t axis=0; axis<3; ++axis){
+                    for (std::size_t j=0; j<nSamples; ++j){
+                        driveSamples[j] = species.chargeMassRatio * vectorComponent(fieldSamples[j], axis);
+                    }
+                    MathieuTransferMap::state_t response = species.maps[axis].drivenResponse(driveSamples);
+                    MathieuTransferMap::state_t propagated =
+                            MathieuTransferMap::apply(species.maps[axis].matrix(), species.stepDrivenResponses[axis]);
+                    species.stepDrivenResponses[axis] = {propagated[0] + response[0], propagated[1] + response[1]};
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_floquetQuadrupoleIntegrator.hpp
+
+ Propagation of ions in ideal quadrupole fields by whole RF periods with precomputed transfer matrices
+
+ ****************************/
+
+#ifndef Integration_floquetQuadrupoleIntegrator_hpp
+#define Integration_floquetQuadrupoleIntegrator_hpp
+
+#include "Core_particle.hpp"
+#include "Core_vector.hpp"
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "Integration_mathieuTransferMap.hpp"
+#include <vector>
+#include <functional>
+
+namespace Integration{
+
+    /**
+     * Trajectory "integrator" for ions in an ideal (purely quadrupolar) RF field without space charge and without
+     * collisions, which advances the ions by whole RF periods with precomputed transfer matrices (Floquet theory).
+     *
+     * The field is described by the voltage U(t) = U_dc + V_rf(t) cos(omega t) and the field gradients per voltage
+     * g_x, g_y, g_z of the electrode geometry (e.g. g = (1, 1, -2) / r_0^2 for an ideal 3D quadrupole ion trap and
+     * g = (1, -1, 0) / r_0^2 for an ideal linear quadrupole), and an optional spatially homogeneous (dipolar)
+     * excitation field E_ex(t). The acceleration of an ion with charge Q and mass m along axis i is
+     *
+     *      a_i = Q/m (-U(t) g_i x_i + E_ex,i(t))
+     *
+     * thus the motion along the axes is decoupled and linear. For every ion species (charge / mass ratio) the one RF
+     * period transfer maps (MathieuTransferMap) of the three axes are calculated once, and every ion is propagated
+     * by a 2x2 matrix vector product per axis and time step, independent of the number of RF periods per time step.
+     * The excitation is treated as driven perturbation, its response is integrated once per species and time step.
+     *
+     * The time step length has to be a whole multiple of the RF period, the simulation starts at a zero RF phase. The
+     * RF amplitude is evaluated at the beginning of every time step and is constant during the time step (the
+     * transfer maps are recalculated if the amplitude changes, which allows slow amplitude ramps / scans). Other
+     * actions (e.g. ion termination at electrodes) are performed at the end of every time step.
+     */
+    class FloquetQuadrupoleIntegrator: public AbstractTimeIntegrator {
+
+    public:
+
+        /**
+         * Type definition for time dependent RF amplitudes
+         */
+        typedef std::function<double (double time)> rfAmplitudeFctType;
+
+        /**
+         * Type definition for time dependent homogeneous excitation fields
+         */
+        typedef std::function<Core::Vector (double time)> excitationFieldFctType;
+
+        FloquetQuadrupoleIntegrator(
+                const std::vector<Core::Particle*>& particles,
+                Core::Vector fieldGradients,
+                double rfFrequency,
+                rfAmplitudeFctType rfAmplitudeFunction,
+                double dcVoltage = 0.0,
+                excitationFieldFctType excitationFieldFunction = nullptr,
+                postTimestepFctType timestepWriteFunction = nullptr,
+                otherActionsFctType otherActionsFunction = nullptr,
+                AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                std::size_t substepsPerPeriod = 512
+        );
+
+        [[nodiscard]] double rfPeriod() const;
+        [[nodiscard]] std::size_t numberOfSpecies() const;
+        [[nodiscard]] const MathieuTransferMap& transferMap(const Core::Particle& particle, std::size_t axis) const;
+
+        void addParticle(Core::Particle* particle) override;
+        void run(unsigned int nTimesteps, double dt) override;
+        void runSingleStep(double dt) override;
+        void finalizeSimulation() override;
+
+    private:
+
+        /**
+         * An ion species with its transfer maps and the transfer over the current time step
+         */
+        struct Species {
+            double chargeMassRatio; ///< Charge / mass ratio of the species
+            std::vector<MathieuTransferMap> maps; ///< One RF period transfer maps of the axes
+            std::array<MathieuTransferMap::matrix_t, 3> stepMatrices; ///< Transfer matrices of the current time step
+            std::array<MathieuTransferMap::state_t, 3> stepDrivenResponses; ///< Driven responses of the current time step
+        };
+
+        Core::Vector fieldGradients_; ///< Field gradients per voltage (g_x, g_y, g_z)
+        double rfOmega_; ///< RF angular frequency
+        rfAmplitudeFctType rfAmplitudeFunction_ = nullptr; ///< RF amplitude as function of time
+        double dcVoltage_ = 0.0; ///< DC voltage
+        excitationFieldFctType excitationFieldFunction_ = nullptr; ///< Homogeneous excitation field
+        postTimestepFctType postTimestepFunction_ = nullptr; ///< function to export / write time step results
+        otherActionsFctType otherActionsFunction_ = nullptr; ///< function for arbitrary other actions in the simulation
+        std::size_t substepsPerPeriod_; ///< number of integration substeps per period of the transfer maps
+
+        double mapsRfAmplitude_ = 0.0; ///< RF amplitude the transfer maps were calculated for
+        std::vector<Species> species_; ///< The ion species
+        std::vector<std::size_t> particleSpecies_; ///< Species index of the particles
+        std::vector<Core::Vector> newPos_; ///< new position (after time step) for particles
+
+        [[nodiscard]] std::size_t periodsPerTimestep_(double dt) const;
+        std::size_t speciesIndex_(const Core::Particle& particle);
+        void calculateTransferMaps_(Species& species, double rfAmplitude) const;
+        void prepareTimestep_(std::size_t nPeriods);
+    };
+}
+
+#endif /* Integration_floquetQuadrupoleIntegrator_hpp */
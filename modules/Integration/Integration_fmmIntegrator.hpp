@@ -32,6 +32,7 @@
 #include "Core_particle.hpp"
 #include "Core_vector.hpp"
 #include "Integration_abstractTimeIntegrator.hpp"
+#include "Core_tracing.hpp"
 #include "CollisionModel_AbstractCollisionModel.hpp"
 #include <vector>
 
@@ -141,14 +142,17 @@ namespace Integration{
 
     template <class FMMSolverT>
     void FMMVerletIntegrator<FMMSolverT>::runSingleStep(double dt) {
+        IDSIMF_TRACE_SCOPE("time step", "integration");
         bearParticles_(time_);
 
         if (collisionModel_ !=nullptr){
+            IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
             collisionModel_->updateModelTimestepParameters(timestep_, time_);
         }
 
         // first: Calculate charge distribution with particle positions and charges at the beginning of the time step
         if (nParticles_ > 0){
+            IDSIMF_TRACE_SCOPE("space charge solver", "space charge");
             solver_.computeChargeDistribution();
         }
 
@@ -156,8 +160,10 @@ namespace Integration{
         #pragma omp parallel \
                 default(none) shared(a_tdt_, a_t_, dt, particles_)
         {
+            IDSIMF_TRACE_SCOPE("particle update", "integration");
 
-            #pragma omp for
+            // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+            #pragma omp for nowait
             for (std::size_t i=0; i<nParticles_; i++){
 
                 if (particles_[i]->isActive()){
@@ -196,6 +202,7 @@ namespace Integration{
         time_ = time_ + dt;
         timestep_++;
         if (postTimestepFunction_ != nullptr) {
+            IDSIMF_TRACE_SCOPE("post time step", "integration");
             postTimestepFunction_(this, particles_, time_, timestep_, false);
         }
     }
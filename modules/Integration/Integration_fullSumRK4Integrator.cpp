@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Integration_fullSumRK4Integrator.hpp"
+#include "Core_tracing.hpp"
 #include <utility>
 #include <algorithm>
 
@@ -94,11 +95,13 @@ void Integration::FullSumRK4Integrator::run(unsigned int nTimesteps, double dt)
 }
 
 void Integration::FullSumRK4Integrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
 
     //first: Generate new particles if necessary
     bearParticles_(time_);
 
     if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
         collisionModel_->updateModelTimestepParameters(timestep_, time_);
     }
     std::size_t i;
@@ -106,8 +109,10 @@ void Integration::FullSumRK4Integrator::runSingleStep(double dt){
             default(none) shared(newPos_, spaceChargeAcceleration_, dt, particles_) \
             private(i)
     {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
 
-        #pragma omp for schedule(dynamic, 40)
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
         for (i=0; i<nParticles_; i++){
 
             if (particles_[i]->isActive()){
@@ -193,6 +198,7 @@ void Integration::FullSumRK4Integrator::runSingleStep(double dt){
     time_ = time_ + dt;
     timestep_++;
     if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
         postTimestepFunction_(this, particles_, time_, timestep_, false);
     }
 }
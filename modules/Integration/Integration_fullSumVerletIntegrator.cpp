@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Integration_fullSumVerletIntegrator.hpp"
+#include "Core_tracing.hpp"
 #include <utility>
 #include <algorithm>
 
@@ -92,8 +93,10 @@ void Integration::FullSumVerletIntegrator::run(unsigned int nTimesteps, double d
 }
 
 void Integration::FullSumVerletIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
     bearParticles_(time_);
     if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
         collisionModel_->updateModelTimestepParameters(timestep_, time_);
     }
     std::size_t i;
@@ -101,8 +104,10 @@ void Integration::FullSumVerletIntegrator::runSingleStep(double dt){
             default(none) shared(newPos_, a_tdt_, a_t_, dt, particles_) \
             private(i) //firstprivate(MyNod)
     {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
 
-        #pragma omp for schedule(dynamic, 40)
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
         for (i=0; i<nParticles_; i++){
 
             if (particles_[i]->isActive()){
@@ -152,6 +157,7 @@ void Integration::FullSumVerletIntegrator::runSingleStep(double dt){
     time_ = time_ + dt;
     timestep_++;
     if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
         postTimestepFunction_(this, particles_, time_, timestep_, false);
     }
 }
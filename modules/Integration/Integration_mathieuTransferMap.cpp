@@ -0,0 +1,199 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_mathieuTransferMap.hpp"
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * Constructs the transfer map of the Mathieu equation x'' = -(kDC + kRF cos(omega t)) x + f(t) for one RF period
+ * starting at a zero phase of the RF
+ *
+ * @param kDC DC restoring coefficient (1/s^2)
+ * @param kRF RF restoring coefficient (1/s^2)
+ * @param omega RF angular frequency (1/s)
+ * @param nSubsteps number of integration substeps per RF period (rounded up to an even number)
+ */
+Integration::MathieuTransferMap::MathieuTransferMap(double kDC, double kRF, double omega, std::size_t nSubsteps):
+kDC_(kDC),
+kRF_(kRF),
+omega_(omega),
+nSubsteps_(nSubsteps + nSubsteps % 2)
+{
+    if (omega <= 0.0 || nSubsteps < 2){
+        throw (std::invalid_argument("Illegal RF frequency or number of substeps for Mathieu transfer map"));
+    }
+
+    // integrate the fundamental solutions (columns of the transfer matrix) with RK4:
+    double h = period() / static_cast<double>(nSubsteps_);
+    auto k = [this](double t){return kDC_ + kRF_*std::cos(omega_*t);};
+
+    double x1 = 1.0, v1 = 0.0, x2 = 0.0, v2 = 1.0;
+    driveKernel_.resize(nSubsteps_ + 1);
+    for (std::size_t j=0; j<=nSubsteps_; ++j){
+        // Simpson weights:
+        double w = (j == 0 || j == nSubsteps_) ? h/3.0 : (j % 2 == 1 ? 4.0*h/3.0 : 2.0*h/3.0);
+        // with det(Phi) = 1: Phi(s)^-1 (0, f) = (-x2 f, x1 f)
+        driveKernel_[j] = {-x2*w, x1*w};
+
+        if (j == nSubsteps_){
+            break;
+        }
+        double t = static_cast<double>(j)*h;
+        double kStart = k(t), kMid = k(t + 0.5*h), kEnd = k(t + h);
+        for (auto column: {std::make_pair(&x1, &v1), std::make_pair(&x2, &v2)}){
+            double& x = *column.first;
+            double& v = *column.second;
+            double dx1 = v, dv1 = -kStart*x;
+            double dx2 = v + 0.5*h*dv1, dv2 = -kMid*(x + 0.5*h*dx1);
+            double dx3 = v + 0.5*h*dv2, dv3 = -kMid*(x + 0.5*h*dx2);
+            double dx4 = v + h*dv3, dv4 = -kEnd*(x + h*dx3);
+            x += h/6.0*(dx1 + 2.0*dx2 + 2.0*dx3 + dx4);
+            v += h/6.0*(dv1 + 2.0*dv2 + 2.0*dv3 + dv4);
+        }
+    }
+    matrix_ = {x1, x2, v1, v2};
+}
+
+/**
+ * Gets the RF period (the time span of the transfer map)
+ */
+double Integration::MathieuTransferMap::period() const {
+    return 2.0*M_PI/omega_;
+}
+
+/**
+ * Gets the Mathieu parameter a (with the dimensionless time xi = omega t / 2)
+ */
+double Integration::MathieuTransferMap::mathieuA() const {
+    return 4.0*kDC_/(omega_*omega_);
+}
+
+/**
+ * Gets the Mathieu parameter q (with the dimensionless time xi = omega t / 2, the canonical form of the Mathieu
+ * equation is d^2x / dxi^2 + (a - 2q cos(2 xi)) x = 0)
+ */
+double Integration::MathieuTransferMap::mathieuQ() const {
+    return -2.0*kRF_/(omega_*omega_);
+}
+
+/**
+ * Gets the transfer matrix over one RF period (row major, acting on (x, v))
+ */
+const Integration::MathieuTransferMap::matrix_t& Integration::MathieuTransferMap::matrix() const {
+    return matrix_;
+}
+
+/**
+ * Gets the transfer matrix over a number of RF periods (the matrix power, calculated by repeated squaring)
+ * @param nPeriods the number of RF periods
+ */
+Integration::MathieuTransferMap::matrix_t Integration::MathieuTransferMap::matrixPower(std::size_t nPeriods) const {
+    matrix_t result = {1.0, 0.0, 0.0, 1.0};
+    matrix_t base = matrix_;
+    while (nPeriods > 0){
+        if (nPeriods % 2 == 1){
+            result = multiply(result, base);
+        }
+        base = multiply(base, base);
+        nPeriods /= 2;
+    }
+    return result;
+}
+
+/**
+ * Checks if the motion is stable (bounded), which is the case if the absolute trace of the transfer matrix is
+ * smaller than two
+ */
+bool Integration::MathieuTransferMap::isStable() const {
+    return std::fabs(matrix_[0] + matrix_[3]) < 2.0;
+}
+
+/**
+ * Gets the Mathieu stability parameter beta (cos(pi beta) = trace(M) / 2), which is in [0, 1] for stable motion
+ * (NaN for unstable motion)
+ */
+double Integration::MathieuTransferMap::stabilityParameterBeta() const {
+    if (!isStable()){
+        return std::nan("");
+    }
+    return std::acos(0.5*(matrix_[0] + matrix_[3])) / M_PI;
+}
+
+/**
+ * Gets the (fundamental) secular frequency of stable motion (Hz), which is beta / 2 times the RF frequency
+ */
+double Integration::MathieuTransferMap::secularFrequency() const {
+    return 0.5*stabilityParameterBeta() * omega_/(2.0*M_PI);
+}
+
+/**
+ * Gets the number of samples of the driving acceleration required by drivenResponse
+ */
+std::size_t Integration::MathieuTransferMap::numberOfDriveSamples() const {
+    return driveKernel_.size();
+}
+
+/**
+ * Gets the time (relative to the beginning of the RF period) of a sample of the driving acceleration
+ * @param sampleIndex index of the sample
+ */
+double Integration::MathieuTransferMap::driveSampleTime(std::size_t sampleIndex) const {
+    return static_cast<double>(sampleIndex) * period() / static_cast<double>(nSubsteps_);
+}
+
+/**
+ * Calculates the response to a driving acceleration over one RF period: The state at the end of the period is
+ * M (x, v) + drivenResponse.
+ *
+ * @param driveSamples driving acceleration at the sample times (see driveSampleTime) of the RF period
+ * @return the state change caused by the driving acceleration
+ */
+Integration::MathieuTransferMap::state_t Integration::MathieuTransferMap::drivenResponse(
+        const std::vector<double>& driveSamples) const {
+
+    if (driveSamples.size() != driveKernel_.size()){
+        throw (std::invalid_argument("Wrong number of driving acceleration samples for Mathieu transfer map"));
+    }
+    state_t integral = {0.0, 0.0};
+    for (std::size_t j=0; j<driveKernel_.size(); ++j){
+        integral[0] += driveKernel_[j][0]*driveSamples[j];
+        integral[1] += driveKernel_[j][1]*driveSamples[j];
+    }
+    return apply(matrix_, integral);
+}
+
+/**
+ * Multiplies two 2x2 matrices
+ */
+Integration::MathieuTransferMap::matrix_t Integration::MathieuTransferMap::multiply(
+        const matrix_t& A, const matrix_t& B) {
+
+    return {A[0]*B[0] + A[1]*B[2], A[0]*B[1] + A[1]*B[3],
+            A[2]*B[0] + A[3]*B[2], A[2]*B[1] + A[3]*B[3]};
+}
+
+/**
+ * Applies a 2x2 matrix to a phase space state
+ */
+Integration::MathieuTransferMap::state_t Integration::MathieuTransferMap::apply(const matrix_t& A, const state_t& x) {
+    return {A[0]*x[0] + A[1]*x[1], A[2]*x[0] + A[3]*x[1]};
+}
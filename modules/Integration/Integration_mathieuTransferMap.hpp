@@ -0,0 +1,90 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_mathieuTransferMap.hpp
+
+ One RF period transfer map (Floquet / monodromy matrix) of the linear motion in an ideal quadrupole field
+
+ ****************************/
+
+#ifndef Integration_mathieuTransferMap_hpp
+#define Integration_mathieuTransferMap_hpp
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+namespace Integration{
+
+    /**
+     * Transfer map of the motion along one axis in an ideal quadrupole field over one RF period.
+     *
+     * The motion is described by the (driven) Mathieu equation
+     *
+     *      x'' = -(k_dc + k_rf cos(omega t)) x + f(t)
+     *
+     * with the DC and RF restoring coefficients k_dc, k_rf (charge / mass times the field gradient per voltage times
+     * the voltage) and a spatially homogeneous driving acceleration f(t) (e.g. a dipolar excitation). The
+     * homogeneous equation is linear with periodic coefficients, thus the state (x, v) after a whole RF period
+     * T = 2 pi / omega is a linear function of the state at the beginning of the period (Floquet theory): It is given
+     * by the 2x2 transfer (monodromy) matrix M, which depends only on the Mathieu parameters (a, q) and is the same
+     * for all periods starting at a zero phase of the RF (t = n T). The driving acceleration adds an inhomogeneous
+     * term, which is the integral of the driving acceleration weighted with the fundamental solutions over the
+     * period.
+     *
+     * The fundamental solutions are calculated once by a Runge-Kutta 4 integration with a fixed number of substeps
+     * per period, the driving term is integrated with the Simpson rule on the same substep grid.
+     */
+    class MathieuTransferMap {
+
+    public:
+        typedef std::array<double, 4> matrix_t; ///< Row major 2x2 matrix acting on (x, v)
+        typedef std::array<double, 2> state_t; ///< Phase space state (x, v)
+
+        MathieuTransferMap(double kDC, double kRF, double omega, std::size_t nSubsteps = 512);
+
+        [[nodiscard]] double period() const;
+        [[nodiscard]] double mathieuA() const;
+        [[nodiscard]] double mathieuQ() const;
+        [[nodiscard]] const matrix_t& matrix() const;
+        [[nodiscard]] matrix_t matrixPower(std::size_t nPeriods) const;
+        [[nodiscard]] bool isStable() const;
+        [[nodiscard]] double stabilityParameterBeta() const;
+        [[nodiscard]] double secularFrequency() const;
+
+        [[nodiscard]] std::size_t numberOfDriveSamples() const;
+        [[nodiscard]] double driveSampleTime(std::size_t sampleIndex) const;
+        [[nodiscard]] state_t drivenResponse(const std::vector<double>& driveSamples) const;
+
+        [[nodiscard]] static matrix_t multiply(const matrix_t& A, const matrix_t& B);
+        [[nodiscard]] static state_t apply(const matrix_t& A, const state_t& x);
+
+    private:
+        double kDC_; ///< DC restoring coefficient
+        double kRF_; ///< RF restoring coefficient
+        double omega_; ///< RF angular frequency
+        std::size_t nSubsteps_; ///< Number of integration substeps per RF period (even)
+        matrix_t matrix_ = {1.0, 0.0, 0.0, 1.0}; ///< The transfer matrix over one RF period
+        std::vector<state_t> driveKernel_; ///< Quadrature weighted kernel of the driving term at the substep times
+    };
+}
+
+#endif /* Integration_mathieuTransferMap_hpp */
@@ -0,0 +1,283 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_parallelEventDrivenIntegrator.hpp"
+#include "Core_randomGenerators.hpp"
+#include "Core_tracing.hpp"
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Integration::ParallelEventDrivenIntegrator::ParallelEventDrivenIntegrator(
+        const std::vector<Core::Particle *>& particles,
+        Integration::accelerationFctSingleStepType accelerationFunction,
+        uniformFieldRegionFctType uniformFieldRegionFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction) :
+        AbstractTimeIntegrator(particles, ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        uniformFieldRegionFunction_(std::move(uniformFieldRegionFunction)),
+        postTimestepFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{
+    checkCollisionModel_();
+}
+
+Integration::ParallelEventDrivenIntegrator::ParallelEventDrivenIntegrator(
+        Integration::accelerationFctSingleStepType accelerationFunction,
+        uniformFieldRegionFctType uniformFieldRegionFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction) :
+        AbstractTimeIntegrator(ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        uniformFieldRegionFunction_(std::move(uniformFieldRegionFunction)),
+        postTimestepFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{
+    checkCollisionModel_();
+    initInternalState_();
+}
+
+/**
+ * Adds a particle to the integrator (required if particles are generated in the course of the simulation
+ * @param particle the particle to add to the integration
+ */
+void Integration::ParallelEventDrivenIntegrator::addParticle(Core::Particle *particle){
+    particles_.push_back(particle);
+    newPos_.emplace_back(Core::Vector(0,0,0));
+    accelerations_.emplace_back(Core::Vector(0,0,0));
+
+    tree_.insertParticle(*particle, nParticles_);
+    ++nParticles_;
+}
+
+void Integration::ParallelEventDrivenIntegrator::checkCollisionModel_() const {
+    if (collisionModel_ == nullptr || !collisionModel_->hasCollisionEvents()){
+        throw (std::invalid_argument("Event driven integration requires a collision model with collision events"));
+    }
+}
+
+void Integration::ParallelEventDrivenIntegrator::bearParticles_(double time) {
+    Integration::AbstractTimeIntegrator::bearParticles_(time);
+    initInternalState_();
+}
+
+void Integration::ParallelEventDrivenIntegrator::initInternalState_(){
+    tree_.init();
+}
+
+/**
+ * Runs the integration
+ * @param nTimesteps number of time steps to run
+ * @param dt time step length
+ */
+void Integration::ParallelEventDrivenIntegrator::run(unsigned int nTimesteps, double dt) {
+
+    // run init:
+    this->runState_ = RUNNING;
+    bearParticles_(0.0);
+
+    if (postTimestepFunction_ !=nullptr) {
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+
+    // run:
+    for (unsigned int step=0; step< nTimesteps; step++){
+        runSingleStep(dt);
+        if (this->runState_ == IN_TERMINATION){
+            break;
+        }
+    }
+    this->finalizeSimulation();
+    this->runState_ = STOPPED;
+}
+
+/**
+ * Runs a single step of the integration
+ * @param dt time step length
+ */
+void Integration::ParallelEventDrivenIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
+
+    //first: Generate new particles if necessary
+    bearParticles_(time_);
+
+    int ver=0;
+
+    {
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
+        collisionModel_->updateModelTimestepParameters(timestep_, time_);
+    }
+
+    std::size_t i;
+    #pragma omp parallel \
+            default(none) shared(newPos_, accelerations_, dt, particles_) \
+            private(i)
+    {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
+
+        // the accelerations (with the space charge from the tree) are evaluated for all particles before the
+        // particles are propagated, since the propagation moves the particle locations to the collision events:
+        #pragma omp for schedule(dynamic, 40)
+        for (i=0; i<nParticles_; i++){
+            Core::Particle* particle = particles_[i];
+            if (particle->isActive()){
+                collisionModel_->updateModelParticleParameters(*particle);
+
+                accelerations_[i] = accelerationFunction_(particle, i, tree_, time_, timestep_);
+                collisionModel_->modifyAcceleration(accelerations_[i], *particle, dt);
+            }
+        }
+
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
+        for (i=0; i<nParticles_; i++){
+            Core::Particle* particle = particles_[i];
+            if (particle->isActive()){
+                const Core::Vector& acceleration = accelerations_[i];
+                if (uniformFieldRegionFunction_ == nullptr || uniformFieldRegionFunction_(particle, time_)){
+                    newPos_[i] = propagateEventDriven_(particle, acceleration, dt);
+                }
+                else {
+                    // fixed time step with per time step collision test:
+                    newPos_[i] = particle->getLocation() + particle->getVelocity()*dt + acceleration*(0.5*dt*dt);
+                    particle->setVelocity(particle->getVelocity() + acceleration*dt);
+                    collisionModel_->modifyVelocity(*particle, dt);
+                }
+            }
+        }
+    }
+
+    // First find all new positions, then perform otherActions then update tree.
+    // This ensures that all new particle positions are found with the state from
+    // last time step. No particle positions are found with a partly updated tree.
+    {
+        IDSIMF_TRACE_SCOPE("position update", "integration");
+        for (std::size_t j=0; j<nParticles_; j++){
+            if (particles_[j]->isActive()){
+                //position changes due to background interaction:
+                collisionModel_->modifyPosition(newPos_[j], *(particles_[j]), dt);
+
+                if (otherActionsFunction_ != nullptr) {
+                    otherActionsFunction_(newPos_[j], particles_[j], j, time_, timestep_);
+                }
+                tree_.updateParticleLocation(j, newPos_[j], &ver);
+            }
+        }
+    }
+
+    // Update serialized tree structure:
+    {
+        IDSIMF_TRACE_SCOPE("tree update", "space charge");
+        tree_.updateNodes(ver);
+    }
+    time_ = time_ + dt;
+    timestep_++;
+    if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+}
+
+/**
+ * Finalizes the integration run (should be called after the last time step).
+ */
+void Integration::ParallelEventDrivenIntegrator::finalizeSimulation(){
+    if (postTimestepFunction_ != nullptr){
+        postTimestepFunction_(this, particles_, time_, timestep_, true);
+    }
+}
+
+/**
+ * Gets the memory used by the Barnes-Hut tree of the integrator
+ */
+std::size_t Integration::ParallelEventDrivenIntegrator::spaceChargeMemoryUsageBytes() const{
+    return tree_.memoryUsageBytes();
+}
+
+/**
+ * Propagates a particle with a constant acceleration from collision to collision (with null collisions) through
+ * a time step. The particle location is advanced to every flight segment end and collision event, thus the
+ * collision model evaluates the gas state at the current particle position. The particle velocity is updated, the
+ * particle location is reset to the location at the begin of the time step at the end (the tree is updated after
+ * all particles are propagated).
+ *
+ * @param particle the particle to propagate
+ * @param acceleration the constant acceleration of the particle in the time step
+ * @param dt the time step length
+ * @return the new location of the particle at the end of the time step
+ */
+Core::Vector Integration::ParallelEventDrivenIntegrator::propagateEventDriven_(
+        Core::Particle* particle, const Core::Vector& acceleration, double dt) {
+
+    Core::RandomSource* rndSource = Core::globalRandomGeneratorPool->getThreadRandomSource();
+    double accelerationMagnitude = acceleration.magnitude();
+    Core::Vector startLocation = particle->getLocation();
+    Core::Vector location = startLocation;
+    Core::Vector velocity = particle->getVelocity();
+
+    double remainingTime = dt;
+    while (remainingTime > 0.0){
+        // the velocity changes by at most |a| * segmentTime in the flight segment, the collision frequency bound of
+        // the segment is the frequency with a speed increased accordingly:
+        double segmentTime = remainingTime;
+        double restFrequency = collisionModel_->collisionFrequencyBound(*particle, 0.0);
+        if (restFrequency > 0.0){
+            segmentTime = std::min(segmentTime, SEGMENT_MEAN_FREE_FLIGHTS / restFrequency);
+        }
+        double frequencyBound = collisionModel_->collisionFrequencyBound(
+                *particle, accelerationMagnitude*segmentTime);
+
+        // sample the time to the next tentative collision event:
+        double flightTime = segmentTime;
+        bool isTentativeCollision = false;
+        if (frequencyBound > 0.0){
+            double tentativeTime = -std::log(1.0 - rndSource->uniformRealRndValue()) / frequencyBound;
+            if (tentativeTime < segmentTime){
+                flightTime = tentativeTime;
+                isTentativeCollision = true;
+            }
+        }
+
+        // analytic free flight with constant acceleration:
+        location = location + velocity*flightTime + acceleration*(0.5*flightTime*flightTime);
+        velocity = velocity + acceleration*flightTime;
+        particle->setLocation(location);
+        particle->setVelocity(velocity);
+        remainingTime -= flightTime;
+
+        // accept the tentative event as real collision with the ratio of real collision frequency and bound:
+        if (isTentativeCollision &&
+            rndSource->uniformRealRndValue()*frequencyBound < collisionModel_->collisionFrequency(*particle)){
+            collisionModel_->performCollision(*particle);
+            velocity = particle->getVelocity();
+        }
+    }
+    particle->setLocation(startLocation);
+    return location;
+}
@@ -0,0 +1,136 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_parallelEventDrivenIntegrator.hpp
+
+ Parallel event driven (collision to collision) trajectory integrator for particles in piecewise uniform fields
+
+ ****************************/
+
+#ifndef Integration_parallelEventDrivenIntegrator_hpp
+#define Integration_parallelEventDrivenIntegrator_hpp
+
+#include "Core_particle.hpp"
+#include "Core_vector.hpp"
+#include "BTree_parallelTree.hpp"
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "CollisionModel_AbstractCollisionModel.hpp"
+#include <vector>
+#include <functional>
+
+namespace Integration{
+
+    /**
+     * Ion trajectory integrator which propagates the particles from collision to collision (event driven) in
+     * regions with uniform fields. Space charge calculation with the parallel Barnes-Hut tree.
+     *
+     * In regions with a uniform acceleration a (e.g. the drift region of an IMS drift tube), the motion between two
+     * collisions with the background gas is the analytic free flight with constant acceleration. Instead of advancing
+     * the particles with small fixed time steps and testing for a collision in every step, the free flight time to
+     * the next collision is sampled directly with the null collision method: Tentative collision events are drawn
+     * from a Poisson process with a constant rate nu_max, which bounds the real (velocity dependent) collision
+     * frequency nu(v) of the particle during the flight. The particle is advanced analytically to the tentative
+     * event, which is a real collision with the probability nu(v) / nu_max and a null collision (no interaction)
+     * otherwise. Since the particle velocity changes by at most |a| t in a flight of length t, the bound is the
+     * collision frequency for the current velocity plus |a| t (AbstractCollisionModel::collisionFrequencyBound). The
+     * flights are split into segments of the order of the mean free flight time to keep the bound tight.
+     *
+     * Thus, the time step length is not limited by the mean time between collisions and can be chosen according to
+     * the required temporal resolution of the simulation results (and the variation of the space charge field).
+     * Multiple collisions per time step are resolved exactly. The acceleration of a particle is evaluated once per
+     * time step, the gas state (pressure, temperature, flow velocity) is evaluated by the collision model at the
+     * particle position of the flight segments and collision events.
+     *
+     * A region function flags the particles which are in uniform field regions. Particles outside the uniform regions
+     * are integrated with fixed time steps (with constant acceleration in the time step) and the per time step
+     * collision test of the collision model (AbstractCollisionModel::modifyVelocity), thus the time step length has
+     * to be short compared to the mean time between collisions if particles enter non uniform regions.
+     *
+     * The collision model has to describe the gas interaction with discrete collision events
+     * (AbstractCollisionModel::hasCollisionEvents), e.g. the hard sphere model.
+     */
+    class ParallelEventDrivenIntegrator: public AbstractTimeIntegrator {
+
+        public:
+
+            /**
+             * Type definition for a function which flags if a particle is in a region with an uniform acceleration
+             * (constant in space and time during the current time step)
+             */
+            typedef std::function
+                <bool (Core::Particle* particle,
+                       double time)>
+                uniformFieldRegionFctType;
+
+            /**
+             * Length of the flight segments with a common collision frequency bound in mean free flight times
+             */
+            constexpr static double SEGMENT_MEAN_FREE_FLIGHTS = 1.0;
+
+            ParallelEventDrivenIntegrator(
+                    const std::vector<Core::Particle*>& particles,
+                    accelerationFctSingleStepType accelerationFunction,
+                    uniformFieldRegionFctType uniformFieldRegionFunction,
+                    CollisionModel::AbstractCollisionModel* collisionModel,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr
+            );
+
+            ParallelEventDrivenIntegrator(
+                    accelerationFctSingleStepType accelerationFunction,
+                    uniformFieldRegionFctType uniformFieldRegionFunction,
+                    CollisionModel::AbstractCollisionModel* collisionModel,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr
+            );
+
+            void addParticle(Core::Particle* particle) override;
+            void run(unsigned int nTimesteps, double dt) override;
+            void runSingleStep(double dt) override;
+            void finalizeSimulation() override;
+            [[nodiscard]] std::size_t spaceChargeMemoryUsageBytes() const override;
+
+    private:
+
+        CollisionModel::AbstractCollisionModel* collisionModel_ = nullptr; ///< the gas collision model to perform while integrating
+
+        accelerationFctSingleStepType accelerationFunction_ = nullptr;   ///< function to calculate particle acceleration
+        uniformFieldRegionFctType uniformFieldRegionFunction_ = nullptr; ///< function to flag particles in uniform fields
+        postTimestepFctType postTimestepFunction_ = nullptr; ///< function to export / write time step results
+        otherActionsFctType otherActionsFunction_ = nullptr;   ///< function for arbitrary other actions in the simulation
+
+        //internal variables for actual calculations:
+        BTree::ParallelTree tree_; ///< The parallel BTree with dynamic domain (primarily for space charge calculation)
+
+        std::vector<Core::Vector>  newPos_;  ///< new position (after time step) for particles
+        std::vector<Core::Vector>  accelerations_;  ///< accelerations of the particles in the current time step
+
+        void checkCollisionModel_() const;
+        [[nodiscard]] Core::Vector propagateEventDriven_(Core::Particle* particle, const Core::Vector& acceleration,
+                                                         double dt);
+        void bearParticles_(double time);
+        void initInternalState_();
+    };
+}
+
+#endif /* Integration_parallelEventDrivenIntegrator_hpp */
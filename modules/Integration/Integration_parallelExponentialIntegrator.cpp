@@ -0,0 +1,230 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_parallelExponentialIntegrator.hpp"
+#include "Core_tracing.hpp"
+#include <utility>
+#include <cmath>
+
+Integration::ParallelExponentialIntegrator::ParallelExponentialIntegrator(
+        const std::vector<Core::Particle *>& particles,
+        Integration::accelerationFctSingleStepType accelerationFunction,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(particles, ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        postTimestepFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{}
+
+Integration::ParallelExponentialIntegrator::ParallelExponentialIntegrator(
+        Integration::accelerationFctSingleStepType accelerationFunction,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        postTimestepFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{
+    initInternalState_();
+}
+
+/**
+ * Calculates the functions phi_1(z) = (1 - exp(-z)) / z and phi_2(z) = (1 - phi_1(z)) / z of the exponential
+ * integration scheme (with the limits phi_1(0) = 1, phi_2(0) = 1/2)
+ *
+ * @param z damping rate times time step length (non negative)
+ * @return {phi_1(z), phi_2(z)}
+ */
+std::array<double, 2> Integration::ParallelExponentialIntegrator::phiFunctions(double z) {
+    if (z < 1e-3){
+        // series expansions, avoids the cancellation for small z:
+        double phi1 = 1.0 - z/2.0 + z*z/6.0 - z*z*z/24.0;
+        double phi2 = 0.5 - z/6.0 + z*z/24.0 - z*z*z/120.0;
+        return {phi1, phi2};
+    }
+    double phi1 = -std::expm1(-z) / z;
+    return {phi1, (1.0 - phi1) / z};
+}
+
+/**
+ * Adds a particle to the integrator (required if particles are generated in the course of the simulation
+ * @param particle the particle to add to the integration
+ */
+void Integration::ParallelExponentialIntegrator::addParticle(Core::Particle *particle){
+    particles_.push_back(particle);
+    newPos_.emplace_back(Core::Vector(0,0,0));
+
+    tree_.insertParticle(*particle, nParticles_);
+    ++nParticles_;
+}
+
+void Integration::ParallelExponentialIntegrator::bearParticles_(double time) {
+    Integration::AbstractTimeIntegrator::bearParticles_(time);
+    initInternalState_();
+}
+
+void Integration::ParallelExponentialIntegrator::initInternalState_(){
+    tree_.init();
+}
+
+/**
+ * Runs the integration
+ * @param nTimesteps number of time steps to run
+ * @param dt time step length
+ */
+void Integration::ParallelExponentialIntegrator::run(unsigned int nTimesteps, double dt) {
+
+    // run init:
+    this->runState_ = RUNNING;
+    bearParticles_(0.0);
+
+    if (postTimestepFunction_ !=nullptr) {
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+
+    // run:
+    for (unsigned int step=0; step< nTimesteps; step++){
+        runSingleStep(dt);
+        if (this->runState_ == IN_TERMINATION){
+            break;
+        }
+    }
+    this->finalizeSimulation();
+    this->runState_ = STOPPED;
+}
+
+/**
+ * Runs a single step of the integration
+ * @param dt time step length
+ */
+void Integration::ParallelExponentialIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
+
+    //first: Generate new particles if necessary
+    bearParticles_(time_);
+
+    int ver=0;
+
+    if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
+        collisionModel_->updateModelTimestepParameters(timestep_, time_);
+    }
+
+    std::size_t i;
+    #pragma omp parallel \
+            default(none) shared(newPos_, dt, particles_) \
+            private(i)
+    {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
+
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
+        for (i=0; i<nParticles_; i++){
+            Core::Particle* particle = particles_[i];
+            if (particle->isActive()){
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->updateModelParticleParameters(*particle);
+                }
+
+                Core::Vector acceleration = accelerationFunction_(particle, i, tree_, time_, timestep_);
+
+                double dampingRate = 0.0;
+                Core::Vector gasVelocity(0.0, 0.0, 0.0);
+                if (collisionModel_ != nullptr) {
+                    dampingRate = collisionModel_->dragDampingRate(*particle);
+                    if (dampingRate > 0.0) {
+                        gasVelocity = collisionModel_->dragGasVelocity(*particle);
+                    }
+                    else {
+                        collisionModel_->modifyAcceleration(acceleration, *particle, dt);
+                    }
+                }
+
+                std::array<double, 2> phi = phiFunctions(dampingRate*dt);
+                Core::Vector relativeVelocity = particle->getVelocity() - gasVelocity;
+                newPos_[i] = particle->getLocation() + gasVelocity*dt
+                        + relativeVelocity*(dt*phi[0]) + acceleration*(dt*dt*phi[1]);
+                particle->setVelocity(
+                        gasVelocity + relativeVelocity*std::exp(-dampingRate*dt) + acceleration*(dt*phi[0]));
+
+                //velocity changes due to background interaction:
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->modifyVelocity(*particle, dt);
+                }
+            }
+        }
+    }
+
+    // First find all new positions, then perform otherActions then update tree.
+    // This ensures that all new particle positions are found with the state from
+    // last time step. No particle positions are found with a partly updated tree.
+    {
+        IDSIMF_TRACE_SCOPE("position update", "integration");
+        for (std::size_t j=0; j<nParticles_; j++){
+            if (particles_[j]->isActive()){
+                //position changes due to background interaction:
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->modifyPosition(newPos_[j], *(particles_[j]), dt);
+                }
+
+                if (otherActionsFunction_ != nullptr) {
+                    otherActionsFunction_(newPos_[j], particles_[j], j, time_, timestep_);
+                }
+                tree_.updateParticleLocation(j, newPos_[j], &ver);
+            }
+        }
+    }
+
+    // Update serialized tree structure:
+    {
+        IDSIMF_TRACE_SCOPE("tree update", "space charge");
+        tree_.updateNodes(ver);
+    }
+    time_ = time_ + dt;
+    timestep_++;
+    if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+}
+
+/**
+ * Finalizes the integration run (should be called after the last time step).
+ */
+void Integration::ParallelExponentialIntegrator::finalizeSimulation(){
+    if (postTimestepFunction_ != nullptr){
+        postTimestepFunction_(this, particles_, time_, timestep_, true);
+    }
+}
+
+/**
+ * Gets the memory used by the Barnes-Hut tree of the integrator
+ */
+std::size_t Integration::ParallelExponentialIntegrator::spaceChargeMemoryUsageBytes() const{
+    return tree_.memoryUsageBytes();
+}
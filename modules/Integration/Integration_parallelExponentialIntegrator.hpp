@@ -0,0 +1,113 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_parallelExponentialIntegrator.hpp
+
+ Parallel exponential trajectory integrator for strongly damped (drag dominated) particle motion
+
+ ****************************/
+
+#ifndef Integration_parallelExponentialIntegrator_hpp
+#define Integration_parallelExponentialIntegrator_hpp
+
+#include "Core_particle.hpp"
+#include "Core_vector.hpp"
+#include "BTree_parallelTree.hpp"
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "CollisionModel_AbstractCollisionModel.hpp"
+#include <vector>
+
+namespace Integration{
+
+    /**
+     * Ion trajectory integrator for strongly damped motion, which treats a linear drag exactly (exponential
+     * integrator). Space charge calculation with the parallel Barnes-Hut tree.
+     *
+     * The equation of motion of a particle with a linear drag towards the background gas velocity u is
+     *
+     *      dv/dt = a(x, t) - gamma (v - u)
+     *
+     * with the damping rate gamma (the inverse velocity relaxation time) and the acceleration a from fields and
+     * space charge. The drag is integrated analytically, while a, gamma and u are evaluated once per time step at
+     * the beginning of the step and are kept constant during the step:
+     *
+     *      v(t+dt) = u + exp(-gamma dt) (v - u) + dt phi_1(gamma dt) a
+     *      x(t+dt) = x + dt u + dt phi_1(gamma dt) (v - u) + dt^2 phi_2(gamma dt) a
+     *
+     * with phi_1(z) = (1 - exp(-z)) / z and phi_2(z) = (1 - phi_1(z)) / z. The scheme is stable for arbitrary
+     * damping rates and relaxes the velocity exactly to the drift velocity u + a / gamma, thus the time step is not
+     * limited by the velocity relaxation time (as in the explicit Verlet / Runge-Kutta integrators at high background
+     * gas pressures) but only by the variation of the fields. Without drag, the scheme is the explicit first order
+     * scheme with constant acceleration.
+     *
+     * The drag is taken from the collision model (AbstractCollisionModel::dragDampingRate / dragGasVelocity). For
+     * models with a continuous drag (e.g. the statistical diffusion model) the drag replaces modifyAcceleration of
+     * the model, for all other models modifyAcceleration is applied as in the other integrators. The velocity and
+     * position modifications of the collision models (e.g. diffusion jumps) are applied after every time step.
+     */
+    class ParallelExponentialIntegrator: public AbstractTimeIntegrator {
+
+        public:
+
+            ParallelExponentialIntegrator(
+                    const std::vector<Core::Particle*>& particles,
+                    accelerationFctSingleStepType accelerationFunction,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            ParallelExponentialIntegrator(
+                    accelerationFctSingleStepType accelerationFunction,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            [[nodiscard]] static std::array<double, 2> phiFunctions(double z);
+
+            void addParticle(Core::Particle* particle) override;
+            void run(unsigned int nTimesteps, double dt) override;
+            void runSingleStep(double dt) override;
+            void finalizeSimulation() override;
+            [[nodiscard]] std::size_t spaceChargeMemoryUsageBytes() const override;
+
+    private:
+
+        CollisionModel::AbstractCollisionModel* collisionModel_ = nullptr; ///< the gas collision model to perform while integrating
+
+        accelerationFctSingleStepType accelerationFunction_ = nullptr;   ///< function to calculate particle acceleration
+        postTimestepFctType postTimestepFunction_ = nullptr; ///< function to export / write time step results
+        otherActionsFctType otherActionsFunction_ = nullptr;   ///< function for arbitrary other actions in the simulation
+
+        //internal variables for actual calculations:
+        BTree::ParallelTree tree_; ///< The parallel BTree with dynamic domain (primarily for space charge calculation)
+
+        std::vector<Core::Vector>  newPos_;  ///< new position (after time step) for particles
+
+        void bearParticles_(double time);
+        void initInternalState_();
+    };
+}
+
+#endif /* Integration_parallelExponentialIntegrator_hpp */
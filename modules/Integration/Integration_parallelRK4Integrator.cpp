@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Integration_parallelRK4Integrator.hpp"
+#include "Core_tracing.hpp"
 #include <utility>
 #include <algorithm>
 
@@ -70,6 +71,17 @@ void Integration::ParallelRK4Integrator::addParticle(Core::Particle *particle){
     ++nParticles_;
 }
 
+/**
+ * Sets a static spatial domain for the space charge tree instead of the default dynamic domain, which is adapted
+ * to the particle cloud. All particles have to stay inside the static domain.
+ *
+ * @param min the lower corner of the domain
+ * @param max the upper corner of the domain
+ */
+void Integration::ParallelRK4Integrator::setStaticDomain(Core::Vector min, Core::Vector max) {
+    tree_.setStaticDomain(min, max);
+}
+
 void Integration::ParallelRK4Integrator::bearParticles_(double time) {
     Integration::AbstractTimeIntegrator::bearParticles_(time);
     initInternalState_();
@@ -101,6 +113,7 @@ void Integration::ParallelRK4Integrator::run(unsigned int nTimesteps, double dt)
 }
 
 void Integration::ParallelRK4Integrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
 
     //first: Generate new particles if necessary
     bearParticles_(time_);
@@ -108,6 +121,7 @@ void Integration::ParallelRK4Integrator::runSingleStep(double dt){
     int ver=0;
 
     if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
         collisionModel_->updateModelTimestepParameters(timestep_, time_);
     }
     std::size_t i;
@@ -115,8 +129,10 @@ void Integration::ParallelRK4Integrator::runSingleStep(double dt){
             default(none) shared(newPos_, spaceChargeAcceleration_, dt, particles_) \
             private(i)
     {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
 
-        #pragma omp for schedule(dynamic, 40)
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
         for (i=0; i<nParticles_; i++){
 
             if (particles_[i]->isActive()){
@@ -200,10 +216,14 @@ void Integration::ParallelRK4Integrator::runSingleStep(double dt){
     }
 
     // Update serialized tree structure:
-    tree_.updateNodes(ver);
+    {
+        IDSIMF_TRACE_SCOPE("tree update", "space charge");
+        tree_.updateNodes(ver);
+    }
     time_ = time_ + dt;
     timestep_++;
     if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
         postTimestepFunction_(this, particles_, time_, timestep_, false);
     }
 }
@@ -217,6 +237,13 @@ void Integration::ParallelRK4Integrator::finalizeSimulation(){
     }
 }
 
+/**
+ * Gets the memory used by the Barnes-Hut tree of the integrator
+ */
+std::size_t Integration::ParallelRK4Integrator::spaceChargeMemoryUsageBytes() const{
+    return tree_.memoryUsageBytes();
+}
+
 Core::Vector Integration::ParallelRK4Integrator::evaluateAccelerationFunction_(Core::Particle* particle,
                                                                                Core::Vector position,
                                                                                Core::Vector velocity,
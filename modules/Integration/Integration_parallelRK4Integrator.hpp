@@ -62,9 +62,11 @@ namespace Integration{
             );
 
             void addParticle(Core::Particle* particle) override;
+            void setStaticDomain(Core::Vector min, Core::Vector max);
             void run(unsigned int nTimesteps, double dt) override;
             void runSingleStep(double dt) override;
             void finalizeSimulation() override;
+            [[nodiscard]] std::size_t spaceChargeMemoryUsageBytes() const override;
 
     private:
 
@@ -84,9 +86,7 @@ namespace Integration{
                                                    double dt);
 
         //internal variables for actual calculations:
-        Core::Vector loc_min_ = Core::Vector(-1000,-1000,-1000); ///< currently hard coded lower corner of the sim. domain
-        Core::Vector loc_max_ = Core::Vector( 1000, 1000, 1000); ///< currently hard coded upper corner of the sim. domain
-        BTree::ParallelTree tree_ = BTree::ParallelTree(loc_min_,loc_max_);///< The parallel BTree (primarily for space charge calculation)
+        BTree::ParallelTree tree_; ///< The parallel BTree with dynamic domain (primarily for space charge calculation)
 
         std::vector<Core::Vector>  newPos_;  ///< new position (after time step) for particles
         std::vector<Core::Vector>  spaceChargeAcceleration_;  ///< space charge acceleration from
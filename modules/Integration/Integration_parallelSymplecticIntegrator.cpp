@@ -0,0 +1,246 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_parallelSymplecticIntegrator.hpp"
+#include "Core_tracing.hpp"
+#include <utility>
+#include <cmath>
+
+Integration::ParallelSymplecticIntegrator::ParallelSymplecticIntegrator(
+        const std::vector<Core::Particle *>& particles,
+        Integration::accelerationFctType accelerationFunction,
+        Integration::accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+        Order order,
+        Integration::postTimestepFctType timestepWriteFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(particles, ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        spaceChargeAccelerationFunction_(std::move(spaceChargeAccelerationFunction)),
+        postTimestepFunction_(std::move(timestepWriteFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction)),
+        weights_(compositionWeights(order))
+{}
+
+Integration::ParallelSymplecticIntegrator::ParallelSymplecticIntegrator(
+        Integration::accelerationFctType accelerationFunction,
+        Integration::accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+        Order order,
+        Integration::postTimestepFctType timestepWriteFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        accelerationFunction_(std::move(accelerationFunction)),
+        spaceChargeAccelerationFunction_(std::move(spaceChargeAccelerationFunction)),
+        postTimestepFunction_(std::move(timestepWriteFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction)),
+        weights_(compositionWeights(order))
+{
+    initInternalState_();
+}
+
+/**
+ * Gets the relative lengths of the Verlet substeps of a composition scheme (the weights sum up to one)
+ *
+ * @param order the order of the composition scheme
+ * @return the weights of the substeps, in the order of their execution
+ */
+std::vector<double> Integration::ParallelSymplecticIntegrator::compositionWeights(Order order) {
+    if (order == FOURTH_ORDER){
+        // Forest-Ruth / Yoshida triple jump:
+        double w1 = 1.0 / (2.0 - std::cbrt(2.0));
+        double w0 = 1.0 - 2.0*w1;
+        return {w1, w0, w1};
+    }
+    else {
+        // Yoshida 1990, solution A:
+        double w1 = -1.17767998417887;
+        double w2 = 0.235573213359357;
+        double w3 = 0.784513610477560;
+        double w0 = 1.0 - 2.0*(w1 + w2 + w3);
+        return {w3, w2, w1, w0, w1, w2, w3};
+    }
+}
+
+/**
+ * Adds a particle to the integrator (required if particles are generated in the course of the simulation
+ * @param particle the particle to add to the integration
+ */
+void Integration::ParallelSymplecticIntegrator::addParticle(Core::Particle *particle){
+    particles_.push_back(particle);
+    newPos_.emplace_back(Core::Vector(0,0,0));
+
+    tree_.insertParticle(*particle, nParticles_);
+    ++nParticles_;
+}
+
+void Integration::ParallelSymplecticIntegrator::bearParticles_(double time) {
+    Integration::AbstractTimeIntegrator::bearParticles_(time);
+    initInternalState_();
+}
+
+void Integration::ParallelSymplecticIntegrator::initInternalState_(){
+    tree_.init();
+}
+
+/**
+ * Runs the integration
+ * @param nTimesteps number of time steps to run
+ * @param dt time step length
+ */
+void Integration::ParallelSymplecticIntegrator::run(unsigned int nTimesteps, double dt) {
+
+    // run init:
+    this->runState_ = RUNNING;
+    bearParticles_(0.0);
+
+    if (postTimestepFunction_ !=nullptr) {
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+
+    // run:
+    for (unsigned int step=0; step< nTimesteps; step++){
+        runSingleStep(dt);
+        if (this->runState_ == IN_TERMINATION){
+            break;
+        }
+    }
+    this->finalizeSimulation();
+    this->runState_ = STOPPED;
+}
+
+/**
+ * Runs a single step of the integration
+ * @param dt time step length
+ */
+void Integration::ParallelSymplecticIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
+
+    //first: Generate new particles if necessary
+    bearParticles_(time_);
+
+    int ver=0;
+
+    if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
+        collisionModel_->updateModelTimestepParameters(timestep_, time_);
+    }
+    std::size_t i;
+    #pragma omp parallel \
+            default(none) shared(newPos_, weights_, dt, particles_) \
+            private(i)
+    {
+        IDSIMF_TRACE_SCOPE("particle update", "integration");
+
+        // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+        #pragma omp for schedule(dynamic, 40) nowait
+        for (i=0; i<nParticles_; i++){
+            Core::Particle* particle = particles_[i];
+            if (particle->isActive()){
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->updateModelParticleParameters(*particle);
+                }
+
+                Core::Vector spaceChargeAcceleration =
+                        spaceChargeAccelerationFunction_(particle, i, tree_, time_, timestep_);
+
+                // composition of drift - kick - drift (position Verlet) substeps:
+                Core::Vector x = particle->getLocation();
+                Core::Vector v = particle->getVelocity();
+                double t = time_;
+                for (double weight: weights_){
+                    double h = weight*dt;
+                    x = x + v*(0.5*h);
+                    t += 0.5*h;
+
+                    Core::Vector acceleration =
+                            accelerationFunction_(particle, x, v, t, timestep_) + spaceChargeAcceleration;
+                    if (collisionModel_ != nullptr) {
+                        collisionModel_->modifyAcceleration(acceleration, *particle, dt);
+                    }
+                    v = v + acceleration*h;
+
+                    x = x + v*(0.5*h);
+                    t += 0.5*h;
+                }
+
+                newPos_[i] = x;
+                particle->setVelocity(v);
+                //velocity changes due to background interaction:
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->modifyVelocity(*particle, dt);
+                }
+            }
+        }
+    }
+
+    // First find all new positions, then perform otherActions then update tree.
+    // This ensures that all new particle positions are found with the state from
+    // last time step. No particle positions are found with a partly updated tree.
+    {
+        IDSIMF_TRACE_SCOPE("position update", "integration");
+        for (std::size_t j=0; j<nParticles_; j++){
+            if (particles_[j]->isActive()){
+                //position changes due to background interaction:
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->modifyPosition(newPos_[j], *(particles_[j]), dt);
+                }
+
+                if (otherActionsFunction_ != nullptr) {
+                    otherActionsFunction_(newPos_[j], particles_[j], j, time_, timestep_);
+                }
+                tree_.updateParticleLocation(j, newPos_[j], &ver);
+            }
+        }
+    }
+
+    // Update serialized tree structure:
+    {
+        IDSIMF_TRACE_SCOPE("tree update", "space charge");
+        tree_.updateNodes(ver);
+    }
+    time_ = time_ + dt;
+    timestep_++;
+    if (postTimestepFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
+        postTimestepFunction_(this, particles_, time_, timestep_, false);
+    }
+}
+
+/**
+ * Finalizes the integration run (should be called after the last time step).
+ */
+void Integration::ParallelSymplecticIntegrator::finalizeSimulation(){
+    if (postTimestepFunction_ != nullptr){
+        postTimestepFunction_(this, particles_, time_, timestep_, true);
+    }
+}
+
+/**
+ * Gets the memory used by the Barnes-Hut tree of the integrator
+ */
+std::size_t Integration::ParallelSymplecticIntegrator::spaceChargeMemoryUsageBytes() const{
+    return tree_.memoryUsageBytes();
+}
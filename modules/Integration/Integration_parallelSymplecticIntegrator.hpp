@@ -0,0 +1,118 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_parallelSymplecticIntegrator.hpp
+
+ Parallel higher order (fourth and sixth order) symplectic composition integrator with Barnes-Hut tree based
+ space charge calculation
+
+ ****************************/
+
+#ifndef Integration_parallelSymplecticIntegrator_hpp
+#define Integration_parallelSymplecticIntegrator_hpp
+
+#include "Core_particle.hpp"
+#include "Core_vector.hpp"
+#include "BTree_parallelTree.hpp"
+#include "Integration_abstractTimeIntegrator.hpp"
+#include "CollisionModel_AbstractCollisionModel.hpp"
+#include <vector>
+
+namespace Integration{
+
+    /**
+     * Ion trajectory integrator with a higher order symplectic composition scheme (Yoshida / Forest-Ruth type).
+     *
+     * A time step is composed of several position Verlet (drift - kick - drift) substeps with weighted substep
+     * lengths: The fourth order scheme (Forest-Ruth, Yoshida triple jump) has three substeps, the sixth order scheme
+     * (Yoshida, solution A) has seven substeps, thus three or seven evaluations of the external acceleration are
+     * performed per time step. The schemes are time reversible and symplectic for position dependent forces, therefore
+     * the energy error stays bounded and the phase error grows only linearly over long collision free runs
+     * (e.g. storage in ion traps), which allows several times larger time steps than the (second order) Verlet
+     * integrators for a given accuracy. The time is treated as a coordinate, which advances with the drifts, thus
+     * explicitly time dependent fields (RF) are integrated consistently.
+     *
+     * The external acceleration and the space charge acceleration are given as separate functions (as for the
+     * Runge-Kutta integrators). The space charge acceleration is evaluated once per time step with a Barnes-Hut
+     * tree and is kept constant during the substeps, thus the higher order applies to the external fields.
+     * Collision models are supported as in the other integrators, but random collisions destroy the symplectic
+     * property.
+     */
+    class ParallelSymplecticIntegrator: public AbstractTimeIntegrator {
+
+        public:
+
+            /**
+             * Order of the composition scheme
+             */
+            enum Order {FOURTH_ORDER, SIXTH_ORDER};
+
+            ParallelSymplecticIntegrator(
+                    const std::vector<Core::Particle*>& particles,
+                    accelerationFctType accelerationFunction,
+                    accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+                    Order order = FOURTH_ORDER,
+                    postTimestepFctType timestepWriteFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            ParallelSymplecticIntegrator(
+                    accelerationFctType accelerationFunction,
+                    accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+                    Order order = FOURTH_ORDER,
+                    postTimestepFctType timestepWriteFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            [[nodiscard]] static std::vector<double> compositionWeights(Order order);
+
+            void addParticle(Core::Particle* particle) override;
+            void run(unsigned int nTimesteps, double dt) override;
+            void runSingleStep(double dt) override;
+            void finalizeSimulation() override;
+            [[nodiscard]] std::size_t spaceChargeMemoryUsageBytes() const override;
+
+    private:
+
+        CollisionModel::AbstractCollisionModel* collisionModel_ = nullptr; ///< the gas collision model to perform while integrating
+
+        accelerationFctType accelerationFunction_ = nullptr;   ///< function to calculate particle acceleration (without space charge)
+        accelerationFctSpaceChargeType spaceChargeAccelerationFunction_ = nullptr;   ///< function to calculate particle acceleration from space charge
+        postTimestepFctType postTimestepFunction_ = nullptr; ///< function to export / write time step results
+        otherActionsFctType otherActionsFunction_ = nullptr;   ///< function for arbitrary other actions in the simulation
+
+        std::vector<double> weights_; ///< relative lengths of the Verlet substeps of the composition scheme
+
+        //internal variables for actual calculations:
+        BTree::ParallelTree tree_; ///< The parallel BTree with dynamic domain (primarily for space charge calculation)
+
+        std::vector<Core::Vector>  newPos_;  ///< new position (after time step) for particles
+
+        void bearParticles_(double time);
+        void initInternalState_();
+    };
+}
+
+#endif /* Integration_parallelSymplecticIntegrator_hpp */
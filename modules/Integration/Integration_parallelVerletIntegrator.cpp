@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Integration_parallelVerletIntegrator.hpp"
+#include "Core_tracing.hpp"
 #include <utility>
 #include <algorithm>
 
@@ -52,6 +53,46 @@ Integration::ParallelVerletIntegrator::ParallelVerletIntegrator(
     initInternalState_();
 }
 
+Integration::ParallelVerletIntegrator::ParallelVerletIntegrator(
+        const std::vector<Core::Particle *>& particles,
+        Integration::accelerationFctType accelerationFunction,
+        Integration::accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(particles, ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        externalAccelerationFunction_(std::move(accelerationFunction)),
+        spaceChargeAccelerationFunction_(std::move(spaceChargeAccelerationFunction)),
+        postTimestepWriteFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{}
+
+Integration::ParallelVerletIntegrator::ParallelVerletIntegrator(
+        Integration::accelerationFctType accelerationFunction,
+        Integration::accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+        Integration::postTimestepFctType postTimestepFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        Integration::AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel) :
+        AbstractTimeIntegrator(ionStartMonitoringFunction),
+        collisionModel_(collisionModel),
+        externalAccelerationFunction_(std::move(accelerationFunction)),
+        spaceChargeAccelerationFunction_(std::move(spaceChargeAccelerationFunction)),
+        postTimestepWriteFunction_(std::move(postTimestepFunction)),
+        otherActionsFunction_(std::move(otherActionsFunction))
+{
+    initInternalState_();
+}
+
+/**
+ * Returns true if the integrator runs in overlapped mode (separate external and space charge acceleration
+ * functions, which are evaluated concurrently)
+ */
+bool Integration::ParallelVerletIntegrator::isOverlapped() const {
+    return spaceChargeAccelerationFunction_ != nullptr;
+}
 
 /**
  * Adds a particle to the verlet integrator (required if particles are generated in the course of the simulation
@@ -62,11 +103,24 @@ void Integration::ParallelVerletIntegrator::addParticle(Core::Particle *particle
     newPos_.emplace_back(Core::Vector(0,0,0));
     a_t_.emplace_back(Core::Vector(0,0,0));
     a_tdt_.emplace_back(Core::Vector(0,0,0));
+    a_ext_.emplace_back(Core::Vector(0,0,0));
+    a_sc_.emplace_back(Core::Vector(0,0,0));
 
     tree_.insertParticle(*particle, nParticles_);
     ++nParticles_;
 }
 
+/**
+ * Sets a static spatial domain for the space charge tree instead of the default dynamic domain, which is adapted
+ * to the particle cloud. All particles have to stay inside the static domain.
+ *
+ * @param min the lower corner of the domain
+ * @param max the upper corner of the domain
+ */
+void Integration::ParallelVerletIntegrator::setStaticDomain(Core::Vector min, Core::Vector max) {
+    tree_.setStaticDomain(min, max);
+}
+
 void Integration::ParallelVerletIntegrator::bearParticles_(double time) {
     Integration::AbstractTimeIntegrator::bearParticles_(time);
     initInternalState_();
@@ -107,6 +161,7 @@ void Integration::ParallelVerletIntegrator::run(unsigned int nTimesteps, double
  * @param dt time step length
  */
 void Integration::ParallelVerletIntegrator::runSingleStep(double dt){
+    IDSIMF_TRACE_SCOPE("time step", "integration");
 
     //std::cout << "runSingleStep "<<dt<<" "<<time_<<std::endl;
     //first: Generate new particles if necessary
@@ -122,39 +177,48 @@ void Integration::ParallelVerletIntegrator::runSingleStep(double dt){
     //
 
     if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
         collisionModel_->updateModelTimestepParameters(timestep_, time_);
     }
-    std::size_t i;
-    #pragma omp parallel \
-            default(none) shared(newPos_, a_tdt_, a_t_, dt, particles_) \
-            private(i) //firstprivate(MyNod)
-    {
-
-        #pragma omp for schedule(dynamic, 40)
-        for (i=0; i<nParticles_; i++){
-
-            if (particles_[i]->isActive()){
-
-                if (collisionModel_ != nullptr) {
-                    collisionModel_->updateModelParticleParameters(*(particles_[i]));
-                }
 
-                newPos_[i] = particles_[i]->getLocation() + particles_[i]->getVelocity() * dt + a_t_[i]*(1.0/2.0*dt*dt);
-                a_tdt_[i] = accelerationFunction_(particles_[i], i, tree_, time_, timestep_);
-                //acceleration changes due to background interaction:
-
-                if (collisionModel_ != nullptr) {
-                    collisionModel_->modifyAcceleration(a_tdt_[i], *(particles_[i]), dt);
-                }
-
-                particles_[i]->setVelocity( particles_[i]->getVelocity() + ((a_t_[i]+ a_tdt_[i])*1.0/2.0 *dt) );
-                a_t_[i] = a_tdt_[i];
-
-                //velocity changes due to background interaction:
-                if (collisionModel_ != nullptr) {
-                    //std::cout << "before:" << particles_[i]->getVelocity() << std::endl;
-                    collisionModel_->modifyVelocity(*(particles_[i]),dt);
-                    //std::cout << "after:" << particles_[i]->getVelocity() << std::endl;
+    if (isOverlapped()){
+        evaluateAccelerationsOverlapped_(dt);
+    }
+    else {
+        std::size_t i;
+        #pragma omp parallel \
+                default(none) shared(newPos_, a_tdt_, a_t_, dt, particles_) \
+                private(i) //firstprivate(MyNod)
+        {
+            IDSIMF_TRACE_SCOPE("particle update", "integration");
+
+            // no barrier at the end of the loop: the parallel region ends with a barrier anyway
+            #pragma omp for schedule(dynamic, 40) nowait
+            for (i=0; i<nParticles_; i++){
+
+                if (particles_[i]->isActive()){
+
+                    if (collisionModel_ != nullptr) {
+                        collisionModel_->updateModelParticleParameters(*(particles_[i]));
+                    }
+
+                    newPos_[i] = particles_[i]->getLocation() + particles_[i]->getVelocity() * dt + a_t_[i]*(1.0/2.0*dt*dt);
+                    a_tdt_[i] = accelerationFunction_(particles_[i], i, tree_, time_, timestep_);
+                    //acceleration changes due to background interaction:
+
+                    if (collisionModel_ != nullptr) {
+                        collisionModel_->modifyAcceleration(a_tdt_[i], *(particles_[i]), dt);
+                    }
+
+                    particles_[i]->setVelocity( particles_[i]->getVelocity() + ((a_t_[i]+ a_tdt_[i])*1.0/2.0 *dt) );
+                    a_t_[i] = a_tdt_[i];
+
+                    //velocity changes due to background interaction:
+                    if (collisionModel_ != nullptr) {
+                        //std::cout << "before:" << particles_[i]->getVelocity() << std::endl;
+                        collisionModel_->modifyVelocity(*(particles_[i]),dt);
+                        //std::cout << "after:" << particles_[i]->getVelocity() << std::endl;
+                    }
                 }
             }
         }
@@ -164,25 +228,32 @@ void Integration::ParallelVerletIntegrator::runSingleStep(double dt){
     // This ensures that all new particle positions are found with the state from
     // last time step. No particle positions are found with a partly updated tree.
     // Additionally, the update step is not (yet) parallel.
-    for (std::size_t i=0; i<nParticles_; i++){
-        if (particles_[i]->isActive()){
-            //position changes due to background interaction:
-            if (collisionModel_ != nullptr) {
-                collisionModel_->modifyPosition(newPos_[i], *(particles_[i]), dt);
-            }
+    {
+        IDSIMF_TRACE_SCOPE("position update", "integration");
+        for (std::size_t i=0; i<nParticles_; i++){
+            if (particles_[i]->isActive()){
+                //position changes due to background interaction:
+                if (collisionModel_ != nullptr) {
+                    collisionModel_->modifyPosition(newPos_[i], *(particles_[i]), dt);
+                }
 
-            if (otherActionsFunction_ != nullptr) {
-                otherActionsFunction_(newPos_[i], particles_[i], i, time_, timestep_);
+                if (otherActionsFunction_ != nullptr) {
+                    otherActionsFunction_(newPos_[i], particles_[i], i, time_, timestep_);
+                }
+                tree_.updateParticleLocation(i, newPos_[i], &ver);
             }
-            tree_.updateParticleLocation(i, newPos_[i], &ver);
         }
     }
 
     // Update serialized tree structure:
-    tree_.updateNodes(ver);
+    {
+        IDSIMF_TRACE_SCOPE("tree update", "space charge");
+        tree_.updateNodes(ver);
+    }
     time_ = time_ + dt;
     timestep_++;
     if (postTimestepWriteFunction_ != nullptr) {
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
         postTimestepWriteFunction_(this, particles_, time_, timestep_, false);
     }
 }
@@ -196,4 +267,104 @@ void Integration::ParallelVerletIntegrator::finalizeSimulation(){
     }
 }
 
+/**
+ * Gets the memory used by the Barnes-Hut tree of the integrator
+ */
+std::size_t Integration::ParallelVerletIntegrator::spaceChargeMemoryUsageBytes() const{
+    return tree_.memoryUsageBytes();
+}
+
+
+
+/**
+ * Evaluates the accelerations and updates the particle velocities in overlapped mode: For every chunk of particles,
+ * a space charge task, an external acceleration task and a velocity update task, which depends on the two former
+ * tasks, is created. Space charge tasks are prioritized since they are typically the most expensive ones.
+ * Thus, the evaluation of the space charge and the external accelerations and collision actions of different chunks
+ * overlap.
+ *
+ * @param dt time step length
+ */
+void Integration::ParallelVerletIntegrator::evaluateAccelerationsOverlapped_(double dt) {
+    std::size_t nChunks = (nParticles_ + OVERLAP_CHUNK_SIZE - 1) / OVERLAP_CHUNK_SIZE;
+
+    // tokens for the dependencies between the tasks of the individual chunks:
+    std::vector<char> scTokens(nChunks, 0);
+    std::vector<char> extTokens(nChunks, 0);
+
+    #pragma omp parallel default(shared)
+    {
+        #pragma omp single
+        {
+            for (std::size_t chunk=0; chunk<nChunks; ++chunk){
+                std::size_t iBegin = chunk * OVERLAP_CHUNK_SIZE;
+                std::size_t iEnd = std::min(iBegin + OVERLAP_CHUNK_SIZE, nParticles_);
+
+                #pragma omp task firstprivate(iBegin, iEnd) depend(out: scTokens.data()[chunk]) priority(1)
+                evaluateSpaceChargeChunk_(iBegin, iEnd);
+
+                #pragma omp task firstprivate(iBegin, iEnd, dt) depend(out: extTokens.data()[chunk])
+                evaluateExternalChunk_(iBegin, iEnd, dt);
+
+                #pragma omp task firstprivate(iBegin, iEnd, dt) depend(in: scTokens.data()[chunk], extTokens.data()[chunk])
+                updateVelocitiesChunk_(iBegin, iEnd, dt);
+            }
+        }
+    }
+}
+
+/**
+ * Evaluates the space charge acceleration for a chunk of particles
+ */
+void Integration::ParallelVerletIntegrator::evaluateSpaceChargeChunk_(std::size_t iBegin, std::size_t iEnd) {
+    IDSIMF_TRACE_SCOPE("space charge chunk", "space charge");
+    for (std::size_t i=iBegin; i<iEnd; ++i){
+        if (particles_[i]->isActive()){
+            a_sc_[i] = spaceChargeAccelerationFunction_(particles_[i], i, tree_, time_, timestep_);
+        }
+    }
+}
 
+/**
+ * Evaluates the new particle positions and the external (non space charge) acceleration for a chunk of particles
+ */
+void Integration::ParallelVerletIntegrator::evaluateExternalChunk_(std::size_t iBegin, std::size_t iEnd, double dt) {
+    IDSIMF_TRACE_SCOPE("external acceleration chunk", "integration");
+    for (std::size_t i=iBegin; i<iEnd; ++i){
+        Core::Particle* particle = particles_[i];
+        if (particle->isActive()){
+            if (collisionModel_ != nullptr) {
+                collisionModel_->updateModelParticleParameters(*particle);
+            }
+            newPos_[i] = particle->getLocation() + particle->getVelocity() * dt + a_t_[i]*(1.0/2.0*dt*dt);
+            a_ext_[i] = externalAccelerationFunction_(
+                    particle, particle->getLocation(), particle->getVelocity(), time_, timestep_);
+        }
+    }
+}
+
+/**
+ * Merges the external and space charge accelerations and updates the velocities for a chunk of particles
+ */
+void Integration::ParallelVerletIntegrator::updateVelocitiesChunk_(std::size_t iBegin, std::size_t iEnd, double dt) {
+    IDSIMF_TRACE_SCOPE("velocity update chunk", "integration");
+    for (std::size_t i=iBegin; i<iEnd; ++i){
+        Core::Particle* particle = particles_[i];
+        if (particle->isActive()){
+            a_tdt_[i] = a_ext_[i] + a_sc_[i];
+
+            //acceleration changes due to background interaction:
+            if (collisionModel_ != nullptr) {
+                collisionModel_->modifyAcceleration(a_tdt_[i], *particle, dt);
+            }
+
+            particle->setVelocity( particle->getVelocity() + ((a_t_[i]+ a_tdt_[i])*1.0/2.0 *dt) );
+            a_t_[i] = a_tdt_[i];
+
+            //velocity changes due to background interaction:
+            if (collisionModel_ != nullptr) {
+                collisionModel_->modifyVelocity(*particle, dt);
+            }
+        }
+    }
+}
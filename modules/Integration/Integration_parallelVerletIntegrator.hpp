@@ -33,6 +33,7 @@
 
 #include "Core_particle.hpp"
 #include "Core_vector.hpp"
+#include "Core_hugePageAllocator.hpp"
 #include "BTree_parallelTree.hpp"
 #include "Integration_abstractTimeIntegrator.hpp"
 #include "CollisionModel_AbstractCollisionModel.hpp"
@@ -46,6 +47,12 @@ namespace Integration{
      *
      * The acceleration calculation and additional actions performed is passed to this trajectory integrator externally
      * by functions. Thus, the integration scheme can be applied to arbitrary simulation problems.
+     *
+     * If the acceleration is given as separate external and space charge acceleration functions, the integrator runs
+     * in an overlapped mode: The space charge evaluation and the external field evaluation are performed as independent
+     * tasks on chunks of particles, which are executed concurrently by the thread team. The velocity update and the
+     * collision model actions for a chunk are performed as soon as both accelerations of the chunk are available,
+     * thus the threads do not idle at a barrier between the evaluation phases.
      */
     class ParallelVerletIntegrator: public AbstractTimeIntegrator {
 
@@ -68,29 +75,60 @@ namespace Integration{
                     CollisionModel::AbstractCollisionModel* collisionModel = nullptr
             );
 
+            ParallelVerletIntegrator(
+                    const std::vector<Core::Particle*>& particles,
+                    accelerationFctType accelerationFunction,
+                    accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            ParallelVerletIntegrator(
+                    accelerationFctType accelerationFunction,
+                    accelerationFctSpaceChargeType spaceChargeAccelerationFunction,
+                    postTimestepFctType postTimestepFunction = nullptr,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    AbstractTimeIntegrator::particleStartMonitoringFctType ionStartMonitoringFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            [[nodiscard]] bool isOverlapped() const;
             void addParticle(Core::Particle* particle) override;
+            void setStaticDomain(Core::Vector min, Core::Vector max);
             void run(unsigned int nTimesteps, double dt) override;
             void runSingleStep(double dt) override;
             void finalizeSimulation() override;
+            [[nodiscard]] std::size_t spaceChargeMemoryUsageBytes() const override;
 
     private:
 
+        using particleVectorArray_t = Core::hugePageVector<Core::Vector, Core::HugePageSubsystem::PARTICLES>;
+
         CollisionModel::AbstractCollisionModel* collisionModel_ = nullptr; ///< the gas collision model to perform while integrating
 
+        static constexpr std::size_t OVERLAP_CHUNK_SIZE = 40; ///< Number of particles per task in overlapped mode
+
         accelerationFctSingleStepType accelerationFunction_ = nullptr;   ///< function to calculate particle acceleration
+        accelerationFctType externalAccelerationFunction_ = nullptr; ///< function to calculate particle acceleration without space charge (overlapped mode)
+        accelerationFctSpaceChargeType spaceChargeAccelerationFunction_ = nullptr; ///< function to calculate particle acceleration from space charge (overlapped mode)
         postTimestepFctType postTimestepWriteFunction_ = nullptr; ///< function to export / write time step results
         otherActionsFctType otherActionsFunction_ = nullptr;   ///< function for arbitrary other actions in the simulation
 
         //internal variables for actual calculations:
-        Core::Vector loc_min_ = Core::Vector(-1000,-1000,-1000); ///< currently hard coded lower corner of the sim. domain
-        Core::Vector loc_max_ = Core::Vector( 1000, 1000, 1000); ///< currently hard coded upper corner of the sim. domain
-        BTree::ParallelTree tree_ = BTree::ParallelTree(loc_min_,loc_max_);
-        ///< The parallel BTree (primarily for space charge calculation)
-
-        std::vector<Core::Vector>  newPos_;  ///< new position (after time step) for particles
-        std::vector<Core::Vector>  a_t_;     ///< last time step acceleration for particles
-        std::vector<Core::Vector>  a_tdt_;   ///< new acceleration for particles
-
+        BTree::ParallelTree tree_; ///< The parallel BTree with dynamic domain (primarily for space charge calculation)
+
+        particleVectorArray_t newPos_;  ///< new position (after time step) for particles
+        particleVectorArray_t a_t_;     ///< last time step acceleration for particles
+        particleVectorArray_t a_tdt_;   ///< new acceleration for particles
+        particleVectorArray_t a_ext_;   ///< new acceleration without space charge (overlapped mode)
+        particleVectorArray_t a_sc_;    ///< new acceleration from space charge (overlapped mode)
+
+        void evaluateAccelerationsOverlapped_(double dt);
+        void evaluateSpaceChargeChunk_(std::size_t iBegin, std::size_t iEnd);
+        void evaluateExternalChunk_(std::size_t iBegin, std::size_t iEnd, double dt);
+        void updateVelocitiesChunk_(std::size_t iBegin, std::size_t iEnd, double dt);
         void bearParticles_(double time);
         void initInternalState_();
     };
@@ -0,0 +1,174 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "Integration_steadyStateBeamIntegrator.hpp"
+#include "Core_tracing.hpp"
+#include <stdexcept>
+
+/**
+ * Constructs a steady state beam integrator
+ *
+ * @param particles the particles of the representative trajectories (their current location, velocity and time of
+ * birth define the start of the trajectories)
+ * @param currents beam currents (A) carried by the individual trajectories
+ * @param solver the steady state space charge solver
+ * @param accelerationFunction function to calculate the acceleration of the particles, the solver is passed as
+ * space charge field calculator
+ * @param otherActionsFunction function for other actions in every time step, deactivates particles to end their
+ * trajectories
+ * @param collisionModel the gas collision model (can be nullptr)
+ */
+Integration::SteadyStateBeamIntegrator::SteadyStateBeamIntegrator(
+        const std::vector<Core::Particle*>& particles,
+        const std::vector<double>& currents,
+        SpaceCharge::SteadyStateBeamSolver& solver,
+        Integration::accelerationFctSingleStepType accelerationFunction,
+        Integration::otherActionsFctType otherActionsFunction,
+        CollisionModel::AbstractCollisionModel* collisionModel):
+particles_(particles),
+currents_(currents),
+solver_(solver),
+accelerationFunction_(std::move(accelerationFunction)),
+otherActionsFunction_(std::move(otherActionsFunction)),
+collisionModel_(collisionModel)
+{
+    if (currents_.size() != particles_.size()){
+        throw (std::invalid_argument("Number of trajectory currents does not match the number of particles"));
+    }
+    for (Core::Particle* particle: particles_){
+        startLocations_.push_back(particle->getLocation());
+        startVelocities_.push_back(particle->getVelocity());
+        startTimes_.push_back(particle->getTimeOfBirth());
+    }
+    a_t_.resize(particles_.size(), Core::Vector(0.0, 0.0, 0.0));
+}
+
+/**
+ * Iterates tracing of the trajectories and updates of the space charge field until the charge density is self
+ * consistent
+ *
+ * @param maxIterations maximum number of iterations
+ * @param tolerance the iteration stops if the self consistency residual of the solver is below the tolerance
+ * @param dt time step length
+ * @param maxTimesteps maximum number of time steps of a trajectory
+ * @return the number of iterations performed in this call (the residuals of all iterations are accumulated, see
+ * getResiduals)
+ */
+std::size_t Integration::SteadyStateBeamIntegrator::run(unsigned int maxIterations, double tolerance, double dt,
+                                                       unsigned int maxTimesteps) {
+    std::size_t nIterations = 0;
+    for (unsigned int iteration=0; iteration<maxIterations; ++iteration){
+        traceTrajectories(dt, maxTimesteps);
+        double residual;
+        {
+            IDSIMF_TRACE_SCOPE("steady state field update", "space charge");
+            residual = solver_.updateField();
+        }
+        residuals_.push_back(residual);
+        ++nIterations;
+        if (residual < tolerance){
+            break;
+        }
+    }
+    return nIterations;
+}
+
+/**
+ * Traces all trajectories with the current space charge field of the solver and deposits their charge in the solver
+ *
+ * @param dt time step length
+ * @param maxTimesteps maximum number of time steps of a trajectory
+ * @param traceStepFunction function called after every time step (can be nullptr)
+ * @param depositCharge if false, the trajectories are traced without deposition of charge in the solver (e.g. for
+ * an output only tracing of the trajectories with the final field)
+ */
+void Integration::SteadyStateBeamIntegrator::traceTrajectories(double dt, unsigned int maxTimesteps,
+                                                               const traceStepFctType& traceStepFunction,
+                                                               bool depositCharge) {
+    std::size_t nParticles = particles_.size();
+    for (std::size_t i=0; i<nParticles; ++i){
+        particles_[i]->setLocation(startLocations_[i]);
+        particles_[i]->setVelocity(startVelocities_[i]);
+        particles_[i]->setActive(true);
+        particles_[i]->setInvalid(false);
+        a_t_[i] = Core::Vector(0.0, 0.0, 0.0);
+    }
+
+    for (unsigned int timestep=0; timestep<maxTimesteps; ++timestep){
+        if (collisionModel_ != nullptr){
+            collisionModel_->updateModelTimestepParameters(timestep, dt*timestep);
+        }
+
+        std::size_t nActive = 0;
+        {
+            IDSIMF_TRACE_SCOPE("steady state trajectory step", "integration");
+            #pragma omp parallel for default(none) shared(nParticles, dt, timestep, depositCharge) \
+                    reduction(+:nActive) schedule(dynamic, 40)
+            for (std::size_t i=0; i<nParticles; ++i){
+                Core::Particle* particle = particles_[i];
+                if (!particle->isActive()){
+                    continue;
+                }
+                double time = startTimes_[i] + dt*timestep;
+                if (depositCharge){
+                    solver_.depositCharge(particle->getLocation(), currents_[i]*dt);
+                }
+
+                if (collisionModel_ != nullptr){
+                    collisionModel_->updateModelParticleParameters(*particle);
+                }
+                Core::Vector newPos = particle->getLocation() + particle->getVelocity()*dt + a_t_[i]*(0.5*dt*dt);
+                Core::Vector a_tdt = accelerationFunction_(particle, i, solver_, time, timestep);
+                if (collisionModel_ != nullptr){
+                    collisionModel_->modifyAcceleration(a_tdt, *particle, dt);
+                }
+                particle->setVelocity(particle->getVelocity() + (a_t_[i] + a_tdt)*(0.5*dt));
+                a_t_[i] = a_tdt;
+                if (collisionModel_ != nullptr){
+                    collisionModel_->modifyVelocity(*particle, dt);
+                    collisionModel_->modifyPosition(newPos, *particle, dt);
+                }
+                if (otherActionsFunction_ != nullptr){
+                    otherActionsFunction_(newPos, particle, i, time + dt, timestep + 1);
+                }
+                particle->setLocation(newPos);
+                if (particle->isActive()){
+                    ++nActive;
+                }
+            }
+        }
+
+        bool lastTimestep = (nActive == 0 || timestep+1 == maxTimesteps);
+        if (traceStepFunction != nullptr){
+            traceStepFunction(particles_, timestep+1, lastTimestep);
+        }
+        if (nActive == 0){
+            break;
+        }
+    }
+}
+
+/**
+ * Gets the self consistency residuals of the performed iterations
+ */
+const std::vector<double>& Integration::SteadyStateBeamIntegrator::getResiduals() const {
+    return residuals_;
+}
@@ -0,0 +1,105 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ Integration_steadyStateBeamIntegrator.hpp
+
+ Self consistent tracing of current carrying trajectories for the steady state space charge of continuous beams
+
+ ****************************/
+
+#ifndef Integration_steadyStateBeamIntegrator_hpp
+#define Integration_steadyStateBeamIntegrator_hpp
+
+#include "Core_particle.hpp"
+#include "Core_vector.hpp"
+#include "Integration_generic.hpp"
+#include "SC_steadyStateBeamSolver.hpp"
+#include "CollisionModel_AbstractCollisionModel.hpp"
+#include <vector>
+#include <functional>
+
+namespace Integration{
+
+    /**
+     * Steady state integrator for continuous ion beams: Instead of a time dependent simulation of an ion population
+     * until the space charge distribution stabilizes, a set of representative trajectories is traced, each of which
+     * carries a fraction of the beam current. The trajectories deposit their charge (current times time step length)
+     * along their paths in a SpaceCharge::SteadyStateBeamSolver, which calculates the steady state space charge field
+     * from the deposited charge density. Tracing and field calculation are iterated (with under relaxation of the
+     * charge density in the solver) until the charge density is self consistent.
+     *
+     * The trajectories are integrated with the velocity verlet scheme of the other verlet integrators, the space
+     * charge field is provided to the acceleration function by the steady state solver (as space charge field
+     * calculator). Every trajectory starts from the location, velocity and time of birth the particle had at the
+     * construction of the integrator, and ends if the particle is deactivated (typically by the other actions function,
+     * e.g. when the particle leaves the simulation domain or hits an electrode) or after a maximum number of time
+     * steps. A trajectory starting at its time of birth t_0 is traced with the simulation time t_0 + n dt, thus
+     * the start times can be used to sample the phases of time dependent (e.g. RF) fields.
+     *
+     * With a stochastic collision model, the traced charge density is subject to statistical noise, which limits the
+     * achievable self consistency residual.
+     */
+    class SteadyStateBeamIntegrator {
+
+        public:
+
+            /**
+             * Type definition for functions which are called after every time step of a tracing pass (e.g. to write
+             * the trajectories of the final pass)
+             */
+            typedef std::function
+                <void (std::vector<Core::Particle*>& particles,
+                       unsigned int timestep,
+                       bool lastTimestep)>
+                traceStepFctType;
+
+            SteadyStateBeamIntegrator(
+                    const std::vector<Core::Particle*>& particles,
+                    const std::vector<double>& currents,
+                    SpaceCharge::SteadyStateBeamSolver& solver,
+                    accelerationFctSingleStepType accelerationFunction,
+                    otherActionsFctType otherActionsFunction = nullptr,
+                    CollisionModel::AbstractCollisionModel* collisionModel = nullptr
+            );
+
+            std::size_t run(unsigned int maxIterations, double tolerance, double dt, unsigned int maxTimesteps);
+            void traceTrajectories(double dt, unsigned int maxTimesteps,
+                                   const traceStepFctType& traceStepFunction = nullptr, bool depositCharge = true);
+            [[nodiscard]] const std::vector<double>& getResiduals() const;
+
+    private:
+
+        std::vector<Core::Particle*> particles_; ///< The particles of the representative trajectories
+        std::vector<double> currents_; ///< Beam current carried by the trajectories (A)
+        SpaceCharge::SteadyStateBeamSolver& solver_; ///< The steady state space charge solver
+        accelerationFctSingleStepType accelerationFunction_ = nullptr; ///< function to calculate particle acceleration
+        otherActionsFctType otherActionsFunction_ = nullptr; ///< function for other actions (e.g. trajectory termination)
+        CollisionModel::AbstractCollisionModel* collisionModel_ = nullptr; ///< the gas collision model to perform while integrating
+
+        std::vector<Core::Vector> startLocations_; ///< Start locations of the trajectories
+        std::vector<Core::Vector> startVelocities_; ///< Start velocities of the trajectories
+        std::vector<double> startTimes_; ///< Start times of the trajectories
+        std::vector<Core::Vector> a_t_; ///< last time step acceleration for particles
+        std::vector<double> residuals_; ///< Self consistency residuals of the iterations
+    };
+}
+
+#endif /* Integration_steadyStateBeamIntegrator_hpp */
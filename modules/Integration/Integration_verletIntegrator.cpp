@@ -20,6 +20,7 @@
  ****************************/
 
 #include "Integration_verletIntegrator.hpp"
+#include "Core_tracing.hpp"
 #include "Core_particle.hpp"
 #include "CollisionModel_AbstractCollisionModel.hpp"
 #include <utility>
@@ -111,10 +112,12 @@ void Integration::VerletIntegrator::run(unsigned int nTimesteps, double dt) {
  * @param dt time step length
  */
 void Integration::VerletIntegrator::runSingleStep(double dt) {
+    IDSIMF_TRACE_SCOPE("time step", "integration");
 
     bearParticles_(time_);
 
     if (collisionModel_ !=nullptr){
+        IDSIMF_TRACE_SCOPE("collision model time step update", "collision");
         collisionModel_->updateModelTimestepParameters(timestep_, time_);
     }
 
@@ -159,6 +162,7 @@ void Integration::VerletIntegrator::runSingleStep(double dt) {
     timestep_++;
     time_ = time_ + dt;
     if (postTimestepFunction_ != nullptr){
+        IDSIMF_TRACE_SCOPE("post time step", "integration");
         postTimestepFunction_(this, particles_, time_, timestep_, false);
     }
 }
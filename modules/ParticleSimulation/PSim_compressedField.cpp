@@ -0,0 +1,336 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "PSim_compressedField.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace{
+    std::atomic<std::uint64_t> nextCompressedFieldId{1}; ///< Source of unique ids of compressed fields
+
+    /**
+     * Maps a signed residual (in two's complement) to an unsigned integer with small magnitudes for small
+     * positive and negative residuals
+     */
+    inline std::uint64_t zigZagEncode(std::uint64_t value){
+        return (value << 1) ^ (0 - (value >> 63));
+    }
+
+    inline std::uint64_t zigZagDecode(std::uint64_t value){
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
+    /**
+     * Three dimensional Lorenzo predictor of a block value from its (already processed) lower neighbors,
+     * values outside of the block are zero. Integers are predicted in modular arithmetic.
+     */
+    template<typename T, std::size_t N>
+    inline T lorenzoPrediction(const std::array<T, N>& a, std::size_t lx, std::size_t ly, std::size_t lz){
+        constexpr std::size_t edge = ParticleSimulation::CompressedField::BLOCK_EDGE;
+        auto at = [&a](std::size_t x, std::size_t y, std::size_t z){return a[(z*edge + y)*edge + x];};
+        T a100 = lx>0 ? at(lx-1, ly, lz) : T(0);
+        T a010 = ly>0 ? at(lx, ly-1, lz) : T(0);
+        T a001 = lz>0 ? at(lx, ly, lz-1) : T(0);
+        T a110 = (lx>0 && ly>0) ? at(lx-1, ly-1, lz) : T(0);
+        T a101 = (lx>0 && lz>0) ? at(lx-1, ly, lz-1) : T(0);
+        T a011 = (ly>0 && lz>0) ? at(lx, ly-1, lz-1) : T(0);
+        T a111 = (lx>0 && ly>0 && lz>0) ? at(lx-1, ly-1, lz-1) : T(0);
+        return a100 + a010 + a001 - a110 - a101 - a011 + a111;
+    }
+
+    inline bool isInteriorPoint(std::size_t lx, std::size_t ly, std::size_t lz){
+        return lx>0 && ly>0 && lz>0;
+    }
+
+    inline unsigned int bitWidth(std::uint64_t value){
+        unsigned int width = 0;
+        while (value != 0){
+            value >>= 1;
+            ++width;
+        }
+        return width;
+    }
+}
+
+/**
+ * Constructs a compressed field from a linearized grid of scalar values
+ *
+ * @param dimensions Number of grid points in x, y and z direction
+ * @param data The grid values, linearized with x as fastest and z as slowest running index
+ * @param errorBound Maximum absolute error of the stored values (lossy compression) or 0 for lossless compression
+ */
+ParticleSimulation::CompressedField::CompressedField(std::array<std::size_t, 3> dimensions,
+                                                     const std::vector<double>& data, double errorBound):
+id_(nextCompressedFieldId++),
+dimensions_(dimensions),
+errorBound_(errorBound)
+{
+    if (dimensions[0]*dimensions[1]*dimensions[2] != data.size()){
+        throw (std::invalid_argument("Size of compressed field data does not match the field dimensions"));
+    }
+    if (errorBound < 0.0 || !std::isfinite(errorBound)){
+        throw (std::invalid_argument("Illegal error bound for compressed field"));
+    }
+    if (errorBound > 0.0){
+        double maxQuantized = std::ldexp(1.0, 62);
+        for (double value: data){
+            if (!std::isfinite(value) || std::fabs(value / (2.0*errorBound)) >= maxQuantized){
+                std::stringstream ss;
+                ss << "Value " << value << " can not be compressed with error bound " << errorBound;
+                throw (std::invalid_argument(ss.str()));
+            }
+        }
+    }
+
+    for (std::size_t d=0; d<3; ++d){
+        nBlocks_[d] = (dimensions_[d] + BLOCK_EDGE - 1) / BLOCK_EDGE;
+    }
+
+    blockOffsets_.reserve(nBlocks_[0]*nBlocks_[1]*nBlocks_[2] + 1);
+    for (std::size_t bz=0; bz<nBlocks_[2]; ++bz){
+        for (std::size_t by=0; by<nBlocks_[1]; ++by){
+            for (std::size_t bx=0; bx<nBlocks_[0]; ++bx){
+                blockOffsets_.push_back(compressedData_.size());
+                compressBlock_(bx, by, bz, data);
+            }
+        }
+    }
+    blockOffsets_.push_back(compressedData_.size());
+    compressedData_.shrink_to_fit();
+}
+
+/**
+ * Gets a (decompressed) value from the grid
+ *
+ * @param ix Grid point index in x direction
+ * @param iy Grid point index in y direction
+ * @param iz Grid point index in z direction
+ */
+double ParticleSimulation::CompressedField::get(std::size_t ix, std::size_t iy, std::size_t iz) const {
+    thread_local std::vector<CacheEntry> blockCache(CACHE_SIZE);
+
+    std::size_t blockIndex = ((iz / BLOCK_EDGE) * nBlocks_[1] + iy / BLOCK_EDGE) * nBlocks_[0] + ix / BLOCK_EDGE;
+    CacheEntry& entry = blockCache[(blockIndex + id_ * 7919) % CACHE_SIZE];
+    if (entry.fieldId != id_ || entry.blockIndex != blockIndex){
+        decompressBlock_(blockIndex, entry.values);
+        entry.fieldId = id_;
+        entry.blockIndex = blockIndex;
+    }
+    return entry.values[((iz % BLOCK_EDGE) * BLOCK_EDGE + iy % BLOCK_EDGE) * BLOCK_EDGE + ix % BLOCK_EDGE];
+}
+
+/**
+ * Gets the number of grid points in the spatial directions
+ */
+std::array<std::size_t, 3> ParticleSimulation::CompressedField::getDimensions() const {
+    return dimensions_;
+}
+
+/**
+ * Gets the absolute error bound of the stored values (0 for lossless compression)
+ */
+double ParticleSimulation::CompressedField::getErrorBound() const {
+    return errorBound_;
+}
+
+/**
+ * Gets the memory size of the compressed data in bytes
+ */
+std::size_t ParticleSimulation::CompressedField::compressedSizeBytes() const {
+    return compressedData_.size() + blockOffsets_.size() * sizeof(std::size_t);
+}
+
+/**
+ * Gets the memory size of the uncompressed data in bytes
+ */
+std::size_t ParticleSimulation::CompressedField::uncompressedSizeBytes() const {
+    return dimensions_[0] * dimensions_[1] * dimensions_[2] * sizeof(double);
+}
+
+/**
+ * Gets the number of grid points in a block in the spatial directions (blocks at the upper borders of the grid
+ * can be smaller than BLOCK_EDGE)
+ */
+std::array<std::size_t, 3> ParticleSimulation::CompressedField::blockExtent_(
+        std::size_t bx, std::size_t by, std::size_t bz) const {
+    return {
+        std::min(BLOCK_EDGE, dimensions_[0] - bx*BLOCK_EDGE),
+        std::min(BLOCK_EDGE, dimensions_[1] - by*BLOCK_EDGE),
+        std::min(BLOCK_EDGE, dimensions_[2] - bz*BLOCK_EDGE)
+    };
+}
+
+/**
+ * Compresses a block and appends it to the compressed data
+ */
+void ParticleSimulation::CompressedField::compressBlock_(std::size_t bx, std::size_t by, std::size_t bz,
+                                                         const std::vector<double>& data) {
+    std::array<std::size_t, 3> ext = blockExtent_(bx, by, bz);
+
+    // gather values (block local layout with full BLOCK_EDGE strides):
+    std::array<double, BLOCK_SIZE> values{};
+    std::array<std::uint64_t, BLOCK_SIZE> integers{};
+    for (std::size_t lz=0; lz<ext[2]; ++lz){
+        for (std::size_t ly=0; ly<ext[1]; ++ly){
+            for (std::size_t lx=0; lx<ext[0]; ++lx){
+                std::size_t gx = bx*BLOCK_EDGE + lx;
+                std::size_t gy = by*BLOCK_EDGE + ly;
+                std::size_t gz = bz*BLOCK_EDGE + lz;
+                std::size_t localIndex = (lz*BLOCK_EDGE + ly)*BLOCK_EDGE + lx;
+                values[localIndex] = data[(gz*dimensions_[1] + gy)*dimensions_[0] + gx];
+                integers[localIndex] = toInteger_(values[localIndex]);
+            }
+        }
+    }
+
+    // prediction residuals, separated for block boundary and block interior points which have typically
+    // very different residual magnitudes:
+    std::vector<std::uint64_t> residuals;
+    residuals.reserve(ext[0]*ext[1]*ext[2]);
+    std::array<unsigned int, 2> widths = {0, 0};
+    for (std::size_t lz=0; lz<ext[2]; ++lz){
+        for (std::size_t ly=0; ly<ext[1]; ++ly){
+            for (std::size_t lx=0; lx<ext[0]; ++lx){
+                std::size_t localIndex = (lz*BLOCK_EDGE + ly)*BLOCK_EDGE + lx;
+                std::uint64_t residual;
+                if (errorBound_ > 0.0){
+                    residual = zigZagEncode(integers[localIndex] - lorenzoPrediction(integers, lx, ly, lz));
+                }
+                else {
+                    residual = integers[localIndex] ^ toInteger_(lorenzoPrediction(values, lx, ly, lz));
+                }
+                std::size_t category = isInteriorPoint(lx, ly, lz) ? 1 : 0;
+                widths[category] = std::max(widths[category], bitWidth(residual));
+                residuals.push_back(residual);
+            }
+        }
+    }
+
+    // bit packing with the maximum residual widths of the block:
+    compressedData_.push_back(static_cast<std::uint8_t>(widths[0]));
+    compressedData_.push_back(static_cast<std::uint8_t>(widths[1]));
+    std::uint8_t currentByte = 0;
+    unsigned int bitPosition = 0;
+    std::size_t iResidual = 0;
+    for (std::size_t lz=0; lz<ext[2]; ++lz){
+        for (std::size_t ly=0; ly<ext[1]; ++ly){
+            for (std::size_t lx=0; lx<ext[0]; ++lx){
+                std::uint64_t residual = residuals[iResidual++];
+                unsigned int remaining = widths[isInteriorPoint(lx, ly, lz) ? 1 : 0];
+                while (remaining > 0){
+                    unsigned int nBits = std::min(remaining, 8 - bitPosition);
+                    auto bits = static_cast<std::uint8_t>(residual & ((1u << nBits) - 1));
+                    currentByte = static_cast<std::uint8_t>(currentByte | (bits << bitPosition));
+                    residual >>= nBits;
+                    remaining -= nBits;
+                    bitPosition += nBits;
+                    if (bitPosition == 8){
+                        compressedData_.push_back(currentByte);
+                        currentByte = 0;
+                        bitPosition = 0;
+                    }
+                }
+            }
+        }
+    }
+    if (bitPosition > 0){
+        compressedData_.push_back(currentByte);
+    }
+}
+
+/**
+ * Decompresses a block into a block local value array (with full BLOCK_EDGE strides)
+ */
+void ParticleSimulation::CompressedField::decompressBlock_(std::size_t blockIndex,
+                                                           std::array<double, BLOCK_SIZE>& values) const {
+    std::size_t bx = blockIndex % nBlocks_[0];
+    std::size_t by = (blockIndex / nBlocks_[0]) % nBlocks_[1];
+    std::size_t bz = blockIndex / (nBlocks_[0] * nBlocks_[1]);
+    std::array<std::size_t, 3> ext = blockExtent_(bx, by, bz);
+
+    const std::uint8_t* src = compressedData_.data() + blockOffsets_[blockIndex];
+    std::array<unsigned int, 2> widths = {src[0], src[1]};
+    src += 2;
+    unsigned int bitPosition = 0;
+
+    std::array<std::uint64_t, BLOCK_SIZE> integers{};
+    for (std::size_t lz=0; lz<ext[2]; ++lz){
+        for (std::size_t ly=0; ly<ext[1]; ++ly){
+            for (std::size_t lx=0; lx<ext[0]; ++lx){
+                unsigned int width = widths[isInteriorPoint(lx, ly, lz) ? 1 : 0];
+                std::uint64_t residual = 0;
+                unsigned int nRead = 0;
+                while (nRead < width){
+                    unsigned int nBits = std::min(width - nRead, 8 - bitPosition);
+                    std::uint64_t bits = (static_cast<std::uint64_t>(*src) >> bitPosition) & ((1u << nBits) - 1);
+                    residual |= bits << nRead;
+                    nRead += nBits;
+                    bitPosition += nBits;
+                    if (bitPosition == 8){
+                        ++src;
+                        bitPosition = 0;
+                    }
+                }
+
+                std::size_t localIndex = (lz*BLOCK_EDGE + ly)*BLOCK_EDGE + lx;
+                if (errorBound_ > 0.0){
+                    integers[localIndex] = lorenzoPrediction(integers, lx, ly, lz) + zigZagDecode(residual);
+                    values[localIndex] = toDouble_(integers[localIndex]);
+                }
+                else {
+                    values[localIndex] = toDouble_(residual ^ toInteger_(lorenzoPrediction(values, lx, ly, lz)));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Maps a value to the integer representation used for compression
+ */
+std::uint64_t ParticleSimulation::CompressedField::toInteger_(double value) const {
+    if (errorBound_ > 0.0){
+        return static_cast<std::uint64_t>(std::llround(value / (2.0*errorBound_)));
+    }
+    else {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(double));
+        return bits;
+    }
+}
+
+/**
+ * Maps an integer representation back to a value
+ */
+double ParticleSimulation::CompressedField::toDouble_(std::uint64_t value) const {
+    if (errorBound_ > 0.0){
+        return static_cast<double>(static_cast<std::int64_t>(value)) * (2.0*errorBound_);
+    }
+    else {
+        double result;
+        std::memcpy(&result, &value, sizeof(double));
+        return result;
+    }
+}
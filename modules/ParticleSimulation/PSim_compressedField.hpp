@@ -0,0 +1,95 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_compressedField.hpp
+
+ Compressed storage of a regular three dimensional scalar grid in independently compressed blocks with a
+ per thread cache of decompressed blocks
+
+ ****************************/
+
+#ifndef Particle_simulation_compressed_field
+#define Particle_simulation_compressed_field
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ParticleSimulation{
+
+    /**
+     * Compressed in memory storage of a regular three dimensional grid of scalar values.
+     *
+     * The grid is divided into cubic blocks of BLOCK_EDGE^3 grid points, which are compressed independently:
+     * The values are predicted from their neighbors in the block with a three dimensional Lorenzo predictor. In
+     * lossy mode, the values are quantized with a step of two times the error bound and the integer prediction
+     * residuals are stored. In lossless mode, the XOR of the IEEE 754 bit patterns of the value and the prediction
+     * is stored. The residuals are bit packed with the minimal bit widths of the block boundary and the block
+     * interior points. In smooth fields most residuals are small, which results in high compression ratios.
+     *
+     * Accessed blocks are decompressed on demand into a small per thread cache, thus spatially local accesses
+     * (e.g. the grid points surrounding an interpolated position) are served from decompressed data.
+     */
+    class CompressedField {
+
+    public:
+        static constexpr std::size_t BLOCK_EDGE = 8; ///< Number of grid points per edge of a compression block
+
+        CompressedField(std::array<std::size_t, 3> dimensions, const std::vector<double>& data,
+                        double errorBound = 0.0);
+
+        [[nodiscard]] double get(std::size_t ix, std::size_t iy, std::size_t iz) const;
+
+        [[nodiscard]] std::array<std::size_t, 3> getDimensions() const;
+        [[nodiscard]] double getErrorBound() const;
+        [[nodiscard]] std::size_t compressedSizeBytes() const;
+        [[nodiscard]] std::size_t uncompressedSizeBytes() const;
+
+    private:
+        static constexpr std::size_t BLOCK_SIZE = BLOCK_EDGE*BLOCK_EDGE*BLOCK_EDGE; ///< Grid points per block
+        static constexpr std::size_t CACHE_SIZE = 32; ///< Number of decompressed blocks in a per thread cache
+
+        /**
+         * A decompressed block in the per thread block cache
+         */
+        struct CacheEntry{
+            std::uint64_t fieldId = 0; ///< Unique id of the compressed field the block belongs to (0 = empty)
+            std::size_t blockIndex = 0; ///< Index of the cached block
+            std::array<double, BLOCK_SIZE> values{}; ///< The decompressed values of the block
+        };
+
+        std::uint64_t id_; ///< Unique id of this compressed field (key of the per thread cache)
+        std::array<std::size_t, 3> dimensions_; ///< Number of grid points in the spatial directions
+        std::array<std::size_t, 3> nBlocks_; ///< Number of blocks in the spatial directions
+        double errorBound_; ///< Absolute error bound (0 for lossless compression)
+        std::vector<std::uint8_t> compressedData_; ///< Concatenated compressed blocks
+        std::vector<std::size_t> blockOffsets_; ///< Offsets of the compressed blocks in compressedData_
+
+        [[nodiscard]] std::array<std::size_t, 3> blockExtent_(std::size_t bx, std::size_t by, std::size_t bz) const;
+        void compressBlock_(std::size_t bx, std::size_t by, std::size_t bz, const std::vector<double>& data);
+        void decompressBlock_(std::size_t blockIndex, std::array<double, BLOCK_SIZE>& values) const;
+        [[nodiscard]] std::uint64_t toInteger_(double value) const;
+        [[nodiscard]] double toDouble_(std::uint64_t value) const;
+    };
+}
+
+#endif //Particle_simulation_compressed_field
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <iterator>
 #include <exception>
+#include <stdexcept>
 
 template <hsize_t dims> using dataField =
     FileIO::HDF5Reader::DataField<dims, double>;
@@ -74,7 +75,7 @@ ParticleSimulation::InterpolatedField::InterpolatedField(const std::string &hdf5
             throw (std::invalid_argument(ss.str()));
         }
 
-        linearizedFields_.emplace_back(std::vector<double>());
+        linearizedFields_.emplace_back();
         unsigned int counter = 0;
 
         // Read field data
@@ -84,7 +85,8 @@ ParticleSimulation::InterpolatedField::InterpolatedField(const std::string &hdf5
             //TODO: throw exception if 4th dimension (the vector components dimension) is not 3 (not a 3d vector)
 
             std::array<hsize_t, 4> dfIndices = {0, 0, 0, 0};
-            std::vector<double>& lf = linearizedFields_.back();
+            auto& lf = linearizedFields_.back();
+            lf.reserve(3*gridDimensions_[0]*gridDimensions_[1]*gridDimensions_[2]);
 
             for (std::size_t zi = 0; zi<gridDimensions_[2]; ++zi) {
                 dfIndices[2] = zi;
@@ -110,7 +112,8 @@ ParticleSimulation::InterpolatedField::InterpolatedField(const std::string &hdf5
         else {
             dataField<3> df = h5Reader.readDataset<3>(fullFieldName);
             std::array<hsize_t, 3> dfIndices = {0, 0, 0};
-            std::vector<double>& lf = linearizedFields_.back();
+            auto& lf = linearizedFields_.back();
+            lf.reserve(gridDimensions_[0]*gridDimensions_[1]*gridDimensions_[2]);
 
             for (std::size_t zi = 0; zi<gridDimensions_[2]; ++zi) {
                 dfIndices[2] = zi;
@@ -136,7 +139,7 @@ ParticleSimulation::InterpolatedField::InterpolatedField(const std::string &hdf5
  */
 double ParticleSimulation::InterpolatedField::getScalar(size_t ix, size_t iy, size_t iz, size_t fieldIndex) const{
     enforceScalar_(fieldIndex);
-    return linearizedFields_[fieldIndex][linearizedIndexScalar_(ix,iy,iz)];
+    return value_(fieldIndex, 0, ix, iy, iz);
 }
 
 /**
@@ -165,11 +168,10 @@ Core::Vector ParticleSimulation::InterpolatedField::getVector(std::size_t ix, st
         throw (std::invalid_argument(ss.str()));
     }
 
-    std::size_t vectorIndex = linearizedIndexVector_(ix, iy, iz);
     return {
-        linearizedFields_[fieldIndex][vectorIndex],
-        linearizedFields_[fieldIndex][vectorIndex+1],
-        linearizedFields_[fieldIndex][vectorIndex+2]
+        value_(fieldIndex, 0, ix, iy, iz),
+        value_(fieldIndex, 1, ix, iy, iz),
+        value_(fieldIndex, 2, ix, iy, iz)
     };
 }
 
@@ -190,6 +192,59 @@ Core::Vector ParticleSimulation::InterpolatedField::getInterpolatedVector(double
     return Core::Vector(result[0], result[1], result[2]);
 }
 
+/**
+ * Compresses the data fields: The fields are stored block wise compressed in memory and decompressed on demand,
+ * which reduces the memory consumption of large fields at the cost of a moderate slowdown of the field access.
+ * Vector fields are compressed component wise.
+ *
+ * @param errorBound Maximum absolute error of the stored field values (0 for lossless compression)
+ */
+void ParticleSimulation::InterpolatedField::compress(double errorBound) {
+    if (isCompressed()){
+        throw (std::logic_error("Interpolated field is already compressed"));
+    }
+    std::array<std::size_t, 3> dims = {gridDimensions_[0], gridDimensions_[1], gridDimensions_[2]};
+    std::size_t nPoints = dims[0]*dims[1]*dims[2];
+
+    for (std::size_t fieldIndex=0; fieldIndex<linearizedFields_.size(); ++fieldIndex){
+        std::vector<CompressedField> components;
+        std::size_t nComponents = isVector_[fieldIndex] ? 3 : 1;
+        std::vector<double> componentData(nPoints);
+        for (std::size_t comp=0; comp<nComponents; ++comp){
+            for (std::size_t i=0; i<nPoints; ++i){
+                componentData[i] = linearizedFields_[fieldIndex][i*nComponents + comp];
+            }
+            components.emplace_back(dims, componentData, errorBound);
+        }
+        compressedFields_.push_back(std::move(components));
+    }
+    linearizedFields_.clear();
+    linearizedFields_.shrink_to_fit();
+}
+
+/**
+ * Returns true if the data fields are stored compressed
+ */
+bool ParticleSimulation::InterpolatedField::isCompressed() const {
+    return !compressedFields_.empty();
+}
+
+/**
+ * Gets the memory size of the (compressed or uncompressed) field data in bytes
+ */
+std::size_t ParticleSimulation::InterpolatedField::dataSizeBytes() const {
+    std::size_t result = 0;
+    for (const auto& field: linearizedFields_){
+        result += field.size() * sizeof(double);
+    }
+    for (const auto& components: compressedFields_){
+        for (const auto& component: components){
+            result += component.compressedSizeBytes();
+        }
+    }
+    return result;
+}
+
 /**
  * Gets the spatial grid (set of three vectors of spatial positions of the data points in the spatial dimensions)
  */
@@ -254,6 +309,19 @@ std::size_t ParticleSimulation::InterpolatedField::linearizedIndexVector_(std::s
                 ix * 3;
 }
 
+double ParticleSimulation::InterpolatedField::value_(std::size_t fieldIndex, std::size_t component,
+                                                    std::size_t ix, std::size_t iy, std::size_t iz) const {
+    if (!compressedFields_.empty()){
+        return compressedFields_[fieldIndex][component].get(ix, iy, iz);
+    }
+    else if (isVector_[fieldIndex]){
+        return linearizedFields_[fieldIndex][linearizedIndexVector_(ix, iy, iz) + component];
+    }
+    else {
+        return linearizedFields_[fieldIndex][linearizedIndexScalar_(ix, iy, iz)];
+    }
+}
+
 template<typename datT>
 datT ParticleSimulation::InterpolatedField::interpolate_(double x, double y, double z, std::size_t fieldIndex) const{
 
@@ -263,8 +331,6 @@ datT ParticleSimulation::InterpolatedField::interpolate_(double x, double y, dou
         throw (std::invalid_argument(ss.str()));
     }
 
-    const std::vector<double>* field = &(linearizedFields_[fieldIndex]);
-
     std::array<std::size_t, 3> lowerBoundIndices = findLowerBoundIndices(x, y, z);
     std::size_t xiLower = lowerBoundIndices[0]-1;
     std::size_t  xiUpper = lowerBoundIndices[0];
@@ -284,52 +350,29 @@ datT ParticleSimulation::InterpolatedField::interpolate_(double x, double y, dou
     double yd = (y-yLower) /(yUpper - yLower);
     double zd = (z-zLower) /(zUpper - zLower);
 
-    if constexpr (std::is_same_v<datT, double>) {
+    auto interpolateComponent = [&](std::size_t comp){
+        double c_00 = value_(fieldIndex, comp, xiLower, yiLower, ziLower)*(1-xd)
+                    + value_(fieldIndex, comp, xiUpper, yiLower, ziLower)*xd;
 
-        double c_00 = field->operator[](linearizedIndexScalar_(xiLower, yiLower, ziLower))*(1-xd)
-                    + field->operator[](linearizedIndexScalar_(xiUpper, yiLower, ziLower))*xd;
+        double c_01 = value_(fieldIndex, comp, xiLower, yiLower, ziUpper)*(1-xd)
+                    + value_(fieldIndex, comp, xiUpper, yiLower, ziUpper)*xd;
 
-        double c_01 = field->operator[](linearizedIndexScalar_(xiLower, yiLower, ziUpper))*(1-xd)
-                    + field->operator[](linearizedIndexScalar_(xiUpper, yiLower, ziUpper))*xd;
+        double c_10 = value_(fieldIndex, comp, xiLower, yiUpper, ziLower)*(1-xd)
+                    + value_(fieldIndex, comp, xiUpper, yiUpper, ziLower)*xd;
 
-        double c_10 = field->operator[](linearizedIndexScalar_(xiLower, yiUpper, ziLower))*(1-xd)
-                    + field->operator[](linearizedIndexScalar_(xiUpper, yiUpper, ziLower))*xd;
-
-        double c_11 = field->operator[](linearizedIndexScalar_(xiLower, yiUpper, ziUpper))*(1-xd)
-                    + field->operator[](linearizedIndexScalar_(xiUpper, yiUpper, ziUpper))*xd;
+        double c_11 = value_(fieldIndex, comp, xiLower, yiUpper, ziUpper)*(1-xd)
+                    + value_(fieldIndex, comp, xiUpper, yiUpper, ziUpper)*xd;
 
         double c_0 = c_00*(1-yd) + c_10*yd;
         double c_1 = c_01*(1-yd) + c_11*yd;
 
-        double result = c_0*(1-zd) + c_1*zd;
+        return c_0*(1-zd) + c_1*zd;
+    };
 
-        return result;
+    if constexpr (std::is_same_v<datT, double>) {
+        return interpolateComponent(0);
     }
     else if constexpr (std::is_same_v<datT, std::array<double, 3>>) {
-
-        std::size_t i_000 = linearizedIndexVector_(xiLower, yiLower, ziLower);
-        std::size_t i_001 = linearizedIndexVector_(xiLower, yiLower, ziUpper);
-        std::size_t i_010 = linearizedIndexVector_(xiLower, yiUpper, ziLower);
-        std::size_t i_011 = linearizedIndexVector_(xiLower, yiUpper, ziUpper);
-        std::size_t i_100 = linearizedIndexVector_(xiUpper, yiLower, ziLower);
-        std::size_t i_101 = linearizedIndexVector_(xiUpper, yiLower, ziUpper);
-        std::size_t i_110 = linearizedIndexVector_(xiUpper, yiUpper, ziLower);
-        std::size_t i_111 = linearizedIndexVector_(xiUpper, yiUpper, ziUpper);
-
-        std::array<double, 3> result{0.0,0.0,0.0};
-
-        for (std::size_t i=0; i<3; ++i){
-            double c_00 = field->operator[](i_000+i)*(1-xd) + field->operator[](i_100+i)*xd;
-            double c_01 = field->operator[](i_001+i)*(1-xd) + field->operator[](i_101+i)*xd;
-            double c_10 = field->operator[](i_010+i)*(1-xd) + field->operator[](i_110+i)*xd;
-            double c_11 = field->operator[](i_011+i)*(1-xd) + field->operator[](i_111+i)*xd;
-
-            double c_0 = c_00*(1-yd) + c_10*yd;
-            double c_1 = c_01*(1-yd) + c_11*yd;
-
-            result[i] = c_0*(1-zd) + c_1*zd;
-        }
-
-        return result;
+        return std::array<double, 3>{interpolateComponent(0), interpolateComponent(1), interpolateComponent(2)};
     }
-}
\ No newline at end of file
+}
@@ -28,6 +28,9 @@
 #ifndef BTree_interpolatedField_hpp
 #define BTree_interpolatedField_hpp
 
+#include "PSim_spatialField.hpp"
+#include "PSim_compressedField.hpp"
+#include "Core_hugePageAllocator.hpp"
 #include <vector>
 #include <array>
 #include <string>
@@ -45,7 +48,7 @@ namespace ParticleSimulation{
      *  3d vector fields and allowing spatial interpolation of the field values
      */
 
-    class InterpolatedField {
+    class InterpolatedField : public SpatialField {
         // TODO: implement an additional equidistant / regular grid mode, with much simplified
         // calculation of the indices of the nodes surrounding an spatial position within the grid
 
@@ -53,12 +56,19 @@ namespace ParticleSimulation{
         explicit InterpolatedField(const std::string &hdf5Filename);
 
         [[nodiscard]] double getScalar(std::size_t ix, std::size_t iy, std::size_t iz, std::size_t fieldIndex) const;
-        [[nodiscard]] double getInterpolatedScalar(double x,double y, double z, std::size_t fieldIndex) const;
+        using SpatialField::getInterpolatedScalar;
+        using SpatialField::getInterpolatedVector;
+
+        [[nodiscard]] double getInterpolatedScalar(double x,double y, double z, std::size_t fieldIndex) const override;
         [[nodiscard]] Core::Vector getVector(std::size_t ix, std::size_t iy, std::size_t iz, std::size_t fieldIndex) const;
-        [[nodiscard]] Core::Vector getInterpolatedVector(double x, double y, double z, std::size_t fieldIndex) const;
+        [[nodiscard]] Core::Vector getInterpolatedVector(double x, double y, double z, std::size_t fieldIndex) const override;
+
+        void compress(double errorBound = 0.0);
+        [[nodiscard]] bool isCompressed() const;
+        [[nodiscard]] std::size_t dataSizeBytes() const;
 
         [[nodiscard]] std::vector<std::vector<double>> getGrid() const;
-        [[nodiscard]] std::array<double,6> getBounds() const;
+        [[nodiscard]] std::array<double,6> getBounds() const override;
         [[nodiscard]] std::array<std::size_t, 3> findLowerBoundIndices(double x, double y, double z) const;
 
     private:
@@ -71,12 +81,15 @@ namespace ParticleSimulation{
         //std::vector<int> fieldsComponents_;            ///< number of components of the individual data fields
         std::vector<std::string> fieldNames_;
         std::vector<bool> isVector_; ///< Flag if data field is a vector
-        std::vector<std::vector<double>> linearizedFields_;
+        std::vector<Core::hugePageVector<double, Core::HugePageSubsystem::FIELD_GRIDS>> linearizedFields_; ///< Uncompressed field data
+        std::vector<std::vector<CompressedField>> compressedFields_; ///< Compressed field data (one per vector component)
 
         void updateBounds_();
         inline void enforceScalar_(std::size_t fieldIndex) const;
         [[nodiscard]] std::size_t linearizedIndexScalar_(std::size_t ix, std::size_t iy, std::size_t iz) const;
         [[nodiscard]] std::size_t linearizedIndexVector_(std::size_t ix, std::size_t iy, std::size_t iz) const;
+        [[nodiscard]] double value_(std::size_t fieldIndex, std::size_t component,
+                                    std::size_t ix, std::size_t iy, std::size_t iz) const;
         template<typename datT> [[nodiscard]] datT interpolate_(double x, double y, double z, std::size_t fieldIndex) const;
     };
 }
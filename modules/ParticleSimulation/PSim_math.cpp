@@ -20,6 +20,9 @@
  ****************************/
 
 #include "PSim_math.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
 /**
  * Computes an linearly spaced vector of double values (similar to the corresponding matlab and numpy methods)
@@ -53,4 +56,55 @@ std::vector<double> ParticleSimulation::fillVector(double value, int n) {
         result.push_back(value);
     }
     return(result);
-}
\ No newline at end of file
+}
+
+/**
+ * Checks if a number is a power of two
+ */
+bool ParticleSimulation::isPowerOfTwo(std::size_t n) {
+    return n > 0 && (n & (n-1)) == 0;
+}
+
+/**
+ * Computes the (unnormalized) inverse discrete Fourier transform of a complex sequence in place:
+ * x_n = sum_k X_k exp(2 pi i k n / N)
+ *
+ * The transformation is performed with an iterative radix 2 fast Fourier transform, thus the length of the
+ * sequence has to be a power of two.
+ *
+ * @param data the complex spectrum, which is replaced by the transformed sequence
+ */
+void ParticleSimulation::inverseFFT(std::vector<std::complex<double>>& data) {
+    std::size_t n = data.size();
+    if (!isPowerOfTwo(n)){
+        throw (std::invalid_argument("Length of inverse FFT data is not a power of two"));
+    }
+
+    // bit reversal permutation:
+    for (std::size_t i=1, j=0; i<n; ++i){
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j){
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // butterfly stages:
+    for (std::size_t len=2; len<=n; len <<= 1){
+        double angle = 2.0 * M_PI / static_cast<double>(len);
+        std::complex<double> wLen(std::cos(angle), std::sin(angle));
+        for (std::size_t i=0; i<n; i += len){
+            std::complex<double> w(1.0, 0.0);
+            for (std::size_t k=0; k<len/2; ++k){
+                std::complex<double> u = data[i+k];
+                std::complex<double> v = data[i+k+len/2] * w;
+                data[i+k] = u + v;
+                data[i+k+len/2] = u - v;
+                w *= wLen;
+            }
+        }
+    }
+}
@@ -29,10 +29,13 @@
 #define PSim_math_hpp
 
 #include <vector>
+#include <complex>
 
 namespace ParticleSimulation {
     [[nodiscard]] std::vector<double> linspace(double lower, double upper, int n);
     [[nodiscard]] std::vector<double> fillVector(double value, int n);
+    [[nodiscard]] bool isPowerOfTwo(std::size_t n);
+    void inverseFFT(std::vector<std::complex<double>>& data);
 }
 
 
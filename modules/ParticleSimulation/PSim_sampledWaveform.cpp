@@ -23,6 +23,7 @@
 #include <fstream>
 #include <cmath>
 #include <iostream>
+#include <utility>
 
 /**
  * Constructor: Creates a sampled waveform from a given file
@@ -53,6 +54,22 @@ ParticleSimulation::SampledWaveform::SampledWaveform(std::string filename){
     }
 }
 
+/**
+ * Constructor: Creates a sampled waveform from samples in memory (e.g. a synthesized waveform)
+ * @param samples the waveform samples, one sample per time step
+ */
+ParticleSimulation::SampledWaveform::SampledWaveform(std::vector<double> samples):
+wfTable_(std::move(samples)),
+size_(wfTable_.size()),
+dataIsGood_(true)
+{
+    double phaseIncrement = 1.0 / static_cast<double>(size_);
+    phaseTable_.reserve(size_);
+    for(std::size_t i=0; i<size_; ++i){
+        phaseTable_.push_back(static_cast<double>(i)*phaseIncrement);
+    }
+}
+
 /**
  * Checks if the input file was read correctly and waveform data is ready
  * @return true if the data was read correctly
@@ -44,6 +44,7 @@ namespace ParticleSimulation{
 
     public:
         explicit SampledWaveform(std::string filename);
+        explicit SampledWaveform(std::vector<double> samples);
         [[nodiscard]] bool good() const;
         [[nodiscard]] std::size_t size() const;
         [[nodiscard]] double getValue(std::size_t index) const;
@@ -25,6 +25,7 @@
 #include "spdlog/spdlog.h"
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 
 ParticleSimulation::PotentialArrayException::operator std::string() const {
     return this->what();
@@ -620,6 +621,11 @@ double ParticleSimulation::SimionPotentialArray::interpolatedPotentialCartesian3
 }
 
 double ParticleSimulation::SimionPotentialArray::potential_(index_t ix, index_t iy, index_t iz) const {
+    if (compressedPotentials_){
+        return compressedPotentials_->get(
+                static_cast<std::size_t>(ix), static_cast<std::size_t>(iy), static_cast<std::size_t>(iz))
+                * potentialScale_;
+    }
     double pot = rawPotential_(ix, iy, iz);
     // electrodes are defined by potentials larger than maxVoltage_ in simion PAs
     if (pot > maxVoltage_){
@@ -648,6 +654,48 @@ ParticleSimulation::index_t ParticleSimulation::SimionPotentialArray::linearInde
     return (iz * ny_ + iy) * nx_ + ix;
 }
 
+/**
+ * Compresses the potential array: The potentials are stored block wise compressed in memory and decompressed
+ * on demand, which reduces the memory consumption of large or many potential arrays at the cost of a moderate
+ * slowdown of the potential access. The electrode flags of the nodes are stored separately and remain exact.
+ *
+ * @param errorBound Maximum absolute error of the stored (unscaled) potentials (0 for lossless compression)
+ */
+void ParticleSimulation::SimionPotentialArray::compress(double errorBound) {
+    if (compressedPotentials_){
+        throw (ParticleSimulation::PotentialArrayException("Potential array is already compressed"));
+    }
+    std::vector<double> potentials(points_.size());
+    electrodeFlags_.resize(points_.size());
+    for (std::size_t i=0; i<points_.size(); ++i){
+        electrodeFlags_[i] = points_[i] > maxVoltage_;
+        potentials[i] = electrodeFlags_[i] ? points_[i] - 2*maxVoltage_ : points_[i];
+    }
+    compressedPotentials_ = std::make_unique<CompressedField>(
+            std::array<std::size_t, 3>{
+                static_cast<std::size_t>(nx_), static_cast<std::size_t>(ny_), static_cast<std::size_t>(nz_)},
+            potentials, errorBound);
+    points_.clear();
+    points_.shrink_to_fit();
+}
+
+/**
+ * Returns true if the potentials are stored compressed
+ */
+bool ParticleSimulation::SimionPotentialArray::isCompressed() const {
+    return compressedPotentials_ != nullptr;
+}
+
+/**
+ * Gets the memory size of the (compressed or uncompressed) potential data in bytes
+ */
+std::size_t ParticleSimulation::SimionPotentialArray::dataSizeBytes() const {
+    if (compressedPotentials_){
+        return compressedPotentials_->compressedSizeBytes() + electrodeFlags_.size() / 8;
+    }
+    return points_.size() * sizeof(double);
+}
+
 /**
  * Internal isInside method (without coordinate transformation)
  */
@@ -683,6 +731,9 @@ bool ParticleSimulation::SimionPotentialArray::isInside_(double x, double y, dou
 }
 
 bool ParticleSimulation::SimionPotentialArray::isElectrode_(index_t ix, index_t iy, index_t iz) const{
+    if (compressedPotentials_){
+        return electrodeFlags_[static_cast<std::size_t>(linearIndex_(ix, iy, iz))];
+    }
     return rawPotential_(ix, iy, iz) > maxVoltage_;
 }
 
@@ -695,7 +746,7 @@ void ParticleSimulation::SimionPotentialArray::printState() const{
     std::cout << "mx: "<<mirrorx_ << " my: "<<mirrory_<< " mz: "<<mirrorz_ <<std::endl;
     //std::cout << "electrostatic: "<< electrostatic << " ng:"<< ng << std::endl;
 
-    for (std::size_t i=0; i< 10; ++i){
+    for (std::size_t i=0; i< std::min<std::size_t>(10, points_.size()); ++i){
         std::cout << " "<< points_[i];
     }
     std::cout << std::endl;
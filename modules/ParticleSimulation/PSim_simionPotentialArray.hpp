@@ -30,7 +30,10 @@
 
 
 #include "Core_vector.hpp"
+#include "PSim_compressedField.hpp"
+#include "Core_hugePageAllocator.hpp"
 #include <iostream>
+#include <memory>
 #include <string>
 #include <array>
 #include <vector>
@@ -77,6 +80,10 @@ namespace ParticleSimulation{
         [[nodiscard]] bool isElectrode(double xPt, double yPt, double zPt) const;
         [[nodiscard]] bool isInside(double xPt, double yPt, double zPt) const;
 
+        void compress(double errorBound = 0.0);
+        [[nodiscard]] bool isCompressed() const;
+        [[nodiscard]] std::size_t dataSizeBytes() const;
+
         [[nodiscard]] std::array<double, 6> getBounds() const;
         [[nodiscard]] std::array<index_t, 3> getNumberOfGridPoints() const;
         [[nodiscard]] std::string getHeaderString() const;
@@ -107,7 +114,9 @@ namespace ParticleSimulation{
         double spatialScale_; ///< Geometric scale between real world coordinates and PA coordinates
         double potentialScale_; ///< Scale factor between internal potentials and real world potential
 
-        std::vector<double> points_; ///< The raw data points of the PA in a linearized vector
+        Core::hugePageVector<double, Core::HugePageSubsystem::FIELD_GRIDS> points_; ///< The raw data points of the PA in a linearized vector
+        std::unique_ptr<CompressedField> compressedPotentials_; ///< Compressed potentials (without electrode offsets)
+        std::vector<bool> electrodeFlags_; ///< Electrode flags of the points (if potentials are compressed)
 
         int mode_ = 0;                       ///< Mode parameter of the SIMION PA
         const double nodeDistance_ = 1.0;    ///< Distance between nodes in the PA (in internal coordinates)
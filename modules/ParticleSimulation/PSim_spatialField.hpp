@@ -0,0 +1,77 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_spatialField.hpp
+
+ Abstract spatial field: Defines a generalized three dimensional field (scalars and 3d vectors) which can be sampled
+ at arbitrary spatial positions
+
+ ****************************/
+
+#ifndef Particle_simulation_spatial_field
+#define Particle_simulation_spatial_field
+
+#include "Core_vector.hpp"
+#include <array>
+#include <cstddef>
+
+namespace ParticleSimulation{
+
+    /**
+     * Abstract spatial field class: A three dimensional field, containing one or multiple scalar or 3d vector
+     * data fields, which can be sampled (interpolated) at arbitrary spatial positions.
+     *
+     * Sampling methods throw std::invalid_argument if a probed position is not within the domain of the field.
+     */
+    class SpatialField {
+
+    public:
+        virtual ~SpatialField() = default;
+
+        [[nodiscard]] virtual double getInterpolatedScalar(
+                double x, double y, double z, std::size_t fieldIndex) const = 0;
+        [[nodiscard]] virtual Core::Vector getInterpolatedVector(
+                double x, double y, double z, std::size_t fieldIndex) const = 0;
+
+        /**
+         * Gets an interpolated scalar with a location hint. The location hint is an implementation specific
+         * acceleration information for the spatial search (e.g. the last mesh element a particle was found in),
+         * which is typically stored per particle and updated by the field. Fields without spatial search ignore
+         * the hint.
+         */
+        [[nodiscard]] virtual double getInterpolatedScalar(
+                double x, double y, double z, std::size_t fieldIndex, std::size_t& /*locationHint*/) const{
+            return getInterpolatedScalar(x, y, z, fieldIndex);
+        }
+
+        /**
+         * Gets an interpolated vector with a location hint (see getInterpolatedScalar with location hint)
+         */
+        [[nodiscard]] virtual Core::Vector getInterpolatedVector(
+                double x, double y, double z, std::size_t fieldIndex, std::size_t& /*locationHint*/) const{
+            return getInterpolatedVector(x, y, z, fieldIndex);
+        }
+
+        [[nodiscard]] virtual std::array<double,6> getBounds() const = 0;
+    };
+}
+
+#endif //Particle_simulation_spatial_field
@@ -0,0 +1,186 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "PSim_swiftWaveform.hpp"
+#include "PSim_math.hpp"
+#include "Core_constants.hpp"
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Constructs a SWIFT waveform from a frequency domain specification
+ *
+ * @param frequencyLower lower end of the excited frequency range (Hz)
+ * @param frequencyUpper upper end of the excited frequency range (Hz)
+ * @param frequencyResolution frequency spacing of the spectral components (Hz), the waveform is periodic with
+ * the inverse of the frequency resolution
+ * @param notches frequency windows ([lower, upper] in Hz) which are not excited
+ */
+ParticleSimulation::SwiftWaveform::SwiftWaveform(double frequencyLower, double frequencyUpper,
+                                                 double frequencyResolution,
+                                                 const std::vector<std::array<double, 2>>& notches):
+frequencyResolution_(frequencyResolution)
+{
+    if (frequencyResolution <= 0.0 || frequencyLower < 0.0 || frequencyUpper <= frequencyLower){
+        throw (std::invalid_argument("Illegal frequency range or resolution of SWIFT waveform"));
+    }
+
+    auto harmonicLower = std::max(static_cast<std::size_t>(std::ceil(frequencyLower/frequencyResolution)),
+                                  std::size_t(1));
+    auto harmonicUpper = static_cast<std::size_t>(std::floor(frequencyUpper/frequencyResolution));
+    auto nFrequencyPoints = static_cast<double>(harmonicUpper - harmonicLower + 1);
+
+    for (std::size_t k=harmonicLower; k<=harmonicUpper; ++k){
+        double frequency = static_cast<double>(k)*frequencyResolution;
+        bool isNotched = std::any_of(notches.begin(), notches.end(),
+                [frequency](const std::array<double, 2>& notch){
+                    return frequency >= notch[0] && frequency <= notch[1];
+                });
+
+        if (!isNotched){
+            // quadratic phase modulation:
+            auto kRel = static_cast<double>(k - harmonicLower);
+            harmonics_.push_back(k);
+            phases_.push_back(M_PI*kRel*kRel/nFrequencyPoints);
+        }
+    }
+
+    if (harmonics_.empty()){
+        throw (std::invalid_argument("SWIFT waveform specification has no excited frequency components"));
+    }
+
+    // normalize the peak amplitude of the waveform, sampled with at least four samples per period of the
+    // highest frequency component:
+    std::size_t nNormalizationSamples = 64;
+    while (nNormalizationSamples < 4*harmonics_.back()){
+        nNormalizationSamples <<= 1;
+    }
+    std::vector<double> period = synthesizePeriod_(nNormalizationSamples);
+    double peak = 0.0;
+    for (double value: period){
+        peak = std::max(peak, std::fabs(value));
+    }
+    componentAmplitude_ = 1.0/peak;
+}
+
+/**
+ * Calculates the secular frequency of an ion in an ideal linear quadrupole (in the adiabatic approximation
+ * for small Mathieu q values), which can be used to specify SWIFT notches for ions of a given mass
+ *
+ * @param massAmu mass of the ion (amu)
+ * @param charge charge of the ion (elementary charges)
+ * @param rfAmplitude amplitude of the RF (V, zero to peak between pole and ground)
+ * @param rfFrequency frequency of the RF (Hz)
+ * @param r_0 inscribed radius of the quadrupole (m)
+ * @return the secular frequency (Hz)
+ */
+double ParticleSimulation::SwiftWaveform::linearQuadrupoleSecularFrequency(
+        double massAmu, double charge, double rfAmplitude, double rfFrequency, double r_0) {
+
+    double omega = 2.0*M_PI*rfFrequency;
+    double q = 4.0*charge*Core::ELEMENTARY_CHARGE*rfAmplitude / (massAmu*Core::AMU_TO_KG*r_0*r_0*omega*omega);
+    return q*rfFrequency / (2.0*std::sqrt(2.0));
+}
+
+/**
+ * Gets the number of excited frequency components
+ */
+std::size_t ParticleSimulation::SwiftWaveform::numberOfComponents() const {
+    return harmonics_.size();
+}
+
+/**
+ * Gets the period of the waveform (the inverse of the frequency resolution)
+ */
+double ParticleSimulation::SwiftWaveform::getPeriod() const {
+    return 1.0/frequencyResolution_;
+}
+
+/**
+ * Evaluates the waveform at an arbitrary time from the spectral representation
+ * @param time the time
+ */
+double ParticleSimulation::SwiftWaveform::getValue(double time) const {
+    // reduce the time to one period to retain the precision of the phase arguments:
+    double periodTime = time - std::floor(time*frequencyResolution_)/frequencyResolution_;
+    double omegaBase = 2.0*M_PI*frequencyResolution_*periodTime;
+
+    double result = 0.0;
+    for (std::size_t i=0; i<harmonics_.size(); ++i){
+        result += std::cos(omegaBase*static_cast<double>(harmonics_[i]) + phases_[i]);
+    }
+    return result*componentAmplitude_;
+}
+
+/**
+ * Synthesizes a sampled waveform table. If the waveform period is a power of two multiple of the sample spacing,
+ * one period is synthesized by inverse FFT and repeated, otherwise the samples are evaluated in parallel from the
+ * spectral representation.
+ *
+ * @param dt time spacing of the samples (typically the time step length of a simulation)
+ * @param nSamples number of samples to synthesize
+ * @return the synthesized samples, sample i is the waveform value at time i*dt
+ */
+std::vector<double> ParticleSimulation::SwiftWaveform::synthesize(double dt, std::size_t nSamples) const {
+    if (dt <= 0.0){
+        throw (std::invalid_argument("Illegal sample spacing for SWIFT waveform synthesis"));
+    }
+    std::vector<double> result(nSamples);
+
+    double samplesPerPeriod = getPeriod()/dt;
+    auto nPeriodSamples = static_cast<std::size_t>(std::llround(samplesPerPeriod));
+    bool useFFT = std::fabs(samplesPerPeriod - static_cast<double>(nPeriodSamples)) < 1e-9*samplesPerPeriod &&
+            isPowerOfTwo(nPeriodSamples) && nPeriodSamples > harmonics_.back();
+
+    if (useFFT){
+        std::vector<double> period = synthesizePeriod_(nPeriodSamples);
+        for (std::size_t i=0; i<nSamples; ++i){
+            result[i] = period[i % nPeriodSamples];
+        }
+    }
+    else {
+        #pragma omp parallel for default(none) shared(result, nSamples, dt) schedule(static)
+        for (std::size_t i=0; i<nSamples; ++i){
+            result[i] = getValue(static_cast<double>(i)*dt);
+        }
+    }
+    return result;
+}
+
+/**
+ * Synthesizes one period of the waveform by inverse FFT
+ * @param nSamples number of samples per period (a power of two larger than the highest harmonic index)
+ */
+std::vector<double> ParticleSimulation::SwiftWaveform::synthesizePeriod_(std::size_t nSamples) const {
+    std::vector<std::complex<double>> spectrum(nSamples, {0.0, 0.0});
+    for (std::size_t i=0; i<harmonics_.size(); ++i){
+        spectrum[harmonics_[i]] = std::polar(componentAmplitude_, phases_[i]);
+    }
+    inverseFFT(spectrum);
+
+    std::vector<double> result(nSamples);
+    for (std::size_t i=0; i<nSamples; ++i){
+        result[i] = spectrum[i].real();
+    }
+    return result;
+}
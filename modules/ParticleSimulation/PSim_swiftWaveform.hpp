@@ -0,0 +1,75 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_swiftWaveform.hpp
+
+ In process synthesis of SWIFT (stored waveform inverse Fourier transform) excitation waveforms from a frequency
+ domain specification
+
+ ****************************/
+
+#ifndef Particle_simulation_swift_waveform
+#define Particle_simulation_swift_waveform
+
+#include <vector>
+#include <array>
+#include <cstddef>
+
+namespace ParticleSimulation{
+
+    /**
+     * SWIFT (stored waveform inverse Fourier transform) excitation waveform.
+     *
+     * The waveform is specified in the frequency domain: A flat excitation magnitude spectrum in a frequency range,
+     * sampled with a frequency resolution, with notches (frequency windows without excitation, e.g. the secular
+     * frequencies of ions to isolate). The phases of the frequency components are modulated quadratically, which
+     * distributes the excitation energy over the whole waveform period and reduces the peak amplitude of the
+     * waveform. The time domain waveform is periodic with the inverse of the frequency resolution and is normalized
+     * to a peak amplitude of one.
+     *
+     * The waveform is stored in a compact spectral representation (the excited frequency components) and can be
+     * evaluated at arbitrary times, or synthesized into a sampled table by inverse FFT / parallel evaluation.
+     */
+    class SwiftWaveform {
+
+    public:
+        SwiftWaveform(double frequencyLower, double frequencyUpper, double frequencyResolution,
+                      const std::vector<std::array<double, 2>>& notches);
+
+        [[nodiscard]] static double linearQuadrupoleSecularFrequency(
+                double massAmu, double charge, double rfAmplitude, double rfFrequency, double r_0);
+
+        [[nodiscard]] std::size_t numberOfComponents() const;
+        [[nodiscard]] double getPeriod() const;
+        [[nodiscard]] double getValue(double time) const;
+        [[nodiscard]] std::vector<double> synthesize(double dt, std::size_t nSamples) const;
+
+    private:
+        double frequencyResolution_; ///< Frequency spacing of the spectral components (inverse of the period)
+        std::vector<std::size_t> harmonics_; ///< Harmonic indices (frequency / resolution) of the excited components
+        std::vector<double> phases_; ///< Phases of the excited components
+        double componentAmplitude_ = 1.0; ///< Amplitude of the components (normalizes the peak amplitude to one)
+
+        [[nodiscard]] std::vector<double> synthesizePeriod_(std::size_t nSamples) const;
+    };
+}
+
+#endif //Particle_simulation_swift_waveform
@@ -0,0 +1,524 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "PSim_tetrahedralMeshField.hpp"
+#include "FileIO_HDF5Reader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+template <hsize_t dims> using dataField =
+    FileIO::HDF5Reader::DataField<dims, double>;
+
+/**
+ * Constructor from a HDF5 file with a tetrahedral mesh data set. The file has to contain the node positions as
+ * (number of nodes x 3) dataset "/mesh/nodes" and the (zero based) node indices of the tetrahedral elements as
+ * (number of elements x 4) dataset "/mesh/elements". The data fields are given in the group "/fields", either as
+ * scalar nodal data (one dimensional datasets with one value per node) or as 3d vector nodal data
+ * (number of nodes x 3 datasets).
+ *
+ * @param hdf5Filename The filename of the HDF5 file to read
+ */
+ParticleSimulation::TetrahedralMeshField::TetrahedralMeshField(const std::string& hdf5Filename) {
+    FileIO::HDF5Reader h5Reader(hdf5Filename);
+
+    dataField<2> nodesDf = h5Reader.readDataset<2>("/mesh/nodes");
+    if (nodesDf.dims[1] != 3){
+        throw (std::invalid_argument("Mesh nodes dataset has to be of shape (number of nodes x 3)"));
+    }
+    for (hsize_t i=0; i<nodesDf.dims[0]; ++i){
+        nodes_.emplace_back(nodesDf.data[i*3], nodesDf.data[i*3+1], nodesDf.data[i*3+2]);
+    }
+
+    dataField<2> elementsDf = h5Reader.readDataset<2>("/mesh/elements");
+    if (elementsDf.dims[1] != 4){
+        throw (std::invalid_argument("Mesh elements dataset has to be of shape (number of elements x 4)"));
+    }
+    for (hsize_t i=0; i<elementsDf.dims[0]; ++i){
+        std::array<std::size_t, 4> element{};
+        for (hsize_t k=0; k<4; ++k){
+            double nodeIndex = elementsDf.data[i*4+k];
+            if (nodeIndex < 0.0){
+                throw (std::invalid_argument("Negative node index in mesh elements"));
+            }
+            element[k] = static_cast<std::size_t>(nodeIndex);
+        }
+        elements_.push_back(element);
+    }
+
+    initializeMesh_();
+
+    for (const auto& fieldName: h5Reader.namesOfDatasetsInGroup("/fields")) {
+        std::string fullFieldName = "/fields/"+fieldName;
+        const int nDims = h5Reader.datasetNDims(fullFieldName);
+        if (nDims==1) {
+            dataField<1> df = h5Reader.readDataset<1>(fullFieldName);
+            addScalarField(fieldName, df.data);
+        }
+        else if (nDims==2) {
+            dataField<2> df = h5Reader.readDataset<2>(fullFieldName);
+            if (df.dims[1] != 3 || df.dims[0] != nodes_.size()){
+                std::stringstream ss;
+                ss << "Dataset " << fieldName << " is not a nodal 3d vector field";
+                throw (std::invalid_argument(ss.str()));
+            }
+            std::vector<Core::Vector> vectors;
+            for (hsize_t i=0; i<df.dims[0]; ++i){
+                vectors.emplace_back(df.data[i*3], df.data[i*3+1], df.data[i*3+2]);
+            }
+            addVectorField(fieldName, vectors);
+        }
+        else {
+            std::stringstream ss;
+            ss << "Dataset " << fieldName << " has illegal dimensionality";
+            throw (std::invalid_argument(ss.str()));
+        }
+    }
+}
+
+/**
+ * Constructor from mesh data
+ *
+ * @param nodes The spatial positions of the mesh nodes
+ * @param elements The (zero based) node indices of the tetrahedral elements
+ */
+ParticleSimulation::TetrahedralMeshField::TetrahedralMeshField(
+        std::vector<Core::Vector> nodes, std::vector<std::array<std::size_t, 4>> elements):
+nodes_(std::move(nodes)),
+elements_(std::move(elements))
+{
+    initializeMesh_();
+}
+
+/**
+ * Adds a scalar data field with values defined on the mesh nodes
+ *
+ * @param fieldName The name of the new data field
+ * @param nodalValues The field values on the mesh nodes
+ */
+void ParticleSimulation::TetrahedralMeshField::addScalarField(const std::string& fieldName,
+                                                              std::vector<double> nodalValues) {
+    if (nodalValues.size() != nodes_.size()){
+        std::stringstream ss;
+        ss << "Scalar field " << fieldName << " has not one value per mesh node";
+        throw (std::invalid_argument(ss.str()));
+    }
+    fieldNames_.push_back(fieldName);
+    isVector_.push_back(false);
+    nodalFields_.push_back(std::move(nodalValues));
+}
+
+/**
+ * Adds a 3d vector data field with values defined on the mesh nodes
+ *
+ * @param fieldName The name of the new data field
+ * @param nodalValues The field vectors on the mesh nodes
+ */
+void ParticleSimulation::TetrahedralMeshField::addVectorField(const std::string& fieldName,
+                                                              const std::vector<Core::Vector>& nodalValues) {
+    if (nodalValues.size() != nodes_.size()){
+        std::stringstream ss;
+        ss << "Vector field " << fieldName << " has not one value per mesh node";
+        throw (std::invalid_argument(ss.str()));
+    }
+    std::vector<double> linearized;
+    linearized.reserve(nodalValues.size()*3);
+    for (const auto& vec: nodalValues){
+        linearized.push_back(vec.x());
+        linearized.push_back(vec.y());
+        linearized.push_back(vec.z());
+    }
+    fieldNames_.push_back(fieldName);
+    isVector_.push_back(true);
+    nodalFields_.push_back(std::move(linearized));
+}
+
+/**
+ * Gets the number of nodes in the mesh
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::getNumberOfNodes() const {
+    return nodes_.size();
+}
+
+/**
+ * Gets the number of tetrahedral elements in the mesh
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::getNumberOfElements() const {
+    return elements_.size();
+}
+
+/**
+ * Gets the names of the data fields (in the order of the field indices)
+ */
+std::vector<std::string> ParticleSimulation::TetrahedralMeshField::getFieldNames() const {
+    return fieldNames_;
+}
+
+/**
+ * Gets the outer spatial bounds (bounding box) of the mesh
+ */
+std::array<double,6> ParticleSimulation::TetrahedralMeshField::getBounds() const {
+    return bounds_;
+}
+
+/**
+ * Finds the element which contains a spatial position with the search grid
+ *
+ * @param position The probed position
+ * @return Index of the element containing the position or NO_ELEMENT if the position is not in the mesh
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::findElement(const Core::Vector& position) const {
+    return findElementInGrid_(position);
+}
+
+/**
+ * Finds the element which contains a spatial position with a walk through the mesh, beginning at a start element.
+ * The walk moves always to the neighbor element across the face with the most negative barycentric coordinate.
+ * If the walk leaves the mesh (e.g. at non convex boundaries) or takes too many steps, the search grid is used.
+ *
+ * @param position The probed position
+ * @param startElement The element to start the walk at (typically the last element of a particle)
+ * @return Index of the element containing the position or NO_ELEMENT if the position is not in the mesh
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::findElement(const Core::Vector& position,
+                                                                  std::size_t startElement) const {
+    if (startElement >= elements_.size()){
+        return findElementInGrid_(position);
+    }
+
+    std::size_t element = startElement;
+    for (std::size_t step=0; step<MAX_WALK_STEPS; ++step){
+        std::array<double, 4> lambda = barycentricCoordinates_(element, position);
+        auto minIt = std::min_element(lambda.begin(), lambda.end());
+        if (*minIt >= -BARYCENTRIC_TOLERANCE){
+            return element;
+        }
+        std::size_t next = neighbors_[element][static_cast<std::size_t>(minIt - lambda.begin())];
+        if (next == NO_ELEMENT){
+            break;
+        }
+        element = next;
+    }
+    return findElementInGrid_(position);
+}
+
+/**
+ * Gets an interpolated scalar for an arbitrary spatial position
+ * @param x Position of the probed data point in x direction
+ * @param y Position of the probed data point in y direction
+ * @param z Position of the probed data point in z direction
+ * @param fieldIndex The index of the data field to return an interpolated data point for
+ */
+double ParticleSimulation::TetrahedralMeshField::getInterpolatedScalar(double x, double y, double z,
+                                                                       std::size_t fieldIndex) const {
+    std::size_t locationHint = NO_ELEMENT;
+    return getInterpolatedScalar(x, y, z, fieldIndex, locationHint);
+}
+
+/**
+ * Gets an interpolated scalar for an arbitrary spatial position with a last element cache
+ * @param x Position of the probed data point in x direction
+ * @param y Position of the probed data point in y direction
+ * @param z Position of the probed data point in z direction
+ * @param fieldIndex The index of the data field to return an interpolated data point for
+ * @param locationHint The last element (e.g. of a particle) where the search is started, is updated to the
+ * element containing the probed position
+ */
+double ParticleSimulation::TetrahedralMeshField::getInterpolatedScalar(double x, double y, double z,
+                                                                       std::size_t fieldIndex,
+                                                                       std::size_t& locationHint) const {
+    enforceFieldType_(fieldIndex, false);
+    return interpolate_<double>(Core::Vector(x, y, z), fieldIndex, locationHint);
+}
+
+/**
+ * Gets an interpolated vector for an arbitrary spatial position
+ * @param x Position of the probed data point in x direction
+ * @param y Position of the probed data point in y direction
+ * @param z Position of the probed data point in z direction
+ * @param fieldIndex The index of the data field to return an interpolated 3d vector data point from
+ */
+Core::Vector ParticleSimulation::TetrahedralMeshField::getInterpolatedVector(double x, double y, double z,
+                                                                             std::size_t fieldIndex) const {
+    std::size_t locationHint = NO_ELEMENT;
+    return getInterpolatedVector(x, y, z, fieldIndex, locationHint);
+}
+
+/**
+ * Gets an interpolated vector for an arbitrary spatial position with a last element cache
+ * @param x Position of the probed data point in x direction
+ * @param y Position of the probed data point in y direction
+ * @param z Position of the probed data point in z direction
+ * @param fieldIndex The index of the data field to return an interpolated 3d vector data point from
+ * @param locationHint The last element (e.g. of a particle) where the search is started, is updated to the
+ * element containing the probed position
+ */
+Core::Vector ParticleSimulation::TetrahedralMeshField::getInterpolatedVector(double x, double y, double z,
+                                                                             std::size_t fieldIndex,
+                                                                             std::size_t& locationHint) const {
+    enforceFieldType_(fieldIndex, true);
+    return interpolate_<Core::Vector>(Core::Vector(x, y, z), fieldIndex, locationHint);
+}
+
+/**
+ * Checks the mesh, calculates the inverse element transforms, the mesh bounds, the element neighborhood and the
+ * search grid
+ */
+void ParticleSimulation::TetrahedralMeshField::initializeMesh_() {
+    if (nodes_.empty() || elements_.empty()){
+        throw (std::invalid_argument("Tetrahedral mesh without nodes or elements"));
+    }
+
+    bounds_ = {nodes_[0].x(), nodes_[0].x(), nodes_[0].y(), nodes_[0].y(), nodes_[0].z(), nodes_[0].z()};
+    for (const auto& node: nodes_){
+        bounds_[0] = std::min(bounds_[0], node.x());
+        bounds_[1] = std::max(bounds_[1], node.x());
+        bounds_[2] = std::min(bounds_[2], node.y());
+        bounds_[3] = std::max(bounds_[3], node.y());
+        bounds_[4] = std::min(bounds_[4], node.z());
+        bounds_[5] = std::max(bounds_[5], node.z());
+    }
+
+    inverseTransforms_.reserve(elements_.size());
+    for (std::size_t i=0; i<elements_.size(); ++i){
+        const std::array<std::size_t, 4>& el = elements_[i];
+        if (std::any_of(el.begin(), el.end(), [this](std::size_t nodeIndex){return nodeIndex >= nodes_.size();})){
+            std::stringstream ss;
+            ss << "Element " << i << " references a non existing mesh node";
+            throw (std::invalid_argument(ss.str()));
+        }
+
+        Core::Vector e1 = nodes_[el[1]] - nodes_[el[0]];
+        Core::Vector e2 = nodes_[el[2]] - nodes_[el[0]];
+        Core::Vector e3 = nodes_[el[3]] - nodes_[el[0]];
+
+        // the rows of the inverse of the edge matrix (e1, e2, e3) are the cross products of the edges
+        // divided by the determinant:
+        Core::Vector r1 = e2.crossProduct(e3);
+        Core::Vector r2 = e3.crossProduct(e1);
+        Core::Vector r3 = e1.crossProduct(e2);
+        double det = e1 * r1;
+        if (std::fabs(det) <= 1e-12 * e1.magnitude() * e2.magnitude() * e3.magnitude()){
+            std::stringstream ss;
+            ss << "Element " << i << " is degenerated";
+            throw (std::invalid_argument(ss.str()));
+        }
+        r1 = r1 / det;
+        r2 = r2 / det;
+        r3 = r3 / det;
+        inverseTransforms_.push_back({r1.x(), r1.y(), r1.z(), r2.x(), r2.y(), r2.z(), r3.x(), r3.y(), r3.z()});
+    }
+
+    buildNeighbors_();
+    buildSearchGrid_();
+}
+
+/**
+ * Finds the neighbor elements across the element faces by matching the sorted node indices of all faces
+ */
+void ParticleSimulation::TetrahedralMeshField::buildNeighbors_() {
+    struct Face{
+        std::array<std::size_t, 3> nodes;
+        std::size_t element;
+        std::size_t localIndex;
+    };
+
+    std::vector<Face> faces;
+    faces.reserve(elements_.size()*4);
+    for (std::size_t i=0; i<elements_.size(); ++i){
+        for (std::size_t k=0; k<4; ++k){
+            //face opposite to node k:
+            Face face{{elements_[i][(k+1)%4], elements_[i][(k+2)%4], elements_[i][(k+3)%4]}, i, k};
+            std::sort(face.nodes.begin(), face.nodes.end());
+            faces.push_back(face);
+        }
+    }
+    std::sort(faces.begin(), faces.end(), [](const Face& lhs, const Face& rhs){return lhs.nodes < rhs.nodes;});
+
+    neighbors_.assign(elements_.size(), {NO_ELEMENT, NO_ELEMENT, NO_ELEMENT, NO_ELEMENT});
+    for (std::size_t i=1; i<faces.size(); ++i){
+        if (faces[i].nodes == faces[i-1].nodes){
+            neighbors_[faces[i].element][faces[i].localIndex] = faces[i-1].element;
+            neighbors_[faces[i-1].element][faces[i-1].localIndex] = faces[i].element;
+        }
+    }
+}
+
+/**
+ * Builds a uniform search grid over the mesh bounds. Every grid cell stores the elements with bounding boxes
+ * overlapping the cell.
+ */
+void ParticleSimulation::TetrahedralMeshField::buildSearchGrid_() {
+    std::array<double, 3> extent{};
+    double minExtent = 1e-12 * std::max({bounds_[1]-bounds_[0], bounds_[3]-bounds_[2], bounds_[5]-bounds_[4], 1.0});
+    for (std::size_t d=0; d<3; ++d){
+        extent[d] = std::max(bounds_[2*d+1] - bounds_[2*d], minExtent);
+    }
+    double nCellsTarget = std::max(1.0, static_cast<double>(elements_.size()) / ELEMENTS_PER_GRID_CELL);
+    double cellEdge = std::cbrt(extent[0]*extent[1]*extent[2] / nCellsTarget);
+    for (std::size_t d=0; d<3; ++d){
+        gridDimensions_[d] = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(extent[d] / cellEdge)));
+        gridCellSize_[d] = extent[d] / static_cast<double>(gridDimensions_[d]);
+    }
+    std::size_t nCells = gridDimensions_[0]*gridDimensions_[1]*gridDimensions_[2];
+
+    auto cellIndexRange = [this](std::size_t element){
+        std::array<std::size_t, 6> range{};
+        for (std::size_t d=0; d<3; ++d){
+            double lower = std::numeric_limits<double>::max();
+            double upper = std::numeric_limits<double>::lowest();
+            for (std::size_t nodeIndex: elements_[element]){
+                const Core::Vector& node = nodes_[nodeIndex];
+                double coord = (d==0) ? node.x() : (d==1) ? node.y() : node.z();
+                lower = std::min(lower, coord);
+                upper = std::max(upper, coord);
+            }
+            double maxIndex = static_cast<double>(gridDimensions_[d] - 1);
+            range[2*d] = static_cast<std::size_t>(
+                    std::clamp(std::floor((lower - bounds_[2*d]) / gridCellSize_[d]), 0.0, maxIndex));
+            range[2*d+1] = static_cast<std::size_t>(
+                    std::clamp(std::floor((upper - bounds_[2*d]) / gridCellSize_[d]), 0.0, maxIndex));
+        }
+        return range;
+    };
+
+    //count elements per cell, then fill the concatenated element lists:
+    gridCellStart_.assign(nCells+1, 0);
+    for (int pass=0; pass<2; ++pass){
+        std::vector<std::size_t> fillPosition;
+        if (pass == 1){
+            for (std::size_t c=0; c<nCells; ++c){
+                gridCellStart_[c+1] += gridCellStart_[c];
+            }
+            gridElements_.resize(gridCellStart_[nCells]);
+            fillPosition.assign(gridCellStart_.begin(), gridCellStart_.end()-1);
+        }
+        for (std::size_t i=0; i<elements_.size(); ++i){
+            std::array<std::size_t, 6> range = cellIndexRange(i);
+            for (std::size_t iz=range[4]; iz<=range[5]; ++iz){
+                for (std::size_t iy=range[2]; iy<=range[3]; ++iy){
+                    for (std::size_t ix=range[0]; ix<=range[1]; ++ix){
+                        std::size_t cell = (iz*gridDimensions_[1] + iy)*gridDimensions_[0] + ix;
+                        if (pass == 0){
+                            ++gridCellStart_[cell+1];
+                        }
+                        else {
+                            gridElements_[fillPosition[cell]++] = i;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Calculates the barycentric coordinates of a position with respect to an element
+ */
+std::array<double, 4> ParticleSimulation::TetrahedralMeshField::barycentricCoordinates_(
+        std::size_t element, const Core::Vector& position) const {
+
+    const std::array<double, 9>& inv = inverseTransforms_[element];
+    Core::Vector d = position - nodes_[elements_[element][0]];
+    double l1 = inv[0]*d.x() + inv[1]*d.y() + inv[2]*d.z();
+    double l2 = inv[3]*d.x() + inv[4]*d.y() + inv[5]*d.z();
+    double l3 = inv[6]*d.x() + inv[7]*d.y() + inv[8]*d.z();
+    return {1.0 - l1 - l2 - l3, l1, l2, l3};
+}
+
+/**
+ * Finds the element containing a position with the search grid
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::findElementInGrid_(const Core::Vector& position) const {
+    std::array<double, 3> coords = {position.x(), position.y(), position.z()};
+    std::array<std::size_t, 3> cellIndices{};
+    for (std::size_t d=0; d<3; ++d){
+        if (coords[d] < bounds_[2*d] || coords[d] > bounds_[2*d+1]){
+            return NO_ELEMENT;
+        }
+        cellIndices[d] = std::min(
+                static_cast<std::size_t>((coords[d] - bounds_[2*d]) / gridCellSize_[d]), gridDimensions_[d] - 1);
+    }
+    std::size_t cell = (cellIndices[2]*gridDimensions_[1] + cellIndices[1])*gridDimensions_[0] + cellIndices[0];
+
+    for (std::size_t i=gridCellStart_[cell]; i<gridCellStart_[cell+1]; ++i){
+        std::size_t element = gridElements_[i];
+        std::array<double, 4> lambda = barycentricCoordinates_(element, position);
+        if (*std::min_element(lambda.begin(), lambda.end()) >= -BARYCENTRIC_TOLERANCE){
+            return element;
+        }
+    }
+    return NO_ELEMENT;
+}
+
+/**
+ * Locates the element containing a position, starting at a location hint, and updates the location hint
+ */
+std::size_t ParticleSimulation::TetrahedralMeshField::locate_(const Core::Vector& position,
+                                                              std::size_t& locationHint) const {
+    std::size_t element = findElement(position, locationHint);
+    if (element == NO_ELEMENT){
+        std::stringstream ss;
+        ss << "Point with coordinates " << position.x() <<" "<< position.y() <<" "<< position.z()
+           <<" is not in tetrahedral mesh field";
+        throw (std::invalid_argument(ss.str()));
+    }
+    locationHint = element;
+    return element;
+}
+
+void ParticleSimulation::TetrahedralMeshField::enforceFieldType_(std::size_t fieldIndex, bool vector) const {
+    if (fieldIndex >= isVector_.size()){
+        std::stringstream ss;
+        ss << "Data field " << fieldIndex <<" does not exist";
+        throw (std::invalid_argument(ss.str()));
+    }
+    if (isVector_[fieldIndex] != vector){
+        std::stringstream ss;
+        ss << "Data field " << fieldIndex <<" is not a " << (vector ? "vector" : "scalar") << " field";
+        throw (std::invalid_argument(ss.str()));
+    }
+}
+
+template<typename datT>
+datT ParticleSimulation::TetrahedralMeshField::interpolate_(const Core::Vector& position, std::size_t fieldIndex,
+                                                           std::size_t& locationHint) const {
+    std::size_t element = locate_(position, locationHint);
+    std::array<double, 4> lambda = barycentricCoordinates_(element, position);
+    const std::vector<double>& field = nodalFields_[fieldIndex];
+    const std::array<std::size_t, 4>& el = elements_[element];
+
+    if constexpr (std::is_same_v<datT, double>) {
+        return lambda[0]*field[el[0]] + lambda[1]*field[el[1]] + lambda[2]*field[el[2]] + lambda[3]*field[el[3]];
+    }
+    else if constexpr (std::is_same_v<datT, Core::Vector>) {
+        std::array<double, 3> result{0.0, 0.0, 0.0};
+        for (std::size_t k=0; k<4; ++k){
+            std::size_t iNode = el[k]*3;
+            result[0] += lambda[k]*field[iNode];
+            result[1] += lambda[k]*field[iNode+1];
+            result[2] += lambda[k]*field[iNode+2];
+        }
+        return {result[0], result[1], result[2]};
+    }
+}
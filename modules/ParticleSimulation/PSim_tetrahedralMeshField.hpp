@@ -0,0 +1,111 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_tetrahedralMeshField.hpp
+
+ Three dimensional field (scalars and 3d vectors) defined on the nodes of an unstructured tetrahedral mesh with
+ linear (barycentric) interpolation of the field values
+
+ ****************************/
+
+#ifndef Particle_simulation_tetrahedral_mesh_field
+#define Particle_simulation_tetrahedral_mesh_field
+
+#include "PSim_spatialField.hpp"
+#include "Core_vector.hpp"
+#include <vector>
+#include <array>
+#include <string>
+#include <limits>
+
+namespace ParticleSimulation{
+
+    /**
+     * Three dimensional field on an unstructured tetrahedral mesh (e.g. exported from a finite element solver),
+     * capable of containing multiple scalar and 3d vector fields defined on the mesh nodes. The field values are
+     * interpolated linearly with the barycentric coordinates (the linear shape functions) of the tetrahedral
+     * element containing a probed position.
+     *
+     * The element containing a position is located with a uniform grid of element buckets. If a location hint
+     * (the last element a particle was found in) is given, a walk through the element neighborhood is performed
+     * first, which is typically much faster since particles move only a short distance per time step.
+     */
+    class TetrahedralMeshField : public SpatialField {
+
+    public:
+        static constexpr std::size_t NO_ELEMENT = std::numeric_limits<std::size_t>::max(); ///< Marker for "no element found"
+
+        explicit TetrahedralMeshField(const std::string& hdf5Filename);
+        TetrahedralMeshField(std::vector<Core::Vector> nodes, std::vector<std::array<std::size_t, 4>> elements);
+
+        void addScalarField(const std::string& fieldName, std::vector<double> nodalValues);
+        void addVectorField(const std::string& fieldName, const std::vector<Core::Vector>& nodalValues);
+
+        [[nodiscard]] std::size_t getNumberOfNodes() const;
+        [[nodiscard]] std::size_t getNumberOfElements() const;
+        [[nodiscard]] std::vector<std::string> getFieldNames() const;
+        [[nodiscard]] std::array<double,6> getBounds() const override;
+
+        [[nodiscard]] std::size_t findElement(const Core::Vector& position) const;
+        [[nodiscard]] std::size_t findElement(const Core::Vector& position, std::size_t startElement) const;
+
+        [[nodiscard]] double getInterpolatedScalar(
+                double x, double y, double z, std::size_t fieldIndex) const override;
+        [[nodiscard]] double getInterpolatedScalar(
+                double x, double y, double z, std::size_t fieldIndex, std::size_t& locationHint) const override;
+        [[nodiscard]] Core::Vector getInterpolatedVector(
+                double x, double y, double z, std::size_t fieldIndex) const override;
+        [[nodiscard]] Core::Vector getInterpolatedVector(
+                double x, double y, double z, std::size_t fieldIndex, std::size_t& locationHint) const override;
+
+    private:
+        static constexpr double BARYCENTRIC_TOLERANCE = 1e-10; ///< Tolerance for a position to be inside an element
+        static constexpr std::size_t MAX_WALK_STEPS = 64; ///< Maximum number of steps of a neighborhood walk
+        static constexpr double ELEMENTS_PER_GRID_CELL = 2.0; ///< Mean number of elements per search grid cell
+
+        std::vector<Core::Vector> nodes_; ///< Spatial positions of the mesh nodes
+        std::vector<std::array<std::size_t, 4>> elements_; ///< Node indices of the tetrahedral elements
+        std::vector<std::array<std::size_t, 4>> neighbors_; ///< Neighbor element across the face opposite to a node
+        std::vector<std::array<double, 9>> inverseTransforms_; ///< Inverse edge matrices of the elements (row major)
+        std::array<double,6> bounds_; ///< Bounding box of the mesh
+
+        std::array<std::size_t, 3> gridDimensions_; ///< Number of search grid cells in the spatial directions
+        std::array<double, 3> gridCellSize_; ///< Size of the search grid cells
+        std::vector<std::size_t> gridCellStart_; ///< Start indices of the grid cell element lists in gridElements_
+        std::vector<std::size_t> gridElements_; ///< Concatenated element lists of the search grid cells
+
+        std::vector<std::string> fieldNames_; ///< Names of the data fields
+        std::vector<bool> isVector_; ///< Flag if data field is a vector
+        std::vector<std::vector<double>> nodalFields_; ///< Linearized nodal values of the data fields
+
+        void initializeMesh_();
+        void buildNeighbors_();
+        void buildSearchGrid_();
+        [[nodiscard]] std::array<double, 4> barycentricCoordinates_(std::size_t element, const Core::Vector& position) const;
+        [[nodiscard]] std::size_t findElementInGrid_(const Core::Vector& position) const;
+        [[nodiscard]] std::size_t locate_(const Core::Vector& position, std::size_t& locationHint) const;
+        void enforceFieldType_(std::size_t fieldIndex, bool vector) const;
+        template<typename datT> [[nodiscard]] datT interpolate_(
+                const Core::Vector& position, std::size_t fieldIndex, std::size_t& locationHint) const;
+    };
+}
+
+#endif //Particle_simulation_tetrahedral_mesh_field
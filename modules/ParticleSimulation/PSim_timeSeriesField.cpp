@@ -0,0 +1,232 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "PSim_timeSeriesField.hpp"
+#include "H5Cpp.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Constructs a time series field from a sequence of snapshot files. The first two snapshots are read immediately
+ * and the current time of the field is set to the time of the first snapshot.
+ *
+ * @param snapshotFilenames file names of the field snapshots (InterpolatedField HDF5 files)
+ * @param snapshotTimes times of the snapshots (strictly increasing)
+ */
+ParticleSimulation::TimeSeriesField::TimeSeriesField(std::vector<std::string> snapshotFilenames,
+                                                     std::vector<double> snapshotTimes):
+snapshotFilenames_(std::move(snapshotFilenames)),
+snapshotTimes_(std::move(snapshotTimes))
+{
+    if (snapshotFilenames_.size() != snapshotTimes_.size()){
+        throw (std::invalid_argument("Numbers of field snapshot files and snapshot times do not match"));
+    }
+    if (snapshotTimes_.size() < 2){
+        throw (std::invalid_argument("A time series field requires at least two snapshots"));
+    }
+    for (std::size_t i=1; i<snapshotTimes_.size(); ++i){
+        if (snapshotTimes_[i] <= snapshotTimes_[i-1]){
+            throw (std::invalid_argument("Times of field snapshots are not strictly increasing"));
+        }
+    }
+
+    // reading snapshots on a background thread is only safe with a thread safe HDF5 library:
+    hbool_t isThreadSafe = false;
+    asyncPrefetch_ = H5is_library_threadsafe(&isThreadSafe) >= 0 && isThreadSafe;
+
+    setTime(snapshotTimes_.front());
+}
+
+/**
+ * Destructor: Waits for a running prefetch of a snapshot
+ */
+ParticleSimulation::TimeSeriesField::~TimeSeriesField() {
+    if (asyncPrefetch_ && prefetch_.valid()){
+        prefetch_.wait();
+    }
+}
+
+/**
+ * Sets the current time of the field: The snapshots bracketing the time become the active snapshots, which are
+ * interpolated, and the reading of the following snapshot is started in the background. Snapshots which are not
+ * used anymore are released.
+ *
+ * @param time the new current time (has to be within the time range of the snapshots)
+ */
+void ParticleSimulation::TimeSeriesField::setTime(double time) {
+    if (time < snapshotTimes_.front() || time > snapshotTimes_.back()){
+        throw (std::invalid_argument("Time is outside of the time range of the field snapshots"));
+    }
+
+    auto upperIt = std::upper_bound(snapshotTimes_.begin(), snapshotTimes_.end(), time);
+    auto index = static_cast<std::size_t>(std::distance(snapshotTimes_.begin(), upperIt));
+    index = std::min(index > 0 ? index-1 : 0, snapshotTimes_.size()-2);
+
+    if (index != lowerIndex_){
+        std::shared_ptr<InterpolatedField> newLower = acquireSnapshot_(index);
+        std::shared_ptr<InterpolatedField> newUpper = acquireSnapshot_(index+1);
+        lower_ = std::move(newLower);
+        upper_ = std::move(newUpper);
+        lowerIndex_ = index;
+
+        // release a prefetched snapshot which is now active or not needed anymore:
+        if (prefetchIndex_ != NO_SNAPSHOT && prefetchIndex_ != index+2){
+            prefetch_ = std::shared_future<std::shared_ptr<InterpolatedField>>();
+            prefetchIndex_ = NO_SNAPSHOT;
+        }
+        if (index+2 < snapshotTimes_.size() && prefetchIndex_ == NO_SNAPSHOT){
+            startPrefetch_(index+2);
+        }
+    }
+
+    time_ = time;
+    weight_ = (time - snapshotTimes_[index]) / (snapshotTimes_[index+1] - snapshotTimes_[index]);
+}
+
+/**
+ * Gets the current time of the field
+ */
+double ParticleSimulation::TimeSeriesField::getTime() const {
+    return time_;
+}
+
+/**
+ * Gets the number of snapshots in the time series
+ */
+std::size_t ParticleSimulation::TimeSeriesField::numberOfSnapshots() const {
+    return snapshotTimes_.size();
+}
+
+/**
+ * Gets the time of a snapshot
+ * @param snapshotIndex index of the snapshot
+ */
+double ParticleSimulation::TimeSeriesField::getSnapshotTime(std::size_t snapshotIndex) const {
+    return snapshotTimes_.at(snapshotIndex);
+}
+
+/**
+ * Gets the number of snapshots which are currently resident in memory (or are currently read in the background)
+ */
+std::size_t ParticleSimulation::TimeSeriesField::numberOfResidentSnapshots() const {
+    std::size_t result = 2;
+    if (asyncPrefetch_ && prefetch_.valid()){
+        ++result;
+    }
+    return result;
+}
+
+/**
+ * Gets the number of snapshot reads started so far (snapshots are read again if the time is set backwards)
+ */
+std::size_t ParticleSimulation::TimeSeriesField::numberOfSnapshotsRead() const {
+    return nSnapshotsRead_;
+}
+
+/**
+ * Gets the size of the field data of the resident snapshots in memory (bytes)
+ */
+std::size_t ParticleSimulation::TimeSeriesField::dataSizeBytes() const {
+    std::size_t result = lower_->dataSizeBytes() + upper_->dataSizeBytes();
+    if (asyncPrefetch_ && prefetch_.valid() &&
+        prefetch_.wait_for(std::chrono::seconds(0)) == std::future_status::ready){
+        result += prefetch_.get()->dataSizeBytes();
+    }
+    return result;
+}
+
+/**
+ * Gets a scalar at the current time, interpolated linearly in time between the bracketing snapshots
+ *
+ * @param x X position
+ * @param y Y position
+ * @param z Z position
+ * @param fieldIndex index of the data field
+ */
+double ParticleSimulation::TimeSeriesField::getInterpolatedScalar(double x, double y, double z,
+                                                                  std::size_t fieldIndex) const {
+    return (1.0 - weight_) * lower_->getInterpolatedScalar(x, y, z, fieldIndex) +
+           weight_ * upper_->getInterpolatedScalar(x, y, z, fieldIndex);
+}
+
+/**
+ * Gets a vector at the current time, interpolated linearly in time between the bracketing snapshots
+ *
+ * @param x X position
+ * @param y Y position
+ * @param z Z position
+ * @param fieldIndex index of the data field
+ */
+Core::Vector ParticleSimulation::TimeSeriesField::getInterpolatedVector(double x, double y, double z,
+                                                                        std::size_t fieldIndex) const {
+    return lower_->getInterpolatedVector(x, y, z, fieldIndex) * (1.0 - weight_) +
+           upper_->getInterpolatedVector(x, y, z, fieldIndex) * weight_;
+}
+
+/**
+ * Gets the spatial bounds of the field (the bounds of the lower bracketing snapshot)
+ */
+std::array<double,6> ParticleSimulation::TimeSeriesField::getBounds() const {
+    return lower_->getBounds();
+}
+
+/**
+ * Gets a snapshot: An active or prefetched snapshot is reused, otherwise the snapshot is read from its file
+ * @param snapshotIndex index of the snapshot
+ */
+std::shared_ptr<ParticleSimulation::InterpolatedField> ParticleSimulation::TimeSeriesField::acquireSnapshot_(
+        std::size_t snapshotIndex) {
+
+    if (lowerIndex_ != NO_SNAPSHOT){
+        if (snapshotIndex == lowerIndex_){
+            return lower_;
+        }
+        if (snapshotIndex == lowerIndex_+1){
+            return upper_;
+        }
+    }
+    if (snapshotIndex == prefetchIndex_){
+        if (!asyncPrefetch_){
+            ++nSnapshotsRead_;
+        }
+        return prefetch_.get();
+    }
+    ++nSnapshotsRead_;
+    return std::make_shared<InterpolatedField>(snapshotFilenames_[snapshotIndex]);
+}
+
+/**
+ * Starts reading a snapshot on a background thread (or defers the reading to its first use, if the HDF5 library
+ * is not thread safe)
+ *
+ * @param snapshotIndex index of the snapshot to prefetch
+ */
+void ParticleSimulation::TimeSeriesField::startPrefetch_(std::size_t snapshotIndex) {
+    if (asyncPrefetch_){
+        ++nSnapshotsRead_;
+    }
+    std::string filename = snapshotFilenames_[snapshotIndex];
+    prefetch_ = std::async(asyncPrefetch_ ? std::launch::async : std::launch::deferred,
+            [filename](){
+                return std::make_shared<InterpolatedField>(filename);
+            }).share();
+    prefetchIndex_ = snapshotIndex;
+}
@@ -0,0 +1,102 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_timeSeriesField.hpp
+
+ Time dependent field, streamed from a sequence of field snapshots with linear interpolation in time
+
+ ****************************/
+
+#ifndef Particle_simulation_time_series_field
+#define Particle_simulation_time_series_field
+
+#include "PSim_spatialField.hpp"
+#include "PSim_interpolatedField.hpp"
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <future>
+#include <limits>
+
+namespace ParticleSimulation{
+
+    /**
+     * Time dependent three dimensional field, defined by a sequence of field snapshots (e.g. the results of a
+     * transient gas dynamics or electrode switching simulation) at increasing times. Every snapshot is an
+     * InterpolatedField HDF5 file, the snapshots should have the same spatial grid and the same data fields.
+     *
+     * The field is sampled at a current time, which is set with setTime(): The field values are interpolated
+     * linearly in time between the two snapshots bracketing the current time. Only a sliding window of snapshots
+     * is resident in memory: The two bracketing snapshots and the next snapshot, which is prefetched on a
+     * background thread while the simulation proceeds. Thus long transient simulations are possible with bounded
+     * memory and without stalls for reading the snapshots, as long as reading a snapshot is faster than
+     * simulating the time between two snapshots. If the HDF5 library is not thread safe, the next snapshot is read
+     * on demand instead of prefetched.
+     *
+     * Sampling the field is thread safe, setTime() must not be called concurrently to sampling (typically it is
+     * called once per time step, e.g. in the post time step function of an integrator).
+     */
+    class TimeSeriesField : public SpatialField {
+
+    public:
+        TimeSeriesField(std::vector<std::string> snapshotFilenames, std::vector<double> snapshotTimes);
+        ~TimeSeriesField() override;
+
+        TimeSeriesField(const TimeSeriesField&) = delete;
+        TimeSeriesField& operator=(const TimeSeriesField&) = delete;
+
+        void setTime(double time);
+        [[nodiscard]] double getTime() const;
+
+        [[nodiscard]] std::size_t numberOfSnapshots() const;
+        [[nodiscard]] double getSnapshotTime(std::size_t snapshotIndex) const;
+        [[nodiscard]] std::size_t numberOfResidentSnapshots() const;
+        [[nodiscard]] std::size_t numberOfSnapshotsRead() const;
+        [[nodiscard]] std::size_t dataSizeBytes() const;
+
+        using SpatialField::getInterpolatedScalar;
+        using SpatialField::getInterpolatedVector;
+        [[nodiscard]] double getInterpolatedScalar(double x, double y, double z, std::size_t fieldIndex) const override;
+        [[nodiscard]] Core::Vector getInterpolatedVector(double x, double y, double z, std::size_t fieldIndex) const override;
+        [[nodiscard]] std::array<double,6> getBounds() const override;
+
+    private:
+        static constexpr std::size_t NO_SNAPSHOT = std::numeric_limits<std::size_t>::max(); ///< Marker for "no snapshot"
+
+        std::vector<std::string> snapshotFilenames_; ///< File names of the snapshots
+        std::vector<double> snapshotTimes_;          ///< Times of the snapshots (strictly increasing)
+        double time_ = 0.0;                          ///< Current time of the field
+        double weight_ = 0.0;                        ///< Interpolation weight of the upper snapshot at the current time
+        std::size_t lowerIndex_ = NO_SNAPSHOT;       ///< Index of the lower bracketing snapshot
+        std::shared_ptr<InterpolatedField> lower_;   ///< Lower bracketing snapshot
+        std::shared_ptr<InterpolatedField> upper_;   ///< Upper bracketing snapshot
+        std::size_t prefetchIndex_ = NO_SNAPSHOT;    ///< Index of the snapshot which is prefetched
+        std::shared_future<std::shared_ptr<InterpolatedField>> prefetch_; ///< The snapshot which is prefetched
+        bool asyncPrefetch_ = true;                  ///< Flag if snapshots are prefetched on a background thread
+        std::size_t nSnapshotsRead_ = 0;             ///< Number of snapshot reads started so far
+
+        [[nodiscard]] std::shared_ptr<InterpolatedField> acquireSnapshot_(std::size_t snapshotIndex);
+        void startPrefetch_(std::size_t snapshotIndex);
+    };
+}
+
+#endif //Particle_simulation_time_series_field
@@ -0,0 +1,423 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "PSim_voltageSchedule.hpp"
+#include "Core_utils.hpp"
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    std::atomic<std::uint64_t> nextVoltageScheduleId{1}; ///< Source of unique ids of voltage schedules
+}
+
+/**
+ * Creates a constant signal
+ * @param value the constant signal value
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::constant(double value) {
+    return Signal(CONSTANT, value);
+}
+
+/**
+ * Creates a sinusoidal (RF) signal with the value amplitude * cos(2 pi frequency t + phase)
+ * @param amplitude amplitude of the signal
+ * @param frequency frequency of the signal (Hz)
+ * @param phase phase of the signal (rad)
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::sine(
+        double amplitude, double frequency, double phase) {
+
+    Signal result(SINE, amplitude);
+    result.frequency_ = frequency;
+    result.phase_ = phase;
+    return result;
+}
+
+/**
+ * Creates a rectangular pulse signal, which has the value amplitude in the time interval
+ * [startTime, startTime + duration) and zero otherwise
+ * @param amplitude amplitude of the pulse
+ * @param startTime start time of the pulse
+ * @param duration length of the pulse
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::pulse(
+        double amplitude, double startTime, double duration) {
+
+    if (duration < 0.0){
+        throw (std::invalid_argument("Negative pulse duration in voltage schedule signal"));
+    }
+    Signal result(PULSE, amplitude);
+    result.pulseStartTime_ = startTime;
+    result.pulseEndTime_ = startTime + duration;
+    return result;
+}
+
+/**
+ * Creates a signal from a sampled waveform with one sample per time step
+ * @param waveform the sampled waveform
+ * @param amplitude amplitude (scaling factor) of the waveform samples
+ * @param looped if true, the waveform is repeated periodically. If false, the signal is zero after the end of the
+ * waveform
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::sampled(
+        std::shared_ptr<SampledWaveform> waveform, double amplitude, bool looped) {
+
+    if (waveform == nullptr || !waveform->good() || waveform->size() == 0){
+        throw (std::invalid_argument("Invalid sampled waveform for voltage schedule signal"));
+    }
+    Signal result(looped ? SAMPLED_LOOPED : SAMPLED, amplitude);
+    result.waveform_ = std::move(waveform);
+    return result;
+}
+
+/**
+ * Creates a periodic traveling wave signal from a sampled waveform, which defines one period of the wave. The
+ * waveform is linearly interpolated.
+ * @param waveform the sampled waveform defining one period of the wave
+ * @param amplitude amplitude (scaling factor) of the waveform
+ * @param frequency frequency of the wave (Hz)
+ * @param phaseShift phase shift of the wave (in periods, typically the phase shift of an electrode in a stack)
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::travelingWave(
+        std::shared_ptr<SampledWaveform> waveform, double amplitude, double frequency, double phaseShift) {
+
+    if (waveform == nullptr || !waveform->good() || waveform->size() == 0){
+        throw (std::invalid_argument("Invalid sampled waveform for voltage schedule signal"));
+    }
+    if (frequency <= 0.0){
+        throw (std::invalid_argument("Illegal traveling wave frequency in voltage schedule signal"));
+    }
+    Signal result(TRAVELING_WAVE, amplitude);
+    result.waveform_ = std::move(waveform);
+    result.frequency_ = frequency;
+    result.phase_ = phaseShift;
+    return result;
+}
+
+/**
+ * Creates a SWIFT excitation signal, which is evaluated at arbitrary times from the spectral representation of the
+ * SWIFT waveform (the SWIFT waveform is periodic and normalized to a peak amplitude of one)
+ * @param waveform the SWIFT waveform
+ * @param amplitude amplitude (scaling factor) of the waveform
+ */
+ParticleSimulation::VoltageSchedule::Signal ParticleSimulation::VoltageSchedule::Signal::swift(
+        std::shared_ptr<SwiftWaveform> waveform, double amplitude) {
+
+    if (waveform == nullptr){
+        throw (std::invalid_argument("Invalid SWIFT waveform for voltage schedule signal"));
+    }
+    Signal result(SWIFT, amplitude);
+    result.swiftWaveform_ = std::move(waveform);
+    return result;
+}
+
+/**
+ * Constructor
+ */
+ParticleSimulation::VoltageSchedule::Signal::Signal(CarrierType carrierType, double amplitude):
+carrierType_(carrierType),
+amplitudeStart_(amplitude),
+amplitudeEnd_(amplitude)
+{}
+
+/**
+ * Defines a linear ramp of the signal amplitude: The amplitude is ramped linearly from the initial amplitude at
+ * rampStartTime to endAmplitude at rampEndTime and is constant before and after the ramp.
+ *
+ * @param endAmplitude amplitude at the end of the ramp
+ * @param rampStartTime start time of the ramp
+ * @param rampEndTime end time of the ramp
+ * @return reference to this signal
+ */
+ParticleSimulation::VoltageSchedule::Signal& ParticleSimulation::VoltageSchedule::Signal::setAmplitudeRamp(
+        double endAmplitude, double rampStartTime, double rampEndTime) {
+
+    if (rampEndTime < rampStartTime){
+        throw (std::invalid_argument("Amplitude ramp of voltage schedule signal ends before its start"));
+    }
+    amplitudeEnd_ = endAmplitude;
+    rampStartTime_ = rampStartTime;
+    rampEndTime_ = rampEndTime;
+    return *this;
+}
+
+/**
+ * Delays the carrier waveform of sampled and SWIFT signals: The waveform starts at startTime (SWIFT carriers) or
+ * at the time step startTimestep (sampled carriers, which are indexed by the time step) and the signal is zero
+ * before. Other carrier types are not affected.
+ *
+ * @param startTime start time of the carrier waveform
+ * @param startTimestep start time step index of the carrier waveform
+ * @return reference to this signal
+ */
+ParticleSimulation::VoltageSchedule::Signal& ParticleSimulation::VoltageSchedule::Signal::setCarrierStart(
+        double startTime, unsigned int startTimestep) {
+
+    carrierStartTime_ = startTime;
+    carrierStartTimestep_ = startTimestep;
+    return *this;
+}
+
+/**
+ * Gets the type of the carrier waveform of the signal
+ */
+ParticleSimulation::VoltageSchedule::Signal::CarrierType
+ParticleSimulation::VoltageSchedule::Signal::carrierType() const {
+    return carrierType_;
+}
+
+/**
+ * Gets the amplitude (the envelope) of the signal at a time
+ * @param time the time
+ */
+double ParticleSimulation::VoltageSchedule::Signal::amplitude(double time) const {
+    if (time >= rampEndTime_){
+        return amplitudeEnd_;
+    }
+    else if (time <= rampStartTime_){
+        return amplitudeStart_;
+    }
+    double rampFraction = (time - rampStartTime_) / (rampEndTime_ - rampStartTime_);
+    return amplitudeStart_ + (amplitudeEnd_ - amplitudeStart_) * rampFraction;
+}
+
+/**
+ * Gets the value of the signal
+ * @param time the time
+ * @param timestep the time step index (used by sampled waveforms)
+ */
+double ParticleSimulation::VoltageSchedule::Signal::value(double time, unsigned int timestep) const {
+    double signalAmplitude = amplitude(time);
+    switch (carrierType_) {
+        case CONSTANT:
+            return signalAmplitude;
+        case SINE:
+            return signalAmplitude * std::cos(2.0 * M_PI * frequency_ * time + phase_);
+        case PULSE:
+            return (time >= pulseStartTime_ && time < pulseEndTime_) ? signalAmplitude : 0.0;
+        case SAMPLED: {
+            if (timestep < carrierStartTimestep_){
+                return 0.0;
+            }
+            std::size_t sampleIndex = timestep - carrierStartTimestep_;
+            return sampleIndex < waveform_->size() ? signalAmplitude * waveform_->getValue(sampleIndex) : 0.0;
+        }
+        case SAMPLED_LOOPED:
+            return timestep < carrierStartTimestep_ ? 0.0 :
+                signalAmplitude * waveform_->getValueLooped(timestep - carrierStartTimestep_);
+        case TRAVELING_WAVE: {
+            double phase = time * frequency_ + phase_;
+            phase = phase - std::floor(phase);
+            return signalAmplitude * waveform_->getInterpolatedValue(phase);
+        }
+        case SWIFT:
+            return time < carrierStartTime_ ? 0.0 :
+                signalAmplitude * swiftWaveform_->getValue(time - carrierStartTime_);
+    }
+    return 0.0; // should never happen, since all carrier types are handled above
+}
+
+/**
+ * Constructs an empty voltage schedule (all electrode voltages are zero)
+ * @param numberOfElectrodes the number of electrodes
+ */
+ParticleSimulation::VoltageSchedule::VoltageSchedule(std::size_t numberOfElectrodes):
+id_(nextVoltageScheduleId++),
+nElectrodes_(numberOfElectrodes),
+offsets_(numberOfElectrodes, 0.0)
+{}
+
+/**
+ * Adds a signal to the schedule. Initially, the signal does not contribute to any electrode voltage.
+ * @param name unique name of the signal
+ * @param signal the signal to add
+ * @return the index of the added signal
+ */
+std::size_t ParticleSimulation::VoltageSchedule::addSignal(const std::string& name, const Signal& signal) {
+    if (std::find(signalNames_.begin(), signalNames_.end(), name) != signalNames_.end()){
+        throw (std::invalid_argument("Signal " + name + " is already defined in voltage schedule"));
+    }
+    signalNames_.push_back(name);
+    signals_.push_back(signal);
+    factors_.resize(factors_.size() + nElectrodes_, 0.0);
+    renewId_();
+    return signals_.size() - 1;
+}
+
+/**
+ * Sets the constant voltage offset of an electrode
+ */
+void ParticleSimulation::VoltageSchedule::setElectrodeOffset(std::size_t electrodeIndex, double offset) {
+    checkElectrodeIndex_(electrodeIndex);
+    offsets_[electrodeIndex] = offset;
+    renewId_();
+}
+
+/**
+ * Sets the factor of a signal in the voltage of an electrode
+ * @param electrodeIndex index of the electrode
+ * @param signalIndex index of the signal
+ * @param factor the factor of the signal in the electrode voltage
+ */
+void ParticleSimulation::VoltageSchedule::setElectrodeFactor(
+        std::size_t electrodeIndex, std::size_t signalIndex, double factor) {
+
+    checkElectrodeIndex_(electrodeIndex);
+    if (signalIndex >= signals_.size()){
+        throw (std::invalid_argument("Illegal signal index in voltage schedule"));
+    }
+    factors_[signalIndex * nElectrodes_ + electrodeIndex] = factor;
+    renewId_();
+}
+
+/**
+ * Sets the factor of a signal, given by its name, in the voltage of an electrode
+ */
+void ParticleSimulation::VoltageSchedule::setElectrodeFactor(
+        std::size_t electrodeIndex, const std::string& signalName, double factor) {
+    setElectrodeFactor(electrodeIndex, signalIndex(signalName), factor);
+}
+
+/**
+ * Gets the number of electrodes
+ */
+std::size_t ParticleSimulation::VoltageSchedule::numberOfElectrodes() const {
+    return nElectrodes_;
+}
+
+/**
+ * Gets the number of signals
+ */
+std::size_t ParticleSimulation::VoltageSchedule::numberOfSignals() const {
+    return signals_.size();
+}
+
+/**
+ * Checks if a signal with a name is defined in the schedule
+ */
+bool ParticleSimulation::VoltageSchedule::hasSignal(const std::string& name) const {
+    return std::find(signalNames_.begin(), signalNames_.end(), name) != signalNames_.end();
+}
+
+/**
+ * Gets the index of a signal by its name
+ */
+std::size_t ParticleSimulation::VoltageSchedule::signalIndex(const std::string& name) const {
+    auto it = std::find(signalNames_.begin(), signalNames_.end(), name);
+    if (it == signalNames_.end()){
+        throw (std::invalid_argument("Signal " + name + " is not defined in voltage schedule"));
+    }
+    return static_cast<std::size_t>(it - signalNames_.begin());
+}
+
+/**
+ * Gets a signal by its index
+ */
+const ParticleSimulation::VoltageSchedule::Signal& ParticleSimulation::VoltageSchedule::signal(
+        std::size_t signalIndex) const {
+    return signals_.at(signalIndex);
+}
+
+/**
+ * Gets a signal by its name
+ */
+const ParticleSimulation::VoltageSchedule::Signal& ParticleSimulation::VoltageSchedule::signal(
+        const std::string& name) const {
+    return signals_[signalIndex(name)];
+}
+
+/**
+ * Gets the voltages of all electrodes. The evaluated voltages are memorized in a per thread cache, thus the
+ * voltages are calculated only once per time (sub)step and thread, even if they are queried for every particle.
+ *
+ * The returned reference points into the per thread cache and is valid until voltages are requested for
+ * more than CACHE_SIZE other times by the calling thread.
+ *
+ * @param time the time
+ * @param timestep the time step index
+ * @return the voltages of the electrodes
+ */
+const std::vector<double>& ParticleSimulation::VoltageSchedule::voltages(double time, unsigned int timestep) const {
+    thread_local std::vector<CacheEntry> evaluationCache(CACHE_SIZE);
+    thread_local std::size_t nextCacheSlot = 0;
+
+    for (CacheEntry& entry: evaluationCache){
+        if (entry.scheduleId == id_ && entry.timestep == timestep && Core::isDoubleEqual(entry.time, time)){
+            return entry.voltages;
+        }
+    }
+
+    CacheEntry& entry = evaluationCache[nextCacheSlot];
+    nextCacheSlot = (nextCacheSlot + 1) % CACHE_SIZE;
+    evaluate(time, timestep, entry.voltages);
+    entry.scheduleId = id_;
+    entry.time = time;
+    entry.timestep = timestep;
+    return entry.voltages;
+}
+
+/**
+ * Gets the voltage of a single electrode (see voltages)
+ */
+double ParticleSimulation::VoltageSchedule::voltage(
+        std::size_t electrodeIndex, double time, unsigned int timestep) const {
+    checkElectrodeIndex_(electrodeIndex);
+    return voltages(time, timestep)[electrodeIndex];
+}
+
+/**
+ * Evaluates the voltages of all electrodes without caching
+ * @param time the time
+ * @param timestep the time step index
+ * @param voltages vector to write the electrode voltages to (resized to the number of electrodes)
+ */
+void ParticleSimulation::VoltageSchedule::evaluate(double time, unsigned int timestep,
+                                                   std::vector<double>& voltages) const {
+    voltages.assign(offsets_.begin(), offsets_.end());
+    for (std::size_t s = 0; s < signals_.size(); ++s){
+        double signalValue = signals_[s].value(time, timestep);
+        if (Core::isDoubleUnequal(signalValue, 0.0)){
+            const double* signalFactors = factors_.data() + s * nElectrodes_;
+            for (std::size_t e = 0; e < nElectrodes_; ++e){
+                voltages[e] += signalFactors[e] * signalValue;
+            }
+        }
+    }
+}
+
+/**
+ * Throws if an electrode index is out of range
+ */
+void ParticleSimulation::VoltageSchedule::checkElectrodeIndex_(std::size_t electrodeIndex) const {
+    if (electrodeIndex >= nElectrodes_){
+        throw (std::invalid_argument("Illegal electrode index in voltage schedule"));
+    }
+}
+
+/**
+ * Renews the unique id of the schedule, which invalidates all memorized evaluations in the per thread caches
+ */
+void ParticleSimulation::VoltageSchedule::renewId_() {
+    id_ = nextVoltageScheduleId++;
+}
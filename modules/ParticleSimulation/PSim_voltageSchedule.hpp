@@ -0,0 +1,144 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ PSim_voltageSchedule.hpp
+
+ Declarative schedule of time dependent electrode voltages: The voltages of a set of electrodes are defined as
+ linear combinations of time dependent signals (DC, RF, ramps, pulses, sampled waveforms, traveling waves,
+ SWIFT waveforms)
+
+ ****************************/
+
+#ifndef Particle_simulation_voltage_schedule
+#define Particle_simulation_voltage_schedule
+
+#include "PSim_sampledWaveform.hpp"
+#include "PSim_swiftWaveform.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace ParticleSimulation{
+
+    /**
+     * Declarative schedule of time dependent electrode voltages.
+     *
+     * A voltage schedule consists of a set of named signals and a set of electrodes. The voltage of an electrode is
+     * a constant offset plus a linear combination of the signal values:
+     *
+     *      U_electrode(t) = offset_electrode + sum_signals factor_(electrode, signal) * signal(t)
+     *
+     * The electrode voltages depend only on the time (and the time step index), thus they are evaluated only once
+     * per time (sub)step into a flat vector of electrode voltages, instead of recalculating them for every particle.
+     * The evaluated voltages are memorized in a small per thread cache, therefore the schedule can be queried
+     * directly from the parallel particle loops of the integrators.
+     */
+    class VoltageSchedule {
+
+    public:
+        /**
+         * A time dependent signal: The signal value is the product of an amplitude envelope (constant or
+         * linearly ramped between a start and an end time) and a carrier waveform.
+         */
+        class Signal {
+
+        public:
+            enum CarrierType {CONSTANT, SINE, PULSE, SAMPLED, SAMPLED_LOOPED, TRAVELING_WAVE, SWIFT};
+
+            static Signal constant(double value);
+            static Signal sine(double amplitude, double frequency, double phase = 0.0);
+            static Signal pulse(double amplitude, double startTime, double duration);
+            static Signal sampled(std::shared_ptr<SampledWaveform> waveform, double amplitude, bool looped = false);
+            static Signal travelingWave(std::shared_ptr<SampledWaveform> waveform, double amplitude,
+                                        double frequency, double phaseShift);
+            static Signal swift(std::shared_ptr<SwiftWaveform> waveform, double amplitude);
+
+            Signal& setAmplitudeRamp(double endAmplitude, double rampStartTime, double rampEndTime);
+            Signal& setCarrierStart(double startTime, unsigned int startTimestep);
+
+            [[nodiscard]] CarrierType carrierType() const;
+            [[nodiscard]] double amplitude(double time) const;
+            [[nodiscard]] double value(double time, unsigned int timestep) const;
+
+        private:
+            explicit Signal(CarrierType carrierType, double amplitude);
+
+            CarrierType carrierType_; ///< Type of the carrier waveform
+            double amplitudeStart_; ///< Amplitude before / at the start of the amplitude ramp
+            double amplitudeEnd_; ///< Amplitude at / after the end of the amplitude ramp
+            double rampStartTime_ = 0.0; ///< Start time of the linear amplitude ramp
+            double rampEndTime_ = 0.0; ///< End time of the linear amplitude ramp
+            double frequency_ = 0.0; ///< Frequency of sine and traveling wave carriers (Hz)
+            double phase_ = 0.0; ///< Phase (rad) of sine carriers / phase shift (periods) of traveling waves
+            double pulseStartTime_ = 0.0; ///< Start time of pulse carriers
+            double pulseEndTime_ = 0.0; ///< End time of pulse carriers
+            double carrierStartTime_ = 0.0; ///< Start time of SWIFT carriers
+            unsigned int carrierStartTimestep_ = 0; ///< Start time step of sampled carriers
+            std::shared_ptr<SampledWaveform> waveform_ = nullptr; ///< Sampled waveform of sampled carriers
+            std::shared_ptr<SwiftWaveform> swiftWaveform_ = nullptr; ///< SWIFT waveform of SWIFT carriers
+        };
+
+        explicit VoltageSchedule(std::size_t numberOfElectrodes);
+
+        std::size_t addSignal(const std::string& name, const Signal& signal);
+        void setElectrodeOffset(std::size_t electrodeIndex, double offset);
+        void setElectrodeFactor(std::size_t electrodeIndex, std::size_t signalIndex, double factor);
+        void setElectrodeFactor(std::size_t electrodeIndex, const std::string& signalName, double factor);
+
+        [[nodiscard]] std::size_t numberOfElectrodes() const;
+        [[nodiscard]] std::size_t numberOfSignals() const;
+        [[nodiscard]] bool hasSignal(const std::string& name) const;
+        [[nodiscard]] std::size_t signalIndex(const std::string& name) const;
+        [[nodiscard]] const Signal& signal(std::size_t signalIndex) const;
+        [[nodiscard]] const Signal& signal(const std::string& name) const;
+
+        [[nodiscard]] const std::vector<double>& voltages(double time, unsigned int timestep) const;
+        [[nodiscard]] double voltage(std::size_t electrodeIndex, double time, unsigned int timestep) const;
+        void evaluate(double time, unsigned int timestep, std::vector<double>& voltages) const;
+
+    private:
+        static constexpr std::size_t CACHE_SIZE = 4; ///< Number of memorized evaluations per thread
+
+        /**
+         * Memorized evaluation of the electrode voltages in the per thread cache
+         */
+        struct CacheEntry{
+            std::uint64_t scheduleId = 0; ///< Unique id of the schedule / configuration (0 = empty)
+            double time = 0.0; ///< Time of the evaluation
+            unsigned int timestep = 0; ///< Time step index of the evaluation
+            std::vector<double> voltages; ///< The evaluated electrode voltages
+        };
+
+        std::uint64_t id_; ///< Unique id of the current configuration of the schedule (key of the per thread cache)
+        std::size_t nElectrodes_; ///< Number of electrodes
+        std::vector<std::string> signalNames_; ///< Names of the signals
+        std::vector<Signal> signals_; ///< The signals
+        std::vector<double> offsets_; ///< Constant voltage offsets of the electrodes
+        std::vector<double> factors_; ///< Signal factors of the electrodes (flat, signal major)
+
+        void checkElectrodeIndex_(std::size_t electrodeIndex) const;
+        void renewId_();
+    };
+}
+
+#endif //Particle_simulation_voltage_schedule
@@ -44,18 +44,18 @@ collisionReaction_(isCollisionReaction)
 {
     //init educts table
     //search discrete educts, calculate static reaction probability
-    int nDiscrete = 0; //number of found discrete educt reaction partners
+    int nDiscrete = 0; //number of discrete educt particles
     for (auto it = educts_.begin(); it != educts_.end(); ++it) {
         RS::Substance* subst =it->first;
         const int sto_factor = it->second; //stochiometric factor
         if (subst->type() == Substance::substanceType::discrete){
-            nDiscrete++;
+            nDiscrete += sto_factor;
             discreteEducts_[subst] = sto_factor;
         }
     }
     this->updateStaticReactionConcentration();
 
-    //if we have only one discrete educt, the whole reaction is classified as independent
+    //if we have only one discrete educt particle, the whole reaction is classified as independent
     if (nDiscrete == 1 ){
         independent_ = true;
     }
@@ -99,6 +99,17 @@ bool RS::AbstractReaction::generateRandomDecision(double probability) const{
     return (rndVal < probability);
 }
 
+/**
+ * Applies the modifications of the reacting particle by a reaction event (e.g. a reinitialization of the
+ * particle velocity), if the reaction event was not sampled by attemptReaction but by the reaction simulation
+ * from the reaction rate. The default implementation does not modify the particle.
+ *
+ * @param conditions the reaction conditions of the reaction event
+ * @param particle the reacting particle
+ */
+void RS::AbstractReaction::applyReactionEffects(RS::ReactionConditions /*conditions*/,
+                                                RS::ReactiveParticle* /*particle*/) const {}
+
 /**
  * Independent reactions are dependent on only one discrete educt / substance modeled in terms of discrete particles
  * @return if this reaction is independent
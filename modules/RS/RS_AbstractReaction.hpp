@@ -97,6 +97,10 @@ namespace RS {
         //a particle pointer is passed to the attemptReaction methods to allow modifications of the particles in the reaction
         virtual ReactionEvent attemptReaction(ReactionConditions conditions, ReactiveParticle* particle, double dt) const = 0;
         virtual ReactionEvent attemptReaction(CollisionConditions conditions, ReactiveParticle* particle) const = 0;
+        //the pseudo first order reaction rate (1/s) of a discrete educt particle:
+        [[nodiscard]] virtual double reactionRate(ReactionConditions conditions) const = 0;
+        //modifications of the reacting particle by a reaction event which is not sampled by attemptReaction:
+        virtual void applyReactionEffects(ReactionConditions conditions, ReactiveParticle* particle) const;
 
         [[nodiscard]] bool isIndependent() const;
         [[nodiscard]] bool isCollisionReaction() const;
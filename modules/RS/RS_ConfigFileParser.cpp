@@ -211,6 +211,19 @@ bool RS::ConfigFileParser::parseReactions(SimulationConfiguration *simConf, cons
                         parsedParams.at(3),
                         labelStr);
             }
+            else if(typeStr == "encounter"){
+                try {
+                    reaction = std::make_unique<RS::DiscreteEncounterReaction>(
+                            educts,
+                            products,
+                            parsedParams.at(0),
+                            parsedParams.at(1),
+                            labelStr);
+                }
+                catch (const std::invalid_argument& ex){
+                    throw (RS::ConfigurationFileException(ex.what()));
+                }
+            }
 
 
 
@@ -218,6 +231,18 @@ bool RS::ConfigFileParser::parseReactions(SimulationConfiguration *simConf, cons
                 throw (RS::ConfigurationFileException("Illegal reaction in configuration file"));
             }
 
+            // reactions of two or more particles of the same discrete substance (e.g. 2A => B) are only modeled
+            // as encounter reactions, since the other reaction types are only performed for independent reactions:
+            if (typeStr != "encounter"){
+                for (const auto& discreteEduct: *reaction->discreteEducts()){
+                    if (discreteEduct.second > 1){
+                        throw (RS::ConfigurationFileException(
+                                "Reaction " + labelStr + " of more than one particle of a discrete substance is "
+                                "only supported as encounter reaction"));
+                    }
+                }
+            }
+
             simConf->addReaction(reaction);
         }
     }
@@ -37,6 +37,7 @@
 #include "RS_SimpleCollisionStepReaction.hpp"
 #include "RS_VantHoffReaction.hpp"
 #include "RS_FieldDependentVantHoffReaction.hpp"
+#include "RS_DiscreteEncounterReaction.hpp"
 #include <iostream>
 #include <memory>
 #include <vector>
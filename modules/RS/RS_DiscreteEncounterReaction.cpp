@@ -0,0 +1,117 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "RS_DiscreteEncounterReaction.hpp"
+#include <stdexcept>
+
+/**
+ * Constructs a discrete encounter reaction
+ *
+ * @param educts Map of educt species (must contain exactly two discrete particles and no isotropic substances)
+ * @param products Map of product species (at most one discrete product particle)
+ * @param encounterRadius the distance below which the educt particles can react (m)
+ * @param microscopicRate the reaction rate of particles within the encounter radius (1/s)
+ * @param label a textual label to identify the reaction
+ */
+RS::DiscreteEncounterReaction::DiscreteEncounterReaction(const std::map<RS::Substance*, int>& educts,
+                                                         const std::map<RS::Substance*, int>& products,
+                                                         double encounterRadius, double microscopicRate,
+                                                         const std::string label):
+AbstractReaction(educts, products, false, "encounter", label),
+encounterRadius_(encounterRadius),
+microscopicRate_(microscopicRate)
+{
+    int nDiscreteEducts = 0;
+    for (const auto& educt: *this->educts()){
+        if (educt.first->type() != Substance::substanceType::discrete){
+            throw (std::invalid_argument("Encounter reaction with non discrete educt"));
+        }
+        nDiscreteEducts += educt.second;
+    }
+    int nDiscreteProducts = 0;
+    for (const auto& product: *this->discreteProducts()){
+        nDiscreteProducts += product.second;
+    }
+    if (nDiscreteEducts != 2 || nDiscreteProducts > 1){
+        throw (std::invalid_argument(
+                "Encounter reaction requires exactly two discrete educts and at most one discrete product"));
+    }
+    if (encounterRadius <= 0.0 || microscopicRate < 0.0){
+        throw (std::invalid_argument("Illegal encounter radius or rate of encounter reaction"));
+    }
+}
+
+/*
+ * Encounter reactions are performed for pairs of particles by the simulation, thus this method should not be called
+ */
+RS::ReactionEvent RS::DiscreteEncounterReaction::attemptReaction(RS::ReactionConditions,
+                                                                 ReactiveParticle*, double) const{
+    throw std::logic_error(
+        "Single particle reaction probability requested for encounter reaction DiscreteEncounterReaction");
+}
+
+/*
+ * Encounter reactions are not collision based, thus this method should not be called
+ */
+RS::ReactionEvent RS::DiscreteEncounterReaction::attemptReaction(CollisionConditions, ReactiveParticle*) const{
+    throw std::logic_error(
+        "Collision based reaction probability requested for encounter reaction DiscreteEncounterReaction");
+}
+
+/*
+ * Encounter reactions have no pseudo first order rate, thus this method should not be called
+ */
+double RS::DiscreteEncounterReaction::reactionRate(RS::ReactionConditions) const{
+    throw std::logic_error(
+        "Pseudo first order reaction rate requested for encounter reaction DiscreteEncounterReaction");
+}
+
+/**
+ * Gets the encounter radius (m)
+ */
+double RS::DiscreteEncounterReaction::encounterRadius() const {
+    return encounterRadius_;
+}
+
+/**
+ * Gets the microscopic reaction rate within the encounter radius (1/s)
+ */
+double RS::DiscreteEncounterReaction::microscopicRate() const {
+    return microscopicRate_;
+}
+
+/**
+ * Gets the reaction probability of an encountering particle pair in a time step
+ * @param dt the time step length
+ */
+double RS::DiscreteEncounterReaction::encounterProbability(double dt) const {
+    return 1.0 - std::exp(-microscopicRate_ * dt);
+}
+
+/**
+ * Gets the discrete product of the reaction (nullptr if the reaction has no discrete product)
+ */
+RS::Substance* RS::DiscreteEncounterReaction::discreteProduct() const {
+    if (this->discreteProducts()->empty()){
+        return nullptr;
+    }
+    return this->discreteProducts()->begin()->first;
+}
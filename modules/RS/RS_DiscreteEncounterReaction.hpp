@@ -0,0 +1,76 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ RS_DiscreteEncounterReaction.hpp
+
+ Bimolecular reaction between two discrete particles (e.g. ion-ion recombination or cluster growth), which is
+ possible if the particles are within an encounter distance
+
+ ****************************/
+#ifndef RS_DiscreteEncounterReaction_hpp
+#define RS_DiscreteEncounterReaction_hpp
+
+#include "RS_AbstractReaction.hpp"
+
+namespace RS {
+
+    /**
+     * Bimolecular reaction between two discrete particles.
+     *
+     * The reaction follows the Doi model: If the distance between two particles of the educt species is below
+     * the encounter radius, the reaction takes place with the microscopic reaction rate lambda, thus with the
+     * probability 1 - exp(-lambda * dt) in a time step of length dt. For small lambda, the macroscopic bimolecular
+     * rate constant is lambda * 4/3 * pi * encounterRadius^3.
+     *
+     * The reaction has two discrete educts (two different substances or two particles of the same substance) and
+     * zero or one discrete product: With one discrete product, one of the educt particles is transformed into the
+     * product and the other educt particle is consumed. Without discrete product, both educt particles are consumed.
+     *
+     * Encounter reactions are performed by RS::Simulation::performEncounterReactions, which finds the reaction
+     * partners with a cell list.
+     */
+    class DiscreteEncounterReaction: public AbstractReaction {
+
+    public:
+        DiscreteEncounterReaction(
+                const std::map<Substance*,int>& educts,
+                const std::map<Substance*,int>& products,
+                double encounterRadius,
+                double microscopicRate,
+                std::string label
+        );
+
+        RS::ReactionEvent attemptReaction(ReactionConditions conditions, ReactiveParticle* particle, double dt) const override;
+        RS::ReactionEvent attemptReaction(CollisionConditions conditions, ReactiveParticle* particle) const override;
+        [[nodiscard]] double reactionRate(ReactionConditions conditions) const override;
+
+        [[nodiscard]] double encounterRadius() const;
+        [[nodiscard]] double microscopicRate() const;
+        [[nodiscard]] double encounterProbability(double dt) const;
+        [[nodiscard]] Substance* discreteProduct() const;
+
+    private:
+        double encounterRadius_ = 0.0; ///< the distance below which the educt particles can react (m)
+        double microscopicRate_ = 0.0; ///< the reaction rate of particles within the encounter radius (1/s)
+    };
+}
+
+#endif //RS_DiscreteEncounterReaction_hpp
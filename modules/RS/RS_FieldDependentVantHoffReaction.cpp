@@ -59,17 +59,7 @@ collisionGasMass_kg_ (collisionGasMassAmu * RS::KG_PER_AMU)
 
 RS::ReactionEvent RS::FieldDependentVantHoffReaction::attemptReaction(
         RS::ReactionConditions conditions, ReactiveParticle* /*particle*/, double dt) const{
-    double KT = mobility_ * P0_pa_ / conditions.pressure * conditions.temperature / T0_K_;
-    double ionTemperature = conditions.temperature +
-                            energyLossRatio_ * (collisionGasMass_kg_ * pow(KT * conditions.electricField, 2.0)) /
-                            (3.0 * RS::K_BOLTZMANN);
-
-    double k_forward =
-            1.0 /
-            (std::exp(H_R_ / R_GAS * (1.0 / ionTemperature - 1.0 / T0_K_)) * K_s_)
-            * kBackward_;
-
-    double reactionProbability = k_forward * this->staticReactionConcentration() * dt;
+    double reactionProbability = reactionRate(conditions) * dt;
     bool reactionHappened = generateRandomDecision(reactionProbability);
 
     return ReactionEvent{reactionHappened, reactionProbability};
@@ -83,4 +73,21 @@ RS::ReactionEvent RS::FieldDependentVantHoffReaction::attemptReaction(
         CollisionConditions /*conditions*/, ReactiveParticle* /*particle*/) const{
     throw std::logic_error(
             "Collision based reaction probability requested for purely stochastic reaction FieldDependentVantHoffReaction");
-}
\ No newline at end of file
+}
+
+/**
+ * Calculates the pseudo first order reaction rate (1/s) of a discrete educt particle
+ */
+double RS::FieldDependentVantHoffReaction::reactionRate(RS::ReactionConditions conditions) const{
+    double KT = mobility_ * P0_pa_ / conditions.pressure * conditions.temperature / T0_K_;
+    double ionTemperature = conditions.temperature +
+                            energyLossRatio_ * (collisionGasMass_kg_ * pow(KT * conditions.electricField, 2.0)) /
+                            (3.0 * RS::K_BOLTZMANN);
+
+    double k_forward =
+            1.0 /
+            (std::exp(H_R_ / R_GAS * (1.0 / ionTemperature - 1.0 / T0_K_)) * K_s_)
+            * kBackward_;
+
+    return k_forward * this->staticReactionConcentration();
+}
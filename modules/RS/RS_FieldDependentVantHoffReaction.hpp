@@ -63,6 +63,7 @@ namespace RS {
 
         RS::ReactionEvent attemptReaction(ReactionConditions conditions, ReactiveParticle* particle, double dt) const override;
         RS::ReactionEvent attemptReaction(CollisionConditions conditions, ReactiveParticle* particle) const override;
+        [[nodiscard]] double reactionRate(ReactionConditions conditions) const override;
 
     private:
         double H_R_ = 0.0;         ///< Reaction enthalphy for the forward reaction
@@ -46,3 +46,11 @@ RS::ReactionEvent RS::SimpleCollisionStepReaction::attemptReaction(CollisionCond
     }
 }
 
+/*
+ * This is a collision based reaction without a stochastic reaction rate, thus this method should not be called
+ */
+double RS::SimpleCollisionStepReaction::reactionRate(RS::ReactionConditions) const{
+    throw std::logic_error(
+        "Stochastic reaction rate requested for collision based reaction SimpleCollisionStepReaction");
+}
+
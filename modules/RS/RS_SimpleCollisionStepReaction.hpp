@@ -44,6 +44,7 @@ namespace RS {
 
         RS::ReactionEvent attemptReaction(ReactionConditions conditions, ReactiveParticle* particle, double dt) const override;
         RS::ReactionEvent attemptReaction(CollisionConditions conditions, ReactiveParticle* particle) const override;
+        [[nodiscard]] double reactionRate(ReactionConditions conditions) const override;
 
     private:
         double activationEnergy_= 0.0;
@@ -20,7 +20,35 @@
  ****************************/
 
 #include "RS_Simulation.hpp"
+#include "RS_SteadyStateSolver.hpp"
 #include "Core_randomGenerators.hpp"
+#include "Core_tracing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+    /**
+     * A pair of particles which react in an encounter reaction
+     */
+    struct EncounterCandidate {
+        std::size_t particleA; ///< local index of the first particle
+        std::size_t particleB; ///< local index of the second particle
+        RS::DiscreteEncounterReaction* reaction; ///< the reaction of the particles
+    };
+
+    /**
+     * Hash function of the integer coordinates of a cell of the encounter cell list
+     */
+    std::uint64_t cellHash(const std::array<std::int64_t, 3>& cell){
+        std::uint64_t hash = static_cast<std::uint64_t>(cell[0]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= static_cast<std::uint64_t>(cell[1]) * 0xC2B2AE3D27D4EB4FULL;
+        hash ^= static_cast<std::uint64_t>(cell[2]) * 0x165667B19E3779F9ULL;
+        return hash ^ (hash >> 32);
+    }
+}
 
 /**
  * Constructs a RS Simulation with a simulation configuration given by a simulation configuration file
@@ -53,7 +81,9 @@ bool RS::Simulation::addParticle(RS::ReactiveParticle* particle, index_t index)
 }
 
 void RS::Simulation::removeParticle(index_t index) {
-    discreteConcentrations_[particleMap_.at(index)->getSpecies()]--;
+    if (consumedParticles_.erase(index) == 0){
+        discreteConcentrations_[particleMap_.at(index)->getSpecies()]--;
+    }
     particleMap_.erase(index);
 }
 
@@ -84,6 +114,32 @@ long RS::Simulation::reactionEvents(RS::AbstractReaction* reaction) const {
     return reactionEvents_.at(reaction);
 }
 
+/**
+ * Sets the sampling mode of the independent reactions:
+ *
+ * If false (default), every independent reaction of a particle is attempted once per time step with the
+ * linearized reaction probability k * dt. Thus a particle reacts at most once per time step and reaction events
+ * with probabilities > 1 are counted as "ill" events, which is only exact for time steps which are short compared
+ * to the reaction times.
+ *
+ * If true, the reaction events of a particle are sampled with exact, exponentially distributed waiting times
+ * from the total reaction rate of the current species of the particle (kinetic Monte Carlo with the reaction
+ * conditions of the time step). A particle can react several times within a time step, therefore fast reactions
+ * are resolved correctly also for time steps which are long compared to the reaction times.
+ *
+ * @param exactKinetics if true, the reactions are sampled with exact waiting times
+ */
+void RS::Simulation::setExactReactionKinetics(bool exactKinetics) {
+    exactReactionKinetics_ = exactKinetics;
+}
+
+/**
+ * Gets if the independent reactions are sampled with exact waiting times (see setExactReactionKinetics)
+ */
+bool RS::Simulation::exactReactionKinetics() const {
+    return exactReactionKinetics_;
+}
+
 /**
  * Performs a time step with static reaction conditions (same reaction conditions for all particles)
  * @param conditions The reaction conditions for the time step
@@ -96,10 +152,13 @@ void RS::Simulation::performTimestep(RS::ReactionConditions& conditions, double
 
     #pragma omp parallel default(none) shared(particleMap_) firstprivate(particleReactedFct, nParticles, conditions, dt)
     {
+        IDSIMF_TRACE_SCOPE("reaction step", "reactions");
         reactionMap indMap = indReactDeepCopy_(); // get local copy of independent reaction maps
 
+        // no barriers at the end of the loops: the parallel region ends with a barrier anyway
+
         if (particleReactedFct != nullptr) {
-            #pragma omp for
+            #pragma omp for nowait
             for (std::size_t i = 0; i<nParticles; ++i) {
                 bool hasReacted = react_(i, conditions, dt, indMap);
                 if (hasReacted){
@@ -109,7 +168,7 @@ void RS::Simulation::performTimestep(RS::ReactionConditions& conditions, double
             }
         }
         else {
-            #pragma omp for
+            #pragma omp for nowait
             for (std::size_t i = 0; i<nParticles; ++i) {
                 react_(i, conditions, dt, indMap);
             }
@@ -131,10 +190,13 @@ void RS::Simulation::performTimestep(const reactionConditionFctType& conditionFc
 
     #pragma omp parallel default(none) shared(particleMap_) firstprivate(conditionFct, particleReactedFct, nParticles, time, dt)
     {
+        IDSIMF_TRACE_SCOPE("reaction step", "reactions");
         reactionMap indMap = indReactDeepCopy_(); // get local copy of independent reaction maps
 
+        // no barriers at the end of the loops: the parallel region ends with a barrier anyway
+
         if (particleReactedFct != nullptr) {
-            #pragma omp for
+            #pragma omp for nowait
             for (std::size_t i = 0; i<nParticles; ++i) {
                 RS::ReactiveParticle* particle = particleMap_[i];
                 ReactionConditions conditions = conditionFct(particle, time);
@@ -145,7 +207,7 @@ void RS::Simulation::performTimestep(const reactionConditionFctType& conditionFc
             }
         }
         else {
-            #pragma omp for
+            #pragma omp for nowait
             for (std::size_t i = 0; i<nParticles; ++i) {
                 RS::ReactiveParticle* particle = particleMap_[i];
                 ReactionConditions conditions = conditionFct(particle, time);
@@ -199,6 +261,32 @@ void RS::Simulation::doReaction(RS::AbstractReaction* reaction, RS::ReactivePart
 
 
 
+/**
+ * Initializes the chemical species of all particles in the simulation to the steady state distribution of the
+ * discrete substances under constant reaction conditions (see RS::SteadyStateSolver), which is reached from the
+ * current discrete concentrations. The species of the particles are randomly drawn from the steady state
+ * distribution, which allows to skip the equilibration of the reaction system in a simulation.
+ *
+ * @param conditions the reaction conditions
+ * @return the steady state distribution (relative abundances) of the discrete substances
+ */
+std::map<RS::Substance*, double> RS::Simulation::initializeToSteadyState(RS::ReactionConditions conditions) {
+    RS::SteadyStateSolver::distribution_t initialDistribution;
+    for (const auto& concentration: discreteConcentrations_){
+        initialDistribution[concentration.first] = concentration.second;
+    }
+    RS::SteadyStateSolver solver(*simConf_);
+    RS::SteadyStateSolver::distribution_t steadyState = solver.steadyState(conditions, initialDistribution);
+
+    for (const auto& particlePair: particleMap_){
+        RS::ReactiveParticle* particle = particlePair.second;
+        discreteConcentrations_[particle->getSpecies()]--;
+        particle->setSpecies(RS::SteadyStateSolver::sampleSubstance(steadyState));
+        discreteConcentrations_[particle->getSpecies()]++;
+    }
+    return steadyState;
+}
+
 /**
  * Let a particle react: The independent reactions of that particle are tested if they occur,
  * if one reaction occurs, that reaction is performed
@@ -212,7 +300,13 @@ bool RS::Simulation::react(index_t index, RS::ReactionConditions& conditions, do
 }
 
 bool RS::Simulation::react_(index_t index, RS::ReactionConditions& conditions, double dt, reactionMap &reacInd) {
+    if (!consumedParticles_.empty() && consumedParticles_.count(index) > 0){
+        return false;
+    }
     RS::ReactiveParticle* particle = particleMap_[index];
+    if (exactReactionKinetics_){
+        return reactExact_(particle, conditions, dt, reacInd);
+    }
 
     std::vector<AbstractReaction*> &iReactions = reacInd[particle->getSpecies()];
     // shuffle the order of the reaction for every time step to prevent simulation artifacts:
@@ -243,6 +337,63 @@ bool RS::Simulation::react_(index_t index, RS::ReactionConditions& conditions, d
     return false;
 }
 
+/**
+ * Samples the independent reaction events of a particle in a time step with exponentially distributed waiting
+ * times: The waiting time to the next reaction event is drawn from the total reaction rate of the current species
+ * of the particle, the reacting channel is chosen with a probability proportional to its reaction rate. This is
+ * repeated with the product species until the time step is exhausted.
+ *
+ * If the number of reaction events exceeds a limit (which indicates extremely fast reversible reactions), the
+ * remaining time of the time step is skipped and an ill event is counted.
+ *
+ * @return true if at least one reaction had occurred
+ */
+bool RS::Simulation::reactExact_(RS::ReactiveParticle* particle, RS::ReactionConditions& conditions, double dt,
+                                 reactionMap &reacInd) {
+    Core::RandomSource* rndSource = Core::globalRandomGeneratorPool->getThreadRandomSource();
+    double remainingTime = dt;
+    int nEvents = 0;
+
+    while (true){
+        std::vector<AbstractReaction*> &iReactions = reacInd[particle->getSpecies()];
+        double totalRate = 0.0;
+        for (const auto& reaction: iReactions){
+            totalRate += reaction->reactionRate(conditions);
+        }
+        if (totalRate <= 0.0){
+            break;
+        }
+
+        double waitingTime = -std::log(1.0 - rndSource->uniformRealRndValue()) / totalRate;
+        if (waitingTime >= remainingTime){
+            break;
+        }
+        if (nEvents >= maxExactReactionEvents_){
+            #pragma omp atomic
+            ++illEvents_;
+            break;
+        }
+        remainingTime -= waitingTime;
+
+        // choose the reacting channel:
+        double rateThreshold = rndSource->uniformRealRndValue() * totalRate;
+        AbstractReaction* reaction = iReactions.back();
+        double cumulativeRate = 0.0;
+        for (const auto& candidate: iReactions){
+            cumulativeRate += candidate->reactionRate(conditions);
+            if (rateThreshold < cumulativeRate){
+                reaction = candidate;
+                break;
+            }
+        }
+
+        reaction->applyReactionEffects(conditions, particle);
+        doReaction(reaction, particle, reaction->discreteProducts()->begin()->first);
+        ++nEvents;
+    }
+    return nEvents > 0;
+}
+
 bool RS::Simulation::collisionReact(index_t index, RS::Substance* reactionPartnerSpecies, CollisionConditions& conditions){
     //step 1: get reactions for this particle and this reaction partner
     RS::ReactiveParticle* particle = particleMap_.at(index);
@@ -268,6 +419,188 @@ bool RS::Simulation::collisionReact(index_t index, RS::Substance* reactionPartne
     return false;
 }
 
+/**
+ * Performs the encounter reactions (bimolecular reactions of discrete particles, see RS::DiscreteEncounterReaction)
+ * for a time step: Pairs of active particles which are closer than the encounter radius of a reaction react
+ * with the encounter probability of the reaction. The reaction partners are found with a cell list (with a cell
+ * size of the largest encounter radius), which is stored in a spatial hash table, thus the effort scales linearly
+ * with the number of particles. Every particle reacts at most once per time step, conflicting reaction pairs are
+ * resolved in random order.
+ *
+ * Particles consumed by an encounter reaction are deactivated and are not longer considered by the reaction
+ * simulation.
+ *
+ * @param dt The time step length
+ * @param particleReactedFct An optional function, which is performed for the particles which were transformed
+ * into a product
+ * @return the number of encounter reaction events in the time step
+ */
+std::size_t RS::Simulation::performEncounterReactions(double dt, const particleReactedFctType& particleReactedFct) {
+    IDSIMF_TRACE_SCOPE("encounter reactions", "reactions");
+    if (reacEncounter_.empty()){
+        return 0;
+    }
+
+    // collect the particles which can take part in encounter reactions:
+    std::vector<index_t> indices;
+    std::vector<std::size_t> substanceIndices;
+    for (const auto& particlePair: particleMap_){
+        RS::ReactiveParticle* particle = particlePair.second;
+        if (!particle->isActive() || consumedParticles_.count(particlePair.first) > 0){
+            continue;
+        }
+        auto substanceIt = encounterSubstanceIndices_.find(particle->getSpecies());
+        if (substanceIt != encounterSubstanceIndices_.end()){
+            indices.push_back(particlePair.first);
+            substanceIndices.push_back(substanceIt->second);
+        }
+    }
+    std::size_t nParticles = indices.size();
+    if (nParticles < 2){
+        return 0;
+    }
+
+    // sort the particles into the cells of a cell list, which is stored in a spatial hash table in compressed
+    // row format:
+    std::size_t nBuckets = 1;
+    while (nBuckets < 2*nParticles){
+        nBuckets <<= 1;
+    }
+    std::size_t bucketMask = nBuckets - 1;
+    double cellSize = maxEncounterRadius_;
+
+    std::vector<Core::Vector> locations(nParticles);
+    std::vector<std::array<std::int64_t, 3>> cells(nParticles);
+    std::vector<std::size_t> bucketStart(nBuckets+1, 0);
+    for (std::size_t i=0; i<nParticles; ++i){
+        locations[i] = particleMap_.at(indices[i])->getLocation();
+        cells[i] = {
+                static_cast<std::int64_t>(std::floor(locations[i].x() / cellSize)),
+                static_cast<std::int64_t>(std::floor(locations[i].y() / cellSize)),
+                static_cast<std::int64_t>(std::floor(locations[i].z() / cellSize))};
+        bucketStart[(cellHash(cells[i]) & bucketMask) + 1]++;
+    }
+    for (std::size_t b=0; b<nBuckets; ++b){
+        bucketStart[b+1] += bucketStart[b];
+    }
+    std::vector<std::size_t> bucketParticles(nParticles);
+    std::vector<std::size_t> bucketFill(bucketStart.begin(), bucketStart.end()-1);
+    for (std::size_t i=0; i<nParticles; ++i){
+        bucketParticles[bucketFill[cellHash(cells[i]) & bucketMask]++] = i;
+    }
+
+    // find the reacting particle pairs in the neighbouring cells:
+    std::size_t nSubstances = encounterSubstanceIndices_.size();
+    std::vector<EncounterCandidate> candidates;
+    Core::AbstractRandomGeneratorPool* rndPool = Core::globalRandomGeneratorPool.get();
+    #pragma omp parallel default(none) shared(candidates, indices, substanceIndices, locations, cells, \
+            bucketStart, bucketParticles, bucketMask, nParticles, nSubstances, dt, rndPool)
+    {
+        std::vector<EncounterCandidate> localCandidates;
+        Core::RandomSource* rndSource = rndPool->getThreadRandomSource();
+
+        #pragma omp for schedule(dynamic, 64)
+        for (std::size_t i=0; i<nParticles; ++i){
+            for (std::int64_t dx=-1; dx<=1; ++dx){
+                for (std::int64_t dy=-1; dy<=1; ++dy){
+                    for (std::int64_t dz=-1; dz<=1; ++dz){
+                        std::array<std::int64_t, 3> cell = {cells[i][0]+dx, cells[i][1]+dy, cells[i][2]+dz};
+                        std::size_t bucket = cellHash(cell) & bucketMask;
+                        for (std::size_t k=bucketStart[bucket]; k<bucketStart[bucket+1]; ++k){
+                            std::size_t j = bucketParticles[k];
+                            // every pair is tested once, particles in other cells with the same hash are skipped:
+                            if (j <= i || cells[j] != cell){
+                                continue;
+                            }
+                            const std::vector<DiscreteEncounterReaction*>& pairReactions =
+                                    reacEncounter_[substanceIndices[i]*nSubstances + substanceIndices[j]];
+                            if (pairReactions.empty()){
+                                continue;
+                            }
+                            double distance = (locations[i] - locations[j]).magnitude();
+                            for (const auto& reaction: pairReactions){
+                                if (distance < reaction->encounterRadius() &&
+                                    rndSource->uniformRealRndValue() < reaction->encounterProbability(dt)){
+                                    localCandidates.push_back({i, j, reaction});
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        #pragma omp critical (encounter_candidates)
+        {
+            candidates.insert(candidates.end(), localCandidates.begin(), localCandidates.end());
+        }
+    }
+
+    // resolve conflicting pairs in random order, every particle reacts only once:
+    std::shuffle(candidates.begin(), candidates.end(),
+                 *Core::globalRandomGeneratorPool->getThreadRandomSource()->getRandomBitSource());
+    std::vector<bool> hasReacted(nParticles, false);
+    std::size_t nReactions = 0;
+    for (const auto& candidate: candidates){
+        if (hasReacted[candidate.particleA] || hasReacted[candidate.particleB]){
+            continue;
+        }
+        hasReacted[candidate.particleA] = true;
+        hasReacted[candidate.particleB] = true;
+        doEncounterReaction_(candidate.reaction, indices[candidate.particleA], indices[candidate.particleB],
+                             particleReactedFct);
+        ++nReactions;
+    }
+    return nReactions;
+}
+
+/**
+ * Checks if a particle was consumed by an encounter reaction
+ * @param index the index of the particle
+ */
+bool RS::Simulation::isConsumed(index_t index) const {
+    return consumedParticles_.count(index) > 0;
+}
+
+/**
+ * Performs an encounter reaction of two particles: The particle with the lower index is transformed into the
+ * discrete product of the reaction (if there is one), the other educt particles are consumed
+ */
+void RS::Simulation::doEncounterReaction_(RS::DiscreteEncounterReaction* reaction, index_t indexA, index_t indexB,
+                                          const particleReactedFctType& particleReactedFct) {
+    if (indexB < indexA){
+        std::swap(indexA, indexB);
+    }
+    totalReactionEvents_++;
+    reactionEvents_[reaction]++;
+
+    RS::ReactiveParticle* particleA = particleMap_.at(indexA);
+    discreteConcentrations_[particleA->getSpecies()]--;
+    discreteConcentrations_[particleMap_.at(indexB)->getSpecies()]--;
+
+    RS::Substance* product = reaction->discreteProduct();
+    if (product != nullptr){
+        particleA->setSpecies(product);
+        discreteConcentrations_[product]++;
+        if (particleReactedFct != nullptr){
+            particleReactedFct(particleA);
+        }
+    }
+    else {
+        consumeParticle_(indexA);
+    }
+    consumeParticle_(indexB);
+}
+
+/**
+ * Marks a particle as consumed by a reaction and deactivates it
+ */
+void RS::Simulation::consumeParticle_(index_t index) {
+    particleMap_.at(index)->setActive(false);
+    consumedParticles_.insert(index);
+}
+
 void RS::Simulation::advanceTimestep(double dt) {
     sumTime_ += dt;
     nTimesteps_ ++;
@@ -372,6 +705,7 @@ void RS::Simulation::initFromSimulationConfig_(std::unique_ptr<RS::SimulationCon
         }
     }
 
+    std::vector<std::pair<RS::DiscreteEncounterReaction*, std::vector<RS::Substance*>>> encounterEducts;
     for(const auto& reac: reactions_){
 
         //prepare reaction event counter:
@@ -401,6 +735,18 @@ void RS::Simulation::initFromSimulationConfig_(std::unique_ptr<RS::SimulationCon
             reacCollision_.at(eductPair).push_back(reac);
             //throw (RS::ConfigurationFileException("Illegal reaction in configuration file"));
         }
+        else if (auto encounterReac = dynamic_cast<RS::DiscreteEncounterReaction*>(reac)){
+            //the reaction is a bimolecular reaction of two discrete particles: add it to the encounter table
+            std::vector<RS::Substance*> eductSubstances;
+            for(const auto& discreteEduct: *reac->discreteEducts()){
+                eductSubstances.push_back(discreteEduct.first);
+            }
+            if (eductSubstances.size() == 1){
+                eductSubstances.push_back(eductSubstances[0]);
+            }
+            encounterEducts.emplace_back(encounterReac, eductSubstances);
+            maxEncounterRadius_ = std::max(maxEncounterRadius_, encounterReac->encounterRadius());
+        }
         else if (reac->isIndependent()){
             //the reaction is independent: there is only one discrete educt
             auto discreteEduct = reac->discreteEducts()->begin();
@@ -410,10 +756,34 @@ void RS::Simulation::initFromSimulationConfig_(std::unique_ptr<RS::SimulationCon
         else{
             //the reaction is dependent on more than one discrete educt: add it to the reaction maps of all educts
             for(const auto& discreteEduct: *reac->discreteEducts()){
+                if (discreteEduct.second > 1){
+                    //reactions of more than one particle of the same discrete substance (e.g. 2A => B) would never
+                    //be performed:
+                    throw (std::invalid_argument("Reaction " + reac->getLabel() + " of more than one particle of "
+                                                 "a discrete substance is only supported as encounter reaction"));
+                }
                 reacDep_.at(discreteEduct.first).push_back(reac);
             }
         }
     }
+
+    //prepare the symmetric table of encounter reactions of pairs of discrete substances:
+    if (!encounterEducts.empty()){
+        std::vector<RS::Substance*> discreteSubstances = simConf_->getAllDiscreteSubstances();
+        std::size_t nDiscrete = discreteSubstances.size();
+        for (std::size_t i=0; i<nDiscrete; ++i){
+            encounterSubstanceIndices_[discreteSubstances[i]] = i;
+        }
+        reacEncounter_.resize(nDiscrete*nDiscrete);
+        for (const auto& encounterEduct: encounterEducts){
+            std::size_t iA = encounterSubstanceIndices_.at(encounterEduct.second[0]);
+            std::size_t iB = encounterSubstanceIndices_.at(encounterEduct.second[1]);
+            reacEncounter_[iA*nDiscrete + iB].push_back(encounterEduct.first);
+            if (iA != iB){
+                reacEncounter_[iB*nDiscrete + iA].push_back(encounterEduct.first);
+            }
+        }
+    }
 }
 
 RS::Simulation::reactionMap RS::Simulation::indReactDeepCopy_() {
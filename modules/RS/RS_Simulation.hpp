@@ -30,6 +30,7 @@
 
 #include "RS_Substance.hpp"
 #include "RS_AbstractReaction.hpp"
+#include "RS_DiscreteEncounterReaction.hpp"
 #include "RS_ReactiveParticle.hpp"
 #include "RS_ConfigFileParser.hpp"
 #include "spdlog/spdlog.h"
@@ -38,6 +39,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <list>
 #include <utility>
 
@@ -66,6 +68,8 @@ namespace RS {
         [[nodiscard]] long totalReactionEvents() const;
         [[nodiscard]] long illEvents() const;
         [[nodiscard]] long reactionEvents(AbstractReaction* reaction) const;
+        void setExactReactionKinetics(bool exactKinetics);
+        [[nodiscard]] bool exactReactionKinetics() const;
 
         void performTimestep(ReactionConditions& conditions, double dt, const particleReactedFctType& particleReactedFct = nullptr);
         void performTimestep(const reactionConditionFctType& conditionFct, double dt, const particleReactedFctType& particleReactedFct = nullptr);
@@ -73,7 +77,10 @@ namespace RS {
         void doReaction(RS::AbstractReaction* reaction, RS::ReactiveParticle* particle, RS::Substance* product);
         bool react(index_t index, ReactionConditions& conditions, double dt);
         bool collisionReact(index_t index, RS::Substance* reactionPartnerSpecies, CollisionConditions& conditions);
+        std::size_t performEncounterReactions(double dt, const particleReactedFctType& particleReactedFct = nullptr);
+        [[nodiscard]] bool isConsumed(index_t index) const;
         void advanceTimestep(double dt);
+        std::map<Substance*, double> initializeToSteadyState(ReactionConditions conditions);
 
         [[nodiscard]] int timestep() const;
         [[nodiscard]] double simulationTime() const;
@@ -92,6 +99,10 @@ namespace RS {
         void initFromSimulationConfig_(std::unique_ptr<RS::SimulationConfiguration> simConf);
         reactionMap indReactDeepCopy_();
         bool react_(index_t index, ReactionConditions& conditions, double dt, reactionMap &reacInd);
+        bool reactExact_(RS::ReactiveParticle* particle, ReactionConditions& conditions, double dt, reactionMap &reacInd);
+        void doEncounterReaction_(RS::DiscreteEncounterReaction* reaction, index_t indexA, index_t indexB,
+                                  const particleReactedFctType& particleReactedFct);
+        void consumeParticle_(index_t index);
 
         std::string concentrationString_() const;
         std::string reactionStatisticsString_() const;
@@ -99,6 +110,8 @@ namespace RS {
         //implement private members / data structures / methods
         long totalReactionEvents_ = 0; ///< the total number of reaction events in the simulation
         long illEvents_= 0;  ///< the number of illegal / ill events (events with reacion probabilties > 1)
+        bool exactReactionKinetics_ = false; ///< if true, the independent reactions are sampled with exact waiting times
+        static constexpr int maxExactReactionEvents_ = 10000; ///< limit of sampled reaction events of a particle in a time step
         double sumTime_ = 0.0; ///< the cumulative time (sum of all time steps)
         int nTimesteps_ = 0; ///< the total number of timesteps in the simulation
         std::unique_ptr<RS::SimulationConfiguration> simConf_;
@@ -110,6 +123,10 @@ namespace RS {
         std::map<std::pair<Substance* const, Substance* const>, std::vector<AbstractReaction*>> reacCollision_; ///< map of collision based reactions
         std::map<Substance* const,std::vector<double>> staticProbabilities_; ///< substance specific static reaction probabilities
         std::map<Substance* const,int> discreteConcentrations_; ///< substance specific discrete particle concentrations
+        std::map<Substance*, std::size_t> encounterSubstanceIndices_; ///< indices of the discrete substances in the encounter reaction table
+        std::vector<std::vector<DiscreteEncounterReaction*>> reacEncounter_; ///< encounter reactions of pairs of discrete substances (flat, symmetric table)
+        double maxEncounterRadius_ = 0.0; ///< the largest encounter radius of all encounter reactions (cell size of the encounter search)
+        std::unordered_set<index_t> consumedParticles_; ///< particles consumed by encounter reactions
     };
 }
 
@@ -31,10 +31,10 @@ AbstractReaction(educts, products,false, "static", label),
 rateConstant_(rateConstant)
 {}
 
-RS::ReactionEvent RS::StaticReaction::attemptReaction(RS::ReactionConditions /*conditions*/,
+RS::ReactionEvent RS::StaticReaction::attemptReaction(RS::ReactionConditions conditions,
                                                       RS::ReactiveParticle* /*particle*/, double dt) const{
 
-    double reactionProbability = rateConstant_ * this->staticReactionConcentration() * dt;
+    double reactionProbability = reactionRate(conditions) * dt;
     bool reactionHappened = generateRandomDecision(reactionProbability);
 
     return ReactionEvent{reactionHappened, reactionProbability};
@@ -49,3 +49,10 @@ RS::ReactionEvent RS::StaticReaction::attemptReaction(CollisionConditions /*cond
     throw std::logic_error(
         "Collision based reaction probability requested for purely stochastic reaction StaticReaction");
 }
+
+/**
+ * Calculates the pseudo first order reaction rate (1/s) of a discrete educt particle
+ */
+double RS::StaticReaction::reactionRate(RS::ReactionConditions /*conditions*/) const{
+    return rateConstant_ * this->staticReactionConcentration();
+}
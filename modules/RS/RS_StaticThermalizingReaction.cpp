@@ -34,23 +34,29 @@ rateConstant_(rateConstant)
 RS::ReactionEvent RS::StaticThermalizingReaction::attemptReaction(RS::ReactionConditions conditions,
                                                                   RS::ReactiveParticle *particle, double dt) const{
 
-    double reactionProbability = rateConstant_ * this->staticReactionConcentration() * dt;
+    double reactionProbability = reactionRate(conditions) * dt;
     bool reactionHappened = generateRandomDecision(reactionProbability);
 
     if (reactionHappened){
-        //reinitalize the reacting particle with a random MB velocity
-
-        //first: get the product particle mass (since the particle will be updated with the new chemical
-        //species afterwards and outside of this method
-        double productMass = this->discreteProducts()->begin()->first->mass();
-
-        particle->setVelocity(
-                RS::util::maxwellBoltzmannRandomVelocity(conditions.temperature,productMass));
+        applyReactionEffects(conditions, particle);
     }
 
     return ReactionEvent{reactionHappened, reactionProbability};
 }
 
+/**
+ * Reinitializes the reacting particle with a random Maxwell-Boltzmann velocity at the reaction temperature
+ */
+void RS::StaticThermalizingReaction::applyReactionEffects(RS::ReactionConditions conditions,
+                                                          RS::ReactiveParticle* particle) const {
+    //get the product particle mass (since the particle will be updated with the new chemical
+    //species afterwards and outside of this method)
+    double productMass = this->discreteProducts()->begin()->first->mass();
+
+    particle->setVelocity(
+            RS::util::maxwellBoltzmannRandomVelocity(conditions.temperature,productMass));
+}
+
 /*
  * This is a purely stochastic reaction, thus the collision based probability is always zero
  * and this method should not be called
@@ -59,3 +65,10 @@ RS::ReactionEvent RS::StaticThermalizingReaction::attemptReaction(CollisionCondi
     throw std::logic_error(
             "Collision based reaction probability requested for purely stochastic reaction StaticReaction");
 }
+
+/**
+ * Calculates the pseudo first order reaction rate (1/s) of a discrete educt particle
+ */
+double RS::StaticThermalizingReaction::reactionRate(RS::ReactionConditions /*conditions*/) const{
+    return rateConstant_ * this->staticReactionConcentration();
+}
@@ -46,6 +46,8 @@ namespace RS {
         //double rateConstant(ReactionConditions) const;
         RS::ReactionEvent attemptReaction(ReactionConditions conditions, ReactiveParticle* particle, double dt) const override;
         RS::ReactionEvent attemptReaction(CollisionConditions conditions, ReactiveParticle* particle) const override;
+        [[nodiscard]] double reactionRate(ReactionConditions conditions) const override;
+        void applyReactionEffects(ReactionConditions conditions, ReactiveParticle* particle) const override;
 
     private:
         double rateConstant_ = 0.0;
@@ -0,0 +1,346 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "RS_SteadyStateSolver.hpp"
+#include "Core_randomGenerators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+    /**
+     * Solves the dense linear system A x = b (A is a row major n x n matrix) by Gaussian elimination with partial
+     * pivoting, the solution is returned in b
+     */
+    void solveLinearSystem(std::vector<double>& A, std::vector<double>& b){
+        std::size_t n = b.size();
+        for (std::size_t col=0; col<n; ++col){
+            std::size_t pivot = col;
+            for (std::size_t row=col+1; row<n; ++row){
+                if (std::fabs(A[row*n + col]) > std::fabs(A[pivot*n + col])){
+                    pivot = row;
+                }
+            }
+            if (pivot != col){
+                for (std::size_t k=0; k<n; ++k){
+                    std::swap(A[col*n + k], A[pivot*n + k]);
+                }
+                std::swap(b[col], b[pivot]);
+            }
+
+            double diag = A[col*n + col];
+            for (std::size_t row=col+1; row<n; ++row){
+                double factor = A[row*n + col] / diag;
+                for (std::size_t k=col; k<n; ++k){
+                    A[row*n + k] -= factor * A[col*n + k];
+                }
+                b[row] -= factor * b[col];
+            }
+        }
+        for (std::size_t i=n; i-- > 0;){
+            double sum = b[i];
+            for (std::size_t k=i+1; k<n; ++k){
+                sum -= A[i*n + k] * b[k];
+            }
+            b[i] = sum / A[i*n + i];
+        }
+    }
+
+    /**
+     * Calculates the stationary distribution of an irreducible set of states with the subtraction free GTH
+     * (Grassmann, Taksar, Heyman) elimination
+     *
+     * @param Q transition rates (row major m x m matrix, Q[i*m + j] is the rate from state i to state j, the
+     * diagonal is ignored), is modified
+     * @param m number of states
+     * @return the stationary distribution (normalized to a sum of one)
+     */
+    std::vector<double> stationaryDistributionGTH(std::vector<double>& Q, std::size_t m){
+        std::vector<double> outRates(m, 0.0);
+        for (std::size_t k=m-1; k>0; --k){
+            double outRate = 0.0;
+            for (std::size_t j=0; j<k; ++j){
+                outRate += Q[k*m + j];
+            }
+            outRates[k] = outRate;
+            for (std::size_t i=0; i<k; ++i){
+                double factor = Q[i*m + k] / outRate;
+                for (std::size_t j=0; j<k; ++j){
+                    if (j != i){
+                        Q[i*m + j] += factor * Q[k*m + j];
+                    }
+                }
+            }
+        }
+
+        std::vector<double> pi(m, 0.0);
+        pi[0] = 1.0;
+        double total = 1.0;
+        for (std::size_t k=1; k<m; ++k){
+            double inflow = 0.0;
+            for (std::size_t i=0; i<k; ++i){
+                inflow += pi[i] * Q[i*m + k];
+            }
+            pi[k] = inflow / outRates[k];
+            total += pi[k];
+        }
+        for (double& value: pi){
+            value /= total;
+        }
+        return pi;
+    }
+}
+
+/**
+ * Constructs a steady state solver for the reactions of a RS simulation configuration
+ */
+RS::SteadyStateSolver::SteadyStateSolver(const RS::SimulationConfiguration& simConf):
+discreteSubstances_(simConf.getAllDiscreteSubstances())
+{
+    std::map<Substance*, std::size_t> substanceIndices;
+    for (std::size_t i=0; i<discreteSubstances_.size(); ++i){
+        substanceIndices[discreteSubstances_[i]] = i;
+    }
+
+    for (const auto& reac: simConf.getAllReactions()){
+        if (reac->isCollisionReaction() || !reac->isIndependent()){
+            continue;
+        }
+        reactions_.push_back(reac);
+        eductIndices_.push_back(substanceIndices.at(reac->discreteEducts()->begin()->first));
+        if (reac->discreteProducts()->empty()){
+            productIndices_.push_back(discreteSubstances_.size());
+        }
+        else {
+            productIndices_.push_back(substanceIndices.at(reac->discreteProducts()->begin()->first));
+        }
+    }
+}
+
+/**
+ * Calculates the rate matrix K of the linear rate equations dN/dt = K N of the discrete substances
+ *
+ * @param conditions the reaction conditions
+ * @return the rate matrix (row major, the column is the reacting substance, the row the changed substance, in
+ * the order of the discrete substances of the simulation configuration)
+ */
+std::vector<double> RS::SteadyStateSolver::rateMatrix(RS::ReactionConditions conditions) const {
+    std::size_t n = discreteSubstances_.size();
+    std::vector<double> K(n*n, 0.0);
+    for (std::size_t i=0; i<reactions_.size(); ++i){
+        double rate = reactions_[i]->reactionRate(conditions);
+        std::size_t educt = eductIndices_[i];
+        std::size_t product = productIndices_[i];
+        K[educt*n + educt] -= rate;
+        if (product < n){
+            K[product*n + educt] += rate;
+        }
+    }
+    return K;
+}
+
+/**
+ * Calculates the steady state distribution of the discrete substances, which is reached from an initial
+ * distribution under constant reaction conditions
+ *
+ * @param conditions the reaction conditions
+ * @param initialDistribution the initial (relative) abundances of the discrete substances, missing substances
+ * have an abundance of zero
+ * @return the steady state relative abundances (normalized to a sum of one) of all discrete substances
+ */
+RS::SteadyStateSolver::distribution_t RS::SteadyStateSolver::steadyState(
+        RS::ReactionConditions conditions, const distribution_t& initialDistribution) const {
+
+    std::size_t n = discreteSubstances_.size();
+    std::vector<double> x(n, 0.0);
+    for (std::size_t i=0; i<n; ++i){
+        auto it = initialDistribution.find(discreteSubstances_[i]);
+        if (it != initialDistribution.end()){
+            if (it->second < 0.0){
+                throw (std::invalid_argument("Negative abundance in initial substance distribution"));
+            }
+            x[i] = it->second;
+        }
+    }
+
+    // transition rates between the substances and rates of reactions without discrete product (sinks):
+    std::vector<double> rates(n*n, 0.0);
+    std::vector<double> sinkRates(n, 0.0);
+    std::vector<double> outRates(n, 0.0);
+    for (std::size_t i=0; i<reactions_.size(); ++i){
+        double rate = reactions_[i]->reactionRate(conditions);
+        std::size_t educt = eductIndices_[i];
+        std::size_t product = productIndices_[i];
+        if (product == n){
+            sinkRates[educt] += rate;
+            outRates[educt] += rate;
+        }
+        else if (product != educt){
+            rates[educt*n + product] += rate;
+            outRates[educt] += rate;
+        }
+    }
+
+    // transitive closure of the reaction graph:
+    std::vector<bool> reachable(n*n, false);
+    for (std::size_t i=0; i<n; ++i){
+        reachable[i*n + i] = true;
+        for (std::size_t j=0; j<n; ++j){
+            if (rates[i*n + j] > 0.0){
+                reachable[i*n + j] = true;
+            }
+        }
+    }
+    for (std::size_t k=0; k<n; ++k){
+        for (std::size_t i=0; i<n; ++i){
+            if (reachable[i*n + k]){
+                for (std::size_t j=0; j<n; ++j){
+                    if (reachable[k*n + j]){
+                        reachable[i*n + j] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // a substance is in a closed class if it has no sink reactions and all substances reachable from it reach
+    // it back:
+    std::vector<bool> isClosed(n, true);
+    for (std::size_t i=0; i<n; ++i){
+        isClosed[i] = sinkRates[i] <= 0.0;
+        for (std::size_t j=0; j<n && isClosed[i]; ++j){
+            if (reachable[i*n + j] && (!reachable[j*n + i] || sinkRates[j] > 0.0)){
+                isClosed[i] = false;
+            }
+        }
+    }
+
+    // distribute the particles in transient substances to the closed substances: the expected residence times y
+    // in the transient substances are the solution of M y = x_transient
+    std::vector<std::size_t> transient;
+    for (std::size_t i=0; i<n; ++i){
+        if (!isClosed[i]){
+            transient.push_back(i);
+        }
+    }
+    std::vector<double> closedMass(n, 0.0);
+    for (std::size_t i=0; i<n; ++i){
+        if (isClosed[i]){
+            closedMass[i] = x[i];
+        }
+    }
+    std::size_t nTransient = transient.size();
+    if (nTransient > 0){
+        std::vector<double> M(nTransient*nTransient, 0.0);
+        std::vector<double> y(nTransient);
+        for (std::size_t a=0; a<nTransient; ++a){
+            y[a] = x[transient[a]];
+            M[a*nTransient + a] = outRates[transient[a]];
+            for (std::size_t b=0; b<nTransient; ++b){
+                if (a != b){
+                    M[a*nTransient + b] -= rates[transient[b]*n + transient[a]];
+                }
+            }
+        }
+        solveLinearSystem(M, y);
+        for (std::size_t i=0; i<n; ++i){
+            if (isClosed[i]){
+                for (std::size_t b=0; b<nTransient; ++b){
+                    closedMass[i] += rates[transient[b]*n + i] * y[b];
+                }
+            }
+        }
+    }
+
+    // stationary distributions of the closed classes:
+    std::fill(x.begin(), x.end(), 0.0);
+    std::vector<bool> isProcessed(n, false);
+    for (std::size_t i=0; i<n; ++i){
+        if (!isClosed[i] || isProcessed[i]){
+            continue;
+        }
+        std::vector<std::size_t> closedClass;
+        double classMass = 0.0;
+        for (std::size_t j=0; j<n; ++j){
+            if (reachable[i*n + j]){
+                closedClass.push_back(j);
+                classMass += closedMass[j];
+                isProcessed[j] = true;
+            }
+        }
+        std::size_t m = closedClass.size();
+        std::vector<double> Q(m*m);
+        for (std::size_t a=0; a<m; ++a){
+            for (std::size_t b=0; b<m; ++b){
+                Q[a*m + b] = rates[closedClass[a]*n + closedClass[b]];
+            }
+        }
+        std::vector<double> pi = stationaryDistributionGTH(Q, m);
+        for (std::size_t a=0; a<m; ++a){
+            x[closedClass[a]] = std::max(pi[a] * classMass, 0.0);
+        }
+    }
+
+    double total = 0.0;
+    for (double value: x){
+        total += value;
+    }
+    if (total <= 0.0){
+        throw (std::invalid_argument("Steady state substance distribution is empty"));
+    }
+
+    distribution_t result;
+    for (std::size_t i=0; i<n; ++i){
+        result[discreteSubstances_[i]] = x[i] / total;
+    }
+    return result;
+}
+
+/**
+ * Draws a random substance from a substance distribution
+ *
+ * @param distribution relative abundances of substances (not necessarily normalized)
+ * @return the randomly drawn substance
+ */
+RS::Substance* RS::SteadyStateSolver::sampleSubstance(const distribution_t& distribution) {
+    double total = 0.0;
+    for (const auto& entry: distribution){
+        total += entry.second;
+    }
+    if (total <= 0.0){
+        throw (std::invalid_argument("Substance distribution to sample from is empty"));
+    }
+
+    double rndValue = Core::globalRandomGeneratorPool->getThreadRandomSource()->uniformRealRndValue() * total;
+    Substance* result = nullptr;
+    double cumulative = 0.0;
+    for (const auto& entry: distribution){
+        if (entry.second > 0.0){
+            result = entry.first;
+            cumulative += entry.second;
+            if (rndValue < cumulative){
+                break;
+            }
+        }
+    }
+    return result;
+}
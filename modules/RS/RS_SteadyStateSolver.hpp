@@ -0,0 +1,80 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ RS_SteadyStateSolver.hpp
+
+ Solver for the steady state distribution of the discrete substances of a RS reaction system
+
+ ****************************/
+
+#ifndef RS_SteadyStateSolver_hpp
+#define RS_SteadyStateSolver_hpp
+
+#include "RS_SimulationConfiguration.hpp"
+#include "RS_AbstractReaction.hpp"
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace RS {
+
+    /**
+     * Calculates the steady state (or equilibrium) distribution of the discrete substances of a reaction system
+     * under defined reaction conditions.
+     *
+     * The independent, stochastic reactions (reactions with only one discrete educt, which are not collision based)
+     * transform a discrete particle with a pseudo first order reaction rate into its discrete product. The
+     * distribution of the discrete substances is therefore described by the linear rate equations
+     *
+     *      dN/dt = K N
+     *
+     * with the rate matrix K. The steady state distribution, which is reached from an initial distribution, is the
+     * long time limit of the rate equations. It is calculated directly, which is robust for stiff reaction systems
+     * with rates spanning many orders of magnitude: The substances are decomposed into closed classes (sets of
+     * substances which are mutually reachable and are not left by any reaction) and transient substances. The
+     * stationary distribution within a closed class is calculated with the subtraction free GTH (Grassmann, Taksar,
+     * Heyman) elimination. The particles in transient substances are distributed to the closed classes according
+     * to the absorption probabilities, thus the steady state depends on the initial distribution if there is more
+     * than one closed class (e.g. for disconnected sets of substances or irreversible reactions).
+     *
+     * Collision based reactions and reactions with more than one discrete educt are not considered.
+     */
+    class SteadyStateSolver {
+
+    public:
+        using distribution_t = std::map<Substance*, double>;
+
+        explicit SteadyStateSolver(const SimulationConfiguration& simConf);
+
+        [[nodiscard]] std::vector<double> rateMatrix(ReactionConditions conditions) const;
+        [[nodiscard]] distribution_t steadyState(ReactionConditions conditions,
+                                                 const distribution_t& initialDistribution) const;
+        [[nodiscard]] static Substance* sampleSubstance(const distribution_t& distribution);
+
+    private:
+        std::vector<Substance*> discreteSubstances_; ///< The discrete substances (the order of the rate matrix)
+        std::vector<AbstractReaction*> reactions_; ///< The independent stochastic reactions
+        std::vector<std::size_t> eductIndices_; ///< Discrete educt index of the reactions
+        std::vector<std::size_t> productIndices_; ///< Discrete product index of the reactions (none: number of substances)
+    };
+}
+
+#endif //RS_SteadyStateSolver_hpp
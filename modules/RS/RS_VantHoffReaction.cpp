@@ -40,12 +40,7 @@ k_backward_(k_backward)
 RS::ReactionEvent RS::VantHoffReaction::attemptReaction(RS::ReactionConditions conditions,
                                                         ReactiveParticle* /*particle*/,
                                                         double dt) const{
-    double k_forward =
-            1.0 /
-            (std::exp(H_R_ / R_GAS * (1.0 / conditions.temperature - 1.0 / T_STANDARD)) * K_s_)
-            * k_backward_;
-
-    double reactionProbability = k_forward* this->staticReactionConcentration() * dt;
+    double reactionProbability = reactionRate(conditions) * dt;
     bool reactionHappened = generateRandomDecision(reactionProbability);
 
     return ReactionEvent{reactionHappened, reactionProbability};
@@ -60,3 +55,15 @@ RS::ReactionEvent RS::VantHoffReaction::attemptReaction(
     throw std::logic_error(
             "Collision based reaction probability requested for purely stochastic reaction VantHoffReaction");
 }
+
+/**
+ * Calculates the pseudo first order reaction rate (1/s) of a discrete educt particle
+ */
+double RS::VantHoffReaction::reactionRate(RS::ReactionConditions conditions) const{
+    double k_forward =
+            1.0 /
+            (std::exp(H_R_ / R_GAS * (1.0 / conditions.temperature - 1.0 / T_STANDARD)) * K_s_)
+            * k_backward_;
+
+    return k_forward * this->staticReactionConcentration();
+}
@@ -21,6 +21,66 @@
 
 #include "BTree_parallelNode.hpp"
 #include <cmath>
+#include <mutex>
+#include <new>
+
+namespace{
+
+    /**
+     * Pool for the storage of parallel tree nodes: The nodes are placed in blocks of (at least) one huge page, which
+     * are allocated with the huge page mode of the tree subsystem, and released nodes are recycled. The blocks are
+     * released when no node is alive anymore.
+     */
+    class ParallelNodePool{
+    public:
+        void* allocate(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (freeNodes_.empty()){
+                addBlock_();
+            }
+            void* node = freeNodes_.back();
+            freeNodes_.pop_back();
+            nNodesAlive_++;
+            return node;
+        }
+
+        void deallocate(void* node){
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeNodes_.push_back(node);
+            nNodesAlive_--;
+            if (nNodesAlive_ == 0){
+                freeNodes_.clear();
+                blocks_.clear();
+            }
+        }
+
+    private:
+        struct alignas(BTree::ParallelNode) NodeStorage{
+            unsigned char bytes[sizeof(BTree::ParallelNode)];
+        };
+        using block_t = Core::hugePageVector<NodeStorage, Core::HugePageSubsystem::TREE>;
+
+        static constexpr std::size_t nodesPerBlock_ = Core::HUGE_PAGE_SIZE/sizeof(NodeStorage) + 1;
+
+        void addBlock_(){
+            blocks_.emplace_back(nodesPerBlock_);
+            // the free nodes are taken from the back, thus the nodes of a block are used in ascending order:
+            for (auto it = blocks_.back().rbegin(); it != blocks_.back().rend(); ++it){
+                freeNodes_.push_back(&(*it));
+            }
+        }
+
+        std::mutex mutex_; ///< guards the pool, nodes can be allocated by trees in different threads
+        std::vector<block_t> blocks_; ///< the storage blocks of the pool
+        std::vector<void*> freeNodes_; ///< node storage which is not in use
+        std::size_t nNodesAlive_ = 0; ///< number of allocated nodes
+    };
+
+    ParallelNodePool& nodePool(){
+        static ParallelNodePool pool;
+        return pool;
+    }
+}
 
 /**
  * Constructs a tree node
@@ -32,6 +92,30 @@ BTree::ParallelNode::ParallelNode(Core::Vector min, Core::Vector max, BTree::Par
         GenericBaseNode<ParallelNode>(min,max,parent)
 {}
 
+/**
+ * Allocates the storage of a node from the huge page backed node pool
+ */
+void* BTree::ParallelNode::operator new(std::size_t size){
+    if (size != sizeof(ParallelNode)){
+        return ::operator new(size);
+    }
+    return nodePool().allocate();
+}
+
+/**
+ * Returns the storage of a node to the node pool
+ */
+void BTree::ParallelNode::operator delete(void* node, std::size_t size){
+    if (node == nullptr){
+        return;
+    }
+    if (size != sizeof(ParallelNode)){
+        ::operator delete(node);
+        return;
+    }
+    nodePool().deallocate(node);
+}
+
 /**
  * Determines the maximum depth, in terms of tree levels, of the (sub) tree with this node as root
  *
@@ -93,7 +177,7 @@ void BTree::ParallelNode::countNodesOnLevel(std::size_t level, std::vector<std::
  * @param insertPositions A vector with the current insert positions in the serialized vector for the individual
  * tree levels
  */
-void BTree::ParallelNode::serializeIntoVector(std::vector<BTree::ParallelNode*>& serializedNodes, std::size_t treeLevel,
+void BTree::ParallelNode::serializeIntoVector(BTree::serializedNodeVector_t& serializedNodes, std::size_t treeLevel,
                                               std::vector<std::size_t>& insertPositions)
 {
     // Also updates the normalized edge length of the node, which is used for the
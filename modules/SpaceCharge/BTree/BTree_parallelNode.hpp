@@ -34,11 +34,19 @@
 #include "Core_vector.hpp"
 #include "BTree_genericBaseNode.hpp"
 #include "Core_particle.hpp"
+#include "Core_hugePageAllocator.hpp"
 #include <ostream>
 #include <vector>
 
 namespace BTree {
 
+    class ParallelNode;
+
+    /**
+     * Serialized links to the nodes of a parallel tree (huge page backed for large trees)
+     */
+    using serializedNodeVector_t = Core::hugePageVector<ParallelNode*, Core::HugePageSubsystem::TREE>;
+
     class ParallelNode: public GenericBaseNode<ParallelNode> {
 
     friend class ParallelTree;
@@ -50,8 +58,12 @@ namespace BTree {
         ParallelNode(const ParallelNode& that) = delete;
         ParallelNode& operator=(const ParallelNode& that) = delete;
 
+        // Nodes are allocated from a huge page backed node pool:
+        static void* operator new(std::size_t size);
+        static void operator delete(void* node, std::size_t size);
+
         // Member methods:
-        void serializeIntoVector(std::vector<BTree::ParallelNode*> &serializedNodes, std::size_t treeLevel,
+        void serializeIntoVector(serializedNodeVector_t &serializedNodes, std::size_t treeLevel,
                                  std::vector<std::size_t> &insertPositions);
 
         [[nodiscard]] std::size_t maximumRecursionDepth() const;
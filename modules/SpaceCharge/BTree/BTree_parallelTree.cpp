@@ -22,9 +22,23 @@
 #include "BTree_parallelTree.hpp"
 #include "Core_utils.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 /**
- Constructor: Constructs a new tree
+ * Constructor: Constructs a new tree with a dynamic domain. The spatial domain of the tree is adapted
+ * to the particle cloud: It is grown by re-rooting if particles leave the domain and it is tightened
+ * to the bounding box of the particles if the particle cloud has become much smaller than the domain.
+ */
+BTree::ParallelTree::ParallelTree():
+        ParallelTree(Core::Vector(-1e-3, -1e-3, -1e-3), Core::Vector(1e-3, 1e-3, 1e-3))
+{
+    dynamicDomain_ = true;
+}
+
+/**
+ Constructor: Constructs a new tree with a static domain
  
  \param min the lower spatial boundary of the tree domain
  \param min the upper spatial boundary of the tree domain
@@ -61,6 +75,29 @@ std::size_t BTree::ParallelTree::getNumberOfParticles() const{
     return(root_->getNumberOfParticles());
 }
 
+/**
+ * Returns true if the spatial domain of the tree is dynamically adapted to the particles
+ */
+bool BTree::ParallelTree::isDomainDynamic() const{
+    return dynamicDomain_;
+}
+
+/**
+ * Estimates the memory used by the tree: The tree nodes (as counted by the last structural update of the tree),
+ * the tree particles in the linear particle list, the index map and the serialized node vector
+ */
+std::size_t BTree::ParallelTree::memoryUsageBytes() const{
+    std::size_t nParticles = iVec_->size();
+    std::size_t result = sizeof(ParallelTree);
+    result += numberOfNodesTotal_*sizeof(ParallelNode);
+    result += nParticles*(sizeof(TreeParticle) + sizeof(treeParticlePtrList::value_type) + 2*sizeof(void*));
+    result += iMap_->bucket_count()*sizeof(void*) +
+              iMap_->size()*(sizeof(void*) + sizeof(std::pair<const std::size_t, treeParticlePtrList::const_iterator>));
+    result += nodesSerialized_.capacity()*sizeof(ParallelNode*);
+    result += (nodesOnLevels_.capacity() + nodeStartIndicesOnLevels_.capacity())*sizeof(std::size_t);
+    return result;
+}
+
 /**
  * Inits the internal data structures after a structural change on the
  * tree structure and returns the total number of tree nodes.
@@ -140,6 +177,9 @@ Core::Vector BTree::ParallelTree::getEFieldFromSpaceCharge(Core::Particle &parti
 void BTree::ParallelTree::insertParticle(Core::Particle &particle, std::size_t ext_index){
 
     auto treeParticle = std::make_unique<BTree::TreeParticle>(&particle);
+    if (dynamicDomain_ && !isInDomain_(particle.getLocation())){
+        growDomain_(particle.getLocation());
+    }
     root_->insertParticle(treeParticle.get());
     iVec_->push_front(std::move(treeParticle));
     iMap_->insert({ext_index, iVec_->cbegin()});
@@ -217,6 +257,19 @@ void BTree::ParallelTree::updateParticleLocation(std::size_t extIndex, Core::Vec
  * @return the total number of nodes in the tree
  */
 std::size_t BTree::ParallelTree::updateNodes(int ver) {
+    // Tighten the domain if the particle cloud has contracted considerably. The tight domain requires a scan of all
+    // particles, which is only performed if the domain was grown or the tree structure indicates a contraction:
+    if(dynamicDomain_ && root_->numP_ > 1 && (domainGrown_ || isCloudContracted_())){
+        Core::Vector tightMin, tightMax;
+        double tightEdgeLength = tightDomain_(tightMin, tightMax);
+        double rootEdgeLength = root_->max_.x() - root_->min_.x();
+        if (tightEdgeLength * DOMAIN_SHRINK_FACTOR < rootEdgeLength){
+            rebuildDomain_(tightMin, tightMax);
+            ver = 1;
+        }
+    }
+    domainGrown_ = false;
+
     if(ver!=0)
     {
         //if a structural change in the tree structure has happened: We have to update serialized
@@ -239,6 +292,31 @@ std::size_t BTree::ParallelTree::updateNodes(int ver) {
     return numberOfNodesTotal_;
 }
 
+/**
+ * Rebuilds the tree structure with a tight, cubic domain around the current particle positions.
+ * (The tree nodes are updated, thus the tree is ready for field calculation afterwards)
+ */
+void BTree::ParallelTree::rebuildDomain() {
+    Core::Vector tightMin, tightMax;
+    tightDomain_(tightMin, tightMax);
+    rebuildDomain_(tightMin, tightMax);
+    updateNodes(1);
+}
+
+/**
+ * Sets a static spatial domain for the tree and rebuilds the tree structure with the given domain.
+ * All particles in the tree have to be inside the domain.
+ * (The tree nodes are updated, thus the tree is ready for field calculation afterwards)
+ *
+ * @param min the lower spatial boundary of the tree domain
+ * @param max the upper spatial boundary of the tree domain
+ */
+void BTree::ParallelTree::setStaticDomain(Core::Vector min, Core::Vector max) {
+    dynamicDomain_ = false;
+    domainGrown_ = false;
+    rebuildDomain_(min, max);
+    updateNodes(1);
+}
 
 void BTree::ParallelTree::printParticles() const{
     int i =0;
@@ -256,6 +334,163 @@ void BTree::ParallelTree::printParticles() const{
 }
 
 
+/**
+ * Checks if a location is inside the spatial domain of the tree root
+ */
+bool BTree::ParallelTree::isInDomain_(const Core::Vector& location) const {
+    return (location.x() > root_->min_.x() && location.x() < root_->max_.x() &&
+            location.y() > root_->min_.y() && location.y() < root_->max_.y() &&
+            location.z() > root_->min_.z() && location.z() < root_->max_.z());
+}
+
+/**
+ * Checks with the tree structure if the particle cloud has contracted considerably: The bounding box of the occupied
+ * nodes on the upper DOMAIN_SHRINK_LEVELS levels of the tree (and of the particles in leaf nodes above these levels)
+ * encloses all particles. If this box is small enough to
+ * trigger a tightening of the domain, the cloud has contracted.
+ * (The check visits only a bounded number of nodes and does not scan the particles)
+ */
+bool BTree::ParallelTree::isCloudContracted_() const {
+    Core::Vector occupiedMin = root_->max_;
+    Core::Vector occupiedMax = root_->min_;
+    std::vector<std::pair<const BTree::ParallelNode*, std::size_t>> nodesToProcess = {{root_.get(), 0}};
+    while (!nodesToProcess.empty()){
+        auto [node, level] = nodesToProcess.back();
+        nodesToProcess.pop_back();
+        if (level < DOMAIN_SHRINK_LEVELS && node->numP_ > 1){
+            for (const auto& octNode: node->octNodes_){
+                if (octNode != nullptr){
+                    nodesToProcess.emplace_back(octNode, level+1);
+                }
+            }
+        }
+        else {
+            // leaf nodes with one particle are bounded by the particle, deeper nodes by their node box:
+            Core::Vector nodeMin = node->min_;
+            Core::Vector nodeMax = node->max_;
+            if (node->numP_ == 1){
+                nodeMin = node->particle_->wrappedParticle->getLocation();
+                nodeMax = nodeMin;
+            }
+            occupiedMin.set(std::min(occupiedMin.x(), nodeMin.x()), std::min(occupiedMin.y(), nodeMin.y()),
+                            std::min(occupiedMin.z(), nodeMin.z()));
+            occupiedMax.set(std::max(occupiedMax.x(), nodeMax.x()), std::max(occupiedMax.y(), nodeMax.y()),
+                            std::max(occupiedMax.z(), nodeMax.z()));
+        }
+    }
+    Core::Vector extent = occupiedMax - occupiedMin;
+    double occupiedEdgeLength = std::max(std::max(extent.x(), extent.y()), extent.z()) * (1.0 + 2.0 * DOMAIN_MARGIN);
+    double rootEdgeLength = root_->max_.x() - root_->min_.x();
+    return occupiedEdgeLength * DOMAIN_SHRINK_FACTOR < rootEdgeLength;
+}
+
+/**
+ * Computes a cubic domain which encloses all particles in the tree with a small margin. Tree nodes have to be cubic,
+ * since the distance criterion in the field calculation uses only one edge length of the nodes.
+ *
+ * @param min (output) the lower corner of the tight domain
+ * @param max (output) the upper corner of the tight domain
+ * @return the edge length of the tight domain
+ */
+double BTree::ParallelTree::tightDomain_(Core::Vector& min, Core::Vector& max) const {
+    Core::Vector pMin = root_->center_;
+    Core::Vector pMax = root_->center_;
+    if (!iVec_->empty()){
+        pMin = iVec_->front()->wrappedParticle->getLocation();
+        pMax = pMin;
+    }
+    for (const auto& particle: *iVec_){
+        Core::Vector loc = particle->wrappedParticle->getLocation();
+        pMin.set(std::min(pMin.x(), loc.x()), std::min(pMin.y(), loc.y()), std::min(pMin.z(), loc.z()));
+        pMax.set(std::max(pMax.x(), loc.x()), std::max(pMax.y(), loc.y()), std::max(pMax.z(), loc.z()));
+    }
+
+    Core::Vector extent = pMax - pMin;
+    double edgeLength = std::max(std::max(extent.x(), extent.y()), extent.z()) * (1.0 + 2.0 * DOMAIN_MARGIN);
+    edgeLength = std::max(edgeLength, MIN_DOMAIN_EDGE_LENGTH);
+
+    Core::Vector center = pMin + extent / 2.0;
+    Core::Vector halfEdge(edgeLength / 2.0, edgeLength / 2.0, edgeLength / 2.0);
+    min = center - halfEdge;
+    max = center + halfEdge;
+    return edgeLength;
+}
+
+/**
+ * Grows the domain of the tree until a given location is inside the domain. The domain is doubled in every step
+ * by creating a new root node which has the old root as one of its sub-octants (re-rooting), thus the existing tree
+ * structure is kept.
+ *
+ * @param location the location which should become part of the tree domain
+ */
+void BTree::ParallelTree::growDomain_(const Core::Vector& location) {
+    if (!std::isfinite(location.x()) || !std::isfinite(location.y()) || !std::isfinite(location.z())){
+        std::stringstream ss;
+        ss << "Tried to grow tree domain to a non finite location: " << location;
+        throw (std::invalid_argument(ss.str()));
+    }
+    domainGrown_ = true;
+    while (!isInDomain_(location)){
+        Core::Vector oldMin = root_->min_;
+        Core::Vector oldMax = root_->max_;
+        Core::Vector edge = oldMax - oldMin;
+
+        // grow in the direction of the location, the old root becomes the octant at the opposite corner:
+        Core::Vector newMin(
+                location.x() <= oldMin.x() ? oldMin.x() - edge.x() : oldMin.x(),
+                location.y() <= oldMin.y() ? oldMin.y() - edge.y() : oldMin.y(),
+                location.z() <= oldMin.z() ? oldMin.z() - edge.z() : oldMin.z());
+        Core::Vector newMax(
+                location.x() <= oldMin.x() ? oldMax.x() : oldMax.x() + edge.x(),
+                location.y() <= oldMin.y() ? oldMax.y() : oldMax.y() + edge.y(),
+                location.z() <= oldMin.z() ? oldMax.z() : oldMax.z() + edge.z());
+        Core::Vector newCenter(
+                location.x() <= oldMin.x() ? oldMin.x() : oldMax.x(),
+                location.y() <= oldMin.y() ? oldMin.y() : oldMax.y(),
+                location.z() <= oldMin.z() ? oldMin.z() : oldMax.z());
+
+        if (root_->numP_ <= 1){
+            // a root without sub nodes can simply be enlarged:
+            root_->min_ = newMin;
+            root_->max_ = newMax;
+            root_->center_ = newCenter;
+            if (root_->numP_ == 0){
+                root_->centerOfCharge_ = newCenter;
+            }
+        }
+        else {
+            auto newRoot = std::make_unique<BTree::ParallelNode>(newMin, newMax, nullptr);
+            newRoot->initAsRoot();
+            // the shared corner of old and new root is set explicitly as center to prevent rounding errors
+            // in the octant determination:
+            newRoot->center_ = newCenter;
+            newRoot->numP_ = root_->numP_;
+            newRoot->charge_ = root_->charge_;
+            newRoot->centerOfCharge_ = root_->centerOfCharge_;
+
+            BTree::ParallelNode* oldRoot = root_.release();
+            oldRoot->parent_ = newRoot.get();
+            newRoot->octNodes_[newRoot->getOctant(oldRoot->center_)] = oldRoot;
+            root_ = std::move(newRoot);
+        }
+    }
+}
+
+/**
+ * Rebuilds the tree structure with a new root node with a given domain and re-inserts all particles.
+ * (The serialized tree data structures are not updated, thus updateNodes has to be called afterwards)
+ *
+ * @param min the lower corner of the new domain
+ * @param max the upper corner of the new domain
+ */
+void BTree::ParallelTree::rebuildDomain_(const Core::Vector& min, const Core::Vector& max) {
+    root_ = std::make_unique<BTree::ParallelNode>(min, max, nullptr);
+    root_->initAsRoot();
+    for (auto& particle: *iVec_){
+        root_->insertParticle(particle.get());
+    }
+}
+
 /**
  * Get number of tree levels in this tree
  */
@@ -38,13 +38,16 @@ namespace BTree {
 
     class ParallelTree: public SpaceCharge::FieldCalculator{
     public:
-        // Constructor:
+        // Constructors:
+        ParallelTree();
         ParallelTree(Core::Vector min, Core::Vector max);
 
         // Public member methods:
         [[nodiscard]] ParallelNode* getRoot() const;
         [[nodiscard]] treeParticlePtrList* getParticleList() const;
         [[nodiscard]] std::size_t getNumberOfParticles() const;
+        [[nodiscard]] bool isDomainDynamic() const;
+        [[nodiscard]] std::size_t memoryUsageBytes() const;
 
         std::size_t init();
         std::vector<std::size_t> countNodesOnLevels();
@@ -55,10 +58,20 @@ namespace BTree {
         [[nodiscard]] BTree::TreeParticle* getParticle(std::size_t ext_index) const;
         void updateParticleLocation(std::size_t extIndex, Core::Vector newLocation, int* numNodesChanged);
         std::size_t updateNodes(int ver);
+        void rebuildDomain();
+        void setStaticDomain(Core::Vector min, Core::Vector max);
         
         void printParticles() const;
 
     private:
+        static constexpr double DOMAIN_MARGIN = 0.05; ///< Relative margin added around the particle bounding box
+        static constexpr double DOMAIN_SHRINK_FACTOR = 4.0; ///< Root edge / tight edge ratio which triggers a rebuild
+        static constexpr double MIN_DOMAIN_EDGE_LENGTH = 1e-9; ///< Minimal root edge length of a dynamic domain
+
+        static constexpr std::size_t DOMAIN_SHRINK_LEVELS = 4; ///< Tree levels used for the detection of a contracted particle cloud
+
+        bool dynamicDomain_ = false; ///< Flag if the tree domain is adapted to the particle cloud
+        bool domainGrown_ = false; ///< Flag if the domain was grown since the last node update
         std::unique_ptr<ParallelNode> root_;
         std::unique_ptr<treeParticlePtrList> iVec_; ///< a linked particle list, stores the particles in a linear order
         std::unique_ptr<std::unordered_map<std::size_t, treeParticlePtrList::const_iterator>> iMap_; ///< a map between the ion indices (keys used by SIMION) and the pointers into the internal particle list
@@ -67,9 +80,14 @@ namespace BTree {
         std::vector<std::size_t> nodeStartIndicesOnLevels_; ///< Vector of serialized indices of the first nodes on the individual tree levels
         std::size_t numberOfNodesTotal_ = 0;
         std::size_t nodesReserveSize_ = 0; ///< Number of nodes which should be reserved in the serialized field calculation
-        std::vector<BTree::ParallelNode*>nodesSerialized_; ///< Serial vector of links to the tree nodes, used for parallelized access to the nodes
+        serializedNodeVector_t nodesSerialized_; ///< Serial vector of links to the tree nodes, used for parallelized access to the nodes
         std::size_t nTreeLevels_ = 0; //number of levels in the tree
 
+        [[nodiscard]] bool isInDomain_(const Core::Vector& location) const;
+        [[nodiscard]] bool isCloudContracted_() const;
+        double tightDomain_(Core::Vector& min, Core::Vector& max) const;
+        void growDomain_(const Core::Vector& location);
+        void rebuildDomain_(const Core::Vector& min, const Core::Vector& max);
         [[nodiscard]] std::size_t getTreeDepth_() const;
         void updateLevelStartIndices_();
         void serializeNodes_();
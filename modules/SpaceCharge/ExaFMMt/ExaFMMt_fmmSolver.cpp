@@ -23,62 +23,77 @@
 #include "build_tree.h"
 #include "build_list.h"
 #include "laplace.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
 
-Core::Vector ExaFMMt::FMMSolver::getEFieldFromSpaceCharge(Core::Particle& particle) {
-    auto iter =(*pMap_)[&particle];
-    return iter->gradient/SpaceCharge::NEGATIVE_EPSILON_0;
+namespace {
+    std::once_flag relativeCoordinatesInitialized; ///< the exafmm-t relative coordinate tables are process global
+
+    constexpr exafmm_t::real_t ROOT_BOX_MARGIN = 1.2; ///< root box size margin when the operators are (re)computed
+    constexpr exafmm_t::real_t MIN_ROOT_BOX_FILLING = 0.25; ///< min. relative cloud size in the root box before the operators are recomputed
 }
 
-void ExaFMMt::FMMSolver::computeChargeDistribution(){
+/**
+ * Persistent exafmm-t state of the solver, which is reused across time steps
+ */
+struct ExaFMMt::FMMSolver::FMMState{
+    std::unique_ptr<exafmm_t::LaplaceFmm> fmm; ///< the fmm instance with the precomputed translation operators
+    int fmmExpansionOrder = 0; ///< expansion order the fmm instance was created with
+    int fmmMaxBodiesPerLeaf = 0; ///< max. bodies per leaf the fmm instance was created with
 
-    // step 1: Prepare sources and targets
-    std::size_t nParticles = getNumberOfParticles();
+    exafmm_t::Bodies<exafmm_t::real_t> sources; ///< source bodies buffer
+    exafmm_t::Bodies<exafmm_t::real_t> targets; ///< target bodies buffer
+    exafmm_t::Nodes<exafmm_t::real_t> nodes; ///< the octree nodes
+    exafmm_t::NodePtrs<exafmm_t::real_t> leafs; ///< the leaf nodes of the octree
+    exafmm_t::NodePtrs<exafmm_t::real_t> nonleafs; ///< the non leaf nodes of the octree
 
-    exafmm_t::Bodies<exafmm_t::real_t> sources(nParticles);
-    exafmm_t::Bodies<exafmm_t::real_t> targets(nParticles);
+    bool hasTree = false; ///< true if the octree and its interaction lists are built
+    std::vector<SpaceCharge::particleListEntry*> pListEntriesPtrs; ///< particle list entries in body index order
+    std::vector<Core::Vector> treePositions; ///< particle positions at the last tree build
+    std::vector<double> maxDisplacements; ///< max. particle displacements from the tree positions for tree reuse
+};
 
-    std::size_t i = 0;
-    Core::Vector particlePos;
-    std::vector<SpaceCharge::particleListEntry*> pListEntriesPtrs;
-    for (SpaceCharge::particleListEntry& pListEntry : *iVec_) {
-        pListEntriesPtrs.emplace_back(&pListEntry);
-        sources[i].ibody = i;
-        targets[i].ibody = i;
-        particlePos = pListEntry.particle -> getLocation();
-        sources[i].X[0] = particlePos.x();
-        sources[i].X[1] = particlePos.y();
-        sources[i].X[2] = particlePos.z();
-
-        targets[i].X[0] = particlePos.x();
-        targets[i].X[1] = particlePos.y();
-        targets[i].X[2] = particlePos.z();
+ExaFMMt::FMMSolver::FMMSolver():
+state_(std::make_unique<FMMState>())
+{}
 
-        sources[i].q = pListEntry.particle -> getCharge();
-        ++i;
-    }
+ExaFMMt::FMMSolver::~FMMSolver() = default;
 
-    // step 2: Create an Fmm instance for Laplace kernel.
-    exafmm_t::LaplaceFmm fmm(expansionOrder_, maxBodiesPerLeaf_);
+Core::Vector ExaFMMt::FMMSolver::getEFieldFromSpaceCharge(Core::Particle& particle) {
+    auto iter =(*pMap_)[&particle];
+    return iter->gradient/SpaceCharge::NEGATIVE_EPSILON_0;
+}
 
-    // step 3: Build and balance the octree.
-    exafmm_t::NodePtrs<exafmm_t::real_t> leafs, nonleafs;
-    exafmm_t::Nodes<exafmm_t::real_t> nodes;
+/**
+ * Computes the potential and the field of the particles in the solver with the fast multipole method.
+ * The octree is reused from the previous call if possible, otherwise it is rebuilt.
+ */
+void ExaFMMt::FMMSolver::computeChargeDistribution(){
 
-    exafmm_t::get_bounds(sources, targets, fmm.x0, fmm.r0);
-    nodes = exafmm_t::build_tree(sources, targets, leafs, nonleafs, fmm);
+    if (getNumberOfParticles() == 0){
+        return;
+    }
 
+    // step 1: Update or rebuild the octree with its interaction lists
+    if (isTreeValid_()){
+        updateTreeBodies_();
+    }
+    else {
+        rebuildTree_();
+    }
 
-    // step 4: Build lists and pre-compute invariant matrices.
-    exafmm_t::init_rel_coord();
-    exafmm_t::build_list(nodes, fmm);
-    fmm.M2L_setup(nonleafs);
-    fmm.precompute();
+    // step 2: Use FMM to evaluate potential
+    exafmm_t::LaplaceFmm& fmm = *state_->fmm;
+    exafmm_t::Nodes<exafmm_t::real_t>& nodes = state_->nodes;
+    exafmm_t::NodePtrs<exafmm_t::real_t>& leafs = state_->leafs;
+    std::vector<SpaceCharge::particleListEntry*>& pListEntriesPtrs = state_->pListEntriesPtrs;
 
-    // step 5: Use FMM to evaluate potential
     fmm.upward_pass(nodes, leafs, false);
     fmm.downward_pass(nodes, leafs, false);
 
-    //#pragma omp parallel for default(none) shared(leafs, pListEntriesPtrs)
+    // step 3: Scatter the results back to the particle list entries (every body is target in exactly one leaf)
+    #pragma omp parallel for default(none) shared(leafs, pListEntriesPtrs)
     for (size_t k=0; k<leafs.size(); ++k) {
         exafmm_t::Node<exafmm_t::real_t>* leaf = leafs[k];
         std::vector<int> & itrgs = leaf->itrgs;
@@ -99,4 +114,163 @@ void ExaFMMt::FMMSolver::setExpansionOrder(int expansionOrder) {
 
 void ExaFMMt::FMMSolver::setMaxBodiesPerLeaf(int maxBodiesPerLeaf) {
     maxBodiesPerLeaf_ = maxBodiesPerLeaf;
-}
\ No newline at end of file
+}
+
+/**
+ * Sets the threshold for the reuse of the octree: The tree is rebuilt if any particle has moved more than
+ * treeRebuildThreshold times the half width of its leaf since the last tree build. A threshold of zero (the
+ * default) rebuilds the tree in every time step.
+ */
+void ExaFMMt::FMMSolver::setTreeRebuildThreshold(double treeRebuildThreshold) {
+    if (treeRebuildThreshold < 0.0){
+        throw (std::invalid_argument("Negative FMM tree rebuild threshold"));
+    }
+    treeRebuildThreshold_ = treeRebuildThreshold;
+}
+
+/**
+ * Gets the number of octree builds performed by the solver
+ */
+std::size_t ExaFMMt::FMMSolver::getNumberOfTreeBuilds() const {
+    return nTreeBuilds_;
+}
+
+/**
+ * Checks if the octree from the last tree build can be reused for the current particles
+ */
+bool ExaFMMt::FMMSolver::isTreeValid_() {
+    FMMState& st = *state_;
+    if (!st.hasTree || treeRebuildThreshold_ <= 0.0 ||
+        st.fmmExpansionOrder != expansionOrder_ || st.fmmMaxBodiesPerLeaf != maxBodiesPerLeaf_ ||
+        st.pListEntriesPtrs.size() != getNumberOfParticles()){
+        return false;
+    }
+
+    std::size_t i = 0;
+    for (SpaceCharge::particleListEntry& pListEntry : *iVec_) {
+        if (st.pListEntriesPtrs[i] != &pListEntry ||
+            (pListEntry.particle->getLocation() - st.treePositions[i]).magnitude() > st.maxDisplacements[i]){
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+/**
+ * Builds the octree and the interaction lists for the current particles. The fmm instance and its precomputed
+ * translation operators are reused if the expansion parameters are unchanged and the particle cloud still fits
+ * into the root box the operators were computed for.
+ */
+void ExaFMMt::FMMSolver::rebuildTree_() {
+    FMMState& st = *state_;
+
+    // Prepare sources and targets
+    std::size_t nParticles = getNumberOfParticles();
+    st.sources.resize(nParticles);
+    st.targets.resize(nParticles);
+    st.pListEntriesPtrs.resize(nParticles);
+    st.treePositions.resize(nParticles);
+    st.maxDisplacements.resize(nParticles);
+
+    std::size_t i = 0;
+    Core::Vector particlePos;
+    for (SpaceCharge::particleListEntry& pListEntry : *iVec_) {
+        st.pListEntriesPtrs[i] = &pListEntry;
+        st.sources[i].ibody = static_cast<int>(i);
+        st.targets[i].ibody = static_cast<int>(i);
+        particlePos = pListEntry.particle -> getLocation();
+        st.treePositions[i] = particlePos;
+        st.sources[i].X[0] = particlePos.x();
+        st.sources[i].X[1] = particlePos.y();
+        st.sources[i].X[2] = particlePos.z();
+
+        st.targets[i].X[0] = particlePos.x();
+        st.targets[i].X[1] = particlePos.y();
+        st.targets[i].X[2] = particlePos.z();
+
+        st.sources[i].q = pListEntry.particle -> getCharge();
+        ++i;
+    }
+
+    // Create a new fmm instance for the Laplace kernel, if the current one is not usable
+    exafmm_t::vec3 x0;
+    exafmm_t::real_t r0;
+    exafmm_t::get_bounds(st.sources, st.targets, x0, r0);
+
+    bool recomputeOperators = !st.fmm ||
+            st.fmmExpansionOrder != expansionOrder_ || st.fmmMaxBodiesPerLeaf != maxBodiesPerLeaf_ ||
+            r0 > st.fmm->r0 || r0 < MIN_ROOT_BOX_FILLING * st.fmm->r0;
+
+    if (recomputeOperators){
+        st.fmm = std::make_unique<exafmm_t::LaplaceFmm>(expansionOrder_, maxBodiesPerLeaf_);
+        st.fmm->r0 = r0 * ROOT_BOX_MARGIN;
+        st.fmmExpansionOrder = expansionOrder_;
+        st.fmmMaxBodiesPerLeaf = maxBodiesPerLeaf_;
+    }
+    st.fmm->x0 = x0;
+
+    // Build and balance the octree
+    st.leafs.clear();
+    st.nonleafs.clear();
+    st.nodes = exafmm_t::build_tree(st.sources, st.targets, st.leafs, st.nonleafs, *st.fmm);
+
+    // Build lists and pre-compute invariant matrices (only for a new fmm instance)
+    std::call_once(relativeCoordinatesInitialized, [](){exafmm_t::init_rel_coord();});
+    exafmm_t::build_list(st.nodes, *st.fmm);
+    st.fmm->M2L_setup(st.nonleafs);
+    if (recomputeOperators){
+        st.fmm->precompute();
+    }
+
+    // Calculate the allowed particle displacements for the reuse of the tree
+    for (exafmm_t::Node<exafmm_t::real_t>* leaf : st.leafs){
+        double maxDisplacement = treeRebuildThreshold_ * leaf->r;
+        for (int ibody : leaf->itrgs){
+            st.maxDisplacements[static_cast<std::size_t>(ibody)] = maxDisplacement;
+        }
+    }
+
+    st.hasTree = true;
+    ++nTreeBuilds_;
+}
+
+/**
+ * Updates the positions and charges of the bodies in the leafs of the existing octree and resets the
+ * expansions and the results of the previous evaluation
+ */
+void ExaFMMt::FMMSolver::updateTreeBodies_() {
+    exafmm_t::Nodes<exafmm_t::real_t>& nodes = state_->nodes;
+    exafmm_t::NodePtrs<exafmm_t::real_t>& leafs = state_->leafs;
+    std::vector<SpaceCharge::particleListEntry*>& pListEntriesPtrs = state_->pListEntriesPtrs;
+
+    #pragma omp parallel default(none) shared(nodes, leafs, pListEntriesPtrs)
+    {
+        #pragma omp for
+        for (size_t k=0; k<nodes.size(); ++k) {
+            std::fill(nodes[k].up_equiv.begin(), nodes[k].up_equiv.end(), 0);
+            std::fill(nodes[k].dn_equiv.begin(), nodes[k].dn_equiv.end(), 0);
+        }
+
+        #pragma omp for
+        for (size_t k=0; k<leafs.size(); ++k) {
+            exafmm_t::Node<exafmm_t::real_t>* leaf = leafs[k];
+            Core::Vector particlePos;
+            for (size_t j=0; j<leaf->isrcs.size(); ++j) {
+                Core::Particle* particle = pListEntriesPtrs[leaf->isrcs[j]]->particle;
+                particlePos = particle->getLocation();
+                leaf->src_coord[3*j+0] = particlePos.x();
+                leaf->src_coord[3*j+1] = particlePos.y();
+                leaf->src_coord[3*j+2] = particlePos.z();
+                leaf->src_value[j] = particle->getCharge();
+            }
+            for (size_t j=0; j<leaf->itrgs.size(); ++j) {
+                particlePos = pListEntriesPtrs[leaf->itrgs[j]]->particle->getLocation();
+                leaf->trg_coord[3*j+0] = particlePos.x();
+                leaf->trg_coord[3*j+1] = particlePos.y();
+                leaf->trg_coord[3*j+2] = particlePos.z();
+            }
+            std::fill(leaf->trg_value.begin(), leaf->trg_value.end(), 0);
+        }
+    }
+}
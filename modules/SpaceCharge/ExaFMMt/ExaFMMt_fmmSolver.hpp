@@ -28,21 +28,49 @@
 #define IDSIMF_EXAFMMT_FMMSOLVER_HPP
 
 #include "SC_generic.hpp"
+#include <memory>
 
 namespace ExaFMMt{
 
-    // add expansion order template
+    /**
+     * Space charge solver based on the exafmm-t library.
+     *
+     * The solver keeps the exafmm-t state alive across time steps: The precomputed translation operators and the
+     * body buffers are reused. By default, the octree with its interaction lists is rebuilt in every time step.
+     * With a positive tree rebuild threshold, the octree is only rebuilt if the set of particles in the solver
+     * changes or if a particle has moved more than this fraction of the half width of its leaf since the last
+     * tree build. Otherwise only the particle positions and charges in the leafs are updated before the FMM
+     * evaluation. Since particles can leave their leaf boxes in this mode, which violates the well separatedness
+     * assumed by the FMM interaction lists, tree reuse has to be validated against a per step rebuild for a
+     * simulation. The translation operators are only
+     * recomputed if the expansion parameters change or if the particle cloud outgrows (or shrinks far below) the
+     * root box the operators were computed for.
+     */
     class FMMSolver : public SpaceCharge::GenericSpaceChargeSolver {
 
     public:
+        FMMSolver();
+        ~FMMSolver() override;
+
         [[nodiscard]] virtual Core::Vector getEFieldFromSpaceCharge(Core::Particle& particle) override;
         void computeChargeDistribution() override;
         void setExpansionOrder(int expansionOrder);
         void setMaxBodiesPerLeaf(int maxBodiesPerLeaf);
+        void setTreeRebuildThreshold(double treeRebuildThreshold);
+        [[nodiscard]] std::size_t getNumberOfTreeBuilds() const;
 
     private:
+        struct FMMState; ///< persistent exafmm-t state (defined in the implementation to keep exafmm-t headers private)
+
+        bool isTreeValid_();
+        void rebuildTree_();
+        void updateTreeBodies_();
+
         int expansionOrder_ = 8;
         int maxBodiesPerLeaf_ = 400;
+        double treeRebuildThreshold_ = 0.0; ///< max. particle displacement (relative to the leaf half width) for tree reuse
+        std::size_t nTreeBuilds_ = 0; ///< number of octree builds performed by the solver
+        std::unique_ptr<FMMState> state_;
     };
 }
 
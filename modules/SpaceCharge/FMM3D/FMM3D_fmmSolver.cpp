@@ -31,38 +31,43 @@ extern "C" {
 void FMM3D::FMMSolver::computeChargeDistribution() {
     std::size_t nParticles = getNumberOfParticles();
 
-    std::vector<double> sources(3*nParticles);
-    std::vector<double> charges(nParticles);
-    std::vector<double> potentials(nParticles);
-    std::vector<double> gradients(3*nParticles);
+    pListEntriesPtrs_.resize(nParticles);
+    sources_.resize(3*nParticles);
+    charges_.resize(nParticles);
+    potentials_.resize(nParticles);
+    gradients_.resize(3*nParticles);
 
     std::size_t i = 0;
-    Core::Vector particlePos;
-    for (const SpaceCharge::particleListEntry& pListEntry : *iVec_) {
-        particlePos = pListEntry.particle -> getLocation();
-        sources[3*i] = particlePos.x();
-        sources[3*i+1] = particlePos.y();
-        sources[3*i+2] = particlePos.z();
-
-        charges[i] = pListEntry.particle -> getCharge();
+    for (SpaceCharge::particleListEntry& pListEntry : *iVec_) {
+        pListEntriesPtrs_[i] = &pListEntry;
         i++;
     }
 
+    #pragma omp parallel for default(none) shared(nParticles, pListEntriesPtrs_, sources_, charges_)
+    for (i=0; i<nParticles; ++i) {
+        Core::Particle* particle = pListEntriesPtrs_[i]->particle;
+        Core::Vector particlePos = particle -> getLocation();
+        sources_[3*i] = particlePos.x();
+        sources_[3*i+1] = particlePos.y();
+        sources_[3*i+2] = particlePos.z();
+
+        charges_[i] = particle -> getCharge();
+    }
+
     // call the actual fmm routine
     int ier =0;
     int nP = (int) nParticles;
-    lfmm3d_s_c_g_wrapper(&requestedPrecision_, &nP, sources.data(), charges.data(),
-                         potentials.data(), gradients.data(), &ier);
+    lfmm3d_s_c_g_wrapper(&requestedPrecision_, &nP, sources_.data(), charges_.data(),
+                         potentials_.data(), gradients_.data(), &ier);
 
     if (ier != 0){
         throw (std::runtime_error("FMM Calculation failed"));
     }
 
-    i = 0;
-    for (SpaceCharge::particleListEntry& pListEntry : *iVec_) {
-        pListEntry.potential = potentials[i];
-        pListEntry.gradient = {gradients[3*i], gradients[3*i+1], gradients[3*i+2]};
-        i++;
+    #pragma omp parallel for default(none) shared(nParticles, pListEntriesPtrs_, potentials_, gradients_)
+    for (i=0; i<nParticles; ++i) {
+        pListEntriesPtrs_[i]->potential = potentials_[i];
+        pListEntriesPtrs_[i]->gradient = {gradients_[3*i], gradients_[3*i+1], gradients_[3*i+2]};
     }
 }
 
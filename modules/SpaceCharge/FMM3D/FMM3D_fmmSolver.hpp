@@ -29,9 +29,14 @@
 #define IDSIMF_FMM3D_FMMSOLVER_HPP
 
 #include "SC_generic.hpp"
+#include <vector>
 
 namespace FMM3D{
 
+    /**
+     * Space charge solver based on the FMM3D library. The data buffers passed to FMM3D are kept across
+     * time steps and are only reallocated if the number of particles grows.
+     */
     class FMMSolver : public SpaceCharge::GenericSpaceChargeSolver {
 
     public:
@@ -40,6 +45,12 @@ namespace FMM3D{
 
     private:
         double requestedPrecision_ = 0.5e-6;
+
+        std::vector<SpaceCharge::particleListEntry*> pListEntriesPtrs_; ///< particle list entries in source order
+        std::vector<double> sources_; ///< source positions buffer
+        std::vector<double> charges_; ///< source charges buffer
+        std::vector<double> potentials_; ///< potentials buffer
+        std::vector<double> gradients_; ///< potential gradients buffer
     };
 }
 #endif //IDSIMF_FMM3D_FMMSOLVER_HPP
@@ -0,0 +1,333 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+ ****************************/
+
+#include "SC_steadyStateBeamSolver.hpp"
+#include "Core_constants.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Constructs a steady state beam solver with a regular grid
+ *
+ * @param gridMin lower corner of the grid
+ * @param gridMax upper corner of the grid
+ * @param nGridPoints number of grid nodes in the spatial directions (at least three)
+ * @param relaxationFactor under relaxation factor of the charge density between the iterations (0 < factor <= 1)
+ */
+SpaceCharge::SteadyStateBeamSolver::SteadyStateBeamSolver(Core::Vector gridMin, Core::Vector gridMax,
+                                                         std::array<std::size_t, 3> nGridPoints,
+                                                         double relaxationFactor):
+gridMin_(gridMin),
+nGridPoints_(nGridPoints),
+relaxationFactor_(relaxationFactor)
+{
+    std::array<double, 3> extent = {gridMax.x()-gridMin.x(), gridMax.y()-gridMin.y(), gridMax.z()-gridMin.z()};
+    for (std::size_t dim=0; dim<3; ++dim){
+        if (nGridPoints_[dim] < 3 || extent[dim] <= 0.0){
+            throw (std::invalid_argument("Illegal grid of steady state beam solver"));
+        }
+        spacing_[dim] = extent[dim] / static_cast<double>(nGridPoints_[dim] - 1);
+    }
+    if (relaxationFactor_ <= 0.0 || relaxationFactor_ > 1.0){
+        throw (std::invalid_argument("Illegal relaxation factor of steady state beam solver"));
+    }
+
+    // optimal over relaxation factor for the Poisson equation with Dirichlet boundaries on a box:
+    double cx = 1.0/(spacing_[0]*spacing_[0]);
+    double cy = 1.0/(spacing_[1]*spacing_[1]);
+    double cz = 1.0/(spacing_[2]*spacing_[2]);
+    double jacobiRadius = (cx*std::cos(M_PI/static_cast<double>(nGridPoints_[0]-1)) +
+                           cy*std::cos(M_PI/static_cast<double>(nGridPoints_[1]-1)) +
+                           cz*std::cos(M_PI/static_cast<double>(nGridPoints_[2]-1))) / (cx+cy+cz);
+    sorFactor_ = 2.0/(1.0 + std::sqrt(1.0 - jacobiRadius*jacobiRadius));
+
+    std::size_t nNodes = nGridPoints_[0]*nGridPoints_[1]*nGridPoints_[2];
+    depositedCharge_.resize(nNodes, 0.0);
+    chargeDensity_.resize(nNodes, 0.0);
+    potential_.resize(nNodes, 0.0);
+    field_.resize(nNodes, Core::Vector(0.0, 0.0, 0.0));
+}
+
+/**
+ * Sets the parameters of the iterative Poisson solution
+ *
+ * @param tolerance relative tolerance (maximum potential change in a SOR sweep relative to the maximum potential)
+ * @param maxIterations maximum number of SOR sweeps
+ */
+void SpaceCharge::SteadyStateBeamSolver::setPoissonParameters(double tolerance, std::size_t maxIterations) {
+    if (tolerance <= 0.0 || maxIterations == 0){
+        throw (std::invalid_argument("Illegal Poisson parameters of steady state beam solver"));
+    }
+    poissonTolerance_ = tolerance;
+    maxPoissonIterations_ = maxIterations;
+}
+
+/**
+ * Deposits a charge at a location onto the grid nodes (cloud in cell). A trajectory which carries the beam current
+ * I deposits the charge I*dt in every time step dt. Charges outside of the grid are discarded. The deposition is
+ * thread safe.
+ *
+ * @param location location of the charge
+ * @param charge the charge (C)
+ */
+void SpaceCharge::SteadyStateBeamSolver::depositCharge(const Core::Vector& location, double charge) {
+    std::array<std::size_t, 3> cell{};
+    std::array<double, 3> fraction{};
+    if (!gridCell_(location, cell, fraction)){
+        return;
+    }
+    for (std::size_t corner=0; corner<8; ++corner){
+        std::size_t ox = corner & 1;
+        std::size_t oy = (corner >> 1) & 1;
+        std::size_t oz = (corner >> 2) & 1;
+        double weight = (ox == 1 ? fraction[0] : 1.0-fraction[0]) *
+                        (oy == 1 ? fraction[1] : 1.0-fraction[1]) *
+                        (oz == 1 ? fraction[2] : 1.0-fraction[2]);
+        std::size_t i = index_(cell[0]+ox, cell[1]+oy, cell[2]+oz);
+        #pragma omp atomic
+        depositedCharge_[i] += charge*weight;
+    }
+}
+
+/**
+ * Updates the space charge field with the charge deposited since the last update: The charge density is relaxed
+ * towards the deposited charge density (if the charge density is empty, e.g. in the first update, the deposited
+ * density is taken directly), the Poisson equation is solved and the field is calculated. The deposited charge is
+ * cleared for the next iteration.
+ *
+ * @return the self consistency residual: the L1 norm of the difference between the deposited and the previous
+ * charge density, relative to the L1 norm of the larger density (one if the charge density was empty)
+ */
+double SpaceCharge::SteadyStateBeamSolver::updateField() {
+    double nodeVolume = spacing_[0]*spacing_[1]*spacing_[2];
+    double sumTraced = 0.0;
+    double sumPrevious = 0.0;
+    double sumDifference = 0.0;
+    for (std::size_t i=0; i<chargeDensity_.size(); ++i){
+        double tracedDensity = depositedCharge_[i] / nodeVolume;
+        sumTraced += std::fabs(tracedDensity);
+        sumPrevious += std::fabs(chargeDensity_[i]);
+        sumDifference += std::fabs(tracedDensity - chargeDensity_[i]);
+    }
+
+    // an empty charge density (no previous deposition) takes the traced density without relaxation:
+    double relaxation = sumPrevious > 0.0 ? relaxationFactor_ : 1.0;
+    for (std::size_t i=0; i<chargeDensity_.size(); ++i){
+        double tracedDensity = depositedCharge_[i] / nodeVolume;
+        chargeDensity_[i] += relaxation*(tracedDensity - chargeDensity_[i]);
+        depositedCharge_[i] = 0.0;
+    }
+
+    double residual = 0.0;
+    double normalization = std::max(sumTraced, sumPrevious);
+    if (normalization > 0.0){
+        residual = sumDifference / normalization;
+    }
+
+    solvePoisson_();
+    calculateField_();
+    ++nFieldUpdates_;
+    return residual;
+}
+
+/**
+ * Gets the number of field updates (self consistency iterations) performed
+ */
+std::size_t SpaceCharge::SteadyStateBeamSolver::numberOfFieldUpdates() const {
+    return nFieldUpdates_;
+}
+
+/**
+ * Gets the total charge of the (relaxed) charge density on the grid
+ */
+double SpaceCharge::SteadyStateBeamSolver::getTotalCharge() const {
+    double sum = 0.0;
+    for (double density: chargeDensity_){
+        sum += density;
+    }
+    return sum*spacing_[0]*spacing_[1]*spacing_[2];
+}
+
+/**
+ * Gets the (relaxed) charge density (C/m^3) at a location, zero outside of the grid
+ */
+double SpaceCharge::SteadyStateBeamSolver::getChargeDensity(const Core::Vector& location) const {
+    return interpolate_(chargeDensity_, location);
+}
+
+/**
+ * Gets the space charge potential (V) at a location, zero outside of the grid
+ */
+double SpaceCharge::SteadyStateBeamSolver::getPotential(const Core::Vector& location) const {
+    return interpolate_(potential_, location);
+}
+
+/**
+ * Gets the space charge field (V/m) at a location, zero outside of the grid
+ */
+Core::Vector SpaceCharge::SteadyStateBeamSolver::getField(const Core::Vector& location) const {
+    return interpolate_(field_, location);
+}
+
+/**
+ * Gets the space charge field at the location of a particle
+ */
+Core::Vector SpaceCharge::SteadyStateBeamSolver::getEFieldFromSpaceCharge(Core::Particle& particle) {
+    return getField(particle.getLocation());
+}
+
+/**
+ * Gets the linear index of a grid node
+ */
+std::size_t SpaceCharge::SteadyStateBeamSolver::index_(std::size_t ix, std::size_t iy, std::size_t iz) const {
+    return (iz*nGridPoints_[1] + iy)*nGridPoints_[0] + ix;
+}
+
+/**
+ * Finds the grid cell of a location
+ *
+ * @param location the location
+ * @param cell the indices of the lower corner node of the cell
+ * @param fraction the relative position of the location in the cell in the spatial directions (0..1)
+ * @return false if the location is outside of the grid
+ */
+bool SpaceCharge::SteadyStateBeamSolver::gridCell_(const Core::Vector& location,
+                                                   std::array<std::size_t, 3>& cell,
+                                                   std::array<double, 3>& fraction) const {
+    std::array<double, 3> relative = {
+            (location.x()-gridMin_.x())/spacing_[0],
+            (location.y()-gridMin_.y())/spacing_[1],
+            (location.z()-gridMin_.z())/spacing_[2]};
+    for (std::size_t dim=0; dim<3; ++dim){
+        auto nCells = static_cast<double>(nGridPoints_[dim] - 1);
+        if (!(relative[dim] >= 0.0 && relative[dim] <= nCells)){
+            return false;
+        }
+        cell[dim] = std::min(static_cast<std::size_t>(relative[dim]), nGridPoints_[dim] - 2);
+        fraction[dim] = relative[dim] - static_cast<double>(cell[dim]);
+    }
+    return true;
+}
+
+/**
+ * Trilinear interpolation of node values at a location, the default value of the value type outside of the grid
+ */
+template<typename T>
+T SpaceCharge::SteadyStateBeamSolver::interpolate_(const std::vector<T>& nodeValues,
+                                                    const Core::Vector& location) const {
+    std::array<std::size_t, 3> cell{};
+    std::array<double, 3> fraction{};
+    T result = nodeValues[0]*0.0;
+    if (!gridCell_(location, cell, fraction)){
+        return result;
+    }
+    for (std::size_t corner=0; corner<8; ++corner){
+        std::size_t ox = corner & 1;
+        std::size_t oy = (corner >> 1) & 1;
+        std::size_t oz = (corner >> 2) & 1;
+        double weight = (ox == 1 ? fraction[0] : 1.0-fraction[0]) *
+                        (oy == 1 ? fraction[1] : 1.0-fraction[1]) *
+                        (oz == 1 ? fraction[2] : 1.0-fraction[2]);
+        result = result + nodeValues[index_(cell[0]+ox, cell[1]+oy, cell[2]+oz)]*weight;
+    }
+    return result;
+}
+
+/**
+ * Solves the Poisson equation for the current charge density with red black successive over relaxation, the
+ * potential of the previous iteration is the start value
+ */
+void SpaceCharge::SteadyStateBeamSolver::solvePoisson_() {
+    std::size_t nx = nGridPoints_[0];
+    std::size_t ny = nGridPoints_[1];
+    std::size_t nz = nGridPoints_[2];
+    std::size_t strideZ = nx*ny;
+    double cx = 1.0/(spacing_[0]*spacing_[0]);
+    double cy = 1.0/(spacing_[1]*spacing_[1]);
+    double cz = 1.0/(spacing_[2]*spacing_[2]);
+    double diagonal = 2.0*(cx+cy+cz);
+    double omega = sorFactor_;
+    std::vector<double>& phi = potential_;
+    const std::vector<double>& rho = chargeDensity_;
+
+    for (std::size_t iteration=0; iteration<maxPoissonIterations_; ++iteration){
+        double maxChange = 0.0;
+        double maxPotential = 0.0;
+        for (std::size_t color=0; color<2; ++color){
+            #pragma omp parallel for default(none) \
+                    shared(phi, rho, nx, ny, nz, strideZ, cx, cy, cz, diagonal, omega, color) \
+                    reduction(max:maxChange, maxPotential) schedule(static)
+            for (std::size_t iz=1; iz<nz-1; ++iz){
+                for (std::size_t iy=1; iy<ny-1; ++iy){
+                    std::size_t ixStart = ((1+iy+iz) % 2 == color) ? 1 : 2;
+                    for (std::size_t ix=ixStart; ix<nx-1; ix+=2){
+                        std::size_t i = (iz*ny + iy)*nx + ix;
+                        double gaussSeidel = (rho[i]/Core::EPSILON_0 +
+                                cx*(phi[i-1] + phi[i+1]) +
+                                cy*(phi[i-nx] + phi[i+nx]) +
+                                cz*(phi[i-strideZ] + phi[i+strideZ])) / diagonal;
+                        double change = omega*(gaussSeidel - phi[i]);
+                        phi[i] += change;
+                        maxChange = std::max(maxChange, std::fabs(change));
+                        maxPotential = std::max(maxPotential, std::fabs(phi[i]));
+                    }
+                }
+            }
+        }
+        if (maxChange <= poissonTolerance_*maxPotential){
+            break;
+        }
+    }
+}
+
+/**
+ * Calculates the space charge field on the grid nodes from the potential (central differences in the interior and
+ * one sided differences on the grid boundary)
+ */
+void SpaceCharge::SteadyStateBeamSolver::calculateField_() {
+    std::size_t nx = nGridPoints_[0];
+    std::size_t ny = nGridPoints_[1];
+    std::size_t nz = nGridPoints_[2];
+
+    auto derivative = [this](std::size_t i, std::size_t position, std::size_t n, std::size_t stride, double h){
+        if (position == 0){
+            return (potential_[i+stride] - potential_[i]) / h;
+        }
+        else if (position == n-1){
+            return (potential_[i] - potential_[i-stride]) / h;
+        }
+        return (potential_[i+stride] - potential_[i-stride]) / (2.0*h);
+    };
+
+    #pragma omp parallel for default(none) shared(nx, ny, nz, derivative) schedule(static)
+    for (std::size_t iz=0; iz<nz; ++iz){
+        for (std::size_t iy=0; iy<ny; ++iy){
+            for (std::size_t ix=0; ix<nx; ++ix){
+                std::size_t i = index_(ix, iy, iz);
+                field_[i] = Core::Vector(
+                        -derivative(i, ix, nx, 1, spacing_[0]),
+                        -derivative(i, iy, ny, nx, spacing_[1]),
+                        -derivative(i, iz, nz, nx*ny, spacing_[2]));
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ SC_steadyStateBeamSolver.hpp
+
+ Grid based self consistent space charge solver for steady state (continuous) ion beams
+
+ ****************************/
+#ifndef IDSIMF_SC_STEADYSTATEBEAMSOLVER_HPP
+#define IDSIMF_SC_STEADYSTATEBEAMSOLVER_HPP
+
+#include "SC_generic.hpp"
+#include "Core_vector.hpp"
+#include <array>
+#include <vector>
+#include <cstddef>
+
+namespace SpaceCharge{
+
+    /**
+     * Space charge solver for the steady state of continuous ion beams (e.g. DC ion transfer optics).
+     *
+     * In the steady state, the space charge distribution of a continuous beam does not depend on time. Instead of
+     * simulating a time dependent population of ions until it stabilizes statistically, a set of representative
+     * trajectories is traced, each carrying a fraction of the beam current. A trajectory with the current I deposits
+     * the charge I*dt in every time step dt along its path onto a regular grid (cloud in cell deposition), which
+     * results in the steady state charge density of the beam. The space charge potential is calculated from the charge
+     * density by solving the Poisson equation on the grid (red black successive over relaxation, the potential is zero
+     * on the grid boundary), the space charge field is the negative gradient of the potential.
+     *
+     * The traced trajectories depend on the space charge field, thus tracing and field calculation are iterated until
+     * the charge density is self consistent. The charge density is under relaxed between the iterations
+     * (rho_new = rho_old + relaxationFactor * (rho_traced - rho_old)) to stabilize the iteration. Charge deposited
+     * outside of the grid is discarded, the space charge field outside of the grid is zero.
+     */
+    class SteadyStateBeamSolver : public FieldCalculator {
+
+    public:
+        SteadyStateBeamSolver(Core::Vector gridMin, Core::Vector gridMax, std::array<std::size_t, 3> nGridPoints,
+                              double relaxationFactor = 0.5);
+
+        void setPoissonParameters(double tolerance, std::size_t maxIterations);
+
+        void depositCharge(const Core::Vector& location, double charge);
+        double updateField();
+
+        [[nodiscard]] std::size_t numberOfFieldUpdates() const;
+        [[nodiscard]] double getTotalCharge() const;
+        [[nodiscard]] double getChargeDensity(const Core::Vector& location) const;
+        [[nodiscard]] double getPotential(const Core::Vector& location) const;
+        [[nodiscard]] Core::Vector getField(const Core::Vector& location) const;
+        [[nodiscard]] Core::Vector getEFieldFromSpaceCharge(Core::Particle& particle) override;
+
+    private:
+        [[nodiscard]] std::size_t index_(std::size_t ix, std::size_t iy, std::size_t iz) const;
+        [[nodiscard]] bool gridCell_(const Core::Vector& location,
+                                     std::array<std::size_t, 3>& cell, std::array<double, 3>& fraction) const;
+        template<typename T> [[nodiscard]] T interpolate_(const std::vector<T>& nodeValues,
+                                                          const Core::Vector& location) const;
+        void solvePoisson_();
+        void calculateField_();
+
+        Core::Vector gridMin_; ///< Lower corner of the grid
+        std::array<std::size_t, 3> nGridPoints_; ///< Number of grid nodes in the spatial directions
+        std::array<double, 3> spacing_; ///< Distance between the grid nodes in the spatial directions
+        double relaxationFactor_; ///< Under relaxation factor of the charge density between the iterations
+
+        double poissonTolerance_ = 1e-6; ///< Relative tolerance of the Poisson solution
+        std::size_t maxPoissonIterations_ = 20000; ///< Maximum number of SOR sweeps of a Poisson solution
+        double sorFactor_; ///< Over relaxation factor of the SOR Poisson solver
+
+        std::size_t nFieldUpdates_ = 0; ///< Number of field updates (self consistency iterations)
+        std::vector<double> depositedCharge_; ///< Charge deposited on the grid nodes in the current iteration
+        std::vector<double> chargeDensity_; ///< Relaxed charge density on the grid nodes
+        std::vector<double> potential_; ///< Space charge potential on the grid nodes
+        std::vector<Core::Vector> field_; ///< Space charge field on the grid nodes
+    };
+}
+#endif //IDSIMF_SC_STEADYSTATEBEAMSOLVER_HPP
@@ -29,4 +29,33 @@ fields = [
 ]
 
 dat = {"grid_points": grid_points, "meshgrid": [X, Y, Z], "fields": fields}
-fg.write_3d_vector_fields_to_hdf5(dat, '../testfields/test_linear_vector_field_01.h5')
\ No newline at end of file
+fg.write_3d_vector_fields_to_hdf5(dat, '../testfields/test_linear_vector_field_01.h5')
+
+# define simple linear fields on a tetrahedral mesh:
+import itertools
+import h5py
+
+grid_points = [0, 2, 5, 10]
+n = len(grid_points)
+node_index = lambda i, j, k: i + n*j + n*n*k
+
+nodes = np.array([[grid_points[i], grid_points[j], grid_points[k]]
+                  for k in range(n) for j in range(n) for i in range(n)], dtype=np.float64)
+
+# every grid cell is split into 6 tetrahedra along its main diagonal:
+elements = []
+for k, j, i in itertools.product(range(n-1), repeat=3):
+    for perm in itertools.permutations([0, 1, 2]):
+        corner = [i, j, k]
+        element = [node_index(*corner)]
+        for axis in perm:
+            corner[axis] += 1
+            element.append(node_index(*corner))
+        elements.append(element)
+
+X, Y, Z = nodes[:, 0], nodes[:, 1], nodes[:, 2]
+with h5py.File('../testfields/test_linear_tetrahedral_mesh_field_01.h5', 'w') as h5f:
+    h5f.create_dataset('mesh/nodes', data=nodes)
+    h5f.create_dataset('mesh/elements', data=np.array(elements, dtype=np.int64))
+    h5f.create_dataset('fields/test_field', data=X + 2*Y + 3*Z)
+    h5f.create_dataset('fields/test_vectorfield', data=np.stack([X, Y + 1.0, -Z], axis=1))
@@ -0,0 +1,88 @@
+"""
+Reader for the shared memory ring buffer of live simulation frames, which is written by
+FileIO::SharedMemoryFrameWriter (see FileIO_sharedMemoryFrameDefs.hpp for the memory layout).
+
+Usage as script: python shm_frame_reader.py /idsimf_run01
+prints the mean particle position of the latest frame until the simulation is finished.
+"""
+
+import mmap
+import os
+import struct
+import sys
+import time
+
+import numpy as np
+
+MAGIC = 0x314D524653444931
+LAYOUT_VERSION = 1
+MAX_FIELDS = 32
+FIELD_NAME_LENGTH = 32
+SLOT_HEADER_SIZE = 64
+
+
+class SharedMemoryFrameReader:
+    """Read only consumer of a shared memory frame buffer (POSIX shared memory on Linux)"""
+
+    def __init__(self, shm_name):
+        fd = os.open('/dev/shm/' + shm_name.lstrip('/'), os.O_RDONLY)
+        try:
+            self._buffer = mmap.mmap(fd, 0, prot=mmap.PROT_READ)
+        finally:
+            os.close(fd)
+
+        magic, version, self.n_fields, self.n_slots, self.max_particles, self.slot_offset, self.slot_stride = \
+            struct.unpack_from('<QIIQQQQ', self._buffer, 0)
+        if magic != MAGIC or version != LAYOUT_VERSION:
+            raise ValueError('Shared memory segment ' + shm_name + ' is not a compatible frame buffer')
+
+        names = struct.unpack_from('<' + (str(FIELD_NAME_LENGTH) + 's') * MAX_FIELDS, self._buffer, 64)
+        self.field_names = [n.split(b'\0', 1)[0].decode() for n in names[:self.n_fields]]
+
+    def close(self):
+        self._buffer.close()
+
+    def frames_written(self):
+        return struct.unpack_from('<Q', self._buffer, 48)[0]
+
+    def writer_active(self):
+        return struct.unpack_from('<Q', self._buffer, 56)[0] != 0
+
+    def read_frame(self, frame_index):
+        """Reads a frame, returns (time, data array [n_particles, n_fields]) or None if the frame is not available"""
+        slot = self.slot_offset + (frame_index % self.n_slots) * self.slot_stride
+        expected_sequence = 2 * frame_index + 2
+        sequence, _, frame_time, n_particles = struct.unpack_from('<QQdQ', self._buffer, slot)
+        if sequence != expected_sequence:
+            return None
+        n_particles = min(n_particles, self.max_particles)
+        data = np.frombuffer(self._buffer, dtype='<f8', count=n_particles * self.n_fields,
+                             offset=slot + SLOT_HEADER_SIZE).reshape((n_particles, self.n_fields)).copy()
+        if struct.unpack_from('<Q', self._buffer, slot)[0] != expected_sequence:
+            return None
+        return frame_time, data
+
+    def read_latest_frame(self):
+        for _ in range(16):
+            n_frames = self.frames_written()
+            if n_frames == 0:
+                return None
+            frame = self.read_frame(n_frames - 1)
+            if frame is not None:
+                return frame
+        return None
+
+
+if __name__ == '__main__':
+    reader = SharedMemoryFrameReader(sys.argv[1])
+    print('fields:', reader.field_names)
+    last_index = -1
+    while reader.writer_active():
+        n_frames = reader.frames_written()
+        if n_frames - 1 != last_index:
+            frame = reader.read_latest_frame()
+            if frame is not None:
+                last_index = n_frames - 1
+                print('t={:.3e} mean position: {}'.format(frame[0], np.mean(frame[1][:, 0:3], axis=0)))
+        time.sleep(0.1)
+    reader.close()
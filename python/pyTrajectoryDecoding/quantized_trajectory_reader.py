@@ -0,0 +1,97 @@
+"""
+Reference reader for trajectory HDF5 files written by FileIO::TrajectoryHDF5Writer, which decodes quantized
+(error bounded, delta encoded) trajectories transparently.
+
+Quantized trajectories store the positions (and optionally the float particle attributes) of a time step as integer
+multiples of a quantization step in the datasets "positions_quantized" / "particle_attributes_float_quantized".
+Key frames (time step attribute "key frame" = 1) store the absolute integer values, all other time steps store the
+differences to the previous time step. Time steps without particles have no datasets.
+
+Usage as script: python quantized_trajectory_reader.py trajectory.hd5 [time step index]
+prints the mean particle position of a time step.
+"""
+
+import sys
+
+import h5py
+import numpy as np
+
+
+class TrajectoryReader:
+    """Reads the particle positions and float attributes of the time steps of a trajectory HDF5 file"""
+
+    def __init__(self, filename):
+        self._file = h5py.File(filename, 'r')
+        traj = self._file['particle_trajectory']
+        self.times = traj['times'][:]
+        self.position_step = float(traj.attrs['quantization position step'][0]) \
+            if 'quantization position step' in traj.attrs else 0.0
+        self.attribute_step = float(traj.attrs['quantization attribute step'][0]) \
+            if 'quantization attribute step' in traj.attrs else 0.0
+        self.attribute_names = [n.decode() if isinstance(n, bytes) else n
+                                for n in traj.attrs.get('attributes names', [])]
+        self._cache = {}
+
+    def close(self):
+        self._file.close()
+
+    def number_of_timesteps(self):
+        return len(self.times)
+
+    def is_quantized(self):
+        return self.position_step > 0.0
+
+    def positions(self, timestep):
+        """Returns the positions of a time step as array [n_particles, 3]"""
+        if self.is_quantized():
+            return self._decode(timestep, 'positions_quantized', 3, self.position_step)
+        return self._read(timestep, 'positions', 3)
+
+    def particle_attributes_float(self, timestep):
+        """Returns the float particle attributes of a time step as array [n_particles, n_attributes]"""
+        n_attributes = len(self.attribute_names)
+        if self.attribute_step > 0.0:
+            return self._decode(timestep, 'particle_attributes_float_quantized', n_attributes, self.attribute_step)
+        return self._read(timestep, 'particle_attributes_float', n_attributes)
+
+    def _group(self, timestep):
+        return self._file['particle_trajectory/timesteps/' + str(timestep)]
+
+    def _read(self, timestep, ds_name, n_columns):
+        group = self._group(timestep)
+        if ds_name not in group:
+            return np.zeros((0, n_columns))
+        return group[ds_name][:].astype(np.float64)
+
+    def _is_start_frame(self, timestep, ds_name):
+        group = self._group(timestep)
+        return ds_name not in group or group.attrs['key frame'][0] == 1
+
+    def _decode(self, timestep, ds_name, n_columns, step):
+        # search backwards for the cached time step or the last key frame:
+        cached_timestep, cached_values = self._cache.get(ds_name, (None, None))
+        start = timestep
+        while start != cached_timestep and not self._is_start_frame(start, ds_name):
+            start -= 1
+
+        if start == cached_timestep:
+            values = cached_values.copy()
+        else:
+            group = self._group(start)
+            values = group[ds_name][:].astype(np.int64) if ds_name in group \
+                else np.zeros((0, n_columns), dtype=np.int64)
+
+        for ts in range(start + 1, timestep + 1):
+            values += self._group(ts)[ds_name][:].astype(np.int64)
+
+        self._cache[ds_name] = (timestep, values)
+        return values.astype(np.float64) * step
+
+
+if __name__ == '__main__':
+    reader = TrajectoryReader(sys.argv[1])
+    ts_index = int(sys.argv[2]) if len(sys.argv) > 2 else reader.number_of_timesteps() - 1
+    pos = reader.positions(ts_index)
+    print('time step {} (t = {}): {} particles, mean position {}'.format(
+        ts_index, reader.times[ts_index], pos.shape[0], pos.mean(axis=0) if pos.shape[0] > 0 else None))
+    reader.close()
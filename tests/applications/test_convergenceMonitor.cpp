@@ -0,0 +1,154 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_convergenceMonitor.cpp
+
+ Tests of the convergence monitor for early termination of simulations
+
+ ****************************/
+
+#include "appUtils_convergenceMonitor.hpp"
+#include "Integration_parallelVerletIntegrator.hpp"
+#include "catch.hpp"
+#include <random>
+#include <cmath>
+
+TEST_CASE( "Test convergence monitor", "[ApplicationUtils][ConvergenceMonitor]") {
+
+    SECTION("Student t quantiles should be correct") {
+        CHECK(Approx(AppUtils::ConvergenceMonitor::studentTQuantile(0.975, 31)).margin(2e-3) == 2.0395);
+        CHECK(Approx(AppUtils::ConvergenceMonitor::studentTQuantile(0.975, 10)).margin(2e-3) == 2.2281);
+        CHECK(Approx(AppUtils::ConvergenceMonitor::studentTQuantile(0.95, 63)).margin(2e-3) == 1.6694);
+        CHECK(Approx(AppUtils::ConvergenceMonitor::studentTQuantile(0.975, 1e6)).margin(1e-3) == 1.9600);
+        CHECK(Approx(AppUtils::ConvergenceMonitor::studentTQuantile(0.025, 31)).margin(2e-3) == -2.0395);
+    }
+
+    SECTION("Observables should be manageable and illegal parameters should throw") {
+        CHECK_THROWS_AS(AppUtils::ConvergenceMonitor(1.5), std::invalid_argument);
+        AppUtils::ConvergenceMonitor monitor;
+        CHECK_FALSE(monitor.isConverged());
+        CHECK(monitor.addObservable("a", 0.1) == 0);
+        CHECK(monitor.addObservable("b", 0.1, false) == 1);
+        CHECK_THROWS_AS(monitor.addObservable("a", 0.1), std::invalid_argument);
+        CHECK_THROWS_AS(monitor.addObservable("c", -0.1), std::invalid_argument);
+        CHECK(monitor.numberOfObservables() == 2);
+        CHECK(monitor.hasObservable("b"));
+        CHECK(monitor.observableIndex("b") == 1);
+        CHECK(monitor.observableName(1) == "b");
+        CHECK_THROWS_AS(monitor.addSample("not_monitored", 1.0), std::invalid_argument);
+    }
+
+    SECTION("Confidence intervals of uncorrelated samples should be correct") {
+        std::mt19937 rng(42);
+        std::normal_distribution<double> dist(5.0, 2.0);
+
+        AppUtils::ConvergenceMonitor monitor(0.95, 32);
+        std::size_t index = monitor.addObservable("x", 0.005);
+
+        for (std::size_t i=0; i<31; ++i){
+            monitor.addSample(index, dist(rng));
+        }
+        AppUtils::ConvergenceMonitor::Statistics stats = monitor.statistics(index);
+        CHECK(std::isinf(stats.confidenceHalfWidth));
+        CHECK_FALSE(stats.isConverged);
+
+        std::size_t nSamples = 100000;
+        for (std::size_t i=31; i<nSamples; ++i){
+            monitor.addSample(index, dist(rng));
+        }
+        stats = monitor.statistics(index);
+        double expectedHalfWidth = 1.96 * 2.0 / std::sqrt(static_cast<double>(nSamples));
+        CHECK(stats.nSamples == nSamples);
+        CHECK(stats.nBatches >= 32);
+        CHECK(stats.nBatches < 64);
+        CHECK(Approx(stats.mean).margin(3.0*expectedHalfWidth) == 5.0);
+        CHECK(Approx(stats.standardDeviation).epsilon(0.01) == 2.0);
+        CHECK(Approx(stats.confidenceHalfWidth).epsilon(0.35) == expectedHalfWidth);
+        CHECK(Approx(stats.targetHalfWidth) == 0.005 * stats.mean);
+        CHECK(stats.isConverged);
+        CHECK(monitor.isConverged());
+    }
+
+    SECTION("Confidence intervals of correlated samples should account for the correlation") {
+        std::mt19937 rng(42);
+        std::normal_distribution<double> dist(0.0, 1.0);
+
+        // autoregressive process with correlation coefficient phi, the variance of the mean is
+        // (1 + phi) / (1 - phi) times larger than for uncorrelated samples:
+        double phi = 0.9;
+        double value = 0.0;
+        AppUtils::ConvergenceMonitor monitor(0.95, 32);
+        std::size_t index = monitor.addObservable("ar", 0.01, false);
+        std::size_t nSamples = 200000;
+        for (std::size_t i=0; i<nSamples; ++i){
+            value = phi * value + dist(rng);
+            monitor.addSample(index, value);
+        }
+        AppUtils::ConvergenceMonitor::Statistics stats = monitor.statistics(index);
+        double sigma = std::sqrt(1.0 / (1.0 - phi*phi));
+        double expectedHalfWidth =
+                1.96 * sigma * std::sqrt((1.0 + phi) / (1.0 - phi) / static_cast<double>(nSamples));
+        CHECK(Approx(stats.standardDeviation).epsilon(0.05) == sigma);
+        CHECK(Approx(stats.confidenceHalfWidth).epsilon(0.35) == expectedHalfWidth);
+        CHECK_FALSE(stats.isConverged);
+        CHECK_FALSE(monitor.isConverged());
+    }
+
+    SECTION("Warm up samples should be discarded and converged monitor should terminate integrator") {
+        AppUtils::ConvergenceMonitor monitor(0.95, 4);
+        std::size_t index = monitor.addObservable("x", 1e-3, false, 10);
+        for (std::size_t i=0; i<10; ++i){
+            monitor.addSample(index, 1e6);
+        }
+        CHECK(monitor.statistics(index).nSamples == 0);
+
+        auto accelerationFct = [](Core::Particle* /*particle*/, int /*particleIndex*/,
+                                  SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 0.0, 0.0);
+        };
+        Integration::ParallelVerletIntegrator integrator(accelerationFct);
+        CHECK_FALSE(monitor.terminateIfConverged(integrator));
+
+        for (std::size_t i=0; i<8; ++i){
+            monitor.addSample(index, i%2 == 0 ? 1.0 : 1.0001);
+        }
+        AppUtils::ConvergenceMonitor::Statistics stats = monitor.statistics(index);
+        CHECK(stats.nSamples == 8);
+        CHECK(Approx(stats.mean) == 1.00005);
+        CHECK(stats.isConverged);
+        CHECK(monitor.terminateIfConverged(integrator));
+        CHECK(integrator.runState() == Integration::AbstractTimeIntegrator::IN_TERMINATION);
+    }
+
+    SECTION("Convergence monitor should be configurable by simulation configuration") {
+        AppUtils::simConf_ptr simConf = std::make_shared<AppUtils::SimulationConfiguration>("convergenceMonitor.json");
+        std::unique_ptr<AppUtils::ConvergenceMonitor> monitor =
+                AppUtils::createConvergenceMonitor(simConf, {"drift_velocity", "cv", "other"});
+        REQUIRE(monitor != nullptr);
+        CHECK(monitor->numberOfObservables() == 2);
+        CHECK(monitor->observableName(1) == "cv");
+
+        CHECK_THROWS_AS(AppUtils::createConvergenceMonitor(simConf, {"drift_velocity"}), std::invalid_argument);
+
+        AppUtils::simConf_ptr otherConf = std::make_shared<AppUtils::SimulationConfiguration>("ionBox.json");
+        CHECK(AppUtils::createConvergenceMonitor(otherConf, {"drift_velocity"}) == nullptr);
+    }
+}
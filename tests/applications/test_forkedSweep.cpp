@@ -0,0 +1,117 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_forkedSweep.cpp
+
+ Tests of forked parameter sweeps from a shared simulated prefix
+
+ ****************************/
+
+#include "appUtils_forkedSweep.hpp"
+#include "appUtils_simulationConfiguration.hpp"
+#include "appUtils_logging.hpp"
+#include "catch.hpp"
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+
+TEST_CASE( "Test forked sweeps", "[ApplicationUtils][ForkedSweep]") {
+
+    auto simConf = std::make_shared<AppUtils::SimulationConfiguration>("forkedSweep.json");
+    std::vector<std::string> variantParameters = {"V_rf", "f_rf", "excite_pulse_potential"};
+
+    SECTION("Variant configurations should replace the configured parameters") {
+        std::vector<AppUtils::simConf_ptr> variants =
+                simConf->variantConfigurations("sweep_variants", variantParameters);
+        REQUIRE(variants.size() == 3);
+        CHECK(variants[0]->doubleParameter("V_rf") == Approx(150.0));
+        CHECK(variants[0]->doubleParameter("f_rf") == Approx(1e6));
+        CHECK_FALSE(variants[0]->isParameter("excite_pulse_potential"));
+        CHECK(variants[1]->doubleParameter("V_rf") == Approx(200.0));
+        CHECK(variants[1]->doubleParameter("excite_pulse_potential") == Approx(1.5));
+        CHECK(variants[2]->doubleParameter("V_rf") == Approx(100.0));
+        CHECK(variants[2]->doubleParameter("f_rf") == Approx(2e6));
+        CHECK(simConf->doubleParameter("V_rf") == Approx(100.0));
+
+        CHECK_THROWS_AS(simConf->variantConfigurations("V_rf", variantParameters), std::invalid_argument);
+        CHECK_THROWS_AS(simConf->variantConfigurations("not_existing", variantParameters), std::invalid_argument);
+    }
+
+    SECTION("Variant parameters which are not read again in the variants should be rejected") {
+        CHECK_THROWS_AS(simConf->variantConfigurations("sweep_variants", {"V_rf", "f_rf"}), std::invalid_argument);
+        CHECK_THROWS_AS(AppUtils::createForkedSweep(simConf, "sweep_result", {"V_rf"}), std::invalid_argument);
+    }
+
+    SECTION("Forked sweeps should be created from the simulation configuration") {
+        std::unique_ptr<AppUtils::ForkedSweep> sweep =
+                AppUtils::createForkedSweep(simConf, "sweep_result", variantParameters);
+        REQUIRE(sweep);
+        CHECK(sweep->variantThreads() == 1);
+        CHECK(sweep->numberOfVariants() == 3);
+        CHECK(sweep->prefixTimesteps() == 200);
+        CHECK_FALSE(sweep->isForkTimestep(199));
+        CHECK(sweep->isForkTimestep(200));
+        CHECK_FALSE(sweep->isVariantProcess());
+        CHECK(sweep->variantResultName(2) == "sweep_result_variant_2");
+        CHECK_THROWS_AS(sweep->variantConfiguration(), std::invalid_argument);
+
+        auto confWithoutSweep = std::make_shared<AppUtils::SimulationConfiguration>("convergenceMonitor.json");
+        CHECK(AppUtils::createForkedSweep(confWithoutSweep, "sweep_result", variantParameters) == nullptr);
+        CHECK_THROWS_AS(AppUtils::ForkedSweep({}, 10, "sweep_result"), std::invalid_argument);
+        CHECK_THROWS_AS(AppUtils::ForkedSweep({simConf}, 10, "sweep_result", 0), std::invalid_argument);
+        CHECK_THROWS_AS(AppUtils::ForkedSweep({simConf}, 10, "sweep_result", 1, 0), std::invalid_argument);
+    }
+
+    SECTION("Variant processes should continue with the state of the prefix and their variant configuration") {
+        std::unique_ptr<AppUtils::ForkedSweep> sweep =
+                AppUtils::createForkedSweep(simConf, "forkedSweep_test", variantParameters);
+        spdlog::drop("logger");
+        AppUtils::logger_ptr logger = AppUtils::createLogger("forkedSweep_test.log");
+        double prefixState = 42.0;
+
+        std::size_t variantIndex = sweep->forkVariants(logger);
+        if (variantIndex != AppUtils::ForkedSweep::PREFIX_PROCESS) {
+            // variant process: export the prefix state and the variant parameter, and terminate
+            std::ofstream result(sweep->variantResultName(variantIndex) + ".txt");
+            result << prefixState << " " << sweep->variantConfiguration()->doubleParameter("V_rf");
+            result.close();
+            _exit(variantIndex == 2 ? EXIT_FAILURE : EXIT_SUCCESS);
+        }
+
+        CHECK_FALSE(sweep->isVariantProcess());
+        CHECK_FALSE(sweep->isForkTimestep(200));
+        CHECK_THROWS_AS(sweep->forkVariants(logger), std::runtime_error);
+        CHECK(sweep->numberOfFailedVariants() == 1);
+
+        std::vector<double> expectedVRf = {150.0, 200.0, 100.0};
+        for (std::size_t i=0; i<3; ++i) {
+            std::string variantResultName = sweep->variantResultName(i);
+            CHECK(std::filesystem::exists(variantResultName + ".log"));
+            std::ifstream result(variantResultName + ".txt");
+            double state = 0.0;
+            double V_rf = 0.0;
+            result >> state >> V_rf;
+            CHECK(state == Approx(prefixState));
+            CHECK(V_rf == Approx(expectedVRf[i]));
+        }
+        spdlog::drop(logger->name());
+    }
+}
@@ -30,6 +30,7 @@
 #include "test_util.hpp"
 #include "Core_utils.hpp"
 #include <string>
+#include <cmath>
 
 TEST_CASE( "Test simulation configuration ", "[ApplicationUtils]") {
 
@@ -54,4 +55,23 @@ TEST_CASE( "Test simulation configuration ", "[ApplicationUtils]") {
         CHECK( !simConf.isVectorParameter("not_a_parameter"));
     }
 
+    SECTION("Sim Conf reading: Voltage schedules should be readable") {
+        std::unique_ptr<ParticleSimulation::VoltageSchedule> schedule =
+                simConf.voltageScheduleParameter("voltage_schedule");
+        REQUIRE(schedule->numberOfElectrodes() == 3);
+        CHECK(schedule->numberOfSignals() == 4);
+        CHECK(schedule->signal("rf").amplitude(0.5e-3) == Approx(200.0));
+        CHECK(schedule->signal("swift").carrierType() == ParticleSimulation::VoltageSchedule::Signal::SWIFT);
+
+        double time = 0.3e-6;
+        double rf = schedule->signal("rf").amplitude(time) * std::cos(2.0*M_PI*1e6*time);
+        const std::vector<double>& voltages = schedule->voltages(time, 0);
+        CHECK(voltages[0] == Approx(10.0 + rf));
+        CHECK(voltages[1] == Approx(-rf + 1.0));
+        CHECK(voltages[2] == Approx(-2.0));
+
+        CHECK_THROWS_AS(simConf.voltageScheduleParameter("invalid_voltage_schedule"), std::invalid_argument);
+        CHECK_THROWS_AS(simConf.voltageScheduleParameter("not_a_parameter"), std::invalid_argument);
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_swarmTransport.cpp
+
+ Tests of the ion swarm transport coefficient analysis and transport table output
+
+ ****************************/
+
+#include "ionMobility_swarmTransport.hpp"
+#include "PSim_sampledFunction.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <cmath>
+
+TEST_CASE( "Test swarm transport coefficient analysis", "[ApplicationUtils][SwarmTransport]") {
+
+    // synthetic swarm: the particles are placed symmetrically around the swarm center, which drifts with a constant
+    // velocity, the spread of the swarm grows with the square root of time as for a diffusing swarm:
+    double driftVelocity = 250.0;
+    double diffusionL = 2e-3;
+    double diffusionT = 5e-3;
+    std::vector<std::unique_ptr<Core::Particle>> particles;
+    std::vector<Core::Particle*> particlesPtrs;
+    std::vector<Core::Vector> unitOffsets = {{1, 0, 1}, {-1, 0, -1}, {0, 1, 1}, {0, -1, -1}};
+    for (std::size_t i=0; i<unitOffsets.size(); ++i){
+        particles.emplace_back(std::make_unique<Core::Particle>(Core::Vector(0.0, 0.0, 0.0), 1.0));
+        particlesPtrs.push_back(particles.back().get());
+    }
+
+    auto setSwarmPositions = [&](double time){
+        // the sample variances of the unit offsets are 4/3 (z) and 2/3 (x, y):
+        double spreadZ = std::sqrt(2.0*diffusionL*time * 3.0/4.0);
+        double spreadXY = std::sqrt(2.0*diffusionT*time * 3.0/2.0);
+        for (std::size_t i=0; i<particles.size(); ++i){
+            particles[i]->setLocation({
+                unitOffsets[i].x()*spreadXY,
+                unitOffsets[i].y()*spreadXY,
+                driftVelocity*time + unitOffsets[i].z()*spreadZ});
+        }
+    };
+
+    AppUtils::SwarmTransportAnalyzer analyzer;
+
+    SECTION("Transport coefficients of a synthetic swarm should be correct") {
+        for (int i=1; i<=10; ++i){
+            double time = i*1e-6;
+            setSwarmPositions(time);
+            analyzer.addSample(time, particlesPtrs);
+        }
+        CHECK(analyzer.numberOfSamples() == 10);
+
+        AppUtils::SwarmTransportCoefficients coefficients = analyzer.transportCoefficients();
+        CHECK(Approx(coefficients.driftVelocity_ms).epsilon(1e-9) == driftVelocity);
+        CHECK(Approx(coefficients.longitudinalDiffusion_m2s).epsilon(1e-9) == diffusionL);
+        CHECK(Approx(coefficients.transverseDiffusion_m2s).epsilon(1e-9) == diffusionT);
+    }
+
+    SECTION("Inactive particles should not be considered") {
+        auto inactiveParticle = std::make_unique<Core::Particle>(Core::Vector(1.0, 1.0, 1.0), 1.0);
+        inactiveParticle->setActive(false);
+        particlesPtrs.push_back(inactiveParticle.get());
+        for (int i=1; i<=5; ++i){
+            double time = i*1e-6;
+            setSwarmPositions(time);
+            analyzer.addSample(time, particlesPtrs);
+        }
+        CHECK(Approx(analyzer.transportCoefficients().driftVelocity_ms).epsilon(1e-9) == driftVelocity);
+    }
+
+    SECTION("Insufficient samples or particles should throw") {
+        setSwarmPositions(1e-6);
+        analyzer.addSample(1e-6, particlesPtrs);
+        CHECK_THROWS_AS(analyzer.transportCoefficients(), std::invalid_argument);
+
+        std::vector<Core::Particle*> singleParticle = {particlesPtrs[0]};
+        CHECK_THROWS_AS(analyzer.addSample(2e-6, singleParticle), std::invalid_argument);
+    }
+}
+
+TEST_CASE( "Test transport table output", "[ApplicationUtils][SwarmTransport]") {
+
+    std::vector<AppUtils::TransportTableEntry> table;
+    std::vector<double> fields = {10.0, 50.0, 100.0};
+    std::vector<double> mobilities = {2.0e-4, 2.2e-4, 1.8e-4};
+    for (double temperature: {300.0, 400.0}){
+        for (std::size_t i=0; i<fields.size(); ++i){
+            AppUtils::TransportTableEntry entry;
+            entry.reducedField_Td = fields[i];
+            entry.temperature_K = temperature;
+            entry.mobility = mobilities[i] * temperature/300.0;
+            table.push_back(entry);
+        }
+    }
+
+    SECTION("Mobility scaling function should be readable as sampled function") {
+        AppUtils::writeMobilityScalingFunction("test_mobility_scaling.csv", table, 400.0);
+        ParticleSimulation::SampledFunction scalingFunction("test_mobility_scaling.csv");
+        REQUIRE(scalingFunction.good());
+        CHECK(scalingFunction.size() == 4);
+        CHECK(Approx(scalingFunction.getInterpolatedValue(0.0)) == 1.0);
+        CHECK(Approx(scalingFunction.getInterpolatedValue(10.0)) == 1.0);
+        CHECK(Approx(scalingFunction.getInterpolatedValue(50.0)) == 1.1);
+        CHECK(Approx(scalingFunction.getInterpolatedValue(75.0)) == 1.0);
+    }
+
+    SECTION("Missing temperature should throw") {
+        CHECK_THROWS_AS(AppUtils::writeMobilityScalingFunction("test_mobility_scaling.csv", table, 500.0),
+                std::invalid_argument);
+    }
+
+    SECTION("Zero field entries (with undefined mobility) should throw") {
+        AppUtils::TransportTableEntry zeroFieldEntry;
+        zeroFieldEntry.reducedField_Td = 0.0;
+        zeroFieldEntry.temperature_K = 300.0;
+        table.push_back(zeroFieldEntry);
+        CHECK_THROWS_AS(AppUtils::writeMobilityScalingFunction("test_mobility_scaling.csv", table, 300.0),
+                std::invalid_argument);
+        CHECK_THROWS_AS(AppUtils::writeTransportTable("test_transport_table.csv", table), std::invalid_argument);
+        CHECK_NOTHROW(AppUtils::writeMobilityScalingFunction("test_mobility_scaling.csv", table, 400.0));
+    }
+}
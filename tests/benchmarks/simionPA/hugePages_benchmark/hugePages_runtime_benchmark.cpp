@@ -0,0 +1,168 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+
+ Runtime benchmark of huge page backed field grids, particle arrays and tree storage: Random access lookups into
+ a large synthetic SIMION potential array and space charge calculation with the parallel Barnes-Hut tree are timed
+ with the different huge page modes
+
+ ****************************/
+
+#include "Core_hugePageAllocator.hpp"
+#include "Core_particle.hpp"
+#include "PSim_simionPotentialArray.hpp"
+#include "Integration_parallelVerletIntegrator.hpp"
+#include "appUtils_stopwatch.hpp"
+#include "CLI11.hpp"
+#include <omp.h>
+#include <cmath>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+
+/**
+ * Writes a synthetic planar 3d SIMION potential array with a smooth potential distribution
+ */
+void writeSyntheticPa(const std::string& filename, int nPerDirection){
+    std::ofstream out(filename, std::ios::binary);
+    int mode = -1;
+    int symmetry = 1; // planar
+    double maxVoltage = 100000.0;
+    unsigned mirror = 0;
+    out.write(reinterpret_cast<const char*>(&mode), sizeof(mode));
+    out.write(reinterpret_cast<const char*>(&symmetry), sizeof(symmetry));
+    out.write(reinterpret_cast<const char*>(&maxVoltage), sizeof(maxVoltage));
+    for (int i=0; i<3; ++i){
+        out.write(reinterpret_cast<const char*>(&nPerDirection), sizeof(nPerDirection));
+    }
+    out.write(reinterpret_cast<const char*>(&mirror), sizeof(mirror));
+
+    std::vector<double> plane(static_cast<std::size_t>(nPerDirection*nPerDirection));
+    for (int iz=0; iz<nPerDirection; ++iz){
+        for (int iy=0; iy<nPerDirection; ++iy){
+            for (int ix=0; ix<nPerDirection; ++ix){
+                plane[static_cast<std::size_t>(iy*nPerDirection + ix)] =
+                        100.0*std::sin(0.05*ix)*std::cos(0.03*iy) + 0.5*iz;
+            }
+        }
+        out.write(reinterpret_cast<const char*>(plane.data()),
+                static_cast<std::streamsize>(plane.size()*sizeof(double)));
+    }
+}
+
+void printHugePageBacking(){
+    std::cout << "huge page backed bytes (cumulative): transparent "
+              << Core::hugePageAllocatedBytes(Core::HugePageMode::TRANSPARENT)
+              << " explicit " << Core::hugePageAllocatedBytes(Core::HugePageMode::EXPLICIT)
+              << " regular pages " << Core::hugePageAllocatedBytes(Core::HugePageMode::NONE) << std::endl;
+}
+
+void benchmarkFieldLookup(const std::string& paFilename, int nPerDirection, unsigned int nSamples){
+    ParticleSimulation::SimionPotentialArray simPa(paFilename);
+
+    // random positions in the interior of the PA (the PA spatial scale is 1 mm per grid node):
+    double upper = (nPerDirection - 3)*0.001;
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> dist(0.001, upper);
+
+    AppUtils::Stopwatch stopWatch;
+    stopWatch.start();
+    double sum = 0.0;
+    for (unsigned int i=0; i<nSamples; ++i){
+        double x = dist(rng);
+        double y = dist(rng);
+        double z = dist(rng);
+        sum += simPa.getField(x, y, z).x();
+    }
+    stopWatch.stop();
+
+    std::cout << "random field lookups: " << nSamples << " (checksum " << sum << ")" << std::endl;
+    std::cout << "elapsed wall time:"<< stopWatch.elapsedSecondsWall()<<std::endl;
+    std::cout << "elapsed cpu time:"<< stopWatch.elapsedSecondsCPU()<<std::endl;
+}
+
+void benchmarkSpaceCharge(unsigned int nIons, unsigned int timeSteps){
+    std::vector<std::unique_ptr<Core::Particle>> particles;
+    std::vector<Core::Particle*> particlePtrs;
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (unsigned int i=0; i<nIons; ++i){
+        auto particle = std::make_unique<Core::Particle>(Core::Vector(dist(rng), dist(rng), dist(rng)), 1.0);
+        particle->setMassAMU(100);
+        particlePtrs.push_back(particle.get());
+        particles.push_back(std::move(particle));
+    }
+
+    auto accelerationFunction =
+            [](Core::Particle *particle, int /*particleIndex*/, SpaceCharge::FieldCalculator& scFieldCalculator,
+               double /*time*/, int /*timestep*/) -> Core::Vector{
+                return scFieldCalculator.getEFieldFromSpaceCharge(*particle) *
+                       (particle->getCharge() / particle->getMass());
+            };
+
+    Integration::ParallelVerletIntegrator integrator(particlePtrs, accelerationFunction);
+
+    AppUtils::Stopwatch stopWatch;
+    stopWatch.start();
+    integrator.run(timeSteps, 1e-3);
+    stopWatch.stop();
+
+    std::cout << "space charge time steps: " << timeSteps << " with " << nIons << " ions" << std::endl;
+    std::cout << "elapsed wall time:"<< stopWatch.elapsedSecondsWall()<<std::endl;
+    std::cout << "elapsed cpu time:"<< stopWatch.elapsedSecondsCPU()<<std::endl;
+}
+
+int main(int argc, char** argv) {
+    CLI::App app{"Runtime benchmark of huge page backed buffers", "hugePages benchmark"};
+
+    int nGridPoints = 320;
+    app.add_option("--grid_points,-g", nGridPoints, "number of grid points per direction of the synthetic PA");
+    unsigned int nSamples = 20000000;
+    app.add_option("--samples,-s", nSamples, "number of random field lookups");
+    unsigned int nIons = 50000;
+    app.add_option("--n_ions,-i", nIons, "number of ions for the space charge benchmark");
+    unsigned int timeSteps = 5;
+    app.add_option("--time_steps,-t", timeSteps, "number of time steps of the space charge benchmark");
+    int numberOfThreads = 1;
+    app.add_option("--n_threads,-n", numberOfThreads, "number of parallel threads");
+    CLI11_PARSE(app, argc, argv);
+
+    omp_set_num_threads(numberOfThreads);
+
+    std::string paFilename = "hugePages_benchmark_synthetic.pa";
+    writeSyntheticPa(paFilename, nGridPoints);
+
+    for (const char* modeName: {"none", "transparent", "explicit"}){
+        Core::setHugePageMode(Core::parseHugePageMode(modeName));
+        std::cout << "---- Huge page mode: " << modeName << " -------" << std::endl;
+        benchmarkFieldLookup(paFilename, nGridPoints, nSamples);
+        benchmarkSpaceCharge(nIons, timeSteps);
+        printHugePageBacking();
+    }
+    std::remove(paFilename.c_str());
+
+    std::cout << "====================" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_AtomCellGrid.cpp
+
+ Testing of the spatial atom index for cut-off based MD force calculation
+
+ ****************************/
+
+#include "CollisionModel_AtomCellGrid.hpp"
+#include "CollisionModel_MolecularStructure.hpp"
+#include "CollisionModel_Molecule.hpp"
+#include "CollisionModel_MDForceField_LJ12_6.hpp"
+#include "FileIO_MolecularStructureReader.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <vector>
+
+namespace {
+    /**
+     * Creates the atoms of a large synthetic ion: A cubic lattice of carbon atoms with two protons
+     */
+    std::vector<std::shared_ptr<CollisionModel::Atom>> createLatticeIonAtoms(int nPerDimension, double spacing){
+        std::vector<std::shared_ptr<CollisionModel::Atom>> atoms;
+        double offset = 0.5 * spacing * (nPerDimension - 1);
+        for (int i=0; i<nPerDimension; ++i){
+            for (int j=0; j<nPerDimension; ++j){
+                for (int k=0; k<nPerDimension; ++k){
+                    atoms.emplace_back(std::make_shared<CollisionModel::Atom>(
+                            Core::Vector(i*spacing - offset, j*spacing - offset, k*spacing - offset),
+                            12.0, 0.0, 0.0, CollisionModel::Atom::AtomType::C,
+                            3.4e-10 + 0.01e-10*(i%3), 0.36e3/Core::N_AVOGADRO));
+                }
+            }
+        }
+        atoms.emplace_back(std::make_shared<CollisionModel::Atom>(
+                Core::Vector(offset + 1.0e-10, 0.0, 0.0), 1.008, 1.0, 0.0, CollisionModel::Atom::AtomType::H,
+                2.5e-10, 0.1e3/Core::N_AVOGADRO));
+        atoms.emplace_back(std::make_shared<CollisionModel::Atom>(
+                Core::Vector(-offset - 1.0e-10, 0.5e-10, 0.0), 1.008, 1.0, 0.0, CollisionModel::Atom::AtomType::H,
+                2.5e-10, 0.1e3/Core::N_AVOGADRO));
+        return atoms;
+    }
+
+    std::vector<Core::Vector> calculateForces(std::shared_ptr<CollisionModel::MolecularStructure> ionStructure,
+                                              std::shared_ptr<CollisionModel::MolecularStructure> gasStructure,
+                                              Core::Vector gasPosition, Core::Vector ionAngles){
+        CollisionModel::Molecule ion(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), ionStructure);
+        CollisionModel::Molecule gas(gasPosition, Core::Vector(0.0, 0.0, 0.0), gasStructure);
+        ion.setAngles(ionAngles);
+        gas.setAngles(Core::Vector(0.3, -0.2, 0.7));
+
+        CollisionModel::MDForceField_LJ12_6 forceField(1.7e-30);
+        std::vector<CollisionModel::Molecule*> moleculesPtr = {&ion, &gas};
+        std::vector<Core::Vector> forces(2);
+        forceField.calculateForceField(moleculesPtr, forces);
+        return forces;
+    }
+}
+
+TEST_CASE("Test atom cell grid construction", "[CollisionModels][AtomCellGrid]") {
+
+    std::vector<std::shared_ptr<CollisionModel::Atom>> atoms = createLatticeIonAtoms(8, 1.5e-10);
+    CollisionModel::AtomCellGrid grid(atoms, 12.0e-10);
+
+    CHECK(grid.getCutoffRadius() == Approx(12.0e-10));
+    CHECK(grid.getCellSize() == Approx(3.0e-10));
+    CHECK(grid.getChargedAtomIndices() == std::vector<std::size_t>{512, 513});
+
+    // every uncharged atom is in exactly one cell, inside the bounding sphere of the cell:
+    std::vector<int> atomCellCount(atoms.size(), 0);
+    for (const auto& cell: grid.getCells()){
+        for (std::size_t i: cell.atomIndices){
+            atomCellCount[i]++;
+            CHECK((atoms[i]->getRelativePosition() - cell.center).magnitude() <= cell.radius*(1.0 + 1e-12));
+        }
+    }
+    for (std::size_t i=0; i<512; ++i){
+        CHECK(atomCellCount[i] == 1);
+    }
+    CHECK(grid.getCells().size() < 512);
+
+    CHECK_THROWS_AS(CollisionModel::AtomCellGrid(atoms, 0.0), std::invalid_argument);
+}
+
+TEST_CASE("Test aggregated dispersion coefficient of atom cell grid", "[CollisionModels][AtomCellGrid]") {
+
+    std::vector<std::shared_ptr<CollisionModel::Atom>> atoms = createLatticeIonAtoms(4, 1.5e-10);
+    CollisionModel::AtomCellGrid grid(atoms, 4.0e-10);
+    CollisionModel::Atom gasAtom(Core::Vector(0.0, 0.0, 0.0), 14.0, 0.0, -0.48,
+                                 CollisionModel::Atom::AtomType::N, 2.5e-10, 2.711e3/Core::N_AVOGADRO);
+
+    for (const auto& cell: grid.getCells()){
+        double c6Reference = 0.0;
+        for (std::size_t i: cell.atomIndices){
+            double sigma = CollisionModel::Atom::calcLJSig(*atoms[i], gasAtom);
+            double epsilon = CollisionModel::Atom::calcLJEps(*atoms[i], gasAtom);
+            c6Reference += 4.0 * epsilon * sigma*sigma*sigma*sigma*sigma*sigma;
+        }
+        CHECK(CollisionModel::AtomCellGrid::dispersionCoefficient(cell, gasAtom) == Approx(c6Reference).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("Test MD force calculation with atom cell grid", "[CollisionModels][AtomCellGrid]") {
+
+    FileIO::MolecularStructureReader reader = FileIO::MolecularStructureReader();
+    auto molecularStructureCollection = reader.readMolecularStructure("test_molecularstructure_reader.json");
+    std::vector<std::shared_ptr<CollisionModel::Atom>> atoms = createLatticeIonAtoms(12, 1.5e-10);
+    auto ionFull = std::make_shared<CollisionModel::MolecularStructure>(atoms, 20e-10, "lattice");
+    auto ionNoCutoff = std::make_shared<CollisionModel::MolecularStructure>(atoms, 20e-10, "lattice");
+    auto ionCutoff = std::make_shared<CollisionModel::MolecularStructure>(atoms, 20e-10, "lattice");
+    ionNoCutoff->buildAtomCellGrid(1.0);
+    ionCutoff->buildAtomCellGrid(10e-10);
+
+    Core::Vector ionAngles(0.4, 1.1, -0.6);
+    std::vector<Core::Vector> gasPositions = {{12e-10, 2e-10, -1e-10}, {-3e-10, 11.5e-10, 4e-10}, {2e-10, -1e-10, 13e-10}, {10e-10, 9e-10, 8e-10}};
+
+    for (const std::string gasName: {"N2", "He", "CO2"}){
+        auto gasStructure = molecularStructureCollection.at(gasName);
+        for (const auto& gasPosition: gasPositions){
+            std::vector<Core::Vector> forcesFull = calculateForces(ionFull, gasStructure, gasPosition, ionAngles);
+            REQUIRE(forcesFull[0].magnitude() > 0.0);
+
+            // without effective cut-off, the indexed force equals the full pairwise force:
+            std::vector<Core::Vector> forcesNoCutoff =
+                    calculateForces(ionNoCutoff, gasStructure, gasPosition, ionAngles);
+            for (std::size_t i=0; i<2; ++i){
+                CHECK((forcesNoCutoff[i] - forcesFull[i]).magnitude() < 1e-10 * forcesFull[i].magnitude());
+            }
+
+            // with cut-off radius, the long range corrected force approximates the full force:
+            std::vector<Core::Vector> forcesCutoff =
+                    calculateForces(ionCutoff, gasStructure, gasPosition, ionAngles);
+            CHECK((forcesCutoff[0] + forcesCutoff[1]).magnitude() < 1e-12 * forcesFull[0].magnitude());
+            CHECK((forcesCutoff[0] - forcesFull[0]).magnitude() < 5e-3 * forcesFull[0].magnitude());
+        }
+    }
+
+    SECTION("Cell centers are rotated with the molecule"){
+        CollisionModel::Molecule ion(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), ionCutoff);
+        ion.setAngles(ionAngles);
+        ion.setAngles(Core::Vector(-0.2, 0.5, 2.0));
+
+        const auto& cells = ionCutoff->getAtomCellGrid()->getCells();
+        REQUIRE(ion.getCellCenters().size() == cells.size());
+        for (std::size_t c=0; c<cells.size(); ++c){
+            Core::Vector centroid(0.0, 0.0, 0.0);
+            for (std::size_t i: cells[c].atomIndices){
+                centroid += ion.getAtoms()[i]->getRelativePosition();
+            }
+            centroid = centroid / static_cast<double>(cells[c].atomIndices.size());
+            CHECK((ion.getCellCenters()[c] - centroid).magnitude() < 1e-20);
+        }
+    }
+}
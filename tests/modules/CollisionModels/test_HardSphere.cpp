@@ -103,3 +103,40 @@ TEST_CASE( "Test Hard Sphere model after collision function", "[CollisionModels]
     CHECK(Approx(collisionEnergies[1]) == 0.0224838);
 }
 
+
+TEST_CASE( "Test Hard Sphere model collision frequency", "[CollisionModels][HardSphereModel]") {
+    double diameterHe = CollisionModel::HardSphereModel::DIAMETER_HE;
+    double pressure_Pa = 100.0;
+    double temperature_K = 298.0;
+    CollisionModel::HardSphereModel hs(pressure_Pa, temperature_K, 4.0, diameterHe);
+
+    Core::Particle ion;
+    ion.setDiameter(diameterHe);
+    ion.setMassAMU(28.0);
+
+    double numberDensity = pressure_Pa / (Core::K_BOLTZMANN*temperature_K);
+    double sigma = M_PI*diameterHe*diameterHe;
+    double vMeanGas = std::sqrt(8.0*Core::K_BOLTZMANN*temperature_K/(M_PI*4.0*Core::AMU_TO_KG));
+
+    CHECK(hs.hasCollisionEvents());
+
+    // a static ion collides with the mean gas speed, a fast ion approximately with its own speed:
+    ion.setVelocity(Core::Vector(0.0, 0.0, 0.0));
+    CHECK(Approx(hs.collisionFrequency(ion)).epsilon(1e-6) == numberDensity*sigma*vMeanGas);
+    ion.setVelocity(Core::Vector(0.0, 1e6, 0.0));
+    CHECK(Approx(hs.collisionFrequency(ion)).epsilon(1e-3) == numberDensity*sigma*1e6);
+
+    // the bound is the frequency with the increased speed and grows with the speed increase:
+    ion.setVelocity(Core::Vector(300.0, 0.0, 0.0));
+    double frequency = hs.collisionFrequency(ion);
+    CHECK(Approx(hs.collisionFrequencyBound(ion, 0.0)) == frequency);
+    double bound = hs.collisionFrequencyBound(ion, 500.0);
+    CHECK(bound > frequency);
+    ion.setVelocity(Core::Vector(0.0, 800.0, 0.0));
+    CHECK(Approx(hs.collisionFrequency(ion)) == bound);
+
+    // no collisions without background gas:
+    CollisionModel::HardSphereModel hsVacuum(0.0, temperature_K, 4.0, diameterHe);
+    CHECK(hsVacuum.collisionFrequency(ion) <= 0.0);
+    CHECK(hsVacuum.collisionFrequencyBound(ion, 1000.0) <= 0.0);
+}
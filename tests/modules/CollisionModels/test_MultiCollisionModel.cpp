@@ -70,3 +70,104 @@ TEST_CASE( "Test multi collision model with multiple hard sphere models ","[Coll
     CHECK(collisionCounts[1] == 2);
 }
 
+TEST_CASE( "Test collision events of multi collision model","[CollisionModels][MultiModel]") {
+    //Set the global random generator to a test random number generator to make the test experiment fully deterministic:
+    Core::globalRandomGeneratorPool = std::make_unique<Core::TestRandomGeneratorPool>();
+
+    double diameterHe = CollisionModel::HardSphereModel::DIAMETER_HE;
+    double diameterN2 = CollisionModel::HardSphereModel::DIAMETER_N2;
+
+    int collisionCounts[2] ={0,0};
+    auto countFct1 = CollisionModel::util::getCollisionCountFunction(&collisionCounts[0]);
+    auto countFct2 = CollisionModel::util::getCollisionCountFunction(&collisionCounts[1]);
+
+    auto hs1 = std::make_unique<CollisionModel::HardSphereModel>(1.0,298,4.0,diameterHe,countFct1);
+    auto hs2 = std::make_unique<CollisionModel::HardSphereModel>(0.5,298,28.0,diameterN2,countFct2);
+
+    Core::Particle ion = Core::Particle();
+    ion.setDiameter(diameterN2);
+    ion.setVelocity(Core::Vector(400,0,0));
+    ion.setMassAMU(28.0);
+
+    double frequency1 = hs1->collisionFrequency(ion);
+    double frequency2 = hs2->collisionFrequency(ion);
+    double bound1 = hs1->collisionFrequencyBound(ion, 100.0);
+    double bound2 = hs2->collisionFrequencyBound(ion, 100.0);
+
+    std::vector<std::unique_ptr<CollisionModel::AbstractCollisionModel>> models;
+    models.emplace_back(std::move(hs1));
+    models.emplace_back(std::move(hs2));
+    CollisionModel::MultiCollisionModel multiModel(std::move(models));
+
+    CHECK(multiModel.hasCollisionEvents());
+    CHECK(Approx(multiModel.collisionFrequency(ion)) == frequency1 + frequency2);
+    CHECK(Approx(multiModel.collisionFrequencyBound(ion, 100.0)) == bound1 + bound2);
+
+    // collisions are distributed to the sub models according to their collision frequencies:
+    int nCollisions = 2000;
+    for (int i=0; i<nCollisions; ++i){
+        ion.setVelocity(Core::Vector(400,0,0));
+        multiModel.performCollision(ion);
+    }
+    CHECK(collisionCounts[0] + collisionCounts[1] == nCollisions);
+    CHECK(Approx(collisionCounts[0] / static_cast<double>(nCollisions)).margin(0.05) ==
+            frequency1 / (frequency1 + frequency2));
+}
+
+namespace {
+    /**
+     * Minimal collision model with a constant continuous linear drag
+     */
+    class ConstantDragModel : public CollisionModel::AbstractCollisionModel {
+    public:
+        ConstantDragModel(double dampingRate, Core::Vector gasVelocity):
+        dampingRate_(dampingRate), gasVelocity_(gasVelocity){}
+
+        void updateModelParticleParameters(Core::Particle& /*ion*/) const override {}
+        void initializeModelParticleParameters(Core::Particle& /*ion*/) const override {}
+        void updateModelTimestepParameters(unsigned int /*timestep*/, double /*time*/) override {}
+        void modifyAcceleration(Core::Vector& /*acceleration*/, Core::Particle& /*ion*/, double /*dt*/) override {}
+        void modifyVelocity(Core::Particle& /*ion*/, double /*dt*/) override {}
+        void modifyPosition(Core::Vector& /*position*/, Core::Particle& /*ion*/, double /*dt*/) override {}
+
+        [[nodiscard]] double dragDampingRate(Core::Particle& /*ion*/) const override {
+            return dampingRate_;
+        }
+        [[nodiscard]] Core::Vector dragGasVelocity(Core::Particle& /*ion*/) const override {
+            return gasVelocity_;
+        }
+
+    private:
+        double dampingRate_;
+        Core::Vector gasVelocity_;
+    };
+}
+
+TEST_CASE( "Test continuous drag of multi collision model","[CollisionModels][MultiModel]") {
+    Core::Particle ion = Core::Particle();
+
+    SECTION("The drags of the sub models should be combined into one linear drag") {
+        std::vector<std::unique_ptr<CollisionModel::AbstractCollisionModel>> models;
+        models.emplace_back(std::make_unique<ConstantDragModel>(1.0e7, Core::Vector(10.0, 0.0, 0.0)));
+        models.emplace_back(std::make_unique<ConstantDragModel>(3.0e7, Core::Vector(0.0, 20.0, 0.0)));
+        models.emplace_back(std::make_unique<CollisionModel::HardSphereModel>(
+                1.0, 298, 4.0, CollisionModel::HardSphereModel::DIAMETER_HE));
+        CollisionModel::MultiCollisionModel multiModel(std::move(models));
+
+        CHECK(Approx(multiModel.dragDampingRate(ion)) == 4.0e7);
+        Core::Vector gasVelocity = multiModel.dragGasVelocity(ion);
+        CHECK(Approx(gasVelocity.x()) == 2.5);
+        CHECK(Approx(gasVelocity.y()) == 15.0);
+        CHECK(gasVelocity.z() == Approx(0.0));
+    }
+
+    SECTION("Sub models without continuous drag should result in no drag") {
+        std::vector<std::unique_ptr<CollisionModel::AbstractCollisionModel>> models;
+        models.emplace_back(std::make_unique<CollisionModel::HardSphereModel>(
+                1.0, 298, 4.0, CollisionModel::HardSphereModel::DIAMETER_HE));
+        CollisionModel::MultiCollisionModel multiModel(std::move(models));
+
+        CHECK(multiModel.dragDampingRate(ion) == Approx(0.0));
+        CHECK(multiModel.dragGasVelocity(ion).magnitude() == Approx(0.0));
+    }
+}
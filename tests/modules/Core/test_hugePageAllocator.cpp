@@ -0,0 +1,125 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_hugePageAllocator.cpp
+
+ Testing of the huge page backed allocation of large buffers
+
+ ****************************/
+
+#include "Core_hugePageAllocator.hpp"
+#include "catch.hpp"
+#include <numeric>
+#include <cstdint>
+#include <stdexcept>
+
+TEST_CASE( "Test huge page allocator", "[Core][memory]") {
+
+    using Core::HugePageMode;
+    using Core::HugePageSubsystem;
+
+    SECTION("Huge page modes and subsystems are parsed from their names"){
+        CHECK(Core::parseHugePageMode("none") == HugePageMode::NONE);
+        CHECK(Core::parseHugePageMode("Transparent") == HugePageMode::TRANSPARENT);
+        CHECK(Core::parseHugePageMode("EXPLICIT") == HugePageMode::EXPLICIT);
+        CHECK_THROWS_AS(Core::parseHugePageMode("huge"), std::invalid_argument);
+
+        CHECK(Core::parseHugePageSubsystem("fields") == HugePageSubsystem::FIELD_GRIDS);
+        CHECK(Core::parseHugePageSubsystem("particles") == HugePageSubsystem::PARTICLES);
+        CHECK(Core::parseHugePageSubsystem("tree") == HugePageSubsystem::TREE);
+        CHECK_THROWS_AS(Core::parseHugePageSubsystem("grid"), std::invalid_argument);
+    }
+
+    SECTION("Huge page modes are selected per subsystem and taken by the allocators at construction"){
+        Core::setHugePageMode(HugePageMode::NONE);
+        Core::setHugePageMode(HugePageSubsystem::TREE, HugePageMode::TRANSPARENT);
+        CHECK(Core::hugePageMode(HugePageSubsystem::FIELD_GRIDS) == HugePageMode::NONE);
+        CHECK(Core::hugePageMode(HugePageSubsystem::TREE) == HugePageMode::TRANSPARENT);
+
+        Core::hugePageVector<double, HugePageSubsystem::TREE> treeVector;
+        Core::hugePageVector<double, HugePageSubsystem::FIELD_GRIDS> fieldVector;
+        CHECK(treeVector.get_allocator().mode() == HugePageMode::TRANSPARENT);
+        CHECK(fieldVector.get_allocator().mode() == HugePageMode::NONE);
+
+        // changing the subsystem mode does not affect existing containers:
+        Core::setHugePageMode(HugePageSubsystem::TREE, HugePageMode::NONE);
+        CHECK(treeVector.get_allocator().mode() == HugePageMode::TRANSPARENT);
+        Core::setHugePageMode(HugePageMode::NONE);
+    }
+
+    SECTION("Large buffers are huge page aligned and usable in all modes"){
+        std::size_t nElements = 3*Core::HUGE_PAGE_SIZE/sizeof(double) + 17;
+        for (HugePageMode mode: {HugePageMode::NONE, HugePageMode::TRANSPARENT, HugePageMode::EXPLICIT}){
+            Core::HugePageAllocator<double, HugePageSubsystem::FIELD_GRIDS> allocator(mode);
+            Core::hugePageVector<double, HugePageSubsystem::FIELD_GRIDS> vec(nElements, 0.0, allocator);
+            std::iota(vec.begin(), vec.end(), 0.0);
+            CHECK(vec[nElements-1] == Approx(static_cast<double>(nElements-1)));
+
+            #ifdef __linux__
+            if (mode != HugePageMode::NONE){
+                CHECK(reinterpret_cast<std::uintptr_t>(vec.data()) % Core::HUGE_PAGE_SIZE == 0);
+            }
+            #endif
+
+            // copies and moves keep the mode of the allocator:
+            auto copied = vec;
+            CHECK(copied.get_allocator().mode() == mode);
+            CHECK(copied[42] == Approx(42.0));
+            auto moved = std::move(copied);
+            CHECK(moved.get_allocator().mode() == mode);
+            CHECK(moved[nElements-1] == Approx(static_cast<double>(nElements-1)));
+
+            vec.clear();
+            vec.shrink_to_fit();
+            vec.push_back(1.0);
+            CHECK(vec[0] == Approx(1.0));
+        }
+    }
+
+    SECTION("Mapped large buffers are accounted with their backing"){
+        std::size_t bytesBefore =
+                Core::hugePageAllocatedBytes(HugePageMode::NONE) +
+                Core::hugePageAllocatedBytes(HugePageMode::TRANSPARENT) +
+                Core::hugePageAllocatedBytes(HugePageMode::EXPLICIT);
+
+        Core::HugePageAllocator<char, HugePageSubsystem::PARTICLES> allocator(HugePageMode::EXPLICIT);
+        Core::hugePageVector<char, HugePageSubsystem::PARTICLES> vec(Core::HUGE_PAGE_SIZE + 1, 'a', allocator);
+        CHECK(vec.back() == 'a');
+
+        std::size_t bytesAfter =
+                Core::hugePageAllocatedBytes(HugePageMode::NONE) +
+                Core::hugePageAllocatedBytes(HugePageMode::TRANSPARENT) +
+                Core::hugePageAllocatedBytes(HugePageMode::EXPLICIT);
+        #ifdef __linux__
+            CHECK(bytesAfter - bytesBefore == 2*Core::HUGE_PAGE_SIZE);
+        #else
+            CHECK(bytesAfter == bytesBefore);
+        #endif
+    }
+
+    SECTION("Small buffers are allocated from the regular heap"){
+        std::size_t bytesBefore = Core::hugePageAllocatedBytes(HugePageMode::TRANSPARENT);
+        Core::HugePageAllocator<int, HugePageSubsystem::PARTICLES> allocator(HugePageMode::TRANSPARENT);
+        Core::hugePageVector<int, HugePageSubsystem::PARTICLES> vec(1000, 1, allocator);
+        CHECK(std::accumulate(vec.begin(), vec.end(), 0) == 1000);
+        CHECK(Core::hugePageAllocatedBytes(HugePageMode::TRANSPARENT) == bytesBefore);
+    }
+}
@@ -0,0 +1,77 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_memoryAccounting.cpp
+
+ Testing of the memory accounting of simulation subsystems
+
+ ****************************/
+
+#include "Core_memoryAccounting.hpp"
+#include "Core_particle.hpp"
+#include "catch.hpp"
+#include <vector>
+
+TEST_CASE( "Test memory accounting", "[Core][memory]") {
+
+    SECTION("Memory reports sum up the subsystem sizes"){
+        Core::MemoryReport report;
+        CHECK(report.totalBytes() == 0);
+
+        report.add("particles", 1000);
+        report.add("tree", 500);
+        report.add("particles", 24);
+        CHECK(report.numberOfSubsystems() == 2);
+        CHECK(report.bytes("particles") == 1024);
+        CHECK(report.bytes("tree") == 500);
+        CHECK(report.bytes("writer") == 0);
+        CHECK(report.totalBytes() == 1524);
+
+        std::vector<std::string> lines = report.toLines();
+        REQUIRE(lines.size() == 3);
+        CHECK(lines[0].find("particles") == 0);
+        CHECK(lines[0].find("1.00 KiB") != std::string::npos);
+        CHECK(lines[2].find("total") == 0);
+    }
+
+    SECTION("Memory sizes are formatted with binary unit prefixes"){
+        CHECK(Core::formatBytes(12) == "12 B");
+        CHECK(Core::formatBytes(1536) == "1.50 KiB");
+        CHECK(Core::formatBytes(3*1024*1024) == "3.00 MiB");
+    }
+
+    SECTION("Particle memory usage includes the additional attributes"){
+        Core::Particle particle(Core::Vector(0.0, 0.0, 0.0), 1.0);
+        std::size_t bareSize = particle.memoryUsageBytes();
+        CHECK(bareSize >= sizeof(Core::Particle));
+
+        particle.setFloatAttribute("an attribute with a long name, which is allocated on the heap", 1.0);
+        particle.setIntegerAttribute("index", 1);
+        CHECK(particle.memoryUsageBytes() > bareSize + 64);
+    }
+
+    SECTION("Resident memory of the process is determined"){
+        std::vector<double> data(1000000, 1.0);
+        CHECK(data[999999] > 0.0);
+        CHECK(Core::peakResidentMemoryBytes() >= data.size()*sizeof(double));
+        CHECK(Core::currentResidentMemoryBytes() > 0);
+    }
+}
@@ -0,0 +1,90 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_tracing.cpp
+
+ Testing of the per thread timeline tracing
+
+ ****************************/
+
+#include "Core_tracing.hpp"
+#include "catch.hpp"
+#include <omp.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+TEST_CASE( "Test timeline tracing", "[Core][tracing]") {
+
+    Core::Tracing::clear();
+
+    SECTION("No events are recorded if tracing is disabled"){
+        Core::Tracing::setEnabled(false);
+        {
+            Core::Tracing::Scope scope("disabled scope", "test");
+        }
+        CHECK(Core::Tracing::numberOfEvents() == 0);
+    }
+
+    SECTION("Events of parallel threads are recorded in per thread buffers"){
+        Core::Tracing::setEnabled(true);
+        int nThreads = 4;
+        int nEventsPerThread = 50;
+
+        #pragma omp parallel num_threads(nThreads) default(none) shared(nEventsPerThread)
+        {
+            for (int i=0; i<nEventsPerThread; ++i){
+                Core::Tracing::Scope scope("work item", "test");
+            }
+        }
+        {
+            Core::Tracing::Scope outer("outer \"quoted\" scope", "test");
+            Core::Tracing::Scope inner("inner scope", "test");
+        }
+        Core::Tracing::setEnabled(false);
+
+        CHECK(Core::Tracing::numberOfEvents() == static_cast<std::size_t>(nThreads*nEventsPerThread + 2));
+        CHECK(Core::Tracing::numberOfThreads() >= static_cast<std::size_t>(omp_get_max_threads() > 1 ? 2 : 1));
+
+        std::string traceFilename = "test_trace.json";
+        Core::Tracing::writeChromeTrace(traceFilename);
+
+        std::ifstream traceFile(traceFilename);
+        std::stringstream buffer;
+        buffer << traceFile.rdbuf();
+        std::string trace = buffer.str();
+
+        CHECK(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+        CHECK(trace.find("\"name\":\"thread_name\",\"ph\":\"M\"") != std::string::npos);
+        CHECK(trace.find("\"name\":\"work item\",\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos);
+        CHECK(trace.find(R"("name":"outer \"quoted\" scope")") != std::string::npos);
+
+        std::size_t nCompleteEvents = 0;
+        for (std::size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+                pos = trace.find("\"ph\":\"X\"", pos+1)){
+            ++nCompleteEvents;
+        }
+        CHECK(nCompleteEvents == static_cast<std::size_t>(nThreads*nEventsPerThread + 2));
+
+        Core::Tracing::clear();
+        CHECK(Core::Tracing::numberOfEvents() == 0);
+    }
+}
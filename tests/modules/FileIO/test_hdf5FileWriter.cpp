@@ -26,6 +26,7 @@
  ****************************/
 
 #include "FileIO_trajectoryHDF5Writer.hpp"
+#include "FileIO_trajectoryHDF5Reader.hpp"
 #include "PSim_particleStartSplatTracker.hpp"
 #include "Core_vector.hpp"
 #include "Core_particle.hpp"
@@ -37,6 +38,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cmath>
+#include <filesystem>
 
 
 
@@ -412,4 +415,148 @@ TEST_CASE( "Test HDF5 trajectory file writer", "[ParticleSimulation][file writer
         REQUIRE(Approx(attribParticleMasses[0]) == 125.5);
         REQUIRE(Approx(attribParticleMasses[1]) == 128.8);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Quantized hdf5 trajectories are decoded with bounded error", "[ParticleSimulation][file writers]") {
+
+    std::string filenameQuantized = "test_trajectory_quantized.hd5";
+    std::string filenamePlain = "test_trajectory_unquantized.hd5";
+    double positionError = 1e-6;
+    double attributeError = 1e-3;
+    hsize_t keyFrameInterval = 10;
+    std::size_t nParticles = 500;
+    std::size_t nFrames = 45;
+
+    FileIO::partAttribTransformFctType pAttribTransformFct =
+            [](Core::Particle *particle) -> std::vector<double>{
+                std::vector<double> result = {
+                        particle->getVelocity().x(),
+                        particle->getVelocity().y(),
+                        particle->getVelocity().z()
+                };
+                return result;
+            };
+    std::vector<std::string> pAttribNames = {"velocity x", "velocity y", "velocity z"};
+
+    auto particleLocation = [](std::size_t i, std::size_t k) -> Core::Vector {
+        double i_d = static_cast<double>(i);
+        double t = static_cast<double>(k) * 1e-2;
+        return {1e-3 * std::sin(i_d + 3.0*t), 2e-3 * std::cos(0.5*i_d + 2.0*t), 1e-4 * i_d * t};
+    };
+    auto particleVelocity = [](std::size_t i, std::size_t k) -> Core::Vector {
+        double i_d = static_cast<double>(i);
+        double t = static_cast<double>(k) * 1e-2;
+        return {30.0 * std::cos(i_d + 3.0*t), -40.0 * std::sin(0.5*i_d + 2.0*t), 1e-2 * i_d};
+    };
+
+    // the particle number changes at frame 23, which forces a key frame, frame 30 is empty:
+    auto nParticlesInFrame = [nParticles](std::size_t k) -> std::size_t {
+        if (k == 30){
+            return 0;
+        }
+        return k < 23 ? nParticles : nParticles - 100;
+    };
+
+    {
+        FileIO::TrajectoryHDF5Writer writerQuantized(filenameQuantized);
+        writerQuantized.setParticleAttributes(pAttribNames, pAttribTransformFct);
+        writerQuantized.setQuantization(positionError, attributeError, keyFrameInterval);
+
+        FileIO::TrajectoryHDF5Writer writerPlain(filenamePlain);
+        writerPlain.setParticleAttributes(pAttribNames, pAttribTransformFct);
+
+        std::vector<Core::uniquePartPtr> particles;
+        for (std::size_t i=0; i<nParticles; ++i){
+            particles.emplace_back(std::make_unique<Core::Particle>());
+        }
+
+        for (std::size_t k=0; k<nFrames; ++k){
+            std::vector<Core::Particle*> particlePtrs;
+            for (std::size_t i=0; i<nParticlesInFrame(k); ++i){
+                particles[i]->setLocation(particleLocation(i, k));
+                particles[i]->setVelocity(particleVelocity(i, k));
+                particlePtrs.emplace_back(particles[i].get());
+            }
+            writerQuantized.writeTimestep(particlePtrs, static_cast<double>(k));
+            writerPlain.writeTimestep(particlePtrs, static_cast<double>(k));
+        }
+
+        // the quantization can not be changed after time steps were written:
+        CHECK_THROWS_AS(writerQuantized.setQuantization(1e-3), std::logic_error);
+
+        writerQuantized.finalizeTrajectory();
+        writerPlain.finalizeTrajectory();
+    }
+
+    SECTION("Illegal quantization parameters are rejected"){
+        FileIO::TrajectoryHDF5Writer writer("test_trajectory_illegal_quantization.hd5");
+        CHECK_THROWS_AS(writer.setQuantization(0.0), std::invalid_argument);
+        CHECK_THROWS_AS(writer.setQuantization(1e-6, 0.0, 0), std::invalid_argument);
+    }
+
+    SECTION("Quantized trajectory is smaller than the unquantized trajectory"){
+        CHECK(std::filesystem::file_size(filenameQuantized) < std::filesystem::file_size(filenamePlain));
+    }
+
+    SECTION("Key frames are written periodically and if the number of particles changes"){
+        FileIO::HDF5Reader reader(filenameQuantized);
+        std::vector<std::size_t> keyFrames;
+        for (std::size_t k=0; k<nFrames; ++k){
+            std::string groupName = "/particle_trajectory/timesteps/" + std::to_string(k);
+            if (k == 30){
+                CHECK(!reader.hasAttribute(groupName, "key frame"));
+            }
+            else if (reader.readAttributeVector<int>(groupName, "key frame")[0] == 1){
+                keyFrames.push_back(k);
+            }
+        }
+        CHECK(keyFrames == std::vector<std::size_t>({0, 10, 20, 23, 31, 41}));
+    }
+
+    SECTION("Quantized trajectory is decoded with bounded error in sequential and random order"){
+        FileIO::TrajectoryHDF5Reader reader(filenameQuantized);
+        CHECK(reader.isQuantized());
+        CHECK(reader.numberOfTimesteps() == nFrames);
+        CHECK(reader.positionQuantizationStep() == Approx(2.0*positionError));
+
+        auto checkFrame = [&](std::size_t k){
+            auto positions = reader.positions(k);
+            auto attributes = reader.particleAttributesFloat(k);
+            REQUIRE(positions.dims[0] == nParticlesInFrame(k));
+            REQUIRE(positions.dims[1] == 3);
+            REQUIRE(attributes.dims[0] == nParticlesInFrame(k));
+            REQUIRE(attributes.dims[1] == 3);
+
+            double maxPositionError = 0.0;
+            double maxAttributeError = 0.0;
+            for (hsize_t i=0; i<positions.dims[0]; ++i){
+                Core::Vector locVec = particleLocation(i, k);
+                Core::Vector velVec = particleVelocity(i, k);
+                std::array<double, 3> loc = {locVec.x(), locVec.y(), locVec.z()};
+                std::array<double, 3> vel = {velVec.x(), velVec.y(), velVec.z()};
+                for (hsize_t j=0; j<3; ++j){
+                    maxPositionError = std::max(maxPositionError, std::fabs(positions.get({i, j}) - loc[j]));
+                    maxAttributeError = std::max(maxAttributeError, std::fabs(attributes.get({i, j}) - vel[j]));
+                }
+            }
+            CHECK(maxPositionError <= positionError * (1.0 + 1e-9));
+            CHECK(maxAttributeError <= attributeError * (1.0 + 1e-9));
+        };
+
+        for (std::size_t k=0; k<nFrames; ++k){
+            checkFrame(k);
+        }
+        for (std::size_t k : std::vector<std::size_t>({37, 5, 44, 19, 30, 31, 9})){
+            checkFrame(k);
+        }
+    }
+
+    SECTION("Unquantized trajectory is read by the trajectory reader"){
+        FileIO::TrajectoryHDF5Reader reader(filenamePlain);
+        CHECK(!reader.isQuantized());
+        auto positions = reader.positions(12);
+        REQUIRE(positions.dims[0] == nParticles);
+        CHECK(positions.get({7, 1}) == Approx(particleLocation(7, 12).y()));
+        CHECK(reader.positions(30).dims[0] == 0);
+    }
+}
@@ -0,0 +1,120 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_sharedMemoryFrames.cpp
+
+ Testing of the shared memory ring buffer for live simulation frames
+
+ ****************************/
+
+#include "Core_particle.hpp"
+#include "FileIO_sharedMemoryFrameWriter.hpp"
+#include "FileIO_sharedMemoryFrameReader.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+
+TEST_CASE( "Shared memory frame buffer should publish frames to readers", "[FileIO][SharedMemoryFrames][file writers]") {
+
+    std::vector<Core::uniquePartPtr> particles;
+    std::vector<Core::Particle*> particlePtrs;
+    for (std::size_t i=0; i<10; ++i){
+        auto particle = std::make_unique<Core::Particle>(Core::Vector(static_cast<double>(i), 2.0, 3.0), 1.0);
+        particlePtrs.push_back(particle.get());
+        particles.push_back(std::move(particle));
+    }
+    std::string shmName = "/idsimf_test_frames";
+
+    SECTION("Illegal buffer definitions should throw"){
+        CHECK_THROWS_AS(FileIO::SharedMemoryFrameWriter("no_slash", 10), std::invalid_argument);
+        CHECK_THROWS_AS(FileIO::SharedMemoryFrameWriter(shmName, 0), std::invalid_argument);
+        CHECK_THROWS_AS(FileIO::SharedMemoryFrameReader("/idsimf_test_not_existing"), std::runtime_error);
+    }
+
+    SECTION("Frames with particle positions and attributes should be readable"){
+        FileIO::SharedMemoryFrameWriter writer(shmName, 8, 4);
+        CHECK(writer.memoryUsageBytes() ==
+              FileIO::SharedMemoryFrames::slotOffset() + 4*FileIO::SharedMemoryFrames::slotStride(8, 3));
+        writer.setParticleAttributes({"charge"},
+                [](Core::Particle* particle) -> std::vector<double>{ return {particle->getCharge()}; });
+        // the segment is sized for the positions and the attribute:
+        CHECK(writer.memoryUsageBytes() ==
+              FileIO::SharedMemoryFrames::slotOffset() + 4*FileIO::SharedMemoryFrames::slotStride(8, 4));
+
+        FileIO::SharedMemoryFrameReader reader(shmName);
+        FileIO::SharedMemoryFrame frame;
+        CHECK_FALSE(reader.readLatestFrame(frame));
+        CHECK(reader.isWriterActive());
+        CHECK(reader.numberOfSlots() == 4);
+        CHECK(reader.fieldNames() == std::vector<std::string>{"x", "y", "z", "charge"});
+
+        writer.writeTimestep(particlePtrs, 0.5);
+        CHECK(writer.framesWritten() == 1);
+        REQUIRE(reader.readLatestFrame(frame));
+        CHECK(frame.frameIndex == 0);
+        CHECK(frame.time == Approx(0.5));
+        // the buffer is limited to 8 particles:
+        CHECK(frame.nParticles == 8);
+        CHECK(frame.nFields == 4);
+        CHECK(frame.value(7, 0) == Approx(7.0));
+        CHECK(frame.value(7, 1) == Approx(2.0));
+        CHECK(frame.value(7, 2) == Approx(3.0));
+        CHECK(frame.value(7, 3) == Approx(particlePtrs[7]->getCharge()));
+
+        CHECK_THROWS_AS(writer.setParticleAttributes({"a"},
+                [](Core::Particle*) -> std::vector<double>{ return {0.0}; }), std::logic_error);
+    }
+
+    SECTION("Overwritten frames in the ring buffer should be rejected"){
+        FileIO::SharedMemoryFrameWriter writer(shmName, 10, 3);
+        FileIO::SharedMemoryFrameReader reader(shmName);
+
+        for (int i=0; i<5; ++i){
+            particlePtrs[0]->setLocation(Core::Vector(static_cast<double>(i), 0.0, 0.0));
+            writer.writeTimestep(particlePtrs, i*0.1);
+        }
+        CHECK(reader.framesWritten() == 5);
+
+        FileIO::SharedMemoryFrame frame;
+        CHECK_FALSE(reader.readFrame(0, frame));
+        CHECK_FALSE(reader.readFrame(1, frame));
+        CHECK_FALSE(reader.readFrame(5, frame));
+        REQUIRE(reader.readFrame(2, frame));
+        CHECK(frame.value(0, 0) == Approx(2.0));
+        REQUIRE(reader.readLatestFrame(frame));
+        CHECK(frame.frameIndex == 4);
+        CHECK(frame.value(0, 0) == Approx(4.0));
+        CHECK(frame.value(9, 0) == Approx(9.0));
+    }
+
+    SECTION("Readers should stay attached after the writer was closed"){
+        auto writer = std::make_unique<FileIO::SharedMemoryFrameWriter>(shmName, 10);
+        writer->writeTimestep(particlePtrs, 1.0);
+        FileIO::SharedMemoryFrameReader reader(shmName);
+        writer.reset();
+
+        CHECK_FALSE(reader.isWriterActive());
+        FileIO::SharedMemoryFrame frame;
+        CHECK(reader.readLatestFrame(frame));
+        CHECK_THROWS_AS(FileIO::SharedMemoryFrameReader(shmName), std::runtime_error);
+    }
+}
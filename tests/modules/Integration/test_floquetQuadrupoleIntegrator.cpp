@@ -0,0 +1,180 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_floquetQuadrupoleIntegrator.cpp
+
+ Testing of the Mathieu transfer maps and the Floquet quadrupole propagation
+
+ ****************************/
+
+#include "Integration_floquetQuadrupoleIntegrator.hpp"
+#include "Integration_mathieuTransferMap.hpp"
+#include "Integration_parallelRK4Integrator.hpp"
+#include "SC_generic.hpp"
+#include "Core_vector.hpp"
+#include "Core_particle.hpp"
+#include "catch.hpp"
+#include <cmath>
+
+TEST_CASE( "Test Mathieu transfer map", "[ParticleSimulation][FloquetQuadrupoleIntegrator][trajectory integration]") {
+
+    double omega = 2.0*M_PI*1e6;
+
+    SECTION("Transfer map without RF is the harmonic oscillator solution"){
+        double omegaHarmonic = 0.3*omega;
+        Integration::MathieuTransferMap map(omegaHarmonic*omegaHarmonic, 0.0, omega);
+        double phase = omegaHarmonic*map.period();
+        const Integration::MathieuTransferMap::matrix_t& M = map.matrix();
+        CHECK(M[0] == Approx(std::cos(phase)).margin(1e-9));
+        CHECK(M[1]*omegaHarmonic == Approx(std::sin(phase)).margin(1e-9));
+        CHECK(M[2]/omegaHarmonic == Approx(-std::sin(phase)).margin(1e-9));
+        CHECK(M[3] == Approx(std::cos(phase)).margin(1e-9));
+        CHECK(map.stabilityParameterBeta() == Approx(0.6));
+
+        Integration::MathieuTransferMap::matrix_t M3 = map.matrixPower(3);
+        CHECK(M3[0] == Approx(std::cos(3*phase)).margin(1e-8));
+        CHECK(M3[1]*omegaHarmonic == Approx(std::sin(3*phase)).margin(1e-8));
+    }
+
+    SECTION("Stability and secular frequency in the Mathieu stability diagram"){
+        double q = 0.1;
+        Integration::MathieuTransferMap mapLowQ(0.0, -q*omega*omega/2.0, omega);
+        CHECK(mapLowQ.mathieuQ() == Approx(q));
+        CHECK(mapLowQ.mathieuA() == Approx(0.0).margin(1e-15));
+        CHECK(mapLowQ.isStable());
+        // adiabatic approximation for small q:
+        CHECK(mapLowQ.stabilityParameterBeta() == Approx(q/std::sqrt(2.0)).epsilon(0.005));
+        CHECK(mapLowQ.secularFrequency() == Approx(q/std::sqrt(2.0) * 0.5e6).epsilon(0.005));
+
+        // the stability limit on the q axis is at q = 0.908:
+        CHECK(Integration::MathieuTransferMap(0.0, -0.9*omega*omega/2.0, omega).isStable());
+        CHECK_FALSE(Integration::MathieuTransferMap(0.0, -0.92*omega*omega/2.0, omega).isStable());
+
+        // the transfer matrix is symplectic (unit determinant):
+        const Integration::MathieuTransferMap::matrix_t& M = mapLowQ.matrix();
+        CHECK(M[0]*M[3] - M[1]*M[2] == Approx(1.0).epsilon(1e-10));
+    }
+
+    SECTION("Driven response of a free particle to a constant acceleration"){
+        Integration::MathieuTransferMap map(0.0, 0.0, omega, 64);
+        double acceleration = 1e5;
+        std::vector<double> driveSamples(map.numberOfDriveSamples(), acceleration);
+        Integration::MathieuTransferMap::state_t response = map.drivenResponse(driveSamples);
+        double T = map.period();
+        CHECK(response[0] == Approx(0.5*acceleration*T*T));
+        CHECK(response[1] == Approx(acceleration*T));
+        CHECK(map.driveSampleTime(map.numberOfDriveSamples()-1) == Approx(T));
+
+        CHECK_THROWS(map.drivenResponse(std::vector<double>(3, 0.0)));
+        CHECK_THROWS(Integration::MathieuTransferMap(0.0, 0.0, -1.0));
+    }
+}
+
+TEST_CASE( "Test Floquet quadrupole integrator", "[ParticleSimulation][FloquetQuadrupoleIntegrator][trajectory integration]") {
+
+    // ideal quadrupole ion trap:
+    double r_0 = 0.01;
+    Core::Vector fieldGradients(1.0/(r_0*r_0), 1.0/(r_0*r_0), -2.0/(r_0*r_0));
+    double fRf = 1e6;
+    double omega = 2.0*M_PI*fRf;
+    double V_rf = 500.0;
+    double T = 1.0/fRf;
+    double z_0 = 0.007;
+    double excitationVoltage = 1.0;
+    double excitationFrequency = 1.1e5;
+    auto excitationFieldFct = [excitationVoltage, z_0, excitationFrequency](double time){
+        return Core::Vector(0.0, 0.0, excitationVoltage/z_0 * std::sin(2.0*M_PI*excitationFrequency*time));
+    };
+
+    Core::Vector startPosition(1e-4, -2e-4, 3e-4);
+    Core::Vector startVelocity(10.0, 0.0, -20.0);
+
+    SECTION("Floquet propagation reproduces a full trajectory integration"){
+        // reference: RK4 integration with a fine time step
+        auto accelerationFct = [&fieldGradients, V_rf, omega, &excitationFieldFct](
+                Core::Particle* particle, Core::Vector position, Core::Vector /*velocity*/,
+                double time, unsigned int /*timestep*/){
+            double U = V_rf*std::cos(omega*time);
+            Core::Vector field(-U*fieldGradients.x()*position.x(),
+                               -U*fieldGradients.y()*position.y(),
+                               -U*fieldGradients.z()*position.z());
+            return (field + excitationFieldFct(time)) * (particle->getCharge()/particle->getMass());
+        };
+        auto spaceChargeAccelerationFct = [](Core::Particle* /*particle*/, int /*particleIndex*/,
+                SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 0.0, 0.0);
+        };
+
+        Core::Particle referenceParticle(startPosition, startVelocity, 1.0, 100.0);
+        std::vector<Core::Particle*> referenceParticles = {&referenceParticle};
+        Integration::ParallelRK4Integrator rk4Integrator(referenceParticles, accelerationFct, spaceChargeAccelerationFct);
+        unsigned int stepsPerPeriod = 400;
+        unsigned int nPeriods = 20;
+        rk4Integrator.run(stepsPerPeriod*nPeriods, T/stepsPerPeriod);
+
+        Core::Particle particle(startPosition, startVelocity, 1.0, 100.0);
+        Core::Particle particleHeavy(startPosition, startVelocity, 1.0, 200.0);
+        std::vector<Core::Particle*> particles = {&particle, &particleHeavy};
+        unsigned int nWrites = 0;
+        auto postTimestepFct = [&nWrites](Integration::AbstractTimeIntegrator* /*integrator*/,
+                std::vector<Core::Particle*>& /*particles*/, double /*time*/, int /*timestep*/, bool /*lastTimestep*/){
+            ++nWrites;
+        };
+        Integration::FloquetQuadrupoleIntegrator floquetIntegrator(
+                particles, fieldGradients, fRf, [V_rf](double /*time*/){return V_rf;}, 0.0,
+                excitationFieldFct, postTimestepFct);
+        floquetIntegrator.run(nPeriods/2, 2*T);
+
+        CHECK(floquetIntegrator.numberOfSpecies() == 2);
+        CHECK(floquetIntegrator.transferMap(particle, 2).mathieuQ() == Approx(0.49).epsilon(0.01));
+        CHECK(floquetIntegrator.time() == Approx(nPeriods*T));
+        CHECK(nWrites == nPeriods/2 + 2);
+
+        Core::Vector difference = particle.getLocation() - referenceParticle.getLocation();
+        CHECK(difference.magnitude() < 1e-6*referenceParticle.getLocation().magnitude());
+        Core::Vector velocityDifference = particle.getVelocity() - referenceParticle.getVelocity();
+        CHECK(velocityDifference.magnitude() < 1e-6*referenceParticle.getVelocity().magnitude());
+    }
+
+    SECTION("Floquet integrator terminates ions with other actions and checks the time step"){
+        double maxRadius = 1e-3;
+        auto otherActionsFct = [maxRadius](Core::Vector& newPartPos, Core::Particle* particle,
+                std::size_t /*particleIndex*/, double time, unsigned int /*timestep*/){
+            if (newPartPos.magnitude() > maxRadius){
+                particle->setActive(false);
+                particle->setSplatTime(time);
+            }
+        };
+
+        // light ion is unstable (q > 0.908):
+        Core::Particle particle(startPosition, startVelocity, 1.0, 20.0);
+        std::vector<Core::Particle*> particles = {&particle};
+        Integration::FloquetQuadrupoleIntegrator floquetIntegrator(
+                particles, fieldGradients, fRf, [V_rf](double /*time*/){return V_rf;}, 0.0,
+                nullptr, nullptr, otherActionsFct);
+
+        CHECK_THROWS(floquetIntegrator.run(10, 1.5*T));
+        floquetIntegrator.run(100, T);
+        CHECK_FALSE(floquetIntegrator.transferMap(particle, 2).isStable());
+        CHECK_FALSE(particle.isActive());
+        CHECK(particle.getSplatTime() < 100*T);
+    }
+}
@@ -42,6 +42,8 @@
 #include "Core_vector.hpp"
 #include "Core_particle.hpp"
 #include "catch.hpp"
+#include <cmath>
+#include <algorithm>
 
 template<class solverType>
         void runTestSimulation(std::vector<Core::uniquePartPtr> &particles,
@@ -165,3 +167,98 @@ TEST_CASE( "Test fmm verlet integrator", "[Integration][FMMVerletIntegrator][tra
 #endif
     }
 }
+
+#ifdef WITH_EXAFMMT
+TEST_CASE( "Test exafmm-t solver state reuse across time steps", "[SpaceCharge][ExaFMMt]") {
+
+    std::size_t nParticles = 500;
+    std::vector<Core::uniquePartPtr> particles;
+    for (std::size_t i = 0; i<nParticles; ++i) {
+        double iD = static_cast<double>(i);
+        particles.push_back(std::make_unique<Core::Particle>(
+                Core::Vector(std::sin(iD*0.7)*1e-3, std::cos(iD*1.3)*1e-3, std::sin(iD*2.1)*1e-3), 1.0));
+    }
+
+    ExaFMMt::FMMSolver reusingSolver;
+    ExaFMMt::FMMSolver rebuildingSolver;
+    reusingSolver.setMaxBodiesPerLeaf(50);
+    rebuildingSolver.setMaxBodiesPerLeaf(50);
+    reusingSolver.setTreeRebuildThreshold(0.05);
+    for (std::size_t i = 0; i<nParticles; ++i) {
+        reusingSolver.insertParticle(*particles[i], i);
+        rebuildingSolver.insertParticle(*particles[i], i);
+    }
+
+    SECTION("Small particle movements should reuse the tree and give the results of a rebuilt tree") {
+        for (int step = 0; step<3; ++step) {
+            reusingSolver.computeChargeDistribution();
+            rebuildingSolver.computeChargeDistribution();
+            double maxField = 0.0;
+            for (const auto& particle: particles) {
+                maxField = std::max(maxField, rebuildingSolver.getEFieldFromSpaceCharge(*particle).magnitude());
+            }
+            for (const auto& particle: particles) {
+                Core::Vector fieldReused = reusingSolver.getEFieldFromSpaceCharge(*particle);
+                Core::Vector fieldRebuilt = rebuildingSolver.getEFieldFromSpaceCharge(*particle);
+                CHECK((fieldReused - fieldRebuilt).magnitude() < 1e-4 * maxField);
+            }
+            for (const auto& particle: particles) {
+                particle->setLocation(particle->getLocation() + Core::Vector(1e-8, 0.0, -1e-8));
+            }
+        }
+        CHECK(reusingSolver.getNumberOfTreeBuilds() == 1);
+        CHECK(rebuildingSolver.getNumberOfTreeBuilds() == 3);
+    }
+
+    SECTION("Reused trees should give the results of a per step rebuild up to the rebuild threshold") {
+        // the particles drift towards the rebuild threshold (and possibly out of their leaf boxes) until the tree
+        // is rebuilt, the field of the reused tree has to match the field of a tree rebuilt in every step:
+        for (int step = 0; step<10; ++step) {
+            reusingSolver.computeChargeDistribution();
+            rebuildingSolver.computeChargeDistribution();
+            double maxField = 0.0;
+            for (const auto& particle: particles) {
+                maxField = std::max(maxField, rebuildingSolver.getEFieldFromSpaceCharge(*particle).magnitude());
+            }
+            double maxDeviation = 0.0;
+            for (const auto& particle: particles) {
+                Core::Vector fieldReused = reusingSolver.getEFieldFromSpaceCharge(*particle);
+                Core::Vector fieldRebuilt = rebuildingSolver.getEFieldFromSpaceCharge(*particle);
+                maxDeviation = std::max(maxDeviation, (fieldReused - fieldRebuilt).magnitude());
+            }
+            CHECK(maxDeviation < 1e-3 * maxField);
+            for (std::size_t i = 0; i<nParticles; ++i) {
+                double iD = static_cast<double>(i);
+                particles[i]->setLocation(particles[i]->getLocation() +
+                        Core::Vector(std::cos(iD), std::sin(iD), std::cos(3.0*iD))*2e-6);
+            }
+        }
+        CHECK(rebuildingSolver.getNumberOfTreeBuilds() == 10);
+    }
+
+    SECTION("Trees should be rebuilt in every step by default") {
+        ExaFMMt::FMMSolver defaultSolver;
+        for (std::size_t i = 0; i<nParticles; ++i) {
+            defaultSolver.insertParticle(*particles[i], i);
+        }
+        defaultSolver.computeChargeDistribution();
+        defaultSolver.computeChargeDistribution();
+        CHECK(defaultSolver.getNumberOfTreeBuilds() == 2);
+    }
+
+    SECTION("Large particle movements and removed particles should trigger a tree rebuild") {
+        reusingSolver.computeChargeDistribution();
+        particles[0]->setLocation(Core::Vector(2e-3, 2e-3, 2e-3));
+        reusingSolver.computeChargeDistribution();
+        CHECK(reusingSolver.getNumberOfTreeBuilds() == 2);
+
+        reusingSolver.removeParticle(1);
+        reusingSolver.computeChargeDistribution();
+        CHECK(reusingSolver.getNumberOfTreeBuilds() == 3);
+    }
+
+    SECTION("Negative tree rebuild thresholds should throw") {
+        CHECK_THROWS_AS(reusingSolver.setTreeRebuildThreshold(-0.1), std::invalid_argument);
+    }
+}
+#endif
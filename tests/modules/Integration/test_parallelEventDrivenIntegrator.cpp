@@ -0,0 +1,180 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_parallelEventDrivenIntegrator.cpp
+
+ Testing of the parallel event driven (collision to collision) trajectory integrator
+
+ ****************************/
+
+#include "Integration_parallelEventDrivenIntegrator.hpp"
+#include "Integration_parallelVerletIntegrator.hpp"
+#include "Integration_parallelExponentialIntegrator.hpp"
+#include "CollisionModel_HardSphere.hpp"
+#include "CollisionModel_StatisticalDiffusion.hpp"
+#include "Core_vector.hpp"
+#include "Core_particle.hpp"
+#include "Core_randomGenerators.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    /**
+     * Mean z position of a particle ensemble
+     */
+    double meanPositionZ(const std::vector<std::unique_ptr<Core::Particle>>& particles){
+        double sum = 0.0;
+        for (const auto& particle: particles){
+            sum += particle->getLocation().z();
+        }
+        return sum / static_cast<double>(particles.size());
+    }
+}
+
+TEST_CASE( "Test parallel event driven integrator", "[ParticleSimulation][ParallelEventDrivenIntegrator][trajectory integration]") {
+    Core::globalRandomGeneratorPool = std::make_unique<Core::RandomGeneratorPool>();
+
+    double fieldAcceleration = 1e10;
+    auto accelerationFct = [fieldAcceleration](Core::Particle* /*particle*/, std::size_t /*particleIndex*/,
+                                               SpaceCharge::FieldCalculator& /*tree*/, double /*time*/,
+                                               unsigned int /*timestep*/){
+        return Core::Vector(0.0, 0.0, fieldAcceleration);
+    };
+    auto uniformRegionFct = [](Core::Particle* /*particle*/, double /*time*/){
+        return true;
+    };
+
+    SECTION( "Event driven integrator should require a collision model with collision events") {
+        CollisionModel::StatisticalDiffusionModel sds(100000, 298, 28, 0.366 * 1.0e-9);
+        CHECK_THROWS_AS(Integration::ParallelEventDrivenIntegrator(accelerationFct, uniformRegionFct, nullptr),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(Integration::ParallelEventDrivenIntegrator(accelerationFct, uniformRegionFct, &sds),
+                        std::invalid_argument);
+    }
+
+    SECTION( "Event driven integrator without background gas should integrate constant acceleration exactly") {
+        CollisionModel::HardSphereModel hsVacuum(0.0, 298, 4.0, CollisionModel::HardSphereModel::DIAMETER_HE);
+        Core::Particle particle(Core::Vector(0.0, 0.0, 0.0), Core::Vector(100.0, 0.0, 0.0), 1.0, 100.0);
+        std::vector<Core::Particle*> particles = {&particle};
+        Integration::ParallelEventDrivenIntegrator integrator(
+                particles, accelerationFct, uniformRegionFct, &hsVacuum);
+        integrator.run(10, 1e-7);
+
+        double time = 1e-6;
+        CHECK(Approx(particle.getLocation().x()).epsilon(1e-10) == 100.0*time);
+        CHECK(Approx(particle.getLocation().z()).epsilon(1e-10) == 0.5*fieldAcceleration*time*time);
+        CHECK(Approx(particle.getVelocity().z()).epsilon(1e-10) == fieldAcceleration*time);
+    }
+
+    SECTION( "Event driven integrator should reproduce the drift of fixed step integration") {
+        // ion in helium at 2000 Pa, the mean time between collisions is in the order of 5 ns:
+        double pressure_Pa = 2000.0;
+        double ionMass_amu = 37.0;
+        double ionDiameter_m = 4e-10;
+        unsigned int nParticles = 400;
+        double tEnd = 1e-6;
+
+        auto createParticles = [=](){
+            std::vector<std::unique_ptr<Core::Particle>> particles;
+            for (unsigned int i=0; i<nParticles; ++i){
+                particles.emplace_back(std::make_unique<Core::Particle>(
+                        Core::Vector(i*1e-6, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, ionMass_amu));
+                particles.back()->setDiameter(ionDiameter_m);
+            }
+            return particles;
+        };
+        auto particlePointers = [](const std::vector<std::unique_ptr<Core::Particle>>& particles){
+            std::vector<Core::Particle*> result;
+            for (const auto& particle: particles){
+                result.push_back(particle.get());
+            }
+            return result;
+        };
+
+        // reference: fixed step integration with a collision probability of about 2 % per time step:
+        CollisionModel::HardSphereModel hsFixedStep(pressure_Pa, 298, 4.003, 2.8e-10);
+        std::vector<std::unique_ptr<Core::Particle>> particlesFixedStep = createParticles();
+        Integration::ParallelVerletIntegrator fixedStepIntegrator(
+                particlePointers(particlesFixedStep), accelerationFct, nullptr, nullptr, nullptr, &hsFixedStep);
+        fixedStepIntegrator.run(10000, tEnd/10000);
+
+        // the event driven integration with time steps much longer than the time between collisions:
+        CollisionModel::HardSphereModel hsEventDriven(pressure_Pa, 298, 4.003, 2.8e-10);
+        std::vector<std::unique_ptr<Core::Particle>> particlesEventDriven = createParticles();
+        Integration::ParallelEventDrivenIntegrator eventDrivenIntegrator(
+                particlePointers(particlesEventDriven), accelerationFct, uniformRegionFct, &hsEventDriven);
+        eventDrivenIntegrator.run(10, tEnd/10);
+
+        double driftDistanceFixedStep = meanPositionZ(particlesFixedStep);
+        CHECK(driftDistanceFixedStep > 0.0);
+        CHECK(Approx(meanPositionZ(particlesEventDriven)).epsilon(0.07) == driftDistanceFixedStep);
+    }
+
+    SECTION( "Event driven integrator should evaluate the gas state at the current particle location") {
+        // record the locations at which the collision model evaluates the gas pressure:
+        std::vector<double> evaluatedLocationsZ;
+        CollisionModel::HardSphereModel hsLocal(
+                [&evaluatedLocationsZ](Core::Vector& location){
+                    evaluatedLocationsZ.push_back(location.z());
+                    return 2000.0;
+                },
+                [](Core::Vector& /*location*/){return Core::Vector(0.0, 0.0, 0.0);},
+                298, 4.003, 2.8e-10);
+        Core::Particle particle(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 37.0);
+        particle.setDiameter(4e-10);
+        std::vector<Core::Particle*> particles = {&particle};
+        Integration::ParallelEventDrivenIntegrator integrator(particles, accelerationFct, uniformRegionFct, &hsLocal);
+
+        // a single time step with many collisions: the gas state is evaluated along the trajectory of the particle
+        integrator.run(1, 1e-7);
+        REQUIRE_FALSE(evaluatedLocationsZ.empty());
+        CHECK(*std::max_element(evaluatedLocationsZ.begin(), evaluatedLocationsZ.end()) > 0.0);
+        CHECK(particle.getLocation().z() > 0.0);
+    }
+
+    SECTION( "Event driven integrator should use fixed steps outside of uniform field regions") {
+        // the fixed step scheme with constant acceleration in the time step is the scheme of the exponential
+        // integrator without drag, thus both integrators have to produce the same trajectory:
+        Core::globalRandomGeneratorPool = std::make_unique<Core::TestRandomGeneratorPool>();
+        CollisionModel::HardSphereModel hsNonUniform(2000.0, 298, 4.003, 2.8e-10);
+        Core::Particle particleNonUniform(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 37.0);
+        std::vector<Core::Particle*> particlesNonUniform = {&particleNonUniform};
+        Integration::ParallelEventDrivenIntegrator nonUniformIntegrator(
+                particlesNonUniform, accelerationFct,
+                [](Core::Particle* /*particle*/, double /*time*/){return false;}, &hsNonUniform);
+        nonUniformIntegrator.run(500, 1e-10);
+
+        Core::globalRandomGeneratorPool = std::make_unique<Core::TestRandomGeneratorPool>();
+        CollisionModel::HardSphereModel hsReference(2000.0, 298, 4.003, 2.8e-10);
+        Core::Particle particleReference(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 37.0);
+        std::vector<Core::Particle*> particlesReference = {&particleReference};
+        Integration::ParallelExponentialIntegrator referenceIntegrator(
+                particlesReference, accelerationFct, nullptr, nullptr, nullptr, &hsReference);
+        referenceIntegrator.run(500, 1e-10);
+
+        CHECK(particleNonUniform.getVelocity().magnitude() > 0.0);
+        CHECK(Approx(particleNonUniform.getLocation().z()).epsilon(1e-9) == particleReference.getLocation().z());
+        CHECK(Approx(particleNonUniform.getVelocity().x()).epsilon(1e-9) == particleReference.getVelocity().x());
+        CHECK(Approx(particleNonUniform.getVelocity().z()).epsilon(1e-9) == particleReference.getVelocity().z());
+    }
+}
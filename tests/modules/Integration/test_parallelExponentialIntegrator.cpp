@@ -0,0 +1,163 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_parallelExponentialIntegrator.cpp
+
+ Testing of the parallel exponential integrator for strongly damped particle motion
+
+ ****************************/
+
+#include "Integration_parallelExponentialIntegrator.hpp"
+#include "CollisionModel_StatisticalDiffusion.hpp"
+#include "Core_vector.hpp"
+#include "Core_particle.hpp"
+#include "Core_randomGenerators.hpp"
+#include "catch.hpp"
+#include <cmath>
+
+namespace {
+    /**
+     * Simple collision model with a constant linear drag towards a constant gas velocity
+     */
+    class ConstantDragModel: public CollisionModel::AbstractCollisionModel {
+    public:
+        ConstantDragModel(double dampingRate, Core::Vector gasVelocity):
+                dampingRate_(dampingRate), gasVelocity_(gasVelocity) {}
+
+        void updateModelParticleParameters(Core::Particle& /*ion*/) const override {}
+        void initializeModelParticleParameters(Core::Particle& /*ion*/) const override {}
+        void updateModelTimestepParameters(unsigned int /*timestep*/, double /*time*/) override {}
+        void modifyAcceleration(Core::Vector& /*acceleration*/, Core::Particle& /*particle*/, double /*dt*/) override {}
+        void modifyVelocity(Core::Particle& /*particle*/, double /*dt*/) override {}
+        void modifyPosition(Core::Vector& /*position*/, Core::Particle& /*particle*/, double /*dt*/) override {}
+
+        [[nodiscard]] double dragDampingRate(Core::Particle& /*particle*/) const override {
+            return dampingRate_;
+        }
+        [[nodiscard]] Core::Vector dragGasVelocity(Core::Particle& /*particle*/) const override {
+            return gasVelocity_;
+        }
+
+    private:
+        double dampingRate_;
+        Core::Vector gasVelocity_;
+    };
+}
+
+TEST_CASE( "Test phi functions of exponential integrator", "[ParticleSimulation][ParallelExponentialIntegrator]") {
+    for (double z: {1e-8, 1e-4, 9.9e-4, 1.1e-3, 0.1, 1.0, 10.0, 1000.0}){
+        std::array<double, 2> phi = Integration::ParallelExponentialIntegrator::phiFunctions(z);
+        double phi1Ref = -std::expm1(-z) / z;
+        CHECK(Approx(phi[0]).epsilon(1e-12) == phi1Ref);
+        if (z > 1e-2){
+            CHECK(Approx(phi[1]).epsilon(1e-12) == (1.0 - phi1Ref) / z);
+        }
+        else {
+            CHECK(Approx(phi[1]).epsilon(1e-9) == 0.5 - z/6.0 + z*z/24.0);
+        }
+    }
+    std::array<double, 2> phiZero = Integration::ParallelExponentialIntegrator::phiFunctions(0.0);
+    CHECK(Approx(phiZero[0]) == 1.0);
+    CHECK(Approx(phiZero[1]) == 0.5);
+}
+
+TEST_CASE( "Test parallel exponential integrator", "[ParticleSimulation][ParallelExponentialIntegrator][trajectory integration]") {
+    //Set the global random generator to a test random number generator to make the test experiment fully deterministic:
+    Core::globalRandomGeneratorPool = std::make_unique<Core::TestRandomGeneratorPool>();
+
+    double ionAcceleration = 10.0;
+    auto accelerationFct = [ionAcceleration](Core::Particle* /*particle*/, int /*particleIndex*/,
+                                             SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+        return Core::Vector(ionAcceleration, 0, ionAcceleration * 0.5);
+    };
+
+    Core::Particle testParticle(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 100.0);
+
+    SECTION( "Exponential integrator without drag should integrate constant acceleration exactly") {
+        Integration::ParallelExponentialIntegrator integrator(accelerationFct);
+        REQUIRE_NOTHROW(integrator.run(1, 1e-4));
+
+        integrator.addParticle(&testParticle);
+        integrator.run(100, 1e-4);
+
+        double time = 100e-4;
+        CHECK(Approx(testParticle.getLocation().x()).epsilon(1e-10) == 0.5*ionAcceleration*time*time);
+        CHECK(Approx(testParticle.getLocation().z()).epsilon(1e-10) == 0.25*ionAcceleration*time*time);
+        CHECK(Approx(testParticle.getVelocity().x()).epsilon(1e-10) == ionAcceleration*time);
+    }
+
+    SECTION( "Exponential integrator should integrate constant drag exactly, independent of the time step") {
+        double dampingRate = 1e4;
+        Core::Vector gasVelocity(0.0, 2.0, 0.0);
+        ConstantDragModel dragModel(dampingRate, gasVelocity);
+
+        double tEnd = 1e-3;
+        double driftVelocity = ionAcceleration / dampingRate;
+        double relaxedFraction = 1.0 - std::exp(-dampingRate*tEnd);
+        double xRef = driftVelocity*tEnd - driftVelocity/dampingRate * relaxedFraction;
+        double yRef = gasVelocity.y()*tEnd - gasVelocity.y()/dampingRate * relaxedFraction;
+
+        // time steps from well resolved to ten times the velocity relaxation time:
+        for (unsigned int nSteps: {1000u, 100u, 10u}){
+            Core::Particle particle(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 100.0);
+            std::vector<Core::Particle*> particles = {&particle};
+            Integration::ParallelExponentialIntegrator integrator(
+                    particles, accelerationFct, nullptr, nullptr, nullptr, &dragModel);
+            integrator.run(nSteps, tEnd / nSteps);
+
+            CHECK(Approx(particle.getLocation().x()).epsilon(1e-9) == xRef);
+            CHECK(Approx(particle.getLocation().y()).epsilon(1e-9) == yRef);
+            CHECK(Approx(particle.getLocation().z()).epsilon(1e-9) == 0.5*xRef);
+            CHECK(Approx(particle.getVelocity().x()).epsilon(1e-9) == driftVelocity * relaxedFraction);
+            CHECK(Approx(particle.getVelocity().y()).epsilon(1e-9) == gasVelocity.y() * relaxedFraction);
+        }
+    }
+
+    SECTION( "Exponential integrator should be stable with SDS model and time steps much larger than the relaxation time") {
+        CollisionModel::StatisticalDiffusionModel sds(100000, 298, 28, 0.366 * 1.0e-9);
+        double fieldAcceleration = 1e11;
+        auto fieldFct = [fieldAcceleration](Core::Particle* /*particle*/, int /*particleIndex*/,
+                                            SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 0.0, fieldAcceleration);
+        };
+
+        testParticle.setMassAMU(100);
+        testParticle.setDiameter(0.5e-9);
+        testParticle.setMobility(2.0e-4);
+        sds.setSTPParameters(testParticle);
+        sds.updateModelParticleParameters(testParticle);
+        double dampingRate = sds.dragDampingRate(testParticle);
+        double dt = 100.0 / dampingRate;
+
+        std::vector<Core::Particle*> particles = {&testParticle};
+        Integration::ParallelExponentialIntegrator integrator(
+                particles, fieldFct, nullptr, nullptr, nullptr, &sds);
+        integrator.run(1000, dt);
+
+        // velocity is relaxed to the drift velocity, position is bounded by drift + diffusion:
+        CHECK(Approx(testParticle.getVelocity().z()).epsilon(1e-6) == fieldAcceleration / dampingRate);
+        CHECK(std::fabs(testParticle.getVelocity().x()) < 1e-12);
+        double driftDistance = fieldAcceleration / dampingRate * 1000.0 * dt;
+        CHECK(std::isfinite(testParticle.getLocation().x()));
+        CHECK(testParticle.getLocation().z() > 0.5 * driftDistance);
+        CHECK(testParticle.getLocation().z() < 1.5 * driftDistance);
+    }
+}
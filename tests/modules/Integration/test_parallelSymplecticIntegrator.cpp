@@ -0,0 +1,165 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_parallelSymplecticIntegrator.cpp
+
+ Testing of the parallel higher order symplectic trajectory integrator
+
+ ****************************/
+
+#include "Integration_parallelSymplecticIntegrator.hpp"
+#include "SC_generic.hpp"
+#include "Core_vector.hpp"
+#include "Core_particle.hpp"
+#include "catch.hpp"
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+    /**
+     * Integrates a harmonic oscillator over a number of periods and returns the deviation from the exact solution
+     */
+    double harmonicOscillatorError(Integration::ParallelSymplecticIntegrator::Order order,
+                                   unsigned int stepsPerPeriod, unsigned int nPeriods){
+        double omega = 2.0*M_PI*1000.0;
+        auto accelerationFct = [omega](Core::Particle* /*particle*/, Core::Vector position,
+                Core::Vector /*velocity*/, double /*time*/, unsigned int /*timestep*/){
+            return position*(-omega*omega);
+        };
+        auto spaceChargeAccelerationFct = [](Core::Particle* /*particle*/, int /*particleIndex*/,
+                SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 0.0, 0.0);
+        };
+
+        Core::Particle particle(Core::Vector(1.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 100.0);
+        std::vector<Core::Particle*> particles = {&particle};
+        Integration::ParallelSymplecticIntegrator integrator(
+                particles, accelerationFct, spaceChargeAccelerationFct, order);
+
+        double period = 1.0/1000.0;
+        integrator.run(stepsPerPeriod*nPeriods, period/stepsPerPeriod);
+
+        double phase = omega*integrator.time();
+        double dx = particle.getLocation().x() - std::cos(phase);
+        double dv = particle.getVelocity().x()/omega + std::sin(phase);
+        return std::sqrt(dx*dx + dv*dv);
+    }
+}
+
+TEST_CASE( "Test parallel symplectic integrator", "[ParticleSimulation][ParallelSymplecticIntegrator][trajectory integration]") {
+
+    SECTION("Composition weights sum up to one and are symmetric"){
+        for (auto order: {Integration::ParallelSymplecticIntegrator::FOURTH_ORDER,
+                          Integration::ParallelSymplecticIntegrator::SIXTH_ORDER}){
+            std::vector<double> weights = Integration::ParallelSymplecticIntegrator::compositionWeights(order);
+            CHECK(std::accumulate(weights.begin(), weights.end(), 0.0) == Approx(1.0).epsilon(1e-14));
+            for (std::size_t i=0; i<weights.size(); ++i){
+                CHECK(weights[i] == Approx(weights[weights.size()-1-i]));
+            }
+        }
+        CHECK(Integration::ParallelSymplecticIntegrator::compositionWeights(
+                Integration::ParallelSymplecticIntegrator::FOURTH_ORDER).size() == 3);
+        CHECK(Integration::ParallelSymplecticIntegrator::compositionWeights(
+                Integration::ParallelSymplecticIntegrator::SIXTH_ORDER).size() == 7);
+    }
+
+    SECTION("Uniform acceleration and constant space charge are integrated exactly"){
+        double dt = 1e-4;
+        auto accelerationFct = [](Core::Particle* /*particle*/, Core::Vector /*position*/,
+                Core::Vector /*velocity*/, double /*time*/, unsigned int /*timestep*/){
+            return Core::Vector(10.0, 0.0, 5.0);
+        };
+        auto spaceChargeAccelerationFct = [](Core::Particle* /*particle*/, int /*particleIndex*/,
+                SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 1.0, 0.0);
+        };
+
+        Core::Particle testParticle(Core::Vector(0.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 100.0);
+        Integration::ParallelSymplecticIntegrator integrator(accelerationFct, spaceChargeAccelerationFct,
+                Integration::ParallelSymplecticIntegrator::SIXTH_ORDER);
+        REQUIRE_NOTHROW(integrator.run(1, dt));
+        integrator.addParticle(&testParticle);
+        integrator.run(100, dt);
+
+        double t = 100*dt;
+        Core::Vector ionPos = testParticle.getLocation();
+        CHECK(ionPos.x() == Approx(0.5*10.0*t*t));
+        CHECK(ionPos.y() == Approx(0.5*1.0*t*t));
+        CHECK(ionPos.z() == Approx(0.5*5.0*t*t));
+        CHECK(integrator.timeStep() == 101);
+    }
+
+    SECTION("Fourth and sixth order schemes converge with their order"){
+        auto fourth = Integration::ParallelSymplecticIntegrator::FOURTH_ORDER;
+        double errorCoarse4 = harmonicOscillatorError(fourth, 20, 10);
+        double errorFine4 = harmonicOscillatorError(fourth, 40, 10);
+        CHECK(errorCoarse4/errorFine4 == Approx(16.0).epsilon(0.1));
+
+        auto sixth = Integration::ParallelSymplecticIntegrator::SIXTH_ORDER;
+        double errorCoarse6 = harmonicOscillatorError(sixth, 20, 10);
+        double errorFine6 = harmonicOscillatorError(sixth, 40, 10);
+        CHECK(errorCoarse6/errorFine6 == Approx(64.0).epsilon(0.15));
+        CHECK(errorCoarse6 < errorCoarse4);
+    }
+
+    SECTION("Energy error stays bounded in long runs"){
+        double omega = 2.0*M_PI*1000.0;
+        auto accelerationFct = [omega](Core::Particle* /*particle*/, Core::Vector position,
+                Core::Vector /*velocity*/, double /*time*/, unsigned int /*timestep*/){
+            return position*(-omega*omega);
+        };
+        auto spaceChargeAccelerationFct = [](Core::Particle* /*particle*/, int /*particleIndex*/,
+                SpaceCharge::FieldCalculator& /*tree*/, double /*time*/, int /*timestep*/){
+            return Core::Vector(0.0, 0.0, 0.0);
+        };
+
+        // runs the oscillator over a number of periods (20 time steps per period) and returns the max. relative
+        // energy error:
+        auto maxEnergyErrorOfRun = [omega, &accelerationFct, &spaceChargeAccelerationFct](unsigned int nPeriods){
+            double maxEnergyError = 0.0;
+            auto postTimestepFct = [omega, &maxEnergyError](
+                    Integration::AbstractTimeIntegrator* /*integrator*/, std::vector<Core::Particle*>& particles,
+                    double /*time*/, int /*timestep*/, bool /*lastTimestep*/){
+                double x = particles[0]->getLocation().x();
+                double v = particles[0]->getVelocity().x();
+                double energy = 0.5*v*v + 0.5*omega*omega*x*x;
+                double energyExact = 0.5*omega*omega;
+                maxEnergyError = std::max(maxEnergyError, std::fabs(energy - energyExact)/energyExact);
+            };
+
+            Core::Particle particle(Core::Vector(1.0, 0.0, 0.0), Core::Vector(0.0, 0.0, 0.0), 1.0, 100.0);
+            std::vector<Core::Particle*> particles = {&particle};
+            Integration::ParallelSymplecticIntegrator integrator(
+                    particles, accelerationFct, spaceChargeAccelerationFct,
+                    Integration::ParallelSymplecticIntegrator::FOURTH_ORDER, postTimestepFct);
+            integrator.run(20*nPeriods, 1e-3/20);
+            return maxEnergyError;
+        };
+
+        double longRunError = maxEnergyErrorOfRun(2000);
+        double shortRunError = maxEnergyErrorOfRun(20);
+
+        // no secular energy drift: the error of a run over 2000 periods is not larger than over 20 periods
+        CHECK(longRunError < 1e-3);
+        CHECK(longRunError <= shortRunError*1.01);
+    }
+}
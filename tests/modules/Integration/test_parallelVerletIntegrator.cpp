@@ -227,3 +227,66 @@ TEST_CASE( "Test parallel verlet integrator", "[ParticleSimulation][ParallelVerl
         }
     }
 }
+
+TEST_CASE( "Test parallel verlet integrator in overlapped mode", "[ParticleSimulation][ParallelVerletIntegrator][trajectory integration]") {
+
+    double dt = 1e-9;
+    unsigned int timeSteps = 50;
+    double spaceChargeFactor = 1000.0;
+    double trapConstant = 1e11;
+
+    auto externalAccelerationFct = [trapConstant](Core::Particle* /*particle*/, Core::Vector position,
+            Core::Vector /*velocity*/, double /*time*/, unsigned int /*timestep*/){
+        return position * (-trapConstant);
+    };
+
+    auto spaceChargeAccelerationFct = [spaceChargeFactor](Core::Particle* particle, std::size_t /*particleIndex*/,
+            SpaceCharge::FieldCalculator& scFieldCalculator, double /*time*/, unsigned int /*timestep*/){
+        return scFieldCalculator.getEFieldFromSpaceCharge(*particle) *
+                (particle->getCharge() * spaceChargeFactor / particle->getMass());
+    };
+
+    auto combinedAccelerationFct = [externalAccelerationFct, spaceChargeAccelerationFct](
+            Core::Particle* particle, std::size_t particleIndex, SpaceCharge::FieldCalculator& scFieldCalculator,
+            double time, unsigned int timestep){
+        return externalAccelerationFct(particle, particle->getLocation(), particle->getVelocity(), time, timestep) +
+                spaceChargeAccelerationFct(particle, particleIndex, scFieldCalculator, time, timestep);
+    };
+
+    std::size_t nPerDirection = 6;
+    std::vector<Core::uniquePartPtr> particlesCombined;
+    std::vector<Core::uniquePartPtr> particlesOverlapped;
+    std::vector<Core::Particle*> ptrsCombined;
+    std::vector<Core::Particle*> ptrsOverlapped;
+    for (std::size_t i=0; i<nPerDirection; ++i){
+        for (std::size_t j=0; j<nPerDirection; ++j){
+            for (std::size_t k=0; k<nPerDirection; ++k){
+                Core::Vector pos(i*1e-4, j*1.1e-4, k*0.9e-4);
+                particlesCombined.push_back(std::make_unique<Core::Particle>(pos, Core::Vector(0, 0, 0), 1.0, 100.0));
+                particlesOverlapped.push_back(std::make_unique<Core::Particle>(pos, Core::Vector(0, 0, 0), 1.0, 100.0));
+                ptrsCombined.push_back(particlesCombined.back().get());
+                ptrsOverlapped.push_back(particlesOverlapped.back().get());
+            }
+        }
+    }
+
+    Integration::ParallelVerletIntegrator combinedIntegrator(ptrsCombined, combinedAccelerationFct);
+    Integration::ParallelVerletIntegrator overlappedIntegrator(
+            ptrsOverlapped, externalAccelerationFct, spaceChargeAccelerationFct);
+
+    CHECK_FALSE(combinedIntegrator.isOverlapped());
+    CHECK(overlappedIntegrator.isOverlapped());
+
+    combinedIntegrator.run(timeSteps, dt);
+    overlappedIntegrator.run(timeSteps, dt);
+
+    double maxDiff = 0.0;
+    double maxDisplacement = 0.0;
+    for (std::size_t i=0; i<ptrsCombined.size(); ++i){
+        maxDiff = std::max(maxDiff,
+                (ptrsCombined[i]->getLocation() - ptrsOverlapped[i]->getLocation()).magnitude());
+        maxDisplacement = std::max(maxDisplacement, ptrsCombined[i]->getVelocity().magnitude());
+    }
+    CHECK(maxDisplacement > 0.0);
+    CHECK(maxDiff < 1e-12);
+}
@@ -0,0 +1,145 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_steadyStateBeamIntegrator.cpp
+
+ Testing of the steady state (self consistent space charge) beam integrator
+
+ ****************************/
+
+#include "Integration_steadyStateBeamIntegrator.hpp"
+#include "SC_steadyStateBeamSolver.hpp"
+#include "Core_vector.hpp"
+#include "Core_particle.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <cmath>
+
+namespace {
+    /**
+     * Creates a parallel beam of particles with a circular cross section, moving in x direction
+     */
+    std::vector<std::unique_ptr<Core::Particle>> circularBeam(double xStart, double radius, double velocity){
+        std::vector<std::unique_ptr<Core::Particle>> particles;
+        particles.push_back(std::make_unique<Core::Particle>(
+                Core::Vector(xStart, 0.0, 0.0), Core::Vector(velocity, 0.0, 0.0), 1.0, 100.0));
+        for (int i=0; i<12; ++i){
+            double phi = i*M_PI/6.0;
+            particles.push_back(std::make_unique<Core::Particle>(
+                    Core::Vector(xStart, radius*std::cos(phi), radius*std::sin(phi)),
+                    Core::Vector(velocity, 0.0, 0.0), 1.0, 100.0));
+        }
+        return particles;
+    }
+
+    /**
+     * Mean radial distance of the particles from the beam axis
+     */
+    double meanRadius(const std::vector<std::unique_ptr<Core::Particle>>& particles){
+        double sum = 0.0;
+        for (const auto& particle: particles){
+            Core::Vector loc = particle->getLocation();
+            sum += std::sqrt(loc.y()*loc.y() + loc.z()*loc.z());
+        }
+        return sum / static_cast<double>(particles.size());
+    }
+}
+
+TEST_CASE( "Test steady state beam integrator", "[ParticleSimulation][SteadyStateBeamIntegrator][trajectory integration]") {
+
+    double velocity = 1000.0;
+    double xStart = -0.01;
+    double xEnd = 0.01;
+    double dt = 1e-7;
+    unsigned int maxTimesteps = 1000;
+
+    auto accelerationFct = [](Core::Particle* particle, std::size_t /*particleIndex*/,
+                              SpaceCharge::FieldCalculator& scFieldCalculator, double /*time*/,
+                              unsigned int /*timestep*/){
+        return scFieldCalculator.getEFieldFromSpaceCharge(*particle) * (particle->getCharge() / particle->getMass());
+    };
+    auto terminationFct = [xEnd](Core::Vector& newPartPos, Core::Particle* particle, std::size_t /*particleIndex*/,
+                                 double /*time*/, unsigned int /*timestep*/){
+        if (newPartPos.x() > xEnd){
+            particle->setActive(false);
+        }
+    };
+
+    SECTION( "Steady state integrator should reject currents not matching the particles") {
+        SpaceCharge::SteadyStateBeamSolver solver({-0.012, -0.005, -0.005}, {0.012, 0.005, 0.005}, {25, 11, 11});
+        auto particles = circularBeam(xStart, 1e-3, velocity);
+        std::vector<Core::Particle*> particlePtrs;
+        for (const auto& particle: particles){
+            particlePtrs.push_back(particle.get());
+        }
+        std::vector<double> currents = {1e-9};
+        CHECK_THROWS_AS(Integration::SteadyStateBeamIntegrator(particlePtrs, currents, solver, accelerationFct),
+                        std::invalid_argument);
+    }
+
+    SECTION( "Steady state integrator should deposit the beam charge and find a self consistent solution") {
+        SpaceCharge::SteadyStateBeamSolver solver({-0.012, -0.005, -0.005}, {0.012, 0.005, 0.005}, {49, 41, 41});
+        auto particles = circularBeam(xStart, 1e-3, velocity);
+        std::vector<Core::Particle*> particlePtrs;
+        for (const auto& particle: particles){
+            particlePtrs.push_back(particle.get());
+        }
+
+        double beamCurrent = 1e-9;
+        std::vector<double> currents(particles.size(), beamCurrent / static_cast<double>(particles.size()));
+        Integration::SteadyStateBeamIntegrator integrator(particlePtrs, currents, solver, accelerationFct,
+                                                          terminationFct);
+
+        // the first iteration traces the trajectories without space charge: The beam is parallel and the total
+        // charge is the beam current times the transit time
+        std::size_t nIterations = integrator.run(1, 1e-3, dt, maxTimesteps);
+        CHECK(nIterations == 1);
+        CHECK(solver.getTotalCharge() == Approx(beamCurrent*(xEnd - xStart)/velocity).epsilon(0.02));
+        CHECK(meanRadius(particles) == Approx(12.0/13.0*1e-3));
+        for (const auto& particle: particles){
+            CHECK(particle->getLocation().x() > xEnd);
+            CHECK(!particle->isActive());
+        }
+
+        // further iterations: the beam is widened by its space charge and the residual decreases
+        nIterations = integrator.run(40, 1e-3, dt, maxTimesteps);
+        const std::vector<double>& residuals = integrator.getResiduals();
+        CHECK(nIterations == residuals.size() - 1);
+        CHECK(residuals.size() < 41);
+        CHECK(residuals.back() < 1e-3);
+        CHECK(residuals[2] < residuals[1]);
+
+        double radiusSpaceCharge = meanRadius(particles);
+        CHECK(radiusSpaceCharge > 1.2*12.0/13.0*1e-3);
+
+        // retracing without deposition does not change the charge in the solver:
+        unsigned int nTracedSteps = 0;
+        integrator.traceTrajectories(dt, maxTimesteps,
+                [&nTracedSteps](std::vector<Core::Particle*>&, unsigned int, bool){ ++nTracedSteps; }, false);
+        CHECK(nTracedSteps > 0);
+        CHECK(meanRadius(particles) == Approx(radiusSpaceCharge).epsilon(1e-2));
+
+        // retracing with the converged field reproduces the trajectories:
+        integrator.traceTrajectories(dt, maxTimesteps);
+        CHECK(meanRadius(particles) == Approx(radiusSpaceCharge).epsilon(1e-2));
+        CHECK(solver.updateField() < 1e-2);
+    }
+}
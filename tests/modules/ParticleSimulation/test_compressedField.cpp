@@ -0,0 +1,148 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_compressedField.cpp
+
+ Testing of block wise compressed field storage
+
+ ****************************/
+
+#include "PSim_compressedField.hpp"
+#include "PSim_interpolatedField.hpp"
+#include "PSim_simionPotentialArray.hpp"
+#include "Core_vector.hpp"
+#include "catch.hpp"
+#include "test_util.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST_CASE("Test compressed field", "[ParticleSimulation][CompressedField]") {
+
+    // dimensions which are no multiples of the block edge length:
+    std::array<std::size_t, 3> dims = {21, 9, 17};
+    std::size_t nPoints = dims[0]*dims[1]*dims[2];
+
+    std::vector<double> smoothData(nPoints);
+    for (std::size_t iz=0; iz<dims[2]; ++iz){
+        for (std::size_t iy=0; iy<dims[1]; ++iy){
+            for (std::size_t ix=0; ix<dims[0]; ++ix){
+                smoothData[(iz*dims[1] + iy)*dims[0] + ix] =
+                        100.0*std::sin(0.1*ix)*std::cos(0.05*iy) + 3.0*iz - 7.5;
+            }
+        }
+    }
+
+    SECTION("Lossless compression reproduces arbitrary data exactly") {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> dist(-1e6, 1e6);
+        std::vector<double> randomData(nPoints);
+        for (double& value: randomData){
+            value = dist(rng);
+        }
+        randomData[5] = 0.0;
+        randomData[6] = -0.0;
+        randomData[7] = 1e-300;
+
+        ParticleSimulation::CompressedField randomField(dims, randomData);
+        ParticleSimulation::CompressedField smoothField(dims, smoothData);
+
+        bool allEqual = true;
+        for (std::size_t iz=0; iz<dims[2]; ++iz){
+            for (std::size_t iy=0; iy<dims[1]; ++iy){
+                for (std::size_t ix=0; ix<dims[0]; ++ix){
+                    std::size_t i = (iz*dims[1] + iy)*dims[0] + ix;
+                    allEqual = allEqual &&
+                            isExactDoubleEqual(randomField.get(ix, iy, iz), randomData[i]) &&
+                            isExactDoubleEqual(smoothField.get(ix, iy, iz), smoothData[i]);
+                }
+            }
+        }
+        CHECK(allEqual);
+        CHECK(smoothField.getErrorBound() == Approx(0.0));
+        CHECK(smoothField.uncompressedSizeBytes() == nPoints*sizeof(double));
+    }
+
+    SECTION("Lossy compression respects the error bound and compresses smooth data strongly") {
+        double errorBound = 1e-3;
+        ParticleSimulation::CompressedField lossyField(dims, smoothData, errorBound);
+
+        double maxError = 0.0;
+        // access in reverse order to exercise the block cache:
+        for (std::size_t i=nPoints; i-- > 0;){
+            std::size_t ix = i % dims[0];
+            std::size_t iy = (i / dims[0]) % dims[1];
+            std::size_t iz = i / (dims[0]*dims[1]);
+            maxError = std::max(maxError, std::fabs(lossyField.get(ix, iy, iz) - smoothData[i]));
+        }
+        CHECK(maxError <= errorBound*(1.0 + 1e-9));
+        CHECK(lossyField.compressedSizeBytes()*4 < lossyField.uncompressedSizeBytes());
+    }
+
+    SECTION("Illegal inputs throw") {
+        CHECK_THROWS_AS(ParticleSimulation::CompressedField({2, 2, 2}, {1.0, 2.0}), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::CompressedField({2, 1, 1}, {1.0, 2.0}, -1.0), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::CompressedField({2, 1, 1}, {1.0, NAN}, 1e-3), std::invalid_argument);
+    }
+
+    SECTION("Compressed interpolated fields return the same values as uncompressed fields") {
+        ParticleSimulation::InterpolatedField field("test_linear_vector_field_01.h5");
+        ParticleSimulation::InterpolatedField compressedField("test_linear_vector_field_01.h5");
+        compressedField.compress();
+        CHECK(compressedField.isCompressed());
+        CHECK_FALSE(field.isCompressed());
+        CHECK_THROWS_AS(compressedField.compress(), std::logic_error);
+
+        std::vector<Core::Vector> probes = {{0.01, 0.0, 0.01}, {7.0, 0.0, 0.1}, {2.0, 0.0, 2.1}, {15.3, -4.2, 8.8}};
+        for (const auto& p: probes){
+            for (std::size_t fieldIndex=0; fieldIndex<2; ++fieldIndex) {
+                CHECK(compressedField.getInterpolatedVector(p.x(), p.y(), p.z(), fieldIndex) ==
+                      field.getInterpolatedVector(p.x(), p.y(), p.z(), fieldIndex));
+            }
+        }
+        CHECK(compressedField.getVector(3, 2, 1, 0) == field.getVector(3, 2, 1, 0));
+    }
+
+    SECTION("Compressed potential arrays return the same values as uncompressed potential arrays") {
+        ParticleSimulation::SimionPotentialArray pa("simion_test_planar_3d.pa");
+        ParticleSimulation::SimionPotentialArray compressedPa("simion_test_planar_3d.pa");
+        compressedPa.compress();
+        CHECK(compressedPa.isCompressed());
+        CHECK(compressedPa.dataSizeBytes() < pa.dataSizeBytes());
+
+        std::array<double, 6> bounds = pa.getBounds();
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> distX(bounds[0], bounds[1]);
+        std::uniform_real_distribution<double> distY(bounds[2], bounds[3]);
+        std::uniform_real_distribution<double> distZ(bounds[4], bounds[5]);
+        bool allEqual = true;
+        for (int i=0; i<1000; ++i){
+            double x = distX(rng);
+            double y = distY(rng);
+            double z = distZ(rng);
+            allEqual = allEqual &&
+                    isExactDoubleEqual(compressedPa.getInterpolatedPotential(x, y, z),
+                                       pa.getInterpolatedPotential(x, y, z)) &&
+                    (compressedPa.isElectrode(x, y, z) == pa.isElectrode(x, y, z));
+        }
+        CHECK(allEqual);
+    }
+}
@@ -28,6 +28,8 @@
 #include "PSim_math.hpp"
 #include "catch.hpp"
 #include <vector>
+#include <complex>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -73,3 +75,33 @@ TEST_CASE ("Check max_int value","[ParticleSimulation][math]"){
     std::cout <<"INT_MAX:"<< std::numeric_limits<int>::max() <<std::endl;
     std::cout <<"LONG_MAX:"<< std::numeric_limits<long>::max() <<std::endl;
 }
+
+TEST_CASE("Test inverse FFT", "[ParticleSimulation][math]") {
+
+    SECTION("Inverse FFT should be equal to the direct inverse discrete Fourier transform") {
+        std::size_t n = 32;
+        std::vector<std::complex<double>> spectrum(n);
+        for (std::size_t k=0; k<n; ++k){
+            spectrum[k] = {std::sin(0.3*static_cast<double>(k)), 0.1*static_cast<double>(k)};
+        }
+        std::vector<std::complex<double>> transformed = spectrum;
+        ParticleSimulation::inverseFFT(transformed);
+
+        for (std::size_t j=0; j<n; ++j){
+            std::complex<double> expected = {0.0, 0.0};
+            for (std::size_t k=0; k<n; ++k){
+                double angle = 2.0*M_PI*static_cast<double>(k*j)/static_cast<double>(n);
+                expected += spectrum[k]*std::polar(1.0, angle);
+            }
+            CHECK(transformed[j].real() == Approx(expected.real()).margin(1e-10));
+            CHECK(transformed[j].imag() == Approx(expected.imag()).margin(1e-10));
+        }
+    }
+
+    SECTION("Inverse FFT should throw if the length is not a power of two") {
+        std::vector<std::complex<double>> data(12);
+        CHECK(ParticleSimulation::isPowerOfTwo(64));
+        CHECK( !ParticleSimulation::isPowerOfTwo(12));
+        CHECK_THROWS_AS(ParticleSimulation::inverseFFT(data), std::invalid_argument);
+    }
+}
@@ -89,6 +89,14 @@ TEST_CASE("Test sampled waveform / SWIFT waveform reader", "[ParticleSimulation]
         CHECK(sw.getInterpolatedValue(0.9999) == Approx(0.0002));
     }
 
+    SECTION("Waveform constructed from samples in memory should be correct") {
+        ParticleSimulation::SampledWaveform sw(std::vector<double>{0.0, 1.0, 0.5, -1.0});
+        CHECK(sw.good());
+        CHECK(sw.size() == 4);
+        CHECK(sw.getValue(2) == Approx(0.5));
+        CHECK(sw.getValueLooped(7) == Approx(-1.0));
+    }
+
     SECTION( "Non existing input file should lead to good()==false") {
         ParticleSimulation::SampledWaveform sw("not_a_file");
         CHECK(! sw.good());
@@ -0,0 +1,108 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_swiftWaveform.cpp
+
+ Testing of the in process SWIFT waveform synthesis
+
+ ****************************/
+
+#include "PSim_swiftWaveform.hpp"
+#include "catch.hpp"
+#include <cmath>
+#include <algorithm>
+
+/**
+ * Magnitude of the discrete Fourier component of a sampled signal at a frequency
+ */
+double fourierMagnitude(const std::vector<double>& samples, double dt, double frequency){
+    double re = 0.0;
+    double im = 0.0;
+    for (std::size_t i=0; i<samples.size(); ++i){
+        double angle = 2.0*M_PI*frequency*static_cast<double>(i)*dt;
+        re += samples[i]*std::cos(angle);
+        im += samples[i]*std::sin(angle);
+    }
+    return std::sqrt(re*re + im*im) / static_cast<double>(samples.size());
+}
+
+TEST_CASE("Test SWIFT waveform synthesis", "[ParticleSimulation][SwiftWaveform]") {
+
+    double frequencyResolution = 1000.0;
+    ParticleSimulation::SwiftWaveform swift(10000.0, 200000.0, frequencyResolution,
+            {{49500.0, 60500.0}, {120000.0, 121000.0}});
+
+    // one period of the waveform, sampled with 1024 samples:
+    double dt = 1.0/(frequencyResolution*1024.0);
+    std::vector<double> period = swift.synthesize(dt, 1024);
+
+    SECTION("SWIFT waveform should have the correct frequency components") {
+        CHECK(swift.numberOfComponents() == 191 - 11 - 2);
+        CHECK(swift.getPeriod() == Approx(1.0e-3));
+
+        double componentMagnitude = fourierMagnitude(period, dt, 30000.0);
+        CHECK(componentMagnitude > 0.0);
+        CHECK(fourierMagnitude(period, dt, 150000.0) == Approx(componentMagnitude).epsilon(1e-6));
+        for (double notchedFrequency: {50000.0, 55000.0, 60000.0, 120000.0, 121000.0, 5000.0, 250000.0}){
+            CHECK(fourierMagnitude(period, dt, notchedFrequency) == Approx(0.0).margin(1e-10));
+        }
+    }
+
+    SECTION("SWIFT waveform should be normalized to a peak amplitude of one") {
+        double peak = 0.0;
+        for (double value: period){
+            peak = std::max(peak, std::fabs(value));
+        }
+        CHECK(peak == Approx(1.0).epsilon(0.05));
+    }
+
+    SECTION("Synthesized waveform should be equal to the directly evaluated waveform") {
+        for (std::size_t i: {0ul, 17ul, 512ul, 1023ul}){
+            CHECK(period[i] == Approx(swift.getValue(static_cast<double>(i)*dt)).margin(1e-10));
+        }
+
+        // sample spacing which is no power of two fraction of the period (direct evaluation):
+        double dtDirect = 1.3e-7;
+        std::vector<double> direct = swift.synthesize(dtDirect, 20000);
+        CHECK(direct[12345] == Approx(swift.getValue(12345*dtDirect)).margin(1e-10));
+    }
+
+    SECTION("SWIFT waveform should be periodic") {
+        std::vector<double> longWaveform = swift.synthesize(dt, 3000);
+        CHECK(longWaveform[2100] == Approx(period[2100-2048]).margin(1e-10));
+        CHECK(swift.getValue(0.3e-3) == Approx(swift.getValue(5.3e-3)).margin(1e-9));
+    }
+
+    SECTION("Illegal SWIFT specifications should throw") {
+        CHECK_THROWS_AS(ParticleSimulation::SwiftWaveform(2000.0, 1000.0, 10.0, {}), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::SwiftWaveform(1000.0, 2000.0, 0.0, {}), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::SwiftWaveform(1000.0, 2000.0, 10.0, {{500.0, 2500.0}}),
+                std::invalid_argument);
+    }
+
+    SECTION("Secular frequencies in a linear quadrupole should be correct") {
+        // q = 4 e V / (m r_0^2 Omega^2), f_sec = q f_rf / (2 sqrt(2))
+        double f = ParticleSimulation::SwiftWaveform::linearQuadrupoleSecularFrequency(100.0, 1.0, 500.0, 1.0e6, 0.004);
+        double omega = 2.0*M_PI*1.0e6;
+        double q = 4.0*1.60217e-19*500.0 / (100.0*1.66048e-27*0.004*0.004*omega*omega);
+        CHECK(f == Approx(q*1.0e6/(2.0*std::sqrt(2.0))));
+    }
+}
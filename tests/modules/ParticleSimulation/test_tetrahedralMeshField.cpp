@@ -0,0 +1,126 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_tetrahedralMeshField.cpp
+
+ Testing of fields on unstructured tetrahedral meshes
+
+ ****************************/
+
+#include "PSim_tetrahedralMeshField.hpp"
+#include "Core_vector.hpp"
+#include "catch.hpp"
+#include "test_util.hpp"
+#include <vector>
+#include <array>
+
+TEST_CASE("Test tetrahedral mesh field", "[ParticleSimulation][TetrahedralMeshField][file readers]") {
+
+    SECTION("Test linear tetrahedral mesh field with hdf5 file") {
+        ParticleSimulation::TetrahedralMeshField meshField("test_linear_tetrahedral_mesh_field_01.h5");
+
+        SECTION("Mesh and field metadata is correct") {
+            CHECK(meshField.getNumberOfNodes() == 64);
+            CHECK(meshField.getNumberOfElements() == 162);
+            std::vector<std::string> fieldNames = {"test_field", "test_vectorfield"};
+            CHECK(meshField.getFieldNames() == fieldNames);
+            std::array<double, 6> correctBounds = {0, 10, 0, 10, 0, 10};
+            CHECK(meshField.getBounds() == correctBounds);
+        }
+
+        SECTION("Linear fields are reproduced exactly by the interpolation") {
+            std::vector<Core::Vector> probes = {
+                    {1.0, 1.0, 1.0}, {9.9, 0.1, 4.2}, {3.3, 7.7, 5.5}, {0.0, 0.0, 0.0}, {10.0, 10.0, 10.0},
+                    {2.0, 5.0, 6.1}};
+            for (const auto& p: probes) {
+                CHECK(meshField.getInterpolatedScalar(p.x(), p.y(), p.z(), 0) ==
+                      Approx(p.x() + 2*p.y() + 3*p.z()));
+                CHECK(vectorApproxCompare(
+                        meshField.getInterpolatedVector(p.x(), p.y(), p.z(), 1),
+                        Core::Vector(p.x(), p.y() + 1.0, -p.z())) == vectorsApproxEqual);
+            }
+        }
+
+        SECTION("Located elements contain the probed position") {
+            Core::Vector position(4.5, 3.2, 8.1);
+            std::size_t element = meshField.findElement(position);
+            REQUIRE(element != ParticleSimulation::TetrahedralMeshField::NO_ELEMENT);
+
+            // walks from arbitrary start elements should end in the same element:
+            for (std::size_t start=0; start<meshField.getNumberOfElements(); start += 17) {
+                CHECK(meshField.findElement(position, start) == element);
+            }
+            CHECK(meshField.findElement(Core::Vector(11.0, 3.2, 8.1)) ==
+                  ParticleSimulation::TetrahedralMeshField::NO_ELEMENT);
+        }
+
+        SECTION("Location hint is updated and used for subsequent lookups") {
+            std::size_t hint = ParticleSimulation::TetrahedralMeshField::NO_ELEMENT;
+            Core::Vector position(0.5, 0.5, 0.5);
+            for (int i=0; i<90; ++i) {
+                double value = meshField.getInterpolatedScalar(position.x(), position.y(), position.z(), 0, hint);
+                CHECK(value == Approx(position.x() + 2*position.y() + 3*position.z()));
+                CHECK(hint == meshField.findElement(position));
+                position = position + Core::Vector(0.1, 0.05, 0.1);
+            }
+        }
+
+        SECTION("Illegal accesses throw") {
+            CHECK_THROWS_AS(meshField.getInterpolatedScalar(-1.0, 5.0, 5.0, 0), std::invalid_argument);
+            CHECK_THROWS_AS(meshField.getInterpolatedVector(5.0, 5.0, 5.0, 0), std::invalid_argument);
+            CHECK_THROWS_AS(meshField.getInterpolatedScalar(5.0, 5.0, 5.0, 1), std::invalid_argument);
+            CHECK_THROWS_AS(meshField.getInterpolatedScalar(5.0, 5.0, 5.0, 2), std::invalid_argument);
+        }
+    }
+
+    SECTION("Test tetrahedral mesh field constructed from mesh data") {
+        std::vector<Core::Vector> nodes = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 1}};
+        std::vector<std::array<std::size_t, 4>> elements = {{0, 1, 2, 3}, {1, 2, 3, 4}};
+
+        ParticleSimulation::TetrahedralMeshField meshField(nodes, elements);
+        meshField.addScalarField("nodal_values", {1.0, 2.0, 3.0, 4.0, 5.0});
+
+        SECTION("Nodal values are interpolated with barycentric coordinates") {
+            CHECK(meshField.getInterpolatedScalar(0.0, 0.0, 0.0, 0) == Approx(1.0));
+            CHECK(meshField.getInterpolatedScalar(1.0, 1.0, 1.0, 0) == Approx(5.0));
+            CHECK(meshField.getInterpolatedScalar(0.25, 0.25, 0.25, 0) == Approx(2.5));
+            CHECK(meshField.getInterpolatedScalar(0.5, 0.5, 0.5, 0) == Approx(3.5));
+        }
+
+        SECTION("Positions in the bounding box but outside of the (non convex) mesh throw") {
+            CHECK_THROWS_AS(meshField.getInterpolatedScalar(0.9, 0.9, 0.0, 0), std::invalid_argument);
+            std::size_t hint = 0;
+            CHECK_THROWS_AS(meshField.getInterpolatedScalar(0.9, 0.9, 0.0, 0, hint), std::invalid_argument);
+        }
+
+        SECTION("Illegal mesh data throws") {
+            CHECK_THROWS_AS(meshField.addScalarField("wrong_size", {1.0, 2.0}), std::invalid_argument);
+
+            std::vector<std::array<std::size_t, 4>> degeneratedElements = {{0, 1, 2, 3}, {0, 1, 2, 2}};
+            CHECK_THROWS_AS(ParticleSimulation::TetrahedralMeshField(nodes, degeneratedElements),
+                            std::invalid_argument);
+
+            std::vector<std::array<std::size_t, 4>> wrongIndexElements = {{0, 1, 2, 7}};
+            CHECK_THROWS_AS(ParticleSimulation::TetrahedralMeshField(nodes, wrongIndexElements),
+                            std::invalid_argument);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_timeSeriesField.cpp
+
+ Testing of the time dependent field streamed from field snapshots
+
+ ****************************/
+
+#include "PSim_timeSeriesField.hpp"
+#include "H5Cpp.h"
+#include "catch.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Writes a scalar field snapshot with the values offset + slope*x on a small regular grid
+ */
+void writeLinearSnapshot(const std::string& filename, double offset, double slope){
+    std::vector<double> gridPoints = {0.0, 1.0, 2.0};
+    H5::H5File file(filename, H5F_ACC_TRUNC);
+    H5::Group gridGroup = file.createGroup("/grid_points");
+    hsize_t gridDims[1] = {gridPoints.size()};
+    H5::DataSpace gridSpace(1, gridDims);
+    for (const auto& name: {"x", "y", "z"}){
+        H5::DataSet ds = gridGroup.createDataSet(name, H5::PredType::NATIVE_DOUBLE, gridSpace);
+        ds.write(gridPoints.data(), H5::PredType::NATIVE_DOUBLE);
+    }
+
+    H5::Group fieldsGroup = file.createGroup("/fields");
+    hsize_t fieldDims[3] = {gridPoints.size(), gridPoints.size(), gridPoints.size()};
+    std::vector<double> values;
+    for (double x: gridPoints){
+        for (std::size_t i=0; i<gridPoints.size()*gridPoints.size(); ++i){
+            values.push_back(offset + slope*x);
+        }
+    }
+    H5::DataSpace fieldSpace(3, fieldDims);
+    H5::DataSet ds = fieldsGroup.createDataSet("potential", H5::PredType::NATIVE_DOUBLE, fieldSpace);
+    ds.write(values.data(), H5::PredType::NATIVE_DOUBLE);
+}
+
+TEST_CASE("Test time series field", "[ParticleSimulation][TimeSeriesField][file readers]") {
+
+    std::vector<std::string> filenames;
+    std::vector<double> times;
+    for (std::size_t i=0; i<5; ++i){
+        filenames.push_back("test_time_series_snapshot_" + std::to_string(i) + ".h5");
+        times.push_back(static_cast<double>(i)*1e-3);
+        writeLinearSnapshot(filenames.back(), 10.0*static_cast<double>(i), 1.0 + static_cast<double>(i));
+    }
+
+    SECTION("Illegal snapshot specifications throw"){
+        CHECK_THROWS_AS(ParticleSimulation::TimeSeriesField({filenames[0]}, {0.0}), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::TimeSeriesField(filenames, {0.0, 1.0}), std::invalid_argument);
+        CHECK_THROWS_AS(ParticleSimulation::TimeSeriesField(
+                {filenames[0], filenames[1]}, {1.0, 1.0}), std::invalid_argument);
+    }
+
+    SECTION("Field is interpolated linearly in time between the bracketing snapshots"){
+        ParticleSimulation::TimeSeriesField field(filenames, times);
+        CHECK(field.numberOfSnapshots() == 5);
+        CHECK(field.getTime() == Approx(0.0));
+        CHECK(field.getInterpolatedScalar(1.0, 1.0, 1.0, 0) == Approx(1.0));
+
+        std::array<double, 6> bounds = {0.0, 2.0, 0.0, 2.0, 0.0, 2.0};
+        CHECK(field.getBounds() == bounds);
+
+        field.setTime(0.5e-3);
+        // mean of snapshot 0 (1.0*x) and snapshot 1 (10 + 2.0*x):
+        CHECK(field.getInterpolatedScalar(1.0, 0.5, 0.5, 0) == Approx(6.5));
+        CHECK(field.getInterpolatedScalar(1.5, 0.5, 0.5, 0) == Approx(7.25));
+
+        field.setTime(3.25e-3);
+        // snapshot 3: 30 + 4.0*x, snapshot 4: 40 + 5.0*x
+        CHECK(field.getInterpolatedScalar(1.0, 1.0, 1.0, 0) == Approx(0.75*34.0 + 0.25*45.0));
+
+        field.setTime(4e-3);
+        CHECK(field.getInterpolatedScalar(1.5, 1.0, 1.0, 0) == Approx(47.5));
+
+        CHECK_THROWS_AS(field.setTime(4.1e-3), std::invalid_argument);
+        CHECK_THROWS_AS(field.setTime(-1e-3), std::invalid_argument);
+        CHECK_THROWS_AS(field.getInterpolatedScalar(3.0, 1.0, 1.0, 0), std::invalid_argument);
+    }
+
+    SECTION("Only a sliding window of snapshots is resident and every snapshot is read once in forward runs"){
+        ParticleSimulation::TimeSeriesField field(filenames, times);
+        CHECK(field.numberOfResidentSnapshots() <= 3);
+        std::size_t singleSnapshotSize = 27*sizeof(double);
+        for (std::size_t step=0; step<=400; ++step){
+            field.setTime(static_cast<double>(step)*1e-5);
+            CHECK(field.numberOfResidentSnapshots() <= 3);
+            CHECK(field.dataSizeBytes() <= 3*singleSnapshotSize);
+        }
+        CHECK(field.numberOfSnapshotsRead() == 5);
+
+        // setting the time backwards reads the snapshots again:
+        field.setTime(0.5e-3);
+        CHECK(field.getInterpolatedScalar(1.0, 0.5, 0.5, 0) == Approx(6.5));
+        CHECK(field.numberOfSnapshotsRead() > 5);
+    }
+
+    for (const auto& filename: filenames){
+        std::filesystem::remove(filename);
+    }
+}
@@ -0,0 +1,199 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_voltageSchedule.cpp
+
+ Testing of the electrode voltage schedule
+
+ ****************************/
+
+#include "PSim_voltageSchedule.hpp"
+#include "catch.hpp"
+#include <cmath>
+#include <memory>
+
+using Signal = ParticleSimulation::VoltageSchedule::Signal;
+
+TEST_CASE("Test voltage schedule signals", "[ParticleSimulation][VoltageSchedule]") {
+
+    SECTION("Constant, sine and pulse signals should be correct") {
+        Signal constSignal = Signal::constant(12.5);
+        CHECK(constSignal.value(0.0, 0) == Approx(12.5));
+        CHECK(constSignal.value(1.0, 1000) == Approx(12.5));
+
+        double frequency = 1.0e6;
+        Signal sineSignal = Signal::sine(100.0, frequency, 0.5);
+        for (double time: {0.0, 1.3e-7, 2.9e-6}){
+            CHECK(sineSignal.value(time, 0) == Approx(100.0*std::cos(2.0*M_PI*frequency*time + 0.5)));
+        }
+        CHECK(sineSignal.carrierType() == Signal::SINE);
+
+        Signal pulseSignal = Signal::pulse(5.0, 1.0e-3, 2.0e-3);
+        CHECK(pulseSignal.value(0.5e-3, 0) == Approx(0.0));
+        CHECK(pulseSignal.value(1.0e-3, 0) == Approx(5.0));
+        CHECK(pulseSignal.value(2.9e-3, 0) == Approx(5.0));
+        CHECK(pulseSignal.value(3.1e-3, 0) == Approx(0.0));
+    }
+
+    SECTION("Amplitude ramps should be linear and constant outside of the ramp") {
+        Signal rampedSignal = Signal::constant(10.0);
+        rampedSignal.setAmplitudeRamp(30.0, 1.0, 3.0);
+        CHECK(rampedSignal.amplitude(0.0) == Approx(10.0));
+        CHECK(rampedSignal.amplitude(1.0) == Approx(10.0));
+        CHECK(rampedSignal.amplitude(2.0) == Approx(20.0));
+        CHECK(rampedSignal.amplitude(2.5) == Approx(25.0));
+        CHECK(rampedSignal.amplitude(4.0) == Approx(30.0));
+        CHECK(rampedSignal.value(2.0, 0) == Approx(20.0));
+
+        Signal rampedSine = Signal::sine(100.0, 10.0).setAmplitudeRamp(200.0, 0.0, 1.0);
+        CHECK(rampedSine.value(0.5, 0) == Approx(150.0*std::cos(2.0*M_PI*10.0*0.5)));
+
+        CHECK_THROWS_AS(Signal::constant(1.0).setAmplitudeRamp(2.0, 1.0, 0.5), std::invalid_argument);
+        CHECK_THROWS_AS(Signal::pulse(1.0, 0.0, -1.0), std::invalid_argument);
+    }
+
+    SECTION("Sampled waveform signals should be correct") {
+        auto waveform = std::make_shared<ParticleSimulation::SampledWaveform>("swift_test_sin.csv");
+        REQUIRE(waveform->size() == 200);
+
+        Signal sampledSignal = Signal::sampled(waveform, 2.0);
+        CHECK(sampledSignal.value(0.0, 24) == Approx(2.0*waveform->getValue(24)));
+        CHECK(sampledSignal.value(0.0, 250) == Approx(0.0));
+
+        Signal loopedSignal = Signal::sampled(waveform, 2.0, true);
+        CHECK(loopedSignal.value(0.0, 224) == Approx(2.0*waveform->getValue(24)));
+
+        Signal delayedSignal = Signal::sampled(waveform, 2.0).setCarrierStart(1.0e-5, 1000);
+        CHECK(delayedSignal.value(0.0, 24) == Approx(0.0));
+        CHECK(delayedSignal.value(0.0, 1024) == Approx(2.0*waveform->getValue(24)));
+        CHECK(delayedSignal.value(0.0, 1250) == Approx(0.0));
+
+        auto invalidWaveform = std::make_shared<ParticleSimulation::SampledWaveform>("not_existing.csv");
+        CHECK_THROWS_AS(Signal::sampled(invalidWaveform, 1.0), std::invalid_argument);
+    }
+
+    SECTION("Traveling wave signals should be periodic and phase shifted") {
+        auto waveform = std::make_shared<ParticleSimulation::SampledWaveform>("low_sample_waveform.csv");
+        double frequency = 1000.0;
+        Signal waveSignal = Signal::travelingWave(waveform, 3.0, frequency, 0.25);
+
+        CHECK(waveSignal.value(0.0, 0) == Approx(3.0*waveform->getInterpolatedValue(0.25)));
+        CHECK(waveSignal.value(0.15e-3, 0) == Approx(3.0*waveform->getInterpolatedValue(0.4)));
+        CHECK(waveSignal.value(5.15e-3, 0) == Approx(3.0*waveform->getInterpolatedValue(0.4)));
+        CHECK(waveSignal.value(0.8e-3, 0) == Approx(3.0*waveform->getInterpolatedValue(0.05)));
+
+        CHECK_THROWS_AS(Signal::travelingWave(waveform, 3.0, 0.0, 0.0), std::invalid_argument);
+    }
+
+    SECTION("SWIFT signals should be evaluated from the SWIFT waveform") {
+        auto swift = std::make_shared<ParticleSimulation::SwiftWaveform>(1000.0, 50000.0, 500.0,
+                std::vector<std::array<double, 2>>{{9000.0, 11000.0}});
+        Signal swiftSignal = Signal::swift(swift, 4.0);
+        CHECK(swiftSignal.carrierType() == Signal::SWIFT);
+        CHECK(swiftSignal.value(1.7e-5, 0) == Approx(4.0*swift->getValue(1.7e-5)));
+
+        Signal delayedSwiftSignal = Signal::swift(swift, 4.0).setCarrierStart(1.0e-3, 0);
+        CHECK(delayedSwiftSignal.value(0.5e-3, 0) == Approx(0.0));
+        CHECK(delayedSwiftSignal.value(1.017e-3, 0) == Approx(4.0*swift->getValue(1.7e-5)));
+        CHECK_THROWS_AS(Signal::swift(nullptr, 1.0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Test voltage schedule", "[ParticleSimulation][VoltageSchedule]") {
+
+    double frequency = 1.0e6;
+    ParticleSimulation::VoltageSchedule schedule(3);
+    std::size_t rfIndex = schedule.addSignal("rf", Signal::sine(100.0, frequency));
+    schedule.addSignal("excite", Signal::pulse(2.0, 0.0, 1.0e-6));
+
+    schedule.setElectrodeOffset(0, 10.0);
+    schedule.setElectrodeFactor(0, rfIndex, 1.0);
+    schedule.setElectrodeFactor(1, "rf", -1.0);
+    schedule.setElectrodeFactor(1, "excite", 0.5);
+    schedule.setElectrodeOffset(2, -5.0);
+
+    auto expectedVoltages = [frequency](double time) -> std::vector<double> {
+        double rf = 100.0*std::cos(2.0*M_PI*frequency*time);
+        double excite = time < 1.0e-6 ? 2.0 : 0.0;
+        return {10.0 + rf, -rf + 0.5*excite, -5.0};
+    };
+
+    SECTION("Schedule should have correct structure") {
+        CHECK(schedule.numberOfElectrodes() == 3);
+        CHECK(schedule.numberOfSignals() == 2);
+        CHECK(schedule.hasSignal("excite"));
+        CHECK( !schedule.hasSignal("dc"));
+        CHECK(schedule.signalIndex("excite") == 1);
+        CHECK(schedule.signal("rf").amplitude(0.0) == Approx(100.0));
+    }
+
+    SECTION("Electrode voltages should be the correct linear combinations of the signals") {
+        for (double time: {0.0, 0.3e-6, 1.7e-6}){
+            std::vector<double> expected = expectedVoltages(time);
+            const std::vector<double>& voltages = schedule.voltages(time, 0);
+            REQUIRE(voltages.size() == 3);
+            for (std::size_t i=0; i<3; ++i){
+                CHECK(voltages[i] == Approx(expected[i]).margin(1e-12));
+                CHECK(schedule.voltage(i, time, 0) == Approx(expected[i]).margin(1e-12));
+            }
+
+            std::vector<double> evaluated;
+            schedule.evaluate(time, 0, evaluated);
+            CHECK(evaluated == voltages);
+        }
+    }
+
+    SECTION("Modification of the schedule should invalidate memorized voltages") {
+        CHECK(schedule.voltages(0.0, 0)[2] == Approx(-5.0));
+        schedule.setElectrodeOffset(2, 7.0);
+        CHECK(schedule.voltages(0.0, 0)[2] == Approx(7.0));
+        schedule.setElectrodeFactor(2, "rf", 1.0);
+        CHECK(schedule.voltages(0.0, 0)[2] == Approx(107.0));
+    }
+
+    SECTION("Voltages queried in parallel should be correct") {
+        std::size_t nQueries = 10000;
+        std::vector<double> results(nQueries);
+        #pragma omp parallel for default(none) shared(schedule, results, nQueries)
+        for (std::size_t i=0; i<nQueries; ++i){
+            double time = static_cast<double>(i % 7) * 0.25e-6;
+            results[i] = schedule.voltages(time, static_cast<unsigned int>(i % 7))[1];
+        }
+
+        bool allCorrect = true;
+        for (std::size_t i=0; i<nQueries; ++i){
+            double time = static_cast<double>(i % 7) * 0.25e-6;
+            if (std::fabs(results[i] - expectedVoltages(time)[1]) > 1e-9){
+                allCorrect = false;
+            }
+        }
+        CHECK(allCorrect);
+    }
+
+    SECTION("Illegal schedule definitions should throw") {
+        CHECK_THROWS_AS(schedule.addSignal("rf", Signal::constant(1.0)), std::invalid_argument);
+        CHECK_THROWS_AS(schedule.setElectrodeOffset(3, 1.0), std::invalid_argument);
+        CHECK_THROWS_AS(schedule.setElectrodeFactor(0, 2, 1.0), std::invalid_argument);
+        CHECK_THROWS_AS(schedule.setElectrodeFactor(0, "not_a_signal", 1.0), std::invalid_argument);
+        CHECK_THROWS_AS(schedule.signalIndex("not_a_signal"), std::invalid_argument);
+        CHECK_THROWS_AS(schedule.voltage(5, 0.0, 0), std::invalid_argument);
+    }
+}
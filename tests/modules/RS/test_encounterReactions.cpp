@@ -0,0 +1,226 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_encounterReactions.cpp
+
+ Testing of bimolecular encounter reactions of discrete particles
+
+ ****************************/
+
+#include "RS_Simulation.hpp"
+#include "RS_ConfigFileParser.hpp"
+#include "RS_DiscreteEncounterReaction.hpp"
+#include "RS_StaticReaction.hpp"
+#include "Core_randomGenerators.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <vector>
+#include <cmath>
+
+namespace {
+    const std::string encounterConfig =
+            "[SUBSTANCES]\n"
+            "Pos discrete 19 1 3.57e-4 3.0e-10\n"
+            "Neg discrete 35 -1 3.57e-4 3.0e-10\n"
+            "Cl discrete 55 1 3.57e-4 3.0e-10\n"
+            "N2 isotropic 3.58e16\n"
+            "[REACTIONS]\n"
+            "Pos + Neg => | encounter ; 1e-6 ; 1e12 #recombination\n"
+            "Pos + Pos => Cl | encounter ; 1e-6 ; 1e12 #clustering\n";
+}
+
+TEST_CASE("Test discrete encounter reactions", "[RS][reactions][encounter]") {
+
+    RS::ConfigFileParser parser;
+    std::unique_ptr<RS::SimulationConfiguration> simConf = parser.parseText(encounterConfig);
+    RS::Substance* pos = simConf->substanceByName("Pos");
+    RS::Substance* neg = simConf->substanceByName("Neg");
+    RS::Substance* cl = simConf->substanceByName("Cl");
+    RS::Substance* n2 = simConf->substanceByName("N2");
+
+    SECTION("Encounter reaction should be parsed and validated") {
+        REQUIRE(simConf->getAllReactions().size() == 2);
+        auto* reaction = dynamic_cast<RS::DiscreteEncounterReaction*>(simConf->reaction(0));
+        REQUIRE(reaction != nullptr);
+        CHECK(reaction->getTypeLabel() == "encounter");
+        CHECK_FALSE(reaction->isIndependent());
+        CHECK(reaction->encounterRadius() == Approx(1e-6));
+        CHECK(reaction->microscopicRate() == Approx(1e12));
+        CHECK(reaction->discreteProduct() == nullptr);
+        CHECK(reaction->encounterProbability(1e-9) == Approx(1.0 - std::exp(-1000.0)));
+        CHECK(dynamic_cast<RS::DiscreteEncounterReaction*>(simConf->reaction(1))->discreteProduct() == cl);
+
+        std::string illegalIsotropic =
+                "[SUBSTANCES]\nPos discrete 19 1 3.57e-4 3.0e-10\nN2 isotropic 3.58e16\n"
+                "[REACTIONS]\nPos + N2 => Pos | encounter ; 1e-6 ; 1e9 #illegal\n";
+        CHECK_THROWS_AS(parser.parseText(illegalIsotropic), RS::ConfigurationFileException);
+
+        std::string illegalRadius =
+                "[SUBSTANCES]\nPos discrete 19 1 3.57e-4 3.0e-10\nNeg discrete 35 -1 3.57e-4 3.0e-10\n"
+                "[REACTIONS]\nPos + Neg => | encounter ; 0.0 ; 1e9 #illegal\n";
+        CHECK_THROWS_AS(parser.parseText(illegalRadius), RS::ConfigurationFileException);
+
+        // reactions of two particles of the same discrete substance are only performed as encounter reactions:
+        std::string illegalStaticDimerization =
+                "[SUBSTANCES]\nA discrete 19 1 3.57e-4 3.0e-10\nB discrete 38 1 3.57e-4 3.0e-10\n"
+                "[REACTIONS]\n2A => B | static ; 1e5 #dimerization\n";
+        CHECK_THROWS_AS(parser.parseText(illegalStaticDimerization), RS::ConfigurationFileException);
+        std::string illegalStaticSum =
+                "[SUBSTANCES]\nA discrete 19 1 3.57e-4 3.0e-10\nB discrete 38 1 3.57e-4 3.0e-10\n"
+                "[REACTIONS]\nA + A => B | static ; 1e5 #dimerization\n";
+        CHECK_THROWS_AS(parser.parseText(illegalStaticSum), RS::ConfigurationFileException);
+        std::string encounterDimerization =
+                "[SUBSTANCES]\nA discrete 19 1 3.57e-4 3.0e-10\nB discrete 38 1 3.57e-4 3.0e-10\n"
+                "[REACTIONS]\n2A => B | encounter ; 1e-6 ; 1e9 #dimerization\n";
+        CHECK_NOTHROW(RS::Simulation(parser.parseText(encounterDimerization)));
+
+        std::string dimerSubstances =
+                "[SUBSTANCES]\nA discrete 19 1 3.57e-4 3.0e-10\nB discrete 38 1 3.57e-4 3.0e-10\n[REACTIONS]\n";
+        std::unique_ptr<RS::SimulationConfiguration> dimerConf = parser.parseText(dimerSubstances);
+        std::unique_ptr<RS::AbstractReaction> dimerization = std::make_unique<RS::StaticReaction>(
+                std::map<RS::Substance*, int>{{dimerConf->substanceByName("A"), 2}},
+                std::map<RS::Substance*, int>{{dimerConf->substanceByName("B"), 1}}, 1e5, "dimerization");
+        dimerConf->addReaction(dimerization);
+        CHECK_THROWS_AS(RS::Simulation(std::move(dimerConf)), std::invalid_argument);
+
+        std::map<RS::Substance*, int> educts = {{pos, 1}, {neg, 1}};
+        std::map<RS::Substance*, int> products = {{pos, 1}, {cl, 1}};
+        CHECK_THROWS_AS(RS::DiscreteEncounterReaction(educts, products, 1e-6, 1e9, "illegal"),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(RS::DiscreteEncounterReaction({{pos, 1}}, {}, 1e-6, 1e9, "illegal"),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(RS::DiscreteEncounterReaction({{pos, 1}, {neg, 1}, {n2, 1}}, {}, 1e-6, 1e9, "illegal"),
+                        std::invalid_argument);
+    }
+
+    SECTION("Only particles within the encounter radius should react") {
+        RS::Simulation rsSim(std::move(simConf));
+        std::vector<std::unique_ptr<RS::ReactiveParticle>> particles;
+        particles.push_back(std::make_unique<RS::ReactiveParticle>(pos, Core::Vector(0.0, 0.0, 0.0)));
+        particles.push_back(std::make_unique<RS::ReactiveParticle>(neg, Core::Vector(0.5e-6, 0.0, 0.0)));
+        particles.push_back(std::make_unique<RS::ReactiveParticle>(pos, Core::Vector(1e-3, 0.0, 0.0)));
+        particles.push_back(std::make_unique<RS::ReactiveParticle>(neg, Core::Vector(1e-3, 1.5e-6, 0.0)));
+        for (std::size_t i=0; i<particles.size(); ++i){
+            rsSim.addParticle(particles[i].get(), i);
+        }
+
+        std::size_t nReactions = rsSim.performEncounterReactions(1e-9);
+        CHECK(nReactions == 1);
+        CHECK(rsSim.isConsumed(0));
+        CHECK(rsSim.isConsumed(1));
+        CHECK_FALSE(rsSim.isConsumed(2));
+        CHECK_FALSE(rsSim.isConsumed(3));
+        CHECK_FALSE(particles[0]->isActive());
+        CHECK(particles[2]->isActive());
+        CHECK(rsSim.discreteConcentrations()[pos] == 1);
+        CHECK(rsSim.discreteConcentrations()[neg] == 1);
+        CHECK(rsSim.totalReactionEvents() == 1);
+
+        // consumed particles should not react again and can be removed:
+        CHECK(rsSim.performEncounterReactions(1e-9) == 0);
+        rsSim.removeParticle(0);
+        CHECK(rsSim.discreteConcentrations()[pos] == 1);
+    }
+
+    SECTION("Product reactions should transform one particle and consume the other") {
+        RS::Simulation rsSim(std::move(simConf));
+        RS::ReactiveParticle particleA(pos, Core::Vector(0.0, 0.0, 0.0));
+        RS::ReactiveParticle particleB(pos, Core::Vector(0.0, 0.0, 0.2e-6));
+        rsSim.addParticle(&particleA, 0);
+        rsSim.addParticle(&particleB, 1);
+
+        std::size_t nReactedFct = 0;
+        rsSim.performEncounterReactions(1e-9, [&nReactedFct](RS::ReactiveParticle*){nReactedFct++;});
+        CHECK(nReactedFct == 1);
+        CHECK(particleA.getSpecies() == cl);
+        CHECK(particleA.isActive());
+        CHECK_FALSE(particleB.isActive());
+        CHECK(rsSim.isConsumed(1));
+        CHECK(rsSim.discreteConcentrations()[pos] == 0);
+        CHECK(rsSim.discreteConcentrations()[cl] == 1);
+    }
+
+    SECTION("Every particle should react at most once and all possible pairs should be found") {
+        RS::Simulation rsSim(std::move(simConf));
+        std::vector<std::unique_ptr<RS::ReactiveParticle>> particles;
+        std::size_t nParticles = 4000;
+        double boxSize = 2e-5;
+        Core::RandomSource* rndSource = Core::globalRandomGeneratorPool->getThreadRandomSource();
+        for (std::size_t i=0; i<nParticles; ++i){
+            RS::Substance* species = (i % 2 == 0) ? pos : neg;
+            Core::Vector location(
+                    (rndSource->uniformRealRndValue()-0.5)*boxSize,
+                    (rndSource->uniformRealRndValue()-0.5)*boxSize,
+                    (rndSource->uniformRealRndValue()-0.5)*boxSize);
+            particles.push_back(std::make_unique<RS::ReactiveParticle>(species, location));
+            rsSim.addParticle(particles.back().get(), i);
+        }
+
+        // brute force search of the particles with a possible reaction partner:
+        std::size_t nPossiblePartners = 0;
+        for (std::size_t i=0; i<nParticles; ++i){
+            for (std::size_t j=0; j<nParticles; ++j){
+                bool canReact = !(particles[i]->getSpecies() == neg && particles[j]->getSpecies() == neg);
+                if (i != j && canReact &&
+                    (particles[i]->getLocation() - particles[j]->getLocation()).magnitude() < 1e-6){
+                    nPossiblePartners++;
+                    break;
+                }
+            }
+        }
+
+        std::size_t nReactions = rsSim.performEncounterReactions(1e-9);
+        CHECK(nReactions > 0);
+
+        // every particle which has not reacted must not have a non reacted partner within the encounter radius
+        // (the reaction probability is one), the number of consumed / transformed particles must be consistent:
+        std::size_t nConsumed = 0;
+        std::size_t nReacted = 0;
+        for (std::size_t i=0; i<nParticles; ++i){
+            if (rsSim.isConsumed(i)){
+                nConsumed++;
+            }
+            if (rsSim.isConsumed(i) || particles[i]->getSpecies() == cl){
+                nReacted++;
+            }
+        }
+        CHECK(nReacted == 2*nReactions);
+        CHECK(nReacted <= nPossiblePartners);
+        for (std::size_t i=0; i<nParticles; ++i){
+            if (rsSim.isConsumed(i) || particles[i]->getSpecies() == cl){
+                continue;
+            }
+            for (std::size_t j=i+1; j<nParticles; ++j){
+                if (rsSim.isConsumed(j) || particles[j]->getSpecies() == cl){
+                    continue;
+                }
+                bool canReact = !(particles[i]->getSpecies() == neg && particles[j]->getSpecies() == neg);
+                if (canReact){
+                    CHECK((particles[i]->getLocation() - particles[j]->getLocation()).magnitude() >= 1e-6);
+                }
+            }
+        }
+
+        auto concentrations = rsSim.discreteConcentrations();
+        CHECK(static_cast<std::size_t>(concentrations[pos] + concentrations[neg] + concentrations[cl])
+              == nParticles - nConsumed);
+    }
+}
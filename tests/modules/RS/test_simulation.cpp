@@ -36,6 +36,7 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include <cmath>
 
 using sMap = std::map<RS::Substance*,int>;
 using sPair= sMap::value_type;
@@ -297,6 +298,52 @@ TEST_CASE( "Test RS simulations", "[RS][Simulation]") {
         CHECK( particles[nParticles-1]->getSpecies() == Cl1);
     }
 
+    SECTION( "Exact reaction kinetics should resolve reactions faster than the time step") {
+        Core::globalRandomGeneratorPool = std::make_unique<Core::RandomGeneratorPool>();
+
+        std::string confString =
+                "[SUBSTANCES]\n"
+                "A discrete 19 1 3.57e-4 3.0e-10\n"
+                "B discrete 37 1 2.76e-4 6.0e-10\n"
+                "N2 isotropic 1.0\n"
+                "[REACTIONS]\n"
+                "A + N2 => B + N2 | static ; 1000.0 #forward\n"
+                "B + N2 => A + N2 | static ; 500.0 #backward\n";
+        RS::Simulation sim = RS::Simulation(parser.parseText(confString));
+        sim.setExactReactionKinetics(true);
+        CHECK(sim.exactReactionKinetics());
+        RS::Substance* subst_A = sim.simulationConfiguration()->substanceByName("A");
+
+        std::size_t nParticles = 20000;
+        std::vector<uniqueReactivePartPtr> particles;
+        for (std::size_t i=0; i < nParticles; ++i) {
+            uniqueReactivePartPtr particle = std::make_unique<RS::ReactiveParticle>(subst_A);
+            sim.addParticle(particle.get(), i);
+            particles.push_back(std::move(particle));
+        }
+
+        RS::ReactionConditions reactionConditions = RS::ReactionConditions();
+        reactionConditions.temperature = 298;
+        reactionConditions.electricField = 0.0;
+        reactionConditions.pressure = 100000.0;
+
+        // one time step with (k_forward + k_backward) * dt = 1.5, the linearized probabilities would be ill:
+        double dt = 1e-3;
+        sim.performTimestep(reactionConditions, dt);
+
+        double fractionA = sim.discreteConcentrations()[subst_A] / static_cast<double>(nParticles);
+        CHECK(fractionA == Approx(1.0/3.0 + 2.0/3.0*std::exp(-1.5)).margin(0.015));
+        CHECK(sim.illEvents() == 0);
+        // some particles have reacted more than once:
+        CHECK(sim.totalReactionEvents() > static_cast<long>(nParticles - static_cast<std::size_t>(
+                sim.discreteConcentrations()[subst_A])));
+
+        // long time step: the equilibrium is reached
+        sim.performTimestep(reactionConditions, 0.1);
+        fractionA = sim.discreteConcentrations()[subst_A] / static_cast<double>(nParticles);
+        CHECK(fractionA == Approx(1.0/3.0).margin(0.015));
+    }
+
     SECTION("Result of collision based reaction events with configuration file should be correct"){
 
         RS::Simulation sim(parser.parseFile("RS_collisionBasedReactions_test.conf"));
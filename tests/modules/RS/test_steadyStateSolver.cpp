@@ -0,0 +1,147 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_steadyStateSolver.cpp
+
+ Testing of the steady state solver of RS reaction systems
+
+ ****************************/
+
+#include "RS_SteadyStateSolver.hpp"
+#include "RS_Simulation.hpp"
+#include "RS_ConfigFileParser.hpp"
+#include "RS_StaticReaction.hpp"
+#include "catch.hpp"
+#include "test_util.hpp"
+#include <memory>
+#include <cmath>
+
+TEST_CASE("Test RS steady state solver", "[RS][SteadyStateSolver]") {
+
+    RS::ConfigFileParser parser;
+    RS::ReactionConditions conditions = RS::ReactionConditions();
+    conditions.temperature = 298.0;
+    conditions.pressure = 100000.0;
+    conditions.electricField = 0.0;
+
+    SECTION("Rate matrix of water cluster system should be correct") {
+        std::unique_ptr<RS::SimulationConfiguration> simConf = parser.parseFile("RS_waterCluster_test.conf");
+        RS::SteadyStateSolver solver(*simConf);
+        std::vector<double> K = solver.rateMatrix(conditions);
+
+        std::size_t n = simConf->getAllDiscreteSubstances().size();
+        REQUIRE(K.size() == n*n);
+        // reactions only transform particles, thus all columns sum up to zero:
+        for (std::size_t col=0; col<n; ++col){
+            double sum = 0.0;
+            for (std::size_t row=0; row<n; ++row){
+                sum += K[row*n + col];
+            }
+            CHECK(sum == Approx(0.0).margin(1e-12*std::fabs(K[col*n + col])));
+        }
+        // Cl_1 -> Cl_2 with k = 1.007190e-28 * [H2O] * [N2]:
+        CHECK(K[1*n + 0] == Approx(1.007190e-28 * 3.58e13 * 3.58e16));
+        CHECK(K[0*n + 0] == Approx(-1.007190e-28 * 3.58e13 * 3.58e16));
+        CHECK(K[0*n + 1] == Approx(5.773214e-27 * 3.58e16));
+    }
+
+    SECTION("Steady state of reversible reaction chain should fulfill detailed balance") {
+        std::unique_ptr<RS::SimulationConfiguration> simConf = parser.parseFile("RS_waterCluster_test.conf");
+        std::vector<RS::Substance*> substances = simConf->getAllDiscreteSubstances();
+        RS::SteadyStateSolver solver(*simConf);
+        std::vector<double> K = solver.rateMatrix(conditions);
+        std::size_t n = substances.size();
+
+        RS::SteadyStateSolver::distribution_t steadyState = solver.steadyState(conditions, {{substances[0], 1.0}});
+
+        double sum = 0.0;
+        for (const auto& entry: steadyState){
+            sum += entry.second;
+        }
+        CHECK(sum == Approx(1.0));
+
+        for (std::size_t i=2; i+1<n; ++i){
+            double expectedRatio = K[(i+1)*n + i] / K[i*n + (i+1)];
+            CHECK(steadyState.at(substances[i+1]) / steadyState.at(substances[i]) == Approx(expectedRatio).epsilon(1e-6));
+        }
+    }
+
+    SECTION("Steady state of system with irreversible reactions should depend on the initial distribution") {
+        RS::SimulationConfiguration simConf;
+        std::unique_ptr<RS::Substance> substA = std::make_unique<RS::Substance>("A", RS::Substance::substanceType::discrete);
+        std::unique_ptr<RS::Substance> substB = std::make_unique<RS::Substance>("B", RS::Substance::substanceType::discrete);
+        std::unique_ptr<RS::Substance> substC = std::make_unique<RS::Substance>("C", RS::Substance::substanceType::discrete);
+        RS::Substance* A = substA.get();
+        RS::Substance* B = substB.get();
+        RS::Substance* C = substC.get();
+        simConf.addSubstance(substA);
+        simConf.addSubstance(substB);
+        simConf.addSubstance(substC);
+
+        std::unique_ptr<RS::AbstractReaction> reaction = std::make_unique<RS::StaticReaction>(
+                std::map<RS::Substance*, int>{{A, 1}}, std::map<RS::Substance*, int>{{B, 1}}, 5.0, "A_to_B");
+        simConf.addReaction(reaction);
+        simConf.updateConfiguration();
+
+        RS::SteadyStateSolver solver(simConf);
+        RS::SteadyStateSolver::distribution_t steadyState = solver.steadyState(conditions, {{A, 3.0}, {C, 1.0}});
+        CHECK(steadyState.at(A) == Approx(0.0).margin(1e-12));
+        CHECK(steadyState.at(B) == Approx(0.75));
+        CHECK(steadyState.at(C) == Approx(0.25));
+
+        CHECK_THROWS_AS(solver.steadyState(conditions, {}), std::invalid_argument);
+        CHECK_THROWS_AS(solver.steadyState(conditions, {{A, -1.0}}), std::invalid_argument);
+    }
+
+    SECTION("Substances should be sampled from a distribution") {
+        RS::Substance A("A", RS::Substance::substanceType::discrete);
+        RS::Substance B("B", RS::Substance::substanceType::discrete);
+        for (int i=0; i<100; ++i){
+            CHECK(RS::SteadyStateSolver::sampleSubstance({{&A, 0.0}, {&B, 2.0}}) == &B);
+        }
+        CHECK_THROWS_AS(RS::SteadyStateSolver::sampleSubstance({{&A, 0.0}}), std::invalid_argument);
+    }
+
+    SECTION("Particles in a RS simulation should be initialized to the steady state") {
+        RS::Simulation sim(parser.parseFile("RS_waterCluster_test.conf"));
+        std::vector<RS::Substance*> substances = sim.simulationConfiguration()->getAllDiscreteSubstances();
+
+        std::size_t nParticles = 20000;
+        std::vector<uniqueReactivePartPtr> particles;
+        for (std::size_t i=0; i<nParticles; ++i){
+            particles.push_back(std::make_unique<RS::ReactiveParticle>(substances[0]));
+            sim.addParticle(particles.back().get(), i);
+        }
+
+        std::map<RS::Substance*, double> steadyState = sim.initializeToSteadyState(conditions);
+        std::map<RS::Substance* const, int> concentrations = sim.discreteConcentrations();
+
+        int total = 0;
+        for (RS::Substance* subst: substances){
+            total += concentrations.at(subst);
+            double expected = steadyState.at(subst) * static_cast<double>(nParticles);
+            double tolerance = 5.0*std::sqrt(expected) + 1.0;
+            CHECK(std::fabs(concentrations.at(subst) - expected) < tolerance);
+        }
+        CHECK(total == static_cast<int>(nParticles));
+        CHECK(concentrations.at(substances[0]) == 0);
+    }
+}
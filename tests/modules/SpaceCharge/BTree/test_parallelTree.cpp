@@ -144,12 +144,125 @@ TEST_CASE( "Test parallel tree semantics / particle management","[Tree]") {
         ParticleSimulation::BoxStartZone startZone(boxSize);
         std::vector<std::unique_ptr<Core::Particle>> ions= startZone.getRandomParticlesInStartZone(nions, 1);
 
+        std::size_t emptyTreeMemory = testTree.memoryUsageBytes();
         for (std::size_t i=0; i<nions; i++){
             testTree.insertParticle((*ions[i]),i+1);
         }
-        testTree.init();
+        std::size_t nNodes = testTree.init();
         //The integrity of the resulting large random tree should be valid:
         CHECK_NOTHROW(testTree.getRoot()->testNodeIntegrity(0));
+
+        //The memory usage estimate accounts for all nodes and tree particles:
+        CHECK(testTree.memoryUsageBytes() >
+              emptyTreeMemory + nNodes*sizeof(BTree::ParallelNode) + nions*sizeof(BTree::TreeParticle));
+    }
+}
+
+TEST_CASE( "Test parallel tree with dynamic domain","[Tree]") {
+    BTree::ParallelTree testTree;
+    CHECK(testTree.isDomainDynamic());
+
+    SECTION("Domain is grown by re-rooting if particles are outside of the domain"){
+        Core::Particle testIon1(Core::Vector(-0.0001, 0.0, 0.0), 1.0);
+        Core::Particle testIon2(Core::Vector(0.0001, 0.0, 0.0), 1.0);
+        Core::Particle testIon3(Core::Vector(0.5, -0.3, 0.2), 1.0);
+        testTree.insertParticle(testIon1, 1);
+        testTree.insertParticle(testIon2, 2);
+        testTree.insertParticle(testIon3, 3);
+
+        BTree::ParallelNode* root = testTree.getRoot();
+        CHECK(root->getNumberOfParticles() == 3);
+        CHECK(root->getMin().x() < 0.5);
+        CHECK(root->getMax().x() > 0.5);
+        CHECK(root->getMin().y() < -0.3);
+        CHECK(root->getMax().z() > 0.2);
+        CHECK_NOTHROW(root->testNodeIntegrity(0));
+
+        int updated = 0;
+        testTree.updateParticleLocation(1, Core::Vector(-2.0, 1.0, 3.0), &updated);
+        CHECK(updated == 1);
+        CHECK(testTree.getRoot()->getMin().x() < -2.0);
+        CHECK(testTree.getRoot()->getMax().z() > 3.0);
+        CHECK(testTree.getNumberOfParticles() == 3);
+        CHECK_NOTHROW(testTree.getRoot()->testNodeIntegrity(0));
+
+        testTree.updateNodes(updated);
+        CHECK(isExactDoubleEqual(testTree.getRoot()->getCharge(), 3.0*Core::ELEMENTARY_CHARGE));
+    }
+
+    SECTION("Domain is tightened if the particle cloud contracts"){
+        Core::Particle testIon1(Core::Vector(-1.0, 0.0, 0.0), 1.0);
+        Core::Particle testIon2(Core::Vector(1.0, 0.0, 0.0), 1.0);
+        Core::Particle testIon3(Core::Vector(0.0, 0.5, 0.0), 1.0);
+        testTree.insertParticle(testIon1, 1);
+        testTree.insertParticle(testIon2, 2);
+        testTree.insertParticle(testIon3, 3);
+        testTree.rebuildDomain();
+        double initialEdgeLength = testTree.getRoot()->getMax().x() - testTree.getRoot()->getMin().x();
+        CHECK(initialEdgeLength > 2.0);
+        CHECK(initialEdgeLength < 2.5);
+
+        int updated = 0;
+        testTree.updateParticleLocation(1, Core::Vector(-0.001, 0.0, 0.0), &updated);
+        testTree.updateParticleLocation(2, Core::Vector(0.001, 0.0, 0.0), &updated);
+        testTree.updateParticleLocation(3, Core::Vector(0.0, 0.0005, 0.0), &updated);
+        testTree.updateNodes(updated);
+
+        BTree::ParallelNode* root = testTree.getRoot();
+        double tightEdgeLength = root->getMax().x() - root->getMin().x();
+        CHECK(tightEdgeLength < 0.0025);
+        CHECK(root->getNumberOfParticles() == 3);
+        CHECK(isExactDoubleEqual(root->getCharge(), 3.0*Core::ELEMENTARY_CHARGE));
+        CHECK(testTree.getParticle(2)->getHostNode() != root);
+        CHECK_NOTHROW(root->testNodeIntegrity(0));
+    }
+
+    SECTION("A static domain can be set for a tree with dynamic domain"){
+        Core::Particle testIon1(Core::Vector(-0.0001, 0.0, 0.0), 1.0);
+        Core::Particle testIon2(Core::Vector(0.0001, 0.0, 0.0), 1.0);
+        testTree.insertParticle(testIon1, 1);
+        testTree.insertParticle(testIon2, 2);
+        testTree.setStaticDomain(Core::Vector(-2.0, -2.0, -2.0), Core::Vector(2.0, 2.0, 2.0));
+        CHECK_FALSE(testTree.isDomainDynamic());
+
+        // the static domain is not tightened:
+        testTree.updateNodes(0);
+        CHECK(isExactDoubleEqual(testTree.getRoot()->getMin().x(), -2.0));
+        CHECK(isExactDoubleEqual(testTree.getRoot()->getMax().z(), 2.0));
+        CHECK(testTree.getRoot()->getNumberOfParticles() == 2);
+        CHECK_NOTHROW(testTree.getRoot()->testNodeIntegrity(0));
+    }
+
+    SECTION("Dynamic domain tree field calculation is consistent with full sum solution"){
+        unsigned int nPerDirection = 20;
+        auto ions = getIonsInLattice(nPerDirection);
+
+        SpaceCharge::FullSumSolver fullSumSolver;
+        std::size_t i = 0;
+        for (auto& ion: ions){
+            fullSumSolver.insertParticle(*ion, i);
+            testTree.insertParticle(*ion, i);
+            ++i;
+        }
+        testTree.init();
+        fullSumSolver.computeChargeDistribution();
+        CHECK_NOTHROW(testTree.getRoot()->testNodeIntegrity(0));
+
+        auto meanRelativeError = [&ions, &testTree, &fullSumSolver](){
+            double errorSum = 0.0;
+            std::size_t nSamples = 0;
+            for (std::size_t j=0; j<ions.size(); j+=7){
+                Core::Vector fullSumField = fullSumSolver.getEFieldFromSpaceCharge(*ions[j]);
+                errorSum += (testTree.getEFieldFromSpaceCharge(*ions[j])-fullSumField).magnitude() / fullSumField.magnitude();
+                ++nSamples;
+            }
+            return errorSum / static_cast<double>(nSamples);
+        };
+
+        CHECK(meanRelativeError() < 3.5e-2);
+        testTree.rebuildDomain();
+        CHECK_NOTHROW(testTree.getRoot()->testNodeIntegrity(0));
+        CHECK(meanRelativeError() < 3e-2);
     }
 }
 
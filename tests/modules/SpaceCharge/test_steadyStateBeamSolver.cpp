@@ -0,0 +1,104 @@
+/***************************
+ Ion Dynamics Simulation Framework (IDSimF)
+
+ Copyright 2020 - Physical and Theoretical Chemistry /
+ Institute of Pure and Applied Mass Spectrometry
+ of the University of Wuppertal, Germany
+
+ IDSimF is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ IDSimF is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with IDSimF.  If not, see <https://www.gnu.org/licenses/>.
+
+ ------------
+ test_steadyStateBeamSolver.cpp
+
+ Testing of the grid based steady state beam space charge solver
+
+ ****************************/
+
+#include "SC_steadyStateBeamSolver.hpp"
+#include "Core_constants.hpp"
+#include "catch.hpp"
+#include <cmath>
+
+TEST_CASE( "Test steady state beam solver", "[SpaceCharge][SteadyStateBeamSolver]") {
+
+    SECTION("Steady state beam solver rejects illegal grids and relaxation factors"){
+        CHECK_THROWS_AS(SpaceCharge::SteadyStateBeamSolver({-1, -1, -1}, {1, 1, 1}, {2, 10, 10}), std::invalid_argument);
+        CHECK_THROWS_AS(SpaceCharge::SteadyStateBeamSolver({-1, 1, -1}, {1, 1, 1}, {10, 10, 10}), std::invalid_argument);
+        CHECK_THROWS_AS(SpaceCharge::SteadyStateBeamSolver({-1, -1, -1}, {1, 1, 1}, {10, 10, 10}, 0.0),
+                std::invalid_argument);
+        CHECK_THROWS_AS(SpaceCharge::SteadyStateBeamSolver({-1, -1, -1}, {1, 1, 1}, {10, 10, 10}, 1.5),
+                std::invalid_argument);
+    }
+
+    SECTION("Field of a point charge is the Coulomb field"){
+        SpaceCharge::SteadyStateBeamSolver solver({-1, -1, -1}, {1, 1, 1}, {41, 41, 41});
+        double charge = 1e-12;
+        solver.depositCharge({0.0, 0.0, 0.0}, charge);
+        solver.depositCharge({2.0, 0.0, 0.0}, charge); // outside of the grid: discarded
+        solver.updateField();
+
+        CHECK(solver.numberOfFieldUpdates() == 1);
+        CHECK(solver.getTotalCharge() == Approx(charge));
+
+        double r = 0.4;
+        double coulombField = charge / (4.0*M_PI*Core::EPSILON_0*r*r);
+        Core::Vector fieldPositive = solver.getField({r, 0.0, 0.0});
+        Core::Vector fieldNegative = solver.getField({0.0, -r, 0.0});
+        CHECK(fieldPositive.x() == Approx(coulombField).epsilon(0.05));
+        CHECK(fieldNegative.y() == Approx(-coulombField).epsilon(0.05));
+        CHECK(std::fabs(fieldPositive.y()) < 1e-6*coulombField);
+
+        CHECK(solver.getPotential({0.0, 0.0, 0.0}) > solver.getPotential({r, 0.0, 0.0}));
+        CHECK(solver.getPotential({r, 0.0, 0.0}) > 0.0);
+        CHECK(solver.getPotential({1.0, 0.0, 0.0}) == Approx(0.0).margin(1e-20));
+
+        Core::Vector fieldOutside = solver.getField({1.5, 0.0, 0.0});
+        CHECK(fieldOutside.magnitude() == Approx(0.0).margin(1e-20));
+
+        Core::Particle particle({r, 0.0, 0.0}, 1.0);
+        CHECK(solver.getEFieldFromSpaceCharge(particle).x() == Approx(fieldPositive.x()));
+    }
+
+    SECTION("Charge deposition is distributed to the grid nodes"){
+        SpaceCharge::SteadyStateBeamSolver solver({0, 0, 0}, {1, 1, 1}, {3, 3, 3});
+        solver.depositCharge({0.25, 0.5, 0.5}, 1e-12);
+        solver.updateField();
+        double nodeVolume = 0.5*0.5*0.5;
+        CHECK(solver.getChargeDensity({0.0, 0.5, 0.5}) == Approx(0.5e-12/nodeVolume));
+        CHECK(solver.getChargeDensity({0.5, 0.5, 0.5}) == Approx(0.5e-12/nodeVolume));
+        CHECK(solver.getChargeDensity({1.0, 0.5, 0.5}) == Approx(0.0).margin(1e-20));
+    }
+
+    SECTION("Charge density is under relaxed between the iterations"){
+        SpaceCharge::SteadyStateBeamSolver solver({-1, -1, -1}, {1, 1, 1}, {21, 21, 21}, 0.5);
+        double charge = 1e-12;
+
+        CHECK(solver.updateField() == Approx(0.0)); // nothing deposited yet
+
+        solver.depositCharge({0.1, 0.1, 0.1}, charge);
+        CHECK(solver.updateField() == Approx(1.0));
+        CHECK(solver.getTotalCharge() == Approx(charge));
+
+        // the same deposition is self consistent:
+        solver.depositCharge({0.1, 0.1, 0.1}, charge);
+        CHECK(solver.updateField() == Approx(0.0).margin(1e-12));
+        CHECK(solver.getTotalCharge() == Approx(charge));
+
+        // a doubled deposition is relaxed:
+        solver.depositCharge({0.1, 0.1, 0.1}, 2.0*charge);
+        CHECK(solver.updateField() == Approx(0.5));
+        CHECK(solver.getTotalCharge() == Approx(1.5*charge));
+        CHECK(solver.numberOfFieldUpdates() == 4);
+    }
+}